@@ -16,10 +16,20 @@ if ! command -v gcc &> /dev/null; then
 fi
 
 # Compile with all warnings and pthread/rt libraries
-echo "Compiling rrc_integrated.c..."
-gcc -o rrc_integrated rrc_integrated.c -pthread -lrt -Wall -Wextra -g
+echo "Compiling rrc_integrated.c nc_wire.c..."
+gcc -o rrc_integrated rrc_integrated.c nc_wire.c -pthread -lrt -Wall -Wextra -g
+status=$?
 
-if [ $? -eq 0 ]; then
+# NC wire codec round-trip test (needs only nc_wire.c)
+echo "Compiling and running nc_wire_test..."
+if gcc -o nc_wire_test nc_wire_test.c nc_wire.c -lm -Wall -Wextra -g && ./nc_wire_test > /dev/null; then
+    echo "✓ nc_wire_test passed"
+else
+    echo "✗ nc_wire_test failed (run ./nc_wire_test for details)"
+    status=1
+fi
+
+if [ $status -eq 0 ]; then
     echo ""
     echo "=========================================="
     echo "✓ Compilation successful!"
@@ -21,17 +21,36 @@
  * Creates a HELLO message containing the node's willingness and
  * current neighbor information for broadcast to one-hop neighbors.
  * 
+ * @param arena Scratch arena that holds the message and its neighbor list
  * @return Pointer to newly created HELLO message, or NULL on failure
  */
-struct olsr_hello* generate_hello_message(void);
+struct olsr_hello* generate_hello_message(struct olsr_arena* arena);
+
+/**
+ * @brief Serialize a HELLO message in RFC 3626 wire format
+ * 
+ * Builds the message directly from the neighbor table into buf, with
+ * neighbors grouped into one link message block per link code.
+ * Allocation-free; reads the neighbor table without locking, so call it
+ * from the thread that owns the OLSR tables.
+ * 
+ * @param buf Output buffer, typically the NC payload
+ * @param buf_len Size of buf in bytes
+ * @return Number of bytes written, or -1 if the message does not fit
+ */
+int serialize_hello_message(uint8_t* buf, size_t buf_len);
 
 /**
  * @brief Send a HELLO message
  * 
- * Generates and simulates sending a HELLO message. In this implementation,
- * it performs message creation and logging without actual network transmission.
+ * Serializes a HELLO message into the given NC payload buffer, ready to
+ * be passed to enqueue_olsr_nc_packet().
+ * 
+ * @param nc_payload NC payload buffer to fill
+ * @param payload_len Size of nc_payload in bytes
+ * @return Number of bytes written, or -1 on failure
  */
-void send_hello_message(void);
+int send_hello_message(uint8_t* nc_payload, size_t payload_len);
 
 /**
  * @brief Process a received HELLO message
@@ -91,6 +110,35 @@ int update_neighbor(uint32_t addr, uint8_t link_code, uint8_t willingness);
  */
 struct neighbor_entry* find_neighbor(uint32_t addr);
 
+/**
+ * @brief Remove a neighbor from the neighbor table
+ * 
+ * Keeps the table dense by moving the last entry into the freed slot.
+ * 
+ * @param addr IP address of the neighbor to remove
+ * @return 0 on success, -1 if neighbor not found
+ */
+int remove_neighbor(uint32_t addr);
+
+/**
+ * @brief Check whether the link to a neighbor is symmetric
+ * 
+ * @param addr IP address of the neighbor
+ * @return 1 if the neighbor listed this node in its last HELLO, 0 otherwise
+ */
+int neighbor_is_symmetric(uint32_t addr);
+
+/**
+ * @brief Remove neighbors not heard from within NEIGHB_HOLD_TIME
+ * 
+ * Walks the expiry list from the stalest neighbor and stops at the first
+ * one still valid, so the cost is proportional to the number expired.
+ * 
+ * @param now Current time
+ * @return Number of neighbors removed
+ */
+int expire_neighbors(time_t now);
+
 /**
  * @brief Print the current neighbor table
  * 
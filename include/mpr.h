@@ -0,0 +1,82 @@
+/**
+ * @file mpr.h
+ * @brief MPR (Multipoint Relay) selection and two-hop neighbor set
+ * @author OLSR Implementation Team
+ * @date 2025-10-02
+ *
+ * This file contains function declarations for maintaining the two-hop
+ * neighbor set from received HELLO messages and selecting the MPR set
+ * with the RFC 3626 section 8.3.1 heuristic.
+ */
+
+#ifndef MPR_H
+#define MPR_H
+
+#include "olsr.h"
+#include "packet.h"
+
+#define MPR_MAX_TWO_HOP 128                      /**< Maximum strict two-hop neighbors tracked */
+#define MPR_TWO_HOP_WORDS (MPR_MAX_TWO_HOP / 64) /**< 64-bit words per coverage bitset */
+
+/**
+ * @brief Update the two-hop set and MPR selector set from a HELLO
+ *
+ * Records which two-hop nodes the sender covers (its SYM_NEIGH and
+ * MPR_NEIGH entries) and whether it selected this node as MPR. If the
+ * coverage or the sender's eligibility did not change, the MPR set is
+ * left as is; otherwise it is marked for recalculation.
+ *
+ * @param sender_addr Address of the HELLO originator
+ * @param hello Parsed HELLO message
+ * @param symmetric 1 if the link to the sender is symmetric
+ */
+void mpr_process_hello(uint32_t sender_addr, const struct olsr_hello* hello, int symmetric);
+
+/**
+ * @brief Forget a one-hop neighbor and the two-hop nodes only it covered
+ * @param neighbor_addr Address of the lost neighbor
+ */
+void mpr_remove_neighbor(uint32_t neighbor_addr);
+
+/**
+ * @brief Follow a neighbor that moved to another neighbor_table slot
+ *
+ * Per-neighbor MPR state is indexed like neighbor_table; the neighbor
+ * table calls this when it compacts after a removal.
+ *
+ * @param from Old slot
+ * @param to New slot
+ */
+void mpr_move_neighbor(int from, int to);
+
+/**
+ * @brief Recalculate the MPR set if the neighborhood changed
+ *
+ * Updates is_mpr in the neighbor table, which HELLO generation advertises
+ * as MPR_NEIGH.
+ *
+ * @return 1 if the MPR set was recalculated, 0 if it was already current
+ */
+int mpr_recalculate(void);
+
+/**
+ * @brief Check whether a neighbor is currently selected as MPR
+ * @param neighbor_addr Address of the neighbor
+ * @return 1 if selected, 0 otherwise
+ */
+int mpr_is_selected(uint32_t neighbor_addr);
+
+/**
+ * @brief Copy the current MPR set
+ * @param out Output array
+ * @param max Capacity of out
+ * @return Number of MPRs written
+ */
+int mpr_get_set(uint32_t* out, int max);
+
+/**
+ * @brief Print the MPR set and two-hop coverage
+ */
+void print_mpr_set(void);
+
+#endif
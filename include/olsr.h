@@ -46,6 +46,20 @@
 #define LOST_LINK     3  /**< Lost link */
 /** @} */
 
+/**
+ * @defgroup NeighborTypes Neighbor Type Codes
+ * @brief Neighbor types carried in the upper bits of a HELLO link code
+ * @{
+ */
+#define NOT_NEIGH     0  /**< Not a symmetric neighbor */
+#define SYM_NEIGH     1  /**< Symmetric neighbor */
+#define MPR_NEIGH     2  /**< Symmetric neighbor selected as MPR */
+
+#define OLSR_LINK_CODE(neigh_type, link_type) ((uint8_t)(((neigh_type) << 2) | (link_type)))
+#define OLSR_LINK_TYPE(link_code)  ((link_code) & 0x03)
+#define OLSR_NEIGH_TYPE(link_code) (((link_code) >> 2) & 0x03)
+/** @} */
+
 /**
  * @defgroup Intervals Protocol Timing Intervals
  * @brief Default time intervals for OLSR protocol operations
@@ -53,9 +67,10 @@
  */
 #define HELLO_INTERVAL 2  /**< HELLO message interval in seconds */
 #define TC_INTERVAL    5  /**< TC message interval in seconds */
+#define NEIGHB_HOLD_TIME (3 * HELLO_INTERVAL) /**< Neighbor expiry time in seconds */
 /** @} */
 
-#define MAX_NEIGHBORS 40  /**< Maximum number of neighbors in table */
+#define MAX_NEIGHBORS 256 /**< Maximum number of neighbors in table */
 
 /**
  * @brief Neighbor table entry structure
@@ -71,6 +86,8 @@ struct neighbor_entry {
     int is_mpr;                  /**< Flag: 1 if neighbor is selected as MPR */
     int is_mpr_selector;         /**< Flag: 1 if neighbor selected this node as MPR */
     struct neighbor_entry *next; /**< Pointer to next neighbor (for linked list) */
+    int expiry_prev;             /**< Slot of the previously heard neighbor, -1 if none */
+    int expiry_next;             /**< Slot of the next heard neighbor, -1 if none */
 };
 
 /**
@@ -117,7 +134,7 @@ extern uint16_t message_seq_num;
 struct control_message {
     uint8_t msg_type;    /**< Type of message (MSG_HELLO, MSG_TC, etc.) */
     uint32_t timestamp;  /**< Timestamp when message was created */
-    void* msg_data;      /**< Pointer to actual message data */
+    void* msg_data;      /**< Serialized message, in RFC 3626 wire format */
     int data_size;       /**< Size of the message data in bytes */
 };
 
@@ -144,7 +161,7 @@ void init_control_queue(struct control_queue* queue);
  * @brief Push a message to the control queue
  * @param queue Pointer to the control queue
  * @param msg_type Type of the message
- * @param msg_data Pointer to message data
+ * @param msg_data Serialized message; the queue keeps its own copy
  * @param data_size Size of the message data
  * @return 0 on success, -1 on failure
  */
@@ -12,9 +12,43 @@
 #define PACKET_H
 
 #include<stdint.h>
+#include<stddef.h>
 #include<time.h>
 #include "olsr.h"
 
+/**
+ * @defgroup WireFormat RFC 3626 Wire Format
+ * @brief Sizes of the packed on-air message layout
+ *
+ * All fields are big-endian. Addresses are copied as stored, since node
+ * addresses are already kept in network byte order.
+ * @{
+ */
+#define OLSR_MSG_HEADER_SIZE        12   /**< Type, Vtime, Size, Originator, TTL, Hop Count, Seq */
+#define OLSR_HELLO_HEADER_SIZE      4    /**< Reserved, Htime, Willingness */
+#define OLSR_LINK_BLOCK_HEADER_SIZE 4    /**< Link Code, Reserved, Link Message Size */
+#define OLSR_TC_HEADER_SIZE         4    /**< ANSN, Reserved */
+#define OLSR_ADDR_SIZE              4    /**< IPv4 address */
+#define OLSR_MAX_MESSAGE_SIZE       2048 /**< Largest message carried in one NC payload */
+/** @} */
+
+#define OLSR_ARENA_SIZE 4096 /**< Scratch space for one parsed or generated message */
+
+/**
+ * @brief Per-message scratch arena
+ *
+ * Bump allocator that backs the pointers inside a generated or parsed
+ * olsr_hello / olsr_tc. Callers declare one on the stack per message; it
+ * needs no freeing and is never shared between threads.
+ */
+struct olsr_arena {
+	size_t used;                 /**< Bytes handed out so far */
+	union {
+		uint8_t bytes[OLSR_ARENA_SIZE];
+		uint64_t align;          /**< Keeps allocations 8-byte aligned */
+	} mem;
+};
+
 /**
  * @brief OLSR packet structure
  * 
@@ -72,18 +106,88 @@ struct olsr_hello {
 		uint8_t link_code;      /**< Link type and neighbor type code */
 	} *neighbors;            /**< Array of neighbor information */
 	int neighbor_count;      /**< Number of neighbors in the array */
+	int self_link_code;      /**< Link code this node is listed under, -1 if absent */
 };
 
 /**
  * @brief Generate a HELLO message
+ * @param arena Scratch arena that holds the message and its neighbor list
  * @return Pointer to newly created HELLO message, or NULL on failure
  */
-struct olsr_hello* generate_hello_message(void);
+struct olsr_hello* generate_hello_message(struct olsr_arena* arena);
 
 /**
  * @brief Generate a TC message  
+ * @param arena Scratch arena that holds the message and its selector list
  * @return Pointer to newly created TC message, or NULL on failure
  */
-struct olsr_tc* generate_tc_message(void);
+struct olsr_tc* generate_tc_message(struct olsr_arena* arena);
+
+/**
+ * @brief Reset an arena so it can back a new message
+ * @param arena Arena to reset
+ */
+void olsr_arena_reset(struct olsr_arena* arena);
+
+/**
+ * @brief Allocate zeroed, 8-byte aligned memory from an arena
+ * @param arena Arena to allocate from
+ * @param size Number of bytes
+ * @return Pointer into the arena, or NULL if it is exhausted
+ */
+void* olsr_arena_alloc(struct olsr_arena* arena, size_t size);
+
+/**
+ * @brief Encode a time in seconds as an RFC 3626 mantissa/exponent byte
+ * @param seconds Time in seconds (Vtime or Htime)
+ * @return Encoded byte (high nibble mantissa, low nibble exponent)
+ */
+uint8_t olsr_encode_time(uint32_t seconds);
+
+/**
+ * @brief Decode an RFC 3626 mantissa/exponent byte
+ * @param code Encoded Vtime/Htime byte
+ * @return Time in whole seconds, saturated at 255
+ */
+uint8_t olsr_decode_time(uint8_t code);
+
+/**
+ * @brief Write the 12-byte message header
+ *
+ * msg->vtime is taken in seconds and encoded; msg->msg_size must already
+ * hold the total serialized size of the message.
+ *
+ * @param msg Header fields to write
+ * @param buf Output buffer (at least OLSR_MSG_HEADER_SIZE bytes)
+ */
+void olsr_write_message_header(const struct olsr_message* msg, uint8_t* buf);
+
+/**
+ * @brief Parse one serialized OLSR message
+ *
+ * Decodes the header into msg and the HELLO/TC body into arena, setting
+ * msg->body to point at it. Unknown message types are returned with a NULL
+ * body so the caller can skip them.
+ *
+ * @param buf Serialized message(s), e.g. an NC slot payload
+ * @param len Bytes available in buf
+ * @param msg Output header
+ * @param arena Scratch arena for the body
+ * @return Bytes consumed (the message size), or -1 if malformed
+ */
+int parse_olsr_message(const uint8_t* buf, size_t len, struct olsr_message* msg,
+                       struct olsr_arena* arena);
+
+/**
+ * @brief Parse a HELLO body (after the message header)
+ * @return Parsed HELLO in arena, or NULL if malformed
+ */
+struct olsr_hello* parse_hello_body(const uint8_t* buf, size_t len, struct olsr_arena* arena);
+
+/**
+ * @brief Parse a TC body (after the message header)
+ * @return Parsed TC in arena, or NULL if malformed
+ */
+struct olsr_tc* parse_tc_body(const uint8_t* buf, size_t len, struct olsr_arena* arena);
 
 #endif
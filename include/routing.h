@@ -15,6 +15,7 @@
 #define MAX_ROUTING_ENTRIES 100  /**< Maximum entries in routing table */
 #define INFINITE_COST INT_MAX    /**< Infinite cost for unreachable nodes */
 #define MAX_NODES 50            /**< Maximum nodes in topology */
+#define ROUTING_HOLDDOWN_MS 100  /**< Default hold-down for triggered recomputation */
 
 /**
  * @brief Routing table entry structure
@@ -89,9 +90,64 @@ void clear_routing_table(void);
 
 /**
  * @brief Update routing table with new topology information
+ * 
+ * Schedules a recomputation rather than running SPF immediately.
  */
 void update_routing_table(void);
 
+/**
+ * @brief Mark the topology as changed
+ * 
+ * Changes arriving within the hold-down window of the first one are
+ * coalesced into a single SPF run.
+ */
+void routing_mark_dirty(void);
+
+/**
+ * @brief Set the hold-down window for triggered recomputation
+ * @param holddown_ms Window in milliseconds
+ */
+void routing_set_holddown(uint32_t holddown_ms);
+
+/**
+ * @brief Milliseconds until a pending recomputation is due
+ * 
+ * Suitable as a poll/select timeout for the daemon loop.
+ * 
+ * @return Remaining delay, 0 if due now, -1 if nothing is pending
+ */
+int routing_pending_delay_ms(void);
+
+/**
+ * @brief Run SPF once if the topology is dirty and the hold-down expired
+ * @return 1 if the routing table was recomputed, 0 otherwise
+ */
+int routing_run_pending(void);
+
+/**
+ * @brief Current routing table generation
+ * 
+ * Bumped whenever a recomputation changes a route; consumers caching
+ * next hops drop their cache when it moves.
+ * 
+ * @return Generation number
+ */
+uint32_t routing_get_generation(void);
+
+/**
+ * @brief Look up the next hop towards a destination
+ * @param dest_ip Destination IP address
+ * @param next_hop Output next hop
+ * @param generation Output generation of the table read (may be NULL)
+ * @return 0 if a route exists, -1 otherwise
+ */
+int routing_lookup(uint32_t dest_ip, uint32_t* next_hop, uint32_t* generation);
+
+/**
+ * @brief Print triggered-update statistics
+ */
+void print_routing_stats(void);
+
 /**
  * @brief Add or update a topology link from TC message
  * @param from_addr Source node address
@@ -0,0 +1,64 @@
+/**
+ * @file rrc_notify.h
+ * @brief Unsolicited OLSR to RRC notifications
+ * @author OLSR Implementation Team
+ * @date 2025-10-02
+ *
+ * Pushes MPR set and MPR selector set changes to the RRC over the
+ * "/mq_olsr_to_rrc" POSIX queue, which the RRC uses to restrict
+ * broadcast/multicast relaying to MPRs. Route answers and routing table
+ * generation changes go over the same queue, so the RRC can tell when
+ * the next hops it cached are stale.
+ */
+
+#ifndef RRC_NOTIFY_H
+#define RRC_NOTIFY_H
+
+#define RRC_NOTIFY_QUEUE "/mq_olsr_to_rrc"  /**< Queue created by the RRC */
+#define RRC_REQUEST_QUEUE "/mq_rrc_to_olsr"  /**< RRC route requests */
+#define RRC_NOTIFY_MAX_NODES 40             /**< Matches the RRC's MAX_MONITORED_NODES */
+#define RRC_NOTIFY_ANY_DEST 0               /**< Route update that only carries a generation */
+
+/**
+ * @brief Send the current MPR and MPR selector sets to the RRC
+ *
+ * Non-blocking. If the queue is not open yet or full, the update stays
+ * pending and is retried on the next call.
+ *
+ * @return 0 if sent, -1 if left pending
+ */
+int rrc_notify_mpr_update(void);
+
+/**
+ * @brief Tell the RRC that the routing table generation moved
+ *
+ * Non-blocking, retried by rrc_notify_poll() like the MPR update.
+ *
+ * @return 0 if sent, -1 if left pending
+ */
+int rrc_notify_route_generation(void);
+
+/**
+ * @brief Answer queued RRC route requests
+ *
+ * Each answer carries the generation of the table it was read from.
+ */
+void rrc_notify_serve_requests(void);
+
+/**
+ * @brief Descriptor to wait on for RRC route requests
+ * @return File descriptor, -1 if the RRC queue is not open yet
+ */
+int rrc_notify_request_fd(void);
+
+/**
+ * @brief Retry updates that could not be sent earlier
+ */
+void rrc_notify_poll(void);
+
+/**
+ * @brief Close the notification queue
+ */
+void rrc_notify_close(void);
+
+#endif
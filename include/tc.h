@@ -28,10 +28,21 @@ int add_mpr_selector(uint32_t selector_addr);
  */
 int remove_mpr_selector(uint32_t selector_addr);
 
+/**
+ * @brief Serialize a TC message in RFC 3626 wire format
+ * @param buf Output buffer, typically the NC payload
+ * @param buf_len Size of buf in bytes
+ * @return Number of bytes written, or -1 if the message does not fit
+ */
+int serialize_tc_message(uint8_t* buf, size_t buf_len);
+
 /**
  * @brief Send a TC message
+ * @param nc_payload NC payload buffer to fill, ready for enqueue_olsr_nc_packet()
+ * @param payload_len Size of nc_payload in bytes
+ * @return Bytes written, 0 if there are no MPR selectors, -1 on failure
  */
-void send_tc_message(void);
+int send_tc_message(uint8_t* nc_payload, size_t payload_len);
 
 /**
  * @brief Process a received TC message
@@ -53,6 +64,14 @@ int push_tc_to_queue(struct control_queue* queue);
  */
 int get_mpr_selector_count(void);
 
+/**
+ * @brief Copy the current MPR selector set
+ * @param out Output array
+ * @param max Capacity of out
+ * @return Number of selectors written
+ */
+int get_mpr_selectors(uint32_t* out, int max);
+
 /**
  * @brief Get current ANSN value
  * @return Current ANSN (Advertised Neighbor Sequence Number)
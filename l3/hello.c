@@ -18,6 +18,7 @@
 #include "../include/hello.h"
 #include "../include/olsr.h"
 #include "../include/packet.h"
+#include "../include/mpr.h"
 
 /** @brief Global neighbor table array */
 struct neighbor_entry neighbor_table[MAX_NEIGHBORS];
@@ -30,6 +31,20 @@ uint32_t node_ip = 0;
 /** @brief Global message sequence number counter */
 uint16_t message_seq_num = 0;
 
+/**
+ * @brief Link code advertised for a neighbor table entry
+ *
+ * The link type is the sensed link status; the neighbor type is MPR_NEIGH
+ * or SYM_NEIGH for symmetric links and NOT_NEIGH otherwise.
+ */
+static uint8_t hello_link_code(const struct neighbor_entry* entry) {
+    uint8_t neigh_type = NOT_NEIGH;
+    if (entry->link_status == SYM_LINK) {
+        neigh_type = entry->is_mpr ? MPR_NEIGH : SYM_NEIGH;
+    }
+    return OLSR_LINK_CODE(neigh_type, entry->link_status & 0x03);
+}
+
 /**
  * @brief Generate a HELLO message
  * 
@@ -37,16 +52,13 @@ uint16_t message_seq_num = 0;
  * willingness value and neighbor information. The message is used for
  * neighbor discovery and link sensing in the OLSR protocol.
  * 
- * @return Pointer to newly allocated HELLO message, or NULL on failure
+ * @param arena Scratch arena that holds the message and its neighbor list
+ * @return Pointer to the HELLO message inside arena, or NULL on failure
  * 
- * @note The caller is responsible for freeing the returned message
- * @note If neighbor_count > 0, neighbor information is not included
- *       in this simplified implementation
+ * @note The message lives as long as the arena; nothing needs freeing
  */
-struct olsr_hello* generate_hello_message(void) {
-    static struct olsr_hello hello_msg_static;
-    struct olsr_hello* hello_msg = &hello_msg_static;
-    memset(hello_msg, 0, sizeof(struct olsr_hello));
+struct olsr_hello* generate_hello_message(struct olsr_arena* arena) {
+    struct olsr_hello* hello_msg = olsr_arena_alloc(arena, sizeof(struct olsr_hello));
     if (!hello_msg) {
         printf("Error: Failed to allocate memory for HELLO message\n");
         return NULL;
@@ -55,22 +67,18 @@ struct olsr_hello* generate_hello_message(void) {
     hello_msg->hello_interval = HELLO_INTERVAL;
     hello_msg->willingness = node_willingness;
     hello_msg->neighbor_count = neighbor_count;
+    hello_msg->self_link_code = -1;
 
     if (neighbor_count > 0) {
-        static struct hello_neighbor neighbors_static[MAX_NEIGHBORS];
-        hello_msg->neighbors = &neighbors_static;
-        memset(hello_msg->neighbors, 0, neighbor_count * sizeof(struct hello_neighbor));
-        
-        // Allocate and fill neighbor information
+        hello_msg->neighbors = olsr_arena_alloc(arena, neighbor_count * sizeof(struct hello_neighbor));
         if (!hello_msg->neighbors) {
             printf("Error: Failed to allocate memory for neighbors list\n");
-            free(hello_msg);
             return NULL;
         }
         
         for (int i = 0; i < neighbor_count; i++) {
             hello_msg->neighbors[i].neighbor_addr = neighbor_table[i].neighbor_addr;
-            hello_msg->neighbors[i].link_code = neighbor_table[i].link_status;
+            hello_msg->neighbors[i].link_code = hello_link_code(&neighbor_table[i]);
         }
     } else {
         hello_msg->neighbors = NULL;
@@ -83,53 +91,164 @@ struct olsr_hello* generate_hello_message(void) {
 }
 
 /**
- * @brief Send a HELLO message
+ * @brief Serialize a HELLO message straight from the neighbor table
  * 
- * Generates a HELLO message, wraps it in an OLSR message header,
- * and simulates transmission. This function handles message creation,
- * sequence number assignment, and logging.
+ * Writes the message header, the HELLO header and one link message block
+ * per distinct link code into buf. No intermediate structs are built and
+ * nothing is allocated.
  * 
- * @note In this implementation, no actual network transmission occurs.
- *       The function demonstrates message creation and logging only.
+ * @param buf Output buffer, typically the NC payload
+ * @param buf_len Size of buf in bytes
+ * @return Number of bytes written, or -1 if the message does not fit
  */
-void send_hello_message(struct control_queue* queue) {
+int serialize_hello_message(uint8_t* buf, size_t buf_len) {
+    if (!buf || buf_len < OLSR_MSG_HEADER_SIZE + OLSR_HELLO_HEADER_SIZE) {
+        return -1;
+    }
 
-    struct olsr_hello* hello_msg = generate_hello_message();
-    if (!hello_msg) {
-        printf("Error: Failed to generate HELLO message\n");
-        return;
+    // Drop neighbors past their hold time, then advertise the current
+    // MPR set as MPR_NEIGH link codes
+    expire_neighbors(time(NULL));
+    mpr_recalculate();
+
+    size_t pos = OLSR_MSG_HEADER_SIZE;
+    buf[pos++] = 0;  // Reserved
+    buf[pos++] = 0;
+    buf[pos++] = olsr_encode_time(HELLO_INTERVAL);
+    buf[pos++] = node_willingness;
+
+    uint32_t codes_done = 0;
+    for (int i = 0; i < neighbor_count; i++) {
+        uint8_t code = hello_link_code(&neighbor_table[i]);
+        if (codes_done & (1u << code)) {
+            continue;
+        }
+        codes_done |= 1u << code;
+
+        size_t block = pos;
+        if (buf_len - pos < OLSR_LINK_BLOCK_HEADER_SIZE) {
+            return -1;
+        }
+        pos += OLSR_LINK_BLOCK_HEADER_SIZE;
+
+        for (int j = i; j < neighbor_count; j++) {
+            if (hello_link_code(&neighbor_table[j]) != code) {
+                continue;
+            }
+            if (buf_len - pos < OLSR_ADDR_SIZE) {
+                return -1;
+            }
+            memcpy(&buf[pos], &neighbor_table[j].neighbor_addr, OLSR_ADDR_SIZE);
+            pos += OLSR_ADDR_SIZE;
+        }
+
+        size_t block_size = pos - block;
+        buf[block] = code;
+        buf[block + 1] = 0;  // Reserved
+        buf[block + 2] = (uint8_t)(block_size >> 8);
+        buf[block + 3] = (uint8_t)block_size;
     }
-    
-    // Create OLSR message header
+
     struct olsr_message msg;
-    msg.msg_type = MSG_HELLO;      /**< Set message type to HELLO */
-    msg.vtime = 6;                 /**< Validity time (encoded) */
-    msg.originator = node_ip;      /**< Set originator to this node's IP */
+    msg.msg_type = MSG_HELLO;
+    msg.vtime = 6;
+    msg.msg_size = (uint16_t)pos;
+    msg.originator = node_ip;
     msg.ttl = 1;                   /**< TTL = 1 for HELLO (one-hop only) */
-    msg.hop_count = 0;             /**< Initial hop count */
-    msg.msg_seq_num = ++message_seq_num; /**< Increment and assign sequence number */
-    msg.body = hello_msg;          /**< Attach HELLO message body */
-    
-    // Calculate total message size
-    msg.msg_size = sizeof(struct olsr_message) + sizeof(struct olsr_hello) + 
-                   (hello_msg->neighbor_count * sizeof(struct hello_neighbor));
+    msg.hop_count = 0;
+    msg.msg_seq_num = __atomic_add_fetch(&message_seq_num, 1, __ATOMIC_RELAXED);
+    msg.body = NULL;
+    olsr_write_message_header(&msg, buf);
 
-    // Debugging output
-    printf("HELLO message sent (type=%d, size=%d bytes, seq=%d)\n", 
-           msg.msg_type, msg.msg_size, msg.msg_seq_num);
-    printf("Willingness: %d, Neighbors: %d\n", 
-           hello_msg->willingness, hello_msg->neighbor_count);
+    return (int)pos;
+}
+
+/**
+ * @brief Parse a HELLO body (after the message header)
+ * 
+ * Validates every link message block before anything is copied, then
+ * places the HELLO and its neighbor list in arena.
+ * 
+ * @param buf HELLO body
+ * @param len Length of the body in bytes
+ * @param arena Scratch arena for the parsed message
+ * @return Parsed HELLO, or NULL if malformed or the arena is too small
+ */
+struct olsr_hello* parse_hello_body(const uint8_t* buf, size_t len, struct olsr_arena* arena) {
+    if (!buf || len < OLSR_HELLO_HEADER_SIZE) {
+        return NULL;
+    }
+
+    int count = 0;
+    size_t pos = OLSR_HELLO_HEADER_SIZE;
+    while (pos < len) {
+        if (len - pos < OLSR_LINK_BLOCK_HEADER_SIZE) {
+            return NULL;
+        }
+        size_t block_size = (size_t)((buf[pos + 2] << 8) | buf[pos + 3]);
+        if (block_size < OLSR_LINK_BLOCK_HEADER_SIZE || block_size > len - pos ||
+            (block_size - OLSR_LINK_BLOCK_HEADER_SIZE) % OLSR_ADDR_SIZE != 0) {
+            return NULL;
+        }
+        count += (int)((block_size - OLSR_LINK_BLOCK_HEADER_SIZE) / OLSR_ADDR_SIZE);
+        pos += block_size;
+    }
 
-    if(!queue){
-      printf("Error: Control queue is NULL\n");
-      return;
+    struct olsr_hello* hello_msg = olsr_arena_alloc(arena, sizeof(struct olsr_hello));
+    if (!hello_msg) {
+        return NULL;
+    }
+    hello_msg->hello_interval = olsr_decode_time(buf[2]);
+    hello_msg->willingness = buf[3];
+    hello_msg->self_link_code = -1;
+
+    if (count > 0) {
+        hello_msg->neighbors = olsr_arena_alloc(arena, count * sizeof(struct hello_neighbor));
+        if (!hello_msg->neighbors) {
+            return NULL;
+        }
     }
-    if(push_hello_to_queue(queue)==0){
-      printf("HELLO Message successfully queued for MAC Layer\n");
+
+    pos = OLSR_HELLO_HEADER_SIZE;
+    while (pos < len) {
+        uint8_t code = buf[pos];
+        size_t block_end = pos + (size_t)((buf[pos + 2] << 8) | buf[pos + 3]);
+        for (pos += OLSR_LINK_BLOCK_HEADER_SIZE; pos < block_end; pos += OLSR_ADDR_SIZE) {
+            struct hello_neighbor* n = &hello_msg->neighbors[hello_msg->neighbor_count++];
+            memcpy(&n->neighbor_addr, &buf[pos], OLSR_ADDR_SIZE);
+            n->link_code = code;
+            if (n->neighbor_addr == node_ip) {
+                hello_msg->self_link_code = code;
+            }
+        }
     }
-    else{
-      printf("ERROR: Failed to queue HELLO Message\n");
+
+    return hello_msg;
+}
+
+/**
+ * @brief Send a HELLO message
+ * 
+ * Serializes a HELLO message into the caller's NC payload buffer, ready
+ * to be handed to the RRC with enqueue_olsr_nc_packet().
+ * 
+ * @param nc_payload NC payload buffer to fill
+ * @param payload_len Size of nc_payload in bytes
+ * @return Number of bytes written, or -1 on failure
+ */
+int send_hello_message(uint8_t* nc_payload, size_t payload_len) {
+    int len = serialize_hello_message(nc_payload, payload_len);
+    if (len < 0) {
+        printf("Error: HELLO message does not fit in %zu bytes\n", payload_len);
+        return -1;
     }
+
+    // Debugging output
+    printf("HELLO message sent (type=%d, size=%d bytes, seq=%d)\n", 
+           MSG_HELLO, len, message_seq_num);
+    printf("Willingness: %d, Neighbors: %d\n", node_willingness, neighbor_count);
+
+    return len;
 }
 
 /**
@@ -156,35 +275,34 @@ void process_hello_message(struct olsr_message* msg, uint32_t sender_addr) {
            inet_ntoa(*(struct in_addr*)&sender_addr),
            hello_msg->willingness, hello_msg->neighbor_count);
     
-    // Check if we are mentioned in the sender's neighbor list (bidirectional link)
-    int we_are_mentioned = 0;
-    for (int i = 0; i < hello_msg->neighbor_count; i++) {
-        if (hello_msg->neighbors[i].neighbor_addr == node_ip) {
-            we_are_mentioned = 1;
-            printf("We are mentioned in neighbor's HELLO message\n");
-            break;
-        }
+    // The parser already noted whether we are listed (bidirectional link)
+    int we_are_mentioned = hello_msg->self_link_code >= 0 &&
+                           OLSR_LINK_TYPE(hello_msg->self_link_code) != LOST_LINK;
+    if (we_are_mentioned) {
+        printf("We are mentioned in neighbor's HELLO message\n");
     }
-    
+
     // Update link status based on bidirectional communication
-    if (we_are_mentioned) {
-        update_neighbor(sender_addr, SYM_LINK, hello_msg->willingness);
-    } else {
-        update_neighbor(sender_addr, ASYM_LINK, hello_msg->willingness);
+    uint8_t link_code = we_are_mentioned ? SYM_LINK : ASYM_LINK;
+    if (update_neighbor(sender_addr, link_code, hello_msg->willingness) < 0) {
+        add_neighbor(sender_addr, link_code, hello_msg->willingness);
     }
+
+    // Two-hop coverage and MPR selector set; the MPR set is recomputed
+    // lazily before the next HELLO, and only if this changed anything
+    mpr_process_hello(sender_addr, hello_msg, we_are_mentioned);
 }
 
 /**
  * @brief Push a HELLO message to the control queue
  * 
- * Creates a new HELLO message and adds it to the specified control queue
- * for later processing. This function combines message generation with
- * queue management.
+ * Serializes a new HELLO message and adds it to the specified control
+ * queue for later transmission.
  * 
  * @param queue Pointer to the control queue where the message will be stored
  * @return 0 on success, -1 on failure
  * 
- * @note The control queue takes ownership of the message data
+ * @note The control queue copies the serialized bytes
  */
 int push_hello_to_queue(struct control_queue* queue) {
     if (!queue) {
@@ -192,18 +310,19 @@ int push_hello_to_queue(struct control_queue* queue) {
         return -1;
     }
 
-    // Generate HELLO message
-    struct olsr_hello* hello_msg = generate_hello_message();
-    if (!hello_msg) {
+    // Serialize HELLO message
+    uint8_t buf[OLSR_MAX_MESSAGE_SIZE];
+    int len = serialize_hello_message(buf, sizeof(buf));
+    if (len < 0) {
         printf("Error: Failed to generate HELLO message\n");
         return -1;
     }
 
     // Push to control queue
-    int result = push_to_control_queue(queue, MSG_HELLO, hello_msg, sizeof(struct olsr_hello));
+    int result = push_to_control_queue(queue, MSG_HELLO, buf, len);
     
-    printf("HELLO message created and queued (willingness=%d, neighbors=%d)\n", 
-           hello_msg->willingness, hello_msg->neighbor_count);
+    printf("HELLO message created and queued (willingness=%d, neighbors=%d, %d bytes)\n", 
+           node_willingness, neighbor_count, len);
     
     return result;
 }
@@ -2,23 +2,72 @@
 #include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
+#include <poll.h>
+#include <time.h>
 #include "../include/hello.h"
 #include "../include/tc.h"
 #include "../include/olsr.h"
+#include "../include/mpr.h"
 #include "../include/routing.h"
+#include "../include/rrc_notify.h"
 
 void init_olsr(void){
     // Initialization code for OLSR daemon
     // Set up sockets, timers, data structures, etc.
     printf("OLSR Daemon Initialized\n");
-    generate_hello_message();
-    send_hello_message();
-    send_tc_message();
+    uint8_t nc_payload[OLSR_MAX_MESSAGE_SIZE];
+    send_hello_message(nc_payload, sizeof(nc_payload));
+    send_tc_message(nc_payload, sizeof(nc_payload));
     // Further initialization as needed
 }
+
+/**
+ * @brief OLSR daemon loop
+ *
+ * Sends HELLO and TC on their intervals and expires neighbors. The wait
+ * is cut short by routing_pending_delay_ms(), so a triggered routing
+ * recomputation runs as soon as its hold-down window has passed, and by
+ * RRC route requests, which are answered from the current table.
+ */
+static void run_olsr(void) {
+    uint8_t nc_payload[OLSR_MAX_MESSAGE_SIZE];
+    time_t next_hello = time(NULL) + HELLO_INTERVAL;
+    time_t next_tc = time(NULL) + TC_INTERVAL;
+
+    for (;;) {
+        time_t now = time(NULL);
+        expire_neighbors(now);
+        mpr_recalculate();
+
+        if (now >= next_hello) {
+            send_hello_message(nc_payload, sizeof(nc_payload));
+            next_hello = now + HELLO_INTERVAL;
+        }
+        if (now >= next_tc) {
+            send_tc_message(nc_payload, sizeof(nc_payload));
+            next_tc = now + TC_INTERVAL;
+        }
+
+        routing_run_pending();
+        rrc_notify_serve_requests();
+
+        time_t next_timer = next_hello < next_tc ? next_hello : next_tc;
+        int timeout_ms = (int)(next_timer - time(NULL)) * 1000;
+        int routing_ms = routing_pending_delay_ms();
+        if (routing_ms >= 0 && routing_ms < timeout_ms) {
+            timeout_ms = routing_ms;
+        }
+        if (timeout_ms > 0) {
+            struct pollfd pfd = { .fd = rrc_notify_request_fd(), .events = POLLIN };
+            poll(&pfd, 1, timeout_ms);  // fd -1 (RRC not up) is ignored by poll
+        }
+    }
+}
+
 int main() {
     printf("OLSR Daemon Starting...\n");
     // Initialization code here
     init_olsr();
+    run_olsr();
     return 0;
-}
\ No newline at end of file
+}
@@ -1,17 +1,380 @@
-#include "../include/olsr.h"
-#include "../include/hello.h"
+/**
+ * @file mpr.c
+ * @brief MPR selection with bitset two-hop coverage
+ * @author OLSR Implementation Team
+ * @date 2025-10-02
+ *
+ * Every two-hop node gets a bit index. Each one-hop neighbor stores the
+ * set of two-hop nodes it reaches as a bitset, so coverage, uniqueness and
+ * reachability in the RFC 3626 heuristic are a few word operations per
+ * neighbor. A HELLO only triggers a recalculation when it actually
+ * changes a neighbor's coverage or eligibility.
+ */
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <stdint.h>
 #include <arpa/inet.h>
-#include <unistd.h>
-#include <time.h>
-
-/** @brief Maximum number of nodes in the topology */
-#define MAX_NODES 50
-/** @brief Maximum entries in the routing table */
-#define MAX_ROUTING_ENTRIES 100
-/** @brief Infinite cost for unreachable nodes */
-#define INFINITE_COST INT_MAX
-/** @brief Routing table entry structure */
+#include "../include/olsr.h"
+#include "../include/packet.h"
+#include "../include/hello.h"
+#include "../include/tc.h"
+#include "../include/mpr.h"
+#include "../include/rrc_notify.h"
+
+/** @brief One-hop neighbor as seen by MPR selection */
+struct mpr_one_hop {
+    uint32_t addr;                           /**< Neighbor address */
+    int in_use;                              /**< Slot holds a neighbor */
+    int eligible;                            /**< Symmetric and willingness != WILL_NEVER */
+    uint8_t willingness;                     /**< Neighbor's willingness */
+    uint64_t coverage[MPR_TWO_HOP_WORDS];    /**< Two-hop nodes reachable through it */
+};
+
+/** @brief Two-hop node with the number of neighbors that reach it */
+struct mpr_two_hop {
+    uint32_t addr;                           /**< Two-hop node address */
+    uint16_t refs;                           /**< Covering one-hop neighbors; 0 = free */
+};
+
+static struct mpr_one_hop one_hop[MAX_NEIGHBORS];  /**< Parallel to neighbor_table */
+static struct mpr_two_hop two_hop[MPR_MAX_TWO_HOP];
+
+/** @brief Current MPR set */
+static uint32_t mpr_set[MAX_NEIGHBORS];
+static int mpr_count = 0;
+/** @brief Set when coverage or eligibility changed since the last selection */
+static int mpr_dirty = 0;
+
+static struct {
+    uint32_t hello_updates;
+    uint32_t unchanged_updates;
+    uint32_t recalculations;
+    uint32_t two_hop_overflows;
+} mpr_stats = {0};
+
+static int popcount_set(const uint64_t* set) {
+    int n = 0;
+    for (int w = 0; w < MPR_TWO_HOP_WORDS; w++) {
+        n += __builtin_popcountll(set[w]);
+    }
+    return n;
+}
+
+static int popcount_and(const uint64_t* a, const uint64_t* b) {
+    int n = 0;
+    for (int w = 0; w < MPR_TWO_HOP_WORDS; w++) {
+        n += __builtin_popcountll(a[w] & b[w]);
+    }
+    return n;
+}
+
+/** @brief MPR state of a neighbor; one_hop[] is indexed like neighbor_table */
+static struct mpr_one_hop* find_one_hop(uint32_t addr, int create) {
+    struct neighbor_entry* entry = find_neighbor(addr);
+    if (!entry) {
+        return NULL;
+    }
+
+    struct mpr_one_hop* n = &one_hop[entry - neighbor_table];
+    if (!n->in_use) {
+        if (!create) {
+            return NULL;
+        }
+        memset(n, 0, sizeof(*n));
+        n->addr = addr;
+        n->in_use = 1;
+    }
+    return n;
+}
+
+/**
+ * @brief Bit index for a two-hop address, allocating one if needed
+ * @param addr Two-hop node address
+ * @param pending Coverage being built; its bits count as taken
+ * @return Bit index, or -1 if the two-hop table is full
+ */
+static int two_hop_index(uint32_t addr, const uint64_t* pending) {
+    int free_idx = -1;
+    for (int i = 0; i < MPR_MAX_TWO_HOP; i++) {
+        int taken = two_hop[i].refs > 0 || ((pending[i / 64] >> (i % 64)) & 1);
+        if (taken && two_hop[i].addr == addr) {
+            return i;
+        }
+        if (!taken && free_idx < 0) {
+            free_idx = i;
+        }
+    }
+    if (free_idx >= 0) {
+        two_hop[free_idx].addr = addr;
+    }
+    return free_idx;
+}
+
+/** @brief Replace a neighbor's coverage, keeping two-hop reference counts in step */
+static void set_coverage(struct mpr_one_hop* n, const uint64_t* coverage) {
+    for (int w = 0; w < MPR_TWO_HOP_WORDS; w++) {
+        uint64_t added = coverage[w] & ~n->coverage[w];
+        uint64_t removed = n->coverage[w] & ~coverage[w];
+        while (added) {
+            two_hop[w * 64 + __builtin_ctzll(added)].refs++;
+            added &= added - 1;
+        }
+        while (removed) {
+            two_hop[w * 64 + __builtin_ctzll(removed)].refs--;
+            removed &= removed - 1;
+        }
+        n->coverage[w] = coverage[w];
+    }
+}
+
+/**
+ * @brief Update the two-hop set and MPR selector set from a HELLO
+ * @param sender_addr Address of the HELLO originator
+ * @param hello Parsed HELLO message
+ * @param symmetric 1 if the link to the sender is symmetric
+ */
+void mpr_process_hello(uint32_t sender_addr, const struct olsr_hello* hello, int symmetric) {
+    if (!hello) {
+        return;
+    }
+
+    struct mpr_one_hop* n = find_one_hop(sender_addr, 1);
+    if (!n) {
+        printf("Error: HELLO sender not in neighbor table\n");
+        return;
+    }
+    mpr_stats.hello_updates++;
+
+    uint64_t coverage[MPR_TWO_HOP_WORDS] = {0};
+    int selected_us = 0;
+
+    for (int i = 0; i < hello->neighbor_count; i++) {
+        uint32_t addr = hello->neighbors[i].neighbor_addr;
+        uint8_t neigh_type = OLSR_NEIGH_TYPE(hello->neighbors[i].link_code);
+
+        if (addr == node_ip) {
+            selected_us = (neigh_type == MPR_NEIGH);
+            continue;
+        }
+        if (neigh_type != SYM_NEIGH && neigh_type != MPR_NEIGH) {
+            continue;
+        }
+
+        int idx = two_hop_index(addr, coverage);
+        if (idx < 0) {
+            mpr_stats.two_hop_overflows++;
+            continue;
+        }
+        coverage[idx / 64] |= 1ULL << (idx % 64);
+    }
+
+    // A sender that lists us as MPR_NEIGH selected us: it goes into our TC
+    if (selected_us && symmetric) {
+        add_mpr_selector(sender_addr);
+    } else {
+        remove_mpr_selector(sender_addr);
+    }
+
+    int eligible = symmetric && hello->willingness != WILL_NEVER;
+    int changed = (eligible != n->eligible) || (hello->willingness != n->willingness) ||
+                  memcmp(coverage, n->coverage, sizeof(coverage)) != 0;
+
+    // Two-hop nodes no longer referenced by any neighbor free their index
+    set_coverage(n, coverage);
+    n->eligible = eligible;
+    n->willingness = hello->willingness;
+
+    if (changed) {
+        mpr_dirty = 1;
+    } else {
+        mpr_stats.unchanged_updates++;
+    }
+}
+
+/**
+ * @brief Forget a one-hop neighbor and the two-hop nodes only it covered
+ * @param neighbor_addr Address of the lost neighbor
+ */
+void mpr_remove_neighbor(uint32_t neighbor_addr) {
+    struct mpr_one_hop* n = find_one_hop(neighbor_addr, 0);
+    if (!n) {
+        return;
+    }
+
+    uint64_t none[MPR_TWO_HOP_WORDS] = {0};
+    set_coverage(n, none);
+    n->in_use = 0;
+    remove_mpr_selector(neighbor_addr);
+    mpr_dirty = 1;
+}
+
+/**
+ * @brief Follow a neighbor moved to another neighbor_table slot
+ * @param from Old slot
+ * @param to New slot
+ */
+void mpr_move_neighbor(int from, int to) {
+    one_hop[to] = one_hop[from];
+    memset(&one_hop[from], 0, sizeof(one_hop[from]));
+}
+
+/**
+ * @brief Recalculate the MPR set if the neighborhood changed
+ *
+ * RFC 3626 section 8.3.1: start from WILL_ALWAYS neighbors, add every
+ * neighbor that is the only path to some two-hop node, then repeatedly
+ * take the neighbor with the highest willingness, then reachability, then
+ * degree, until all strict two-hop nodes are covered.
+ *
+ * @return 1 if the MPR set was recalculated, 0 if it was already current
+ */
+int mpr_recalculate(void) {
+    if (!mpr_dirty) {
+        rrc_notify_poll();
+        return 0;
+    }
+    mpr_dirty = 0;
+    mpr_stats.recalculations++;
+
+    // N2: strict two-hop nodes, i.e. not ourselves and not a one-hop neighbor
+    uint64_t n2[MPR_TWO_HOP_WORDS] = {0};
+    for (int i = 0; i < MAX_NEIGHBORS; i++) {
+        if (one_hop[i].in_use && one_hop[i].eligible) {
+            for (int w = 0; w < MPR_TWO_HOP_WORDS; w++) {
+                n2[w] |= one_hop[i].coverage[w];
+            }
+        }
+    }
+    for (int b = 0; b < MPR_MAX_TWO_HOP; b++) {
+        if ((n2[b / 64] >> (b % 64)) & 1) {
+            if (two_hop[b].addr == node_ip || neighbor_is_symmetric(two_hop[b].addr)) {
+                n2[b / 64] &= ~(1ULL << (b % 64));
+            }
+        }
+    }
+
+    // Nodes reached by exactly one eligible neighbor
+    uint64_t once[MPR_TWO_HOP_WORDS] = {0};
+    uint64_t twice[MPR_TWO_HOP_WORDS] = {0};
+    for (int i = 0; i < MAX_NEIGHBORS; i++) {
+        if (one_hop[i].in_use && one_hop[i].eligible) {
+            for (int w = 0; w < MPR_TWO_HOP_WORDS; w++) {
+                twice[w] |= once[w] & one_hop[i].coverage[w];
+                once[w] |= one_hop[i].coverage[w];
+            }
+        }
+    }
+
+    int selected[MAX_NEIGHBORS] = {0};
+    uint64_t uncovered[MPR_TWO_HOP_WORDS];
+    memcpy(uncovered, n2, sizeof(uncovered));
+
+    for (int i = 0; i < MAX_NEIGHBORS; i++) {
+        if (!one_hop[i].in_use || !one_hop[i].eligible) {
+            continue;
+        }
+        int take = (one_hop[i].willingness == WILL_ALWAYS);
+        for (int w = 0; w < MPR_TWO_HOP_WORDS && !take; w++) {
+            take = (one_hop[i].coverage[w] & once[w] & ~twice[w] & n2[w]) != 0;
+        }
+        if (take) {
+            selected[i] = 1;
+            for (int w = 0; w < MPR_TWO_HOP_WORDS; w++) {
+                uncovered[w] &= ~one_hop[i].coverage[w];
+            }
+        }
+    }
+
+    while (popcount_set(uncovered) > 0) {
+        int best = -1;
+        int best_reach = 0;
+        int best_degree = 0;
+        for (int i = 0; i < MAX_NEIGHBORS; i++) {
+            if (!one_hop[i].in_use || !one_hop[i].eligible || selected[i]) {
+                continue;
+            }
+            int reach = popcount_and(one_hop[i].coverage, uncovered);
+            if (reach == 0) {
+                continue;
+            }
+            int degree = popcount_and(one_hop[i].coverage, n2);
+            if (best < 0 ||
+                one_hop[i].willingness > one_hop[best].willingness ||
+                (one_hop[i].willingness == one_hop[best].willingness &&
+                 (reach > best_reach || (reach == best_reach && degree > best_degree)))) {
+                best = i;
+                best_reach = reach;
+                best_degree = degree;
+            }
+        }
+        if (best < 0) {
+            break;  // Remaining nodes are unreachable through eligible neighbors
+        }
+        selected[best] = 1;
+        for (int w = 0; w < MPR_TWO_HOP_WORDS; w++) {
+            uncovered[w] &= ~one_hop[best].coverage[w];
+        }
+    }
+
+    mpr_count = 0;
+    for (int i = 0; i < MAX_NEIGHBORS; i++) {
+        if (selected[i]) {
+            mpr_set[mpr_count++] = one_hop[i].addr;
+        }
+    }
+    for (int i = 0; i < neighbor_count; i++) {
+        neighbor_table[i].is_mpr = selected[i];
+    }
+
+    printf("MPR set recalculated: %d MPRs cover %d two-hop nodes\n",
+           mpr_count, popcount_set(n2));
+    rrc_notify_mpr_update();
+    return 1;
+}
+
+/**
+ * @brief Check whether a neighbor is currently selected as MPR
+ * @param neighbor_addr Address of the neighbor
+ * @return 1 if selected, 0 otherwise
+ */
+int mpr_is_selected(uint32_t neighbor_addr) {
+    for (int i = 0; i < mpr_count; i++) {
+        if (mpr_set[i] == neighbor_addr) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief Copy the current MPR set
+ * @param out Output array
+ * @param max Capacity of out
+ * @return Number of MPRs written
+ */
+int mpr_get_set(uint32_t* out, int max) {
+    int n = mpr_count < max ? mpr_count : max;
+    memcpy(out, mpr_set, n * sizeof(uint32_t));
+    return n;
+}
+
+/**
+ * @brief Print the MPR set and two-hop coverage
+ */
+void print_mpr_set(void) {
+    printf("\n=== MPR Set (%d) ===\n", mpr_count);
+    for (int i = 0; i < MAX_NEIGHBORS; i++) {
+        if (!one_hop[i].in_use) {
+            continue;
+        }
+        printf("%-15s %s willingness=%d covers=%d\n",
+               inet_ntoa(*(struct in_addr*)&one_hop[i].addr),
+               mpr_is_selected(one_hop[i].addr) ? "MPR" : "   ",
+               one_hop[i].willingness, popcount_set(one_hop[i].coverage));
+    }
+    printf("HELLO updates: %u (unchanged: %u), recalculations: %u, two-hop overflows: %u\n",
+           mpr_stats.hello_updates, mpr_stats.unchanged_updates,
+           mpr_stats.recalculations, mpr_stats.two_hop_overflows);
+}
@@ -1,3 +1,18 @@
+/**
+ * @file neighbor.c
+ * @brief Hashed one-hop neighbor table
+ * @author OLSR Implementation Team
+ * @date 2025-10-02
+ *
+ * neighbor_table stays a dense array (slots 0..neighbor_count-1) so that
+ * HELLO generation and routing can iterate it directly. Lookups by
+ * address go through an open-addressed index with linear probing and
+ * backward-shift deletion, so there are no tombstones. Entries are also
+ * threaded on an intrusive list in last_seen order; expiry pops from the
+ * head and never scans the table. A bitset with one bit per slot records
+ * which neighbors listed this node in their last HELLO (symmetric links).
+ */
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -9,39 +24,267 @@
 #include "../include/routing.h"
 #include "../include/tc.h"
 #include "../include/hello.h"
+#include "../include/mpr.h"
 #include "../include/packet.h"
 
-void update_neighbor(uint32_t neighbor_addr, int link_type, uint8_t willingness){
-    for (int i = 0; i < neighbor_count; i++) {
-        if (neighbor_table[i].neighbor_addr == neighbor_addr) {
-            neighbor_table[i].link_status = link_type;
-            neighbor_table[i].willingness = willingness;
-            neighbor_table[i].last_seen = time(NULL);
-            printf("Updated neighbor: %s (link_type=%d, willingness=%d)\n",
-                   inet_ntoa(*(struct in_addr*)&neighbor_addr),
-                   link_type, willingness);
-            return;
+#define NEIGHBOR_HASH_BITS 9
+#define NEIGHBOR_HASH_SIZE (1 << NEIGHBOR_HASH_BITS) /**< At most 50% load at MAX_NEIGHBORS */
+#define NEIGHBOR_SLOT_NONE (-1)
+
+/** @brief Address → neighbor_table slot, NEIGHBOR_SLOT_NONE when empty */
+static int16_t neighbor_index[NEIGHBOR_HASH_SIZE];
+static int neighbor_index_ready = 0;
+
+/** @brief Expiry list in last_seen order: head is the stalest neighbor */
+static int expiry_head = NEIGHBOR_SLOT_NONE;
+static int expiry_tail = NEIGHBOR_SLOT_NONE;
+
+/** @brief Bit per slot: neighbor listed us in its last HELLO */
+static uint64_t heard_us[(MAX_NEIGHBORS + 63) / 64];
+
+static uint32_t neighbor_hash(uint32_t addr) {
+    return (addr * 2654435761u) >> (32 - NEIGHBOR_HASH_BITS);
+}
+
+static void neighbor_index_init(void) {
+    memset(neighbor_index, 0xFF, sizeof(neighbor_index));  // All NEIGHBOR_SLOT_NONE
+    neighbor_index_ready = 1;
+}
+
+/** @brief Hash bucket holding addr, or the empty bucket where it would go */
+static uint32_t neighbor_bucket(uint32_t addr) {
+    uint32_t b = neighbor_hash(addr);
+    while (neighbor_index[b] != NEIGHBOR_SLOT_NONE &&
+           neighbor_table[neighbor_index[b]].neighbor_addr != addr) {
+        b = (b + 1) & (NEIGHBOR_HASH_SIZE - 1);
+    }
+    return b;
+}
+
+/** @brief Remove a bucket, shifting later probes back to keep chains unbroken */
+static void neighbor_index_delete(uint32_t b) {
+    uint32_t hole = b;
+    uint32_t next = (b + 1) & (NEIGHBOR_HASH_SIZE - 1);
+
+    while (neighbor_index[next] != NEIGHBOR_SLOT_NONE) {
+        uint32_t home = neighbor_hash(neighbor_table[neighbor_index[next]].neighbor_addr);
+        // Move next into the hole unless its home lies cyclically in (hole, next]
+        if (((next - home) & (NEIGHBOR_HASH_SIZE - 1)) >= ((next - hole) & (NEIGHBOR_HASH_SIZE - 1))) {
+            neighbor_index[hole] = neighbor_index[next];
+            hole = next;
         }
+        next = (next + 1) & (NEIGHBOR_HASH_SIZE - 1);
+    }
+    neighbor_index[hole] = NEIGHBOR_SLOT_NONE;
+}
+
+static void expiry_unlink(int slot) {
+    struct neighbor_entry* n = &neighbor_table[slot];
+    if (n->expiry_prev != NEIGHBOR_SLOT_NONE) {
+        neighbor_table[n->expiry_prev].expiry_next = n->expiry_next;
+    } else {
+        expiry_head = n->expiry_next;
+    }
+    if (n->expiry_next != NEIGHBOR_SLOT_NONE) {
+        neighbor_table[n->expiry_next].expiry_prev = n->expiry_prev;
+    } else {
+        expiry_tail = n->expiry_prev;
+    }
+    n->expiry_prev = n->expiry_next = NEIGHBOR_SLOT_NONE;
+}
+
+/** @brief Append at the tail: the neighbor was just heard */
+static void expiry_append(int slot) {
+    struct neighbor_entry* n = &neighbor_table[slot];
+    n->expiry_prev = expiry_tail;
+    n->expiry_next = NEIGHBOR_SLOT_NONE;
+    if (expiry_tail != NEIGHBOR_SLOT_NONE) {
+        neighbor_table[expiry_tail].expiry_next = slot;
+    } else {
+        expiry_head = slot;
+    }
+    expiry_tail = slot;
+}
+
+static void set_heard_us(int slot, int heard) {
+    if (heard) {
+        heard_us[slot / 64] |= 1ULL << (slot % 64);
+    } else {
+        heard_us[slot / 64] &= ~(1ULL << (slot % 64));
+    }
+}
+
+/**
+ * @brief Find a neighbor in the neighbor table
+ * @param addr IP address of the neighbor to find
+ * @return Pointer to neighbor entry if found, NULL otherwise
+ */
+struct neighbor_entry* find_neighbor(uint32_t addr) {
+    if (!neighbor_index_ready) {
+        return NULL;
+    }
+    int16_t slot = neighbor_index[neighbor_bucket(addr)];
+    return slot == NEIGHBOR_SLOT_NONE ? NULL : &neighbor_table[slot];
+}
+
+/**
+ * @brief Check whether the link to a neighbor is symmetric
+ * @param addr IP address of the neighbor
+ * @return 1 if it listed this node in its last HELLO, 0 otherwise
+ */
+int neighbor_is_symmetric(uint32_t addr) {
+    struct neighbor_entry* n = find_neighbor(addr);
+    if (!n) {
+        return 0;
+    }
+    int slot = (int)(n - neighbor_table);
+    return (heard_us[slot / 64] >> (slot % 64)) & 1;
+}
+
+/**
+ * @brief Update an existing neighbor in the table
+ * @param addr IP address of the neighbor to update
+ * @param link_code New link status code
+ * @param willingness New willingness value
+ * @return 0 on success, -1 if neighbor not found
+ */
+int update_neighbor(uint32_t addr, uint8_t link_code, uint8_t willingness) {
+    struct neighbor_entry* n = find_neighbor(addr);
+    if (!n) {
+        return -1;
+    }
+
+    int slot = (int)(n - neighbor_table);
+    if (n->link_status != link_code) {
+        routing_mark_dirty();  // Symmetric links are routing edges
     }
+    n->link_status = link_code;
+    n->willingness = willingness;
+    n->last_seen = time(NULL);
+    set_heard_us(slot, link_code == SYM_LINK);
+
+    expiry_unlink(slot);
+    expiry_append(slot);
+
+    printf("Updated neighbor: %s (link_type=%d, willingness=%d)\n",
+           inet_ntoa(*(struct in_addr*)&addr), link_code, willingness);
+    return 0;
 }
 
-void add_neigbhor(uint32_t neighbor_addr, int link_type, uint8_t willingness){
+/**
+ * @brief Add a new neighbor to the neighbor table
+ * @param addr IP address of the neighbor
+ * @param link_code Link status code (SYM_LINK, ASYM_LINK, etc.)
+ * @param willingness Neighbor's willingness to act as MPR
+ * @return 0 on success, -1 if the table is full or the neighbor exists
+ */
+int add_neighbor(uint32_t addr, uint8_t link_code, uint8_t willingness) {
+    if (!neighbor_index_ready) {
+        neighbor_index_init();
+    }
     if (neighbor_count >= MAX_NEIGHBORS) {
         printf("Error: Neighbor table full\n");
-        return;
-    }
-    
-    neighbor_table[neighbor_count].neighbor_addr = neighbor_addr;
-    neighbor_table[neighbor_count].link_status = link_type;
-    neighbor_table[neighbor_count].willingness = willingness;
-    neighbor_table[neighbor_count].last_seen = time(NULL);
-    neighbor_table[neighbor_count].is_mpr = 0;
-    neighbor_table[neighbor_count].is_mpr_selector = 0;
-    neighbor_table[neighbor_count].next = NULL;
-    
-    neighbor_count++;
-    
+        return -1;
+    }
+
+    uint32_t b = neighbor_bucket(addr);
+    if (neighbor_index[b] != NEIGHBOR_SLOT_NONE) {
+        return -1;
+    }
+
+    int slot = neighbor_count++;
+    struct neighbor_entry* n = &neighbor_table[slot];
+    memset(n, 0, sizeof(*n));
+    n->neighbor_addr = addr;
+    n->link_status = link_code;
+    n->willingness = willingness;
+    n->last_seen = time(NULL);
+    n->next = NULL;
+    neighbor_index[b] = (int16_t)slot;
+    set_heard_us(slot, link_code == SYM_LINK);
+    expiry_append(slot);
+    routing_mark_dirty();
+
     printf("Added new neighbor: %s (link_type=%d, willingness=%d)\n",
-           inet_ntoa(*(struct in_addr*)&neighbor_addr),
-           link_type, willingness);
-}
\ No newline at end of file
+           inet_ntoa(*(struct in_addr*)&addr), link_code, willingness);
+    return 0;
+}
+
+/**
+ * @brief Remove a neighbor, keeping neighbor_table dense
+ *
+ * The last entry is moved into the freed slot; its hash bucket, expiry
+ * links, symmetric bit and MPR state follow it.
+ *
+ * @param addr IP address of the neighbor to remove
+ * @return 0 on success, -1 if neighbor not found
+ */
+int remove_neighbor(uint32_t addr) {
+    struct neighbor_entry* n = find_neighbor(addr);
+    if (!n) {
+        return -1;
+    }
+
+    int slot = (int)(n - neighbor_table);
+    int last = neighbor_count - 1;
+
+    mpr_remove_neighbor(addr);
+    expiry_unlink(slot);
+    neighbor_index_delete(neighbor_bucket(addr));
+
+    if (slot != last) {
+        neighbor_table[slot] = neighbor_table[last];
+        neighbor_index[neighbor_bucket(neighbor_table[slot].neighbor_addr)] = (int16_t)slot;
+        set_heard_us(slot, (heard_us[last / 64] >> (last % 64)) & 1);
+
+        struct neighbor_entry* moved = &neighbor_table[slot];
+        if (moved->expiry_prev != NEIGHBOR_SLOT_NONE) {
+            neighbor_table[moved->expiry_prev].expiry_next = slot;
+        } else {
+            expiry_head = slot;
+        }
+        if (moved->expiry_next != NEIGHBOR_SLOT_NONE) {
+            neighbor_table[moved->expiry_next].expiry_prev = slot;
+        } else {
+            expiry_tail = slot;
+        }
+        mpr_move_neighbor(last, slot);
+    }
+    set_heard_us(last, 0);
+    neighbor_count--;
+    routing_mark_dirty();
+
+    printf("Removed neighbor: %s\n", inet_ntoa(*(struct in_addr*)&addr));
+    return 0;
+}
+
+/**
+ * @brief Drop neighbors not heard from within NEIGHB_HOLD_TIME
+ * @param now Current time
+ * @return Number of neighbors removed
+ */
+int expire_neighbors(time_t now) {
+    int removed = 0;
+    while (expiry_head != NEIGHBOR_SLOT_NONE &&
+           neighbor_table[expiry_head].last_seen + NEIGHB_HOLD_TIME < now) {
+        remove_neighbor(neighbor_table[expiry_head].neighbor_addr);
+        removed++;
+    }
+    return removed;
+}
+
+/**
+ * @brief Print the current neighbor table
+ */
+void print_neighbor_table(void) {
+    printf("\n=== Neighbor Table (%d) ===\n", neighbor_count);
+    for (int slot = expiry_tail; slot != NEIGHBOR_SLOT_NONE; slot = neighbor_table[slot].expiry_prev) {
+        struct neighbor_entry* n = &neighbor_table[slot];
+        printf("%-15s link=%d willingness=%d %s%s last_seen=%lds ago\n",
+               inet_ntoa(*(struct in_addr*)&n->neighbor_addr),
+               n->link_status, n->willingness,
+               n->is_mpr ? "MPR " : "",
+               n->is_mpr_selector ? "MPR-selector" : "",
+               (long)(time(NULL) - n->last_seen));
+    }
+}
@@ -0,0 +1,145 @@
+/**
+ * @file packet.c
+ * @brief RFC 3626 message header encoding and per-message scratch arenas
+ * @author OLSR Implementation Team
+ * @date 2025-10-02
+ *
+ * This file implements the parts of the OLSR wire format shared by HELLO
+ * and TC: the 12-byte message header, the Vtime/Htime mantissa-exponent
+ * encoding, and dispatch of a received message to its body parser. Bodies
+ * are parsed into a caller-owned arena rather than static or heap storage.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include "../include/olsr.h"
+#include "../include/packet.h"
+
+/** @brief Scaling constant C of RFC 3626 section 18.3, in 1/16 s units */
+#define OLSR_TIME_C_DIV 16
+
+/**
+ * @brief Reset an arena so it can back a new message
+ * @param arena Arena to reset
+ */
+void olsr_arena_reset(struct olsr_arena* arena) {
+    arena->used = 0;
+}
+
+/**
+ * @brief Allocate zeroed, 8-byte aligned memory from an arena
+ * @param arena Arena to allocate from
+ * @param size Number of bytes
+ * @return Pointer into the arena, or NULL if it is exhausted
+ */
+void* olsr_arena_alloc(struct olsr_arena* arena, size_t size) {
+    size_t aligned = (size + 7) & ~(size_t)7;
+    if (!arena || aligned > OLSR_ARENA_SIZE - arena->used) {
+        return NULL;
+    }
+
+    void* p = &arena->mem.bytes[arena->used];
+    arena->used += aligned;
+    memset(p, 0, size);
+    return p;
+}
+
+/**
+ * @brief Encode a time in seconds as an RFC 3626 mantissa/exponent byte
+ *
+ * value = C * (1 + a/16) * 2^b with C = 1/16 s; the result is rounded down
+ * to the nearest representable time.
+ *
+ * @param seconds Time in seconds (Vtime or Htime)
+ * @return Encoded byte (high nibble mantissa a, low nibble exponent b)
+ */
+uint8_t olsr_encode_time(uint32_t seconds) {
+    uint32_t t = seconds * OLSR_TIME_C_DIV;  // In units of C
+    if (t == 0) {
+        return 0;
+    }
+
+    uint8_t b = 0;
+    while (b < 15 && (t >> (b + 1)) != 0) {
+        b++;
+    }
+
+    uint32_t a = ((t << 4) >> b) - 16;
+    return (uint8_t)((a << 4) | b);
+}
+
+/**
+ * @brief Decode an RFC 3626 mantissa/exponent byte
+ * @param code Encoded Vtime/Htime byte
+ * @return Time in whole seconds, saturated at 255
+ */
+uint8_t olsr_decode_time(uint8_t code) {
+    uint32_t a = code >> 4;
+    uint32_t b = code & 0x0F;
+    uint32_t seconds = ((16 + a) << b) / (16 * OLSR_TIME_C_DIV);
+    return seconds > 255 ? 255 : (uint8_t)seconds;
+}
+
+/**
+ * @brief Write the 12-byte message header
+ * @param msg Header fields to write (vtime in seconds)
+ * @param buf Output buffer (at least OLSR_MSG_HEADER_SIZE bytes)
+ */
+void olsr_write_message_header(const struct olsr_message* msg, uint8_t* buf) {
+    buf[0] = msg->msg_type;
+    buf[1] = olsr_encode_time(msg->vtime);
+    buf[2] = (uint8_t)(msg->msg_size >> 8);
+    buf[3] = (uint8_t)msg->msg_size;
+    memcpy(&buf[4], &msg->originator, OLSR_ADDR_SIZE);
+    buf[8] = msg->ttl;
+    buf[9] = msg->hop_count;
+    buf[10] = (uint8_t)(msg->msg_seq_num >> 8);
+    buf[11] = (uint8_t)msg->msg_seq_num;
+}
+
+/**
+ * @brief Parse one serialized OLSR message
+ * @param buf Serialized message(s), e.g. an NC slot payload
+ * @param len Bytes available in buf
+ * @param msg Output header; msg->body points into arena
+ * @param arena Scratch arena for the body
+ * @return Bytes consumed (the message size), or -1 if malformed
+ */
+int parse_olsr_message(const uint8_t* buf, size_t len, struct olsr_message* msg,
+                       struct olsr_arena* arena) {
+    if (!buf || !msg || len < OLSR_MSG_HEADER_SIZE) {
+        return -1;
+    }
+
+    msg->msg_type = buf[0];
+    msg->vtime = olsr_decode_time(buf[1]);
+    msg->msg_size = (uint16_t)((buf[2] << 8) | buf[3]);
+    memcpy(&msg->originator, &buf[4], OLSR_ADDR_SIZE);
+    msg->ttl = buf[8];
+    msg->hop_count = buf[9];
+    msg->msg_seq_num = (uint16_t)((buf[10] << 8) | buf[11]);
+    msg->body = NULL;
+
+    if (msg->msg_size < OLSR_MSG_HEADER_SIZE || msg->msg_size > len) {
+        printf("Error: OLSR message size %d does not fit %zu bytes\n", msg->msg_size, len);
+        return -1;
+    }
+
+    const uint8_t* body = buf + OLSR_MSG_HEADER_SIZE;
+    size_t body_len = msg->msg_size - OLSR_MSG_HEADER_SIZE;
+
+    switch (msg->msg_type) {
+    case MSG_HELLO:
+        msg->body = parse_hello_body(body, body_len, arena);
+        break;
+    case MSG_TC:
+        msg->body = parse_tc_body(body, body_len, arena);
+        break;
+    default:
+        return msg->msg_size;  // Unknown type: caller skips it
+    }
+
+    return msg->body ? msg->msg_size : -1;
+}
@@ -0,0 +1,190 @@
+/**
+ * @file packet_test.c
+ * @brief RFC 3626 HELLO/TC serialization test program
+ *
+ * Serializes HELLO and TC messages from the neighbor table and MPR
+ * selector set, parses them back with parse_olsr_message() and checks the
+ * header, link message blocks, ANSN and selectors. Also checks the
+ * Vtime/Htime encoding, messages that do not fit, and malformed input.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <arpa/inet.h>
+#include "../include/olsr.h"
+#include "../include/packet.h"
+#include "../include/hello.h"
+#include "../include/tc.h"
+
+static int failures = 0;
+
+#define CHECK(cond, what) do { \
+    if (cond) { \
+        printf("PASS: %s\n", what); \
+    } else { \
+        printf("FAIL: %s\n", what); \
+        failures++; \
+    } \
+} while (0)
+
+/** @brief Control queue stand-in; the daemon's queue lives with the RRC glue */
+int push_to_control_queue(struct control_queue* queue, uint8_t msg_type, void* msg_data, int data_size) {
+    (void)queue;
+    (void)msg_type;
+    (void)msg_data;
+    (void)data_size;
+    return 0;
+}
+
+static uint32_t addr(int host) {
+    return htonl(0x0A000000u + (uint32_t)host);
+}
+
+static void test_time_encoding(void) {
+    static const uint32_t seconds[] = {1, 2, 5, 6, 15, 20, 30};
+    int exact = 1;
+    for (size_t i = 0; i < sizeof(seconds) / sizeof(seconds[0]); i++) {
+        exact &= olsr_decode_time(olsr_encode_time(seconds[i])) == seconds[i];
+    }
+    CHECK(exact, "Vtime/Htime round trip for protocol intervals");
+    CHECK(olsr_encode_time(6) == 0x86, "6 s encodes as mantissa 8, exponent 6");
+    CHECK(olsr_decode_time(olsr_encode_time(255)) == 248, "unrepresentable time rounds down");
+    CHECK(olsr_encode_time(0) == 0 && olsr_decode_time(0xFF) == 255, "zero and saturation");
+}
+
+static void test_hello(void) {
+    uint8_t buf[OLSR_MAX_MESSAGE_SIZE];
+    struct olsr_message msg;
+    struct olsr_arena arena;
+
+    node_ip = addr(1);
+    node_willingness = WILL_HIGH;
+    add_neighbor(addr(2), SYM_LINK, WILL_DEFAULT);
+    add_neighbor(addr(3), ASYM_LINK, WILL_DEFAULT);
+    add_neighbor(addr(4), SYM_LINK, WILL_LOW);
+
+    int len = serialize_hello_message(buf, sizeof(buf));
+    int expected = OLSR_MSG_HEADER_SIZE + OLSR_HELLO_HEADER_SIZE +
+                   2 * OLSR_LINK_BLOCK_HEADER_SIZE + 3 * OLSR_ADDR_SIZE;
+    CHECK(len == expected, "HELLO groups neighbors into one block per link code");
+
+    olsr_arena_reset(&arena);
+    int used = parse_olsr_message(buf, (size_t)len, &msg, &arena);
+    struct olsr_hello* hello = msg.body;
+    CHECK(used == len && msg.msg_type == MSG_HELLO && msg.msg_size == len &&
+          msg.originator == node_ip && msg.ttl == 1 && msg.hop_count == 0 &&
+          msg.vtime == 6 && msg.msg_seq_num == message_seq_num,
+          "HELLO header round trips");
+    CHECK(hello && hello->willingness == WILL_HIGH && hello->hello_interval == HELLO_INTERVAL &&
+          hello->neighbor_count == 3,
+          "HELLO body round trips");
+
+    int codes = 0;
+    for (int i = 0; hello && i < hello->neighbor_count; i++) {
+        uint32_t a = hello->neighbors[i].neighbor_addr;
+        uint8_t code = hello->neighbors[i].link_code;
+        if ((a == addr(2) || a == addr(4)) && code == OLSR_LINK_CODE(SYM_NEIGH, SYM_LINK)) codes++;
+        if (a == addr(3) && code == OLSR_LINK_CODE(NOT_NEIGH, ASYM_LINK)) codes++;
+    }
+    CHECK(codes == 3, "each neighbor carries its link and neighbor type");
+    CHECK(hello && hello->self_link_code == -1, "own address absent from own HELLO");
+
+    // Parsed at neighbor 2, which finds itself listed as symmetric
+    node_ip = addr(2);
+    olsr_arena_reset(&arena);
+    parse_olsr_message(buf, (size_t)len, &msg, &arena);
+    hello = msg.body;
+    CHECK(hello && hello->self_link_code == OLSR_LINK_CODE(SYM_NEIGH, SYM_LINK),
+          "receiver finds its own link code");
+    node_ip = addr(1);
+
+    CHECK(serialize_hello_message(buf, (size_t)len - 1) == -1, "HELLO that does not fit is refused");
+
+    remove_neighbor(addr(2));
+    remove_neighbor(addr(3));
+    remove_neighbor(addr(4));
+}
+
+static void test_tc(void) {
+    uint8_t buf[OLSR_MAX_MESSAGE_SIZE];
+    struct olsr_message msg;
+    struct olsr_arena arena;
+
+    uint16_t ansn = get_current_ansn();
+    add_mpr_selector(addr(5));
+    add_mpr_selector(addr(6));
+    add_mpr_selector(addr(7));
+    CHECK(add_mpr_selector(addr(6)) == -1 && get_current_ansn() == (uint16_t)(ansn + 3),
+          "ANSN moves only when the selector set changes");
+
+    int len = serialize_tc_message(buf, sizeof(buf));
+    CHECK(len == OLSR_MSG_HEADER_SIZE + OLSR_TC_HEADER_SIZE + 3 * OLSR_ADDR_SIZE, "TC size");
+
+    olsr_arena_reset(&arena);
+    int used = parse_olsr_message(buf, (size_t)len, &msg, &arena);
+    struct olsr_tc* tc = msg.body;
+    CHECK(used == len && msg.msg_type == MSG_TC && msg.ttl == 255 && msg.vtime == 15 &&
+          msg.originator == node_ip,
+          "TC header round trips");
+    CHECK(tc && tc->ansn == get_current_ansn() && tc->selector_count == 3 &&
+          tc->mpr_selectors[0].neighbor_addr == addr(5) &&
+          tc->mpr_selectors[1].neighbor_addr == addr(6) &&
+          tc->mpr_selectors[2].neighbor_addr == addr(7),
+          "TC ANSN and selectors round trip");
+
+    // HELLO and TC back to back, as in one NC payload
+    uint8_t payload[OLSR_MAX_MESSAGE_SIZE];
+    int hello_len = serialize_hello_message(payload, sizeof(payload));
+    memcpy(payload + hello_len, buf, (size_t)len);
+    olsr_arena_reset(&arena);
+    int first = parse_olsr_message(payload, (size_t)(hello_len + len), &msg, &arena);
+    int first_type = msg.msg_type;
+    int second = parse_olsr_message(payload + first, (size_t)(hello_len + len - first), &msg, &arena);
+    CHECK(first == hello_len && first_type == MSG_HELLO && second == len && msg.msg_type == MSG_TC,
+          "messages in one payload parse in sequence");
+
+    CHECK(serialize_tc_message(buf, (size_t)len - 1) == -1, "TC that does not fit is refused");
+
+    remove_mpr_selector(addr(5));
+    remove_mpr_selector(addr(6));
+    remove_mpr_selector(addr(7));
+}
+
+static void test_malformed(void) {
+    uint8_t buf[OLSR_MAX_MESSAGE_SIZE];
+    struct olsr_message msg;
+    struct olsr_arena arena;
+
+    add_mpr_selector(addr(8));
+    int len = serialize_tc_message(buf, sizeof(buf));
+    remove_mpr_selector(addr(8));
+
+    olsr_arena_reset(&arena);
+    CHECK(parse_olsr_message(buf, (size_t)len - 1, &msg, &arena) == -1, "message size past the buffer");
+    CHECK(parse_olsr_message(buf, OLSR_MSG_HEADER_SIZE - 1, &msg, &arena) == -1, "short header");
+
+    buf[3] = (uint8_t)(len - 1);  // Selector list no longer a multiple of 4
+    CHECK(parse_olsr_message(buf, (size_t)len, &msg, &arena) == -1, "ragged TC body");
+
+    buf[0] = 0x80;  // Unknown type, valid size
+    buf[3] = (uint8_t)len;
+    CHECK(parse_olsr_message(buf, (size_t)len, &msg, &arena) == len && msg.body == NULL,
+          "unknown type is skipped by size");
+
+    // HELLO whose link block claims more than the message holds
+    add_neighbor(addr(9), SYM_LINK, WILL_DEFAULT);
+    len = serialize_hello_message(buf, sizeof(buf));
+    remove_neighbor(addr(9));
+    buf[OLSR_MSG_HEADER_SIZE + OLSR_HELLO_HEADER_SIZE + 3] += OLSR_ADDR_SIZE;
+    CHECK(parse_olsr_message(buf, (size_t)len, &msg, &arena) == -1, "overlong link block");
+}
+
+int main(void) {
+    test_time_encoding();
+    test_hello();
+    test_tc();
+    test_malformed();
+
+    printf("%s\n", failures ? "FAILED" : "ALL TESTS PASSED");
+    return failures ? 1 : 0;
+}
@@ -13,10 +13,12 @@
 #include <string.h>
 #include <stdint.h>
 #include <time.h>
+#include <sched.h>
 #include "../include/olsr.h"
 #include "../include/packet.h"
 #include "../include/hello.h"
 #include "../include/routing.h"
+#include "../include/rrc_notify.h"
 
 /**
  * @brief Convert node ID to string (kernel-independent)
@@ -30,10 +32,130 @@ static char* id_to_string(uint32_t id, char* buffer) {
     return buffer;
 }
 
-/** @brief Global routing table */
-static struct routing_table_entry routing_table[MAX_ROUTING_ENTRIES];
-/** @brief Current number of routing entries */
-static int routing_table_size = 0;
+/**
+ * @brief One published routing table
+ *
+ * A snapshot is immutable while it is current. SPF builds the next table
+ * in the other snapshot and publishes it with a single pointer store, so
+ * lookups never block on, or observe, a recomputation in progress.
+ */
+struct routing_snapshot {
+    struct routing_table_entry entries[MAX_ROUTING_ENTRIES]; /**< Sorted by dest_ip */
+    int size;             /**< Number of valid entries */
+    uint32_t generation;  /**< Bumped whenever a route changed */
+    int readers;          /**< Lookups currently reading this snapshot */
+};
+
+static struct routing_snapshot routing_snapshots[2];
+/** @brief Snapshot lookups read */
+static struct routing_snapshot* routing_current = &routing_snapshots[0];
+/** @brief Snapshot being built, NULL outside a recomputation */
+static struct routing_snapshot* routing_build = NULL;
+
+/**
+ * @brief Pin the current snapshot for reading
+ *
+ * The reader count keeps the writer from reusing the snapshot; if the
+ * pointer moved while it was being pinned, retry on the new one.
+ */
+static struct routing_snapshot* routing_acquire(void) {
+    for (;;) {
+        struct routing_snapshot* snap = __atomic_load_n(&routing_current, __ATOMIC_SEQ_CST);
+        __atomic_add_fetch(&snap->readers, 1, __ATOMIC_SEQ_CST);
+        if (__atomic_load_n(&routing_current, __ATOMIC_SEQ_CST) == snap) {
+            return snap;
+        }
+        __atomic_sub_fetch(&snap->readers, 1, __ATOMIC_SEQ_CST);
+    }
+}
+
+static void routing_release(struct routing_snapshot* snap) {
+    __atomic_sub_fetch(&snap->readers, 1, __ATOMIC_RELEASE);
+}
+
+/**
+ * @brief Start building the next snapshot in the non-current buffer
+ * @param seed 1 to start from the current routes, 0 to start empty
+ */
+static void routing_begin_build(int seed) {
+    struct routing_snapshot* cur = routing_current;
+    struct routing_snapshot* next = (cur == &routing_snapshots[0]) ? &routing_snapshots[1]
+                                                                   : &routing_snapshots[0];
+
+    // Grace period: wait out lookups still reading the retired snapshot
+    while (__atomic_load_n(&next->readers, __ATOMIC_ACQUIRE) != 0) {
+        sched_yield();
+    }
+
+    next->size = seed ? cur->size : 0;
+    if (seed) {
+        memcpy(next->entries, cur->entries, sizeof(cur->entries[0]) * cur->size);
+    }
+    routing_build = next;
+}
+
+/**
+ * @brief Compare the built snapshot, already sorted, with the current one and swap
+ * @return 1 if any route changed, 0 otherwise
+ */
+static int routing_swap(void) {
+    struct routing_snapshot* next = routing_build;
+    struct routing_snapshot* cur = routing_current;
+
+    int changed = (next->size != cur->size);
+    for (int i = 0; i < next->size && !changed; i++) {
+        changed = next->entries[i].dest_ip != cur->entries[i].dest_ip ||
+                  next->entries[i].next_hop != cur->entries[i].next_hop ||
+                  next->entries[i].metric != cur->entries[i].metric ||
+                  next->entries[i].hops != cur->entries[i].hops;
+    }
+    next->generation = cur->generation + (changed ? 1 : 0);
+
+    __atomic_store_n(&routing_current, next, __ATOMIC_SEQ_CST);
+    routing_build = NULL;
+    return changed;
+}
+
+/**
+ * @brief Sort the built snapshot, compare it with the current one and swap
+ * @return 1 if any route changed, 0 otherwise
+ */
+static int routing_publish(void) {
+    struct routing_snapshot* next = routing_build;
+
+    // Stable insertion sort by destination; a later entry for the same
+    // destination replaces the earlier one
+    int n = 0;
+    for (int i = 0; i < next->size; i++) {
+        struct routing_table_entry e = next->entries[i];
+        int j = n;
+        while (j > 0 && next->entries[j - 1].dest_ip > e.dest_ip) {
+            next->entries[j] = next->entries[j - 1];
+            j--;
+        }
+        if (j > 0 && next->entries[j - 1].dest_ip == e.dest_ip) {
+            memmove(&next->entries[j], &next->entries[j + 1], sizeof(e) * (n - j));
+            next->entries[j - 1] = e;
+        } else {
+            next->entries[j] = e;
+            n++;
+        }
+    }
+    next->size = n;
+    return routing_swap();
+}
+
+/** @brief Triggered-update scheduler state */
+static int routing_dirty = 0;
+static struct timespec routing_dirty_since;
+static uint32_t routing_holddown_ms = ROUTING_HOLDDOWN_MS;
+
+static struct {
+    uint32_t triggers;      /**< routing_mark_dirty() calls */
+    uint32_t coalesced;     /**< Triggers absorbed by a pending recomputation */
+    uint32_t recomputations;
+    uint32_t unchanged;     /**< Recomputations that changed no route */
+} routing_stats = {0};
 
 /** @brief Topology information from TC messages */
 static struct topology_link tc_topology[MAX_NODES * MAX_NODES];
@@ -69,11 +191,12 @@ int update_tc_topology(uint32_t from_addr, uint32_t to_addr, time_t validity) {
     tc_topology[tc_topology_size].cost = 1;  // Standard OLSR cost
     tc_topology[tc_topology_size].validity = validity;
     tc_topology_size++;
+    routing_mark_dirty();
     
     char from_str[16], to_str[16];
     printf("Added TC topology link: %s -> %s (validity=%lds)\n",
-           ip_to_string(from_addr, from_str),
-           ip_to_string(to_addr, to_str),
+           id_to_string(from_addr, from_str),
+           id_to_string(to_addr, to_str),
            (long)(validity - time(NULL)));
     
     return 0;
@@ -85,23 +208,29 @@ int update_tc_topology(uint32_t from_addr, uint32_t to_addr, time_t validity) {
 void cleanup_tc_topology(void) {
     time_t now = time(NULL);
     int i = 0;
+    int removed = 0;
     
     while (i < tc_topology_size) {
         if (tc_topology[i].validity <= now) {
             // Remove expired link by shifting remaining entries
             char from_str[16], to_str[16];
             printf("Removing expired TC link: %s -> %s\n",
-                   ip_to_string(tc_topology[i].from_addr, from_str),
-                   ip_to_string(tc_topology[i].to_addr, to_str));
+                   id_to_string(tc_topology[i].from_addr, from_str),
+                   id_to_string(tc_topology[i].to_addr, to_str));
             
             for (int j = i; j < tc_topology_size - 1; j++) {
                 tc_topology[j] = tc_topology[j + 1];
             }
             tc_topology_size--;
+            removed++;
         } else {
             i++;
         }
     }
+    
+    if (removed > 0) {
+        routing_mark_dirty();
+    }
 }
 
 /**
@@ -151,8 +280,8 @@ int build_topology_graph(struct topology_link* topology, int max_links) {
             
             char node_str[16], neighbor_str[16];
             printf("Added direct link: %s -> %s (cost=1)\n",
-                   ip_to_string(node_ip, node_str),
-                   ip_to_string(neighbor_table[i].neighbor_addr, neighbor_str));
+                   id_to_string(node_ip, node_str),
+                   id_to_string(neighbor_table[i].neighbor_addr, neighbor_str));
         }
     }
     
@@ -167,8 +296,8 @@ int build_topology_graph(struct topology_link* topology, int max_links) {
             
             char from_str[16], to_str[16];
             printf("Added TC link: %s -> %s (cost=%d)\n",
-                   ip_to_string(tc_topology[i].from_addr, from_str),
-                   ip_to_string(tc_topology[i].to_addr, to_str),
+                   id_to_string(tc_topology[i].from_addr, from_str),
+                   id_to_string(tc_topology[i].to_addr, to_str),
                    tc_topology[i].cost);
         }
     }
@@ -246,7 +375,11 @@ void dijkstra_shortest_path(uint32_t source, struct topology_link* topology, int
         }
     }
     
-    // Update routing table with results
+    // Build the new table off to the side; lookups keep using the old one
+    int own_build = (routing_build == NULL);
+    if (own_build) {
+        routing_begin_build(0);
+    }
     clear_routing_table();
     
     for (int i = 0; i < node_count; i++) {
@@ -268,10 +401,18 @@ void dijkstra_shortest_path(uint32_t source, struct topology_link* topology, int
             add_routing_entry(nodes[i], next_hop, dist[i], dist[i]);
         }
     }
+
+    if (own_build) {
+        routing_publish();
+    }
 }
 
 /**
  * @brief Calculate routing table using shortest path algorithm
+ *
+ * Runs SPF into the spare snapshot and swaps it in. The generation
+ * number only moves, and the table is only printed and announced to the
+ * RRC, when a route changed.
  */
 void calculate_routing_table(void) {
     printf("=== Calculating OLSR Routing Table ===\n");
@@ -286,56 +427,189 @@ void calculate_routing_table(void) {
     
     printf("Built topology graph with %d links\n", link_count);
     
+    routing_begin_build(0);
     if (link_count > 0) {
         dijkstra_shortest_path(node_ip, topology, link_count);
         printf("Shortest path calculation completed\n");
-        print_routing_table();
     } else {
         printf("No topology links available - clearing routing table\n");
         clear_routing_table();
     }
+    int changed = routing_publish();
+
+    routing_stats.recomputations++;
+    if (changed) {
+        print_routing_table();
+        rrc_notify_route_generation();
+    } else {
+        routing_stats.unchanged++;
+        printf("Routing table unchanged (generation %u)\n", routing_get_generation());
+    }
+}
+
+static uint32_t elapsed_ms(const struct timespec* since, const struct timespec* now) {
+    return (uint32_t)((now->tv_sec - since->tv_sec) * 1000 +
+                      (now->tv_nsec - since->tv_nsec) / 1000000);
+}
+
+/**
+ * @brief Mark the topology as changed
+ *
+ * The first trigger opens the hold-down window; later triggers inside it
+ * are absorbed, so a burst of HELLO/TC changes costs one SPF run.
+ */
+void routing_mark_dirty(void) {
+    routing_stats.triggers++;
+    if (routing_dirty) {
+        routing_stats.coalesced++;
+        return;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &routing_dirty_since);
+    routing_dirty = 1;
+}
+
+/**
+ * @brief Set the hold-down window for triggered recomputation
+ * @param holddown_ms Window in milliseconds (0 recomputes on the next poll)
+ */
+void routing_set_holddown(uint32_t holddown_ms) {
+    routing_holddown_ms = holddown_ms;
+}
+
+/**
+ * @brief Milliseconds until a pending recomputation is due
+ * @return Remaining delay, 0 if due now, -1 if nothing is pending
+ */
+int routing_pending_delay_ms(void) {
+    if (!routing_dirty) {
+        return -1;
+    }
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    uint32_t elapsed = elapsed_ms(&routing_dirty_since, &now);
+    return elapsed >= routing_holddown_ms ? 0 : (int)(routing_holddown_ms - elapsed);
+}
+
+/**
+ * @brief Run SPF once if the topology is dirty and the hold-down expired
+ * @return 1 if the routing table was recomputed, 0 otherwise
+ */
+int routing_run_pending(void) {
+    if (routing_pending_delay_ms() != 0) {
+        return 0;
+    }
+    routing_dirty = 0;
+    calculate_routing_table();
+    return 1;
+}
+
+/**
+ * @brief Current routing table generation
+ * @return Generation number, bumped whenever a route changes
+ */
+uint32_t routing_get_generation(void) {
+    struct routing_snapshot* snap = routing_acquire();
+    uint32_t generation = snap->generation;
+    routing_release(snap);
+    return generation;
+}
+
+/**
+ * @brief Look up the next hop towards a destination
+ *
+ * Lock-free: binary search in the current snapshot.
+ *
+ * @param dest_ip Destination IP address
+ * @param next_hop Output next hop
+ * @param generation Output generation the answer belongs to (may be NULL)
+ * @return 0 if a route exists, -1 otherwise
+ */
+int routing_lookup(uint32_t dest_ip, uint32_t* next_hop, uint32_t* generation) {
+    struct routing_snapshot* snap = routing_acquire();
+    int found = -1;
+    int lo = 0, hi = snap->size - 1;
+    while (lo <= hi) {
+        int mid = (lo + hi) / 2;
+        if (snap->entries[mid].dest_ip == dest_ip) {
+            *next_hop = snap->entries[mid].next_hop;
+            found = 0;
+            break;
+        }
+        if (snap->entries[mid].dest_ip < dest_ip) {
+            lo = mid + 1;
+        } else {
+            hi = mid - 1;
+        }
+    }
+    if (generation) {
+        *generation = snap->generation;
+    }
+    routing_release(snap);
+    return found;
 }
 
 /**
  * @brief Add entry to routing table
  */
 int add_routing_entry(uint32_t dest_ip, uint32_t next_hop, uint32_t metric, int hops) {
-    if (routing_table_size >= MAX_ROUTING_ENTRIES) {
-        printf("Error: Routing table full\n");
-        return -1;
+    // Outside a recomputation, publish a copy of the current table plus this route
+    int own_build = (routing_build == NULL);
+    if (own_build) {
+        routing_begin_build(1);
     }
-    
-    // Check if entry already exists
-    for (int i = 0; i < routing_table_size; i++) {
-        if (routing_table[i].dest_ip == dest_ip) {
-            // Update existing entry
-            routing_table[i].next_hop = next_hop;
-            routing_table[i].metric = metric;
-            routing_table[i].hops = hops;
-            routing_table[i].timestamp = time(NULL);
-            char dest_str[16], hop_str[16];
-            printf("Updated routing entry: %s via %s (cost=%d, hops=%d)\n",
-                   ip_to_string(dest_ip, dest_str),
-                   ip_to_string(next_hop, hop_str),
-                   metric, hops);
-            return 0;
+
+    struct routing_snapshot* next = routing_build;
+    struct routing_table_entry* e = NULL;
+    int slot = next->size;
+    if (own_build) {
+        // The seeded copy is already sorted: put the route in its slot
+        // directly instead of sorting the whole table again
+        int lo = 0, hi = next->size;
+        while (lo < hi) {
+            int mid = (lo + hi) / 2;
+            if (next->entries[mid].dest_ip < dest_ip) {
+                lo = mid + 1;
+            } else {
+                hi = mid;
+            }
+        }
+        slot = lo;
+        if (slot < next->size && next->entries[slot].dest_ip == dest_ip) {
+            e = &next->entries[slot];
         }
     }
-    
-    // Add new entry
-    routing_table[routing_table_size].dest_ip = dest_ip;
-    routing_table[routing_table_size].next_hop = next_hop;
-    routing_table[routing_table_size].metric = metric;
-    routing_table[routing_table_size].hops = hops;
-    routing_table[routing_table_size].timestamp = time(NULL);
-    routing_table_size++;
+
+    if (!e) {
+        if (next->size >= MAX_ROUTING_ENTRIES) {
+            printf("Error: Routing table full\n");
+            if (own_build) {
+                routing_build = NULL;
+            }
+            return -1;
+        }
+        // Inside a recomputation slot is the end of the table: entries are
+        // appended without a search and routing_publish() keeps the last
+        // entry per destination
+        memmove(&next->entries[slot + 1], &next->entries[slot],
+                sizeof(next->entries[0]) * (next->size - slot));
+        next->size++;
+        e = &next->entries[slot];
+    }
+    e->dest_ip = dest_ip;
+    e->next_hop = next_hop;
+    e->metric = metric;
+    e->hops = hops;
+    e->timestamp = time(NULL);
     
     char dest_str[16], hop_str[16];
     printf("Added routing entry: %s via %s (cost=%d, hops=%d)\n",
-           ip_to_string(dest_ip, dest_str),
-           ip_to_string(next_hop, hop_str),
+           id_to_string(dest_ip, dest_str),
+           id_to_string(next_hop, hop_str),
            metric, hops);
-    
+
+    if (own_build) {
+        routing_swap();
+    }
     return 0;
 }
 
@@ -347,37 +621,58 @@ void print_routing_table(void) {
     printf("Destination      Next Hop         Cost  Hops  Age\n");
     printf("------------------------------------------------\n");
     
-    if (routing_table_size == 0) {
+    struct routing_snapshot* snap = routing_acquire();
+    if (snap->size == 0) {
         printf("(empty)\n");
+        routing_release(snap);
         return;
     }
     
     time_t now = time(NULL);
-    for (int i = 0; i < routing_table_size; i++) {
-        int age = (int)(now - routing_table[i].timestamp);
+    for (int i = 0; i < snap->size; i++) {
+        const struct routing_table_entry* e = &snap->entries[i];
+        int age = (int)(now - e->timestamp);
         char dest_str[16], hop_str[16];
         printf("%-15s  %-15s  %4d  %4d  %3ds\n",
-               ip_to_string(routing_table[i].dest_ip, dest_str),
-               ip_to_string(routing_table[i].next_hop, hop_str),
-               routing_table[i].metric,
-               routing_table[i].hops,
+               id_to_string(e->dest_ip, dest_str),
+               id_to_string(e->next_hop, hop_str),
+               e->metric,
+               e->hops,
                age);
     }
     printf("\n");
+    routing_release(snap);
 }
 
 /**
  * @brief Clear and reinitialize routing table
  */
 void clear_routing_table(void) {
-    routing_table_size = 0;
-    memset(routing_table, 0, sizeof(routing_table));
+    if (routing_build) {
+        routing_build->size = 0;
+        return;
+    }
+    routing_begin_build(0);
+    routing_publish();
 }
 
 /**
  * @brief Update routing table with new topology information
+ *
+ * Schedules a coalesced recomputation; routing_run_pending() performs it
+ * once the hold-down window has passed.
  */
 void update_routing_table(void) {
-    printf("Updating routing table...\n");
-    calculate_routing_table();
+    routing_mark_dirty();
+}
+
+/**
+ * @brief Print triggered-update statistics
+ */
+void print_routing_stats(void) {
+    printf("Routing: %u triggers (%u coalesced), %u recomputations (%u unchanged), "
+           "generation %u, hold-down %ums\n",
+           routing_stats.triggers, routing_stats.coalesced,
+           routing_stats.recomputations, routing_stats.unchanged,
+           routing_get_generation(), routing_holddown_ms);
 }
\ No newline at end of file
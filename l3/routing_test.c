@@ -0,0 +1,134 @@
+/**
+ * @file routing_test.c
+ * @brief Triggered routing recomputation test program
+ *
+ * Checks that topology changes inside the hold-down window coalesce into
+ * one SPF run, that nothing runs before the window passes, that the
+ * generation moves only when a route changes, and that lookups see the
+ * published table.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <time.h>
+#include <arpa/inet.h>
+#include "../include/olsr.h"
+#include "../include/hello.h"
+#include "../include/routing.h"
+
+static int failures = 0;
+
+#define CHECK(cond, what) do { \
+    if (cond) { \
+        printf("PASS: %s\n", what); \
+    } else { \
+        printf("FAIL: %s\n", what); \
+        failures++; \
+    } \
+} while (0)
+
+#define TEST_HOLDDOWN_MS 200
+
+/** @brief Control queue stand-in; the daemon's queue lives with the RRC glue */
+int push_to_control_queue(struct control_queue* queue, uint8_t msg_type, void* msg_data, int data_size) {
+    (void)queue;
+    (void)msg_type;
+    (void)msg_data;
+    (void)data_size;
+    return 0;
+}
+
+static uint32_t addr(int host) {
+    return htonl(0x0A000000u + (uint32_t)host);
+}
+
+static void sleep_ms(int ms) {
+    usleep((useconds_t)ms * 1000);
+}
+
+/** @brief Poll until the pending recomputation runs; returns how many ran */
+static int run_when_due(void) {
+    int delay = routing_pending_delay_ms();
+    if (delay < 0) {
+        return 0;
+    }
+    sleep_ms(delay + 5);
+    int runs = 0;
+    while (routing_run_pending()) {
+        runs++;
+    }
+    return runs;
+}
+
+static void test_idle(void) {
+    CHECK(routing_pending_delay_ms() == -1 && routing_run_pending() == 0,
+          "nothing pending without a trigger");
+}
+
+static void test_burst_coalesces(void) {
+    time_t validity = time(NULL) + 60;
+    uint32_t generation = routing_get_generation();
+
+    node_ip = addr(1);
+    routing_set_holddown(TEST_HOLDDOWN_MS);
+
+    // A burst of HELLO and TC changes: 1 - 2 - 3 - 4, 1 - 5
+    add_neighbor(addr(2), SYM_LINK, WILL_DEFAULT);
+    add_neighbor(addr(5), SYM_LINK, WILL_DEFAULT);
+    update_tc_topology(addr(2), addr(3), validity);
+    update_tc_topology(addr(3), addr(4), validity);
+    update_routing_table();
+
+    int delay = routing_pending_delay_ms();
+    CHECK(delay > 0 && delay <= TEST_HOLDDOWN_MS, "first trigger opens the hold-down window");
+    CHECK(routing_run_pending() == 0, "no recomputation inside the window");
+
+    uint32_t hop = 0;
+    CHECK(routing_lookup(addr(4), &hop, NULL) == -1, "routes not published before the window ends");
+
+    sleep_ms(TEST_HOLDDOWN_MS / 2);
+    update_tc_topology(addr(5), addr(6), validity);
+    int later = routing_pending_delay_ms();
+    CHECK(later > 0 && later < delay, "later triggers do not extend the window");
+
+    CHECK(run_when_due() == 1, "the whole burst costs one recomputation");
+    CHECK(routing_pending_delay_ms() == -1, "nothing pending afterwards");
+
+    uint32_t gen = 0;
+    CHECK(routing_lookup(addr(4), &hop, &gen) == 0 && hop == addr(2) && gen == generation + 1,
+          "multi-hop route published with a new generation");
+    CHECK(routing_lookup(addr(6), &hop, NULL) == 0 && hop == addr(5),
+          "change inside the window is included");
+}
+
+static void test_unchanged_keeps_generation(void) {
+    uint32_t generation = routing_get_generation();
+
+    update_routing_table();
+    CHECK(run_when_due() == 1 && routing_get_generation() == generation,
+          "recomputation that changes no route keeps the generation");
+
+    update_tc_topology(addr(4), addr(7), time(NULL) + 60);
+    CHECK(run_when_due() == 1 && routing_get_generation() == generation + 1,
+          "new destination moves the generation");
+}
+
+static void test_zero_holddown(void) {
+    routing_set_holddown(0);
+    update_routing_table();
+    CHECK(routing_pending_delay_ms() == 0 && routing_run_pending() == 1,
+          "zero hold-down runs on the next poll");
+    routing_set_holddown(ROUTING_HOLDDOWN_MS);
+}
+
+int main(void) {
+    test_idle();
+    test_burst_coalesces();
+    test_unchanged_keeps_generation();
+    test_zero_holddown();
+
+    print_routing_stats();
+    printf("%s\n", failures ? "FAILED" : "ALL TESTS PASSED");
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,224 @@
+/**
+ * @file rrc_notify.c
+ * @brief Unsolicited OLSR to RRC notifications
+ * @author OLSR Implementation Team
+ * @date 2025-10-02
+ *
+ * Node addresses are IPv4 in network byte order; the RRC identifies a node
+ * by the last octet of its address.
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <fcntl.h>
+#include <mqueue.h>
+#include <arpa/inet.h>
+#include "../include/olsr.h"
+#include "../include/tc.h"
+#include "../include/mpr.h"
+#include "../include/routing.h"
+#include "../include/rrc_notify.h"
+
+#define RRC_MSG_OLSR_ROUTE_UPDATE 1  /**< IPC_MessageType on the RRC side */
+#define RRC_MSG_OLSR_MPR_UPDATE 2
+#define RRC_MSG_RRC_ROUTE_REQUEST 10
+#define RRC_MQ_MESSAGE_SIZE 4096     /**< mq_msgsize the RRC creates its queues with */
+
+/** @brief MPR update as read by the RRC (IPC_MPRUpdate) */
+struct rrc_mpr_update {
+    int32_t type;
+    uint8_t mpr_count;
+    uint8_t selector_count;
+    uint8_t mprs[RRC_NOTIFY_MAX_NODES];
+    uint8_t selectors[RRC_NOTIFY_MAX_NODES];
+};
+
+/** @brief Route request as sent by the RRC (IPC_RouteRequest) */
+struct rrc_route_request {
+    int32_t type;
+    uint8_t dest_node;
+    uint32_t request_id;
+};
+
+/** @brief Route answer or update as read by the RRC (IPC_RouteResponse) */
+struct rrc_route_update {
+    int32_t type;
+    uint8_t dest_node;        /**< RRC_NOTIFY_ANY_DEST: generation only */
+    uint8_t next_hop;
+    uint8_t route_available;
+    uint32_t request_id;      /**< 0 when unsolicited */
+    uint32_t generation;      /**< routing_get_generation() of the answer */
+};
+
+/** @brief Queue descriptors, opened on first use */
+static mqd_t notify_mq = (mqd_t)-1;
+static mqd_t request_mq = (mqd_t)-1;
+
+/** @brief Unsent change waiting for the queue */
+static int notify_pending = 0;
+static int generation_pending = 0;
+
+static int notify_open(void) {
+    if (notify_mq == (mqd_t)-1) {
+        notify_mq = mq_open(RRC_NOTIFY_QUEUE, O_WRONLY | O_NONBLOCK);
+    }
+    return notify_mq == (mqd_t)-1 ? -1 : 0;
+}
+
+/**
+ * @brief Convert addresses to RRC node IDs
+ * @param addrs Addresses in network byte order
+ * @param count Number of addresses
+ * @param out Output node IDs
+ * @return Number of node IDs written
+ */
+static uint8_t addrs_to_node_ids(const uint32_t* addrs, int count, uint8_t* out) {
+    int n = 0;
+    for (int i = 0; i < count && n < RRC_NOTIFY_MAX_NODES; i++) {
+        out[n++] = (uint8_t)(ntohl(addrs[i]) & 0xFF);
+    }
+    return (uint8_t)n;
+}
+
+/**
+ * @brief Send the current MPR and MPR selector sets to the RRC
+ * @return 0 if sent, -1 if left pending
+ */
+int rrc_notify_mpr_update(void) {
+    notify_pending = 1;
+
+    if (notify_open() != 0) {
+        return -1;  // RRC not running yet
+    }
+
+    uint32_t addrs[MAX_NEIGHBORS];
+    struct rrc_mpr_update update;
+    memset(&update, 0, sizeof(update));
+    update.type = RRC_MSG_OLSR_MPR_UPDATE;
+
+    int count = mpr_get_set(addrs, MAX_NEIGHBORS);
+    update.mpr_count = addrs_to_node_ids(addrs, count, update.mprs);
+    count = get_mpr_selectors(addrs, MAX_NEIGHBORS);
+    update.selector_count = addrs_to_node_ids(addrs, count, update.selectors);
+
+    if (mq_send(notify_mq, (const char*)&update, sizeof(update), 0) != 0) {
+        return -1;  // Queue full, retried with the next change or poll
+    }
+
+    notify_pending = 0;
+    return 0;
+}
+
+/**
+ * @brief Tell the RRC that the routing table generation moved
+ *
+ * Carries only the generation; the RRC drops the next hops it cached
+ * under an older one and asks again on next use.
+ *
+ * @return 0 if sent, -1 if left pending
+ */
+int rrc_notify_route_generation(void) {
+    generation_pending = 1;
+
+    if (notify_open() != 0) {
+        return -1;
+    }
+
+    struct rrc_route_update update;
+    memset(&update, 0, sizeof(update));
+    update.type = RRC_MSG_OLSR_ROUTE_UPDATE;
+    update.dest_node = RRC_NOTIFY_ANY_DEST;
+    update.generation = routing_get_generation();
+
+    if (mq_send(notify_mq, (const char*)&update, sizeof(update), 0) != 0) {
+        return -1;
+    }
+
+    generation_pending = 0;
+    return 0;
+}
+
+/**
+ * @brief Answer one RRC route request from the routing table
+ *
+ * The RRC names nodes by the last octet; the destination shares our
+ * network prefix.
+ */
+static void answer_route_request(const struct rrc_route_request* request) {
+    uint32_t dest_ip = htonl((ntohl(node_ip) & 0xFFFFFF00u) | request->dest_node);
+    uint32_t next_hop = 0;
+
+    struct rrc_route_update response;
+    memset(&response, 0, sizeof(response));
+    response.type = RRC_MSG_OLSR_ROUTE_UPDATE;
+    response.dest_node = request->dest_node;
+    response.request_id = request->request_id;
+    if (routing_lookup(dest_ip, &next_hop, &response.generation) == 0) {
+        response.next_hop = (uint8_t)(ntohl(next_hop) & 0xFF);
+        response.route_available = 1;
+    }
+
+    if (notify_open() == 0) {
+        mq_send(notify_mq, (const char*)&response, sizeof(response), 0);
+    }
+}
+
+/**
+ * @brief Answer the route requests the RRC has queued
+ */
+void rrc_notify_serve_requests(void) {
+    if (request_mq == (mqd_t)-1) {
+        request_mq = mq_open(RRC_REQUEST_QUEUE, O_RDONLY | O_NONBLOCK);
+        if (request_mq == (mqd_t)-1) {
+            return;
+        }
+    }
+
+    char buf[RRC_MQ_MESSAGE_SIZE];
+    ssize_t bytes;
+    while ((bytes = mq_receive(request_mq, buf, sizeof(buf), NULL)) >= (ssize_t)sizeof(int32_t)) {
+        int32_t type;
+        memcpy(&type, buf, sizeof(type));
+        if (type != RRC_MSG_RRC_ROUTE_REQUEST || (size_t)bytes < sizeof(struct rrc_route_request)) {
+            continue;  // Discovery triggers and metrics requests are not ours
+        }
+        struct rrc_route_request request;
+        memcpy(&request, buf, sizeof(request));
+        answer_route_request(&request);
+    }
+}
+
+/**
+ * @brief Descriptor to wait on for RRC route requests
+ * @return File descriptor, -1 if the RRC queue is not open yet
+ */
+int rrc_notify_request_fd(void) {
+    return (int)request_mq;
+}
+
+/**
+ * @brief Retry updates that could not be sent earlier
+ */
+void rrc_notify_poll(void) {
+    if (notify_pending) {
+        rrc_notify_mpr_update();
+    }
+    if (generation_pending) {
+        rrc_notify_route_generation();
+    }
+}
+
+/**
+ * @brief Close the notification queue
+ */
+void rrc_notify_close(void) {
+    if (notify_mq != (mqd_t)-1) {
+        mq_close(notify_mq);
+        notify_mq = (mqd_t)-1;
+    }
+    if (request_mq != (mqd_t)-1) {
+        mq_close(request_mq);
+        request_mq = (mqd_t)-1;
+    }
+}
@@ -10,8 +10,9 @@
 #include "../include/hello.h"
 #include "../include/routing.h"
 #include "../include/tc.h"
+#include "../include/rrc_notify.h"
 
-/** @brief Global ANSN (Advertised Neighbor Sequence Number) counter */
+/** @brief ANSN (Advertised Neighbor Sequence Number), bumped when the selector set changes */
 static uint16_t ansn_counter = 0;
 
 /** @brief Array to store MPR selector addresses */
@@ -28,7 +29,7 @@ static int mpr_selector_count = 0;
  * @param msg Pointer to received OLSR message containing TC
  * @param sender_addr IP address of message sender
  */
-void process_tc_message(struct olsr_message* msg, uint32_t sender_addr) s {
+void process_tc_message(struct olsr_message* msg, uint32_t sender_addr) {
     if (!msg || msg->msg_type != MSG_TC) {
         printf("Error: Invalid TC message\n");
         return;
@@ -83,8 +84,10 @@ int add_mpr_selector(uint32_t selector_addr) {
     }
     
     mpr_selectors[mpr_selector_count++] = selector_addr;
+    ansn_counter++;
     printf("Added MPR selector: %s\n",
            inet_ntoa(*(struct in_addr*)&selector_addr));
+    rrc_notify_mpr_update();
     return 0;
 }
 
@@ -101,8 +104,10 @@ int remove_mpr_selector(uint32_t selector_addr) {
                 mpr_selectors[j] = mpr_selectors[j + 1];
             }
             mpr_selector_count--;
+            ansn_counter++;
             printf("Removed MPR selector: %s\n",
                    inet_ntoa(*(struct in_addr*)&selector_addr));
+            rrc_notify_mpr_update();
             return 0;
         }
     }
@@ -111,23 +116,25 @@ int remove_mpr_selector(uint32_t selector_addr) {
 
 /**
  * @brief Generate a TC message
- * @return Newly allocated TC message, NULL on failure
+ * @param arena Scratch arena that holds the message and its selector list
+ * @return TC message inside arena, NULL on failure
  */
-struct olsr_tc* generate_tc_message(void) {
-    static struct olsr_tc tc_static;
-    struct olsr_tc* tc = &tc_static;
-    memset(&tc_static, 0, sizeof(struct olsr_tc));
+struct olsr_tc* generate_tc_message(struct olsr_arena* arena) {
+    struct olsr_tc* tc = olsr_arena_alloc(arena, sizeof(struct olsr_tc));
     if (!tc) {
         printf("Error: Failed to allocate TC message\n");
         return NULL;
     }
     
-    tc->ansn = ++ansn_counter;
+    tc->ansn = ansn_counter;
     tc->selector_count = mpr_selector_count;
     
     if (mpr_selector_count > 0) {
-        static struct tc_neighbor mpr_selectors_static[MAX_NEIGHBORS];
-        tc->mpr_selectors = mpr_selectors_static;
+        tc->mpr_selectors = olsr_arena_alloc(arena, mpr_selector_count * sizeof(struct tc_neighbor));
+        if (!tc->mpr_selectors) {
+            printf("Error: Failed to allocate TC selector list\n");
+            return NULL;
+        }
         // Copy MPR selectors
         for (int i = 0; i < mpr_selector_count; i++) {
             tc->mpr_selectors[i].neighbor_addr = mpr_selectors[i];
@@ -140,39 +147,121 @@ struct olsr_tc* generate_tc_message(void) {
 }
 
 /**
- * @brief Send a TC message
+ * @brief Serialize a TC message straight from the MPR selector list
+ * @param buf Output buffer, typically the NC payload
+ * @param buf_len Size of buf in bytes
+ * @return Number of bytes written, or -1 if the message does not fit
  */
-void send_tc_message(void) {
-    // Only send if we have MPR selectors
-    if (mpr_selector_count == 0) {
-        printf("No MPR selectors - skipping TC message\n");
-        return;
+int serialize_tc_message(uint8_t* buf, size_t buf_len) {
+    int count = mpr_selector_count;
+    size_t size = OLSR_MSG_HEADER_SIZE + OLSR_TC_HEADER_SIZE + (size_t)count * OLSR_ADDR_SIZE;
+    if (!buf || size > buf_len) {
+        return -1;
     }
-    
-    struct olsr_tc* tc = generate_tc_message();
-    if (!tc) return;
-    
-    // Create message header
+
+    uint16_t ansn = ansn_counter;
+    size_t pos = OLSR_MSG_HEADER_SIZE;
+    buf[pos++] = (uint8_t)(ansn >> 8);
+    buf[pos++] = (uint8_t)ansn;
+    buf[pos++] = 0;  // Reserved
+    buf[pos++] = 0;
+    for (int i = 0; i < count; i++) {
+        memcpy(&buf[pos], &mpr_selectors[i], OLSR_ADDR_SIZE);
+        pos += OLSR_ADDR_SIZE;
+    }
+
     struct olsr_message msg;
     msg.msg_type = MSG_TC;
-    msg.vtime = 15;           // Longer validity than HELLO
+    msg.vtime = 15;          // Longer validity than HELLO
+    msg.msg_size = (uint16_t)size;
     msg.originator = node_ip;
     msg.ttl = 255;           // Maximum TTL for TC
     msg.hop_count = 0;
-    msg.msg_seq_num = ++message_seq_num;
-    msg.body = tc;
+    msg.msg_seq_num = __atomic_add_fetch(&message_seq_num, 1, __ATOMIC_RELAXED);
+    msg.body = NULL;
+    olsr_write_message_header(&msg, buf);
+
+    return (int)size;
+}
+
+/**
+ * @brief Parse a TC body (after the message header)
+ * @param buf TC body
+ * @param len Length of the body in bytes
+ * @param arena Scratch arena for the parsed message
+ * @return Parsed TC, or NULL if malformed or the arena is too small
+ */
+struct olsr_tc* parse_tc_body(const uint8_t* buf, size_t len, struct olsr_arena* arena) {
+    if (!buf || len < OLSR_TC_HEADER_SIZE || (len - OLSR_TC_HEADER_SIZE) % OLSR_ADDR_SIZE != 0) {
+        return NULL;
+    }
+
+    struct olsr_tc* tc = olsr_arena_alloc(arena, sizeof(struct olsr_tc));
+    if (!tc) {
+        return NULL;
+    }
+    tc->ansn = (uint16_t)((buf[0] << 8) | buf[1]);
+    tc->selector_count = (int)((len - OLSR_TC_HEADER_SIZE) / OLSR_ADDR_SIZE);
+
+    if (tc->selector_count > 0) {
+        tc->mpr_selectors = olsr_arena_alloc(arena, tc->selector_count * sizeof(struct tc_neighbor));
+        if (!tc->mpr_selectors) {
+            return NULL;
+        }
+        for (int i = 0; i < tc->selector_count; i++) {
+            memcpy(&tc->mpr_selectors[i].neighbor_addr,
+                   &buf[OLSR_TC_HEADER_SIZE + i * OLSR_ADDR_SIZE], OLSR_ADDR_SIZE);
+        }
+    }
+
+    return tc;
+}
+
+/**
+ * @brief Send a TC message
+ * @param nc_payload NC payload buffer to fill
+ * @param payload_len Size of nc_payload in bytes
+ * @return Bytes written, 0 if there is nothing to advertise, -1 on failure
+ */
+int send_tc_message(uint8_t* nc_payload, size_t payload_len) {
+    // Only send if we have MPR selectors
+    if (mpr_selector_count == 0) {
+        printf("No MPR selectors - skipping TC message\n");
+        return 0;
+    }
     
-    msg.msg_size = sizeof(struct olsr_message) +
-                   sizeof(struct olsr_tc) +
-                   (tc->selector_count * sizeof(struct tc_neighbor));
+    int len = serialize_tc_message(nc_payload, payload_len);
+    if (len < 0) {
+        printf("Error: TC message does not fit in %zu bytes\n", payload_len);
+        return -1;
+    }
     
     // TC message debug output
     printf("TC message ready: ANSN=%d, size=%d, selectors=%d\n",
-           tc->ansn, msg.msg_size, tc->selector_count);
+           ansn_counter, len, mpr_selector_count);
     
-    // Cleanup
-    if (tc->mpr_selectors) free(tc->mpr_selectors);
-    free(tc);
+    return len;
+}
+
+/**
+ * @brief Push a TC message to the control queue
+ * @param queue Pointer to the control queue where the message will be stored
+ * @return 0 on success, -1 on failure
+ */
+int push_tc_to_queue(struct control_queue* queue) {
+    if (!queue) {
+        printf("Error: Control queue is NULL\n");
+        return -1;
+    }
+
+    uint8_t buf[OLSR_MAX_MESSAGE_SIZE];
+    int len = serialize_tc_message(buf, sizeof(buf));
+    if (len < 0) {
+        printf("Error: Failed to generate TC message\n");
+        return -1;
+    }
+
+    return push_to_control_queue(queue, MSG_TC, buf, len);
 }
 
 /**
@@ -182,6 +271,18 @@ int get_mpr_selector_count(void) {
     return mpr_selector_count;
 }
 
+/**
+ * @brief Copy the current MPR selector set
+ * @param out Output array
+ * @param max Capacity of out
+ * @return Number of selectors written
+ */
+int get_mpr_selectors(uint32_t* out, int max) {
+    int n = mpr_selector_count < max ? mpr_selector_count : max;
+    memcpy(out, mpr_selectors, n * sizeof(uint32_t));
+    return n;
+}
+
 /**
  * @brief Get current ANSN value
  */
@@ -1,4 +1,4 @@
-#define _POSIX_C_SOURCE 200809L
+#define _GNU_SOURCE
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -8,9 +8,13 @@
 #include <signal.h>
 #include <errno.h>
 #include <sys/stat.h>
+#include <fcntl.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include "file_transfer.h"
 
 #define SOCKET_PATH "/tmp/file_socket"
-#define BUFFER_SIZE 1024
+#define BUFFER_SIZE 65536
 #define UPLOADS_DIR "../uploads"
 
 int server_fd = -1;
@@ -37,130 +41,377 @@ void ensure_uploads_dir() {
     }
 }
 
-// Handle file reception from client
-void handle_file_transfer(int client_fd) {
+// splice() errors meaning "not on these fds", not a broken transfer
+static bool splice_unsupported(int err) {
+    return err == EINVAL || err == ENOSYS || err == EOPNOTSUPP;
+}
+
+// Write the count bytes already moved into the pipe to the file at *off
+static int drain_pipe_to_file(int pipe_rd, int file_fd, loff_t* off, size_t count) {
     char buffer[BUFFER_SIZE];
-    char filename[256];
-    long file_size = 0;
-    char filepath[512];
-    FILE *file = NULL;
-    long bytes_received = 0;
+    while (count > 0) {
+        size_t want = count < sizeof(buffer) ? count : sizeof(buffer);
+        ssize_t got = read(pipe_rd, buffer, want);
+        if (got < 0 && errno == EINTR) continue;
+        if (got <= 0) return -1;
+        if (pwrite(file_fd, buffer, (size_t)got, *off) != got) return -1;
+        *off += got;
+        count -= (size_t)got;
+    }
+    return 0;
+}
+
+// Move len bytes from the socket straight into the file at offset.
+// splice() keeps the data in the kernel (socket -> pipe -> page cache).
+// Without a pipe, or once splice turns out not to work on these fds, the
+// data goes through read/pwrite; the pipe is then closed so the rest of
+// the transfer stays on that path.
+static int receive_into_file(int client_fd, int pipe_fds[2], int file_fd,
+                             uint64_t offset, uint64_t len) {
+    loff_t out_off = (loff_t)offset;
+    bool unsupported = false;
     
-    printf("Starting file transfer from client...\n");
+    while (pipe_fds[0] >= 0 && len > 0 && !unsupported) {
+        size_t want = len < FT_CHUNK_SIZE ? (size_t)len : FT_CHUNK_SIZE;
+        ssize_t in = splice(client_fd, NULL, pipe_fds[1], NULL, want,
+                            SPLICE_F_MOVE | SPLICE_F_MORE);
+        if (in < 0 && errno == EINTR) continue;
+        if (in < 0 && splice_unsupported(errno)) {
+            unsupported = true;
+            break;
+        }
+        if (in <= 0) return -1;
+        
+        ssize_t left = in;
+        while (left > 0) {
+            ssize_t out = splice(pipe_fds[0], NULL, file_fd, &out_off, left,
+                                 SPLICE_F_MOVE | SPLICE_F_MORE);
+            if (out < 0 && errno == EINTR) continue;
+            if (out < 0 && splice_unsupported(errno)) {
+                if (drain_pipe_to_file(pipe_fds[0], file_fd, &out_off, (size_t)left) < 0) {
+                    return -1;
+                }
+                unsupported = true;
+                break;
+            }
+            if (out <= 0) return -1;
+            left -= out;
+        }
+        len -= (uint64_t)in;
+    }
+    
+    if (unsupported) {
+        printf("splice not supported here, falling back to read/pwrite\n");
+        close(pipe_fds[0]);
+        close(pipe_fds[1]);
+        pipe_fds[0] = pipe_fds[1] = -1;
+    }
+    
+    char buffer[BUFFER_SIZE];
+    while (len > 0) {
+        size_t want = len < sizeof(buffer) ? (size_t)len : sizeof(buffer);
+        if (ft_read_full(client_fd, buffer, want) < 0) return -1;
+        if (pwrite(file_fd, buffer, want, out_off) != (ssize_t)want) return -1;
+        out_off += want;
+        len -= want;
+    }
+    return 0;
+}
+
+// Strip any directory components so uploads cannot escape UPLOADS_DIR
+static const char* sanitize_filename(char* name) {
+    char* slash = strrchr(name, '/');
+    const char* base = slash ? slash + 1 : name;
+    if (base[0] == '\0' || strcmp(base, ".") == 0 || strcmp(base, "..") == 0) {
+        return NULL;
+    }
+    return base;
+}
+
+// Log progress every 10%
+static void log_progress(uint64_t bytes_received, uint64_t file_size, int* last_logged) {
+    int current = file_size ? (int)((bytes_received * 100) / file_size) : 100;
+    if (current - *last_logged >= 10 || bytes_received == file_size) {
+        printf("File transfer progress: %d%% (%llu/%llu bytes)\n", current,
+               (unsigned long long)bytes_received, (unsigned long long)file_size);
+        *last_logged = current;
+    }
+}
+
+// Framed transfer: length-prefixed chunks, sliding-window ACKs, resumable
+void handle_framed_transfer(int client_fd) {
+    FT_FrameHeader hdr;
+    FT_OpenInfo open_info;
+    char name_buf[FT_MAX_NAME_LEN + 1];
+    char part_path[800];
+    char final_path[512];
     
-    // Read metadata (filename:filesize)
-    ssize_t bytes_read = read(client_fd, buffer, sizeof(buffer) - 1);
-    if (bytes_read <= 0) {
-        printf("Error reading file metadata\n");
-        write(client_fd, "ERROR: Failed to read metadata\n", 31);
+    if (ft_recv_header(client_fd, &hdr) < 0 || hdr.type != FT_FRAME_OPEN ||
+        hdr.length <= sizeof(open_info) || hdr.length > sizeof(open_info) + FT_MAX_NAME_LEN ||
+        ft_read_full(client_fd, &open_info, sizeof(open_info)) < 0 ||
+        ft_read_full(client_fd, name_buf, hdr.length - sizeof(open_info)) < 0) {
+        printf("Invalid OPEN frame\n");
+        ft_send_frame(client_fd, FT_FRAME_ERROR, 0, 0, NULL, 0);
         return;
     }
+    name_buf[hdr.length - sizeof(open_info)] = '\0';
     
-    buffer[bytes_read] = '\0';
+    const char* filename = sanitize_filename(name_buf);
+    if (!filename) {
+        printf("Rejected file name: %s\n", name_buf);
+        ft_send_frame(client_fd, FT_FRAME_ERROR, 0, 0, NULL, 0);
+        return;
+    }
     
-    // Parse metadata
-    char *newline = strchr(buffer, '\n');
-    if (newline) {
-        *newline = '\0';
-        
-        char *colon = strchr(buffer, ':');
-        if (colon) {
-            *colon = '\0';
-            strncpy(filename, buffer, sizeof(filename) - 1);
-            filename[sizeof(filename) - 1] = '\0';
-            file_size = atol(colon + 1);
+    uint64_t file_size = hdr.offset;
+    uint64_t mtime_ns = be64toh(open_info.mtime_ns);
+    
+    // Partial file is keyed on name, size and source mtime so a resumed OPEN
+    // finds it, but a source rewritten with the same size starts over
+    snprintf(final_path, sizeof(final_path), "%s/%s", UPLOADS_DIR, filename);
+    snprintf(part_path, sizeof(part_path), "%s.%llu.%llx.part", final_path,
+             (unsigned long long)file_size, (unsigned long long)mtime_ns);
+    
+    int file_fd = open(part_path, O_WRONLY | O_CREAT, 0644);
+    if (file_fd < 0) {
+        printf("Error creating file: %s\n", strerror(errno));
+        ft_send_frame(client_fd, FT_FRAME_ERROR, 0, 0, NULL, 0);
+        return;
+    }
+    
+    struct stat st;
+    uint64_t committed = 0;
+    if (fstat(file_fd, &st) == 0 && (uint64_t)st.st_size <= file_size) {
+        committed = (uint64_t)st.st_size;
+    } else if (ftruncate(file_fd, 0) < 0) {
+        printf("Error resetting partial file: %s\n", strerror(errno));
+    }
+    
+    printf("Receiving file: %s (%llu bytes, resuming at %llu)\n", filename,
+           (unsigned long long)file_size, (unsigned long long)committed);
+    
+    FT_ResumeInfo info;
+    info.chunk_size = htobe32(FT_CHUNK_SIZE);
+    info.window_chunks = htobe32(FT_WINDOW_CHUNKS);
+    if (ft_send_frame(client_fd, FT_FRAME_RESUME, 0, committed, &info, sizeof(info)) < 0) {
+        close(file_fd);
+        return;
+    }
+    
+    int pipe_fds[2] = {-1, -1};
+    if (pipe(pipe_fds) < 0) {
+        pipe_fds[0] = pipe_fds[1] = -1;
+    }
+    
+    int last_logged = 0;
+    bool done = false;
+    
+    while (!done && ft_recv_header(client_fd, &hdr) == 0) {
+        switch (hdr.type) {
+            case FT_FRAME_DATA:
+                if (hdr.offset != committed || hdr.offset + hdr.length > file_size) {
+                    // Out of order or duplicate after a resume: discard, ask for rewind
+                    if (ft_drain(client_fd, hdr.length) < 0) goto disconnected;
+                    ft_send_frame(client_fd, FT_FRAME_ACK, FT_FLAG_REWIND, committed, NULL, 0);
+                    break;
+                }
+                if (receive_into_file(client_fd, pipe_fds, file_fd, hdr.offset, hdr.length) < 0) {
+                    goto disconnected;
+                }
+                committed += hdr.length;
+                ft_send_frame(client_fd, FT_FRAME_ACK, 0, committed, NULL, 0);
+                log_progress(committed, file_size, &last_logged);
+                break;
+            
+            case FT_FRAME_CLOSE:
+                done = true;
+                break;
             
-            printf("Receiving file: %s (%ld bytes)\n", filename, file_size);
-        } else {
-            printf("Invalid metadata format\n");
-            write(client_fd, "ERROR: Invalid metadata format\n", 31);
+            default:
+                printf("Unexpected frame type %d\n", hdr.type);
+                if (ft_drain(client_fd, hdr.length) < 0) goto disconnected;
+                break;
+        }
+    }
+    
+disconnected:
+    if (pipe_fds[0] >= 0) {
+        close(pipe_fds[0]);
+        close(pipe_fds[1]);
+    }
+    
+    if (done && committed == file_size) {
+        fsync(file_fd);
+        close(file_fd);
+        if (rename(part_path, final_path) == 0) {
+            printf("File transfer completed successfully: %s (%llu bytes)\n",
+                   filename, (unsigned long long)committed);
+            ft_send_frame(client_fd, FT_FRAME_DONE, 0, committed, NULL, 0);
             return;
         }
-    } else {
+        printf("Error finalizing file: %s\n", strerror(errno));
+        ft_send_frame(client_fd, FT_FRAME_ERROR, 0, committed, NULL, 0);
+        return;
+    }
+    
+    close(file_fd);
+    
+    // Keep the partial file: the sender resumes from `committed` on reconnect
+    printf("File transfer interrupted: %llu/%llu bytes kept for resume\n",
+           (unsigned long long)committed, (unsigned long long)file_size);
+    if (done) {
+        ft_send_frame(client_fd, FT_FRAME_ERROR, 0, committed, NULL, 0);
+    }
+}
+
+// Legacy transfer: "filename:filesize\n" followed by exactly filesize bytes.
+// The size is authoritative; a trailing "EOF\n" from older clients is ignored.
+void handle_legacy_transfer(int client_fd) {
+    char buffer[BUFFER_SIZE];
+    char filename[256];
+    long file_size = 0;
+    char filepath[512];
+    size_t header_len = 0;
+    
+    printf("Starting file transfer from client...\n");
+    
+    // Read metadata (filename:filesize) one byte at a time so no file data is consumed
+    while (header_len < sizeof(buffer) - 1) {
+        if (ft_read_full(client_fd, &buffer[header_len], 1) < 0) {
+            printf("Error reading file metadata\n");
+            write(client_fd, "ERROR: Failed to read metadata\n", 31);
+            return;
+        }
+        if (buffer[header_len] == '\n') break;
+        header_len++;
+    }
+    
+    if (header_len == sizeof(buffer) - 1) {
         printf("Metadata missing newline\n");
         write(client_fd, "ERROR: Metadata missing newline\n", 32);
         return;
     }
+    buffer[header_len] = '\0';
+    
+    char *colon = strchr(buffer, ':');
+    if (!colon) {
+        printf("Invalid metadata format\n");
+        write(client_fd, "ERROR: Invalid metadata format\n", 31);
+        return;
+    }
+    
+    *colon = '\0';
+    strncpy(filename, buffer, sizeof(filename) - 1);
+    filename[sizeof(filename) - 1] = '\0';
+    file_size = atol(colon + 1);
+    
+    const char* safe_name = sanitize_filename(filename);
+    if (!safe_name || file_size < 0) {
+        printf("Invalid metadata format\n");
+        write(client_fd, "ERROR: Invalid metadata format\n", 31);
+        return;
+    }
+    
+    printf("Receiving file: %s (%ld bytes)\n", safe_name, file_size);
     
     // Create full file path
-    snprintf(filepath, sizeof(filepath), "%s/%s", UPLOADS_DIR, filename);
+    snprintf(filepath, sizeof(filepath), "%s/%s", UPLOADS_DIR, safe_name);
     
-    // Open file for writing
-    file = fopen(filepath, "wb");
-    if (!file) {
+    int file_fd = open(filepath, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (file_fd < 0) {
         printf("Error creating file: %s\n", strerror(errno));
         write(client_fd, "ERROR: Failed to create file\n", 29);
         return;
     }
     
-    // Receive file data
-    while (bytes_received < file_size) {
-        bytes_read = read(client_fd, buffer, sizeof(buffer));
-        if (bytes_read <= 0) {
-            if (bytes_read == 0) {
-                printf("Connection closed by client\n");
-            } else {
-                printf("Error reading file data: %s\n", strerror(errno));
-            }
-            break;
-        }
-        
-        // Check for EOF marker in the data
-        char *eof_pos = strstr(buffer, "EOF\n");
-        if (eof_pos) {
-            // Write only the data before EOF marker
-            size_t data_before_eof = eof_pos - buffer;
-            if (data_before_eof > 0) {
-                size_t written = fwrite(buffer, 1, data_before_eof, file);
-                if (written != data_before_eof) {
-                    printf("Error writing final data to file: %s\n", strerror(errno));
-                    break;
-                }
-                bytes_received += data_before_eof;
-            }
-            printf("EOF marker received\n");
-            break;
-        }
-        
-        // Write data to file
-        size_t written = fwrite(buffer, 1, bytes_read, file);
-        if (written != bytes_read) {
-            printf("Error writing to file: %s\n", strerror(errno));
-            break;
-        }
-        
-        bytes_received += bytes_read;
-        
-        // Log progress every 10%
-        static long last_progress_logged = 0;
-        long current_progress = ((double)bytes_received / file_size) * 100.0;
-        if (current_progress - last_progress_logged >= 10 || bytes_received == file_size) {
-            printf("File transfer progress: %ld%% (%ld/%ld bytes)\n", 
-                   current_progress, bytes_received, file_size);
-            last_progress_logged = current_progress;
-        }
+    int pipe_fds[2] = {-1, -1};
+    if (pipe(pipe_fds) < 0) {
+        pipe_fds[0] = pipe_fds[1] = -1;
     }
     
-    fclose(file);
+    int ok = receive_into_file(client_fd, pipe_fds, file_fd, 0, (uint64_t)file_size);
     
-    // Small delay to ensure all data is written
-    sleep(1); // 1 second delay
+    if (pipe_fds[0] >= 0) {
+        close(pipe_fds[0]);
+        close(pipe_fds[1]);
+    }
+    fsync(file_fd);
+    close(file_fd);
     
-    if (bytes_received >= file_size) {
-        printf("File transfer completed successfully: %s (%ld bytes)\n", filename, bytes_received);
+    if (ok == 0) {
+        printf("File transfer completed successfully: %s (%ld bytes)\n", safe_name, file_size);
         write(client_fd, "SUCCESS: File received successfully\n", 36);
     } else {
-        printf("File transfer incomplete: %ld/%ld bytes\n", bytes_received, file_size);
+        printf("File transfer incomplete: %s\n", safe_name);
         write(client_fd, "ERROR: File transfer incomplete\n", 32);
         // Remove incomplete file
         unlink(filepath);
     }
 }
 
-int main() {
+// Handle file reception from client: framed clients announce FT_MAGIC,
+// anything else is treated as the legacy text header
+void handle_file_transfer(int client_fd) {
+    uint32_t magic = 0;
+    
+    if (recv(client_fd, &magic, sizeof(magic), MSG_PEEK | MSG_WAITALL) != sizeof(magic)) {
+        printf("Client closed before sending a header\n");
+        return;
+    }
+    
+    if (be32toh(magic) == FT_MAGIC) {
+        handle_framed_transfer(client_fd);
+    } else {
+        handle_legacy_transfer(client_fd);
+    }
+}
+
+// Client mode: upload a file to a running server, resuming after each
+// interrupted attempt from the offset the server reports
+#define SEND_MAX_ATTEMPTS 5
+
+static int send_file_to_server(const char* path, const char* remote_name) {
+    struct sockaddr_un addr;
+    
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strncpy(addr.sun_path, SOCKET_PATH, sizeof(addr.sun_path) - 1);
+    
+    for (int attempt = 1; attempt <= SEND_MAX_ATTEMPTS; attempt++) {
+        int sock_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (sock_fd == -1) {
+            perror("socket");
+            return 1;
+        }
+        
+        if (connect(sock_fd, (struct sockaddr*)&addr, sizeof(addr)) == 0 &&
+            ft_send_file(sock_fd, path, remote_name) == 0) {
+            close(sock_fd);
+            printf("Sent %s as %s\n", path, remote_name);
+            return 0;
+        }
+        close(sock_fd);
+        
+        printf("Send attempt %d/%d failed, retrying\n", attempt, SEND_MAX_ATTEMPTS);
+        sleep(1);
+    }
+    
+    printf("Giving up on %s\n", path);
+    return 1;
+}
+
+int main(int argc, char* argv[]) {
     struct sockaddr_un addr;
     int client_fd;
     
+    // file_server send <path> [remote_name]
+    if (argc >= 3 && strcmp(argv[1], "send") == 0) {
+        const char* remote_name = argc >= 4 ? argv[3] : argv[2];
+        const char* slash = strrchr(remote_name, '/');
+        signal(SIGPIPE, SIG_IGN);
+        return send_file_to_server(argv[2], slash ? slash + 1 : remote_name);
+    }
+    
     // Set up signal handlers
     signal(SIGINT, signal_handler);
     signal(SIGTERM, signal_handler);
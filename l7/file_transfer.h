@@ -0,0 +1,276 @@
+/**
+ * Chunked File Transfer Protocol for L7 File Service
+ * Length-framed chunks with sliding-window ACKs and resumable offsets
+ *
+ * Every frame starts with a fixed header (network byte order):
+ *
+ *   magic(4) | type(1) | flags(1) | reserved(2) | length(4) | offset(8)
+ *
+ * followed by exactly `length` payload bytes. There is no in-band EOF
+ * marker: the receiver always knows how many bytes belong to the frame.
+ *
+ * Exchange:
+ *   sender   -> OPEN   (offset = file size, payload = FT_OpenInfo + file name)
+ *   receiver -> RESUME (offset = bytes already committed, payload = FT_ResumeInfo)
+ *   sender   -> DATA   (offset = file offset, payload = chunk)       [window]
+ *   receiver -> ACK    (offset = contiguous bytes committed)
+ *   sender   -> CLOSE  (offset = file size)
+ *   receiver -> DONE or ERROR
+ *
+ * A transfer interrupted by a route change keeps its partial file on the
+ * receiver; reopening with the same name, size and modification time
+ * resumes at the RESUME offset instead of starting over. A source file
+ * that was rewritten in place changes its mtime, so stale partial data
+ * is never spliced onto the new contents.
+ */
+
+#ifndef FILE_TRANSFER_H
+#define FILE_TRANSFER_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <endian.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/sendfile.h>
+
+// ============================================================================
+// PROTOCOL CONSTANTS
+// ============================================================================
+
+#define FT_MAGIC            0x46545831u   // "FTX1"
+#define FT_CHUNK_SIZE       65536         // Bytes per DATA frame
+#define FT_WINDOW_CHUNKS    8             // Outstanding un-ACKed chunks
+#define FT_MAX_NAME_LEN     255
+
+typedef enum {
+    FT_FRAME_OPEN   = 1,
+    FT_FRAME_RESUME = 2,
+    FT_FRAME_DATA   = 3,
+    FT_FRAME_ACK    = 4,
+    FT_FRAME_CLOSE  = 5,
+    FT_FRAME_DONE   = 6,
+    FT_FRAME_ERROR  = 7
+} FT_FrameType;
+
+// ACK flag: receiver discarded out-of-order data, sender must go back to offset
+#define FT_FLAG_REWIND      0x01
+
+// ============================================================================
+// WIRE STRUCTURES
+// ============================================================================
+
+typedef struct __attribute__((packed)) {
+    uint32_t magic;
+    uint8_t  type;
+    uint8_t  flags;
+    uint16_t reserved;
+    uint32_t length;
+    uint64_t offset;
+} FT_FrameHeader;
+
+// OPEN payload prefix: identifies the source file version, name follows
+typedef struct __attribute__((packed)) {
+    uint64_t mtime_ns;
+} FT_OpenInfo;
+
+// RESUME payload: receiver-advertised chunking and window
+typedef struct __attribute__((packed)) {
+    uint32_t chunk_size;
+    uint32_t window_chunks;
+} FT_ResumeInfo;
+
+// ============================================================================
+// FRAME I/O HELPERS
+// ============================================================================
+
+/**
+ * Read exactly len bytes from a stream socket
+ * @return 0 on success, -1 on error or peer close
+ */
+static inline int ft_read_full(int fd, void* buf, size_t len) {
+    uint8_t* p = (uint8_t*)buf;
+    while (len > 0) {
+        ssize_t n = read(fd, p, len);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return -1;
+        p += n;
+        len -= (size_t)n;
+    }
+    return 0;
+}
+
+/**
+ * Write exactly len bytes to a stream socket
+ */
+static inline int ft_write_full(int fd, const void* buf, size_t len) {
+    const uint8_t* p = (const uint8_t*)buf;
+    while (len > 0) {
+        ssize_t n = write(fd, p, len);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return -1;
+        p += n;
+        len -= (size_t)n;
+    }
+    return 0;
+}
+
+/**
+ * Send a frame header (and optional small payload) in one write
+ */
+static inline int ft_send_frame(int fd, FT_FrameType type, uint8_t flags,
+                                uint64_t offset, const void* payload, uint32_t length) {
+    uint8_t buf[sizeof(FT_FrameHeader) + sizeof(FT_OpenInfo) + FT_MAX_NAME_LEN + 1];
+    FT_FrameHeader hdr;
+
+    hdr.magic = htobe32(FT_MAGIC);
+    hdr.type = (uint8_t)type;
+    hdr.flags = flags;
+    hdr.reserved = 0;
+    hdr.length = htobe32(length);
+    hdr.offset = htobe64(offset);
+
+    // DATA payloads are streamed separately by the caller
+    if (!payload || length > sizeof(buf) - sizeof(hdr)) {
+        return ft_write_full(fd, &hdr, sizeof(hdr));
+    }
+
+    memcpy(buf, &hdr, sizeof(hdr));
+    memcpy(buf + sizeof(hdr), payload, length);
+    return ft_write_full(fd, buf, sizeof(hdr) + length);
+}
+
+/**
+ * Receive and validate a frame header, converting to host byte order
+ */
+static inline int ft_recv_header(int fd, FT_FrameHeader* hdr) {
+    if (ft_read_full(fd, hdr, sizeof(*hdr)) < 0) return -1;
+
+    hdr->magic = be32toh(hdr->magic);
+    hdr->length = be32toh(hdr->length);
+    hdr->offset = be64toh(hdr->offset);
+
+    return (hdr->magic == FT_MAGIC) ? 0 : -1;
+}
+
+/**
+ * Discard len payload bytes the receiver does not want
+ */
+static inline int ft_drain(int fd, uint64_t len) {
+    uint8_t scratch[4096];
+    while (len > 0) {
+        size_t n = len < sizeof(scratch) ? (size_t)len : sizeof(scratch);
+        if (ft_read_full(fd, scratch, n) < 0) return -1;
+        len -= n;
+    }
+    return 0;
+}
+
+// ============================================================================
+// SENDER
+// ============================================================================
+
+/**
+ * Send a file over a connected stream socket.
+ * Chunks go out with sendfile() (no user-space copy) while up to
+ * window_chunks remain un-ACKed; the receiver's RESUME offset lets an
+ * interrupted transfer pick up where it stopped.
+ * @return 0 on success, -1 on error (call again to resume)
+ */
+static inline int ft_send_file(int sock_fd, const char* path, const char* remote_name) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        perror("ft_send_file: open");
+        return -1;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) < 0) {
+        close(fd);
+        return -1;
+    }
+    uint64_t file_size = (uint64_t)st.st_size;
+
+    uint8_t open_buf[sizeof(FT_OpenInfo) + FT_MAX_NAME_LEN];
+    FT_OpenInfo open_info;
+    size_t name_len = strnlen(remote_name, FT_MAX_NAME_LEN);
+
+    open_info.mtime_ns = htobe64((uint64_t)st.st_mtim.tv_sec * 1000000000ull +
+                                 (uint64_t)st.st_mtim.tv_nsec);
+    memcpy(open_buf, &open_info, sizeof(open_info));
+    memcpy(open_buf + sizeof(open_info), remote_name, name_len);
+    if (ft_send_frame(sock_fd, FT_FRAME_OPEN, 0, file_size, open_buf,
+                      (uint32_t)(sizeof(open_info) + name_len)) < 0) {
+        close(fd);
+        return -1;
+    }
+
+    FT_FrameHeader hdr;
+    FT_ResumeInfo info;
+    if (ft_recv_header(sock_fd, &hdr) < 0 || hdr.type != FT_FRAME_RESUME ||
+        hdr.length != sizeof(info) || ft_read_full(sock_fd, &info, sizeof(info)) < 0) {
+        close(fd);
+        return -1;
+    }
+
+    uint64_t chunk = be32toh(info.chunk_size);
+    uint64_t window = (uint64_t)be32toh(info.window_chunks) * chunk;
+    if (chunk == 0 || window == 0 || hdr.offset > file_size) {
+        close(fd);
+        return -1;
+    }
+
+    uint64_t acked = hdr.offset;
+    uint64_t next = hdr.offset;
+
+    while (acked < file_size) {
+        // Fill the window
+        while (next < file_size && next - acked < window) {
+            uint32_t len = (uint32_t)((file_size - next) < chunk ? (file_size - next) : chunk);
+            if (ft_send_frame(sock_fd, FT_FRAME_DATA, 0, next, NULL, len) < 0) {
+                close(fd);
+                return -1;
+            }
+
+            off_t off = (off_t)next;
+            size_t left = len;
+            while (left > 0) {
+                ssize_t n = sendfile(sock_fd, fd, &off, left);
+                if (n < 0 && errno == EINTR) continue;
+                if (n <= 0) {
+                    close(fd);
+                    return -1;
+                }
+                left -= (size_t)n;
+            }
+            next += len;
+        }
+
+        // Slide on the next ACK
+        if (ft_recv_header(sock_fd, &hdr) < 0 || hdr.type != FT_FRAME_ACK) {
+            close(fd);
+            return -1;
+        }
+        if (hdr.offset > acked) acked = hdr.offset;
+        if (hdr.flags & FT_FLAG_REWIND) next = hdr.offset;
+    }
+
+    close(fd);
+
+    if (ft_send_frame(sock_fd, FT_FRAME_CLOSE, 0, file_size, NULL, 0) < 0) return -1;
+
+    // Drain trailing ACKs until the receiver confirms
+    while (ft_recv_header(sock_fd, &hdr) == 0) {
+        if (hdr.type == FT_FRAME_DONE) return 0;
+        if (hdr.type == FT_FRAME_ERROR) return -1;
+        if (hdr.length > 0 && ft_drain(sock_fd, hdr.length) < 0) break;
+    }
+    return -1;
+}
+
+#endif // FILE_TRANSFER_H
@@ -0,0 +1,409 @@
+/**
+ * L7 <-> RRC Control Protocol
+ * Typed command struct filled in one pass from either encoding:
+ *
+ *   Binary TLV (preferred):
+ *     magic(1)=0xA7 | version(1) | body_len(2, BE) | TLV...
+ *     TLV = tag(1) | len(2, BE) | value[len]   (ints are 4-byte BE)
+ *
+ *   JSON (legacy clients): flat object, e.g.
+ *     {"command":"start_call","destination_id":5}
+ *
+ * Neither path allocates or copies: string and payload fields point into
+ * the caller's buffer and are NOT NUL-terminated (use the *_len fields).
+ * JSON string escapes are skipped over but not decoded.
+ */
+
+#ifndef L7_CONTROL_H
+#define L7_CONTROL_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+
+#define L7_TLV_MAGIC    0xA7
+#define L7_TLV_VERSION  1
+#define L7_TLV_HDR_LEN  4
+
+// TLV tags
+typedef enum {
+    L7_TLV_COMMAND = 1,            // string
+    L7_TLV_DESTINATION_ID = 2,     // int32
+    L7_TLV_NODE_ID = 3,            // int32
+    L7_TLV_DEST_NODE_ID = 4,       // int32
+    L7_TLV_NEXT_HOP_NODE = 5,      // int32
+    L7_TLV_PRIORITY = 6,           // int32
+    L7_TLV_DATA_TYPE = 7,          // int32 (RRC_DataType value)
+    L7_TLV_TRANSMISSION_TYPE = 8,  // int32 (TransmissionType value)
+    L7_TLV_DATA = 9,               // bytes
+    L7_TLV_DATA_SIZE = 10          // int32
+} L7_TlvTag;
+
+// Presence bits for L7_Command.present
+#define L7_FIELD_COMMAND            (1u << L7_TLV_COMMAND)
+#define L7_FIELD_DESTINATION_ID     (1u << L7_TLV_DESTINATION_ID)
+#define L7_FIELD_NODE_ID            (1u << L7_TLV_NODE_ID)
+#define L7_FIELD_DEST_NODE_ID       (1u << L7_TLV_DEST_NODE_ID)
+#define L7_FIELD_NEXT_HOP_NODE      (1u << L7_TLV_NEXT_HOP_NODE)
+#define L7_FIELD_PRIORITY           (1u << L7_TLV_PRIORITY)
+#define L7_FIELD_DATA_TYPE          (1u << L7_TLV_DATA_TYPE)
+#define L7_FIELD_TRANSMISSION_TYPE  (1u << L7_TLV_TRANSMISSION_TYPE)
+#define L7_FIELD_DATA               (1u << L7_TLV_DATA)
+#define L7_FIELD_DATA_SIZE          (1u << L7_TLV_DATA_SIZE)
+
+typedef enum {
+    L7_FORMAT_INVALID = -1,
+    L7_FORMAT_TEXT = 0,    // Not a control message (plain chat text)
+    L7_FORMAT_JSON = 1,
+    L7_FORMAT_TLV = 2
+} L7_Format;
+
+typedef struct {
+    uint32_t present;              // L7_FIELD_* bits
+    const char* command;           // Points into input buffer
+    uint16_t command_len;
+    int32_t destination_id;
+    int32_t node_id;
+    int32_t dest_node_id;
+    int32_t next_hop_node;
+    int32_t priority;
+    int32_t data_type;             // RRC_DataType value
+    int32_t transmission_type;     // TransmissionType value
+    int32_t data_size;
+    const char* data_type_name;    // JSON string form, e.g. "ptt" (NULL for TLV)
+    uint16_t data_type_name_len;
+    const uint8_t* data;           // Points into input buffer
+    size_t data_len;
+} L7_Command;
+
+// ============================================================================
+// HELPERS
+// ============================================================================
+
+static inline bool l7_command_is(const L7_Command* cmd, const char* name) {
+    size_t n = strlen(name);
+    return (cmd->present & L7_FIELD_COMMAND) && cmd->command_len == n &&
+           memcmp(cmd->command, name, n) == 0;
+}
+
+static inline bool l7_span_equals(const char* s, size_t len, const char* lit) {
+    size_t n = strlen(lit);
+    return len == n && memcmp(s, lit, n) == 0;
+}
+
+// String data_type names used by the RRC JSON producers
+static inline int32_t l7_data_type_from_name(const char* s, size_t len) {
+    if (l7_span_equals(s, len, "sms")) return 0;
+    if (l7_span_equals(s, len, "voice") || l7_span_equals(s, len, "voice_digital")) return 1;
+    if (l7_span_equals(s, len, "video")) return 2;
+    if (l7_span_equals(s, len, "file")) return 3;
+    if (l7_span_equals(s, len, "relay")) return 4;
+    if (l7_span_equals(s, len, "ptt")) return 5;
+    return 99;
+}
+
+static inline int32_t l7_transmission_type_from_name(const char* s, size_t len) {
+    if (l7_span_equals(s, len, "multicast")) return 1;
+    if (l7_span_equals(s, len, "broadcast")) return 2;
+    return 0;
+}
+
+// Map a JSON key to its TLV tag without building a string
+static inline int l7_key_to_tag(const char* k, size_t len) {
+    switch (len) {
+        case 4:
+            if (memcmp(k, "data", 4) == 0) return L7_TLV_DATA;
+            break;
+        case 7:
+            if (memcmp(k, "command", 7) == 0) return L7_TLV_COMMAND;
+            if (memcmp(k, "node_id", 7) == 0) return L7_TLV_NODE_ID;
+            break;
+        case 8:
+            if (memcmp(k, "priority", 8) == 0) return L7_TLV_PRIORITY;
+            break;
+        case 9:
+            if (memcmp(k, "data_type", 9) == 0) return L7_TLV_DATA_TYPE;
+            if (memcmp(k, "data_size", 9) == 0) return L7_TLV_DATA_SIZE;
+            break;
+        case 12:
+            if (memcmp(k, "dest_node_id", 12) == 0) return L7_TLV_DEST_NODE_ID;
+            break;
+        case 13:
+            if (memcmp(k, "next_hop_node", 13) == 0) return L7_TLV_NEXT_HOP_NODE;
+            break;
+        case 14:
+            if (memcmp(k, "destination_id", 14) == 0) return L7_TLV_DESTINATION_ID;
+            break;
+        case 17:
+            if (memcmp(k, "transmission_type", 17) == 0) return L7_TLV_TRANSMISSION_TYPE;
+            break;
+    }
+    return 0;
+}
+
+static inline int32_t* l7_int_field(L7_Command* cmd, int tag) {
+    switch (tag) {
+        case L7_TLV_DESTINATION_ID:    return &cmd->destination_id;
+        case L7_TLV_NODE_ID:           return &cmd->node_id;
+        case L7_TLV_DEST_NODE_ID:      return &cmd->dest_node_id;
+        case L7_TLV_NEXT_HOP_NODE:     return &cmd->next_hop_node;
+        case L7_TLV_PRIORITY:          return &cmd->priority;
+        case L7_TLV_DATA_TYPE:         return &cmd->data_type;
+        case L7_TLV_TRANSMISSION_TYPE: return &cmd->transmission_type;
+        case L7_TLV_DATA_SIZE:         return &cmd->data_size;
+        default:                       return NULL;
+    }
+}
+
+// ============================================================================
+// JSON TOKENIZER (single pass, no allocation)
+// ============================================================================
+
+static inline const char* l7_json_skip_ws(const char* p, const char* end) {
+    while (p < end && (*p == ' ' || *p == '\t' || *p == '\n' || *p == '\r')) p++;
+    return p;
+}
+
+// p points just past the opening quote; returns pointer to the closing quote
+static inline const char* l7_json_string_end(const char* p, const char* end) {
+    while (p < end && *p != '"') {
+        if (*p == '\\') p++;
+        p++;
+    }
+    return (p < end) ? p : NULL;
+}
+
+// Skip a nested object/array value
+static inline const char* l7_json_skip_nested(const char* p, const char* end) {
+    int depth = 0;
+    while (p < end) {
+        char c = *p;
+        if (c == '"') {
+            p = l7_json_string_end(p + 1, end);
+            if (!p) return NULL;
+        } else if (c == '{' || c == '[') {
+            depth++;
+        } else if (c == '}' || c == ']') {
+            if (--depth == 0) return p + 1;
+        }
+        p++;
+    }
+    return NULL;
+}
+
+/**
+ * Parse a flat JSON object into cmd in a single left-to-right pass
+ * @return 0 on success, -1 on malformed input
+ */
+static inline int l7_json_parse_command(const char* buf, size_t len, L7_Command* cmd) {
+    const char* p = buf;
+    const char* end = buf + len;
+
+    memset(cmd, 0, sizeof(*cmd));
+
+    p = l7_json_skip_ws(p, end);
+    if (p >= end || *p != '{') return -1;
+    p++;
+
+    while (p < end) {
+        p = l7_json_skip_ws(p, end);
+        if (p < end && *p == '}') return 0;
+        if (p >= end || *p != '"') return -1;
+
+        const char* key = p + 1;
+        const char* key_end = l7_json_string_end(key, end);
+        if (!key_end) return -1;
+        int tag = l7_key_to_tag(key, (size_t)(key_end - key));
+
+        p = l7_json_skip_ws(key_end + 1, end);
+        if (p >= end || *p != ':') return -1;
+        p = l7_json_skip_ws(p + 1, end);
+        if (p >= end) return -1;
+
+        if (*p == '"') {
+            const char* val = p + 1;
+            const char* val_end = l7_json_string_end(val, end);
+            if (!val_end) return -1;
+            size_t vlen = (size_t)(val_end - val);
+
+            switch (tag) {
+                case L7_TLV_COMMAND:
+                    cmd->command = val;
+                    cmd->command_len = (uint16_t)(vlen > 0xFFFF ? 0xFFFF : vlen);
+                    cmd->present |= L7_FIELD_COMMAND;
+                    break;
+                case L7_TLV_DATA:
+                    cmd->data = (const uint8_t*)val;
+                    cmd->data_len = vlen;
+                    cmd->present |= L7_FIELD_DATA;
+                    break;
+                case L7_TLV_DATA_TYPE:
+                    cmd->data_type_name = val;
+                    cmd->data_type_name_len = (uint16_t)(vlen > 0xFFFF ? 0xFFFF : vlen);
+                    cmd->data_type = l7_data_type_from_name(val, vlen);
+                    cmd->present |= L7_FIELD_DATA_TYPE;
+                    break;
+                case L7_TLV_TRANSMISSION_TYPE:
+                    cmd->transmission_type = l7_transmission_type_from_name(val, vlen);
+                    cmd->present |= L7_FIELD_TRANSMISSION_TYPE;
+                    break;
+                default:
+                    break;
+            }
+            p = val_end + 1;
+        } else if (*p == '-' || (*p >= '0' && *p <= '9')) {
+            bool neg = (*p == '-');
+            int64_t v = 0;
+            if (neg) p++;
+            while (p < end && *p >= '0' && *p <= '9') {
+                if (v < INT32_MAX) v = v * 10 + (*p - '0');
+                p++;
+            }
+            // Fraction/exponent are truncated
+            while (p < end && (*p == '.' || *p == 'e' || *p == 'E' || *p == '+' || *p == '-' ||
+                               (*p >= '0' && *p <= '9'))) p++;
+            if (v > INT32_MAX) v = INT32_MAX;
+
+            int32_t* field = l7_int_field(cmd, tag);
+            if (field) {
+                *field = (int32_t)(neg ? -v : v);
+                cmd->present |= (1u << tag);
+            }
+        } else if (*p == '{' || *p == '[') {
+            p = l7_json_skip_nested(p, end);
+            if (!p) return -1;
+        } else {
+            // true / false / null
+            while (p < end && *p != ',' && *p != '}') p++;
+        }
+
+        p = l7_json_skip_ws(p, end);
+        if (p < end && *p == ',') {
+            p++;
+        } else if (p < end && *p == '}') {
+            return 0;
+        } else {
+            return -1;
+        }
+    }
+    return -1;
+}
+
+// ============================================================================
+// BINARY TLV CODEC
+// ============================================================================
+
+static inline size_t l7_tlv_put(uint8_t* out, size_t pos, size_t max, uint8_t tag,
+                                const void* val, size_t len) {
+    if (pos == 0 || len > 0xFFFF || pos + 3 + len > max) return 0;
+    out[pos] = tag;
+    out[pos + 1] = (uint8_t)(len >> 8);
+    out[pos + 2] = (uint8_t)len;
+    memcpy(out + pos + 3, val, len);
+    return pos + 3 + len;
+}
+
+static inline size_t l7_tlv_put_int(uint8_t* out, size_t pos, size_t max, uint8_t tag, int32_t v) {
+    uint8_t be[4] = {(uint8_t)((uint32_t)v >> 24), (uint8_t)((uint32_t)v >> 16),
+                     (uint8_t)((uint32_t)v >> 8), (uint8_t)v};
+    return l7_tlv_put(out, pos, max, tag, be, sizeof(be));
+}
+
+/**
+ * Encode the fields present in cmd
+ * @return encoded length, 0 if out is too small
+ */
+static inline size_t l7_tlv_encode_command(const L7_Command* cmd, uint8_t* out, size_t max) {
+    if (max < L7_TLV_HDR_LEN) return 0;
+
+    size_t pos = L7_TLV_HDR_LEN;
+    if (cmd->present & L7_FIELD_COMMAND) {
+        pos = l7_tlv_put(out, pos, max, L7_TLV_COMMAND, cmd->command, cmd->command_len);
+    }
+    for (int tag = L7_TLV_DESTINATION_ID; tag <= L7_TLV_DATA_SIZE; tag++) {
+        if (tag == L7_TLV_DATA || !(cmd->present & (1u << tag))) continue;
+        pos = l7_tlv_put_int(out, pos, max, (uint8_t)tag, *l7_int_field((L7_Command*)cmd, tag));
+    }
+    if (cmd->present & L7_FIELD_DATA) {
+        pos = l7_tlv_put(out, pos, max, L7_TLV_DATA, cmd->data, cmd->data_len);
+    }
+    if (pos == 0 || pos - L7_TLV_HDR_LEN > 0xFFFF) return 0;
+
+    out[0] = L7_TLV_MAGIC;
+    out[1] = L7_TLV_VERSION;
+    out[2] = (uint8_t)((pos - L7_TLV_HDR_LEN) >> 8);
+    out[3] = (uint8_t)(pos - L7_TLV_HDR_LEN);
+    return pos;
+}
+
+/**
+ * Decode a TLV control message; unknown tags are skipped
+ * @return 0 on success, -1 on malformed input
+ */
+static inline int l7_tlv_decode_command(const uint8_t* buf, size_t len, L7_Command* cmd) {
+    memset(cmd, 0, sizeof(*cmd));
+
+    if (len < L7_TLV_HDR_LEN || buf[0] != L7_TLV_MAGIC || buf[1] != L7_TLV_VERSION) return -1;
+
+    size_t body = ((size_t)buf[2] << 8) | buf[3];
+    if (L7_TLV_HDR_LEN + body > len) return -1;
+
+    const uint8_t* p = buf + L7_TLV_HDR_LEN;
+    const uint8_t* end = p + body;
+
+    while (p < end) {
+        if (end - p < 3) return -1;
+        uint8_t tag = p[0];
+        size_t vlen = ((size_t)p[1] << 8) | p[2];
+        const uint8_t* val = p + 3;
+        if ((size_t)(end - val) < vlen) return -1;
+
+        if (tag == L7_TLV_COMMAND) {
+            cmd->command = (const char*)val;
+            cmd->command_len = (uint16_t)vlen;
+            cmd->present |= L7_FIELD_COMMAND;
+        } else if (tag == L7_TLV_DATA) {
+            cmd->data = val;
+            cmd->data_len = vlen;
+            cmd->present |= L7_FIELD_DATA;
+        } else {
+            int32_t* field = l7_int_field(cmd, tag);
+            if (field && vlen == 4) {
+                *field = (int32_t)(((uint32_t)val[0] << 24) | ((uint32_t)val[1] << 16) |
+                                   ((uint32_t)val[2] << 8) | val[3]);
+                cmd->present |= (1u << tag);
+            }
+        }
+        p = val + vlen;
+    }
+    return 0;
+}
+
+// ============================================================================
+// ENTRY POINT
+// ============================================================================
+
+/**
+ * Detect the encoding from the first byte and fill cmd
+ * @return L7_FORMAT_TLV / L7_FORMAT_JSON on success, L7_FORMAT_TEXT if the
+ *         buffer is not a control message, L7_FORMAT_INVALID if malformed
+ */
+static inline L7_Format l7_parse_control(const uint8_t* buf, size_t len, L7_Command* cmd) {
+    if (len == 0) return L7_FORMAT_TEXT;
+
+    if (buf[0] == L7_TLV_MAGIC) {
+        return l7_tlv_decode_command(buf, len, cmd) == 0 ? L7_FORMAT_TLV : L7_FORMAT_INVALID;
+    }
+
+    const char* p = l7_json_skip_ws((const char*)buf, (const char*)buf + len);
+    if (p < (const char*)buf + len && *p == '{') {
+        return l7_json_parse_command((const char*)buf, len, cmd) == 0 ?
+               L7_FORMAT_JSON : L7_FORMAT_INVALID;
+    }
+
+    memset(cmd, 0, sizeof(*cmd));
+    return L7_FORMAT_TEXT;
+}
+
+#endif // L7_CONTROL_H
@@ -5,6 +5,9 @@
 #include <sys/socket.h>
 #include <sys/un.h>
 #include <signal.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include "l7_control.h"
 
 #define SOCKET_PATH "/tmp/msg_socket"
 #define BUFFER_SIZE 1024
@@ -24,45 +27,27 @@ void signal_handler(int sig) {
     exit(0);
 }
 
-// Simple JSON parser for extracting command and destination_id
-void parse_json_command(const char* json_str, char* command, int* destination_id) {
-    char* cmd_start = strstr(json_str, "\"command\"");
-    char* dest_start = strstr(json_str, "\"destination_id\"");
+// Extract command and destination_id from a TLV or JSON control message
+// (single pass, see l7_control.h)
+bool parse_control_command(const char* buf, size_t len, char* command, size_t command_size,
+                           int* destination_id) {
+    L7_Command cmd;
     
-    // Initialize defaults
-    strcpy(command, "");
+    command[0] = '\0';
     *destination_id = 0;
     
-    if (cmd_start) {
-        // Find the value after "command":
-        cmd_start = strchr(cmd_start, ':');
-        if (cmd_start) {
-            cmd_start++;
-            // Skip whitespace and quotes
-            while (*cmd_start == ' ' || *cmd_start == '\t') cmd_start++;
-            if (*cmd_start == '"') {
-                cmd_start++;
-                char* cmd_end = strchr(cmd_start, '"');
-                if (cmd_end) {
-                    int len = cmd_end - cmd_start;
-                    if (len < 63) {  // Ensure we don't overflow
-                        strncpy(command, cmd_start, len);
-                        command[len] = '\0';
-                    }
-                }
-            }
-        }
+    L7_Format format = l7_parse_control((const uint8_t*)buf, len, &cmd);
+    if (format != L7_FORMAT_JSON && format != L7_FORMAT_TLV) {
+        return false;
     }
     
-    if (dest_start) {
-        // Find the value after "destination_id":
-        dest_start = strchr(dest_start, ':');
-        if (dest_start) {
-            dest_start++;
-            while (*dest_start == ' ' || *dest_start == '\t') dest_start++;
-            *destination_id = atoi(dest_start);
-        }
+    if (cmd.present & L7_FIELD_COMMAND) {
+        size_t n = cmd.command_len < command_size - 1 ? cmd.command_len : command_size - 1;
+        memcpy(command, cmd.command, n);
+        command[n] = '\0';
     }
+    *destination_id = cmd.destination_id;
+    return true;
 }
 
 int main() {
@@ -127,13 +112,14 @@ int main() {
             //Dhanush - memcpy(var_x.buffer, buffer, bytes_received);
             //Dhanush - printf("%s", var_x.buffer);
             buffer[bytes_received] = '\0';
-            printf("Message received: %s\n", buffer);
             
-            // Check if it's a JSON command
-            if (buffer[0] == '{') {
-                char command[64];
-                int destination_id;
-                parse_json_command(buffer, command, &destination_id);
+            char command[64];
+            int destination_id;
+            
+            // Check if it's a TLV or JSON command
+            if (parse_control_command(buffer, (size_t)bytes_received, command,
+                                      sizeof(command), &destination_id)) {
+                printf("Command received: %s (destination %d)\n", command, destination_id);
                 
                 if (strcmp(command, "start_call") == 0) {
                     printf("Starting call to SDR with ID: %d\n", destination_id);
@@ -148,6 +134,7 @@ int main() {
                 }
             } else {
                 // Regular text message
+                printf("Message received: %s\n", buffer);
                 const char* ack = "Message received by SDR";
                 send(client_fd, ack, strlen(ack), 0);
             }
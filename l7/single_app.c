@@ -13,6 +13,9 @@
 #include <stdint.h>
 #include <arpa/inet.h>
 #include <sys/wait.h>
+#include "l7_control.h"
+#include "webm_ingest.h"
+#include "video_ring.h"
 
 // Socket paths for different services
 #define MSG_SOCKET_PATH "/tmp/msg_socket"
@@ -23,8 +26,6 @@
 // Common definitions
 #define BUFFER_SIZE 1048576  // 1MB buffer for video data
 #define UPLOADS_DIR "../uploads"
-#define PIPE_PATH "/tmp/video_pipe"
-#define WEBM_FILE "/tmp/video_stream.webm"
 
 // Colors for output
 #define RED     "\x1b[31m"
@@ -42,7 +43,11 @@ int video_server_fd = -1;
 // Global state variables
 volatile int running = 1;
 int current_sdr_id = 0;
-FILE* webm_file = NULL;
+
+// Local video playback ring (shared with video_server / video_ring_play)
+VideoRingContext video_ring;
+bool video_ring_ready = false;
+WebmIngest video_ingest;
 
 // Thread data structure
 typedef struct {
@@ -100,8 +105,8 @@ void signal_handler(int sig) {
         unlink(VIDEO_SOCKET_PATH);
     }
     
-    if (webm_file) {
-        fclose(webm_file);
+    if (video_ring_ready) {
+        video_ring_close(&video_ring, true);
     }
     
     print_success("All services stopped successfully");
@@ -184,24 +189,26 @@ void handle_message_client(int client_fd) {
     bytes_received = recv(client_fd, buffer, BUFFER_SIZE - 1, 0);
     if (bytes_received > 0) {
         buffer[bytes_received] = '\0';
-        printf(GREEN "[MESSAGE]" RESET " Received: %s\n", buffer);
         
-        // Parse JSON command (simplified)
-        char command[256] = "";
-        int destination_id = 0;
+        // Parse TLV or JSON command in one pass into a typed struct
+        L7_Command cmd;
+        L7_Format format = l7_parse_control((const uint8_t*)buffer, (size_t)bytes_received, &cmd);
         
-        char* cmd_start = strstr(buffer, "\"command\"");
-        if (cmd_start) {
-            sscanf(cmd_start, "\"command\":\"%255[^\"]\"", command);
+        if (format == L7_FORMAT_INVALID) {
+            print_error("Malformed control message");
+            const char* nack = "{\"status\":\"error\",\"message\":\"Malformed control message\"}";
+            send(client_fd, nack, strlen(nack), 0);
+            return;
         }
         
-        char* dest_start = strstr(buffer, "\"destination_id\"");
-        if (dest_start) {
-            sscanf(dest_start, "\"destination_id\":%d", &destination_id);
+        if (format == L7_FORMAT_TEXT) {
+            printf(GREEN "[MESSAGE]" RESET " Received: %s\n", buffer);
+        } else {
+            printf(BLUE "[MESSAGE]" RESET " Command: %.*s, Destination: %d (%s)\n",
+                   (int)cmd.command_len, cmd.command ? cmd.command : "",
+                   cmd.destination_id, format == L7_FORMAT_TLV ? "TLV" : "JSON");
         }
         
-        printf(BLUE "[MESSAGE]" RESET " Command: %s, Destination: %d\n", command, destination_id);
-        
         // Send acknowledgment
         const char* ack = "{\"status\":\"success\",\"message\":\"Message received by MANET server\"}";
         send(client_fd, ack, strlen(ack), 0);
@@ -307,6 +314,16 @@ void handle_file_client(int client_fd) {
     }
 }
 
+// Feed tagged WebM units into the playback ring
+void on_video_unit(WebmUnitKind kind, const uint8_t* data, size_t len, void* user) {
+    WebmIngest* ingest = (WebmIngest*)user;
+    
+    if (kind == WEBM_UNIT_HEADER && ingest->clusters == 0) {
+        video_ring_append_header(&video_ring, data, len);
+    }
+    video_ring_write(&video_ring, data, len);
+}
+
 // Video service handler
 void handle_video_client(int client_fd) {
     char buffer[BUFFER_SIZE];
@@ -315,34 +332,43 @@ void handle_video_client(int client_fd) {
     bytes_received = recv(client_fd, buffer, BUFFER_SIZE - 1, 0);
     if (bytes_received > 0) {
         buffer[bytes_received] = '\0';
-        printf(GREEN "[VIDEO]" RESET " Received video command: %s\n", buffer);
         
         if (strstr(buffer, "start_stream")) {
             printf(BLUE "[VIDEO]" RESET " Starting video stream\n");
             
-            // Open WebM file for writing if not already open
-            if (!webm_file) {
-                webm_file = fopen(WEBM_FILE, "wb");
-                if (!webm_file) {
-                    print_error("Failed to open WebM file");
+            // Open playback ring if not already open
+            if (!video_ring_ready) {
+                if (video_ring_open(&video_ring, true) == 0) {
+                    video_ring_ready = true;
+                } else {
+                    print_error(errno == EBUSY ?
+                                "Video playback ring already has a writer" :
+                                "Failed to open video playback ring");
                 }
             }
+            if (video_ring_ready) {
+                webm_ingest_init(&video_ingest);
+                video_ring_begin_session(&video_ring);
+            }
             
             const char* response = "{\"status\":\"success\",\"action\":\"stream_started\"}";
             send(client_fd, response, strlen(response), 0);
         } else if (strstr(buffer, "stop_stream")) {
             printf(BLUE "[VIDEO]" RESET " Stopping video stream\n");
             
-            if (webm_file) {
-                fclose(webm_file);
-                webm_file = NULL;
-            }
-            
             const char* response = "{\"status\":\"success\",\"action\":\"stream_stopped\"}";
             send(client_fd, response, strlen(response), 0);
         } else {
             // Handle video frame data
-            printf(BLUE "[VIDEO]" RESET " Processing video frame\n");
+            if (video_ring_ready) {
+                uint32_t clusters_before = video_ingest.clusters;
+                webm_ingest_feed(&video_ingest, (const uint8_t*)buffer, (size_t)bytes_received,
+                                 on_video_unit, &video_ingest);
+                if (video_ingest.clusters != clusters_before) {
+                    video_ring_mark_cluster(&video_ring, video_ingest.last_cluster_pos);
+                }
+            }
+            printf(BLUE "[VIDEO]" RESET " Processed video chunk (%zd bytes)\n", bytes_received);
             const char* response = "{\"status\":\"success\",\"message\":\"Frame processed\"}";
             send(client_fd, response, strlen(response), 0);
         }
@@ -0,0 +1,228 @@
+/**
+ * Shared-Memory Video Ring for Local Playback
+ * Single writer (video server), any number of readers (players)
+ *
+ * The writer holds an exclusive flock() on the shm object for as long as
+ * it has the ring open, so a second writer fails to open instead of
+ * interleaving its stream; the lock goes away with the writer's process.
+ *
+ * The writer appends the raw WebM stream; positions are monotonic byte
+ * counters so readers detect overruns without locks. The init segment
+ * (everything before the first Cluster) is kept separately, so a reader
+ * that joins late or falls behind can restart cleanly at the latest
+ * cluster boundary.
+ *
+ * session is odd while the writer resets the per-session fields, so readers
+ * take them with video_ring_get_session(). write_end is published before
+ * the bytes are copied in, so a reader can tell whether the writer was
+ * already overwriting what it copied.
+ */
+
+#ifndef VIDEO_RING_H
+#define VIDEO_RING_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#ifndef VIDEO_RING_SHM
+#define VIDEO_RING_SHM          "/manet_video_ring"
+#endif
+#define VIDEO_RING_MAGIC        0x56524E47u   // "VRNG"
+#define VIDEO_RING_SIZE         (4 * 1024 * 1024)
+#define VIDEO_RING_HEADER_MAX   65536
+
+typedef struct {
+    uint32_t magic;
+    volatile uint32_t session;        // Bumped on every new client session
+    volatile uint64_t write_pos;      // Total bytes ever written
+    volatile uint64_t write_end;      // write_pos once the write in progress completes
+    volatile uint64_t session_start;  // write_pos at the start of the session
+    volatile uint64_t cluster_pos;    // write_pos of the latest Cluster start
+    volatile uint32_t header_len;     // Valid bytes in header[]
+    uint8_t header[VIDEO_RING_HEADER_MAX];
+    uint8_t data[VIDEO_RING_SIZE];
+} VideoRing;
+
+// Per-session fields as one consistent snapshot
+typedef struct {
+    uint32_t session;
+    uint64_t session_start;
+    uint64_t cluster_pos;
+    uint32_t header_len;
+} VideoRingSession;
+
+typedef struct {
+    int shm_fd;
+    VideoRing* ring;
+    bool writer;
+} VideoRingContext;
+
+/**
+ * Create (writer) or attach to (reader) the playback ring
+ * @return 0 on success, -1 on error (errno EBUSY: another writer has it)
+ */
+static inline int video_ring_open(VideoRingContext* ctx, bool writer) {
+    memset(ctx, 0, sizeof(*ctx));
+    ctx->writer = writer;
+
+    if (writer) {
+        ctx->shm_fd = shm_open(VIDEO_RING_SHM, O_CREAT | O_RDWR, 0666);
+        if (ctx->shm_fd < 0) return -1;
+        if (flock(ctx->shm_fd, LOCK_EX | LOCK_NB) < 0) {
+            int err = (errno == EWOULDBLOCK) ? EBUSY : errno;
+            close(ctx->shm_fd);
+            errno = err;
+            return -1;
+        }
+        if (ftruncate(ctx->shm_fd, sizeof(VideoRing)) < 0) {
+            close(ctx->shm_fd);
+            return -1;
+        }
+    } else {
+        ctx->shm_fd = shm_open(VIDEO_RING_SHM, O_RDONLY, 0666);
+        if (ctx->shm_fd < 0) return -1;
+    }
+
+    ctx->ring = (VideoRing*)mmap(NULL, sizeof(VideoRing),
+                                 writer ? (PROT_READ | PROT_WRITE) : PROT_READ,
+                                 MAP_SHARED, ctx->shm_fd, 0);
+    if (ctx->ring == MAP_FAILED) {
+        close(ctx->shm_fd);
+        ctx->ring = NULL;
+        return -1;
+    }
+
+    if (writer && ctx->ring->magic != VIDEO_RING_MAGIC) {
+        memset(ctx->ring, 0, offsetof(VideoRing, header));
+        ctx->ring->magic = VIDEO_RING_MAGIC;
+    }
+    // A previous writer died while starting a session
+    if (writer && (ctx->ring->session & 1)) {
+        __atomic_add_fetch(&ctx->ring->session, 1, __ATOMIC_RELEASE);
+    }
+    return 0;
+}
+
+static inline void video_ring_close(VideoRingContext* ctx, bool unlink) {
+    if (ctx->ring) munmap(ctx->ring, sizeof(VideoRing));
+    if (ctx->shm_fd >= 0) close(ctx->shm_fd);
+    if (unlink) shm_unlink(VIDEO_RING_SHM);
+    memset(ctx, 0, sizeof(*ctx));
+    ctx->shm_fd = -1;
+}
+
+// ============================================================================
+// WRITER
+// ============================================================================
+
+static inline void video_ring_begin_session(VideoRingContext* ctx) {
+    VideoRing* r = ctx->ring;
+
+    // Odd session: readers retry until the fields below are consistent
+    __atomic_add_fetch(&r->session, 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    r->header_len = 0;
+    r->session_start = r->write_pos;
+    r->cluster_pos = r->write_pos;
+    __atomic_add_fetch(&r->session, 1, __ATOMIC_RELEASE);
+}
+
+// Init-segment bytes are also written to the stream; this keeps a copy
+static inline void video_ring_append_header(VideoRingContext* ctx, const uint8_t* data, size_t len) {
+    VideoRing* r = ctx->ring;
+    if (r->header_len + len > VIDEO_RING_HEADER_MAX) return;
+    memcpy(r->header + r->header_len, data, len);
+    __atomic_store_n(&r->header_len, r->header_len + (uint32_t)len, __ATOMIC_RELEASE);
+}
+
+static inline void video_ring_write(VideoRingContext* ctx, const uint8_t* data, size_t len) {
+    VideoRing* r = ctx->ring;
+    uint64_t pos = r->write_pos;
+
+    // Reserve before copying: readers compare against write_end
+    __atomic_store_n(&r->write_end, pos + len, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+
+    while (len > 0) {
+        size_t at = (size_t)(pos % VIDEO_RING_SIZE);
+        size_t n = VIDEO_RING_SIZE - at;
+        if (n > len) n = len;
+        memcpy(r->data + at, data, n);
+        data += n;
+        len -= n;
+        pos += n;
+    }
+
+    __atomic_store_n(&r->write_pos, pos, __ATOMIC_RELEASE);
+}
+
+static inline void video_ring_mark_cluster(VideoRingContext* ctx, uint64_t stream_offset) {
+    VideoRing* r = ctx->ring;
+    __atomic_store_n(&r->cluster_pos, r->session_start + stream_offset, __ATOMIC_RELEASE);
+}
+
+// ============================================================================
+// READER
+// ============================================================================
+
+/**
+ * Snapshot the per-session fields, retrying while a new session is set up
+ */
+static inline void video_ring_get_session(const VideoRingContext* ctx, VideoRingSession* s) {
+    VideoRing* r = ctx->ring;
+
+    for (;;) {
+        uint32_t before = __atomic_load_n(&r->session, __ATOMIC_ACQUIRE);
+        if (before & 1) continue;  // Writer mid-reset
+        s->session_start = __atomic_load_n(&r->session_start, __ATOMIC_RELAXED);
+        s->cluster_pos = __atomic_load_n(&r->cluster_pos, __ATOMIC_ACQUIRE);
+        s->header_len = __atomic_load_n(&r->header_len, __ATOMIC_ACQUIRE);
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        if (__atomic_load_n(&r->session, __ATOMIC_RELAXED) == before) {
+            s->session = before;
+            return;
+        }
+    }
+}
+
+/**
+ * Copy up to max bytes starting at *read_pos.
+ * @return bytes copied, 0 if no new data, -1 if the writer lapped the reader
+ *         (restart from cluster_pos after re-sending the header)
+ */
+static inline ssize_t video_ring_read(VideoRingContext* ctx, uint64_t* read_pos,
+                                      uint8_t* out, size_t max) {
+    VideoRing* r = ctx->ring;
+    uint64_t wpos = __atomic_load_n(&r->write_pos, __ATOMIC_ACQUIRE);
+
+    if (wpos - *read_pos > VIDEO_RING_SIZE) return -1;
+
+    size_t avail = (size_t)(wpos - *read_pos);
+    if (avail > max) avail = max;
+
+    size_t copied = 0;
+    while (copied < avail) {
+        size_t at = (size_t)((*read_pos + copied) % VIDEO_RING_SIZE);
+        size_t n = VIDEO_RING_SIZE - at;
+        if (n > avail - copied) n = avail - copied;
+        memcpy(out + copied, r->data + at, n);
+        copied += n;
+    }
+
+    // A write in progress may have overwritten what we copied meanwhile
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    if (__atomic_load_n(&r->write_end, __ATOMIC_RELAXED) - *read_pos > VIDEO_RING_SIZE) return -1;
+
+    *read_pos += copied;
+    return (ssize_t)copied;
+}
+
+#endif // VIDEO_RING_H
@@ -0,0 +1,101 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <signal.h>
+#include <stdint.h>
+#include "video_ring.h"
+
+// Streams the video server's shared-memory ring to stdout for a local player:
+//   ./video_ring_play | vlc -
+
+#define READ_CHUNK 65536
+#define POLL_INTERVAL_US 5000
+
+volatile int running = 1;
+
+void signal_handler(int sig) {
+    (void)sig;
+    running = 0;
+}
+
+static int write_all(const uint8_t* data, size_t len) {
+    while (len > 0) {
+        ssize_t n = write(STDOUT_FILENO, data, len);
+        if (n <= 0) return -1;
+        data += n;
+        len -= (size_t)n;
+    }
+    return 0;
+}
+
+// Start (or restart) a reader at the latest cluster, preceded by the init segment
+static uint64_t sync_to_cluster(VideoRingContext* ctx, uint32_t* session) {
+    static uint8_t header[VIDEO_RING_HEADER_MAX];
+    VideoRingSession s;
+
+    for (;;) {
+        video_ring_get_session(ctx, &s);
+        *session = s.session;
+
+        // No cluster yet: play the session from its first byte
+        if (s.cluster_pos <= s.session_start) {
+            return s.session_start;
+        }
+
+        // The header belongs to this session only if none started meanwhile
+        memcpy(header, ctx->ring->header, s.header_len);
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        if (__atomic_load_n(&ctx->ring->session, __ATOMIC_RELAXED) == s.session) {
+            break;
+        }
+    }
+
+    if (s.header_len > 0 && write_all(header, s.header_len) < 0) {
+        running = 0;
+    }
+    return s.cluster_pos;
+}
+
+int main(void) {
+    VideoRingContext ctx;
+    static uint8_t chunk[READ_CHUNK];
+    uint32_t session = 0;
+
+    signal(SIGINT, signal_handler);
+    signal(SIGTERM, signal_handler);
+    signal(SIGPIPE, signal_handler);
+
+    if (video_ring_open(&ctx, false) < 0) {
+        fprintf(stderr, "[PLAY] Video ring %s not available (is video_server running?)\n",
+                VIDEO_RING_SHM);
+        return 1;
+    }
+
+    uint64_t read_pos = sync_to_cluster(&ctx, &session);
+    fprintf(stderr, "[PLAY] Attached to %s, session %u\n", VIDEO_RING_SHM, session);
+
+    while (running) {
+        if (__atomic_load_n(&ctx.ring->session, __ATOMIC_ACQUIRE) != session) {
+            read_pos = sync_to_cluster(&ctx, &session);
+            fprintf(stderr, "[PLAY] New session %u\n", session);
+        }
+
+        ssize_t n = video_ring_read(&ctx, &read_pos, chunk, sizeof(chunk));
+        if (n < 0) {
+            fprintf(stderr, "[PLAY] Fell behind writer, resyncing at latest cluster\n");
+            read_pos = sync_to_cluster(&ctx, &session);
+            continue;
+        }
+        if (n == 0) {
+            usleep(POLL_INTERVAL_US);
+            continue;
+        }
+        if (write_all(chunk, (size_t)n) < 0) {
+            break;
+        }
+    }
+
+    video_ring_close(&ctx, false);
+    return 0;
+}
@@ -0,0 +1,57 @@
+/**
+ * Video Ring Test Program
+ * Checks that the playback ring admits one writer at a time and that a
+ * reader sees what the writer appended.
+ */
+
+#define VIDEO_RING_SHM "/manet_video_ring_test"
+
+#include <stdio.h>
+#include <string.h>
+#include "video_ring.h"
+
+static int failures = 0;
+
+#define CHECK(cond, what) do { \
+    if (cond) { \
+        printf("PASS: %s\n", what); \
+    } else { \
+        printf("FAIL: %s\n", what); \
+        failures++; \
+    } \
+} while (0)
+
+int main(void) {
+    VideoRingContext first, second, reader;
+    static const uint8_t cluster[] = { 0x1F, 0x43, 0xB6, 0x75, 0xE7, 0x81, 0x00 };
+    uint8_t out[sizeof(cluster)];
+
+    shm_unlink(VIDEO_RING_SHM);
+
+    CHECK(video_ring_open(&first, true) == 0, "first writer opens the ring");
+
+    errno = 0;
+    int rc = video_ring_open(&second, true);
+    CHECK(rc == -1 && errno == EBUSY, "second writer refused with EBUSY");
+
+    CHECK(video_ring_open(&reader, false) == 0, "reader attaches while a writer holds the ring");
+
+    video_ring_begin_session(&first);
+    video_ring_write(&first, cluster, sizeof(cluster));
+
+    VideoRingSession session;
+    video_ring_get_session(&reader, &session);
+    uint64_t read_pos = session.session_start;
+    ssize_t n = video_ring_read(&reader, &read_pos, out, sizeof(out));
+    CHECK(n == (ssize_t)sizeof(cluster) && memcmp(out, cluster, sizeof(cluster)) == 0,
+          "reader sees the writer's bytes");
+
+    video_ring_close(&reader, false);
+    video_ring_close(&first, false);
+
+    CHECK(video_ring_open(&second, true) == 0, "ring can be taken over once the writer closes");
+    video_ring_close(&second, true);
+
+    printf("%s\n", failures ? "FAILED" : "ALL TESTS PASSED");
+    return failures ? 1 : 0;
+}
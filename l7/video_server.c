@@ -10,13 +10,18 @@
 #include <stdint.h>
 #include <arpa/inet.h>
 #include <signal.h>
-#include <sys/wait.h>
+#include "webm_ingest.h"
+#include "video_ring.h"
+#include "../rrc_posix/rrc_posix_mq_defs.h"
+#include "../rrc_posix/rrc_shm_pool.h"
+#include "../rrc_posix/rrc_mq_adapters.h"
 
 #define SOCKET_PATH "/tmp/video_socket"
-#define PIPE_PATH "/tmp/video_pipe"
-#define WEBM_FILE "/tmp/video_stream.webm"
 #define BUFFER_SIZE 1048576  // 1MB buffer for video data
 
+// Video traffic rides PRIORITY_DATA_1 in the RRC queues
+#define VIDEO_RRC_PRIORITY 1
+
 // Colors for output
 #define RED     "\x1b[31m"
 #define GREEN   "\x1b[32m"
@@ -25,7 +30,32 @@
 #define RESET   "\x1b[0m"
 
 volatile int running = 1;
-FILE* webm_file = NULL;
+
+// Local playback ring (players attach with video_ring_play)
+static VideoRingContext playback_ring;
+static bool playback_ring_ready = false;
+
+// RRC feed (optional: only when rrc_core is running)
+static PoolContext app_pool;
+static MQContext mq_app_to_rrc;
+static bool rrc_feed_ready = false;
+static uint8_t video_src_id = 1;
+static uint8_t video_dest_id = 0;
+
+// Packet being assembled for RRC: consecutive bytes of one unit kind
+static struct {
+    uint8_t payload[PAYLOAD_SIZE_BYTES];
+    size_t len;
+    WebmUnitKind kind;
+    uint32_t sequence_number;
+} rrc_packet;
+
+static struct {
+    uint32_t packets_sent;
+    uint32_t keyframe_packets;
+    uint32_t delta_packets;
+    uint32_t dropped_pool_full;
+} video_stats;
 
 void print_info(const char* message) {
     printf(BLUE "[INFO]" RESET " %s\n", message);
@@ -46,62 +76,123 @@ void signal_handler(int sig) {
     if (sig == SIGINT || sig == SIGTERM) {
         print_info("Received shutdown signal");
         running = 0;
-        if (webm_file) {
-            fclose(webm_file);
-            webm_file = NULL;
+    }
+}
+
+// Hand the assembled packet to RRC through the shared app pool
+static void flush_rrc_packet(void) {
+    if (rrc_packet.len == 0) return;
+    
+    if (rrc_feed_ready) {
+        int pool_idx = app_pool_alloc(&app_pool);
+        if (pool_idx < 0) {
+            video_stats.dropped_pool_full++;
+        } else {
+            AppPacketPoolEntry* pkt = app_pool_get(&app_pool, (uint16_t)pool_idx);
+            pkt->src_id = video_src_id;
+            pkt->dest_id = video_dest_id;
+            pkt->data_type = DATA_TYPE_VIDEO;
+            pkt->transmission_type = 0;  // Unicast
+            pkt->priority = VIDEO_RRC_PRIORITY;
+            pkt->payload_len = (uint16_t)rrc_packet.len;
+            pkt->sequence_number = rrc_packet.sequence_number++;
+            pkt->timestamp_ms = get_timestamp_ms();
+            pkt->urgent = false;
+            pkt->flags = (rrc_packet.kind == WEBM_UNIT_DELTA) ?
+                         FRAME_FLAG_DISCARDABLE : FRAME_FLAG_KEYFRAME;
+            memcpy(pkt->payload, rrc_packet.payload, rrc_packet.len);
+            
+            AppToRrcMsg msg;
+            init_message_header(&msg.header, MSG_APP_TO_RRC_DATA);
+            msg.pool_index = (uint16_t)pool_idx;
+            msg.data_type = DATA_TYPE_VIDEO;
+            msg.priority = VIDEO_RRC_PRIORITY;
+            
+            if (mq_send_msg(&mq_app_to_rrc, &msg, sizeof(msg), VIDEO_RRC_PRIORITY) < 0) {
+                app_pool_release(&app_pool, (uint16_t)pool_idx);
+                video_stats.dropped_pool_full++;
+            } else {
+                video_stats.packets_sent++;
+                if (rrc_packet.kind == WEBM_UNIT_DELTA) {
+                    video_stats.delta_packets++;
+                } else {
+                    video_stats.keyframe_packets++;
+                }
+            }
         }
-        // Kill any running VLC processes
-        system("pkill -f 'vlc.*video_stream.webm'");
     }
+    
+    rrc_packet.len = 0;
 }
 
-void stop_vlc_player() {
-    print_info("Stopping any existing VLC players...");
-    // Kill VLC processes playing our video file
-    system("pkill -f 'vlc.*video_stream.webm'");
-    sleep(1); // Give time for processes to terminate
+// Called by the WebM tagger for every byte range, in stream order
+static void on_webm_unit(WebmUnitKind kind, const uint8_t* data, size_t len, void* user) {
+    WebmIngest* ingest = (WebmIngest*)user;
+    
+    if (playback_ring_ready) {
+        if (kind == WEBM_UNIT_HEADER && ingest->clusters == 0) {
+            video_ring_append_header(&playback_ring, data, len);
+        }
+        video_ring_write(&playback_ring, data, len);
+    }
+    
+    // One RRC packet never mixes unit kinds, so delta packets can be dropped alone
+    if (kind != rrc_packet.kind) {
+        flush_rrc_packet();
+        rrc_packet.kind = kind;
+    }
+    
+    while (len > 0) {
+        size_t room = PAYLOAD_SIZE_BYTES - rrc_packet.len;
+        size_t n = len < room ? len : room;
+        memcpy(rrc_packet.payload + rrc_packet.len, data, n);
+        rrc_packet.len += n;
+        data += n;
+        len -= n;
+        if (rrc_packet.len == PAYLOAD_SIZE_BYTES) {
+            flush_rrc_packet();
+        }
+    }
 }
 
-void start_vlc_player() {
-    print_info("Starting VLC player for video stream...");
+// Attach to rrc_core's app pool and queue; video still plays locally without it
+static void init_rrc_feed(void) {
+    if (video_dest_id == 0) {
+        print_info("No destination node given, RRC feed disabled");
+        return;
+    }
     
-    // Start VLC in the background to play the WebM file continuously
-    if (fork() == 0) {
-        // Child process - start VLC
-        execl("/usr/bin/vlc", "vlc", 
-              WEBM_FILE,
-              "--intf", "qt",
-              "--no-video-title-show",
-              "--file-caching=100",
-              "--network-caching=100",
-              "--live-caching=100",
-              "--input-repeat=999999",
-              "--loop",
-              (char*)NULL);
-        
-        // If execl fails, try with different path
-        execl("/bin/vlc", "vlc", 
-              WEBM_FILE,
-              "--intf", "qt",
-              "--no-video-title-show",
-              "--file-caching=100",
-              "--network-caching=100",
-              "--live-caching=100",
-              "--input-repeat=999999",
-              "--loop",
-              (char*)NULL);
-        
-        print_error("Failed to start VLC");
-        exit(1);
+    if (pool_init(&app_pool, SHM_APP_POOL, sizeof(AppPacketPoolEntry),
+                  APP_POOL_SIZE, false) < 0) {
+        print_info("RRC app pool not available, RRC feed disabled");
+        return;
+    }
+    
+    if (mq_init(&mq_app_to_rrc, MQ_APP_TO_RRC, O_WRONLY, false) < 0) {
+        print_info("RRC queue not available, RRC feed disabled");
+        pool_cleanup(&app_pool, SHM_APP_POOL, false);
+        return;
     }
+    
+    rrc_feed_ready = true;
+    printf(GREEN "[SUCCESS]" RESET " Feeding RRC: node %d -> node %d on priority %d\n",
+           video_src_id, video_dest_id, VIDEO_RRC_PRIORITY);
 }
 
-int main() {
+int main(int argc, char* argv[]) {
     int server_socket, client_socket;
     struct sockaddr_un server_addr;
-    char buffer[BUFFER_SIZE];
+    static uint8_t buffer[BUFFER_SIZE];
     uint32_t frame_length;
     ssize_t bytes_received;
+    WebmIngest ingest;
+
+    if (argc > 1) {
+        video_src_id = (uint8_t)atoi(argv[1]);
+    }
+    if (argc > 2) {
+        video_dest_id = (uint8_t)atoi(argv[2]);
+    }
 
     // Set up signal handlers
     signal(SIGINT, signal_handler);
@@ -109,8 +200,17 @@ int main() {
 
     print_info("Starting MANET Video Server...");
 
-    // Remove old WebM file if it exists
-    unlink(WEBM_FILE);
+    // Local playback reads from shared memory, not a disk file
+    if (video_ring_open(&playback_ring, true) == 0) {
+        playback_ring_ready = true;
+        print_success("Playback ring ready on " VIDEO_RING_SHM " (attach with video_ring_play)");
+    } else {
+        print_error(errno == EBUSY ?
+                    "Playback ring already has a writer, local playback disabled" :
+                    "Failed to create playback ring, local playback disabled");
+    }
+
+    init_rrc_feed();
 
     // Create Unix Domain Socket
     server_socket = socket(AF_UNIX, SOCK_STREAM, 0);
@@ -161,26 +261,13 @@ int main() {
 
         print_success("Video client connected");
         
-        // Stop any existing VLC players
-        stop_vlc_player();
-        
-        // Remove old WebM file and create fresh one
-        unlink(WEBM_FILE);
-        if (webm_file) {
-            fclose(webm_file);
+        // Each session is a fresh WebM stream with its own init segment
+        webm_ingest_init(&ingest);
+        rrc_packet.len = 0;
+        rrc_packet.kind = WEBM_UNIT_HEADER;
+        if (playback_ring_ready) {
+            video_ring_begin_session(&playback_ring);
         }
-        webm_file = fopen(WEBM_FILE, "wb");
-        if (!webm_file) {
-            print_error("Failed to create fresh WebM file");
-            perror("fopen");
-            close(client_socket);
-            continue;
-        }
-        print_success("Fresh WebM file created for new session");
-        
-        // Start VLC player for the new session
-        start_vlc_player();
-        sleep(2); // Give VLC time to start
 
         // Process video frames
         int frame_count = 0;
@@ -221,47 +308,43 @@ int main() {
                 break;
             }
 
-            printf(BLUE "[INFO]" RESET " Received video frame #%d of size %u bytes\n", 
-                   ++frame_count, frame_length);
+            ++frame_count;
 
-            // Write frame to WebM file
-            if (fwrite(buffer, 1, frame_length, webm_file) != frame_length) {
-                print_error("Failed to write to WebM file");
-                perror("fwrite");
-                break;
+            // Tag clusters / keyframes / delta frames and fan out to ring + RRC
+            uint32_t clusters_before = ingest.clusters;
+            webm_ingest_feed(&ingest, buffer, frame_length, on_webm_unit, &ingest);
+            if (playback_ring_ready && ingest.clusters != clusters_before) {
+                video_ring_mark_cluster(&playback_ring, ingest.last_cluster_pos);
             }
-            
-            // Flush to ensure data is written immediately
-            fflush(webm_file);
 
-            printf(BLUE "[INFO]" RESET " Written to %s (total frames: %d)\n", 
-                   WEBM_FILE, frame_count);
+            printf(BLUE "[INFO]" RESET " Chunk #%d: %u bytes (clusters: %u, key: %u, delta: %u)\n",
+                   frame_count, frame_length, ingest.clusters,
+                   ingest.keyframes, ingest.delta_frames);
             fflush(stdout);
         }
 
+        flush_rrc_packet();
+
         // Close client socket
         close(client_socket);
         
-        // Close WebM file but don't delete it yet (VLC might still be playing)
-        if (webm_file) {
-            fclose(webm_file);
-            webm_file = NULL;
-        }
-        
-        print_info("Client session ended");
+        printf(BLUE "[INFO]" RESET " Client session ended: RRC packets %u (key %u, delta %u), "
+               "dropped %u, parser resyncs %u\n",
+               video_stats.packets_sent, video_stats.keyframe_packets,
+               video_stats.delta_packets, video_stats.dropped_pool_full, ingest.resyncs);
     }
 
     // Cleanup
-    if (webm_file) {
-        fclose(webm_file);
-        webm_file = NULL;
-    }
     close(server_socket);
     unlink(SOCKET_PATH);
-    unlink(WEBM_FILE);
     
-    // Stop any running VLC processes
-    stop_vlc_player();
+    if (playback_ring_ready) {
+        video_ring_close(&playback_ring, true);
+    }
+    if (rrc_feed_ready) {
+        mq_cleanup(&mq_app_to_rrc, false);
+        pool_cleanup(&app_pool, SHM_APP_POOL, false);
+    }
     
     print_success("Video server shutdown complete");
 
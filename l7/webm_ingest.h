@@ -0,0 +1,318 @@
+/**
+ * Streaming WebM/Matroska Ingest Tagger for L7 Video Service
+ * Splits an arbitrary-chunked WebM byte stream into tagged units
+ *
+ * The parser walks EBML element headers only; block payloads are skipped
+ * without copying. Every byte fed in is handed back exactly once, in
+ * order, through the unit callback together with its kind:
+ *
+ *   WEBM_UNIT_HEADER   - EBML header, Segment, Info, Tracks, Cues ...
+ *   WEBM_UNIT_CLUSTER  - Cluster header and non-block cluster children
+ *   WEBM_UNIT_KEYFRAME - SimpleBlock with the keyframe flag, or BlockGroup
+ *   WEBM_UNIT_DELTA    - SimpleBlock without the keyframe flag
+ *
+ * Only DELTA units are safe to drop under congestion. BlockGroups are
+ * tagged KEYFRAME because their reference info may follow the block;
+ * browser MediaRecorder output uses SimpleBlocks exclusively.
+ */
+
+#ifndef WEBM_INGEST_H
+#define WEBM_INGEST_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+
+// ============================================================================
+// MATROSKA ELEMENT IDS (marker bits included)
+// ============================================================================
+
+#define EBML_ID_HEADER          0x1A45DFA3
+#define MKV_ID_SEGMENT          0x18538067
+#define MKV_ID_SEEKHEAD         0x114D9B74
+#define MKV_ID_INFO             0x1549A966
+#define MKV_ID_TRACKS           0x1654AE6B
+#define MKV_ID_CUES             0x1C53BB6B
+#define MKV_ID_TAGS             0x1254C367
+#define MKV_ID_CHAPTERS         0x1043A770
+#define MKV_ID_ATTACHMENTS      0x1941A469
+#define MKV_ID_CLUSTER          0x1F43B675
+#define MKV_ID_BLOCKGROUP       0xA0
+#define MKV_ID_SIMPLEBLOCK      0xA3
+
+#define MKV_SIMPLEBLOCK_KEYFRAME 0x80
+
+// Bytes held across feed calls while an element's kind is undecided:
+// ID(4) + size(8) + track vint(8) + timecode(2) + flags(1)
+#define WEBM_CARRY_MAX 32
+
+// ============================================================================
+// PARSER STATE
+// ============================================================================
+
+typedef enum {
+    WEBM_UNIT_HEADER = 0,
+    WEBM_UNIT_CLUSTER = 1,
+    WEBM_UNIT_KEYFRAME = 2,
+    WEBM_UNIT_DELTA = 3
+} WebmUnitKind;
+
+typedef enum {
+    WEBM_STATE_ID = 0,
+    WEBM_STATE_SIZE,
+    WEBM_STATE_BLOCK_TRACK,
+    WEBM_STATE_BLOCK_HEADER,
+    WEBM_STATE_BLOCK_FLAGS,
+    WEBM_STATE_SKIP
+} WebmParseState;
+
+typedef void (*webm_unit_cb)(WebmUnitKind kind, const uint8_t* data, size_t len, void* user);
+
+typedef struct {
+    WebmParseState state;
+
+    // Element header being assembled
+    uint32_t id;
+    uint8_t id_len;
+    uint8_t id_need;
+    uint64_t size;
+    uint8_t size_len;
+    uint8_t size_need;
+    bool size_unknown;
+
+    // Payload bytes left in the current leaf element
+    uint64_t skip_left;
+    uint8_t block_hdr_need;
+
+    // Output tagging
+    WebmUnitKind unit_kind;
+    bool kind_pending;
+    bool in_cluster;
+    uint8_t carry[WEBM_CARRY_MAX];
+    size_t carry_len;
+
+    // Stream position bookkeeping
+    uint64_t stream_pos;
+    uint64_t last_cluster_pos;
+
+    // Statistics
+    uint32_t clusters;
+    uint32_t keyframes;
+    uint32_t delta_frames;
+    uint32_t resyncs;
+} WebmIngest;
+
+// ============================================================================
+// INTERNAL HELPERS
+// ============================================================================
+
+// Length of an EBML vint from its first byte (0 if invalid)
+static inline uint8_t webm_vint_length(uint8_t first, uint8_t max_len) {
+    for (uint8_t len = 1; len <= max_len; len++) {
+        if (first & (0x80 >> (len - 1))) return len;
+    }
+    return 0;
+}
+
+static inline WebmUnitKind webm_kind_for_id(WebmIngest* w, uint32_t id) {
+    switch (id) {
+        case MKV_ID_CLUSTER:
+            w->in_cluster = true;
+            return WEBM_UNIT_CLUSTER;
+        case MKV_ID_BLOCKGROUP:
+            return WEBM_UNIT_KEYFRAME;
+        case EBML_ID_HEADER:
+        case MKV_ID_SEGMENT:
+        case MKV_ID_SEEKHEAD:
+        case MKV_ID_INFO:
+        case MKV_ID_TRACKS:
+        case MKV_ID_CUES:
+        case MKV_ID_TAGS:
+        case MKV_ID_CHAPTERS:
+        case MKV_ID_ATTACHMENTS:
+            w->in_cluster = false;
+            return WEBM_UNIT_HEADER;
+        default:
+            return w->in_cluster ? WEBM_UNIT_CLUSTER : WEBM_UNIT_HEADER;
+    }
+}
+
+// ============================================================================
+// PUBLIC API
+// ============================================================================
+
+static inline void webm_ingest_init(WebmIngest* w) {
+    memset(w, 0, sizeof(*w));
+    w->state = WEBM_STATE_ID;
+    w->unit_kind = WEBM_UNIT_HEADER;
+}
+
+/**
+ * Feed the next chunk of the WebM stream.
+ * Chunk boundaries may fall anywhere, including inside element headers.
+ * @param cb Receives every byte exactly once, tagged with its unit kind
+ */
+static inline void webm_ingest_feed(WebmIngest* w, const uint8_t* data, size_t len,
+                                    webm_unit_cb cb, void* user) {
+    size_t seg = 0;   // First byte of data not yet handed to cb
+
+    // Decide the kind of the element that starts at `start` (carry + data[seg..])
+#define WEBM_RESOLVE(kind_expr, end)                                     \
+    do {                                                                 \
+        WebmUnitKind k_ = (kind_expr);                                   \
+        if (w->carry_len) {                                              \
+            cb(k_, w->carry, w->carry_len, user);                        \
+            w->carry_len = 0;                                            \
+        }                                                                \
+        if ((end) > seg) cb(k_, data + seg, (end) - seg, user);          \
+        seg = (end);                                                     \
+        w->unit_kind = k_;                                               \
+        w->kind_pending = false;                                         \
+    } while (0)
+
+    for (size_t i = 0; i < len; i++) {
+        uint8_t b = data[i];
+
+        switch (w->state) {
+            case WEBM_STATE_ID:
+                if (w->id_len == 0) {
+                    // Element boundary: flush what belongs to the previous unit
+                    if (w->kind_pending) {
+                        WEBM_RESOLVE(w->unit_kind, i);
+                    } else if (i > seg) {
+                        cb(w->unit_kind, data + seg, i - seg, user);
+                        seg = i;
+                    }
+
+                    w->id_need = webm_vint_length(b, 4);
+                    if (w->id_need == 0) {
+                        // Not an element start: pass through with current tag
+                        w->resyncs++;
+                        break;
+                    }
+                    w->kind_pending = true;
+                    w->id = 0;
+                }
+                w->id = (w->id << 8) | b;
+                if (++w->id_len == w->id_need) {
+                    if (w->id == MKV_ID_CLUSTER) {
+                        w->last_cluster_pos = w->stream_pos + i + 1 - w->id_len;
+                    }
+                    w->state = WEBM_STATE_SIZE;
+                    w->size_len = 0;
+                }
+                break;
+
+            case WEBM_STATE_SIZE:
+                if (w->size_len == 0) {
+                    w->size_need = webm_vint_length(b, 8);
+                    if (w->size_need == 0) {
+                        w->resyncs++;
+                        w->id_len = 0;
+                        w->state = WEBM_STATE_ID;
+                        WEBM_RESOLVE(w->unit_kind, i + 1);
+                        break;
+                    }
+                    w->size = b & (0xFF >> w->size_need);
+                    w->size_unknown = (w->size == (uint64_t)(0xFF >> w->size_need));
+                } else {
+                    w->size = (w->size << 8) | b;
+                    if (b != 0xFF) w->size_unknown = false;
+                }
+
+                if (++w->size_len < w->size_need) break;
+
+                w->id_len = 0;
+
+                if (w->id == MKV_ID_SEGMENT || w->id == MKV_ID_CLUSTER) {
+                    // Master elements: descend, children are tagged individually
+                    if (w->id == MKV_ID_CLUSTER) w->clusters++;
+                    WEBM_RESOLVE(webm_kind_for_id(w, w->id), i + 1);
+                    w->state = WEBM_STATE_ID;
+                } else if (w->id == MKV_ID_SIMPLEBLOCK && !w->size_unknown && w->size >= 4) {
+                    // Kind decided by the flags byte
+                    w->skip_left = w->size;
+                    w->state = WEBM_STATE_BLOCK_TRACK;
+                } else if (w->size_unknown) {
+                    // Unknown-size leaf: cannot skip it, resynchronise on next ID
+                    w->resyncs++;
+                    WEBM_RESOLVE(webm_kind_for_id(w, w->id), i + 1);
+                    w->state = WEBM_STATE_ID;
+                } else {
+                    WEBM_RESOLVE(webm_kind_for_id(w, w->id), i + 1);
+                    w->skip_left = w->size;
+                    w->state = w->size ? WEBM_STATE_SKIP : WEBM_STATE_ID;
+                }
+                break;
+
+            case WEBM_STATE_BLOCK_TRACK:
+                w->block_hdr_need = webm_vint_length(b, 8);
+                if (w->block_hdr_need == 0) w->block_hdr_need = 1;
+                // Remaining track bytes plus 2-byte relative timecode
+                w->block_hdr_need = (uint8_t)(w->block_hdr_need - 1 + 2);
+                w->skip_left--;
+                w->state = WEBM_STATE_BLOCK_HEADER;
+                break;
+
+            case WEBM_STATE_BLOCK_HEADER:
+                w->skip_left--;
+                if (--w->block_hdr_need == 0) w->state = WEBM_STATE_BLOCK_FLAGS;
+                if (w->skip_left == 0) {
+                    WEBM_RESOLVE(WEBM_UNIT_DELTA, i + 1);
+                    w->state = WEBM_STATE_ID;
+                }
+                break;
+
+            case WEBM_STATE_BLOCK_FLAGS:
+                w->skip_left--;
+                if (b & MKV_SIMPLEBLOCK_KEYFRAME) {
+                    w->keyframes++;
+                    WEBM_RESOLVE(WEBM_UNIT_KEYFRAME, i + 1);
+                } else {
+                    w->delta_frames++;
+                    WEBM_RESOLVE(WEBM_UNIT_DELTA, i + 1);
+                }
+                w->state = w->skip_left ? WEBM_STATE_SKIP : WEBM_STATE_ID;
+                break;
+
+            case WEBM_STATE_SKIP: {
+                size_t n = len - i;
+                if (n > w->skip_left) n = (size_t)w->skip_left;
+                w->skip_left -= n;
+                i += n - 1;
+                if (w->skip_left == 0) w->state = WEBM_STATE_ID;
+                break;
+            }
+        }
+    }
+
+    if (w->kind_pending) {
+        // Hold the undecided element header until its kind is known
+        if (w->carry_len + (len - seg) <= WEBM_CARRY_MAX) {
+            memcpy(w->carry + w->carry_len, data + seg, len - seg);
+            w->carry_len += len - seg;
+        } else {
+            w->resyncs++;
+            WEBM_RESOLVE(w->unit_kind, len);
+        }
+    } else if (len > seg) {
+        cb(w->unit_kind, data + seg, len - seg, user);
+    }
+
+    w->stream_pos += len;
+
+#undef WEBM_RESOLVE
+}
+
+static inline const char* webm_unit_kind_to_string(WebmUnitKind kind) {
+    switch (kind) {
+        case WEBM_UNIT_HEADER:   return "HEADER";
+        case WEBM_UNIT_CLUSTER:  return "CLUSTER";
+        case WEBM_UNIT_KEYFRAME: return "KEYFRAME";
+        case WEBM_UNIT_DELTA:    return "DELTA";
+        default:                 return "UNKNOWN";
+    }
+}
+
+#endif // WEBM_INGEST_H
@@ -0,0 +1,109 @@
+/**
+ * WebM Ingest Tagger Test Program
+ * Feeds a small hand-built WebM stream through webm_ingest_feed() whole
+ * and one byte at a time, and checks that every byte comes back once,
+ * in order, with the expected unit kind.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "webm_ingest.h"
+
+static int failures = 0;
+
+#define CHECK(cond, what) do { \
+    if (cond) { \
+        printf("PASS: %s\n", what); \
+    } else { \
+        printf("FAIL: %s\n", what); \
+        failures++; \
+    } \
+} while (0)
+
+#define H WEBM_UNIT_HEADER
+#define C WEBM_UNIT_CLUSTER
+#define K WEBM_UNIT_KEYFRAME
+#define D WEBM_UNIT_DELTA
+
+static const uint8_t stream[] = {
+    0x1A, 0x45, 0xDF, 0xA3, 0x84, 0x42, 0x86, 0x81, 0x01,         // EBML header
+    0x18, 0x53, 0x80, 0x67, 0x01, 0xFF, 0xFF, 0xFF,               // Segment, unknown size
+    0xFF, 0xFF, 0xFF, 0xFF,
+    0x15, 0x49, 0xA9, 0x66, 0x83, 0x2A, 0xD7, 0xB1,               // Info
+    0x1F, 0x43, 0xB6, 0x75, 0x01, 0xFF, 0xFF, 0xFF,               // Cluster, unknown size
+    0xFF, 0xFF, 0xFF, 0xFF,
+    0xE7, 0x81, 0x00,                                             // Timecode
+    0xA3, 0x88, 0x81, 0x00, 0x00, 0x80, 0x11, 0x22, 0x33, 0x44,   // SimpleBlock, keyframe
+    0xA3, 0x88, 0x81, 0x00, 0x21, 0x00, 0x55, 0x66, 0x77, 0x88,   // SimpleBlock, delta
+    0xA0, 0x83, 0xFB, 0x81, 0x00,                                 // BlockGroup
+};
+
+static const uint8_t expected[] = {
+    H, H, H, H, H, H, H, H, H,
+    H, H, H, H, H, H, H, H, H, H, H, H,
+    H, H, H, H, H, H, H, H,
+    C, C, C, C, C, C, C, C, C, C, C, C,
+    C, C, C,
+    K, K, K, K, K, K, K, K, K, K,
+    D, D, D, D, D, D, D, D, D, D,
+    K, K, K, K, K,
+};
+
+_Static_assert(sizeof(stream) == sizeof(expected), "one tag per stream byte");
+
+typedef struct {
+    uint8_t bytes[sizeof(stream)];
+    uint8_t kinds[sizeof(stream)];
+    size_t len;
+    bool overflow;
+} Capture;
+
+static void capture_unit(WebmUnitKind kind, const uint8_t* data, size_t len, void* user) {
+    Capture* cap = (Capture*)user;
+    if (cap->len + len > sizeof(cap->bytes)) {
+        cap->overflow = true;
+        return;
+    }
+    memcpy(cap->bytes + cap->len, data, len);
+    memset(cap->kinds + cap->len, (int)kind, len);
+    cap->len += len;
+}
+
+static void run(const char* name, size_t chunk) {
+    WebmIngest ingest;
+    Capture cap;
+    char what[96];
+
+    webm_ingest_init(&ingest);
+    memset(&cap, 0, sizeof(cap));
+    for (size_t off = 0; off < sizeof(stream); off += chunk) {
+        size_t n = sizeof(stream) - off < chunk ? sizeof(stream) - off : chunk;
+        webm_ingest_feed(&ingest, stream + off, n, capture_unit, &cap);
+    }
+
+    snprintf(what, sizeof(what), "%s: every byte handed back once, in order", name);
+    CHECK(!cap.overflow && cap.len == sizeof(stream) && memcmp(cap.bytes, stream, sizeof(stream)) == 0, what);
+
+    size_t bad = 0;
+    while (bad < cap.len && cap.kinds[bad] == expected[bad]) bad++;
+    snprintf(what, sizeof(what), "%s: units tagged HEADER/CLUSTER/KEYFRAME/DELTA", name);
+    CHECK(bad == sizeof(stream), what);
+    if (bad < cap.len) {
+        printf("      byte %zu tagged %s, expected %s\n", bad,
+               webm_unit_kind_to_string((WebmUnitKind)cap.kinds[bad]),
+               webm_unit_kind_to_string((WebmUnitKind)expected[bad]));
+    }
+
+    snprintf(what, sizeof(what), "%s: 1 cluster at offset 29, 1 keyframe, 1 delta", name);
+    CHECK(ingest.clusters == 1 && ingest.last_cluster_pos == 29 &&
+          ingest.keyframes == 1 && ingest.delta_frames == 1 && ingest.resyncs == 0, what);
+}
+
+int main(void) {
+    run("whole stream", sizeof(stream));
+    run("byte by byte", 1);
+    run("3-byte chunks", 3);
+
+    printf("%s\n", failures ? "FAILED" : "ALL TESTS PASSED");
+    return failures ? 1 : 0;
+}
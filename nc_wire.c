@@ -0,0 +1,511 @@
+// NC slot wire codec, see nc_wire.h for the format
+
+#include <stdio.h>
+#include <string.h>
+
+#include "nc_wire.h"
+
+// Sender-side delta reference (our last key frame)
+static struct {
+    bool valid;
+    uint8_t key_id;
+    uint8_t since_key;
+    uint64_t nc_map;
+    uint64_t dugu_map;
+} nc_wire_tx_key = {0};
+
+// Receiver-side delta reference, per source node
+static struct {
+    bool valid;
+    uint8_t key_id;
+    uint64_t nc_map;
+    uint64_t dugu_map;
+} nc_wire_rx_key[NC_WIRE_MAX_SOURCES];
+
+static struct {
+    uint32_t messages_encoded;
+    uint32_t bytes_encoded;
+    uint32_t struct_bytes_replaced; // sizeof() of what the encoded sections used to cost
+    uint32_t key_frames;
+    uint32_t delta_frames;
+    uint32_t sections_dropped;
+    uint32_t messages_decoded;
+    uint32_t decode_errors;
+    uint32_t version_mismatches;
+    uint32_t delta_base_misses;
+} nc_wire_stats = {0};
+
+typedef struct {
+    uint8_t *buf;
+    size_t len;
+    size_t pos;
+    bool overflow;
+} NCWireWriter;
+
+typedef struct {
+    const uint8_t *buf;
+    size_t len;
+    size_t pos;
+    bool error;
+} NCWireReader;
+
+static void ncw_put_u8(NCWireWriter *w, uint8_t v) {
+    if (w->pos >= w->len) {
+        w->overflow = true;
+        return;
+    }
+    w->buf[w->pos++] = v;
+}
+
+// Big-endian, low `bytes` bytes of v
+static void ncw_put_be(NCWireWriter *w, uint64_t v, int bytes) {
+    for (int i = bytes - 1; i >= 0; i--)
+        ncw_put_u8(w, (uint8_t)(v >> (8 * i)));
+}
+
+static void ncw_put_varint(NCWireWriter *w, uint32_t v) {
+    while (v >= 0x80) {
+        ncw_put_u8(w, (uint8_t)(v | 0x80));
+        v >>= 7;
+    }
+    ncw_put_u8(w, (uint8_t)v);
+}
+
+static void ncw_put_bytes(NCWireWriter *w, const uint8_t *data, size_t n) {
+    if (n > w->len - w->pos) {
+        w->overflow = true;
+        return;
+    }
+    memcpy(w->buf + w->pos, data, n);
+    w->pos += n;
+}
+
+static uint8_t ncr_get_u8(NCWireReader *r) {
+    if (r->pos >= r->len) {
+        r->error = true;
+        return 0;
+    }
+    return r->buf[r->pos++];
+}
+
+static uint64_t ncr_get_be(NCWireReader *r, int bytes) {
+    uint64_t v = 0;
+    for (int i = 0; i < bytes; i++)
+        v = (v << 8) | ncr_get_u8(r);
+    return v;
+}
+
+static uint32_t ncr_get_varint(NCWireReader *r) {
+    uint32_t v = 0;
+    for (int shift = 0; shift < 32; shift += 7) {
+        uint8_t b = ncr_get_u8(r);
+        v |= (uint32_t)(b & 0x7F) << shift;
+        if (!(b & 0x80))
+            return v;
+    }
+    r->error = true; // Longer than 5 bytes
+    return 0;
+}
+
+// Section length is written after the body is known; one byte is reserved and
+// the body is shifted if the length needs a second varint byte
+static size_t ncw_begin_section(NCWireWriter *w, uint8_t type) {
+    ncw_put_u8(w, type);
+    size_t len_pos = w->pos;
+    ncw_put_u8(w, 0);
+    return len_pos;
+}
+
+static void ncw_end_section(NCWireWriter *w, size_t len_pos) {
+    if (w->overflow)
+        return;
+
+    size_t body_len = w->pos - len_pos - 1;
+    if (body_len < 0x80) {
+        w->buf[len_pos] = (uint8_t)body_len;
+        return;
+    }
+    if (body_len >= 0x4000 || w->pos >= w->len) {
+        w->overflow = true;
+        return;
+    }
+    memmove(w->buf + len_pos + 2, w->buf + len_pos + 1, body_len);
+    w->buf[len_pos] = (uint8_t)(body_len | 0x80);
+    w->buf[len_pos + 1] = (uint8_t)(body_len >> 7);
+    w->pos++;
+}
+
+static int nc_wire_popcount64(uint64_t v) {
+    int n = 0;
+    while (v) {
+        v &= v - 1;
+        n++;
+    }
+    return n;
+}
+
+// Choose SAME / FLIPS / RAW for one bitmap against the key frame
+static uint8_t nc_wire_map_mode(uint64_t diff, int raw_bytes) {
+    if (diff == 0)
+        return NC_WIRE_MAP_SAME;
+    return (1 + nc_wire_popcount64(diff) < raw_bytes) ? NC_WIRE_MAP_FLIPS : NC_WIRE_MAP_RAW;
+}
+
+static void ncw_put_map(NCWireWriter *w, uint8_t mode, uint64_t map, uint64_t diff, int raw_bytes) {
+    if (mode == NC_WIRE_MAP_RAW) {
+        ncw_put_be(w, map, raw_bytes);
+    } else if (mode == NC_WIRE_MAP_FLIPS) {
+        ncw_put_u8(w, (uint8_t)nc_wire_popcount64(diff));
+        for (uint8_t bit = 0; bit < 64; bit++) {
+            if (diff & (1ULL << bit))
+                ncw_put_u8(w, bit);
+        }
+    }
+}
+
+static uint64_t ncr_get_map(NCWireReader *r, uint8_t mode, uint64_t key_map, int raw_bytes) {
+    if (mode == NC_WIRE_MAP_RAW)
+        return ncr_get_be(r, raw_bytes);
+
+    if (mode == NC_WIRE_MAP_FLIPS) {
+        uint8_t count = ncr_get_u8(r);
+        for (uint8_t i = 0; i < count; i++) {
+            uint8_t bit = ncr_get_u8(r);
+            if (bit >= 64) {
+                r->error = true;
+                break;
+            }
+            key_map ^= 1ULL << bit;
+        }
+    }
+    return key_map;
+}
+
+// Piggyback body; delta-encodes the bitmaps when own (tlv is the sender's TLV)
+static bool nc_wire_put_piggyback(NCWireWriter *w, const PiggybackTLV *tlv, bool own, NCWireBudget *budget) {
+    ncw_put_varint(w, tlv->sourceNodeID);
+    ncw_put_u8(w, tlv->sourceReservations);
+    ncw_put_u8(w, tlv->relayReservations);
+    ncw_put_u8(w, tlv->myNCSlot);
+    ncw_put_u8(w, tlv->ttl);
+    ncw_put_be(w, tlv->timeSync, 4);
+
+    bool key = own && (!nc_wire_tx_key.valid || nc_wire_tx_key.since_key >= NC_WIRE_KEYFRAME_INTERVAL);
+
+    uint8_t nc_mode = NC_WIRE_MAP_RAW;
+    uint8_t dugu_mode = NC_WIRE_MAP_RAW;
+    uint64_t nc_diff = 0, dugu_diff = 0;
+    if (own && !key) {
+        nc_diff = tlv->ncStatusBitmap ^ nc_wire_tx_key.nc_map;
+        dugu_diff = tlv->duGuIntentionMap ^ nc_wire_tx_key.dugu_map;
+        nc_mode = nc_wire_map_mode(nc_diff, NC_WIRE_NC_MAP_BYTES);
+        dugu_mode = nc_wire_map_mode(dugu_diff, NC_WIRE_DUGU_MAP_BYTES);
+    }
+
+    uint8_t key_id = key ? (uint8_t)(nc_wire_tx_key.key_id + 1) : nc_wire_tx_key.key_id;
+    ncw_put_u8(w, (uint8_t)(nc_mode | (dugu_mode << 2) | (key ? NC_WIRE_MAP_KEY : 0)));
+    ncw_put_u8(w, key_id);
+    ncw_put_map(w, nc_mode, tlv->ncStatusBitmap, nc_diff, NC_WIRE_NC_MAP_BYTES);
+    ncw_put_map(w, dugu_mode, tlv->duGuIntentionMap, dugu_diff, NC_WIRE_DUGU_MAP_BYTES);
+
+    if (w->overflow || !own)
+        return false;
+
+    // Recorded only; the reference moves when the frame is actually sent
+    budget->tx_key_pending = true;
+    budget->tx_key_frame = key;
+    budget->tx_key_id = key_id;
+    budget->tx_nc_map = tlv->ncStatusBitmap;
+    budget->tx_dugu_map = tlv->duGuIntentionMap;
+    return !key && (nc_mode != NC_WIRE_MAP_RAW || dugu_mode != NC_WIRE_MAP_RAW);
+}
+
+static bool nc_wire_get_piggyback(NCWireReader *r, PiggybackTLV *tlv) {
+    memset(tlv, 0, sizeof(*tlv));
+    tlv->type = NC_WIRE_SECTION_PIGGYBACK;
+    tlv->length = sizeof(PiggybackTLV) - 2;
+
+    uint32_t source = ncr_get_varint(r);
+    tlv->sourceReservations = ncr_get_u8(r);
+    tlv->relayReservations = ncr_get_u8(r);
+    tlv->myNCSlot = ncr_get_u8(r);
+    tlv->ttl = ncr_get_u8(r);
+    tlv->timeSync = (uint32_t)ncr_get_be(r, 4);
+    uint8_t modes = ncr_get_u8(r);
+    uint8_t key_id = ncr_get_u8(r);
+    if (r->error || source >= NC_WIRE_MAX_SOURCES)
+        return false;
+    tlv->sourceNodeID = (uint16_t)source;
+
+    uint8_t nc_mode = modes & 0x03;
+    uint8_t dugu_mode = (modes >> 2) & 0x03;
+    bool key = (modes & NC_WIRE_MAP_KEY) != 0;
+
+    bool needs_base = (nc_mode != NC_WIRE_MAP_RAW || dugu_mode != NC_WIRE_MAP_RAW);
+    if (needs_base && (!nc_wire_rx_key[source].valid || nc_wire_rx_key[source].key_id != key_id)) {
+        nc_wire_stats.delta_base_misses++;
+        return false;
+    }
+
+    tlv->ncStatusBitmap = ncr_get_map(r, nc_mode, nc_wire_rx_key[source].nc_map, NC_WIRE_NC_MAP_BYTES);
+    tlv->duGuIntentionMap = ncr_get_map(r, dugu_mode, nc_wire_rx_key[source].dugu_map, NC_WIRE_DUGU_MAP_BYTES);
+    if (r->error)
+        return false;
+
+    if (key) {
+        nc_wire_rx_key[source].valid = true;
+        nc_wire_rx_key[source].key_id = key_id;
+        nc_wire_rx_key[source].nc_map = tlv->ncStatusBitmap;
+        nc_wire_rx_key[source].dugu_map = tlv->duGuIntentionMap;
+    }
+    return true;
+}
+
+// Slot lists are sent up to the last non-zero entry
+static void ncw_put_slot_list(NCWireWriter *w, const uint8_t *slots, int count) {
+    while (count > 0 && slots[count - 1] == 0)
+        count--;
+    ncw_put_u8(w, (uint8_t)count);
+    ncw_put_bytes(w, slots, (size_t)count);
+}
+
+static void ncr_get_slot_list(NCWireReader *r, uint8_t *slots, int max) {
+    uint8_t count = ncr_get_u8(r);
+    if (count > max || count > r->len - r->pos) {
+        r->error = true;
+        return;
+    }
+    memcpy(slots, r->buf + r->pos, count);
+    r->pos += count;
+}
+
+// PHY metrics go out as fixed point: RSSI/SNR in 0.1 dB, PER in 0.01 %
+static void nc_wire_put_neighbor(NCWireWriter *w, const NeighborState *n) {
+    ncw_put_varint(w, n->nodeID);
+    ncw_put_u8(w, n->assignedNCSlot);
+    ncw_put_u8(w, n->capabilities);
+    ncw_put_slot_list(w, n->txSlots, (int)sizeof(n->txSlots));
+    ncw_put_slot_list(w, n->rxSlots, (int)sizeof(n->rxSlots));
+    ncw_put_be(w, (uint16_t)(int16_t)(n->phy.rssi_dbm * 10.0f), 2);
+    ncw_put_be(w, (uint16_t)(int16_t)(n->phy.snr_db * 10.0f), 2);
+    ncw_put_be(w, (uint16_t)(n->phy.per_percent * 100.0f), 2);
+    ncw_put_varint(w, n->phy.packet_count);
+}
+
+static void nc_wire_get_neighbor(NCWireReader *r, NeighborState *n) {
+    memset(n, 0, sizeof(*n));
+    n->nodeID = (uint16_t)ncr_get_varint(r);
+    n->assignedNCSlot = ncr_get_u8(r);
+    n->capabilities = ncr_get_u8(r);
+    ncr_get_slot_list(r, n->txSlots, (int)sizeof(n->txSlots));
+    ncr_get_slot_list(r, n->rxSlots, (int)sizeof(n->rxSlots));
+    n->phy.rssi_dbm = (int16_t)ncr_get_be(r, 2) / 10.0f;
+    n->phy.snr_db = (int16_t)ncr_get_be(r, 2) / 10.0f;
+    n->phy.per_percent = (uint16_t)ncr_get_be(r, 2) / 100.0f;
+    n->phy.packet_count = ncr_get_varint(r);
+    n->active = true;
+}
+
+static void nc_wire_put_olsr(NCWireWriter *w, const OLSRMessage *m) {
+    size_t payload_len = m->payload_len > sizeof(m->payload) ? sizeof(m->payload) : m->payload_len;
+
+    ncw_put_u8(w, m->msg_type);
+    ncw_put_u8(w, m->vtime);
+    ncw_put_u8(w, m->ttl);
+    ncw_put_u8(w, m->hop_count);
+    ncw_put_be(w, m->msg_seq_num, 2);
+    ncw_put_varint(w, m->originator_addr);
+    ncw_put_bytes(w, m->payload, payload_len); // Runs to the end of the section
+}
+
+static void nc_wire_get_olsr(NCWireReader *r, size_t section_end, OLSRMessage *m) {
+    memset(m, 0, sizeof(*m));
+    m->msg_type = ncr_get_u8(r);
+    m->vtime = ncr_get_u8(r);
+    m->ttl = ncr_get_u8(r);
+    m->hop_count = ncr_get_u8(r);
+    m->msg_seq_num = (uint16_t)ncr_get_be(r, 2);
+    m->originator_addr = ncr_get_varint(r);
+    if (r->error || r->pos > section_end || section_end - r->pos > sizeof(m->payload)) {
+        r->error = true;
+        return;
+    }
+    m->payload_len = section_end - r->pos;
+    m->msg_size = (uint16_t)m->payload_len;
+    memcpy(m->payload, r->buf + r->pos, m->payload_len);
+    r->pos = section_end;
+}
+
+// Serialize msg into at most max_len bytes; returns bytes used (0 on failure).
+// Sections that do not fit are dropped and reported in budget.
+size_t nc_slot_message_encode(const NCSlotMessage *msg, uint8_t *buf, size_t max_len, NCWireBudget *budget) {
+    NCWireBudget local;
+    if (!budget)
+        budget = &local;
+    memset(budget, 0, sizeof(*budget));
+
+    if (!msg || !buf)
+        return 0;
+
+    NCWireWriter w = {buf, max_len, 0, false};
+    bool truncated = false;
+
+    ncw_put_u8(&w, NC_WIRE_VERSION << 4);
+    ncw_put_be(&w, msg->sourceNodeID, 2);
+    ncw_put_u8(&w, msg->myAssignedNCSlot);
+    ncw_put_be(&w, msg->timestamp, 4);
+    ncw_put_varint(&w, msg->sequence_number);
+    if (w.overflow)
+        return 0;
+    budget->header_bytes = (uint16_t)w.pos;
+
+    for (uint8_t type = NC_WIRE_SECTION_PIGGYBACK; type <= NC_WIRE_SECTION_OLSR; type++) {
+        bool present = (type == NC_WIRE_SECTION_PIGGYBACK && msg->has_piggyback) ||
+                       (type == NC_WIRE_SECTION_NEIGHBOR && msg->has_neighbor_info) ||
+                       (type == NC_WIRE_SECTION_OLSR && msg->has_olsr_message);
+        if (!present)
+            continue;
+
+        size_t start = w.pos;
+        size_t len_pos = ncw_begin_section(&w, type);
+        bool delta = false;
+        if (type == NC_WIRE_SECTION_PIGGYBACK)
+            delta = nc_wire_put_piggyback(&w, &msg->piggyback_tlv,
+                                          msg->piggyback_tlv.sourceNodeID == msg->sourceNodeID, budget);
+        else if (type == NC_WIRE_SECTION_NEIGHBOR)
+            nc_wire_put_neighbor(&w, &msg->my_neighbor_info);
+        else
+            nc_wire_put_olsr(&w, &msg->olsr_message);
+        ncw_end_section(&w, len_pos);
+
+        if (w.overflow) {
+            w.pos = start;
+            w.overflow = false;
+            truncated = true;
+            budget->sections_dropped |= (uint8_t)(1u << type);
+            if (type == NC_WIRE_SECTION_PIGGYBACK)
+                budget->tx_key_pending = false;
+            continue;
+        }
+
+        uint16_t used = (uint16_t)(w.pos - start);
+        if (type == NC_WIRE_SECTION_PIGGYBACK) {
+            budget->piggyback_bytes = used;
+            budget->piggyback_delta = delta;
+            budget->struct_bytes += sizeof(PiggybackTLV);
+        } else if (type == NC_WIRE_SECTION_NEIGHBOR) {
+            budget->neighbor_bytes = used;
+            budget->struct_bytes += sizeof(NeighborState);
+        } else {
+            budget->olsr_bytes = used;
+            budget->struct_bytes += sizeof(OLSRMessage);
+        }
+    }
+
+    if (truncated)
+        buf[0] |= NC_WIRE_FLAG_TRUNCATED;
+
+    budget->total_bytes = (uint16_t)w.pos;
+    return w.pos;
+}
+
+// A frame encoded with budget went out: count it and adopt its delta reference
+void nc_wire_commit_tx(const NCWireBudget *budget) {
+    if (!budget)
+        return;
+
+    nc_wire_stats.messages_encoded++;
+    nc_wire_stats.bytes_encoded += budget->total_bytes;
+    nc_wire_stats.struct_bytes_replaced += budget->struct_bytes;
+    for (uint8_t type = NC_WIRE_SECTION_PIGGYBACK; type <= NC_WIRE_SECTION_OLSR; type++) {
+        if (budget->sections_dropped & (1u << type))
+            nc_wire_stats.sections_dropped++;
+    }
+
+    if (!budget->tx_key_pending)
+        return;
+
+    if (budget->tx_key_frame) {
+        nc_wire_tx_key.valid = true;
+        nc_wire_tx_key.key_id = budget->tx_key_id;
+        nc_wire_tx_key.since_key = 0;
+        nc_wire_tx_key.nc_map = budget->tx_nc_map;
+        nc_wire_tx_key.dugu_map = budget->tx_dugu_map;
+        nc_wire_stats.key_frames++;
+    } else {
+        nc_wire_tx_key.since_key++;
+        nc_wire_stats.delta_frames++;
+    }
+}
+
+// Parse an encoded NC slot message. Unknown section types are skipped so that
+// newer senders stay readable; a piggyback whose delta reference was missed
+// is dropped (has_piggyback = false) without failing the rest of the message.
+bool nc_slot_message_decode(const uint8_t *buf, size_t len, NCSlotMessage *msg) {
+    if (!buf || !msg)
+        return false;
+
+    NCWireReader r = {buf, len, 0, false};
+    memset(msg, 0, sizeof(*msg));
+
+    uint8_t version = ncr_get_u8(&r);
+    if (!r.error && (version >> 4) != NC_WIRE_VERSION) {
+        nc_wire_stats.version_mismatches++;
+        return false;
+    }
+
+    msg->sourceNodeID = (uint16_t)ncr_get_be(&r, 2);
+    msg->myAssignedNCSlot = ncr_get_u8(&r);
+    msg->timestamp = (uint32_t)ncr_get_be(&r, 4);
+    msg->sequence_number = ncr_get_varint(&r);
+
+    while (!r.error && r.pos < r.len) {
+        uint8_t type = ncr_get_u8(&r);
+        uint32_t section_len = ncr_get_varint(&r);
+        if (r.error || section_len > r.len - r.pos) {
+            r.error = true;
+            break;
+        }
+
+        size_t section_end = r.pos + section_len;
+        NCWireReader section = {buf, section_end, r.pos, false};
+
+        if (type == NC_WIRE_SECTION_PIGGYBACK) {
+            msg->has_piggyback = nc_wire_get_piggyback(&section, &msg->piggyback_tlv);
+        } else if (type == NC_WIRE_SECTION_NEIGHBOR) {
+            nc_wire_get_neighbor(&section, &msg->my_neighbor_info);
+            msg->has_neighbor_info = !section.error;
+        } else if (type == NC_WIRE_SECTION_OLSR) {
+            nc_wire_get_olsr(&section, section_end, &msg->olsr_message);
+            msg->has_olsr_message = !section.error;
+        }
+        r.pos = section_end;
+    }
+
+    if (r.error) {
+        nc_wire_stats.decode_errors++;
+        return false;
+    }
+
+    msg->is_valid = true;
+    nc_wire_stats.messages_decoded++;
+    return true;
+}
+
+void print_nc_wire_stats(void) {
+    printf("\n=== NC Wire Codec Statistics ===\n");
+    printf("Messages encoded: %u (%u bytes, %u bytes as structs)\n",
+           nc_wire_stats.messages_encoded, nc_wire_stats.bytes_encoded,
+           nc_wire_stats.struct_bytes_replaced);
+    if (nc_wire_stats.messages_encoded > 0) {
+        printf("Average NC slot budget: %u bytes\n",
+               nc_wire_stats.bytes_encoded / nc_wire_stats.messages_encoded);
+    }
+    printf("Piggyback key frames: %u, delta frames: %u\n",
+           nc_wire_stats.key_frames, nc_wire_stats.delta_frames);
+    printf("Sections dropped (slot full): %u\n", nc_wire_stats.sections_dropped);
+    printf("Messages decoded: %u, errors: %u, version mismatches: %u, delta base misses: %u\n",
+           nc_wire_stats.messages_decoded, nc_wire_stats.decode_errors,
+           nc_wire_stats.version_mismatches, nc_wire_stats.delta_base_misses);
+    printf("================================\n\n");
+}
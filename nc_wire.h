@@ -0,0 +1,138 @@
+// ============================================================================
+// NC SLOT MESSAGE AND WIRE FORMAT
+// ============================================================================
+//
+// NCSlotMessage and PiggybackTLV are host-layout structs used on the local
+// queues. Over the air they are serialized by nc_slot_message_encode():
+// packed, big-endian and versioned, so that only the sections actually
+// present take up NC slot bytes.
+//
+//   header  : version<<4|flags(1) sourceNodeID(2) myAssignedNCSlot(1)
+//             timestamp(4) sequence_number(varint)
+//   section : type(1) length(varint) body
+//
+// Sections are written in the order piggyback, neighbor, OLSR. If a section
+// does not fit in the slot it is left out, and the header gets
+// NC_WIRE_FLAG_TRUNCATED.
+//
+// In the piggyback body, ncStatusBitmap and duGuIntentionMap are sent either
+// raw or as the bit positions that flipped since the sender's last key
+// frame. Only the message's own piggyback (sourceNodeID of the TLV equal to
+// that of the message) is delta-encoded. A key frame is forced every
+// NC_WIRE_KEYFRAME_INTERVAL piggybacks, so a receiver that missed one
+// resynchronises within a few supercycles.
+//
+// Encoding has no side effects. The sender's key reference and the wire
+// statistics only move in nc_wire_commit_tx(), once the frame has been sent.
+//
+// Shared by rccv2.c and rrc_integrated.c; link nc_wire.c with either.
+
+#ifndef NC_WIRE_H
+#define NC_WIRE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+typedef struct {
+    float rssi_dbm;
+    float snr_db;
+    float per_percent;
+    uint32_t packet_count;      // Total packets received from neighbor
+    uint32_t last_update_time;
+} PHYMetrics;
+
+typedef struct {
+    uint16_t nodeID;
+    uint64_t lastHeardTime;
+    uint8_t txSlots[10];        // Which slots neighbor will transmit
+    uint8_t rxSlots[10];        // Which slots neighbor expects to receive
+    PHYMetrics phy;
+    uint8_t capabilities;       // TX/RX capabilities bitmask
+    bool active;                // Is this neighbor currently active
+    uint8_t assignedNCSlot;     // NC slot assigned to this neighbor
+} NeighborState;
+
+typedef struct {
+    uint8_t type;               // TLV type identifier
+    uint8_t length;             // TLV length
+    uint16_t sourceNodeID;      // Source node ID
+    uint8_t sourceReservations; // Source reservations (voice/data)
+    uint8_t relayReservations;  // Relay reservations (voice/data)
+    uint64_t duGuIntentionMap;  // 60-bit DU/GU slot intention
+    uint64_t ncStatusBitmap;    // 40-bit NC slot status
+    uint32_t timeSync;          // Time synchronization info
+    uint8_t myNCSlot;           // My assigned NC slot
+    uint8_t ttl;                // Time-to-live for soft state
+} PiggybackTLV;
+
+// OLSR Message Structure for NC transmission
+typedef struct {
+    uint8_t msg_type;           // 1=HELLO, 2=TC
+    uint8_t vtime;              // Validity time
+    uint16_t msg_size;          // Message size
+    uint32_t originator_addr;   // Originating node
+    uint8_t ttl;                // Time to live
+    uint8_t hop_count;          // Hop count
+    uint16_t msg_seq_num;       // Sequence number
+    uint8_t payload[2048];      // OLSR message payload
+    size_t payload_len;         // Actual payload length
+} OLSRMessage;
+
+// NC Slot Message - Complete message for TDMA transmission
+typedef struct {
+    uint8_t myAssignedNCSlot;        // My assigned NC slot (1-40)
+    OLSRMessage olsr_message;        // OLSR HELLO/TC to transmit
+    bool has_olsr_message;           // Flag: OLSR message present
+    PiggybackTLV piggyback_tlv;      // Piggyback information
+    bool has_piggyback;              // Flag: Piggyback present
+    NeighborState my_neighbor_info;  // My neighbor state information
+    bool has_neighbor_info;          // Flag: Neighbor info present
+    uint32_t timestamp;              // Message creation timestamp
+    uint16_t sourceNodeID;           // Source node ID
+    uint32_t sequence_number;        // Message sequence number
+    bool is_valid;                   // Message validity flag
+} NCSlotMessage;
+
+#define NC_WIRE_VERSION 1
+#define NC_WIRE_FLAG_TRUNCATED 0x01
+
+#define NC_WIRE_SECTION_PIGGYBACK 0x01 // Same type byte as the legacy piggyback TLV
+#define NC_WIRE_SECTION_NEIGHBOR 0x02
+#define NC_WIRE_SECTION_OLSR 0x03
+
+#define NC_WIRE_MAP_SAME 0  // Unchanged since the key frame
+#define NC_WIRE_MAP_FLIPS 1 // count(1) + flipped bit positions(1 each)
+#define NC_WIRE_MAP_RAW 2   // Full bitmap
+#define NC_WIRE_MAP_KEY 0x10 // Raw maps that become the new delta reference
+
+#define NC_WIRE_NC_MAP_BYTES 5   // 40 NC slots
+#define NC_WIRE_DUGU_MAP_BYTES 8 // 60 DU/GU slots
+#define NC_WIRE_KEYFRAME_INTERVAL 8
+#define NC_WIRE_MAX_SOURCES 256
+
+// Byte budget of one encoded NC slot message
+typedef struct {
+    uint16_t header_bytes;
+    uint16_t piggyback_bytes;
+    uint16_t neighbor_bytes;
+    uint16_t olsr_bytes;
+    uint16_t total_bytes;
+    uint8_t sections_dropped; // Bit (1 << section type) per section that did not fit
+    bool piggyback_delta;     // Bitmaps went out as flips rather than raw
+    uint16_t struct_bytes;    // sizeof() of the sections encoded, for statistics
+    // Delta reference assumed by our own piggyback; encoding never changes
+    // nc_wire_tx_key, nc_wire_commit_tx() adopts this once the frame is sent
+    bool tx_key_pending;
+    bool tx_key_frame;
+    uint8_t tx_key_id;
+    uint64_t tx_nc_map;
+    uint64_t tx_dugu_map;
+} NCWireBudget;
+
+size_t nc_slot_message_encode(const NCSlotMessage *msg, uint8_t *buf, size_t max_len, NCWireBudget *budget);
+bool nc_slot_message_decode(const uint8_t *buf, size_t len, NCSlotMessage *msg);
+void nc_wire_commit_tx(const NCWireBudget *budget);
+void print_nc_wire_stats(void);
+
+#endif // NC_WIRE_H
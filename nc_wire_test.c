@@ -0,0 +1,267 @@
+/**
+ * NC Wire Codec Test Program
+ * Encodes NC slot messages with nc_wire.c and decodes them again in the same
+ * process (the sender's and receiver's delta references are separate state):
+ * full round trip, delta piggybacks and the key frame interval, a missed key
+ * frame, slot truncation, version mismatch, short buffers and unknown sections.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+#include "nc_wire.h"
+
+static int failures = 0;
+
+#define CHECK(cond, what) do { \
+    if (cond) { \
+        printf("PASS: %s\n", what); \
+    } else { \
+        printf("FAIL: %s\n", what); \
+        failures++; \
+    } \
+} while (0)
+
+#define MY_NODE 7
+
+static void make_message(NCSlotMessage *msg, uint32_t seq, uint64_t nc_map, uint64_t dugu_map) {
+    memset(msg, 0, sizeof(*msg));
+    msg->sourceNodeID = MY_NODE;
+    msg->myAssignedNCSlot = 12;
+    msg->timestamp = 123456789u;
+    msg->sequence_number = seq;
+
+    msg->has_piggyback = true;
+    msg->piggyback_tlv.type = NC_WIRE_SECTION_PIGGYBACK;
+    msg->piggyback_tlv.sourceNodeID = MY_NODE;
+    msg->piggyback_tlv.sourceReservations = 3;
+    msg->piggyback_tlv.relayReservations = 1;
+    msg->piggyback_tlv.myNCSlot = 12;
+    msg->piggyback_tlv.ttl = 5;
+    msg->piggyback_tlv.timeSync = 0xDEADBEEF;
+    msg->piggyback_tlv.ncStatusBitmap = nc_map;
+    msg->piggyback_tlv.duGuIntentionMap = dugu_map;
+}
+
+static void add_neighbor(NCSlotMessage *msg) {
+    NeighborState *n = &msg->my_neighbor_info;
+    msg->has_neighbor_info = true;
+    n->nodeID = 300;
+    n->assignedNCSlot = 4;
+    n->capabilities = 0x03;
+    n->txSlots[0] = 5;
+    n->txSlots[1] = 17;
+    n->rxSlots[0] = 22;
+    n->phy.rssi_dbm = -71.5f;
+    n->phy.snr_db = 18.2f;
+    n->phy.per_percent = 1.25f;
+    n->phy.packet_count = 100000;
+}
+
+static void add_olsr(NCSlotMessage *msg, size_t payload_len) {
+    OLSRMessage *m = &msg->olsr_message;
+    msg->has_olsr_message = true;
+    m->msg_type = 2;
+    m->vtime = 6;
+    m->ttl = 255;
+    m->hop_count = 1;
+    m->msg_seq_num = 4242;
+    m->originator_addr = MY_NODE;
+    m->payload_len = payload_len;
+    for (size_t i = 0; i < payload_len; i++)
+        m->payload[i] = (uint8_t)(i * 31 + 7);
+}
+
+// Encode, count the frame as sent, decode; returns encoded length
+static size_t send_and_receive(const NCSlotMessage *msg, size_t max_len, NCWireBudget *budget,
+                               NCSlotMessage *out, bool *decoded) {
+    static uint8_t buf[4096];
+    size_t len = nc_slot_message_encode(msg, buf, max_len, budget);
+    nc_wire_commit_tx(budget);
+    *decoded = len > 0 && nc_slot_message_decode(buf, len, out);
+    return len;
+}
+
+static bool piggyback_equal(const PiggybackTLV *a, const PiggybackTLV *b) {
+    return a->sourceNodeID == b->sourceNodeID && a->sourceReservations == b->sourceReservations &&
+           a->relayReservations == b->relayReservations && a->myNCSlot == b->myNCSlot &&
+           a->ttl == b->ttl && a->timeSync == b->timeSync &&
+           a->ncStatusBitmap == b->ncStatusBitmap && a->duGuIntentionMap == b->duGuIntentionMap;
+}
+
+static void test_round_trip(void) {
+    NCSlotMessage msg, out;
+    NCWireBudget budget;
+    bool decoded;
+
+    make_message(&msg, 300000, 0x00000000F0F0ULL, 0x0ABCDEF012345ULL);
+    add_neighbor(&msg);
+    add_olsr(&msg, 200);
+    size_t len = send_and_receive(&msg, 4096, &budget, &out, &decoded);
+
+    CHECK(decoded && out.is_valid, "full message decodes");
+    CHECK(out.sourceNodeID == MY_NODE && out.myAssignedNCSlot == 12 &&
+          out.timestamp == msg.timestamp && out.sequence_number == 300000,
+          "header fields round trip");
+    CHECK(out.has_piggyback && piggyback_equal(&out.piggyback_tlv, &msg.piggyback_tlv),
+          "piggyback round trips");
+    CHECK(!budget.piggyback_delta, "first piggyback is a raw key frame");
+
+    const NeighborState *n = &out.my_neighbor_info;
+    CHECK(out.has_neighbor_info && n->nodeID == 300 && n->assignedNCSlot == 4 &&
+          n->capabilities == 0x03 && memcmp(n->txSlots, msg.my_neighbor_info.txSlots, 10) == 0 &&
+          memcmp(n->rxSlots, msg.my_neighbor_info.rxSlots, 10) == 0 &&
+          n->phy.packet_count == 100000,
+          "neighbor state round trips");
+    CHECK(fabsf(n->phy.rssi_dbm - -71.5f) < 0.1f && fabsf(n->phy.snr_db - 18.2f) < 0.1f &&
+          fabsf(n->phy.per_percent - 1.25f) < 0.01f,
+          "PHY metrics round trip within fixed-point precision");
+
+    const OLSRMessage *m = &out.olsr_message;
+    CHECK(out.has_olsr_message && m->msg_type == 2 && m->vtime == 6 && m->ttl == 255 &&
+          m->hop_count == 1 && m->msg_seq_num == 4242 && m->originator_addr == MY_NODE &&
+          m->payload_len == 200 && memcmp(m->payload, msg.olsr_message.payload, 200) == 0,
+          "OLSR message round trips (long section length)");
+
+    CHECK(len == budget.total_bytes &&
+          len == (size_t)budget.header_bytes + budget.piggyback_bytes + budget.neighbor_bytes + budget.olsr_bytes,
+          "budget adds up to the encoded length");
+    CHECK(len < sizeof(PiggybackTLV) + sizeof(NeighborState) + 200, "encoded smaller than the structs");
+}
+
+static void test_delta_and_key_interval(void) {
+    NCSlotMessage msg, out;
+    NCWireBudget budget;
+    bool decoded;
+    uint64_t nc_map = 0x00FF00FF00ULL;
+    uint64_t dugu_map = 0x0FFFFFFFFFFFFFFFULL;
+
+    // Fresh key frame to start from
+    for (int i = 0; i < NC_WIRE_KEYFRAME_INTERVAL + 1; i++) {
+        make_message(&msg, 10, nc_map, dugu_map);
+        send_and_receive(&msg, 4096, &budget, &out, &decoded);
+        if (budget.tx_key_frame)
+            break;
+    }
+    size_t key_bytes = budget.piggyback_bytes;
+
+    bool all_delta = true, all_equal = true;
+    for (int i = 0; i < NC_WIRE_KEYFRAME_INTERVAL; i++) {
+        nc_map ^= 1ULL << (i % 40);
+        make_message(&msg, 11 + (uint32_t)i, nc_map, dugu_map);
+        send_and_receive(&msg, 4096, &budget, &out, &decoded);
+        all_delta &= budget.piggyback_delta && budget.piggyback_bytes < key_bytes;
+        all_equal &= decoded && out.has_piggyback && piggyback_equal(&out.piggyback_tlv, &msg.piggyback_tlv);
+    }
+    CHECK(all_delta, "small bitmap changes go out as smaller delta frames");
+    CHECK(all_equal, "delta frames decode to the sender's bitmaps");
+
+    make_message(&msg, 20, nc_map, dugu_map);
+    send_and_receive(&msg, 4096, &budget, &out, &decoded);
+    CHECK(budget.tx_key_frame && decoded && piggyback_equal(&out.piggyback_tlv, &msg.piggyback_tlv),
+          "key frame forced after NC_WIRE_KEYFRAME_INTERVAL deltas");
+
+    // A relayed piggyback (other source) is never delta-encoded
+    make_message(&msg, 21, nc_map, dugu_map);
+    msg.piggyback_tlv.sourceNodeID = MY_NODE + 1;
+    send_and_receive(&msg, 4096, &budget, &out, &decoded);
+    CHECK(!budget.piggyback_delta && !budget.tx_key_pending && decoded &&
+          piggyback_equal(&out.piggyback_tlv, &msg.piggyback_tlv),
+          "another node's piggyback is sent raw and leaves our key alone");
+}
+
+static void test_encode_is_pure(void) {
+    NCSlotMessage msg;
+    NCWireBudget a, b;
+    uint8_t buf_a[512], buf_b[512];
+
+    make_message(&msg, 30, 0x1234ULL, 0x5678ULL);
+    size_t len_a = nc_slot_message_encode(&msg, buf_a, sizeof(buf_a), &a);
+    size_t len_b = nc_slot_message_encode(&msg, buf_b, sizeof(buf_b), &b);
+    CHECK(len_a == len_b && memcmp(buf_a, buf_b, len_a) == 0 && a.tx_key_id == b.tx_key_id,
+          "encoding twice without commit gives the same frame");
+}
+
+static void test_missed_key_frame(void) {
+    NCSlotMessage msg, out;
+    NCWireBudget budget;
+    bool decoded;
+    uint8_t buf[512];
+    uint64_t nc_map = 0x3ULL;
+
+    // Run the sender up to a key frame that the receiver never hears
+    do {
+        make_message(&msg, 40, nc_map, 0);
+        nc_slot_message_encode(&msg, buf, sizeof(buf), &budget);
+        nc_wire_commit_tx(&budget);
+    } while (!budget.tx_key_frame);
+
+    nc_map ^= 0x10ULL;
+    make_message(&msg, 41, nc_map, 0);
+    add_neighbor(&msg);
+    send_and_receive(&msg, 4096, &budget, &out, &decoded);
+    CHECK(budget.piggyback_delta, "sender sends a delta against the lost key frame");
+    CHECK(decoded && !out.has_piggyback && out.has_neighbor_info,
+          "receiver drops only the piggyback when its delta base is missing");
+}
+
+static void test_truncation(void) {
+    NCSlotMessage msg, out;
+    NCWireBudget budget;
+    bool decoded;
+    uint8_t buf[128];
+
+    make_message(&msg, 50, 0x1ULL, 0x2ULL);
+    msg.piggyback_tlv.sourceNodeID = MY_NODE + 2; // Raw maps, decodes without a key
+    add_neighbor(&msg);
+    add_olsr(&msg, 300);
+    size_t len = nc_slot_message_encode(&msg, buf, sizeof(buf), &budget);
+    decoded = len > 0 && nc_slot_message_decode(buf, len, &out);
+
+    CHECK(len > 0 && len <= sizeof(buf), "encoding fits the slot");
+    CHECK((buf[0] & NC_WIRE_FLAG_TRUNCATED) && (budget.sections_dropped & (1u << NC_WIRE_SECTION_OLSR)) &&
+          !(budget.sections_dropped & (1u << NC_WIRE_SECTION_NEIGHBOR)),
+          "section that does not fit is dropped and flagged");
+    CHECK(decoded && out.has_piggyback && out.has_neighbor_info && !out.has_olsr_message,
+          "truncated message decodes with the sections that fit");
+
+    CHECK(nc_slot_message_encode(&msg, buf, 4, &budget) == 0, "slot smaller than the header fails");
+}
+
+static void test_malformed(void) {
+    NCSlotMessage msg, out;
+    NCWireBudget budget;
+    uint8_t buf[512];
+
+    make_message(&msg, 60, 0x1ULL, 0x2ULL);
+    msg.piggyback_tlv.sourceNodeID = MY_NODE + 2; // Raw maps, decodes without a key
+    add_neighbor(&msg);
+    size_t len = nc_slot_message_encode(&msg, buf, sizeof(buf), &budget);
+
+    CHECK(!nc_slot_message_decode(buf, len - 1, &out), "short buffer is rejected");
+
+    // Unknown section appended by a newer sender
+    buf[len] = 0x7F;
+    buf[len + 1] = 2;
+    buf[len + 2] = 0xAA;
+    buf[len + 3] = 0xBB;
+    CHECK(nc_slot_message_decode(buf, len + 4, &out) && out.has_piggyback && out.has_neighbor_info,
+          "unknown section type is skipped");
+
+    buf[0] = (uint8_t)((NC_WIRE_VERSION + 1) << 4);
+    CHECK(!nc_slot_message_decode(buf, len, &out), "other wire version is rejected");
+}
+
+int main(void) {
+    test_round_trip();
+    test_delta_and_key_interval();
+    test_encode_is_pure();
+    test_missed_key_frame();
+    test_truncation();
+    test_malformed();
+
+    print_nc_wire_stats();
+    printf("%s\n", failures ? "FAILED" : "ALL TESTS PASSED");
+    return failures ? 1 : 0;
+}
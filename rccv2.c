@@ -23,6 +23,7 @@
 #define HAVE_STRUCT_TIMESPEC
 #include <pthread.h>
 #include "rrc_message_queue.h"
+#include "nc_wire.h"
 
 // Compatibility constants for queue.c
 #define PAYLOAD_SIZE_BYTES 2800 // Updated payload size for larger data packets
@@ -440,29 +441,6 @@ typedef struct
 // MANET WAVEFORM STRUCTURES AND DEFINITIONS
 // ============================================================================
 
-// PHY Metrics Structure for neighbor tracking
-typedef struct
-{
-    float rssi_dbm;
-    float snr_db;
-    float per_percent;
-    uint32_t packet_count; // Total packets received from neighbor
-    uint32_t last_update_time;
-} PHYMetrics;
-
-// Neighbor State Structure (MANET requirements)
-typedef struct
-{
-    uint16_t nodeID;
-    uint64_t lastHeardTime;
-    uint8_t txSlots[10]; // Which slots neighbor will transmit
-    uint8_t rxSlots[10]; // Which slots neighbor expects to receive
-    PHYMetrics phy;
-    uint8_t capabilities;   // TX/RX capabilities bitmask
-    bool active;            // Is this neighbor currently active
-    uint8_t assignedNCSlot; // NC slot assigned to this neighbor
-} NeighborState;
-
 // Slot Status Structure (Requirement 2)
 typedef struct
 {
@@ -471,21 +449,6 @@ typedef struct
     uint32_t lastUpdateTime;
 } SlotStatus;
 
-// Piggyback TLV Structure (Requirement 1)
-typedef struct
-{
-    uint8_t type;               // TLV type identifier
-    uint8_t length;             // TLV length
-    uint16_t sourceNodeID;      // Source node ID
-    uint8_t sourceReservations; // Source reservations (voice/data)
-    uint8_t relayReservations;  // Relay reservations (voice/data)
-    uint64_t duGuIntentionMap;  // 60-bit DU/GU slot intention
-    uint64_t ncStatusBitmap;    // 40-bit NC slot status
-    uint32_t timeSync;          // Time synchronization info
-    uint8_t myNCSlot;           // My assigned NC slot
-    uint8_t ttl;                // Time-to-live for soft state
-} PiggybackTLV;
-
 // NC Slot Management with phy layer assistance
 typedef struct
 {
@@ -552,34 +515,6 @@ static TDMA_SlotInfo tdma_slot_table[8];
 //
 // ============================================================================
 
-// OLSR Message Structure for NC transmission
-typedef struct {
-    uint8_t msg_type;           // 1=HELLO, 2=TC
-    uint8_t vtime;              // Validity time
-    uint16_t msg_size;          // Message size
-    uint32_t originator_addr;   // Originating node
-    uint8_t ttl;                // Time to live
-    uint8_t hop_count;          // Hop count
-    uint16_t msg_seq_num;       // Sequence number
-    uint8_t payload[2048];      // OLSR message payload
-    size_t payload_len;         // Actual payload length
-} OLSRMessage;
-
-// NC Slot Message - Complete message for TDMA transmission
-typedef struct {
-    uint8_t myAssignedNCSlot;        // My assigned NC slot (1-40)
-    OLSRMessage olsr_message;        // OLSR HELLO/TC to transmit
-    bool has_olsr_message;           // Flag: OLSR message present
-    PiggybackTLV piggyback_tlv;      // Piggyback information
-    bool has_piggyback;              // Flag: Piggyback present
-    NeighborState my_neighbor_info;  // My neighbor state information
-    bool has_neighbor_info;          // Flag: Neighbor info present
-    uint32_t timestamp;              // Message creation timestamp
-    uint16_t sourceNodeID;           // Source node ID
-    uint32_t sequence_number;        // Message sequence number
-    bool is_valid;                   // Message validity flag
-} NCSlotMessage;
-
 // NC Slot Message Queue (Circular buffer in shared memory concept)
 #define NC_SLOT_QUEUE_SIZE 10
 typedef struct {
@@ -866,6 +801,7 @@ void rrc_update_piggyback_ttl(void);
 
 // NC Frame Building (Section A.2)
 size_t rrc_build_nc_frame(uint8_t *buffer, size_t maxLen);
+void rrc_nc_frame_transmitted(void);
 
 // Relay Handling (Section A.5)
 bool rrc_should_relay(struct frame *frame);
@@ -1837,6 +1773,10 @@ void rrc_generate_slot_status(SlotStatus *out)
            (unsigned long long)out->ncStatusBitmap, (unsigned long long)out->duGuUsageBitmap);
 }
 
+// ============================================================================
+// PIGGYBACK TLV MANAGEMENT
+// ============================================================================
+
 // Initialize Piggyback TLV System (Section A.2)
 void rrc_init_piggyback_tlv(void)
 {
@@ -1870,20 +1810,21 @@ void rrc_build_piggyback_tlv(PiggybackTLV *tlv)
     printf("RRC: Built piggyback TLV for NC slot %u\n", tlv->myNCSlot);
 }
 
-// Parse received piggyback TLV (Section A.2)
+// Parse the piggyback TLV out of a received NC frame (Section A.2). The frame
+// is the versioned header plus sections that rrc_build_nc_frame() produces.
 bool rrc_parse_piggyback_tlv(const uint8_t *data, size_t len, PiggybackTLV *tlv)
 {
-    if (!data || !tlv || len < sizeof(PiggybackTLV))
+    if (!data || !tlv)
     {
         return false;
     }
 
-    if (data[0] != 0x01)
-    { // Check TLV type
+    NCSlotMessage msg;
+    if (!nc_slot_message_decode(data, len, &msg) || !msg.has_piggyback)
+    {
         return false;
     }
-
-    memcpy(tlv, data, sizeof(PiggybackTLV));
+    *tlv = msg.piggyback_tlv;
 
     // Update neighbor state from TLV
     NeighborState *neighbor = rrc_create_neighbor_state(tlv->sourceNodeID);
@@ -1916,23 +1857,54 @@ void rrc_update_piggyback_ttl(void)
     }
 }
 
+// Encoding of the last NC frame handed to TDMA but not yet confirmed as sent
+static NCWireBudget nc_frame_pending;
+static bool nc_frame_pending_valid = false;
+
 // Build complete NC frame (Section A.2)
 size_t rrc_build_nc_frame(uint8_t *buffer, size_t maxLen)
 {
-    if (!buffer || maxLen < sizeof(PiggybackTLV))
+    if (!buffer)
     {
         return 0;
     }
 
+    NCSlotMessage msg;
+    build_nc_slot_message(&msg, nc_manager.myAssignedNCSlot);
+
     PiggybackTLV tlv;
     rrc_build_piggyback_tlv(&tlv);
+    add_piggyback_to_nc_message(&msg, &tlv);
+
+    NCWireBudget budget;
+    size_t used = nc_slot_message_encode(&msg, buffer, maxLen, &budget);
+    if (used == 0 || budget.sections_dropped)
+    {
+        printf("RRC: NC frame does not fit in %zu bytes\n", maxLen);
+        nc_frame_pending_valid = false;
+        return 0;
+    }
 
-    // Copy TLV to buffer
-    memcpy(buffer, &tlv, sizeof(PiggybackTLV));
+    // Held until the PHY confirms the frame, see rrc_nc_frame_transmitted()
+    nc_frame_pending = budget;
+    nc_frame_pending_valid = true;
 
-    printf("RRC: Built NC frame with piggyback TLV (%zu bytes)\n", sizeof(PiggybackTLV));
+    printf("RRC: Built NC frame with piggyback TLV (%zu bytes, %s bitmaps)\n",
+           used, budget.piggyback_delta ? "delta" : "raw");
 
-    return sizeof(PiggybackTLV);
+    return used;
+}
+
+// Called by TDMA once the last frame from rrc_build_nc_frame() was sent. Only
+// then does the next frame delta-encode against that frame's bitmaps.
+void rrc_nc_frame_transmitted(void)
+{
+    if (!nc_frame_pending_valid)
+    {
+        return;
+    }
+    nc_wire_commit_tx(&nc_frame_pending);
+    nc_frame_pending_valid = false;
 }
 
 // Check if packet should be relayed (Section A.5)
@@ -3409,6 +3381,14 @@ bool rrc_tdma_receive_nc_slot_message(NCSlotMessage *out_msg)
     if (nc_slot_queue_dequeue(out_msg))
     {
         printf("RRC: TDMA received NC slot message (slot %u)\n", out_msg->myAssignedNCSlot);
+
+        // Over-the-air size of this message in the NC slot
+        uint8_t wire[PAYLOAD_SIZE_BYTES];
+        NCWireBudget budget;
+        size_t wire_len = nc_slot_message_encode(out_msg, wire, sizeof(wire), &budget);
+        printf("  - Wire size %zu bytes (header %u, piggyback %u%s, neighbor %u, OLSR %u)\n",
+               wire_len, budget.header_bytes, budget.piggyback_bytes,
+               budget.piggyback_delta ? " delta" : "", budget.neighbor_bytes, budget.olsr_bytes);
         
         // Process components
         if (out_msg->has_olsr_message)
@@ -3997,6 +3977,7 @@ void print_rrc_stats(void)
 
     // Print NC slot message queue statistics
     print_nc_slot_queue_stats();
+    print_nc_wire_stats();
 
     // Print NC reservation priority status
     print_nc_reservation_priority_status();
@@ -9,6 +9,7 @@
 #include<string.h>
 #include<stdlib.h>
 #include<time.h>
+#include "../l7/l7_control.h"
 
 #define QUEUE_SIZE 10
 #define PAYLOAD_SIZE_BYTES 16
@@ -122,86 +123,51 @@ struct frame create_frame_from_rrc_json(uint8_t source_node, uint8_t dest_node,
 }
 
 // ============================================================================
-// RRC JSON Integration Functions - Use your RRC JSON parser
+// RRC Control Message Integration - single-pass JSON / TLV parsing
 // ============================================================================
 
 /**
- * @brief Extract integer value from JSON (from your RRC dup.c)
+ * @brief Process RRC control message (JSON or binary TLV) and add to appropriate queue
+ * All fields are filled in one pass by l7_parse_control(); payload is not copied.
  */
-int extract_json_int_value(const char *json, const char *key) {
-    char search_pattern[100];
-    snprintf(search_pattern, sizeof(search_pattern), "\"%s\":", key);
-    
-    char *key_pos = strstr(json, search_pattern);
-    if (!key_pos) return -1;
-    
-    char *value_start = key_pos + strlen(search_pattern);
-    while (*value_start == ' ' || *value_start == '\t') value_start++;
-    
-    return atoi(value_start);
-}
-
-/**
- * @brief Extract string value from JSON (from your RRC dup.c)
- */
-char* extract_json_string_value(const char *json, const char *key) {
-    char search_pattern[100];
-    snprintf(search_pattern, sizeof(search_pattern), "\"%s\":", key);
-    
-    char *key_pos = strstr(json, search_pattern);
-    if (!key_pos) return NULL;
-    
-    char *value_start = strchr(key_pos + strlen(search_pattern), '"');
-    if (!value_start) return NULL;
-    value_start++; // Skip opening quote
-    
-    char *value_end = strchr(value_start, '"');
-    if (!value_end) return NULL;
-    
-    size_t value_len = value_end - value_start;
-    char *result = (char*)malloc(value_len + 1);
-    if (!result) return NULL;
-    
-    strncpy(result, value_start, value_len);
-    result[value_len] = '\0';
-    
-    return result;
-}
-
-/**
- * @brief Process REAL RRC JSON message and add to appropriate queue
- * NOW ACTUALLY PARSES JSON FROM YOUR RRC!
- */
-void process_rrc_message_to_queue(const char* json_message, 
+void process_rrc_message_to_queue(const char* message, size_t message_len,
                                  struct queue *analog_voice_queue,
                                  struct queue data_queues[],
                                  struct queue *rx_queue) {
     
-    if (!json_message) {
-        printf("RRC→TDMA: ERROR - No JSON message provided\n");
+    if (!message || message_len == 0) {
+        printf("RRC→TDMA: ERROR - No control message provided\n");
         return;
     }
     
-    printf("RRC→TDMA: Processing JSON: %s\n", json_message);
+    L7_Command cmd;
+    L7_Format format = l7_parse_control((const uint8_t*)message, message_len, &cmd);
+    if (format != L7_FORMAT_JSON && format != L7_FORMAT_TLV) {
+        printf("RRC→TDMA: ERROR - Malformed control message\n");
+        return;
+    }
     
-    // PARSE REAL JSON FROM YOUR RRC IMPLEMENTATION
-    uint8_t source_node = extract_json_int_value(json_message, "node_id");
-    uint8_t dest_node = extract_json_int_value(json_message, "dest_node_id");
-    uint8_t next_hop = extract_json_int_value(json_message, "next_hop_node");
-    int rrc_priority = extract_json_int_value(json_message, "priority");
-    int rrc_data_type = extract_json_int_value(json_message, "data_type");
-    int payload_size = extract_json_int_value(json_message, "data_size");
+    if (format == L7_FORMAT_JSON) {
+        printf("RRC→TDMA: Processing JSON: %.*s\n", (int)message_len, message);
+    } else {
+        printf("RRC→TDMA: Processing TLV message (%zu bytes)\n", message_len);
+    }
     
-    // Get payload data
-    char* payload_str = extract_json_string_value(json_message, "data");
-    const char* payload = payload_str ? payload_str : "DefaultData";
-    if (payload_size <= 0) payload_size = strlen(payload);
+    // Apply defaults for missing fields
+    uint8_t source_node = (cmd.present & L7_FIELD_NODE_ID) ? (uint8_t)cmd.node_id : 254;
+    uint8_t dest_node = (cmd.present & L7_FIELD_DEST_NODE_ID) ? (uint8_t)cmd.dest_node_id : 1;
+    uint8_t next_hop = (cmd.present & L7_FIELD_NEXT_HOP_NODE) ? (uint8_t)cmd.next_hop_node : dest_node;
+    int rrc_data_type = (cmd.present & L7_FIELD_DATA_TYPE) ? cmd.data_type : 0;
+    int rrc_priority = (cmd.present & L7_FIELD_PRIORITY) ? cmd.priority : 3;
+    
+    const char* payload = (cmd.present & L7_FIELD_DATA) ? (const char*)cmd.data : "DefaultData";
+    int payload_size = (cmd.present & L7_FIELD_DATA) ? (int)cmd.data_len : (int)strlen(payload);
+    if ((cmd.present & L7_FIELD_DATA_SIZE) && cmd.data_size > 0 && cmd.data_size < payload_size) {
+        payload_size = cmd.data_size;
+    }
     
     // Validate parsed data
-    if (source_node == -1) source_node = 254; // Default node
-    if (dest_node == -1) dest_node = 1;       // Default destination
-    if (next_hop == -1) next_hop = dest_node; // Default next hop
-    if (rrc_priority == -1 && strstr(json_message, "ptt")) {
+    if (rrc_data_type == 5) {
         rrc_priority = -1; // PTT emergency
     } else if (rrc_priority < -1 || rrc_priority > 4) {
         rrc_priority = 3; // Default to SMS priority
@@ -210,7 +176,7 @@ void process_rrc_message_to_queue(const char* json_message,
     printf("RRC→TDMA: Parsed - Node:%u→%u, NextHop:%u, Priority:%d, Type:%d, Size:%d\n",
            source_node, dest_node, next_hop, rrc_priority, rrc_data_type, payload_size);
     
-    // Create frame from REAL RRC JSON data
+    // Create frame from parsed RRC control data
     struct frame frame = create_frame_from_rrc_json(source_node, dest_node, next_hop,
                                                    rrc_data_type, rrc_priority, 
                                                    payload, payload_size);
@@ -235,9 +201,6 @@ void process_rrc_message_to_queue(const char* json_message,
         enqueue(rx_queue, frame);
         printf("RRC→TDMA: 🔄 Relay message queued to rx_queue\n");
     }
-    
-    // Clean up
-    if (payload_str) free(payload_str);
 }
 
 // ============================================================================
@@ -373,23 +336,37 @@ int main() {
     
     printf("1. PTT Emergency Message (from RRC)\n");
     const char* ptt_json = "{\"node_id\":254, \"dest_node_id\":255, \"data_type\":\"ptt\", \"priority\":-1, \"transmission_type\":\"broadcast\", \"data\":\"Emergency\", \"data_size\":9, \"next_hop_node\":255}";
-    process_rrc_message_to_queue(ptt_json, &analog_voice_queue, data_from_l3_queue, &rx_queue);
+    process_rrc_message_to_queue(ptt_json, strlen(ptt_json), &analog_voice_queue, data_from_l3_queue, &rx_queue);
     
     printf("\n2. Digital Voice Message (from RRC)\n");
     const char* voice_json = "{\"node_id\":254, \"dest_node_id\":2, \"data_type\":\"voice_digital\", \"priority\":0, \"transmission_type\":\"unicast\", \"data\":\"VoiceData\", \"data_size\":9, \"next_hop_node\":2}";
-    process_rrc_message_to_queue(voice_json, &analog_voice_queue, data_from_l3_queue, &rx_queue);
+    process_rrc_message_to_queue(voice_json, strlen(voice_json), &analog_voice_queue, data_from_l3_queue, &rx_queue);
     
     printf("\n3. Video Stream Message (from RRC)\n");
     const char* video_json = "{\"node_id\":254, \"dest_node_id\":3, \"data_type\":\"video\", \"priority\":1, \"transmission_type\":\"unicast\", \"data\":\"VideoStream\", \"data_size\":11, \"next_hop_node\":3}";
-    process_rrc_message_to_queue(video_json, &analog_voice_queue, data_from_l3_queue, &rx_queue);
+    process_rrc_message_to_queue(video_json, strlen(video_json), &analog_voice_queue, data_from_l3_queue, &rx_queue);
     
     printf("\n4. File Transfer Message (from RRC)\n");
     const char* file_json = "{\"node_id\":254, \"dest_node_id\":4, \"data_type\":\"file\", \"priority\":2, \"transmission_type\":\"unicast\", \"data\":\"FileData\", \"data_size\":8, \"next_hop_node\":4}";
-    process_rrc_message_to_queue(file_json, &analog_voice_queue, data_from_l3_queue, &rx_queue);
+    process_rrc_message_to_queue(file_json, strlen(file_json), &analog_voice_queue, data_from_l3_queue, &rx_queue);
     
     printf("\n5. SMS Message (from RRC)\n");
     const char* sms_json = "{\"node_id\":254, \"dest_node_id\":1, \"data_type\":\"sms\", \"priority\":3, \"transmission_type\":\"unicast\", \"data\":\"Hello\", \"data_size\":5, \"next_hop_node\":1}";
-    process_rrc_message_to_queue(sms_json, &analog_voice_queue, data_from_l3_queue, &rx_queue);
+    process_rrc_message_to_queue(sms_json, strlen(sms_json), &analog_voice_queue, data_from_l3_queue, &rx_queue);
+    
+    printf("\n6. SMS Message as binary TLV (compact L7<->RRC encoding)\n");
+    L7_Command tlv_cmd = {0};
+    uint8_t tlv_buf[64];
+    tlv_cmd.present = L7_FIELD_NODE_ID | L7_FIELD_DEST_NODE_ID | L7_FIELD_PRIORITY |
+                      L7_FIELD_DATA_TYPE | L7_FIELD_DATA;
+    tlv_cmd.node_id = 254;
+    tlv_cmd.dest_node_id = 5;
+    tlv_cmd.priority = 3;
+    tlv_cmd.data_type = 0;
+    tlv_cmd.data = (const uint8_t*)"Hi";
+    tlv_cmd.data_len = 2;
+    size_t tlv_len = l7_tlv_encode_command(&tlv_cmd, tlv_buf, sizeof(tlv_buf));
+    process_rrc_message_to_queue((const char*)tlv_buf, tlv_len, &analog_voice_queue, data_from_l3_queue, &rx_queue);
     
     printf("\nTesting transmission priority order:\n");
     printf("===================================\n");
@@ -7,6 +7,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <stddef.h>
 #include <time.h>
 #include <errno.h>
 
@@ -33,6 +34,232 @@ uint32_t generate_request_id(void) {
     return id;
 }
 
+// ============================================================================
+// MESSAGE LAYOUTS
+// ============================================================================
+
+// Where each message type keeps its payload array, so records can skip
+// the unused part of it
+typedef struct {
+    uint16_t size;                  // sizeof the union member; 0 = unknown type
+    uint16_t payload_offset;
+    uint16_t payload_cap;           // 0 = no payload array
+    uint16_t payload_len_offset;
+} MessageLayout;
+
+#define LAYOUT(T) { sizeof(T), 0, 0, 0 }
+#define LAYOUT_PAYLOAD(T) { sizeof(T), offsetof(T, payload), \
+                            sizeof(((T *)0)->payload), offsetof(T, payload_len) }
+
+static const MessageLayout message_layouts[] = {
+    [MSG_TYPE_OLSR_ROUTE_REQUEST]        = LAYOUT(OLSR_RouteRequest),
+    [MSG_TYPE_OLSR_ROUTE_RESPONSE]       = LAYOUT(OLSR_RouteResponse),
+    [MSG_TYPE_OLSR_TRIGGER_DISCOVERY]    = LAYOUT(OLSR_TriggerDiscovery),
+    [MSG_TYPE_OLSR_HELLO_NC]             = LAYOUT_PAYLOAD(OLSR_HelloNC),
+    [MSG_TYPE_TDMA_SLOT_CHECK_REQUEST]   = LAYOUT(TDMA_SlotCheckRequest),
+    [MSG_TYPE_TDMA_SLOT_CHECK_RESPONSE]  = LAYOUT(TDMA_SlotCheckResponse),
+    [MSG_TYPE_TDMA_NC_SLOT_REQUEST]      = LAYOUT_PAYLOAD(TDMA_NCSlotRequest),
+    [MSG_TYPE_TDMA_NC_SLOT_RESPONSE]     = LAYOUT(TDMA_NCSlotResponse),
+    [MSG_TYPE_PHY_METRICS_REQUEST]       = LAYOUT(PHY_MetricsRequest),
+    [MSG_TYPE_PHY_METRICS_RESPONSE]      = LAYOUT(PHY_MetricsResponse),
+    [MSG_TYPE_PHY_LINK_STATUS_REQUEST]   = LAYOUT(PHY_LinkStatusRequest),
+    [MSG_TYPE_PHY_LINK_STATUS_RESPONSE]  = LAYOUT(PHY_LinkStatusResponse),
+    [MSG_TYPE_PHY_PACKET_COUNT_REQUEST]  = LAYOUT(PHY_PacketCountRequest),
+    [MSG_TYPE_PHY_PACKET_COUNT_RESPONSE] = LAYOUT(PHY_PacketCountResponse),
+    [MSG_TYPE_APP_TO_RRC]                = LAYOUT_PAYLOAD(APP_ToRRC_Msg),
+    [MSG_TYPE_RRC_TO_APP]                = LAYOUT_PAYLOAD(RRC_ToAPP_Frame),
+};
+
+_Static_assert(sizeof(OLSR_HelloNC) - 256 <= MESSAGE_FIXED_MAX, "OLSR_HelloNC fixed part");
+_Static_assert(sizeof(TDMA_NCSlotRequest) - PAYLOAD_SIZE_BYTES <= MESSAGE_FIXED_MAX, "TDMA_NCSlotRequest fixed part");
+_Static_assert(sizeof(APP_ToRRC_Msg) - PAYLOAD_SIZE_BYTES <= MESSAGE_FIXED_MAX, "APP_ToRRC_Msg fixed part");
+_Static_assert(sizeof(RRC_ToAPP_Frame) - PAYLOAD_SIZE_BYTES <= MESSAGE_FIXED_MAX, "RRC_ToAPP_Frame fixed part");
+_Static_assert(MESSAGE_RING_BYTES % 8 == 0, "records are 8-byte aligned");
+
+static const MessageLayout *message_layout(const LayerMessage *msg) {
+    unsigned type = (unsigned)msg->header.msg_type;
+    if (type >= sizeof(message_layouts) / sizeof(message_layouts[0]) ||
+        message_layouts[type].size == 0 ||
+        message_layouts[type].size - message_layouts[type].payload_cap > MESSAGE_FIXED_MAX) {
+        return NULL;
+    }
+    return &message_layouts[type];
+}
+
+static size_t message_payload_len(const LayerMessage *msg, const MessageLayout *layout) {
+    if (layout->payload_cap == 0) {
+        return 0;
+    }
+    size_t len;
+    memcpy(&len, (const uint8_t *)msg + layout->payload_len_offset, sizeof(len));
+    return len < layout->payload_cap ? len : layout->payload_cap;
+}
+
+// ============================================================================
+// PAYLOAD POOL
+// ============================================================================
+
+static uint8_t payload_pool[MESSAGE_PAYLOAD_POOL_SIZE][PAYLOAD_SIZE_BYTES];
+static int payload_free[MESSAGE_PAYLOAD_POOL_SIZE];
+static int payload_free_count = -1;     // -1 until first use
+static pthread_mutex_t payload_pool_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t payload_pool_cond = PTHREAD_COND_INITIALIZER;
+
+_Static_assert(MESSAGE_PAYLOAD_POOL_SIZE <= INT16_MAX, "pool index fits RecordHeader");
+
+static int payload_pool_index(const uint8_t *payload) {
+    if (payload < payload_pool[0] || payload >= payload_pool[MESSAGE_PAYLOAD_POOL_SIZE]) {
+        return -1;
+    }
+    return (int)((payload - payload_pool[0]) / PAYLOAD_SIZE_BYTES);
+}
+
+// Take a bulk payload buffer, waiting until deadline (NULL = don't wait)
+// for one to be released; NULL if none became free in time
+static uint8_t *payload_pool_take(const struct timespec *deadline) {
+    uint8_t *payload = NULL;
+
+    pthread_mutex_lock(&payload_pool_mutex);
+    if (payload_free_count < 0) {
+        for (int i = 0; i < MESSAGE_PAYLOAD_POOL_SIZE; i++) {
+            payload_free[i] = MESSAGE_PAYLOAD_POOL_SIZE - 1 - i;
+        }
+        payload_free_count = MESSAGE_PAYLOAD_POOL_SIZE;
+    }
+    while (payload_free_count == 0 && deadline) {
+        if (pthread_cond_timedwait(&payload_pool_cond, &payload_pool_mutex, deadline) == ETIMEDOUT) {
+            break;
+        }
+    }
+    if (payload_free_count > 0) {
+        payload = payload_pool[payload_free[--payload_free_count]];
+    }
+    pthread_mutex_unlock(&payload_pool_mutex);
+
+    return payload;
+}
+
+// Take a bulk payload buffer (PAYLOAD_SIZE_BYTES); NULL if the pool is empty
+uint8_t *message_payload_alloc(void) {
+    return payload_pool_take(NULL);
+}
+
+// Return a payload buffer; pointers outside the pool are ignored
+void message_payload_release(uint8_t *payload) {
+    int index = payload ? payload_pool_index(payload) : -1;
+    if (index < 0) {
+        return;
+    }
+
+    pthread_mutex_lock(&payload_pool_mutex);
+    payload_free[payload_free_count++] = index;
+    pthread_cond_signal(&payload_pool_cond);
+    pthread_mutex_unlock(&payload_pool_mutex);
+}
+
+// ============================================================================
+// MESSAGE RING
+// ============================================================================
+
+// Record header; the record's fixed fields and inline payload follow
+typedef struct {
+    uint16_t length;                // Whole record, 8-byte aligned; 0 = wrap padding
+    int16_t pool_index;             // Pooled payload buffer, -1 if inline or none
+    uint32_t payload_len;
+} RecordHeader;
+
+_Static_assert(sizeof(RecordHeader) == MESSAGE_RECORD_HEADER, "record header size");
+
+#define RECORD_ALIGN(n) (((n) + 7) & ~(size_t)7)
+
+// Caller holds mq->mutex and a slot from empty_slots, which guarantees room
+static void ring_write_record(MessageQueue *mq, const LayerMessage *msg, const MessageLayout *layout,
+                              const uint8_t *payload, size_t payload_len, int pool_index) {
+    size_t fixed = layout->size - layout->payload_cap;
+    size_t inline_len = pool_index < 0 ? payload_len : 0;
+    size_t length = RECORD_ALIGN(sizeof(RecordHeader) + fixed + inline_len);
+
+    // Records never straddle the end of the ring
+    if (mq->ring_head + length > MESSAGE_RING_BYTES) {
+        if (mq->ring_head < MESSAGE_RING_BYTES) {
+            RecordHeader pad = { 0, -1, 0 };
+            memcpy(&mq->ring[mq->ring_head], &pad, sizeof(pad));
+        }
+        mq->ring_head = 0;
+    }
+
+    uint8_t *rec = &mq->ring[mq->ring_head];
+    RecordHeader hdr = { (uint16_t)length, (int16_t)pool_index, (uint32_t)payload_len };
+    memcpy(rec, &hdr, sizeof(hdr));
+    rec += sizeof(hdr);
+
+    const uint8_t *src = (const uint8_t *)msg;
+    if (layout->payload_cap == 0) {
+        memcpy(rec, src, layout->size);
+    } else {
+        size_t suffix = layout->payload_offset + layout->payload_cap;
+        memcpy(rec, src, layout->payload_offset);
+        memcpy(rec + layout->payload_offset, src + suffix, layout->size - suffix);
+        if (inline_len > 0) {
+            memcpy(rec + fixed, payload, inline_len);
+        }
+    }
+
+    mq->ring_head += length;
+    mq->bytes_enqueued += length;
+}
+
+// Caller holds mq->mutex and a filled slot. Copies the fixed fields into
+// msg and returns the payload: inline bytes are copied into msg's own
+// payload array, pooled ones are returned by reference.
+static void ring_read_record(MessageQueue *mq, LayerMessage *msg,
+                             uint8_t **payload, size_t *payload_len) {
+    RecordHeader hdr;
+    if (mq->ring_tail + sizeof(hdr) > MESSAGE_RING_BYTES) {
+        mq->ring_tail = 0;
+    }
+    memcpy(&hdr, &mq->ring[mq->ring_tail], sizeof(hdr));
+    if (hdr.length == 0) {
+        mq->ring_tail = 0;
+        memcpy(&hdr, mq->ring, sizeof(hdr));
+    }
+
+    const uint8_t *rec = &mq->ring[mq->ring_tail] + sizeof(hdr);
+    MessageHeader msg_header;
+    memcpy(&msg_header, rec, sizeof(msg_header));
+    const MessageLayout *layout = &message_layouts[msg_header.msg_type];
+
+    uint8_t *dst = (uint8_t *)msg;
+    *payload = NULL;
+    *payload_len = hdr.payload_len;
+    if (layout->payload_cap == 0) {
+        memcpy(dst, rec, layout->size);
+    } else {
+        size_t fixed = layout->size - layout->payload_cap;
+        size_t suffix = layout->payload_offset + layout->payload_cap;
+        memcpy(dst, rec, layout->payload_offset);
+        memcpy(dst + suffix, rec + layout->payload_offset, layout->size - suffix);
+        if (hdr.pool_index >= 0) {
+            *payload = payload_pool[hdr.pool_index];
+        } else {
+            memcpy(dst + layout->payload_offset, rec + fixed, hdr.payload_len);
+            *payload = dst + layout->payload_offset;
+        }
+    }
+
+    mq->ring_tail += hdr.length;
+}
+
+static void deadline_after_ms(struct timespec *ts, int timeout_ms) {
+    clock_gettime(CLOCK_REALTIME, ts);
+    ts->tv_sec += timeout_ms / 1000;
+    ts->tv_nsec += (timeout_ms % 1000) * 1000000L;
+    if (ts->tv_nsec >= 1000000000L) {
+        ts->tv_sec++;
+        ts->tv_nsec -= 1000000000L;
+    }
+}
+
 // Initialize a message queue
 int message_queue_init(MessageQueue *mq, const char *name) {
     if (!mq || !name) {
@@ -42,8 +269,8 @@ int message_queue_init(MessageQueue *mq, const char *name) {
     memset(mq, 0, sizeof(MessageQueue));
     strncpy(mq->name, name, sizeof(mq->name) - 1);
     
-    mq->read_index = 0;
-    mq->write_index = 0;
+    mq->ring_head = 0;
+    mq->ring_tail = 0;
     mq->count = 0;
     mq->enqueue_count = 0;
     mq->dequeue_count = 0;
@@ -69,7 +296,8 @@ int message_queue_init(MessageQueue *mq, const char *name) {
         return -1;
     }
     
-    printf("MessageQueue '%s' initialized (size=%d)\n", name, MESSAGE_QUEUE_SIZE);
+    printf("MessageQueue '%s' initialized (size=%d, ring=%d bytes)\n",
+           name, MESSAGE_QUEUE_SIZE, MESSAGE_RING_BYTES);
     return 0;
 }
 
@@ -79,6 +307,16 @@ void message_queue_cleanup(MessageQueue *mq) {
         return;
     }
     
+    // Pooled payloads still queued go back to the pool
+    while (mq->count > 0) {
+        LayerMessage msg;
+        uint8_t *payload;
+        size_t payload_len;
+        ring_read_record(mq, &msg, &payload, &payload_len);
+        message_payload_release(payload);
+        mq->count--;
+    }
+    
     sem_destroy(&mq->empty_slots);
     sem_destroy(&mq->filled_slots);
     pthread_mutex_destroy(&mq->mutex);
@@ -87,23 +325,13 @@ void message_queue_cleanup(MessageQueue *mq) {
            mq->name, mq->enqueue_count, mq->dequeue_count, mq->overflow_count);
 }
 
-// Enqueue message with timeout
-int message_queue_enqueue(MessageQueue *mq, const LayerMessage *msg, int timeout_ms) {
-    if (!mq || !msg) {
-        return -1;
-    }
-    
-    struct timespec ts;
-    clock_gettime(CLOCK_REALTIME, &ts);
-    ts.tv_sec += timeout_ms / 1000;
-    ts.tv_nsec += (timeout_ms % 1000) * 1000000L;
-    if (ts.tv_nsec >= 1000000000L) {
-        ts.tv_sec++;
-        ts.tv_nsec -= 1000000000L;
-    }
-    
+// Wait until deadline for a free slot and write one record. Takes no
+// ownership of payload.
+static int queue_put(MessageQueue *mq, const LayerMessage *msg, const MessageLayout *layout,
+                     const uint8_t *payload, size_t payload_len, int pool_index,
+                     const struct timespec *deadline) {
     // Wait for empty slot
-    if (sem_timedwait(&mq->empty_slots, &ts) != 0) {
+    if (sem_timedwait(&mq->empty_slots, deadline) != 0) {
         if (errno == ETIMEDOUT) {
             pthread_mutex_lock(&mq->mutex);
             mq->overflow_count++;
@@ -115,8 +343,7 @@ int message_queue_enqueue(MessageQueue *mq, const LayerMessage *msg, int timeout
     // Critical section
     pthread_mutex_lock(&mq->mutex);
     
-    mq->buffer[mq->write_index] = *msg;
-    mq->write_index = (mq->write_index + 1) % MESSAGE_QUEUE_SIZE;
+    ring_write_record(mq, msg, layout, payload, payload_len, pool_index);
     mq->count++;
     mq->enqueue_count++;
     
@@ -128,21 +355,90 @@ int message_queue_enqueue(MessageQueue *mq, const LayerMessage *msg, int timeout
     return 0;
 }
 
-// Dequeue message with timeout
-int message_queue_dequeue(MessageQueue *mq, LayerMessage *msg, int timeout_ms) {
+// Enqueue with the payload given by reference. payload must come from
+// message_payload_alloc() (or be NULL); the queue owns it from here on,
+// even if the enqueue fails. msg's own payload array is not read.
+int message_queue_enqueue_ref(MessageQueue *mq, const LayerMessage *msg,
+                              uint8_t *payload, size_t payload_len, int timeout_ms) {
+    const MessageLayout *layout = (mq && msg) ? message_layout(msg) : NULL;
+    int pool_index = payload ? payload_pool_index(payload) : -1;
+    
+    if (!layout || (payload && pool_index < 0) || payload_len > layout->payload_cap ||
+        (payload_len > 0 && !payload)) {
+        message_payload_release(payload);
+        return -1;
+    }
+    
+    struct timespec deadline;
+    deadline_after_ms(&deadline, timeout_ms);
+    
+    // Small payloads are cheaper inline than as a pool reference
+    if (payload_len <= MESSAGE_INLINE_PAYLOAD) {
+        int rc = queue_put(mq, msg, layout, payload, payload_len, -1, &deadline);
+        message_payload_release(payload);
+        return rc;
+    }
+    
+    int rc = queue_put(mq, msg, layout, NULL, payload_len, pool_index, &deadline);
+    if (rc != 0) {
+        message_payload_release(payload);
+    }
+    return rc;
+}
+
+// Enqueue message with timeout
+int message_queue_enqueue(MessageQueue *mq, const LayerMessage *msg, int timeout_ms) {
     if (!mq || !msg) {
         return -1;
     }
     
-    struct timespec ts;
-    clock_gettime(CLOCK_REALTIME, &ts);
-    ts.tv_sec += timeout_ms / 1000;
-    ts.tv_nsec += (timeout_ms % 1000) * 1000000L;
-    if (ts.tv_nsec >= 1000000000L) {
-        ts.tv_sec++;
-        ts.tv_nsec -= 1000000000L;
+    const MessageLayout *layout = message_layout(msg);
+    if (!layout) {
+        fprintf(stderr, "MessageQueue '%s': unknown message type %d\n",
+                mq->name, (int)msg->header.msg_type);
+        return -1;
     }
     
+    size_t payload_len = message_payload_len(msg, layout);
+    const uint8_t *payload = (const uint8_t *)msg + layout->payload_offset;
+    
+    // One deadline covers both the wait for a buffer and for a slot
+    struct timespec deadline;
+    deadline_after_ms(&deadline, timeout_ms);
+    
+    if (payload_len <= MESSAGE_INLINE_PAYLOAD) {
+        return queue_put(mq, msg, layout, payload, payload_len, -1, &deadline);
+    }
+    
+    // Bulk payload: copy only the used bytes into a pooled buffer
+    uint8_t *pooled = payload_pool_take(&deadline);
+    if (!pooled) {
+        pthread_mutex_lock(&mq->mutex);
+        mq->overflow_count++;
+        pthread_mutex_unlock(&mq->mutex);
+        return -1;
+    }
+    memcpy(pooled, payload, payload_len);
+    
+    int rc = queue_put(mq, msg, layout, NULL, payload_len, payload_pool_index(pooled), &deadline);
+    if (rc != 0) {
+        message_payload_release(pooled);
+    }
+    return rc;
+}
+
+// Dequeue with the payload by reference. *payload points either into a
+// pooled buffer or into msg itself; pass it to message_payload_release()
+// either way once done.
+int message_queue_dequeue_ref(MessageQueue *mq, LayerMessage *msg,
+                              uint8_t **payload, size_t *payload_len, int timeout_ms) {
+    if (!mq || !msg || !payload || !payload_len) {
+        return -1;
+    }
+    
+    struct timespec ts;
+    deadline_after_ms(&ts, timeout_ms);
+    
     // Wait for filled slot
     if (sem_timedwait(&mq->filled_slots, &ts) != 0) {
         return -1;
@@ -151,8 +447,7 @@ int message_queue_dequeue(MessageQueue *mq, LayerMessage *msg, int timeout_ms) {
     // Critical section
     pthread_mutex_lock(&mq->mutex);
     
-    *msg = mq->buffer[mq->read_index];
-    mq->read_index = (mq->read_index + 1) % MESSAGE_QUEUE_SIZE;
+    ring_read_record(mq, msg, payload, payload_len);
     mq->count--;
     mq->dequeue_count++;
     
@@ -164,6 +459,25 @@ int message_queue_dequeue(MessageQueue *mq, LayerMessage *msg, int timeout_ms) {
     return 0;
 }
 
+// Dequeue message with timeout
+int message_queue_dequeue(MessageQueue *mq, LayerMessage *msg, int timeout_ms) {
+    uint8_t *payload;
+    size_t payload_len;
+    
+    if (message_queue_dequeue_ref(mq, msg, &payload, &payload_len, timeout_ms) != 0) {
+        return -1;
+    }
+    
+    // Pooled payloads are copied into msg (used bytes only) and returned
+    if (payload_pool_index(payload) >= 0) {
+        const MessageLayout *layout = &message_layouts[msg->header.msg_type];
+        memcpy((uint8_t *)msg + layout->payload_offset, payload, payload_len);
+        message_payload_release(payload);
+    }
+    
+    return 0;
+}
+
 // Check if queue has messages
 bool message_queue_has_messages(MessageQueue *mq) {
     if (!mq) {
@@ -225,12 +539,13 @@ void print_all_message_queue_stats(void) {
         &mac_to_rrc_relay_queue
     };
     
-    for (int i = 0; i < 9; i++) {
+    for (int i = 0; i < MESSAGE_QUEUE_COUNT; i++) {
         MessageQueue *mq = queues[i];
         pthread_mutex_lock(&mq->mutex);
-        printf("%-20s | count:%2d | enq:%5u | deq:%5u | ovf:%3u\n",
+        printf("%-20s | count:%2d | enq:%5u | deq:%5u | ovf:%3u | avg:%4u B\n",
                mq->name, mq->count, mq->enqueue_count, 
-               mq->dequeue_count, mq->overflow_count);
+               mq->dequeue_count, mq->overflow_count,
+               mq->enqueue_count ? (unsigned)(mq->bytes_enqueued / mq->enqueue_count) : 0);
         pthread_mutex_unlock(&mq->mutex);
     }
     
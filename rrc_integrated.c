@@ -27,6 +27,10 @@
 #include <mqueue.h>
 #include <errno.h>
 #include <pthread.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+#include <limits.h>
 
 // System headers
 #include <sys/types.h>
@@ -34,6 +38,9 @@
 #include <sys/msg.h>
 #include <signal.h>
 
+#include "nc_wire.h"
+#include "rrc_posix/rrc_doorbell.h"
+
 // Compatibility constants
 #define PAYLOAD_SIZE_BYTES 2800
 #define NUM_PRIORITY 4
@@ -81,7 +88,8 @@ static uint8_t rrc_node_id = 1;
 // Message queue configuration
 #define MQ_MAX_MESSAGES 10
 #define MQ_MESSAGE_SIZE 8192  // Must be >= sizeof(IPC_Message), using 8192 for safety
-#define APP_RRC_QUEUE_SIZE 20
+#define APP_RRC_QUEUE_SIZE 32     // Power of two: ring positions wrap by mask
+#define APP_RRC_DEQUEUE_BATCH 8    // Packets the reactor takes per ring visit
 
 // ============================================================================
 // OLSR MESSAGE STRUCTURES
@@ -335,47 +343,16 @@ typedef struct {
 #define PER_POOR_THRESHOLD_PERCENT 50.0f
 #define LINK_TIMEOUT_SECONDS 30
 
-typedef struct {
-    float rssi_dbm;
-    float snr_db;
-    float per_percent;
-    uint32_t packet_count;
-    uint32_t last_update_time;
-} PHYMetrics;
-
 // ============================================================================
 // MANET WAVEFORM STRUCTURES
 // ============================================================================
 
-typedef struct {
-    uint16_t nodeID;
-    bool active;
-    uint64_t lastHeardTime;
-    uint8_t txSlots[10];
-    uint8_t rxSlots[10];
-    PHYMetrics phy;
-    uint8_t assignedNCSlot;
-} NeighborState;
-
 typedef struct {
     uint64_t ncStatusBitmap;
     uint64_t duGuUsageBitmap;
     uint32_t lastUpdateTime;
 } SlotStatus;
 
-typedef struct {
-    uint8_t type;
-    uint8_t length;
-    uint16_t sourceNodeID;
-    uint8_t sourceReservations;
-    uint8_t relayReservations;
-    uint64_t duGuIntentionMap;
-    uint64_t ncStatusBitmap;
-    uint32_t timeSync;
-    uint8_t myNCSlot;
-    uint8_t ttl;
-} PiggybackTLV;
-
 typedef struct {
     uint8_t activeNodes[MAX_MONITORED_NODES];
     int activeNodeCount;
@@ -388,32 +365,6 @@ typedef struct {
 // NC SLOT MESSAGE STRUCTURES
 // ============================================================================
 
-typedef struct {
-    uint8_t msg_type;
-    uint8_t vtime;
-    uint16_t msg_size;
-    uint32_t originator_addr;
-    uint8_t ttl;
-    uint8_t hop_count;
-    uint16_t msg_seq_num;
-    uint8_t payload[2048];
-    size_t payload_len;
-} OLSRMessage;
-
-typedef struct {
-    uint8_t myAssignedNCSlot;
-    OLSRMessage olsr_message;
-    bool has_olsr_message;
-    PiggybackTLV piggyback_tlv;
-    bool has_piggyback;
-    NeighborState my_neighbor_info;
-    bool has_neighbor_info;
-    uint32_t timestamp;
-    uint16_t sourceNodeID;
-    uint32_t sequence_number;
-    bool is_valid;
-} NCSlotMessage;
-
 #define NC_SLOT_QUEUE_SIZE 10
 typedef struct {
     NCSlotMessage messages[NC_SLOT_QUEUE_SIZE];
@@ -471,20 +422,43 @@ typedef struct {
     sem_t queue_mutex;
 } SharedQueueData;
 
+// Packet header carried in the descriptor ring; the payload stays in the arena
 typedef struct {
-    CustomApplicationPacket app_to_rrc_queue[APP_RRC_QUEUE_SIZE];
-    int app_to_rrc_front;
-    int app_to_rrc_back;
-    int app_to_rrc_count;
-    
-    CustomApplicationPacket rrc_to_app_queue[APP_RRC_QUEUE_SIZE];
-    int rrc_to_app_front;
-    int rrc_to_app_back;
-    int rrc_to_app_count;
-    
-    sem_t mutex;
+    uint8_t src_id;
+    uint8_t dest_id;
+    bool urgent;
+    RRC_DataType data_type;
+    TransmissionType transmission_type;
+    uint32_t data_size;
+    uint32_t sequence_number;
+    uint32_t timestamp;
+} AppPacketDescriptor;
+
+// One direction of the app-RRC channel. Producers serialize on a
+// process-shared mutex only long enough to fill a slot; the single
+// consumer reads descriptors and payloads in place without locking.
+// Descriptor i owns arena[i], so no separate allocator is needed.
+typedef struct {
+    uint32_t head;                  // Next position to publish (producers)
+    uint32_t tail;                  // Next position to consume (consumer)
+    uint32_t doorbell;              // Futex word, bumped on every publish
+    uint32_t waiters;               // Threads sleeping on doorbell
+    pthread_mutex_t producer_lock;
+    AppPacketDescriptor desc[APP_RRC_QUEUE_SIZE];
+    uint8_t arena[APP_RRC_QUEUE_SIZE][PAYLOAD_SIZE_BYTES];
+} AppPacketRing;
+
+typedef struct {
+    AppPacketRing app_to_rrc;       // Downlink: application → RRC
+    AppPacketRing rrc_to_app;       // Uplink: RRC → application
 } APP_RRC_SharedMemory;
 
+// Consumer view of a queued packet, valid until it is released
+typedef struct {
+    const AppPacketDescriptor *desc;
+    const uint8_t *payload;
+} AppPacketView;
+
 typedef struct {
     RRC_SystemState current_rrc_state;
     RRC_ConnectionContext connection_pool[RRC_CONNECTION_POOL_SIZE];
@@ -617,11 +591,32 @@ static int reservation_count = 0;
 
 // Thread control
 static volatile bool system_running = true;
-static pthread_t olsr_handler_thread;
-static pthread_t tdma_handler_thread;
-static pthread_t app_handler_thread;
-static pthread_t phy_handler_thread;
-static pthread_t periodic_mgmt_thread;
+static pthread_t reactor_thread;
+static pthread_t app_doorbell_thread;
+static bool reactor_started = false;
+static bool app_doorbell_started = false;
+
+// Reactor: epoll over the inbound MQs, a wakeup eventfd and a 1 s timerfd
+#define RRC_REACTOR_MAX_EVENTS 8
+#define RRC_REACTOR_DRAIN_BUDGET 32   // Messages per source per wakeup
+
+enum {
+    RRC_REACTOR_OLSR = 1,
+    RRC_REACTOR_TDMA,
+    RRC_REACTOR_PHY,
+    RRC_REACTOR_WAKE,
+    RRC_REACTOR_TIMER
+};
+
+static int reactor_epoll_fd = -1;
+static int reactor_wake_fd = -1;
+static int reactor_timer_fd = -1;
+
+static struct {
+    uint64_t wakeups;
+    uint64_t messages;
+    uint64_t app_batches;
+} reactor_stats = {0};
 
 // Next hop tracking
 typedef struct {
@@ -640,6 +635,7 @@ static int next_hop_stats_count = 0;
 
 // IPC initialization
 int rrc_ipc_init(void);
+static int app_ring_init(AppPacketRing *ring);
 void rrc_ipc_cleanup(void);
 
 // Message queue operations
@@ -651,8 +647,11 @@ int rrc_send_to_phy(const IPC_Message *msg);
 int rrc_receive_from_phy(IPC_Message *msg, bool blocking);
 
 // Application communication (shared memory)
-int rrc_receive_from_app(CustomApplicationPacket *packet, bool blocking);
+int rrc_receive_from_app_batch(AppPacketView *views, int max);
+void rrc_release_app_batch(int count);
 int rrc_send_to_app(const CustomApplicationPacket *packet);
+int app_send_to_rrc(const CustomApplicationPacket *packet);
+int app_receive_from_rrc(CustomApplicationPacket *packet, int timeout_ms);
 bool app_to_rrc_queue_is_empty(void);
 bool app_to_rrc_queue_is_full(void);
 bool rrc_to_app_queue_is_empty(void);
@@ -680,6 +679,8 @@ void rrc_update_neighbor(uint16_t nodeID, const NeighborState *state);
 
 // IPC-based external API wrappers
 uint8_t ipc_olsr_get_next_hop(uint8_t destination_node_id);
+bool rrc_route_cache_lookup(uint8_t dest_node, uint8_t *next_hop);
+int ipc_olsr_request_route(uint8_t destination_node_id);
 void ipc_olsr_trigger_route_discovery(uint8_t destination_node_id);
 bool ipc_tdma_check_slot_available(uint8_t next_hop_node, int priority);
 bool ipc_tdma_request_nc_slot(const uint8_t *payload, size_t payload_len, uint8_t *assigned_slot);
@@ -687,15 +688,21 @@ void ipc_phy_get_link_metrics(uint8_t node_id, float *rssi, float *snr, float *p
 bool ipc_phy_is_link_active(uint8_t node_id);
 uint32_t ipc_phy_get_packet_count(uint8_t node_id);
 
-// Message processing threads
-void *rrc_olsr_message_handler(void *arg);
-void *rrc_tdma_message_handler(void *arg);
-void *rrc_app_message_handler(void *arg);
-void *rrc_phy_message_handler(void *arg);
-void *rrc_periodic_management_thread(void *arg);
+// Message dispatch (all run on the reactor thread)
+void rrc_dispatch_olsr_message(const IPC_Message *msg);
+void rrc_dispatch_tdma_message(const IPC_Message *msg);
+void rrc_dispatch_app_packet(const AppPacketDescriptor *app_pkt, const uint8_t *payload);
+void rrc_dispatch_phy_message(const IPC_Message *msg);
+void rrc_periodic_tick(uint64_t cycle_count);
+
+// Reactor
+int rrc_reactor_init(void);
+void *rrc_reactor_thread(void *arg);
+void *rrc_app_doorbell_thread(void *arg);
+void rrc_reactor_wakeup(void);
 
 // Thread control
-void rrc_start_threads(void);
+int rrc_start_threads(void);
 void rrc_stop_threads(void);
 void rrc_signal_handler(int signum);
 
@@ -761,6 +768,7 @@ void rrc_update_connection_activity(uint8_t dest_node);
 int rrc_handle_power_on(void);
 int rrc_handle_power_off(void);
 int rrc_handle_data_request(uint8_t dest_node, MessagePriority qos);
+int rrc_setup_route_answered(RRC_ConnectionContext *ctx, uint8_t next_hop);
 int rrc_handle_route_and_slots_allocated(uint8_t dest_node, uint8_t next_hop);
 int rrc_handle_route_change(uint8_t dest_node, uint8_t new_next_hop);
 int rrc_handle_reconfig_success(uint8_t dest_node, uint8_t new_next_hop);
@@ -801,6 +809,7 @@ void rrc_update_piggyback_ttl(void);
 
 // NC Frame Building
 size_t rrc_build_nc_frame(uint8_t *buffer, size_t maxLen);
+void rrc_nc_frame_transmitted(void);
 
 // Relay Handling
 bool rrc_should_relay(struct frame *frame);
@@ -930,43 +939,88 @@ bool rrc_is_queue_full(struct queue *q) {
 // IPC-BASED EXTERNAL API WRAPPERS
 // ============================================================================
 
-uint8_t ipc_olsr_get_next_hop(uint8_t destination_node_id) {
-    if (!ipc_initialized || mq_rrc_to_olsr == -1 || mq_olsr_to_rrc == -1) {
-        printf("RRC-OLSR: IPC not initialized\n");
-        return 0xFF;
-    }
-    
-    // Send route request
+// Next hops learned from OLSR route updates, by destination. Nothing on
+// the reactor waits for OLSR: a miss sends a request, held off per
+// destination while it is unanswered, and the answer lands here through
+// rrc_dispatch_olsr_message(). Entries older than RRC_ROUTE_CACHE_TTL_SEC
+// still answer but are refreshed.
+#define RRC_ROUTE_REQUEST_HOLDOFF_SEC 1
+#define RRC_ROUTE_CACHE_TTL_SEC 10
+
+typedef struct {
+    uint8_t next_hop;          // 0xFF: OLSR has no route
+    bool valid;
+    time_t learned_at;
+    time_t requested_at;       // Unanswered request sent at, 0 if none
+} RRC_RouteCacheEntry;
+
+static RRC_RouteCacheEntry route_cache[256];
+static uint32_t route_request_seq = 0;
+
+// Relay frames wait for their route in the same table as downlink packets
+static bool rrc_park_relay_frame(const struct frame *frame);
+
+static void rrc_route_cache_store(uint8_t dest_node, uint8_t next_hop) {
+    route_cache[dest_node].next_hop = next_hop;
+    route_cache[dest_node].valid = true;
+    route_cache[dest_node].learned_at = time(NULL);
+    route_cache[dest_node].requested_at = 0;
+}
+
+// Send a route request for dest now, whatever is already out
+static int rrc_send_route_request(uint8_t destination_node_id) {
+    if (!ipc_initialized || mq_rrc_to_olsr == -1) return -1;
+
+    RRC_RouteCacheEntry *entry = &route_cache[destination_node_id];
     IPC_Message request;
     request.route_request.type = MSG_RRC_ROUTE_REQUEST;
     request.route_request.dest_node = destination_node_id;
-    request.route_request.request_id = (uint32_t)time(NULL);
-    
+    request.route_request.request_id = ++route_request_seq;
     if (rrc_send_to_olsr(&request) < 0) {
         printf("RRC-OLSR: Failed to send route request\n");
-        return 0xFF;
+        return -1;
     }
-    
-    // Wait for response (with timeout)
-    struct timespec timeout;
-    clock_gettime(CLOCK_REALTIME, &timeout);
-    timeout.tv_sec += 2; // 2 second timeout
-    
-    IPC_Message response;
-    ssize_t received = mq_timedreceive(mq_olsr_to_rrc, (char*)&response, 
-                                       sizeof(response), NULL, &timeout);
-    
-    if (received > 0 && response.type == MSG_OLSR_ROUTE_UPDATE) {
-        if (response.route_response.route_available) {
-            printf("RRC-OLSR: Route to node %u via next hop %u (hops=%u)\n",
-                   destination_node_id, response.route_response.next_hop,
-                   response.route_response.hop_count);
-            return response.route_response.next_hop;
-        }
+    entry->requested_at = time(NULL);
+    return 0;
+}
+
+// Ask OLSR for a route without waiting. Returns 0 if a request is out
+// (sent now, or an unanswered one within the holdoff), -1 if it could not
+// be sent.
+int ipc_olsr_request_route(uint8_t destination_node_id) {
+    RRC_RouteCacheEntry *entry = &route_cache[destination_node_id];
+    if (entry->requested_at != 0 &&
+        time(NULL) - entry->requested_at < RRC_ROUTE_REQUEST_HOLDOFF_SEC) {
+        return 0;
     }
-    
-    printf("RRC-OLSR: No route available to node %u\n", destination_node_id);
-    return 0xFF;
+    return rrc_send_route_request(destination_node_id);
+}
+
+// Cached next hop toward dest_node without requesting on a miss; a stale
+// entry is returned and refreshed in the background
+static bool rrc_route_cache_peek(uint8_t dest_node, uint8_t *next_hop) {
+    RRC_RouteCacheEntry *entry = &route_cache[dest_node];
+    if (!entry->valid) return false;
+    if (time(NULL) - entry->learned_at >= RRC_ROUTE_CACHE_TTL_SEC) {
+        ipc_olsr_request_route(dest_node);
+    }
+    *next_hop = entry->next_hop;
+    return true;
+}
+
+// Cached next hop toward dest_node (0xFF if unreachable); false until OLSR
+// answered
+bool rrc_route_cache_lookup(uint8_t dest_node, uint8_t *next_hop) {
+    if (rrc_route_cache_peek(dest_node, next_hop)) return true;
+    ipc_olsr_request_route(dest_node);
+    return false;
+}
+
+// Non-blocking: the cached next hop, or 0xFF while OLSR has not answered yet
+uint8_t ipc_olsr_get_next_hop(uint8_t destination_node_id) {
+    uint8_t next_hop;
+    if (!rrc_route_cache_lookup(destination_node_id, &next_hop)) return 0xFF;
+    return next_hop;
 }
 
 void ipc_olsr_trigger_route_discovery(uint8_t destination_node_id) {
@@ -1220,17 +1274,9 @@ int rrc_ipc_init(void) {
         goto cleanup;
     }
     
-    // Initialize app queues
-    memset(app_rrc_shm, 0, sizeof(APP_RRC_SharedMemory));
-    app_rrc_shm->app_to_rrc_front = 0;
-    app_rrc_shm->app_to_rrc_back = 0;
-    app_rrc_shm->app_to_rrc_count = 0;
-    app_rrc_shm->rrc_to_app_front = 0;
-    app_rrc_shm->rrc_to_app_back = 0;
-    app_rrc_shm->rrc_to_app_count = 0;
-    
-    if (sem_init(&app_rrc_shm->mutex, 1, 1) == -1) {
-        perror("sem_init(app_rrc_mutex)");
+    // Initialize app rings
+    if (app_ring_init(&app_rrc_shm->app_to_rrc) != 0 ||
+        app_ring_init(&app_rrc_shm->rrc_to_app) != 0) {
         goto cleanup;
     }
     
@@ -1287,7 +1333,8 @@ void rrc_ipc_cleanup(void) {
     }
     
     if (app_rrc_shm != NULL) {
-        sem_destroy(&app_rrc_shm->mutex);
+        pthread_mutex_destroy(&app_rrc_shm->app_to_rrc.producer_lock);
+        pthread_mutex_destroy(&app_rrc_shm->rrc_to_app.producer_lock);
         munmap(app_rrc_shm, sizeof(APP_RRC_SharedMemory));
         app_rrc_shm = NULL;
     }
@@ -1460,123 +1507,195 @@ int rrc_receive_from_phy(IPC_Message *msg, bool blocking) {
 // APP-RRC SHARED MEMORY OPERATIONS
 // ============================================================================
 
-int rrc_receive_from_app(CustomApplicationPacket *packet, bool blocking) {
-    if (app_rrc_shm == NULL || packet == NULL) {
+static int app_ring_init(AppPacketRing *ring) {
+    memset(ring, 0, sizeof(*ring));
+
+    pthread_mutexattr_t attr;
+    pthread_mutexattr_init(&attr);
+    pthread_mutexattr_setpshared(&attr, PTHREAD_PROCESS_SHARED);
+    int rc = pthread_mutex_init(&ring->producer_lock, &attr);
+    pthread_mutexattr_destroy(&attr);
+    if (rc != 0) {
+        printf("RRC: ERROR - pthread_mutex_init(app ring): %s\n", strerror(rc));
         return -1;
     }
-    
-    if (blocking) {
-        sem_wait(&app_rrc_shm->mutex);
-    } else {
-        struct timespec timeout;
-        clock_gettime(CLOCK_REALTIME, &timeout);
-        timeout.tv_nsec += 1000000; // 1ms timeout
-        if (timeout.tv_nsec >= 1000000000) {
-            timeout.tv_sec++;
-            timeout.tv_nsec -= 1000000000;
+    return 0;
+}
+
+static uint32_t app_ring_count(AppPacketRing *ring) {
+    return __atomic_load_n(&ring->head, __ATOMIC_SEQ_CST) -
+           __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
+}
+
+// Wake anyone sleeping on the doorbell
+static void app_ring_ring_doorbell(AppPacketRing *ring) {
+    rrc_doorbell_ring(&ring->doorbell, &ring->waiters);
+}
+
+// Sleep until the doorbell moves past seen or timeout_ms passes (< 0: no timeout)
+static void app_ring_wait_doorbell(AppPacketRing *ring, uint32_t seen, int timeout_ms) {
+    struct timespec ts;
+    struct timespec *timeout = NULL;
+    if (timeout_ms >= 0) {
+        ts.tv_sec = timeout_ms / 1000;
+        ts.tv_nsec = (timeout_ms % 1000) * 1000000L;
+        timeout = &ts;
+    }
+
+    rrc_doorbell_wait(&ring->doorbell, &ring->waiters, seen, timeout);
+}
+
+// Copy one packet in: the descriptor plus only data_size payload bytes
+static int app_ring_push(AppPacketRing *ring, const CustomApplicationPacket *packet) {
+    size_t len = packet->data_size < PAYLOAD_SIZE_BYTES ? packet->data_size : PAYLOAD_SIZE_BYTES;
+
+    pthread_mutex_lock(&ring->producer_lock);
+
+    uint32_t head = ring->head;
+    if (head - __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE) >= APP_RRC_QUEUE_SIZE) {
+        pthread_mutex_unlock(&ring->producer_lock);
+        return -1;
+    }
+
+    uint32_t pos = head & (APP_RRC_QUEUE_SIZE - 1);
+    AppPacketDescriptor *desc = &ring->desc[pos];
+    desc->src_id = packet->src_id;
+    desc->dest_id = packet->dest_id;
+    desc->urgent = packet->urgent;
+    desc->data_type = packet->data_type;
+    desc->transmission_type = packet->transmission_type;
+    desc->data_size = (uint32_t)len;
+    desc->sequence_number = packet->sequence_number;
+    desc->timestamp = packet->timestamp;
+    memcpy(ring->arena[pos], packet->data, len);
+
+    __atomic_store_n(&ring->head, head + 1, __ATOMIC_SEQ_CST);
+    pthread_mutex_unlock(&ring->producer_lock);
+
+    app_ring_ring_doorbell(ring);
+    return 0;
+}
+
+// Up to max queued packets, oldest first, read in place (single consumer)
+static int app_ring_peek(AppPacketRing *ring, AppPacketView *views, int max) {
+    uint32_t tail = ring->tail;
+    uint32_t avail = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE) - tail;
+    int n = avail < (uint32_t)max ? (int)avail : max;
+
+    for (int i = 0; i < n; i++) {
+        uint32_t pos = (tail + i) & (APP_RRC_QUEUE_SIZE - 1);
+        views[i].desc = &ring->desc[pos];
+        views[i].payload = ring->arena[pos];
+    }
+    return n;
+}
+
+// Hand count peeked slots back to the producers
+static void app_ring_release(AppPacketRing *ring, int count) {
+    __atomic_store_n(&ring->tail, ring->tail + (uint32_t)count, __ATOMIC_RELEASE);
+}
+
+static void app_ring_copy_out(const AppPacketView *view, CustomApplicationPacket *packet) {
+    packet->src_id = view->desc->src_id;
+    packet->dest_id = view->desc->dest_id;
+    packet->urgent = view->desc->urgent;
+    packet->data_type = view->desc->data_type;
+    packet->transmission_type = view->desc->transmission_type;
+    packet->data_size = view->desc->data_size;
+    packet->sequence_number = view->desc->sequence_number;
+    packet->timestamp = view->desc->timestamp;
+    memcpy(packet->data, view->payload, view->desc->data_size);
+}
+
+// Single-packet receive with a copy, for the app side of rrc_to_app
+static int app_ring_receive(AppPacketRing *ring, CustomApplicationPacket *packet, int timeout_ms) {
+    AppPacketView view;
+
+    uint32_t seen = __atomic_load_n(&ring->doorbell, __ATOMIC_SEQ_CST);
+    if (app_ring_peek(ring, &view, 1) == 0) {
+        if (timeout_ms == 0) {
+            return -1;
         }
-        
-        if (sem_timedwait(&app_rrc_shm->mutex, &timeout) == -1) {
+        app_ring_wait_doorbell(ring, seen, timeout_ms);
+        if (app_ring_peek(ring, &view, 1) == 0) {
             return -1;
         }
     }
-    
-    // Check if queue is empty
-    if (app_rrc_shm->app_to_rrc_count == 0) {
-        sem_post(&app_rrc_shm->mutex);
-        return -1;
-    }
-    
-    // Dequeue
-    *packet = app_rrc_shm->app_to_rrc_queue[app_rrc_shm->app_to_rrc_front];
-    app_rrc_shm->app_to_rrc_front = (app_rrc_shm->app_to_rrc_front + 1) % APP_RRC_QUEUE_SIZE;
-    app_rrc_shm->app_to_rrc_count--;
-    
-    sem_post(&app_rrc_shm->mutex);
+
+    app_ring_copy_out(&view, packet);
+    app_ring_release(ring, 1);
     return 0;
 }
 
+// Zero-copy batch dequeue: views stay valid until rrc_release_app_batch()
+int rrc_receive_from_app_batch(AppPacketView *views, int max) {
+    if (app_rrc_shm == NULL || views == NULL) {
+        return 0;
+    }
+    return app_ring_peek(&app_rrc_shm->app_to_rrc, views, max);
+}
+
+void rrc_release_app_batch(int count) {
+    if (app_rrc_shm != NULL && count > 0) {
+        app_ring_release(&app_rrc_shm->app_to_rrc, count);
+    }
+}
+
 int rrc_send_to_app(const CustomApplicationPacket *packet) {
     if (app_rrc_shm == NULL || packet == NULL) {
         return -1;
     }
-    
-    sem_wait(&app_rrc_shm->mutex);
-    
-    // Check if queue is full
-    if (app_rrc_shm->rrc_to_app_count >= APP_RRC_QUEUE_SIZE) {
-        sem_post(&app_rrc_shm->mutex);
+
+    if (app_ring_push(&app_rrc_shm->rrc_to_app, packet) != 0) {
         printf("RRC-APP: rrc_to_app queue full, packet dropped\n");
         return -1;
     }
-    
-    // Enqueue
-    app_rrc_shm->rrc_to_app_queue[app_rrc_shm->rrc_to_app_back] = *packet;
-    app_rrc_shm->rrc_to_app_back = (app_rrc_shm->rrc_to_app_back + 1) % APP_RRC_QUEUE_SIZE;
-    app_rrc_shm->rrc_to_app_count++;
-    
-    sem_post(&app_rrc_shm->mutex);
     return 0;
 }
 
+// Application side of the channel
+int app_send_to_rrc(const CustomApplicationPacket *packet) {
+    if (app_rrc_shm == NULL || packet == NULL) {
+        return -1;
+    }
+    return app_ring_push(&app_rrc_shm->app_to_rrc, packet);
+}
+
+int app_receive_from_rrc(CustomApplicationPacket *packet, int timeout_ms) {
+    if (app_rrc_shm == NULL || packet == NULL) {
+        return -1;
+    }
+    return app_ring_receive(&app_rrc_shm->rrc_to_app, packet, timeout_ms);
+}
+
 bool app_to_rrc_queue_is_empty(void) {
     if (app_rrc_shm == NULL) return true;
-    
-    sem_wait(&app_rrc_shm->mutex);
-    bool empty = (app_rrc_shm->app_to_rrc_count == 0);
-    sem_post(&app_rrc_shm->mutex);
-    
-    return empty;
+    return app_ring_count(&app_rrc_shm->app_to_rrc) == 0;
 }
 
 bool app_to_rrc_queue_is_full(void) {
     if (app_rrc_shm == NULL) return false;
-    
-    sem_wait(&app_rrc_shm->mutex);
-    bool full = (app_rrc_shm->app_to_rrc_count >= APP_RRC_QUEUE_SIZE);
-    sem_post(&app_rrc_shm->mutex);
-    
-    return full;
+    return app_ring_count(&app_rrc_shm->app_to_rrc) >= APP_RRC_QUEUE_SIZE;
 }
 
 bool rrc_to_app_queue_is_empty(void) {
     if (app_rrc_shm == NULL) return true;
-    
-    sem_wait(&app_rrc_shm->mutex);
-    bool empty = (app_rrc_shm->rrc_to_app_count == 0);
-    sem_post(&app_rrc_shm->mutex);
-    
-    return empty;
+    return app_ring_count(&app_rrc_shm->rrc_to_app) == 0;
 }
 
 bool rrc_to_app_queue_is_full(void) {
     if (app_rrc_shm == NULL) return false;
-    
-    sem_wait(&app_rrc_shm->mutex);
-    bool full = (app_rrc_shm->rrc_to_app_count >= APP_RRC_QUEUE_SIZE);
-    sem_post(&app_rrc_shm->mutex);
-    
-    return full;
+    return app_ring_count(&app_rrc_shm->rrc_to_app) >= APP_RRC_QUEUE_SIZE;
 }
 
 int app_to_rrc_queue_count(void) {
     if (app_rrc_shm == NULL) return 0;
-    
-    sem_wait(&app_rrc_shm->mutex);
-    int count = app_rrc_shm->app_to_rrc_count;
-    sem_post(&app_rrc_shm->mutex);
-    
-    return count;
+    return (int)app_ring_count(&app_rrc_shm->app_to_rrc);
 }
 
 int rrc_to_app_queue_count(void) {
     if (app_rrc_shm == NULL) return 0;
-    
-    sem_wait(&app_rrc_shm->mutex);
-    int count = app_rrc_shm->rrc_to_app_count;
-    sem_post(&app_rrc_shm->mutex);
-    
-    return count;
+    return (int)app_ring_count(&app_rrc_shm->rrc_to_app);
 }
 
 void print_app_rrc_queue_stats(void) {
@@ -1584,14 +1703,10 @@ void print_app_rrc_queue_stats(void) {
         printf("App-RRC shared memory not initialized\n");
         return;
     }
-    
-    sem_wait(&app_rrc_shm->mutex);
+
     printf("\n=== App-RRC Queue Statistics ===\n");
-    printf("App→RRC: %d/%d messages\n", 
-           app_rrc_shm->app_to_rrc_count, APP_RRC_QUEUE_SIZE);
-    printf("RRC→App: %d/%d messages\n",
-           app_rrc_shm->rrc_to_app_count, APP_RRC_QUEUE_SIZE);
-    sem_post(&app_rrc_shm->mutex);
+    printf("App→RRC: %d/%d messages\n", app_to_rrc_queue_count(), APP_RRC_QUEUE_SIZE);
+    printf("RRC→App: %d/%d messages\n", rrc_to_app_queue_count(), APP_RRC_QUEUE_SIZE);
 }
 
 // ============================================================================
@@ -2021,11 +2136,13 @@ void rrc_build_piggyback_tlv(PiggybackTLV *tlv) {
     printf("RRC: Built piggyback TLV for NC slot %u\n", tlv->myNCSlot);
 }
 
+// Piggyback TLV out of a whole NC frame as rrc_build_nc_frame() writes it
 bool rrc_parse_piggyback_tlv(const uint8_t *data, size_t len, PiggybackTLV *tlv) {
-    if (!data || !tlv || len < sizeof(PiggybackTLV)) return false;
-    if (data[0] != 0x01) return false;
+    if (!data || !tlv) return false;
     
-    memcpy(tlv, data, sizeof(PiggybackTLV));
+    NCSlotMessage msg;
+    if (!nc_slot_message_decode(data, len, &msg) || !msg.has_piggyback) return false;
+    *tlv = msg.piggyback_tlv;
     
     NeighborState *neighbor = rrc_create_neighbor_state(tlv->sourceNodeID);
     if (neighbor) {
@@ -2051,17 +2168,43 @@ void rrc_update_piggyback_ttl(void) {
     }
 }
 
+// Encoding of the last NC frame handed to TDMA but not yet confirmed as sent
+static NCWireBudget nc_frame_pending;
+static bool nc_frame_pending_valid = false;
+
 size_t rrc_build_nc_frame(uint8_t *buffer, size_t maxLen) {
-    if (!buffer || maxLen < sizeof(PiggybackTLV)) return 0;
+    if (!buffer) return 0;
+    
+    NCSlotMessage msg;
+    build_nc_slot_message(&msg, rrc_neighbors.nc_manager.myAssignedNCSlot);
     
     PiggybackTLV tlv;
     rrc_build_piggyback_tlv(&tlv);
+    add_piggyback_to_nc_message(&msg, &tlv);
+    
+    NCWireBudget budget;
+    size_t used = nc_slot_message_encode(&msg, buffer, maxLen, &budget);
+    if (used == 0 || budget.sections_dropped) {
+        printf("RRC: NC frame does not fit in %zu bytes\n", maxLen);
+        nc_frame_pending_valid = false;
+        return 0;
+    }
     
-    memcpy(buffer, &tlv, sizeof(PiggybackTLV));
+    // Held until the PHY confirms the frame, see rrc_nc_frame_transmitted()
+    nc_frame_pending = budget;
+    nc_frame_pending_valid = true;
     
-    printf("RRC: Built NC frame with piggyback TLV (%zu bytes)\n", sizeof(PiggybackTLV));
+    printf("RRC: Built NC frame with piggyback TLV (%zu bytes, %s bitmaps)\n",
+           used, budget.piggyback_delta ? "delta" : "raw");
     
-    return sizeof(PiggybackTLV);
+    return used;
+}
+
+// TDMA sent the last built NC frame: later frames may delta against it
+void rrc_nc_frame_transmitted(void) {
+    if (!nc_frame_pending_valid) return;
+    nc_wire_commit_tx(&nc_frame_pending);
+    nc_frame_pending_valid = false;
 }
 
 // ============================================================================
@@ -2223,12 +2366,15 @@ void init_relay_queue(void) {
     printf("RRC: Relay queue initialized\n");
 }
 
+// True unless the destination is known to be unreachable; a frame whose
+// route OLSR has not answered yet is parked by enqueue_relay_packet()
 bool should_relay_packet(struct frame *frame) {
     if (!frame) return false;
     if (frame->TTL <= 0) return false;
     if (frame->dest_add == rrc_node_id) return false;
     
-    uint8_t next_hop = ipc_olsr_get_next_hop(frame->dest_add);
+    uint8_t next_hop;
+    if (!rrc_route_cache_lookup(frame->dest_add, &next_hop)) return true;
     if (next_hop == 0 || next_hop == 0xFF) return false;
     
     return true;
@@ -2239,15 +2385,12 @@ bool is_packet_for_self(struct frame *frame) {
     return (frame->dest_add == rrc_node_id);
 }
 
-bool enqueue_relay_packet(struct frame *relay_frame) {
-    if (!relay_frame || !should_relay_packet(relay_frame)) {
-        if (relay_frame && relay_frame->TTL <= 0) {
-            relay_stats.relay_packets_dropped_ttl++;
-        }
+// Route known for a relay frame: queue it for the next hop, or drop it
+static bool rrc_relay_frame_routed(struct frame *relay_frame, uint8_t new_next_hop) {
+    if (new_next_hop == 0 || new_next_hop == 0xFF) {
+        printf("RRC: No route to %u, dropped relay packet\n", relay_frame->dest_add);
         return false;
     }
-    
-    uint8_t new_next_hop = ipc_olsr_get_next_hop(relay_frame->dest_add);
     relay_frame->next_hop_add = new_next_hop;
     relay_frame->TTL--;
     
@@ -2265,6 +2408,21 @@ bool enqueue_relay_packet(struct frame *relay_frame) {
     }
 }
 
+bool enqueue_relay_packet(struct frame *relay_frame) {
+    if (!relay_frame || !should_relay_packet(relay_frame)) {
+        if (relay_frame && relay_frame->TTL <= 0) {
+            relay_stats.relay_packets_dropped_ttl++;
+        }
+        return false;
+    }
+    
+    uint8_t new_next_hop;
+    if (!rrc_route_cache_peek(relay_frame->dest_add, &new_next_hop)) {
+        return rrc_park_relay_frame(relay_frame);
+    }
+    return rrc_relay_frame_routed(relay_frame, new_next_hop);
+}
+
 struct frame dequeue_relay_packet(void) {
     if (!rrc_is_queue_empty(&shared_queues->rrc_relay_queue)) {
         relay_stats.relay_packets_dequeued++;
@@ -2515,10 +2673,14 @@ void rrc_process_nc_reservations_by_priority(void) {
 
 int rrc_request_nc_reservation_multi_relay(uint16_t dest_node, uint8_t traffic_type,
                                            bool urgent, uint32_t packet_count) {
-    uint8_t next_hop = ipc_olsr_get_next_hop(dest_node);
+    uint8_t next_hop = 0xFF;
     uint8_t hop_count = 1;
     
-    if (next_hop == 0 || next_hop == 0xFF) {
+    if (!rrc_route_cache_lookup(dest_node, &next_hop)) {
+        // Requested; counted as far away until OLSR answers
+        printf("RRC PRIORITY: Route to %u pending\n", dest_node);
+        hop_count = 255;
+    } else if (next_hop == 0 || next_hop == 0xFF) {
         printf("RRC PRIORITY: No route to %u, triggering discovery\n", dest_node);
         ipc_olsr_trigger_route_discovery(dest_node);
         hop_count = 255;
@@ -3058,16 +3220,26 @@ int rrc_handle_data_request(uint8_t dest_node, MessagePriority qos) {
     
     rrc_transition_to_state(RRC_STATE_CONNECTION_SETUP, dest_node);
     
-    uint8_t next_hop = ipc_olsr_get_next_hop(dest_node);
+    uint8_t next_hop;
+    if (!rrc_route_cache_lookup(dest_node, &next_hop)) {
+        // rrc_setup_route_answered() picks it up from the route update
+        printf("RRC: Connection setup for node %u waiting for a route\n", dest_node);
+        return 0;
+    }
+    return rrc_setup_route_answered(ctx, next_hop);
+}
+
+// Route for a connection in setup, from the cache or a route update
+int rrc_setup_route_answered(RRC_ConnectionContext *ctx, uint8_t next_hop) {
     if (next_hop == 0 || next_hop == 0xFF) {
-        printf("RRC: ERROR - No route to destination %u\n", dest_node);
+        printf("RRC: ERROR - No route to destination %u\n", ctx->dest_node_id);
         rrc_fsm_stats.setup_failures++;
         return -1;
     }
     
     ctx->next_hop_id = next_hop;
     
-    printf("RRC: Connection setup initiated for node %u via %u\n", dest_node, next_hop);
+    printf("RRC: Connection setup initiated for node %u via %u\n", ctx->dest_node_id, next_hop);
     return 0;
 }
 
@@ -3179,327 +3351,608 @@ void print_rrc_fsm_stats(void) {
 }
 
 // ============================================================================
-// MESSAGE HANDLER THREADS
+// MESSAGE DISPATCH
 // ============================================================================
 
-// OLSR Message Handler Thread
-void *rrc_olsr_message_handler(void *arg) {
-    printf("RRC: OLSR message handler thread started\n");
-    
-    while (system_running) {
-        IPC_Message msg;
-        
-        // Non-blocking receive with short timeout
-        if (rrc_receive_from_olsr(&msg, false) > 0) {
-            switch (msg.type) {
-                case MSG_OLSR_ROUTE_UPDATE:
-                    printf("RRC-OLSR: Received route update for node %u → next hop %u\n",
-                           msg.route_response.dest_node, msg.route_response.next_hop);
-                    
-                    // Check if we need to reconfigure any existing connections
-                    RRC_ConnectionContext *ctx = rrc_get_connection_context(msg.route_response.dest_node);
-                    if (ctx && ctx->next_hop_id != msg.route_response.next_hop) {
-                        printf("RRC-OLSR: Route change detected, triggering reconfiguration\n");
-                        rrc_handle_route_change(msg.route_response.dest_node, msg.route_response.next_hop);
-                    }
-                    break;
-                    
-                case MSG_OLSR_MESSAGE:
-                    printf("RRC-OLSR: Received OLSR protocol message from originator %u\n",
-                           msg.olsr_msg.originator);
-                    
-                    // Build NC slot message with OLSR content
-                    NCSlotMessage nc_msg;
-                    build_nc_slot_message(&nc_msg, rrc_get_my_nc_slot());
-                    
-                    OLSRMessage olsr_wrapped;
-                    olsr_wrapped.msg_type = msg.olsr_msg.msg_type;
-                    olsr_wrapped.originator_addr = msg.olsr_msg.originator;
-                    olsr_wrapped.ttl = msg.olsr_msg.ttl;
-                    olsr_wrapped.hop_count = msg.olsr_msg.hop_count;
-                    
-                    add_olsr_to_nc_message(&nc_msg, &olsr_wrapped);
-                    
-                    // Add piggyback if available
-                    PiggybackTLV piggyback;
-                    rrc_build_piggyback_tlv(&piggyback);
-                    add_piggyback_to_nc_message(&nc_msg, &piggyback);
-                    
-                    // Enqueue to NC slot queue for TDMA transmission
-                    if (nc_slot_queue_enqueue(&nc_msg)) {
-                        printf("RRC-OLSR: OLSR message queued for NC slot transmission\n");
-                    }
-                    break;
-                    
-                default:
-                    printf("RRC-OLSR: Unknown message type %d\n", msg.type);
-                    break;
+// Downlink packets and relay frames waiting for an OLSR route answer. The
+// reactor never blocks on OLSR for them: the packet is parked, the request
+// sent, and the answer completes it in rrc_dispatch_olsr_message().
+#define RRC_ROUTE_PENDING_MAX 16
+#define RRC_ROUTE_PENDING_TIMEOUT_SEC 2
+
+typedef struct {
+    bool in_use;
+    bool is_relay;             // frame is set, not pkt
+    uint8_t dest_id;
+    uint32_t order;            // Parking order, so a destination's packets keep their sequence
+    time_t deadline;
+    union {
+        CustomApplicationPacket pkt;
+        struct frame frame;
+    };
+} RRC_PendingRoute;
+
+static RRC_PendingRoute route_pending[RRC_ROUTE_PENDING_MAX];
+static uint32_t route_pending_order = 0;
+
+static void rrc_complete_pending_routes(uint8_t dest, uint8_t next_hop);
+
+// OLSR message (route updates, OLSR control traffic for the NC slot)
+void rrc_dispatch_olsr_message(const IPC_Message *msg) {
+    switch (msg->type) {
+        case MSG_OLSR_ROUTE_UPDATE: {
+            uint8_t dest = msg->route_response.dest_node;
+            uint8_t next_hop = msg->route_response.route_available ?
+                               msg->route_response.next_hop : 0xFF;
+            printf("RRC-OLSR: Received route update for node %u → next hop %u\n",
+                   dest, msg->route_response.next_hop);
+            rrc_route_cache_store(dest, next_hop);
+
+            RRC_ConnectionContext *ctx = rrc_get_connection_context(dest);
+            if (ctx && ctx->setup_pending && ctx->next_hop_id == 0) {
+                // Answer for a setup rrc_handle_data_request() could not route yet
+                rrc_setup_route_answered(ctx, next_hop);
+            } else if (ctx && ctx->next_hop_id != msg->route_response.next_hop) {
+                // Check if we need to reconfigure any existing connections
+                printf("RRC-OLSR: Route change detected, triggering reconfiguration\n");
+                rrc_handle_route_change(dest, msg->route_response.next_hop);
             }
+
+            // Answer to a route request sent for parked packets
+            rrc_complete_pending_routes(dest, next_hop);
+            break;
         }
-        
-        usleep(1000); // 1ms sleep to prevent busy-waiting
+
+        case MSG_OLSR_MESSAGE:
+            printf("RRC-OLSR: Received OLSR protocol message from originator %u\n",
+                   msg->olsr_msg.originator);
+
+            // Build NC slot message with OLSR content
+            NCSlotMessage nc_msg;
+            build_nc_slot_message(&nc_msg, rrc_get_my_nc_slot());
+
+            OLSRMessage olsr_wrapped;
+            olsr_wrapped.msg_type = msg->olsr_msg.msg_type;
+            olsr_wrapped.originator_addr = msg->olsr_msg.originator;
+            olsr_wrapped.ttl = msg->olsr_msg.ttl;
+            olsr_wrapped.hop_count = msg->olsr_msg.hop_count;
+
+            add_olsr_to_nc_message(&nc_msg, &olsr_wrapped);
+
+            // Add piggyback if available
+            PiggybackTLV piggyback;
+            rrc_build_piggyback_tlv(&piggyback);
+            add_piggyback_to_nc_message(&nc_msg, &piggyback);
+
+            // Enqueue to NC slot queue for TDMA transmission
+            if (nc_slot_queue_enqueue(&nc_msg)) {
+                printf("RRC-OLSR: OLSR message queued for NC slot transmission\n");
+            }
+            break;
+
+        default:
+            printf("RRC-OLSR: Unknown message type %d\n", msg->type);
+            break;
     }
-    
-    printf("RRC: OLSR message handler thread stopped\n");
-    return NULL;
 }
 
-// TDMA Message Handler Thread
-void *rrc_tdma_message_handler(void *arg) {
-    printf("RRC: TDMA message handler thread started\n");
-    
-    while (system_running) {
-        IPC_Message msg;
-        
-        if (rrc_receive_from_tdma(&msg, false) > 0) {
-            switch (msg.type) {
-                case MSG_TDMA_SLOT_STATUS_UPDATE:
-                    printf("RRC-TDMA: Slot status update received\n");
-                    // Update our local view of slot availability
-                    break;
-                    
-                case MSG_TDMA_RX_QUEUE_DATA:
-                    printf("RRC-TDMA: RX queue notification - %u frames from node %u\n",
-                           msg.rx_notify.frame_count, msg.rx_notify.source_node);
-                    
-                    // Process received frames from rx_queue
-                    while (!rrc_is_queue_empty(&shared_queues->rx_queue)) {
-                        struct frame rx_frame = rrc_dequeue_shared(&shared_queues->rx_queue);
-                        
-                        printf("RRC-TDMA: Processing uplink frame from node %u to node %u\n",
-                               rx_frame.source_add, rx_frame.dest_add);
-                        
-                        // Check if packet is for us
-                        if (rx_frame.dest_add == rrc_node_id) {
-                            printf("RRC-TDMA: Frame is for us, delivering to application\n");
-                            
-                            // Convert to app packet and deliver
-                            CustomApplicationPacket app_pkt;
-                            app_pkt.src_id = rx_frame.source_add;
-                            app_pkt.dest_id = rx_frame.dest_add;
-                            app_pkt.data_size = rx_frame.payload_length_bytes;
-                            memcpy(app_pkt.data, rx_frame.payload, rx_frame.payload_length_bytes);
-                            app_pkt.timestamp = (uint32_t)time(NULL);
-                            
-                            if (rrc_send_to_app(&app_pkt) == 0) {
-                                printf("RRC-TDMA: Uplink packet delivered to application\n");
-                            }
-                        } else {
-                            // Check if we should relay
-                            if (should_relay_packet(&rx_frame)) {
-                                printf("RRC-TDMA: Relaying packet to destination %u\n", rx_frame.dest_add);
-                                enqueue_relay_packet(&rx_frame);
-                            }
-                        }
-                        
-                        // Update activity for source node
-                        rrc_update_connection_activity(rx_frame.source_add);
+// TDMA message (slot status, rx_queue notifications)
+void rrc_dispatch_tdma_message(const IPC_Message *msg) {
+    switch (msg->type) {
+        case MSG_TDMA_SLOT_STATUS_UPDATE:
+            printf("RRC-TDMA: Slot status update received\n");
+            // Update our local view of slot availability
+            break;
+
+        case MSG_TDMA_RX_QUEUE_DATA:
+            printf("RRC-TDMA: RX queue notification - %u frames from node %u\n",
+                   msg->rx_notify.frame_count, msg->rx_notify.source_node);
+
+            // Process received frames from rx_queue
+            while (!rrc_is_queue_empty(&shared_queues->rx_queue)) {
+                struct frame rx_frame = rrc_dequeue_shared(&shared_queues->rx_queue);
+
+                printf("RRC-TDMA: Processing uplink frame from node %u to node %u\n",
+                       rx_frame.source_add, rx_frame.dest_add);
+
+                // Check if packet is for us
+                if (rx_frame.dest_add == rrc_node_id) {
+                    printf("RRC-TDMA: Frame is for us, delivering to application\n");
+
+                    // Convert to app packet and deliver
+                    CustomApplicationPacket app_pkt;
+                    app_pkt.src_id = rx_frame.source_add;
+                    app_pkt.dest_id = rx_frame.dest_add;
+                    app_pkt.data_size = rx_frame.payload_length_bytes;
+                    memcpy(app_pkt.data, rx_frame.payload, rx_frame.payload_length_bytes);
+                    app_pkt.timestamp = (uint32_t)time(NULL);
+
+                    if (rrc_send_to_app(&app_pkt) == 0) {
+                        printf("RRC-TDMA: Uplink packet delivered to application\n");
                     }
-                    break;
-                    
-                default:
-                    printf("RRC-TDMA: Unknown message type %d\n", msg.type);
-                    break;
+                } else {
+                    // Check if we should relay
+                    if (should_relay_packet(&rx_frame)) {
+                        printf("RRC-TDMA: Relaying packet to destination %u\n", rx_frame.dest_add);
+                        enqueue_relay_packet(&rx_frame);
+                    }
+                }
+
+                // Update activity for source node
+                rrc_update_connection_activity(rx_frame.source_add);
             }
+            break;
+
+        default:
+            printf("RRC-TDMA: Unknown message type %d\n", msg->type);
+            break;
+    }
+}
+
+// Route answer for a parked downlink packet: transmit it, or tell the app
+// the destination is unreachable
+static void rrc_app_packet_routed(const CustomApplicationPacket *pkt, uint8_t next_hop) {
+    if (next_hop == 0 || next_hop == 0xFF) {
+        printf("RRC-APP: ERROR - No route to destination %u\n", pkt->dest_id);
+
+        // Notify app of failure
+        CustomApplicationPacket failure_pkt = *pkt;
+        failure_pkt.src_id = rrc_node_id;
+        failure_pkt.dest_id = pkt->src_id;
+        rrc_send_to_app(&failure_pkt);
+        return;
+    }
+
+    printf("RRC-APP: Route found - next hop is %u\n", next_hop);
+
+    // Check if connection is established
+    RRC_ConnectionContext *ctx = rrc_get_connection_context(pkt->dest_id);
+    if (ctx && ctx->connection_state == RRC_STATE_CONNECTED) {
+        printf("RRC-APP: Connection established, proceeding with transmission\n");
+
+        // Build frame for downlink transmission
+        struct frame tx_frame;
+        tx_frame.source_add = pkt->src_id;
+        tx_frame.dest_add = pkt->dest_id;
+        tx_frame.next_hop_add = next_hop;
+        tx_frame.rx_or_l3 = false; // L3 (downlink)
+        tx_frame.TTL = 10;
+        tx_frame.priority = (pkt->urgent ? 1 : 2);
+        tx_frame.data_type = (DATATYPE)pkt->data_type;
+        tx_frame.payload_length_bytes = pkt->data_size;
+        memcpy(tx_frame.payload, pkt->data, pkt->data_size);
+
+        // Enqueue to appropriate downlink queue based on priority
+        if (tx_frame.data_type == DATA_TYPE_ANALOG_VOICE) {
+            rrc_enqueue_shared(&shared_queues->analog_voice_queue, tx_frame);
+            printf("RRC-APP: Frame enqueued to analog voice queue\n");
+        } else {
+            int queue_idx = (tx_frame.priority >= 0 && tx_frame.priority < NUM_PRIORITY) ?
+                            tx_frame.priority : 0;
+            rrc_enqueue_shared(&shared_queues->data_from_l3_queue[queue_idx], tx_frame);
+            printf("RRC-APP: Frame enqueued to data queue %d\n", queue_idx);
         }
-        
-        usleep(1000);
+
+        rrc_stats.messages_enqueued_total++;
+
+        // Update connection activity
+        rrc_update_connection_activity(pkt->dest_id);
+
+        // Complete setup if pending
+        if (ctx->setup_pending) {
+            rrc_handle_route_and_slots_allocated(pkt->dest_id, next_hop);
+        }
+    } else {
+        printf("RRC-APP: Connection not ready, waiting for setup completion\n");
     }
-    
-    printf("RRC: TDMA message handler thread stopped\n");
-    return NULL;
 }
 
-// Application Message Handler Thread
-void *rrc_app_message_handler(void *arg) {
-    printf("RRC: Application message handler thread started\n");
-    
-    while (system_running) {
-        CustomApplicationPacket app_pkt;
-        
-        // Check for downlink packets from application
-        if (rrc_receive_from_app(&app_pkt, false) == 0) {
-            printf("RRC-APP: Received packet from app (src:%u → dest:%u, size:%zu, type:%d)\n",
-                   app_pkt.src_id, app_pkt.dest_id, app_pkt.data_size, app_pkt.data_type);
-            
-            rrc_stats.packets_processed++;
-            
-            // Initiate connection setup if needed
-            if (rrc_state.current_rrc_state == RRC_STATE_IDLE) {
-                printf("RRC-APP: Initiating connection setup for destination %u\n", app_pkt.dest_id);
-                
-                MessagePriority priority = PRIORITY_DATA_1;
-                if (app_pkt.data_type == RRC_DATA_TYPE_VOICE) priority = PRIORITY_DIGITAL_VOICE;
-                else if (app_pkt.data_type == RRC_DATA_TYPE_PTT) priority = PRIORITY_ANALOG_VOICE_PTT;
-                
-                rrc_handle_data_request(app_pkt.dest_id, priority);
-            }
-            
-            // Get route from OLSR
-            uint8_t next_hop = ipc_olsr_get_next_hop(app_pkt.dest_id);
-            
-            if (next_hop == 0 || next_hop == 0xFF) {
-                printf("RRC-APP: ERROR - No route to destination %u\n", app_pkt.dest_id);
-                
-                // Notify app of failure
-                CustomApplicationPacket failure_pkt = app_pkt;
-                failure_pkt.src_id = rrc_node_id;
-                failure_pkt.dest_id = app_pkt.src_id;
-                rrc_send_to_app(&failure_pkt);
-                continue;
+// Claim a wait slot for dest and make sure a route request is out. The
+// first packet parked for a destination always sends one; the packets
+// parked behind it ride on that request.
+static RRC_PendingRoute *rrc_claim_pending_route(uint8_t dest) {
+    RRC_PendingRoute *slot = NULL;
+    bool requested = false;
+
+    for (int i = 0; i < RRC_ROUTE_PENDING_MAX; i++) {
+        RRC_PendingRoute *p = &route_pending[i];
+        if (!p->in_use) {
+            if (!slot) slot = p;
+        } else if (p->dest_id == dest) {
+            requested = true;
+        }
+    }
+    if (!slot) {
+        printf("RRC: Route wait list full, dropping packet for %u\n", dest);
+        return NULL;
+    }
+    if (!requested && rrc_send_route_request(dest) < 0) return NULL;
+
+    slot->dest_id = dest;
+    slot->order = ++route_pending_order;
+    slot->deadline = time(NULL) + RRC_ROUTE_PENDING_TIMEOUT_SEC;
+    slot->in_use = true;
+    return slot;
+}
+
+// Park a downlink packet until OLSR answers for its destination
+static bool rrc_park_app_packet(const AppPacketDescriptor *app_pkt, const uint8_t *payload) {
+    RRC_PendingRoute *slot = rrc_claim_pending_route(app_pkt->dest_id);
+    if (!slot) return false;
+
+    AppPacketView view = { app_pkt, payload };
+    app_ring_copy_out(&view, &slot->pkt);
+    slot->is_relay = false;
+    return true;
+}
+
+// Park a relay frame until OLSR answers for its destination
+static bool rrc_park_relay_frame(const struct frame *frame) {
+    RRC_PendingRoute *slot = rrc_claim_pending_route(frame->dest_add);
+    if (!slot) {
+        relay_stats.relay_packets_dropped_full++;
+        return false;
+    }
+
+    slot->frame = *frame;
+    slot->is_relay = true;
+    return true;
+}
+
+// Release the packets parked for dest, oldest first
+static void rrc_complete_pending_routes(uint8_t dest, uint8_t next_hop) {
+    for (;;) {
+        RRC_PendingRoute *oldest = NULL;
+        for (int i = 0; i < RRC_ROUTE_PENDING_MAX; i++) {
+            RRC_PendingRoute *p = &route_pending[i];
+            if (p->in_use && p->dest_id == dest &&
+                (!oldest || (int32_t)(p->order - oldest->order) < 0)) {
+                oldest = p;
             }
-            
-            printf("RRC-APP: Route found - next hop is %u\n", next_hop);
-            
-            // Check if connection is established
-            RRC_ConnectionContext *ctx = rrc_get_connection_context(app_pkt.dest_id);
-            if (ctx && ctx->connection_state == RRC_STATE_CONNECTED) {
-                printf("RRC-APP: Connection established, proceeding with transmission\n");
-                
-                // Build frame for downlink transmission
-                struct frame tx_frame;
-                tx_frame.source_add = app_pkt.src_id;
-                tx_frame.dest_add = app_pkt.dest_id;
-                tx_frame.next_hop_add = next_hop;
-                tx_frame.rx_or_l3 = false; // L3 (downlink)
-                tx_frame.TTL = 10;
-                tx_frame.priority = (app_pkt.urgent ? 1 : 2);
-                tx_frame.data_type = (DATATYPE)app_pkt.data_type;
-                tx_frame.payload_length_bytes = app_pkt.data_size;
-                memcpy(tx_frame.payload, app_pkt.data, app_pkt.data_size);
-                
-                // Enqueue to appropriate downlink queue based on priority
-                if (tx_frame.data_type == DATA_TYPE_ANALOG_VOICE) {
-                    rrc_enqueue_shared(&shared_queues->analog_voice_queue, tx_frame);
-                    printf("RRC-APP: Frame enqueued to analog voice queue\n");
-                } else {
-                    int queue_idx = (tx_frame.priority >= 0 && tx_frame.priority < NUM_PRIORITY) ? 
-                                    tx_frame.priority : 0;
-                    rrc_enqueue_shared(&shared_queues->data_from_l3_queue[queue_idx], tx_frame);
-                    printf("RRC-APP: Frame enqueued to data queue %d\n", queue_idx);
-                }
-                
-                rrc_stats.messages_enqueued_total++;
-                
-                // Update connection activity
-                rrc_update_connection_activity(app_pkt.dest_id);
-                
-                // Complete setup if pending
-                if (ctx->setup_pending) {
-                    rrc_handle_route_and_slots_allocated(app_pkt.dest_id, next_hop);
+        }
+        if (!oldest) return;
+        oldest->in_use = false;
+        if (oldest->is_relay) {
+            rrc_relay_frame_routed(&oldest->frame, next_hop);
+        } else {
+            rrc_app_packet_routed(&oldest->pkt, next_hop);
+        }
+    }
+}
+
+// Destinations OLSR did not answer for within the timeout are unreachable
+static void rrc_expire_pending_routes(void) {
+    time_t now = time(NULL);
+    for (int i = 0; i < RRC_ROUTE_PENDING_MAX; i++) {
+        if (route_pending[i].in_use && route_pending[i].deadline <= now) {
+            printf("RRC-OLSR: No route answer for node %u\n", route_pending[i].dest_id);
+            rrc_complete_pending_routes(route_pending[i].dest_id, 0xFF);
+        }
+    }
+}
+
+// Downlink packet from the application, read in place from the app ring
+void rrc_dispatch_app_packet(const AppPacketDescriptor *app_pkt, const uint8_t *payload) {
+    printf("RRC-APP: Received packet from app (src:%u → dest:%u, size:%u, type:%d)\n",
+           app_pkt->src_id, app_pkt->dest_id, app_pkt->data_size, app_pkt->data_type);
+
+    rrc_stats.packets_processed++;
+
+    // Initiate connection setup if needed
+    if (rrc_state.current_rrc_state == RRC_STATE_IDLE) {
+        printf("RRC-APP: Initiating connection setup for destination %u\n", app_pkt->dest_id);
+
+        MessagePriority priority = PRIORITY_DATA_1;
+        if (app_pkt->data_type == RRC_DATA_TYPE_VOICE) priority = PRIORITY_DIGITAL_VOICE;
+        else if (app_pkt->data_type == RRC_DATA_TYPE_PTT) priority = PRIORITY_ANALOG_VOICE_PTT;
+
+        rrc_handle_data_request(app_pkt->dest_id, priority);
+    }
+
+    // A known route sends right away; otherwise the route comes back
+    // through rrc_dispatch_olsr_message()
+    uint8_t next_hop;
+    if (!rrc_route_cache_peek(app_pkt->dest_id, &next_hop)) {
+        if (rrc_park_app_packet(app_pkt, payload)) return;
+        next_hop = 0xFF;
+    }
+
+    CustomApplicationPacket pkt;
+    AppPacketView view = { app_pkt, payload };
+    app_ring_copy_out(&view, &pkt);
+    rrc_app_packet_routed(&pkt, next_hop);
+}
+
+// PHY message (link metrics, link status)
+void rrc_dispatch_phy_message(const IPC_Message *msg) {
+    switch (msg->type) {
+        case MSG_PHY_METRICS_UPDATE:
+            printf("RRC-PHY: Metrics update for node %u (RSSI:%.1f, SNR:%.1f, PER:%.1f%%)\n",
+                   msg->phy_metrics.node_id, msg->phy_metrics.rssi_dbm,
+                   msg->phy_metrics.snr_db, msg->phy_metrics.per_percent);
+
+            // Update neighbor metrics
+            NeighborState *neighbor = rrc_create_neighbor_state(msg->phy_metrics.node_id);
+            if (neighbor) {
+                neighbor->phy.rssi_dbm = msg->phy_metrics.rssi_dbm;
+                neighbor->phy.snr_db = msg->phy_metrics.snr_db;
+                neighbor->phy.per_percent = msg->phy_metrics.per_percent;
+                neighbor->phy.packet_count = msg->phy_metrics.packet_count;
+                neighbor->phy.last_update_time = msg->phy_metrics.timestamp;
+                neighbor->active = msg->phy_metrics.link_active;
+
+                // Check for poor link quality
+                if (!is_link_quality_good(msg->phy_metrics.node_id)) {
+                    printf("RRC-PHY: WARNING - Poor link quality for node %u\n",
+                           msg->phy_metrics.node_id);
                 }
-            } else {
-                printf("RRC-APP: Connection not ready, waiting for setup completion\n");
             }
+            break;
+
+        case MSG_PHY_LINK_STATUS_CHANGE:
+            printf("RRC-PHY: Link status change for node %u\n", msg->phy_metrics.node_id);
+            break;
+
+        default:
+            printf("RRC-PHY: Unknown message type %d\n", msg->type);
+            break;
+    }
+}
+
+// Once-a-second management tick
+void rrc_periodic_tick(uint64_t cycle_count) {
+    // Periodic system management (timeouts, cleanup)
+    rrc_periodic_system_management();
+
+    // Update piggyback TTL
+    rrc_update_piggyback_ttl();
+
+    // Parked downlink packets OLSR never answered for
+    rrc_expire_pending_routes();
+
+    // Every 10 seconds, send slot table update to TDMA
+    if (cycle_count % 10 == 0) {
+        IPC_Message slot_update;
+        slot_update.type = MSG_RRC_SLOT_TABLE_UPDATE;
+
+        for (int i = 0; i < 8; i++) {
+            slot_update.slot_table.slot_table[i] = tdma_slot_table[i];
+        }
+        slot_update.slot_table.timestamp = (uint32_t)time(NULL);
+        slot_update.slot_table.updated_slot_count = 8;
+
+        if (rrc_send_to_tdma(&slot_update) == 0) {
+            printf("RRC-MGMT: Sent slot table update to TDMA\n");
         }
-        
-        usleep(1000);
     }
-    
-    printf("RRC: Application message handler thread stopped\n");
-    return NULL;
+
+    // Every 30 seconds, print statistics
+    if (cycle_count % 30 == 0) {
+        printf("\n");
+        print_rrc_fsm_stats();
+        print_nc_slot_queue_stats();
+        print_nc_wire_stats();
+        print_relay_stats();
+        print_app_rrc_queue_stats();
+
+        printf("=== RRC Statistics ===\n");
+        printf("Packets processed: %u\n", rrc_stats.packets_processed);
+        printf("Messages enqueued: %u\n", rrc_stats.messages_enqueued_total);
+        printf("Messages discarded: %u\n", rrc_stats.messages_discarded_no_slots);
+        printf("Route queries: %u\n", rrc_stats.route_queries);
+        printf("Poor links detected: %u\n", rrc_stats.poor_links_detected);
+        printf("Reactor: %llu wakeups, %llu messages, %llu app batches\n",
+               (unsigned long long)reactor_stats.wakeups,
+               (unsigned long long)reactor_stats.messages,
+               (unsigned long long)reactor_stats.app_batches);
+        printf("=====================\n\n");
+    }
 }
 
-// PHY Message Handler Thread
-void *rrc_phy_message_handler(void *arg) {
-    printf("RRC: PHY message handler thread started\n");
-    
-    while (system_running) {
+// ============================================================================
+// REACTOR
+// ============================================================================
+
+// Wake the reactor: app packets queued from this process, or shutdown.
+// Only write(2) is used, so this is safe from a signal handler.
+void rrc_reactor_wakeup(void) {
+    if (reactor_wake_fd != -1) {
+        uint64_t one = 1;
+        ssize_t n = write(reactor_wake_fd, &one, sizeof(one));
+        (void)n;
+    }
+}
+
+// Receive everything already queued on an MQ without blocking. An
+// absolute timeout in the past makes mq_timedreceive return ETIMEDOUT
+// once the queue is empty, so the descriptor itself can stay blocking.
+// Bounded so one busy queue cannot starve the rest.
+static int rrc_reactor_drain_mq(mqd_t mq, void (*dispatch)(const IPC_Message *)) {
+    static const struct timespec already_expired = {0, 0};
+    int handled = 0;
+
+    while (handled < RRC_REACTOR_DRAIN_BUDGET) {
         IPC_Message msg;
-        
-        if (rrc_receive_from_phy(&msg, false) > 0) {
-            switch (msg.type) {
-                case MSG_PHY_METRICS_UPDATE:
-                    printf("RRC-PHY: Metrics update for node %u (RSSI:%.1f, SNR:%.1f, PER:%.1f%%)\n",
-                           msg.phy_metrics.node_id, msg.phy_metrics.rssi_dbm,
-                           msg.phy_metrics.snr_db, msg.phy_metrics.per_percent);
-                    
-                    // Update neighbor metrics
-                    NeighborState *neighbor = rrc_create_neighbor_state(msg.phy_metrics.node_id);
-                    if (neighbor) {
-                        neighbor->phy.rssi_dbm = msg.phy_metrics.rssi_dbm;
-                        neighbor->phy.snr_db = msg.phy_metrics.snr_db;
-                        neighbor->phy.per_percent = msg.phy_metrics.per_percent;
-                        neighbor->phy.packet_count = msg.phy_metrics.packet_count;
-                        neighbor->phy.last_update_time = msg.phy_metrics.timestamp;
-                        neighbor->active = msg.phy_metrics.link_active;
-                        
-                        // Check for poor link quality
-                        if (!is_link_quality_good(msg.phy_metrics.node_id)) {
-                            printf("RRC-PHY: WARNING - Poor link quality for node %u\n", 
-                                   msg.phy_metrics.node_id);
-                        }
-                    }
-                    break;
-                    
-                case MSG_PHY_LINK_STATUS_CHANGE:
-                    printf("RRC-PHY: Link status change for node %u\n", msg.phy_metrics.node_id);
-                    break;
-                    
-                default:
-                    printf("RRC-PHY: Unknown message type %d\n", msg.type);
-                    break;
+        ssize_t received = mq_timedreceive(mq, (char *)&msg, MQ_MESSAGE_SIZE,
+                                           NULL, &already_expired);
+        if (received == -1) {
+            if (errno == EMSGSIZE) {
+                char discard[MQ_MESSAGE_SIZE];
+                mq_timedreceive(mq, discard, MQ_MESSAGE_SIZE, NULL, &already_expired);
+                continue;
             }
+            break;
+        }
+        dispatch(&msg);
+        handled++;
+    }
+    return handled;
+}
+
+// Batched, zero-copy drain of the app ring. If the budget runs out the
+// reactor rings itself so the rest is picked up after the other sources.
+static int rrc_reactor_drain_app(void) {
+    int handled = 0;
+
+    while (handled < RRC_REACTOR_DRAIN_BUDGET) {
+        AppPacketView batch[APP_RRC_DEQUEUE_BATCH];
+        int n = rrc_receive_from_app_batch(batch, APP_RRC_DEQUEUE_BATCH);
+        if (n == 0) {
+            return handled;
+        }
+        for (int i = 0; i < n; i++) {
+            rrc_dispatch_app_packet(batch[i].desc, batch[i].payload);
+        }
+        rrc_release_app_batch(n);
+        reactor_stats.app_batches++;
+        handled += n;
+    }
+
+    if (!app_to_rrc_queue_is_empty()) {
+        rrc_reactor_wakeup();
+    }
+    return handled;
+}
+
+// The app process cannot write our eventfd, so this thread sleeps on the
+// app ring's shared futex and forwards each doorbell to the reactor
+void *rrc_app_doorbell_thread(void *arg) {
+    AppPacketRing *ring = &app_rrc_shm->app_to_rrc;
+    uint32_t seen = __atomic_load_n(&ring->doorbell, __ATOMIC_SEQ_CST);
+
+    // Packets queued before the snapshot rang no doorbell we will see:
+    // have the reactor drain them now
+    rrc_reactor_wakeup();
+
+    while (system_running) {
+        app_ring_wait_doorbell(ring, seen, -1);
+        uint32_t now = __atomic_load_n(&ring->doorbell, __ATOMIC_SEQ_CST);
+        if (now != seen) {
+            seen = now;
+            rrc_reactor_wakeup();
         }
-        
-        usleep(1000);
     }
-    
-    printf("RRC: PHY message handler thread stopped\n");
     return NULL;
 }
 
-// Periodic Management Thread
-void *rrc_periodic_management_thread(void *arg) {
-    printf("RRC: Periodic management thread started\n");
-    
-    int cycle_count = 0;
-    
+static int rrc_reactor_add(int fd, uint32_t tag) {
+    struct epoll_event ev;
+    ev.events = EPOLLIN;
+    ev.data.u32 = tag;
+    if (epoll_ctl(reactor_epoll_fd, EPOLL_CTL_ADD, fd, &ev) == -1) {
+        perror("epoll_ctl(ADD)");
+        return -1;
+    }
+    return 0;
+}
+
+static void rrc_reactor_close(void) {
+    if (reactor_timer_fd != -1) {
+        close(reactor_timer_fd);
+        reactor_timer_fd = -1;
+    }
+    if (reactor_wake_fd != -1) {
+        close(reactor_wake_fd);
+        reactor_wake_fd = -1;
+    }
+    if (reactor_epoll_fd != -1) {
+        close(reactor_epoll_fd);
+        reactor_epoll_fd = -1;
+    }
+}
+
+// On Linux an mqd_t is a file descriptor, so the inbound queues go into
+// epoll directly alongside the 1 s management timer and the wakeup eventfd
+int rrc_reactor_init(void) {
+    reactor_epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    if (reactor_epoll_fd == -1) {
+        perror("epoll_create1");
+        return -1;
+    }
+
+    reactor_wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (reactor_wake_fd == -1) {
+        perror("eventfd");
+        goto fail;
+    }
+
+    reactor_timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (reactor_timer_fd == -1) {
+        perror("timerfd_create");
+        goto fail;
+    }
+    struct itimerspec period = {{1, 0}, {1, 0}};
+    if (timerfd_settime(reactor_timer_fd, 0, &period, NULL) == -1) {
+        perror("timerfd_settime");
+        goto fail;
+    }
+
+    if (rrc_reactor_add((int)mq_olsr_to_rrc, RRC_REACTOR_OLSR) == -1 ||
+        rrc_reactor_add((int)mq_tdma_to_rrc, RRC_REACTOR_TDMA) == -1 ||
+        rrc_reactor_add((int)mq_phy_to_rrc, RRC_REACTOR_PHY) == -1 ||
+        rrc_reactor_add(reactor_wake_fd, RRC_REACTOR_WAKE) == -1 ||
+        rrc_reactor_add(reactor_timer_fd, RRC_REACTOR_TIMER) == -1) {
+        goto fail;
+    }
+
+    return 0;
+
+fail:
+    rrc_reactor_close();
+    return -1;
+}
+
+// Single thread owning all RRC state: connection_pool, the neighbor table
+// and the FSM are only touched from here, so the handlers need no locks.
+void *rrc_reactor_thread(void *arg) {
+    printf("RRC: Reactor thread started\n");
+
+    uint64_t cycle_count = 0;
+    struct epoll_event events[RRC_REACTOR_MAX_EVENTS];
+
     while (system_running) {
-        sleep(1); // Run every second
-        cycle_count++;
-        
-        // Periodic system management (timeouts, cleanup)
-        rrc_periodic_system_management();
-        
-        // Update piggyback TTL
-        rrc_update_piggyback_ttl();
-        
-        // Every 10 seconds, send slot table update to TDMA
-        if (cycle_count % 10 == 0) {
-            IPC_Message slot_update;
-            slot_update.type = MSG_RRC_SLOT_TABLE_UPDATE;
-            
-            for (int i = 0; i < 8; i++) {
-                slot_update.slot_table.slot_table[i] = tdma_slot_table[i];
-            }
-            slot_update.slot_table.timestamp = (uint32_t)time(NULL);
-            slot_update.slot_table.updated_slot_count = 8;
-            
-            if (rrc_send_to_tdma(&slot_update) == 0) {
-                printf("RRC-MGMT: Sent slot table update to TDMA\n");
-            }
+        int n = epoll_wait(reactor_epoll_fd, events, RRC_REACTOR_MAX_EVENTS, -1);
+        if (n == -1) {
+            if (errno == EINTR) continue;
+            perror("epoll_wait");
+            break;
         }
-        
-        // Every 30 seconds, print statistics
-        if (cycle_count % 30 == 0) {
-            printf("\n");
-            print_rrc_fsm_stats();
-            print_nc_slot_queue_stats();
-            print_relay_stats();
-            print_app_rrc_queue_stats();
-            
-            printf("=== RRC Statistics ===\n");
-            printf("Packets processed: %u\n", rrc_stats.packets_processed);
-            printf("Messages enqueued: %u\n", rrc_stats.messages_enqueued_total);
-            printf("Messages discarded: %u\n", rrc_stats.messages_discarded_no_slots);
-            printf("Route queries: %u\n", rrc_stats.route_queries);
-            printf("Poor links detected: %u\n", rrc_stats.poor_links_detected);
-            printf("=====================\n\n");
+        reactor_stats.wakeups++;
+
+        for (int i = 0; i < n; i++) {
+            uint64_t count;
+            ssize_t r;
+
+            switch (events[i].data.u32) {
+                case RRC_REACTOR_OLSR:
+                    reactor_stats.messages += rrc_reactor_drain_mq(mq_olsr_to_rrc, rrc_dispatch_olsr_message);
+                    break;
+                case RRC_REACTOR_TDMA:
+                    reactor_stats.messages += rrc_reactor_drain_mq(mq_tdma_to_rrc, rrc_dispatch_tdma_message);
+                    break;
+                case RRC_REACTOR_PHY:
+                    reactor_stats.messages += rrc_reactor_drain_mq(mq_phy_to_rrc, rrc_dispatch_phy_message);
+                    break;
+                case RRC_REACTOR_WAKE:
+                    // App doorbell (via rrc_app_doorbell_thread) or shutdown
+                    r = read(reactor_wake_fd, &count, sizeof(count));
+                    (void)r;
+                    reactor_stats.messages += rrc_reactor_drain_app();
+                    break;
+                case RRC_REACTOR_TIMER:
+                    // Expirations since the last read; missed seconds are
+                    // caught up so the 10 s / 30 s cadences stay on time
+                    if (read(reactor_timer_fd, &count, sizeof(count)) == sizeof(count)) {
+                        while (count-- > 0 && system_running) {
+                            rrc_periodic_tick(++cycle_count);
+                        }
+                    }
+                    break;
+            }
         }
     }
-    
-    printf("RRC: Periodic management thread stopped\n");
+
+    printf("RRC: Reactor thread stopped\n");
     return NULL;
 }
 
@@ -3507,49 +3960,60 @@ void *rrc_periodic_management_thread(void *arg) {
 // THREAD CONTROL
 // ============================================================================
 
-void rrc_start_threads(void) {
-    printf("RRC: Starting message handler threads...\n");
-    
-    if (pthread_create(&olsr_handler_thread, NULL, rrc_olsr_message_handler, NULL) != 0) {
-        perror("pthread_create(olsr_handler)");
-    }
-    
-    if (pthread_create(&tdma_handler_thread, NULL, rrc_tdma_message_handler, NULL) != 0) {
-        perror("pthread_create(tdma_handler)");
-    }
-    
-    if (pthread_create(&app_handler_thread, NULL, rrc_app_message_handler, NULL) != 0) {
-        perror("pthread_create(app_handler)");
+// Returns 0 once the reactor (and the app doorbell relay) run, -1 if
+// nothing would service the queues
+int rrc_start_threads(void) {
+    printf("RRC: Starting reactor...\n");
+
+    if (rrc_reactor_init() != 0) {
+        printf("RRC: ERROR - Reactor initialization failed\n");
+        return -1;
     }
-    
-    if (pthread_create(&phy_handler_thread, NULL, rrc_phy_message_handler, NULL) != 0) {
-        perror("pthread_create(phy_handler)");
+
+    if (pthread_create(&reactor_thread, NULL, rrc_reactor_thread, NULL) != 0) {
+        perror("pthread_create(reactor)");
+        rrc_reactor_close();
+        return -1;
     }
-    
-    if (pthread_create(&periodic_mgmt_thread, NULL, rrc_periodic_management_thread, NULL) != 0) {
-        perror("pthread_create(periodic_mgmt)");
+    reactor_started = true;
+
+    if (app_rrc_shm) {
+        if (pthread_create(&app_doorbell_thread, NULL, rrc_app_doorbell_thread, NULL) != 0) {
+            perror("pthread_create(app_doorbell)");
+            rrc_stop_threads();
+            return -1;
+        }
+        app_doorbell_started = true;
     }
-    
-    printf("RRC: All threads started successfully\n");
+
+    printf("RRC: Reactor started successfully\n");
+    return 0;
 }
 
 void rrc_stop_threads(void) {
-    printf("RRC: Stopping message handler threads...\n");
-    
+    printf("RRC: Stopping reactor...\n");
+
     system_running = false;
-    
-    pthread_join(olsr_handler_thread, NULL);
-    pthread_join(tdma_handler_thread, NULL);
-    pthread_join(app_handler_thread, NULL);
-    pthread_join(phy_handler_thread, NULL);
-    pthread_join(periodic_mgmt_thread, NULL);
-    
-    printf("RRC: All threads stopped\n");
+
+    if (app_doorbell_started) {
+        app_ring_ring_doorbell(&app_rrc_shm->app_to_rrc);
+        pthread_join(app_doorbell_thread, NULL);
+        app_doorbell_started = false;
+    }
+    if (reactor_started) {
+        rrc_reactor_wakeup();
+        pthread_join(reactor_thread, NULL);
+        reactor_started = false;
+    }
+    rrc_reactor_close();
+
+    printf("RRC: Reactor stopped\n");
 }
 
 void rrc_signal_handler(int signum) {
     printf("\nRRC: Received signal %d, shutting down...\n", signum);
     system_running = false;
+    rrc_reactor_wakeup();
 }
 
 // ============================================================================
@@ -3566,21 +4030,14 @@ void rrc_simulate_app_downlink(void) {
     app_pkt.transmission_type = TRANSMISSION_UNICAST;
     app_pkt.data_size = 100;
     snprintf((char*)app_pkt.data, sizeof(app_pkt.data), "Test message from node %u", rrc_node_id);
-    app_pkt.sequence_number = rrc_stats.packets_processed + 1;
+    // rrc_stats belongs to the reactor thread; the loopback keeps its own count
+    static uint32_t loopback_sequence = 0;
+    app_pkt.sequence_number = ++loopback_sequence;
     app_pkt.timestamp = (uint32_t)time(NULL);
     app_pkt.urgent = false;
     
-    if (app_rrc_shm) {
-        sem_wait(&app_rrc_shm->mutex);
-        
-        if (app_rrc_shm->app_to_rrc_count < APP_RRC_QUEUE_SIZE) {
-            app_rrc_shm->app_to_rrc_queue[app_rrc_shm->app_to_rrc_back] = app_pkt;
-            app_rrc_shm->app_to_rrc_back = (app_rrc_shm->app_to_rrc_back + 1) % APP_RRC_QUEUE_SIZE;
-            app_rrc_shm->app_to_rrc_count++;
-            printf(">>> Loopback: Application packet injected to app_to_rrc queue\n");
-        }
-        
-        sem_post(&app_rrc_shm->mutex);
+    if (app_send_to_rrc(&app_pkt) == 0) {
+        printf(">>> Loopback: Application packet injected to app_to_rrc queue\n");
     }
 }
 
@@ -3677,15 +4134,13 @@ void rrc_loopback_test(void) {
     
     // Test 5: Check if uplink was delivered to app
     if (app_rrc_shm) {
-        sem_wait(&app_rrc_shm->mutex);
-        int count = app_rrc_shm->rrc_to_app_count;
-        sem_post(&app_rrc_shm->mutex);
+        int count = rrc_to_app_queue_count();
         
         printf("\n>>> Loopback: RRC to App queue has %d messages\n", count);
         
         if (count > 0) {
             CustomApplicationPacket received_pkt;
-            if (rrc_receive_from_app(&received_pkt, false) == 0) {
+            if (app_receive_from_rrc(&received_pkt, 0) == 0) {
                 printf(">>> Loopback: Successfully retrieved uplink packet from rrc_to_app queue\n");
                 printf("    Source: %u, Dest: %u, Size: %zu\n", 
                        received_pkt.src_id, received_pkt.dest_id, received_pkt.data_size);
@@ -3705,7 +4160,6 @@ void rrc_loopback_test(void) {
 int main(int argc, char *argv[]) {
     printf("\n========================================\n");
     printf("RRC Subsystem with POSIX IPC\n");
-    printf("Multi-threaded Event-Driven Architecture\n");
     printf("========================================\n");
     
     // Set our node ID (can be passed as command line argument)
@@ -3758,16 +4212,12 @@ int main(int argc, char *argv[]) {
     rrc_handle_power_on();
     printf("FSM State: %s\n", rrc_state_to_string(rrc_state.current_rrc_state));
 
-    // Start message handler threads
-    printf("\n========================================\n");
-    printf("Starting Message Handler Threads\n");
-    printf("========================================\n");
-    rrc_start_threads();
-    printf("  ✓ OLSR message handler\n");
-    printf("  ✓ TDMA message handler\n");
-    printf("  ✓ Application message handler\n");
-    printf("  ✓ PHY message handler\n");
-    printf("  ✓ Periodic management thread\n");
+    // One reactor thread services every inbound queue and the 1 s tick
+    if (rrc_start_threads() != 0) {
+        fprintf(stderr, "FATAL: Failed to start the RRC reactor\n");
+        rrc_ipc_cleanup();
+        return 1;
+    }
     
     sleep(1);
     
@@ -3780,16 +4230,11 @@ int main(int argc, char *argv[]) {
     printf("\n========================================\n");
     printf("RRC Subsystem Running\n");
     printf("========================================\n");
-    printf("Event-driven operation active\n");
-    printf("All threads processing messages\n");
     printf("Press Ctrl+C for graceful shutdown\n\n");
 
-    // Main loop - threads handle all events
+    // The reactor handles all events; main only waits for shutdown
     while (system_running) {
-        sleep(60); // Wake up every minute for housekeeping
-        
-        // Main thread can do additional coordination here if needed
-        // Threads are handling all the real-time message processing
+        sleep(60);
     }
 
     // Graceful shutdown sequence
@@ -3797,7 +4242,6 @@ int main(int argc, char *argv[]) {
     printf("Shutting Down RRC Subsystem\n");
     printf("========================================\n");
     
-    printf("Stopping message handler threads...\n");
     rrc_stop_threads();
     
     printf("Powering off RRC...\n");
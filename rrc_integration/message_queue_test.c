@@ -0,0 +1,173 @@
+/**
+ * Message Queue Test Program
+ * Exercises the variable-length record ring across many wraps and the
+ * shared payload pool when every buffer is taken.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "rrc_message_queue.h"
+
+static int failures = 0;
+
+#define CHECK(cond, what) do { \
+    if (cond) { \
+        printf("PASS: %s\n", what); \
+    } else { \
+        printf("FAIL: %s\n", what); \
+        failures++; \
+    } \
+} while (0)
+
+static void fill_payload(uint8_t *payload, size_t len, uint32_t seed)
+{
+    for (size_t i = 0; i < len; i++) {
+        payload[i] = (uint8_t)(seed * 31 + i);
+    }
+}
+
+static bool payload_matches(const uint8_t *payload, size_t len, uint32_t seed)
+{
+    for (size_t i = 0; i < len; i++) {
+        if (payload[i] != (uint8_t)(seed * 31 + i)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Records of mixed sizes, kept a few deep, until the ring has wrapped
+// several times; every message must come back intact and in order
+static void test_ring_wrap(MessageQueue *mq)
+{
+    const int rounds = 40 * MESSAGE_QUEUE_SIZE;
+    const int depth = 5;
+    int wraps = 0;
+    int sent = 0, received = 0;
+    bool intact = true;
+
+    while (received < rounds) {
+        while (sent < rounds && sent - received < depth) {
+            LayerMessage msg;
+            memset(&msg, 0, sizeof(msg));
+            msg.header.request_id = (uint32_t)sent;
+            if (sent % 3 == 0) {
+                msg.header.msg_type = MSG_TYPE_OLSR_ROUTE_RESPONSE;
+                msg.olsr_route_resp.next_hop = (uint8_t)sent;
+            } else {
+                msg.header.msg_type = MSG_TYPE_APP_TO_RRC;
+                msg.app_to_rrc.payload_len = (size_t)(sent * 37) % (MESSAGE_INLINE_PAYLOAD + 1);
+                fill_payload(msg.app_to_rrc.payload, msg.app_to_rrc.payload_len, (uint32_t)sent);
+            }
+
+            size_t head = mq->ring_head;
+            if (message_queue_enqueue(mq, &msg, 100) != 0) {
+                intact = false;
+                break;
+            }
+            if (mq->ring_head < head) {
+                wraps++;
+            }
+            sent++;
+        }
+
+        LayerMessage out;
+        if (message_queue_dequeue(mq, &out, 100) != 0 || out.header.request_id != (uint32_t)received) {
+            intact = false;
+            break;
+        }
+        if (received % 3 == 0) {
+            intact &= out.header.msg_type == MSG_TYPE_OLSR_ROUTE_RESPONSE &&
+                      out.olsr_route_resp.next_hop == (uint8_t)received;
+        } else {
+            intact &= out.header.msg_type == MSG_TYPE_APP_TO_RRC &&
+                      out.app_to_rrc.payload_len == (size_t)(received * 37) % (MESSAGE_INLINE_PAYLOAD + 1) &&
+                      payload_matches(out.app_to_rrc.payload, out.app_to_rrc.payload_len, (uint32_t)received);
+        }
+        if (!intact) {
+            break;
+        }
+        received++;
+    }
+
+    CHECK(wraps >= 3, "ring wrapped several times");
+    CHECK(intact && received == rounds, "every record read back intact and in order");
+    CHECK(mq->count == 0, "queue empty afterwards");
+}
+
+// A full queue of inline records must always fit in the ring
+static void test_ring_full(MessageQueue *mq)
+{
+    LayerMessage msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.header.msg_type = MSG_TYPE_APP_TO_RRC;
+    msg.app_to_rrc.payload_len = MESSAGE_INLINE_PAYLOAD;
+
+    int queued = 0;
+    while (queued < MESSAGE_QUEUE_SIZE && message_queue_enqueue(mq, &msg, 0) == 0) {
+        queued++;
+    }
+    CHECK(queued == MESSAGE_QUEUE_SIZE, "largest inline records fill every slot");
+    CHECK(message_queue_enqueue(mq, &msg, 0) != 0, "enqueue on a full queue fails");
+
+    LayerMessage out;
+    while (message_queue_dequeue(mq, &out, 0) == 0) {
+    }
+}
+
+// With the pool drained a bulk enqueue times out and the caller's
+// message is refused; one released buffer lets the next one through
+static void test_pool_exhaustion(MessageQueue *mq)
+{
+    static uint8_t *taken[MESSAGE_PAYLOAD_POOL_SIZE + 1];
+    int count = 0;
+    while (count <= MESSAGE_PAYLOAD_POOL_SIZE && (taken[count] = message_payload_alloc()) != NULL) {
+        count++;
+    }
+    CHECK(count == MESSAGE_PAYLOAD_POOL_SIZE, "pool hands out exactly its size");
+
+    static LayerMessage bulk;
+    memset(&bulk, 0, sizeof(bulk));
+    bulk.header.msg_type = MSG_TYPE_APP_TO_RRC;
+    bulk.header.request_id = 1;
+    bulk.app_to_rrc.payload_len = PAYLOAD_SIZE_BYTES;
+    fill_payload(bulk.app_to_rrc.payload, PAYLOAD_SIZE_BYTES, 1);
+
+    uint32_t overflows = mq->overflow_count;
+    CHECK(message_queue_enqueue(mq, &bulk, 50) != 0, "bulk enqueue fails while the pool is empty");
+    CHECK(mq->overflow_count == overflows + 1 && mq->count == 0, "refusal counted as overflow, nothing queued");
+
+    message_payload_release(taken[--count]);
+    CHECK(message_queue_enqueue(mq, &bulk, 50) == 0, "bulk enqueue succeeds once a buffer is back");
+    CHECK(message_payload_alloc() == NULL, "queued message holds the released buffer");
+
+    LayerMessage out;
+    uint8_t *payload = NULL;
+    size_t payload_len = 0;
+    CHECK(message_queue_dequeue_ref(mq, &out, &payload, &payload_len, 50) == 0 &&
+          payload_len == PAYLOAD_SIZE_BYTES && payload_matches(payload, payload_len, 1),
+          "bulk payload returned by reference intact");
+    message_payload_release(payload);
+
+    while (count > 0) {
+        message_payload_release(taken[--count]);
+    }
+}
+
+int main(void)
+{
+    static MessageQueue mq;
+    if (message_queue_init(&mq, "TEST") != 0) {
+        printf("FAIL: queue init\n");
+        return 1;
+    }
+
+    test_ring_wrap(&mq);
+    test_ring_full(&mq);
+    test_pool_exhaustion(&mq);
+
+    message_queue_cleanup(&mq);
+
+    printf("%s\n", failures ? "FAILED" : "ALL TESTS PASSED");
+    return failures ? 1 : 0;
+}
@@ -8,6 +8,7 @@
 #include <string.h>
 #define HAVE_STRUCT_TIMESPEC
 #include <pthread.h>
+#include <sched.h>
 #include <unistd.h>
 #include "rrc_message_queue.h"
 
@@ -20,52 +21,121 @@ typedef struct {
 } RouteEntry;
 
 #define MAX_ROUTES 40
-static RouteEntry routing_table[MAX_ROUTES];
-static pthread_mutex_t routing_table_mutex = PTHREAD_MUTEX_INITIALIZER;
+#define NO_ROUTE 0xFF
+
+/**
+ * Published routing table, indexed directly by destination node ID.
+ * A snapshot never changes while it is current: updates are built in the
+ * spare snapshot and swapped in with one pointer store, so lookups from
+ * the RRC thread take no lock and never wait for a recomputation.
+ */
+typedef struct {
+    uint8_t next_hop[256];   // NO_ROUTE if unreachable
+    uint8_t hop_count[256];
+    int readers;             // Lookups currently reading this snapshot
+} RouteSnapshot;
+
+static RouteSnapshot route_snapshots[2];
+static RouteSnapshot* current_routes = &route_snapshots[0];
+// Serializes writers only; readers never touch it
+static pthread_mutex_t route_writer_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+/**
+ * Pin the current snapshot; retry if it was swapped while pinning
+ */
+static RouteSnapshot* route_snapshot_acquire(void)
+{
+    for (;;) {
+        RouteSnapshot* snap = __atomic_load_n(&current_routes, __ATOMIC_SEQ_CST);
+        __atomic_add_fetch(&snap->readers, 1, __ATOMIC_SEQ_CST);
+        if (__atomic_load_n(&current_routes, __ATOMIC_SEQ_CST) == snap) {
+            return snap;
+        }
+        __atomic_sub_fetch(&snap->readers, 1, __ATOMIC_SEQ_CST);
+    }
+}
+
+static void route_snapshot_release(RouteSnapshot* snap)
+{
+    __atomic_sub_fetch(&snap->readers, 1, __ATOMIC_RELEASE);
+}
+
+/**
+ * Publish a new routing table (called with route_writer_mutex held)
+ */
+static void publish_routes_locked(const RouteEntry* routes, int count)
+{
+    RouteSnapshot* cur = current_routes;
+    RouteSnapshot* next = (cur == &route_snapshots[0]) ? &route_snapshots[1] : &route_snapshots[0];
+
+    // Grace period: lookups that pinned the retired snapshot finish first
+    while (__atomic_load_n(&next->readers, __ATOMIC_ACQUIRE) != 0) {
+        sched_yield();
+    }
+
+    memset(next->next_hop, NO_ROUTE, sizeof(next->next_hop));
+    memset(next->hop_count, NO_ROUTE, sizeof(next->hop_count));
+    for (int i = 0; i < count; i++) {
+        if (routes[i].valid) {
+            next->next_hop[routes[i].destination] = routes[i].next_hop;
+            next->hop_count[routes[i].destination] = routes[i].hop_count;
+        }
+    }
+
+    __atomic_store_n(&current_routes, next, __ATOMIC_SEQ_CST);
+}
+
+/**
+ * Replace the routing table with a freshly computed one
+ */
+static void olsr_publish_routes(const RouteEntry* routes, int count)
+{
+    pthread_mutex_lock(&route_writer_mutex);
+    publish_routes_locked(routes, count);
+    pthread_mutex_unlock(&route_writer_mutex);
+}
 
 /**
  * Initialize routing table with some example routes
  */
 void init_routing_table(uint8_t my_node_id)
 {
-    pthread_mutex_lock(&routing_table_mutex);
-    
-    // Clear routing table
-    memset(routing_table, 0, sizeof(routing_table));
+    RouteEntry routes[MAX_ROUTES];
+    int count = 0;
     
     // Add some example routes (in real system, OLSR protocol would populate these)
     // Example: Node 1 can reach nodes 2-5 directly
     if (my_node_id == 1) {
-        routing_table[0] = (RouteEntry){.destination = 2, .next_hop = 2, .hop_count = 1, .valid = true};
-        routing_table[1] = (RouteEntry){.destination = 3, .next_hop = 3, .hop_count = 1, .valid = true};
-        routing_table[2] = (RouteEntry){.destination = 4, .next_hop = 2, .hop_count = 2, .valid = true};
-        routing_table[3] = (RouteEntry){.destination = 5, .next_hop = 3, .hop_count = 2, .valid = true};
+        routes[count++] = (RouteEntry){.destination = 2, .next_hop = 2, .hop_count = 1, .valid = true};
+        routes[count++] = (RouteEntry){.destination = 3, .next_hop = 3, .hop_count = 1, .valid = true};
+        routes[count++] = (RouteEntry){.destination = 4, .next_hop = 2, .hop_count = 2, .valid = true};
+        routes[count++] = (RouteEntry){.destination = 5, .next_hop = 3, .hop_count = 2, .valid = true};
     }
     
-    pthread_mutex_unlock(&routing_table_mutex);
+    olsr_publish_routes(routes, count);
     
     printf("OLSR: Routing table initialized for node %u\n", my_node_id);
 }
 
+/**
+ * Look up next hop and hop count for destination (lock-free)
+ */
+static uint8_t lookup_route(uint8_t destination, uint8_t* hop_count)
+{
+    RouteSnapshot* snap = route_snapshot_acquire();
+    uint8_t next_hop = snap->next_hop[destination];
+    *hop_count = snap->hop_count[destination];
+    route_snapshot_release(snap);
+    return next_hop;
+}
+
 /**
  * Look up next hop for destination
  */
 uint8_t lookup_next_hop(uint8_t destination)
 {
-    uint8_t next_hop = 0xFF; // No route
-    
-    pthread_mutex_lock(&routing_table_mutex);
-    
-    for (int i = 0; i < MAX_ROUTES; i++) {
-        if (routing_table[i].valid && routing_table[i].destination == destination) {
-            next_hop = routing_table[i].next_hop;
-            break;
-        }
-    }
-    
-    pthread_mutex_unlock(&routing_table_mutex);
-    
-    return next_hop;
+    uint8_t hop_count;
+    return lookup_route(destination, &hop_count);
 }
 
 /**
@@ -102,7 +172,8 @@ void* olsr_layer_thread(void* arg)
                 printf("OLSR: Route request for destination %u (req_id=%u)\n", dest, req_id);
                 
                 // Look up next hop
-                uint8_t next_hop = lookup_next_hop(dest);
+                uint8_t hop_count;
+                uint8_t next_hop = lookup_route(dest, &hop_count);
                 
                 // Send response back to RRC
                 LayerMessage response;
@@ -110,7 +181,7 @@ void* olsr_layer_thread(void* arg)
                 response.data.olsr_route_resp.request_id = req_id;
                 response.data.olsr_route_resp.destination_node = dest;
                 response.data.olsr_route_resp.next_hop_node = next_hop;
-                response.data.olsr_route_resp.hop_count = (next_hop == 0xFF) ? 0xFF : 1;
+                response.data.olsr_route_resp.hop_count = hop_count;
                 
                 if (message_queue_enqueue(&olsr_to_rrc_queue, &response, 5000)) {
                     printf("OLSR: Route response sent - next_hop=%u for dest=%u\n", next_hop, dest);
@@ -1,6 +1,14 @@
 /**
  * RRC API Wrappers - Message Queue Based Implementation
  * Extracted from rccv2.c for demo purposes
+ *
+ * Requests are correlated with their responses by header.request_id.
+ * Each outstanding request owns a slot in a pending table; one dispatcher
+ * thread per response queue hands every response to the slot waiting
+ * for it. Callers can therefore issue several requests before waiting,
+ * and concurrent callers never consume each other's responses. Messages
+ * on those queues that are not responses go to the handler registered
+ * with rrc_set_message_handler().
  */
 
 #include <stdio.h>
@@ -8,6 +16,7 @@
 #include <string.h>
 #include <stdbool.h>
 #include <stdint.h>
+#include <time.h>
 #define HAVE_STRUCT_TIMESPEC
 #include "rrc_message_queue.h"
 
@@ -21,41 +30,336 @@ typedef struct {
 #define MAX_NEXT_HOP_STATS 40
 static NextHopUpdateStats next_hop_stats[MAX_NEXT_HOP_STATS];
 static int next_hop_stats_count = 0;
+static pthread_mutex_t next_hop_stats_mutex = PTHREAD_MUTEX_INITIALIZER;
 
 // ============================================================================
-// MESSAGE QUEUE-BASED API IMPLEMENTATIONS
+// REQUEST/RESPONSE CORRELATION
 // ============================================================================
 
+#define DISPATCHER_POLL_MS 200  // Dequeue timeout, bounds shutdown latency
+#define OLSR_BATCH_MAX (MAX_PENDING_REQUESTS / 4)  // Pending slots one olsr_get_next_hops() batch may hold
+
+typedef struct {
+    uint32_t request_id;        // 0 = slot free
+    bool done;
+    LayerMessage response;
+    pthread_cond_t ready;
+} PendingRequest;
+
+static PendingRequest pending[MAX_PENDING_REQUESTS];
+static pthread_mutex_t pending_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t pending_slot_free = PTHREAD_COND_INITIALIZER;
+static int pending_slot_waiters = 0;
+static pthread_once_t dispatcher_once = PTHREAD_ONCE_INIT;
+static bool dispatcher_running = false;
+static RRC_MessageHandler message_handler = NULL;
+
+static MessageQueue *const response_queues[] = {
+    &olsr_to_rrc_queue,
+    &tdma_to_rrc_queue,
+    &phy_to_rrc_queue
+};
+#define NUM_RESPONSE_QUEUES (sizeof(response_queues) / sizeof(response_queues[0]))
+static pthread_t dispatcher_threads[NUM_RESPONSE_QUEUES];
+
+static struct {
+    uint32_t issued;
+    uint32_t completed;
+    uint32_t timed_out;
+    uint32_t orphaned;          // Response arrived after its waiter gave up
+    uint32_t table_full;        // No slot freed up within the request timeout
+    uint32_t forwarded;         // Non-responses passed to the message handler
+    uint32_t unhandled;         // Non-responses dropped, no handler registered
+} correlation_stats = {0};
+
 /**
- * Get next hop for destination from OLSR via message queue
- * Returns next hop node ID, or 0xFF if no route available
+ * True for the message types that answer a request
  */
-uint8_t olsr_get_next_hop(uint8_t destination_node_id)
+static bool is_response(const LayerMessage *msg)
 {
-    LayerMessage msg;
-    msg.type = MSG_OLSR_ROUTE_REQUEST;
-    msg.data.olsr_route_req.request_id = generate_request_id();
-    msg.data.olsr_route_req.destination_node = destination_node_id;
-    
-    // Send request to OLSR layer
-    if (!message_queue_enqueue(&rrc_to_olsr_queue, &msg, 5000)) {
-        return 0xFF; // Timeout - no route
+    switch (msg->header.msg_type) {
+        case MSG_TYPE_OLSR_ROUTE_RESPONSE:
+        case MSG_TYPE_TDMA_SLOT_CHECK_RESPONSE:
+        case MSG_TYPE_TDMA_NC_SLOT_RESPONSE:
+        case MSG_TYPE_PHY_METRICS_RESPONSE:
+        case MSG_TYPE_PHY_LINK_STATUS_RESPONSE:
+        case MSG_TYPE_PHY_PACKET_COUNT_RESPONSE:
+            return true;
+        default:
+            return false;
     }
-    
-    // Wait for response with timeout
-    LayerMessage response;
-    if (!message_queue_dequeue(&olsr_to_rrc_queue, &response, 5000)) {
-        return 0xFF; // Timeout
+}
+
+/**
+ * Register the handler for messages on the response queues that are not
+ * responses (e.g. OLSR HELLO payloads for the NC slot). It runs on the
+ * dispatcher thread of the queue the message arrived on.
+ */
+void rrc_set_message_handler(RRC_MessageHandler handler)
+{
+    __atomic_store_n(&message_handler, handler, __ATOMIC_RELEASE);
+}
+
+/**
+ * Dispatcher - routes each response on one queue to its pending request
+ * and everything else to the message handler
+ */
+static void* response_dispatcher_thread(void *arg)
+{
+    MessageQueue *queue = (MessageQueue *)arg;
+
+    while (__atomic_load_n(&dispatcher_running, __ATOMIC_ACQUIRE)) {
+        LayerMessage msg;
+        if (message_queue_dequeue(queue, &msg, DISPATCHER_POLL_MS) != 0) {
+            continue;
+        }
+
+        if (!is_response(&msg)) {
+            RRC_MessageHandler handler = __atomic_load_n(&message_handler, __ATOMIC_ACQUIRE);
+            pthread_mutex_lock(&pending_mutex);
+            if (handler) {
+                correlation_stats.forwarded++;
+            } else {
+                correlation_stats.unhandled++;
+            }
+            pthread_mutex_unlock(&pending_mutex);
+            if (handler) {
+                handler(queue, &msg);
+            }
+            continue;
+        }
+
+        uint32_t request_id = msg.header.request_id;
+        bool delivered = false;
+
+        pthread_mutex_lock(&pending_mutex);
+        for (int i = 0; request_id != 0 && i < MAX_PENDING_REQUESTS; i++) {
+            if (pending[i].request_id == request_id && !pending[i].done) {
+                pending[i].response = msg;
+                pending[i].done = true;
+                pthread_cond_signal(&pending[i].ready);
+                delivered = true;
+                break;
+            }
+        }
+        if (!delivered) {
+            correlation_stats.orphaned++;
+        }
+        pthread_mutex_unlock(&pending_mutex);
     }
-    
-    if (response.type != MSG_OLSR_ROUTE_RESPONSE || 
-        response.data.olsr_route_resp.request_id != msg.data.olsr_route_req.request_id) {
-        return 0xFF; // Invalid or mismatched response
+
+    return NULL;
+}
+
+static void start_response_dispatchers(void)
+{
+    for (int i = 0; i < MAX_PENDING_REQUESTS; i++) {
+        pthread_cond_init(&pending[i].ready, NULL);
     }
-    
-    uint8_t next_hop = response.data.olsr_route_resp.next_hop_node;
-    
-    // Track next hop changes
+
+    __atomic_store_n(&dispatcher_running, true, __ATOMIC_RELEASE);
+    for (size_t q = 0; q < NUM_RESPONSE_QUEUES; q++) {
+        if (pthread_create(&dispatcher_threads[q], NULL, response_dispatcher_thread,
+                           response_queues[q]) != 0) {
+            printf("RRC: Failed to start response dispatcher for %s\n",
+                   response_queues[q]->name);
+        }
+    }
+}
+
+/**
+ * Send a request and return without waiting for its response
+ *
+ * The response is matched on msg->header.request_id, which must be
+ * nonzero. The request is registered before it is sent, so a fast
+ * response can never arrive ahead of its pending entry. A full pending
+ * table is waited out; timeout_ms bounds that wait and the send together.
+ * Returns false if no slot freed up or the request queue stayed full
+ * until then.
+ */
+bool rrc_request_async(MessageQueue *queue, const LayerMessage *msg, int timeout_ms,
+                       RRC_Future *future)
+{
+    uint32_t request_id = msg->header.request_id;
+
+    pthread_once(&dispatcher_once, start_response_dispatchers);
+
+    future->slot = -1;
+    future->request_id = request_id;
+    if (request_id == 0) {
+        return false;
+    }
+
+    struct timespec deadline;
+    clock_gettime(CLOCK_REALTIME, &deadline);
+    deadline.tv_sec += timeout_ms / 1000;
+    deadline.tv_nsec += (long)(timeout_ms % 1000) * 1000000L;
+    if (deadline.tv_nsec >= 1000000000L) {
+        deadline.tv_sec++;
+        deadline.tv_nsec -= 1000000000L;
+    }
+
+    pthread_mutex_lock(&pending_mutex);
+    for (;;) {
+        for (int i = 0; i < MAX_PENDING_REQUESTS; i++) {
+            if (pending[i].request_id == 0) {
+                pending[i].request_id = request_id;
+                pending[i].done = false;
+                future->slot = i;
+                break;
+            }
+        }
+        if (future->slot >= 0) {
+            break;
+        }
+        pending_slot_waiters++;
+        int rc = pthread_cond_timedwait(&pending_slot_free, &pending_mutex, &deadline);
+        pending_slot_waiters--;
+        if (rc != 0) {
+            break;
+        }
+    }
+    if (future->slot < 0) {
+        correlation_stats.table_full++;
+    } else {
+        correlation_stats.issued++;
+    }
+    pthread_mutex_unlock(&pending_mutex);
+
+    if (future->slot < 0) {
+        return false;
+    }
+
+    struct timespec now;
+    clock_gettime(CLOCK_REALTIME, &now);
+    long long left_ms = (long long)(deadline.tv_sec - now.tv_sec) * 1000LL +
+                        (deadline.tv_nsec - now.tv_nsec) / 1000000L;
+    if (message_queue_enqueue(queue, msg, left_ms > 0 ? (int)left_ms : 0) != 0) {
+        rrc_future_cancel(future);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Free a pending slot and wake one request waiting for it
+ * Caller holds pending_mutex
+ */
+static void release_pending_slot(int slot)
+{
+    pending[slot].request_id = 0;
+    pending[slot].done = false;
+    if (pending_slot_waiters > 0) {
+        pthread_cond_signal(&pending_slot_free);
+    }
+}
+
+/**
+ * Wait for the response to an async request and release its slot
+ * Returns false on timeout; a response arriving later is dropped
+ */
+bool rrc_future_wait(RRC_Future *future, LayerMessage *response, int timeout_ms)
+{
+    if (future->slot < 0) {
+        return false;
+    }
+
+    struct timespec deadline;
+    clock_gettime(CLOCK_REALTIME, &deadline);
+    deadline.tv_sec += timeout_ms / 1000;
+    deadline.tv_nsec += (long)(timeout_ms % 1000) * 1000000L;
+    if (deadline.tv_nsec >= 1000000000L) {
+        deadline.tv_sec++;
+        deadline.tv_nsec -= 1000000000L;
+    }
+
+    PendingRequest *req = &pending[future->slot];
+
+    pthread_mutex_lock(&pending_mutex);
+    while (!req->done) {
+        if (pthread_cond_timedwait(&req->ready, &pending_mutex, &deadline) != 0) {
+            break;
+        }
+    }
+
+    bool done = req->done;
+    if (done) {
+        *response = req->response;
+        correlation_stats.completed++;
+    } else {
+        correlation_stats.timed_out++;
+    }
+    release_pending_slot(future->slot);
+    pthread_mutex_unlock(&pending_mutex);
+
+    future->slot = -1;
+    return done;
+}
+
+/**
+ * Abandon an async request without waiting for it
+ */
+void rrc_future_cancel(RRC_Future *future)
+{
+    if (future->slot < 0) {
+        return;
+    }
+
+    pthread_mutex_lock(&pending_mutex);
+    release_pending_slot(future->slot);
+    pthread_mutex_unlock(&pending_mutex);
+
+    future->slot = -1;
+}
+
+/**
+ * Send a request and wait for the response that matches it
+ */
+static bool rrc_request(MessageQueue *queue, const LayerMessage *msg, LayerMessage *response)
+{
+    RRC_Future future;
+    if (!rrc_request_async(queue, msg, REQUEST_TIMEOUT_MS, &future)) {
+        return false;
+    }
+    return rrc_future_wait(&future, response, REQUEST_TIMEOUT_MS);
+}
+
+/**
+ * Stop the response dispatchers; outstanding waiters time out
+ */
+void rrc_correlation_shutdown(void)
+{
+    if (!__atomic_exchange_n(&dispatcher_running, false, __ATOMIC_ACQ_REL)) {
+        return;
+    }
+    for (size_t q = 0; q < NUM_RESPONSE_QUEUES; q++) {
+        pthread_join(dispatcher_threads[q], NULL);
+    }
+}
+
+void print_correlation_stats(void)
+{
+    pthread_mutex_lock(&pending_mutex);
+    printf("Requests: %u issued, %u completed, %u timed out, %u orphaned responses, %u table full\n",
+           correlation_stats.issued, correlation_stats.completed, correlation_stats.timed_out,
+           correlation_stats.orphaned, correlation_stats.table_full);
+    printf("Other messages: %u forwarded, %u unhandled\n",
+           correlation_stats.forwarded, correlation_stats.unhandled);
+    pthread_mutex_unlock(&pending_mutex);
+}
+
+// ============================================================================
+// MESSAGE QUEUE-BASED API IMPLEMENTATIONS
+// ============================================================================
+
+/**
+ * Record a next hop answer; frequent changes trigger route rediscovery
+ */
+static void track_next_hop(uint8_t destination_node_id, uint8_t next_hop)
+{
+    bool rediscover = false;
+
+    pthread_mutex_lock(&next_hop_stats_mutex);
     int stat_idx = -1;
     for (int i = 0; i < next_hop_stats_count; i++) {
         if (next_hop_stats[i].dest_node == destination_node_id) {
@@ -78,27 +382,130 @@ uint8_t olsr_get_next_hop(uint8_t destination_node_id)
             
             // If next hop changes frequently (>5 times), trigger route rediscovery
             if (next_hop_stats[stat_idx].update_count > 5) {
-                olsr_trigger_route_discovery(destination_node_id);
+                rediscover = true;
                 next_hop_stats[stat_idx].update_count = 0; // Reset counter
             }
         }
         next_hop_stats[stat_idx].last_next_hop = next_hop;
     }
+    pthread_mutex_unlock(&next_hop_stats_mutex);
+
+    if (rediscover) {
+        olsr_trigger_route_discovery(destination_node_id);
+    }
+}
+
+/**
+ * Start a message: zeroed, typed, with a fresh request_id
+ */
+static void init_message(LayerMessage *msg, MessageType type)
+{
+    memset(msg, 0, sizeof(*msg));
+    msg->header.msg_type = type;
+    msg->header.request_id = generate_request_id();
+    msg->header.timestamp = (uint32_t)time(NULL);
+}
+
+static void build_route_request(LayerMessage *msg, uint8_t destination_node_id)
+{
+    init_message(msg, MSG_TYPE_OLSR_ROUTE_REQUEST);
+    msg->olsr_route_req.dest_node = destination_node_id;
+    msg->olsr_route_req.src_node = 0;
+}
+
+/**
+ * Next hop from a route response, 0xFF if OLSR has no route
+ */
+static uint8_t route_response_next_hop(const LayerMessage *response)
+{
+    return response->olsr_route_resp.route_available ? response->olsr_route_resp.next_hop : 0xFF;
+}
+
+/**
+ * Get next hop for destination from OLSR via message queue
+ * Returns next hop node ID, or 0xFF if no route available
+ */
+uint8_t olsr_get_next_hop(uint8_t destination_node_id)
+{
+    LayerMessage msg;
+    build_route_request(&msg, destination_node_id);
+    
+    LayerMessage response;
+    if (!rrc_request(&rrc_to_olsr_queue, &msg, &response)) {
+        return 0xFF; // Timeout - no route
+    }
     
+    uint8_t next_hop = route_response_next_hop(&response);
+    track_next_hop(destination_node_id, next_hop);
     return next_hop;
 }
 
+/**
+ * Milliseconds left until a CLOCK_MONOTONIC deadline, never negative
+ */
+static int remaining_ms(const struct timespec *deadline)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    long long ms = (long long)(deadline->tv_sec - now.tv_sec) * 1000LL +
+                   (deadline->tv_nsec - now.tv_nsec) / 1000000L;
+    return ms > 0 ? (int)ms : 0;
+}
+
+/**
+ * Get next hops for several destinations with one round trip of latency
+ * Requests go out OLSR_BATCH_MAX at a time, each batch sent before its
+ * first response is awaited; the cap leaves most of the shared pending
+ * table to concurrent callers. The whole call shares one
+ * REQUEST_TIMEOUT_MS deadline; destinations without a route, whose request
+ * failed or that were not answered in time get 0xFF.
+ */
+void olsr_get_next_hops(const uint8_t *destinations, uint8_t *next_hops, int count)
+{
+    RRC_Future futures[OLSR_BATCH_MAX];
+    struct timespec deadline;
+    clock_gettime(CLOCK_MONOTONIC, &deadline);
+    deadline.tv_sec += REQUEST_TIMEOUT_MS / 1000;
+    deadline.tv_nsec += (long)(REQUEST_TIMEOUT_MS % 1000) * 1000000L;
+    if (deadline.tv_nsec >= 1000000000L) {
+        deadline.tv_sec++;
+        deadline.tv_nsec -= 1000000000L;
+    }
+
+    for (int base = 0; base < count; base += OLSR_BATCH_MAX) {
+        int batch = count - base;
+        if (batch > OLSR_BATCH_MAX) {
+            batch = OLSR_BATCH_MAX;
+        }
+
+        for (int i = 0; i < batch; i++) {
+            LayerMessage msg;
+            build_route_request(&msg, destinations[base + i]);
+            rrc_request_async(&rrc_to_olsr_queue, &msg, remaining_ms(&deadline), &futures[i]);
+        }
+
+        // Past the deadline this still collects responses that already arrived
+        for (int i = 0; i < batch; i++) {
+            LayerMessage response;
+            next_hops[base + i] = 0xFF;
+            if (rrc_future_wait(&futures[i], &response, remaining_ms(&deadline))) {
+                next_hops[base + i] = route_response_next_hop(&response);
+                track_next_hop(destinations[base + i], next_hops[base + i]);
+            }
+        }
+    }
+}
+
 /**
  * Trigger route discovery for destination (fire-and-forget)
  */
 void olsr_trigger_route_discovery(uint8_t destination_node_id)
 {
     LayerMessage msg;
-    msg.type = MSG_OLSR_ROUTE_REQUEST;
-    msg.data.olsr_route_req.request_id = generate_request_id();
-    msg.data.olsr_route_req.destination_node = destination_node_id;
+    init_message(&msg, MSG_TYPE_OLSR_TRIGGER_DISCOVERY);
+    msg.olsr_trigger.dest_node = destination_node_id;
     
-    // Fire and forget - just queue the request
+    // Fire and forget - no response is expected
     message_queue_enqueue(&rrc_to_olsr_queue, &msg, 1000);
 }
 
@@ -108,28 +515,16 @@ void olsr_trigger_route_discovery(uint8_t destination_node_id)
 bool tdma_check_slot_available(uint8_t next_hop_node, int priority)
 {
     LayerMessage msg;
-    msg.type = MSG_TDMA_SLOT_CHECK;
-    msg.data.tdma_slot_check.request_id = generate_request_id();
-    msg.data.tdma_slot_check.next_hop_node = next_hop_node;
-    msg.data.tdma_slot_check.priority = priority;
-    
-    // Send request to TDMA layer
-    if (!message_queue_enqueue(&rrc_to_tdma_queue, &msg, 5000)) {
-        return false; // Timeout
-    }
+    init_message(&msg, MSG_TYPE_TDMA_SLOT_CHECK_REQUEST);
+    msg.tdma_check_req.next_hop = next_hop_node;
+    msg.tdma_check_req.priority = priority;
     
-    // Wait for response
     LayerMessage response;
-    if (!message_queue_dequeue(&tdma_to_rrc_queue, &response, 5000)) {
+    if (!rrc_request(&rrc_to_tdma_queue, &msg, &response)) {
         return false; // Timeout
     }
     
-    if (response.type != MSG_TDMA_SLOT_CHECK || 
-        response.data.tdma_slot_check.request_id != msg.data.tdma_slot_check.request_id) {
-        return false; // Invalid response
-    }
-    
-    return response.data.tdma_slot_check.slot_available;
+    return response.tdma_check_resp.slot_available;
 }
 
 /**
@@ -137,34 +532,22 @@ bool tdma_check_slot_available(uint8_t next_hop_node, int priority)
  */
 bool tdma_request_nc_slot(const uint8_t *payload, size_t payload_len, uint8_t *assigned_slot)
 {
-    if (!payload || !assigned_slot || payload_len > MAX_NC_PAYLOAD_SIZE) {
+    LayerMessage msg;
+    if (!payload || !assigned_slot || payload_len > sizeof(msg.tdma_nc_req.payload)) {
         return false;
     }
     
-    LayerMessage msg;
-    msg.type = MSG_TDMA_NC_SLOT_REQUEST;
-    msg.data.tdma_nc_req.request_id = generate_request_id();
-    msg.data.tdma_nc_req.payload_len = payload_len;
-    memcpy(msg.data.tdma_nc_req.payload, payload, payload_len);
+    init_message(&msg, MSG_TYPE_TDMA_NC_SLOT_REQUEST);
+    msg.tdma_nc_req.payload_len = payload_len;
+    memcpy(msg.tdma_nc_req.payload, payload, payload_len);
     
-    // Send request to TDMA layer
-    if (!message_queue_enqueue(&rrc_to_tdma_queue, &msg, 5000)) {
-        return false; // Timeout
-    }
-    
-    // Wait for response
     LayerMessage response;
-    if (!message_queue_dequeue(&tdma_to_rrc_queue, &response, 5000)) {
+    if (!rrc_request(&rrc_to_tdma_queue, &msg, &response)) {
         return false; // Timeout
     }
     
-    if (response.type != MSG_TDMA_NC_SLOT_RESPONSE || 
-        response.data.tdma_nc_resp.request_id != msg.data.tdma_nc_req.request_id) {
-        return false; // Invalid response
-    }
-    
-    if (response.data.tdma_nc_resp.success) {
-        *assigned_slot = response.data.tdma_nc_resp.assigned_slot;
+    if (response.tdma_nc_resp.granted) {
+        *assigned_slot = response.tdma_nc_resp.assigned_slot;
         return true;
     }
     
@@ -177,22 +560,11 @@ bool tdma_request_nc_slot(const uint8_t *payload, size_t payload_len, uint8_t *a
 void phy_get_link_metrics(uint8_t node_id, float *rssi, float *snr, float *per)
 {
     LayerMessage msg;
-    msg.type = MSG_PHY_METRICS_REQUEST;
-    msg.data.phy_metrics_req.request_id = generate_request_id();
-    msg.data.phy_metrics_req.target_node = node_id;
+    init_message(&msg, MSG_TYPE_PHY_METRICS_REQUEST);
+    msg.phy_metrics_req.node_id = node_id;
     
-    // Send request to PHY layer
-    if (!message_queue_enqueue(&rrc_to_phy_queue, &msg, 5000)) {
-        // Timeout - return default poor values
-        if (rssi) *rssi = -120.0f;
-        if (snr) *snr = 0.0f;
-        if (per) *per = 1.0f;
-        return;
-    }
-    
-    // Wait for response
     LayerMessage response;
-    if (!message_queue_dequeue(&phy_to_rrc_queue, &response, 5000)) {
+    if (!rrc_request(&rrc_to_phy_queue, &msg, &response)) {
         // Timeout - return default poor values
         if (rssi) *rssi = -120.0f;
         if (snr) *snr = 0.0f;
@@ -200,19 +572,10 @@ void phy_get_link_metrics(uint8_t node_id, float *rssi, float *snr, float *per)
         return;
     }
     
-    if (response.type != MSG_PHY_METRICS_RESPONSE || 
-        response.data.phy_metrics_resp.request_id != msg.data.phy_metrics_req.request_id) {
-        // Invalid response
-        if (rssi) *rssi = -120.0f;
-        if (snr) *snr = 0.0f;
-        if (per) *per = 1.0f;
-        return;
-    }
-    
     // Return metrics
-    if (rssi) *rssi = response.data.phy_metrics_resp.rssi;
-    if (snr) *snr = response.data.phy_metrics_resp.snr;
-    if (per) *per = response.data.phy_metrics_resp.per;
+    if (rssi) *rssi = response.phy_metrics_resp.rssi_dbm;
+    if (snr) *snr = response.phy_metrics_resp.snr_db;
+    if (per) *per = response.phy_metrics_resp.per_percent;
 }
 
 /**
@@ -221,27 +584,15 @@ void phy_get_link_metrics(uint8_t node_id, float *rssi, float *snr, float *per)
 bool phy_is_link_active(uint8_t node_id)
 {
     LayerMessage msg;
-    msg.type = MSG_PHY_LINK_STATUS;
-    msg.data.phy_link_status.request_id = generate_request_id();
-    msg.data.phy_link_status.target_node = node_id;
+    init_message(&msg, MSG_TYPE_PHY_LINK_STATUS_REQUEST);
+    msg.phy_link_req.node_id = node_id;
     
-    // Send request to PHY layer
-    if (!message_queue_enqueue(&rrc_to_phy_queue, &msg, 5000)) {
-        return false; // Timeout
-    }
-    
-    // Wait for response
     LayerMessage response;
-    if (!message_queue_dequeue(&phy_to_rrc_queue, &response, 5000)) {
+    if (!rrc_request(&rrc_to_phy_queue, &msg, &response)) {
         return false; // Timeout
     }
     
-    if (response.type != MSG_PHY_LINK_STATUS || 
-        response.data.phy_link_status.request_id != msg.data.phy_link_status.request_id) {
-        return false; // Invalid response
-    }
-    
-    return response.data.phy_link_status.is_active;
+    return response.phy_link_resp.link_active;
 }
 
 /**
@@ -250,25 +601,13 @@ bool phy_is_link_active(uint8_t node_id)
 uint32_t phy_get_packet_count(uint8_t node_id)
 {
     LayerMessage msg;
-    msg.type = MSG_PHY_PACKET_COUNT;
-    msg.data.phy_packet_count.request_id = generate_request_id();
-    msg.data.phy_packet_count.target_node = node_id;
-    
-    // Send request to PHY layer
-    if (!message_queue_enqueue(&rrc_to_phy_queue, &msg, 5000)) {
-        return 0; // Timeout
-    }
+    init_message(&msg, MSG_TYPE_PHY_PACKET_COUNT_REQUEST);
+    msg.phy_count_req.node_id = node_id;
     
-    // Wait for response
     LayerMessage response;
-    if (!message_queue_dequeue(&phy_to_rrc_queue, &response, 5000)) {
+    if (!rrc_request(&rrc_to_phy_queue, &msg, &response)) {
         return 0; // Timeout
     }
     
-    if (response.type != MSG_PHY_PACKET_COUNT || 
-        response.data.phy_packet_count.request_id != msg.data.phy_packet_count.request_id) {
-        return 0; // Invalid response
-    }
-    
-    return response.data.phy_packet_count.packet_count;
+    return response.phy_count_resp.packet_count;
 }
@@ -0,0 +1,126 @@
+/**
+ * Request/Response Correlation Test Program
+ * Drives rrc_api_wrappers.c against a scripted OLSR peer: one route
+ * request answered in time, one left unanswered until it times out,
+ * and one non-response message handed to the registered handler.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include "rrc_message_queue.h"
+
+static int failures = 0;
+
+#define CHECK(cond, what) do { \
+    if (cond) { \
+        printf("PASS: %s\n", what); \
+    } else { \
+        printf("FAIL: %s\n", what); \
+        failures++; \
+    } \
+} while (0)
+
+static volatile uint32_t handled_type = 0;
+
+static void record_message(MessageQueue *source, const LayerMessage *msg)
+{
+    if (source == &olsr_to_rrc_queue) {
+        __atomic_store_n(&handled_type, (uint32_t)msg->header.msg_type, __ATOMIC_RELEASE);
+    }
+}
+
+// OLSR side: answer the next route request with next_hop, or swallow it
+static void* olsr_peer(void *arg)
+{
+    uint8_t next_hop = *(const uint8_t *)arg;
+    LayerMessage request;
+
+    if (message_queue_dequeue(&rrc_to_olsr_queue, &request, 2000) != 0 ||
+        request.header.msg_type != MSG_TYPE_OLSR_ROUTE_REQUEST) {
+        return NULL;
+    }
+    if (next_hop == 0) {
+        return NULL;
+    }
+
+    LayerMessage response;
+    memset(&response, 0, sizeof(response));
+    response.header.msg_type = MSG_TYPE_OLSR_ROUTE_RESPONSE;
+    response.header.request_id = request.header.request_id;
+    response.olsr_route_resp.dest_node = request.olsr_route_req.dest_node;
+    response.olsr_route_resp.next_hop = next_hop;
+    response.olsr_route_resp.route_available = true;
+    message_queue_enqueue(&olsr_to_rrc_queue, &response, 1000);
+    return NULL;
+}
+
+static void test_round_trip(void)
+{
+    uint8_t next_hop = 7;
+    pthread_t peer;
+    pthread_create(&peer, NULL, olsr_peer, &next_hop);
+
+    CHECK(olsr_get_next_hop(3) == 7, "route request answered with the peer's next hop");
+    pthread_join(peer, NULL);
+}
+
+static void test_timeout(void)
+{
+    uint8_t silent = 0;
+    pthread_t peer;
+    pthread_create(&peer, NULL, olsr_peer, &silent);
+
+    LayerMessage request;
+    memset(&request, 0, sizeof(request));
+    request.header.msg_type = MSG_TYPE_OLSR_ROUTE_REQUEST;
+    request.header.request_id = generate_request_id();
+    request.olsr_route_req.dest_node = 4;
+
+    RRC_Future future;
+    LayerMessage response;
+    CHECK(rrc_request_async(&rrc_to_olsr_queue, &request, 1000, &future), "request registered");
+    CHECK(!rrc_future_wait(&future, &response, 100), "unanswered request times out");
+    pthread_join(peer, NULL);
+}
+
+static void test_forwarding(void)
+{
+    rrc_set_message_handler(record_message);
+
+    LayerMessage hello;
+    memset(&hello, 0, sizeof(hello));
+    hello.header.msg_type = MSG_TYPE_OLSR_HELLO_NC;
+    message_queue_enqueue(&olsr_to_rrc_queue, &hello, 1000);
+
+    for (int i = 0; i < 100 && __atomic_load_n(&handled_type, __ATOMIC_ACQUIRE) == 0; i++) {
+        usleep(10000);
+    }
+    CHECK(handled_type == MSG_TYPE_OLSR_HELLO_NC, "non-response forwarded to the handler");
+}
+
+int main(void)
+{
+    MessageQueue *queues[] = {
+        &rrc_to_olsr_queue, &olsr_to_rrc_queue, &rrc_to_tdma_queue,
+        &tdma_to_rrc_queue, &rrc_to_phy_queue, &phy_to_rrc_queue
+    };
+    const char *names[] = { "RRC->OLSR", "OLSR->RRC", "RRC->TDMA", "TDMA->RRC", "RRC->PHY", "PHY->RRC" };
+
+    for (size_t i = 0; i < sizeof(queues) / sizeof(queues[0]); i++) {
+        message_queue_init(queues[i], names[i]);
+    }
+
+    test_round_trip();
+    test_timeout();
+    test_forwarding();
+
+    rrc_correlation_shutdown();
+    print_correlation_stats();
+    for (size_t i = 0; i < sizeof(queues) / sizeof(queues[0]); i++) {
+        message_queue_cleanup(queues[i]);
+    }
+
+    printf("%s\n", failures ? "FAILED" : "ALL TESTS PASSED");
+    return failures ? 1 : 0;
+}
@@ -185,11 +185,28 @@ typedef union {
     RRC_ToAPP_Frame rrc_to_app;
 } LayerMessage;
 
+// Variable-length message ring
+// Each queued message is a record holding only the bytes its type uses:
+// an 8-byte record header, the fixed fields, then the payload. Payloads
+// up to MESSAGE_INLINE_PAYLOAD stay in the record; larger ones live in a
+// pooled buffer and the record carries its index.
+#define MESSAGE_INLINE_PAYLOAD 256
+#define MESSAGE_FIXED_MAX 64            // Largest message excluding its payload array
+#define MESSAGE_RECORD_HEADER 8
+#define MESSAGE_RECORD_MAX (MESSAGE_RECORD_HEADER + MESSAGE_FIXED_MAX + MESSAGE_INLINE_PAYLOAD)
+// One spare record absorbs the padding left when a record wraps, so a
+// free message slot always has room in the ring
+#define MESSAGE_RING_BYTES ((MESSAGE_QUEUE_SIZE + 1) * MESSAGE_RECORD_MAX)
+#define MESSAGE_QUEUE_COUNT 9           // Queues set up by init_all_message_queues()
+// PAYLOAD_SIZE_BYTES buffers shared by all queues, one per slot, so full
+// queues alone cannot drain the pool
+#define MESSAGE_PAYLOAD_POOL_SIZE (MESSAGE_QUEUE_COUNT * MESSAGE_QUEUE_SIZE)
+
 // Message Queue Structure
 typedef struct {
-    LayerMessage buffer[MESSAGE_QUEUE_SIZE];
-    int read_index;
-    int write_index;
+    uint8_t ring[MESSAGE_RING_BYTES] __attribute__((aligned(8)));
+    size_t ring_head;                   // Byte offset of the next record to write
+    size_t ring_tail;                   // Byte offset of the next record to read
     int count;
     pthread_mutex_t mutex;
     sem_t empty_slots;
@@ -197,6 +214,7 @@ typedef struct {
     uint32_t enqueue_count;
     uint32_t dequeue_count;
     uint32_t overflow_count;
+    uint64_t bytes_enqueued;            // Record bytes, for average message size
     char name[64];
 } MessageQueue;
 
@@ -217,8 +235,48 @@ void message_queue_cleanup(MessageQueue *mq);
 int message_queue_enqueue(MessageQueue *mq, const LayerMessage *msg, int timeout_ms);
 int message_queue_dequeue(MessageQueue *mq, LayerMessage *msg, int timeout_ms);
 bool message_queue_has_messages(MessageQueue *mq);
+
+// Bulk payloads by reference: enqueue_ref takes ownership of a buffer
+// from message_payload_alloc(); dequeue_ref hands one back, and the
+// consumer returns it with message_payload_release()
+uint8_t *message_payload_alloc(void);
+void message_payload_release(uint8_t *payload);
+int message_queue_enqueue_ref(MessageQueue *mq, const LayerMessage *msg,
+                              uint8_t *payload, size_t payload_len, int timeout_ms);
+int message_queue_dequeue_ref(MessageQueue *mq, LayerMessage *msg,
+                              uint8_t **payload, size_t *payload_len, int timeout_ms);
 uint32_t generate_request_id(void);
 
+// Request/response correlation (rrc_api_wrappers.c)
+#define MAX_PENDING_REQUESTS 64
+
+// Handle for a request whose response has not been collected yet
+typedef struct {
+    int slot;
+    uint32_t request_id;
+} RRC_Future;
+
+// Handler for messages on the response queues that answer no request
+typedef void (*RRC_MessageHandler)(MessageQueue *source, const LayerMessage *msg);
+
+bool rrc_request_async(MessageQueue *queue, const LayerMessage *msg, int timeout_ms,
+                       RRC_Future *future);
+bool rrc_future_wait(RRC_Future *future, LayerMessage *response, int timeout_ms);
+void rrc_future_cancel(RRC_Future *future);
+void rrc_set_message_handler(RRC_MessageHandler handler);
+void rrc_correlation_shutdown(void);
+void print_correlation_stats(void);
+
+// Layer APIs built on the correlation layer
+uint8_t olsr_get_next_hop(uint8_t destination_node_id);
+void olsr_get_next_hops(const uint8_t *destinations, uint8_t *next_hops, int count);
+void olsr_trigger_route_discovery(uint8_t destination_node_id);
+bool tdma_check_slot_available(uint8_t next_hop_node, int priority);
+bool tdma_request_nc_slot(const uint8_t *payload, size_t payload_len, uint8_t *assigned_slot);
+void phy_get_link_metrics(uint8_t node_id, float *rssi, float *snr, float *per);
+bool phy_is_link_active(uint8_t node_id);
+uint32_t phy_get_packet_count(uint8_t node_id);
+
 // Initialization and cleanup
 void init_all_message_queues(void);
 void cleanup_all_message_queues(void);
@@ -5,10 +5,9 @@
 #include<stdlib.h>
 #include<time.h>
 #include "timesync.h"
-#include "rrc_shared_memory.h"
 
 #define QUEUE_SIZE 10
-#define PAYLOAD_SIZE_BYTES 16
+#define PAYLOAD_SIZE_BYTES 2800   // Must match the RRC (rccv3.c)
 #define NUM_PRIORITY 4
 #define TOTAL_SLOTS 10
 #define SLOT_DURATION_MS 10
@@ -16,17 +15,29 @@
 
 uint8_t node_addr = 0xFE;
 
-// RRC function stubs
-bool rrc_has_nc_packet_for_slot(int slot);
-struct frame rrc_tdma_dequeue_nc_packet(int slot);
+// RRC function stubs (rccv3.c, linked into the same process)
+bool rrc_has_nc_packet_for_slot(uint8_t slot);
+struct frame rrc_tdma_dequeue_nc_packet(uint8_t slot);
 bool rrc_has_relay_packets();
 struct frame rrc_tdma_dequeue_relay_packet();
+bool rrc_has_mcast_packets(void);
+struct frame rrc_tdma_dequeue_mcast_packet(uint8_t *slot_id);
+void rrc_tdma_release_mcast_slot(uint8_t next_hop, uint8_t slot_id);
 bool rrc_has_data_for_priority(int priority);
 void rrc_get_data_for_priority(int priority, struct frame *out);
-int rrc_get_my_nc_slot();
+uint8_t rrc_get_my_nc_slot(void);
 bool rrc_is_neighbor_tx(int node_id, int slot);
 bool rrc_is_neighbor_rx(int node_id, int slot);
 
+// RRC AQM access: false when the class is empty or everything queued was
+// past its deadline or dropped by CoDel
+bool rrc_tdma_pull_data_packet(int priority, struct frame *out);
+// Per-next-hop access; tdma_class is numbered like SCHED_CLASS below
+int rrc_tdma_queued_next_hops(int tdma_class, uint32_t hops[8]);
+bool rrc_tdma_pull_packet_for_hop(int tdma_class, uint8_t next_hop, struct frame *out, uint8_t *slot_id);
+bool rrc_tdma_pull_relay_packet(struct frame *out);
+bool rrc_tdma_pull_analog_voice_packet(struct frame *out);
+
 typedef enum { 
     SLOT_TYPE_MV, 
     SLOT_TYPE_DU, 
@@ -74,13 +85,20 @@ typedef enum{
     DATA_TYPE_CC 
 } DATATYPE;
 
+// Same layout as the RRC's struct frame: frames are pulled from its AQM queues
 struct frame{ 
     uint8_t source_add; 
     uint8_t dest_add; 
     uint8_t next_hop_add; 
+    uint8_t prev_hop_add;
+    uint16_t sequence_number;
+    uint32_t enqueue_time_ms;
+    bool rx_or_l3;
+    int TTL;
     int priority; 
     DATATYPE data_type; 
     char payload[PAYLOAD_SIZE_BYTES]; 
+    int payload_length_bytes;
 };
 
 struct queue{ 
@@ -94,11 +112,6 @@ static struct tdma_state tdma_state = {
     .frame_count = 0 
 };
 
-static struct queue analog_voice_queue = { 
-    .front = -1, 
-    .back = -1 
-};
-
 bool is_empty(struct queue *q) { 
     return (q->front == -1 || q->front > q->back); 
 }
@@ -123,6 +136,257 @@ struct frame dequeue(struct queue *q){
     return dequeued_frame;
 }
 
+// ============================================================================
+// SLOT SCHEDULER
+// ============================================================================
+//
+// DU/GU slots are filled by a pluggable scheduler. DU slots carry P0 and
+// P1, GU slots relay, multicast, P2 and P3. Digital voice (P0) is always
+// served first in a DU slot; the other classes of the slot type share the
+// rest. The default DRR scheduler keeps one flow per (class, next hop) and
+// gives every flow its class `weight` in slots per round, so neither a busy
+// class nor a congested next hop can starve the others. Frames stay in the
+// RRC's AQM queues until the slot they are sent in: deadline and CoDel drops
+// and make-before-break re-targeting see exactly what is transmitted, and
+// a flow holding only expired frames is never credited.
+
+// Numbered like the RRC's TDMA classes (data priority 0-3, relay, mcast)
+typedef enum {
+    SCHED_CLASS_P0 = 0,     // Digital voice, strict priority
+    SCHED_CLASS_P1,         // Video
+    SCHED_CLASS_P2,         // File transfer
+    SCHED_CLASS_P3,         // SMS
+    SCHED_CLASS_RELAY,      // Multi-hop forwarding
+    SCHED_CLASS_MCAST,      // Broadcast/multicast fan-out and MPR flooding
+    SCHED_CLASS_COUNT
+} SCHED_CLASS;
+
+typedef struct {
+    const char* name;
+    void (*init)(void);
+    // Pick the frame for a DU/GU slot; returns false when idle
+    bool (*select)(SLOT_TYPE slot_type, struct frame* out, SCHED_CLASS* out_class);
+} tdma_slot_scheduler;
+
+static const char* sched_class_names[SCHED_CLASS_COUNT] = {
+    "P0 voice", "P1 video", "P2 file", "P3 sms", "relay", "mcast"
+};
+
+// Slots per DRR round for each flow of a class (P0 is strict and ignores its weight)
+static int sched_weights[SCHED_CLASS_COUNT] = { 0, 4, 2, 1, 3, 2 };
+
+// Slot type each class may be sent in
+static const SLOT_TYPE sched_class_slot[SCHED_CLASS_COUNT] = {
+    SLOT_TYPE_DU, SLOT_TYPE_DU, SLOT_TYPE_GU, SLOT_TYPE_GU, SLOT_TYPE_GU, SLOT_TYPE_GU
+};
+
+static struct {
+    uint32_t tx_frames;
+    uint32_t tx_bytes;
+} sched_class_stats[SCHED_CLASS_COUNT];
+
+static uint32_t sched_slots_offered = 0;
+
+// DU/GU slot the RRC reserved for the multicast copy being sent, released after TX
+static uint8_t sched_mcast_slot = 255;
+
+// DRR state: a deficit per (class, next hop) flow, and per slot type the
+// flow whose turn it is (DU and GU slots serve disjoint classes)
+#define SCHED_FLOW_BITS 256     // One flow per uint8_t next hop in each class
+typedef struct {
+    int sched_class;
+    int next_hop;
+    bool turn_started;
+} drr_cursor;
+
+static int drr_deficit[SCHED_CLASS_COUNT][SCHED_FLOW_BITS];
+static drr_cursor drr_cursors[2];   // [0] DU, [1] GU
+
+void tdma_sched_set_weight(SCHED_CLASS sched_class, int weight) {
+    if (sched_class <= SCHED_CLASS_P0 || sched_class >= SCHED_CLASS_COUNT || weight < 1) return;
+    sched_weights[sched_class] = weight;
+    printf("[SCHED] Weight %s = %d\n", sched_class_names[sched_class], weight);
+}
+
+static bool sched_pull_class(SCHED_CLASS sched_class, struct frame* out) {
+    if (sched_class == SCHED_CLASS_RELAY) {
+        return rrc_tdma_pull_relay_packet(out);
+    }
+    if (sched_class == SCHED_CLASS_MCAST) {
+        // One descriptor per next hop; the copy carries that hop in next_hop_add
+        if (!rrc_has_mcast_packets()) return false;
+        *out = rrc_tdma_dequeue_mcast_packet(&sched_mcast_slot);
+        return true;
+    }
+    return rrc_tdma_pull_data_packet((int)sched_class, out);
+}
+
+static bool sched_pull_flow(SCHED_CLASS sched_class, uint8_t next_hop, struct frame* out) {
+    uint8_t slot_id = 255;
+    if (!rrc_tdma_pull_packet_for_hop((int)sched_class, next_hop, out, &slot_id)) return false;
+    if (sched_class == SCHED_CLASS_MCAST) sched_mcast_slot = slot_id;
+    return true;
+}
+
+static void sched_account(SCHED_CLASS sched_class, const struct frame* f) {
+    sched_class_stats[sched_class].tx_frames++;
+    sched_class_stats[sched_class].tx_bytes += (uint32_t)f->payload_length_bytes;
+}
+
+// ---------------------------------------------------------------------------
+// Strict priority (legacy behaviour: DU serves P0,P1; GU serves relay,mcast,P2,P3)
+// ---------------------------------------------------------------------------
+
+static void strict_init(void) {
+}
+
+static bool strict_select(SLOT_TYPE slot_type, struct frame* out, SCHED_CLASS* out_class) {
+    static const SCHED_CLASS du_order[] = { SCHED_CLASS_P0, SCHED_CLASS_P1 };
+    static const SCHED_CLASS gu_order[] = {
+        SCHED_CLASS_RELAY, SCHED_CLASS_MCAST, SCHED_CLASS_P2, SCHED_CLASS_P3
+    };
+    const SCHED_CLASS* order = (slot_type == SLOT_TYPE_DU) ? du_order : gu_order;
+    int n = (slot_type == SLOT_TYPE_DU) ? 2 : 4;
+
+    for (int i = 0; i < n; i++) {
+        if (sched_pull_class(order[i], out)) {
+            *out_class = order[i];
+            return true;
+        }
+    }
+    return false;
+}
+
+static const tdma_slot_scheduler strict_scheduler = {
+    "strict", strict_init, strict_select
+};
+
+// ---------------------------------------------------------------------------
+// Deficit round robin per (class, next hop)
+// ---------------------------------------------------------------------------
+
+static void drr_init(void) {
+    memset(drr_deficit, 0, sizeof(drr_deficit));
+    memset(drr_cursors, 0, sizeof(drr_cursors));
+    drr_cursors[0].sched_class = SCHED_CLASS_P1;
+    drr_cursors[1].sched_class = SCHED_CLASS_RELAY;
+}
+
+// Hand the turn to the next queued flow after the cursor's, wrapping
+// around classes P1..MCAST; flows[c] holds one bit per next hop of class c
+static void drr_next_flow(drr_cursor* cur, uint32_t flows[SCHED_CLASS_COUNT][SCHED_FLOW_BITS / 32]) {
+    const int total = (SCHED_CLASS_COUNT - SCHED_CLASS_P1) * SCHED_FLOW_BITS;
+    int start = (cur->sched_class - SCHED_CLASS_P1) * SCHED_FLOW_BITS + cur->next_hop + 1;
+
+    cur->turn_started = false;
+    for (int n = 0; n <= total; ) {
+        int bit = (start + n) % total;
+        int c = SCHED_CLASS_P1 + bit / SCHED_FLOW_BITS;
+        uint32_t word = flows[c][(bit % SCHED_FLOW_BITS) / 32] >> (bit % 32);
+        if (word) {
+            bit += __builtin_ctz(word);
+            cur->sched_class = SCHED_CLASS_P1 + bit / SCHED_FLOW_BITS;
+            cur->next_hop = bit % SCHED_FLOW_BITS;
+            return;
+        }
+        n += 32 - bit % 32;
+    }
+}
+
+static bool drr_select(SLOT_TYPE slot_type, struct frame* out, SCHED_CLASS* out_class) {
+    // Voice keeps strict priority in DU slots
+    if (slot_type == SLOT_TYPE_DU && sched_pull_class(SCHED_CLASS_P0, out)) {
+        *out_class = SCHED_CLASS_P0;
+        return true;
+    }
+
+    // Flows of this slot type with live frames; expired ones were dropped by
+    // the RRC here, before any of them could be credited
+    uint32_t flows[SCHED_CLASS_COUNT][SCHED_FLOW_BITS / 32];
+    int flow_count = 0;
+    memset(flows, 0, sizeof(flows));
+    for (int c = SCHED_CLASS_P1; c < SCHED_CLASS_COUNT; c++) {
+        if (sched_class_slot[c] == slot_type) {
+            flow_count += rrc_tdma_queued_next_hops(c, flows[c]);
+        }
+    }
+    if (flow_count == 0) return false;
+
+    // At most one visit per flow; an idle flow forfeits the rest of its turn
+    drr_cursor* cur = &drr_cursors[slot_type == SLOT_TYPE_DU ? 0 : 1];
+    for (int visited = 0; visited <= flow_count; visited++) {
+        SCHED_CLASS c = (SCHED_CLASS)cur->sched_class;
+        int hop = cur->next_hop;
+
+        if (!(flows[c][hop / 32] & (1u << (hop % 32)))) {
+            drr_deficit[c][hop] = 0;
+            drr_next_flow(cur, flows);
+            continue;
+        }
+        if (!cur->turn_started) {
+            drr_deficit[c][hop] += sched_weights[c];
+            cur->turn_started = true;
+        }
+        if (drr_deficit[c][hop] >= 1 && sched_pull_flow(c, (uint8_t)hop, out)) {
+            *out_class = c;
+            if (--drr_deficit[c][hop] < 1) drr_next_flow(cur, flows);
+            return true;
+        }
+
+        drr_deficit[c][hop] = 0;
+        drr_next_flow(cur, flows);
+    }
+    return false;
+}
+
+static const tdma_slot_scheduler drr_scheduler = {
+    "drr", drr_init, drr_select
+};
+
+static const tdma_slot_scheduler* active_scheduler = &drr_scheduler;
+
+static const tdma_slot_scheduler* const tdma_schedulers[] = {
+    &drr_scheduler, &strict_scheduler
+};
+
+// Scheduler by name ("drr", "strict"), NULL if there is none
+const tdma_slot_scheduler* tdma_get_scheduler(const char* name) {
+    for (size_t i = 0; i < sizeof(tdma_schedulers) / sizeof(tdma_schedulers[0]); i++) {
+        if (strcmp(tdma_schedulers[i]->name, name) == 0) return tdma_schedulers[i];
+    }
+    return NULL;
+}
+
+void tdma_set_scheduler(const tdma_slot_scheduler* sched) {
+    if (sched == NULL) return;
+    active_scheduler = sched;
+    active_scheduler->init();
+    printf("[SCHED] Using %s scheduler\n", sched->name);
+}
+
+void tdma_sched_print_stats(void) {
+    uint32_t total = 0;
+    int weight_total = 0;
+    for (int c = SCHED_CLASS_P1; c < SCHED_CLASS_COUNT; c++) {
+        total += sched_class_stats[c].tx_frames;
+        weight_total += sched_weights[c];
+    }
+
+    printf("\n=== TDMA Scheduler (%s) ===\n", active_scheduler->name);
+    printf("Slots offered: %u\n", sched_slots_offered);
+    printf("%-10s %8s %10s %8s %8s\n", "Class", "Frames", "Bytes", "Share%", "Weight%");
+    for (int c = 0; c < SCHED_CLASS_COUNT; c++) {
+        double share = 0.0, wshare = 0.0;
+        if (c != SCHED_CLASS_P0) {
+            share = total ? 100.0 * sched_class_stats[c].tx_frames / total : 0.0;
+            wshare = weight_total ? 100.0 * sched_weights[c] / weight_total : 0.0;
+        }
+        printf("%-10s %8u %10u %8.1f %8.1f\n", sched_class_names[c],
+               sched_class_stats[c].tx_frames, sched_class_stats[c].tx_bytes, share, wshare);
+    }
+    printf("================================\n");
+}
+
 void phy_transmit_frame(struct frame *f) {
     printf("-> [PHY_TX] Frame (P:%d T:%d S:0x%02X D:0x%02X)\n", 
            f->priority, f->data_type, f->source_add, f->dest_add);
@@ -153,8 +417,9 @@ void receive_control_confirm(void) {
 
 void end_call(void) {
     tdma_state.voice_status = VOICE_INACTIVE;
-    while(!is_empty(&analog_voice_queue)) 
-        dequeue(&analog_voice_queue);
+    struct frame stale;
+    while (rrc_tdma_pull_analog_voice_packet(&stale))
+        ;
     printf("[END] Call ended.\n");
 }
 
@@ -166,11 +431,6 @@ void tdma_scheduler_process(void) {
         return;
     }
     
-    if (rrc_shm == NULL || !rrc_shm->rrc_initialized) {
-        printf("[SCHED] RRC not ready.\n");
-        return;
-    }
-    
     int current_slot_id = (sync_info->current_slot % TOTAL_SLOTS) + 1;
     struct slot_definition current_slot = TDMA_FRAME_SCHEDULE[current_slot_id - 1];
     
@@ -192,92 +452,56 @@ void tdma_scheduler_process(void) {
     switch (current_slot.type) {
         case SLOT_TYPE_MV: {
             if (tdma_state.voice_status == VOICE_ACTIVE_TX) {
-                if (!is_empty(&analog_voice_queue)) {
-                    struct frame voice_frame = dequeue(&analog_voice_queue);
+                struct frame voice_frame;
+                if (rrc_tdma_pull_analog_voice_packet(&voice_frame)) {
                     printf("-> [MV] Voice TX\n");
                     phy_transmit_frame(&voice_frame);
                     return;
                 }
             }
             
-            if (rrc_shm_has_data_for_priority(0)) {
-                struct frame prio0_frame;
-                if (rrc_shm_get_data_for_priority(0, &prio0_frame)) {
-                    printf("-> [MV] P0 TX\n");
-                    phy_transmit_frame(&prio0_frame);
-                    return;
-                }
+            struct frame prio0_frame;
+            if (rrc_tdma_pull_data_packet(0, &prio0_frame)) {
+                printf("-> [MV] P0 TX\n");
+                phy_transmit_frame(&prio0_frame);
+                return;
             }
             
             printf("-> [MV] Idle\n");
             break;
         }
         
-        case SLOT_TYPE_DU: {
-            if (rrc_shm_has_data_for_priority(0)) {
-                struct frame prio0_frame;
-                if (rrc_shm_get_data_for_priority(0, &prio0_frame)) {
-                    printf("-> [DU] P0 TX\n");
-                    phy_transmit_frame(&prio0_frame);
-                    return;
-                }
-            }
-            
-            if (rrc_shm_has_data_for_priority(1)) {
-                struct frame prio1_frame;
-                if (rrc_shm_get_data_for_priority(1, &prio1_frame)) {
-                    printf("-> [DU] P1 TX\n");
-                    phy_transmit_frame(&prio1_frame);
-                    return;
-                }
-            }
-            
-            printf("-> [DU] Idle\n");
-            break;
-        }
-        
+        case SLOT_TYPE_DU:
         case SLOT_TYPE_GU: {
-            if (rrc_shm_has_relay_packets()) {
-                struct frame relay_frame;
-                if (rrc_shm_dequeue_relay_packet(&relay_frame)) {
-                    printf("-> [GU] Relay TX\n");
-                    phy_transmit_frame(&relay_frame);
-                    return;
-                }
-            }
-            
-            if (rrc_shm_has_data_for_priority(2)) {
-                struct frame prio2_frame;
-                if (rrc_shm_get_data_for_priority(2, &prio2_frame)) {
-                    printf("-> [GU] P2 TX\n");
-                    phy_transmit_frame(&prio2_frame);
-                    return;
-                }
-            }
-            
-            if (rrc_shm_has_data_for_priority(3)) {
-                struct frame prio3_frame;
-                if (rrc_shm_get_data_for_priority(3, &prio3_frame)) {
-                    printf("-> [GU] P3 TX\n");
-                    phy_transmit_frame(&prio3_frame);
-                    return;
+            const char* tag = (current_slot.type == SLOT_TYPE_DU) ? "DU" : "GU";
+            struct frame data_frame;
+            SCHED_CLASS sched_class;
+
+            sched_slots_offered++;
+            if (active_scheduler->select(current_slot.type, &data_frame, &sched_class)) {
+                printf("-> [%s] %s TX (next hop 0x%02X)\n", tag,
+                       sched_class_names[sched_class], data_frame.next_hop_add);
+                sched_account(sched_class, &data_frame);
+                phy_transmit_frame(&data_frame);
+                if (sched_class == SCHED_CLASS_MCAST) {
+                    rrc_tdma_release_mcast_slot(data_frame.next_hop_add, sched_mcast_slot);
+                    sched_mcast_slot = 255;
                 }
+                return;
             }
-            
-            printf("-> [GU] Idle\n");
+
+            printf("-> [%s] Idle\n", tag);
             break;
         }
         
         case SLOT_TYPE_NC: {
-            int my_nc_slot = rrc_shm_get_my_nc_slot();
+            int my_nc_slot = rrc_get_my_nc_slot();
             if (current_slot.slot_id == my_nc_slot) {
-                if (rrc_shm_has_nc_packet_for_slot(current_slot.slot_id)) {
-                    struct frame nc_frame;
-                    if (rrc_shm_dequeue_nc_packet(current_slot.slot_id, &nc_frame)) {
-                        printf("-> [NC] TX slot %d\n", my_nc_slot);
-                        phy_transmit_frame(&nc_frame);
-                        return;
-                    }
+                if (rrc_has_nc_packet_for_slot((uint8_t)current_slot.slot_id)) {
+                    struct frame nc_frame = rrc_tdma_dequeue_nc_packet((uint8_t)current_slot.slot_id);
+                    printf("-> [NC] TX slot %d\n", my_nc_slot);
+                    phy_transmit_frame(&nc_frame);
+                    return;
                 }
                 printf("-> [NC] No packet\n");
             } else {
@@ -310,40 +534,31 @@ void tdma_handle_received_frame(struct frame *received_frame, int rssi, int snr)
 }
 
 void tdma_init(void) {
-    if (!rrc_shared_memory_init()) {
-        printf("[TDMA] RRC init failed\n");
-        return;
-    }
-    printf("[TDMA] Init OK\n");
+    active_scheduler->init();
+    printf("[TDMA] Init OK (%s scheduler)\n", active_scheduler->name);
 }
 
-int main(){
+#ifndef TDMA_NO_MAIN
+// Usage: TDMA_CODE [drr|strict]
+int main(int argc, char* argv[]){
     srand(time(NULL));
     printf("\n--- TDMA-TimeSync-RRC Test ---\n");
     
+    if (argc > 1) {
+        const tdma_slot_scheduler* sched = tdma_get_scheduler(argv[1]);
+        if (sched == NULL) {
+            fprintf(stderr, "[MAIN] Unknown scheduler '%s' (drr, strict)\n", argv[1]);
+            return 1;
+        }
+        active_scheduler = sched;
+    }
+    
     network_time_sync_init();
     tdma_init();
     printf("[MAIN] Init complete\n");
     
-    if (rrc_shm != NULL) {
-        struct frame test_frame = { 
-            .source_add = node_addr, 
-            .dest_add = 0xFF, 
-            .priority = 1, 
-            .data_type = DATA_TYPE_SMS 
-        };
-        strcpy(test_frame.payload, "Test data");
-        
-        pthread_mutex_lock(&rrc_shm->priority_queues[1].mutex);
-        if (!RRC_QUEUE_IS_FULL(&rrc_shm->priority_queues[1])) {
-            rrc_shm->priority_queues[1].frames[rrc_shm->priority_queues[1].tail] = test_frame;
-            rrc_shm->priority_queues[1].tail = (rrc_shm->priority_queues[1].tail + 1) % RRC_QUEUE_SIZE;
-            rrc_shm->priority_queues[1].count++;
-        }
-        pthread_mutex_unlock(&rrc_shm->priority_queues[1].mutex);
-        
-        printf("[TEST] Added frame\n");
-    }
+    // Data, relay and voice frames come from the RRC's AQM queues
+    // (rrc_tdma_pull_*), so the slots below carry whatever the RRC has queued
     
     printf("\n--- Test 10 slots ---\n");
     for (int i = 0; i < 10; i++) {
@@ -351,6 +566,7 @@ int main(){
         on_slot_timer_interrupt();
     }
     
-    rrc_shared_memory_cleanup();
+    tdma_sched_print_stats();
     return 0;
 }
+#endif // TDMA_NO_MAIN
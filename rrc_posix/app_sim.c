@@ -87,8 +87,8 @@ void check_received_frames(void) {
     printf("[APP] Received frame notification: pool_index=%d\n", msg.pool_index);
     
     // Get frame from shared memory
-    FramePoolEntry* frame = frame_pool_get(&frame_pool, msg.pool_index);
-    if (!frame || !frame->in_use || !frame->valid) {
+    FramePoolEntry* frame = frame_pool_get_gen(&frame_pool, msg.pool_index, msg.generation);
+    if (!frame || !frame->valid) {
         fprintf(stderr, "[APP] Invalid frame at pool_index=%d\n", msg.pool_index);
         return;
     }
@@ -98,7 +98,7 @@ void check_received_frames(void) {
     printf("[APP] Payload: '%s'\n", (char*)frame->payload);
     
     // Release frame from pool
-    frame_pool_release(&frame_pool, msg.pool_index);
+    frame_pool_release_gen(&frame_pool, msg.pool_index, msg.generation);
     
     printf("[APP] Frame processed and released\n\n");
 }
@@ -0,0 +1,110 @@
+/**
+ * Duplicate Cache Test Program
+ * Checks the RECEIVED/FORWARDED flags, ageing after the hold time and
+ * eviction when a probe window fills up, on a simulated clock.
+ */
+
+#include <stdio.h>
+#include "rrc_dup_cache.h"
+
+static int failures = 0;
+
+#define CHECK(cond, what) do { \
+    if (cond) { \
+        printf("PASS: %s\n", what); \
+    } else { \
+        printf("FAIL: %s\n", what); \
+        failures++; \
+    } \
+} while (0)
+
+static RRC_DupCache cache;
+
+static void test_flags(void)
+{
+    uint32_t now = 1000;
+    rrc_dup_cache_clear(&cache);
+
+    CHECK(!rrc_dup_cache_test_and_set_at(&cache, 5, 42, RRC_DUP_FLAG_RECEIVED, now),
+          "first copy is not a duplicate");
+    CHECK(rrc_dup_cache_test_and_set_at(&cache, 5, 42, RRC_DUP_FLAG_RECEIVED, now),
+          "second copy is a duplicate");
+    CHECK(!rrc_dup_cache_test_and_set_at(&cache, 6, 42, RRC_DUP_FLAG_RECEIVED, now) &&
+          !rrc_dup_cache_test_and_set_at(&cache, 5, 43, RRC_DUP_FLAG_RECEIVED, now),
+          "other source or sequence is not a duplicate");
+
+    CHECK(!rrc_dup_cache_test_at(&cache, 5, 42, RRC_DUP_FLAG_FORWARDED, now),
+          "RECEIVED does not imply FORWARDED");
+    CHECK(!rrc_dup_cache_test_at(&cache, 5, 42, RRC_DUP_FLAG_FORWARDED, now),
+          "test does not set the flag");
+    rrc_dup_cache_set_at(&cache, 5, 42, RRC_DUP_FLAG_FORWARDED, now);
+    CHECK(rrc_dup_cache_test_at(&cache, 5, 42, RRC_DUP_FLAG_FORWARDED, now) &&
+          rrc_dup_cache_test_at(&cache, 5, 42, RRC_DUP_FLAG_RECEIVED, now),
+          "set adds FORWARDED and keeps RECEIVED");
+
+    rrc_dup_cache_test_at(&cache, 9, 9, RRC_DUP_FLAG_RECEIVED, now);
+    CHECK(rrc_dup_cache_find(&cache, 9, 9, now) == NULL, "test never inserts");
+
+    CHECK(!rrc_dup_cache_test_and_set_at(&cache, 5, 0, RRC_DUP_FLAG_RECEIVED, now) &&
+          !rrc_dup_cache_test_and_set_at(&cache, 5, 0, RRC_DUP_FLAG_RECEIVED, now),
+          "unsequenced frames are never duplicates");
+}
+
+static void test_ageing(void)
+{
+    uint32_t now = 2000;
+    rrc_dup_cache_clear(&cache);
+
+    rrc_dup_cache_test_and_set_at(&cache, 3, 7, RRC_DUP_FLAG_RECEIVED, now);
+    CHECK(rrc_dup_cache_test_at(&cache, 3, 7, RRC_DUP_FLAG_RECEIVED, now + RRC_DUP_HOLD_TIME_SEC - 1),
+          "entry live until the hold time");
+    CHECK(!rrc_dup_cache_test_at(&cache, 3, 7, RRC_DUP_FLAG_RECEIVED, now + RRC_DUP_HOLD_TIME_SEC),
+          "entry gone after the hold time");
+    CHECK(!rrc_dup_cache_test_and_set_at(&cache, 3, 7, RRC_DUP_FLAG_RECEIVED, now + RRC_DUP_HOLD_TIME_SEC),
+          "expired pair accepted again");
+}
+
+static void test_eviction(void)
+{
+    uint32_t now = 3000;
+    uint16_t seqs[RRC_DUP_PROBE_LIMIT + 1];
+    int found = 0;
+    rrc_dup_cache_clear(&cache);
+
+    // Pairs from one source that hash to the same home slot
+    uint32_t home = rrc_dup_cache_index(1, 1);
+    for (uint32_t seq = 1; seq <= 0xFFFF && found <= RRC_DUP_PROBE_LIMIT; seq++)
+    {
+        if (rrc_dup_cache_index(1, (uint16_t)seq) == home)
+            seqs[found++] = (uint16_t)seq;
+    }
+    if (found <= RRC_DUP_PROBE_LIMIT)
+    {
+        printf("FAIL: not enough colliding sequence numbers\n");
+        failures++;
+        return;
+    }
+
+    // Staggered ages, oldest first
+    for (int i = 0; i < RRC_DUP_PROBE_LIMIT; i++)
+        rrc_dup_cache_test_and_set_at(&cache, 1, seqs[i], RRC_DUP_FLAG_RECEIVED, now + (uint32_t)i);
+    CHECK(cache.evictions == 0, "probe window fills without evictions");
+
+    uint32_t later = now + RRC_DUP_PROBE_LIMIT;
+    rrc_dup_cache_test_and_set_at(&cache, 1, seqs[RRC_DUP_PROBE_LIMIT], RRC_DUP_FLAG_RECEIVED, later);
+    CHECK(cache.evictions == 1, "one more colliding pair evicts");
+    CHECK(!rrc_dup_cache_test_at(&cache, 1, seqs[0], RRC_DUP_FLAG_RECEIVED, later) &&
+          rrc_dup_cache_test_at(&cache, 1, seqs[1], RRC_DUP_FLAG_RECEIVED, later) &&
+          rrc_dup_cache_test_at(&cache, 1, seqs[RRC_DUP_PROBE_LIMIT], RRC_DUP_FLAG_RECEIVED, later),
+          "the entry closest to expiry is the one evicted");
+}
+
+int main(void)
+{
+    test_flags();
+    test_ageing();
+    test_eviction();
+
+    printf("%s\n", failures ? "FAILED" : "ALL TESTS PASSED");
+    return failures ? 1 : 0;
+}
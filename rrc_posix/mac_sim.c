@@ -1,6 +1,7 @@
 /**
  * MAC/PHY Simulator for RRC POSIX Integration
- * Simulates frame reception from PHY layer
+ * Simulates frame reception from PHY layer and acts as the PHY reader of
+ * the per-datatype TX queues, releasing each frame once it is "sent"
  */
 
 #include <stdio.h>
@@ -16,7 +17,13 @@ static bool g_running = true;
 static uint8_t g_node_id = 1;
 
 static PoolContext mac_rx_pool;
+static PoolContext frame_pool;
 static MQContext mq_mac_to_rrc;
+static MQContext mq_tx_queues[7];
+static int tx_queue_count = 0;
+
+#define MAC_TX_POLL_US 10000        // TX queue poll interval
+#define MAC_INJECT_INTERVAL_MS 5000 // Test frame injection interval
 
 void signal_handler(int signum) {
     printf("[MAC] Received signal %d, shutting down...\n", signum);
@@ -46,7 +53,6 @@ void inject_test_frame(uint8_t src_id, uint8_t dest_id, const char* payload) {
     frame.sequence_number = rand() % 10000;
     frame.timestamp_ms = get_timestamp_ms();
     memcpy(frame.payload, payload, frame.payload_len);
-    frame.in_use = true;
     frame.valid = true;
     
     frame_pool_set(&mac_rx_pool, pool_idx, &frame);
@@ -68,6 +74,29 @@ void inject_test_frame(uint8_t src_id, uint8_t dest_id, const char* payload) {
            pool_idx, msg.rssi_dbm);
 }
 
+/**
+ * Transmit every frame RRC queued for PHY. RRC hands frame ownership over
+ * with the RrcToPhyMsg, so the frame goes back to the pool here; a stale
+ * generation means RRC already evicted it.
+ */
+int drain_tx_queues(void) {
+    int handled = 0;
+    for (int q = 0; q < tx_queue_count; q++) {
+        RrcToPhyMsg msg;
+        unsigned int priority;
+        while (mq_try_recv_msg(&mq_tx_queues[q], &msg, sizeof(msg), &priority) > 0) {
+            if (frame_pool_release_gen(&frame_pool, msg.pool_index, msg.generation) < 0) {
+                printf("[MAC] Frame at pool_index=%d was evicted before TX\n", msg.pool_index);
+            } else {
+                printf("[MAC] TX frame pool_index=%d next_hop=%d slot=%d\n",
+                       msg.pool_index, msg.next_hop, msg.assigned_slot);
+            }
+            handled++;
+        }
+    }
+    return handled;
+}
+
 int main(int argc, char* argv[]) {
     if (argc > 1) {
         g_node_id = atoi(argv[1]);
@@ -90,9 +119,35 @@ int main(int argc, char* argv[]) {
         return 1;
     }
     
-    // Open message queue
+    // Attach to the RRC TX frame pool
+    if (pool_init(&frame_pool, SHM_FRAME_POOL, sizeof(FramePoolEntry), 
+                  FRAME_POOL_SIZE, false) < 0) {
+        fprintf(stderr, "[MAC] Failed to attach to frame pool\n");
+        pool_cleanup(&mac_rx_pool, SHM_MAC_RX_POOL, false);
+        return 1;
+    }
+    
+    // Open message queues
     if (mq_init(&mq_mac_to_rrc, MQ_MAC_TO_RRC, O_WRONLY, false) < 0) {
         fprintf(stderr, "[MAC] Failed to open MAC->RRC queue\n");
+        pool_cleanup(&frame_pool, SHM_FRAME_POOL, false);
+        pool_cleanup(&mac_rx_pool, SHM_MAC_RX_POOL, false);
+        return 1;
+    }
+    
+    for (tx_queue_count = 0; tx_queue_count < 7; tx_queue_count++) {
+        const char* name = get_datatype_queue_name((DataType)tx_queue_count);
+        if (mq_init(&mq_tx_queues[tx_queue_count], name, O_RDONLY, false) < 0) {
+            fprintf(stderr, "[MAC] Failed to open TX queue %s\n", name);
+            break;
+        }
+    }
+    if (tx_queue_count < 7) {
+        for (int i = 0; i < tx_queue_count; i++) {
+            mq_cleanup(&mq_tx_queues[i], false);
+        }
+        mq_cleanup(&mq_mac_to_rrc, false);
+        pool_cleanup(&frame_pool, SHM_FRAME_POOL, false);
         pool_cleanup(&mac_rx_pool, SHM_MAC_RX_POOL, false);
         return 1;
     }
@@ -101,12 +156,17 @@ int main(int argc, char* argv[]) {
     printf("[MAC] Will inject test frames every 5 seconds...\n\n");
     
     int frame_count = 0;
+    uint32_t next_inject_ms = get_timestamp_ms() + MAC_INJECT_INTERVAL_MS;
     
-    // Main loop - inject test frames periodically
+    // Main loop - transmit queued frames, inject test frames periodically
     while (g_running) {
-        sleep(5);  // Wait 5 seconds
+        if (drain_tx_queues() == 0) {
+            usleep(MAC_TX_POLL_US);
+        }
         
         if (!g_running) break;
+        if ((int32_t)(get_timestamp_ms() - next_inject_ms) < 0) continue;
+        next_inject_ms += MAC_INJECT_INTERVAL_MS;
         
         // Inject test frame from different source nodes
         if (g_node_id == 1) {
@@ -137,7 +197,11 @@ int main(int argc, char* argv[]) {
     }
     
     // Cleanup
+    for (int i = 0; i < tx_queue_count; i++) {
+        mq_cleanup(&mq_tx_queues[i], false);
+    }
     mq_cleanup(&mq_mac_to_rrc, false);
+    pool_cleanup(&frame_pool, SHM_FRAME_POOL, false);
     pool_cleanup(&mac_rx_pool, SHM_MAC_RX_POOL, false);
     
     printf("\n[MAC] Simulator shutdown complete\n");
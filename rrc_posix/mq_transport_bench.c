@@ -0,0 +1,177 @@
+/**
+ * MQ Transport Benchmark
+ * Compares the POSIX message queue and shared-memory ring backends of
+ * rrc_mq_adapters.h across message sizes, one message per call vs batched
+ *
+ * Usage: mq_transport_bench [messages_per_run]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include "rrc_posix_mq_defs.h"
+#include "rrc_mq_adapters.h"
+
+#define BENCH_MQ_NAME "/rrc_bench_mq"
+#define BENCH_DEPTH 64
+#define BENCH_DEFAULT_MESSAGES 200000
+
+static const size_t bench_sizes[] = { 16, 64, 128, 512, 1024, MAX_MQ_MSG_SIZE };
+
+// ============================================================================
+// CONSUMER (child process)
+// ============================================================================
+
+/**
+ * Receive count messages and check their sequence numbers
+ * @return 0 if every message arrived in order
+ */
+static int bench_consume(size_t msg_size, bool batch, int count) {
+    MQContext mq;
+    uint8_t* buf = malloc(MQ_BATCH_MAX * msg_size);
+    size_t lens[MQ_BATCH_MAX];
+    uint32_t expected = 0;
+    int errors = 0;
+
+    if (!buf || mq_init(&mq, BENCH_MQ_NAME, O_RDONLY, false) < 0) {
+        free(buf);
+        return 1;
+    }
+
+    while (expected < (uint32_t)count) {
+        int n;
+        if (batch) {
+            n = mq_recv_batch(&mq, buf, msg_size, MQ_BATCH_MAX, lens, NULL, 1000);
+        } else {
+            ssize_t bytes = mq_recv_msg_timeout(&mq, buf, msg_size, NULL, 1000);
+            n = bytes > 0 ? 1 : (bytes == -2 ? 0 : -1);
+            lens[0] = bytes > 0 ? (size_t)bytes : 0;
+        }
+        if (n <= 0) {
+            fprintf(stderr, "[BENCH] Consumer stalled at message %u\n", expected);
+            errors++;
+            break;
+        }
+
+        for (int i = 0; i < n; i++) {
+            uint32_t seq;
+            memcpy(&seq, buf + (size_t)i * msg_size, sizeof(seq));
+            if (seq != expected || lens[i] != msg_size) errors++;
+            expected++;
+        }
+    }
+
+    mq_cleanup(&mq, false);
+    free(buf);
+    return errors == 0 ? 0 : 1;
+}
+
+// ============================================================================
+// PRODUCER AND TIMING
+// ============================================================================
+
+static double bench_elapsed_s(uint64_t start_ns) {
+    return (mq_now_ns() - start_ns) / 1e9;
+}
+
+/**
+ * One run: fork a consumer, stream count messages to it, time the transfer
+ * @return Messages per second, or negative on failure
+ */
+static double bench_run(MQBackend backend, size_t msg_size, bool batch, int count) {
+    MQConfig cfg = { BENCH_DEPTH, (long)msg_size, backend };
+    MQContext mq;
+    uint8_t* msgs = calloc(MQ_BATCH_MAX, msg_size);
+
+    if (!msgs || mq_init_config(&mq, BENCH_MQ_NAME, O_WRONLY, true, &cfg) < 0) {
+        free(msgs);
+        return -1.0;
+    }
+
+    pid_t pid = fork();
+    if (pid < 0) {
+        perror("fork");
+        mq_cleanup(&mq, true);
+        free(msgs);
+        return -1.0;
+    }
+    if (pid == 0) {
+        _exit(bench_consume(msg_size, batch, count));
+    }
+
+    uint64_t start_ns = mq_now_ns();
+    uint32_t seq = 0;
+    bool ok = true;
+
+    while (seq < (uint32_t)count && ok) {
+        if (batch) {
+            int n = count - (int)seq < MQ_BATCH_MAX ? count - (int)seq : MQ_BATCH_MAX;
+            for (int i = 0; i < n; i++, seq++) {
+                memcpy(msgs + (size_t)i * msg_size, &seq, sizeof(seq));
+            }
+            ok = mq_send_batch(&mq, msgs, msg_size, msg_size, n, 0) == n;
+        } else {
+            memcpy(msgs, &seq, sizeof(seq));
+            ok = mq_send_msg(&mq, msgs, msg_size, 0) == 0;
+            seq++;
+        }
+    }
+
+    int status = 0;
+    waitpid(pid, &status, 0);
+    double elapsed = bench_elapsed_s(start_ns);
+
+    mq_cleanup(&mq, true);
+    free(msgs);
+
+    if (!ok || !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+        return -1.0;
+    }
+    return count / elapsed;
+}
+
+// ============================================================================
+// MAIN FUNCTION
+// ============================================================================
+
+int main(int argc, char* argv[]) {
+    int count = BENCH_DEFAULT_MESSAGES;
+    int failures = 0;
+
+    if (argc > 1) {
+        count = atoi(argv[1]);
+    }
+    if (count <= 0) {
+        fprintf(stderr, "Usage: %s [messages_per_run]\n", argv[0]);
+        return 1;
+    }
+
+    printf("========================================\n");
+    printf("MQ Transport Benchmark\n");
+    printf("Messages per run: %d, depth: %d, batch: %d\n", count, BENCH_DEPTH, MQ_BATCH_MAX);
+    printf("========================================\n\n");
+    printf("%-7s %-6s %6s %12s %10s %9s\n", "backend", "mode", "size", "msgs/s", "MB/s", "ns/msg");
+
+    for (size_t s = 0; s < sizeof(bench_sizes) / sizeof(bench_sizes[0]); s++) {
+        for (int b = 0; b < 2; b++) {
+            MQBackend backend = b == 0 ? MQ_BACKEND_POSIX : MQ_BACKEND_SHM_RING;
+            for (int batch = 0; batch < 2; batch++) {
+                double rate = bench_run(backend, bench_sizes[s], batch, count);
+                const char* name = backend == MQ_BACKEND_POSIX ? "posix" : "shm";
+                const char* mode = batch ? "batch" : "single";
+
+                if (rate < 0) {
+                    printf("%-7s %-6s %6zu %12s\n", name, mode, bench_sizes[s], "FAILED");
+                    failures++;
+                    continue;
+                }
+                printf("%-7s %-6s %6zu %12.0f %10.1f %9.0f\n", name, mode, bench_sizes[s],
+                       rate, rate * bench_sizes[s] / 1e6, 1e9 / rate);
+            }
+        }
+    }
+
+    return failures == 0 ? 0 : 1;
+}
@@ -79,40 +79,50 @@ RouteEntry* lookup_route(uint8_t dest_node) {
 }
 
 void handle_route_request(MQContext* mq_in, MQContext* mq_out) {
-    RrcToOlsrMsg req;
-    unsigned int priority;
-    
-    ssize_t bytes = mq_try_recv_msg(mq_in, &req, sizeof(req), &priority);
-    if (bytes <= 0) return;
-    
-    printf("[OLSR] Route request: dest=%d, src=%d, req_id=%u\n",
-           req.dest_node, req.src_node, req.header.request_id);
-    
-    // Lookup route
-    RouteEntry* route = lookup_route(req.dest_node);
-    
-    // Send response
-    OlsrToRrcMsg rsp;
-    init_message_header(&rsp.header, MSG_OLSR_TO_RRC_ROUTE_RSP);
-    rsp.header.request_id = req.header.request_id;  // Correlation
-    rsp.dest_node = req.dest_node;
-    
-    if (route) {
-        rsp.next_hop = route->next_hop;
-        rsp.hop_count = route->hop_count;
-        rsp.status = 0;  // OK
-        printf("[OLSR] Route found: next_hop=%d, hop_count=%d\n", 
-               rsp.next_hop, rsp.hop_count);
-    } else {
-        rsp.next_hop = 0;
-        rsp.hop_count = 0;
-        rsp.status = 1;  // NO_ROUTE
-        printf("[OLSR] No route to dest=%d\n", req.dest_node);
+    MQMsgView views[MQ_BATCH_MAX];
+    
+    // Wait up to 10ms for a request, then take everything queued behind it
+    int count = mq_recv_peek(mq_in, views, MQ_BATCH_MAX, 10);
+    if (count < 0) {
+        usleep(10000);
+        return;
     }
     
-    if (mq_send_msg(mq_out, &rsp, sizeof(rsp), priority) < 0) {
-        fprintf(stderr, "[OLSR] Failed to send route response\n");
+    for (int i = 0; i < count; i++) {
+        if (views[i].len < sizeof(RrcToOlsrMsg)) continue;
+        const RrcToOlsrMsg* req = views[i].data;
+        
+        printf("[OLSR] Route request: dest=%d, src=%d, req_id=%u\n",
+               req->dest_node, req->src_node, req->header.request_id);
+    
+        // Lookup route
+        RouteEntry* route = lookup_route(req->dest_node);
+    
+        // Send response
+        OlsrToRrcMsg rsp;
+        init_message_header(&rsp.header, MSG_OLSR_TO_RRC_ROUTE_RSP);
+        rsp.header.request_id = req->header.request_id;  // Correlation
+        rsp.dest_node = req->dest_node;
+    
+        if (route) {
+            rsp.next_hop = route->next_hop;
+            rsp.hop_count = route->hop_count;
+            rsp.status = 0;  // OK
+            printf("[OLSR] Route found: next_hop=%d, hop_count=%d\n", 
+                   rsp.next_hop, rsp.hop_count);
+        } else {
+            rsp.next_hop = 0;
+            rsp.hop_count = 0;
+            rsp.status = 1;  // NO_ROUTE
+            printf("[OLSR] No route to dest=%d\n", req->dest_node);
+        }
+    
+        if (mq_send_msg(mq_out, &rsp, sizeof(rsp), views[i].priority) < 0) {
+            fprintf(stderr, "[OLSR] Failed to send route response\n");
+        }
     }
+    
+    mq_recv_release(mq_in);
 }
 
 int main(int argc, char* argv[]) {
@@ -150,7 +160,6 @@ int main(int argc, char* argv[]) {
     // Main processing loop
     while (g_running) {
         handle_route_request(&mq_rrc_to_olsr, &mq_olsr_to_rrc);
-        usleep(10000);  // 10ms
     }
     
     // Cleanup
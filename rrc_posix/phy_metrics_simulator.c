@@ -175,6 +175,7 @@ int main(int argc, char* argv[]) {
         (PhyRfStatus*)((uint8_t*)shm_base + PHY_OFFSET_RF_STATUS);
     PhyDiagnostics* diag = 
         (PhyDiagnostics*)((uint8_t*)shm_base + PHY_OFFSET_DIAGNOSTICS);
+    PhyChangeBlock* change = phy_change_block(shm_base);
     
     // Initialize metrics for each neighbor
     for (uint8_t i = 0; i < num_neighbors; i++) {
@@ -189,9 +190,14 @@ int main(int argc, char* argv[]) {
     while (g_running) {
         // Update link metrics for all neighbors
         for (uint8_t i = 0; i < num_neighbors; i++) {
+            phy_change_begin_entry(change, i + 1);
             simulate_link_metrics(&link_metrics[i], i + 1, iteration);
+            phy_change_end_entry(change, i + 1);
         }
         
+        // Wake RRC readers blocked in phy_wait_for_changes()
+        phy_change_ring_doorbell(change);
+        
         // Update RF status
         simulate_rf_status(rf_status, iteration);
         
@@ -27,7 +27,16 @@ int main(int argc, char* argv[]) {
     
     // Parse command line arguments
     if (argc > 1) {
-        target_neighbor = atoi(argv[1]);
+        char* end;
+        long id = strtol(argv[1], &end, 0);
+        // The change mask holds one bit per table entry, neighbor_id - 1
+        if (*argv[1] == '\0' || *end != '\0' || id < 1 || id > PHY_MAX_NEIGHBORS) {
+            fprintf(stderr, "ERROR: neighbor_id must be 1-%d, got '%s'\n",
+                    PHY_MAX_NEIGHBORS, argv[1]);
+            fprintf(stderr, "Usage: %s [neighbor_id] [base_addr]\n", argv[0]);
+            return 1;
+        }
+        target_neighbor = (uint8_t)id;
     }
     if (argc > 2) {
         base_addr = strtoull(argv[2], NULL, 0);  // Support hex: 0x40000000
@@ -54,15 +63,27 @@ int main(int argc, char* argv[]) {
     
     printf("PHY metrics initialized successfully\n\n");
     
-    // Main monitoring loop
+    printf("Change notification: %s\n\n",
+           phy_change_supported(&ctx) ? "doorbell" : "polling (PHY has no change block)");
+    
+    // Main monitoring loop: sleep until PHY reports changes, at most 1 second
     int iteration = 0;
     while (g_running) {
+        if (phy_wait_for_changes(&ctx, 1000) < 0) {
+            fprintf(stderr, "ERROR: Waiting for PHY changes failed\n");
+            break;
+        }
+        uint64_t changed = phy_collect_changed_links(&ctx);
+        if (!(changed & (1ULL << (target_neighbor - 1)))) {
+            continue;  // Target link unchanged: nothing to re-read
+        }
+        
         printf("────────────────────────────────────────────────────────────\n");
         printf("Iteration %d - %s", iteration++, ctime(&(time_t){time(NULL)}));
         printf("────────────────────────────────────────────────────────────\n");
         
         // Read link metrics for target neighbor
-        if (phy_read_link_metrics(&ctx, target_neighbor, &link_metrics) == 0) {
+        if (phy_read_link_metrics_stable(&ctx, target_neighbor, &link_metrics) == 0) {
             phy_print_link_metrics(target_neighbor, &link_metrics);
             
             // Check link usability
@@ -126,8 +147,6 @@ int main(int argc, char* argv[]) {
                 printf("\n");
             }
         }
-        
-        sleep(1);  // Update every 1 second
     }
     
     // Cleanup
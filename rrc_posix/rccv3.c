@@ -37,6 +37,9 @@
 #include <sys/msg.h>
 #include <signal.h>
 
+#include "rrc_dup_cache.h"
+#include "rrc_timer_wheel.h"
+
 // Compatibility constants for queue.c
 #define PAYLOAD_SIZE_BYTES 2800 // Updated payload size for larger data packets
 #define NUM_PRIORITY 4          // From queue.c
@@ -45,9 +48,16 @@
 // RRC Static Pool Configuration
 #define RRC_MESSAGE_POOL_SIZE 16
 #define MAX_MONITORED_NODES 40
-#define RRC_CONNECTION_POOL_SIZE 8
+#define RRC_CONNECTION_POOL_SIZE 64
+#define RRC_NODE_INDEX_NONE 0xFF // Empty entry in the node ID → slot indexes
 #define RRC_INACTIVITY_TIMEOUT_SEC 30
 #define RRC_SETUP_TIMEOUT_SEC 10
+#define RRC_NEIGHBOR_TIMEOUT_SEC 60
+#define RRC_NC_RESERVATION_TIMEOUT_SEC 30
+#define RRC_PIGGYBACK_TTL_TICK_MS 1000 // One piggyback TTL step per tick
+#define RRC_RECONFIG_HOLD_PER_CONN 8   // Messages held per connection during RECONFIGURATION
+#define RRC_RECONFIG_CONFIRM_MS 100    // New-path re-check interval
+#define RRC_RECONFIG_MAX_MS 2000       // Give up on the new path after this long
 
 // MANET NC Slot Configuration
 #define NC_SLOTS_PER_SUPERCYCLE 40
@@ -84,6 +94,7 @@ static uint8_t rrc_node_id = 1; // Default node ID, configurable
 typedef enum
 {
     MSG_OLSR_ROUTE_UPDATE = 1,
+    MSG_OLSR_MPR_UPDATE = 2,
     MSG_RRC_ROUTE_REQUEST = 10,
     MSG_RRC_DISCOVERY_TRIGGER = 11,
     MSG_PHY_METRICS_UPDATE = 60,
@@ -107,8 +118,11 @@ typedef struct
     uint8_t next_hop;
     bool route_available;
     uint32_t request_id;
+    uint32_t generation; // OLSR routing table generation the answer was read from
 } IPC_RouteResponse;
 
+#define RRC_ROUTE_UPDATE_ANY_DEST 0 // dest_node of an update that only carries a generation
+
 typedef struct
 {
     IPC_MessageType type;
@@ -120,6 +134,16 @@ typedef struct
     uint32_t packet_count;
 } IPC_PHYMetrics;
 
+// OLSR → RRC: MPR set and MPR selector set of this node (pushed on change)
+typedef struct
+{
+    IPC_MessageType type;
+    uint8_t mpr_count;
+    uint8_t selector_count;
+    uint8_t mprs[MAX_MONITORED_NODES];
+    uint8_t selectors[MAX_MONITORED_NODES];
+} IPC_MPRUpdate;
+
 // IPC handles
 static mqd_t mq_olsr_to_rrc = -1;
 static mqd_t mq_rrc_to_olsr = -1;
@@ -129,6 +153,23 @@ static int shm_queues_fd = -1;
 static bool ipc_initialized = false;
 static uint32_t ipc_request_counter = 0;
 
+// Next hops learned from OLSR route responses and updates, by destination.
+// Paths that must not wait on OLSR read this; a miss sends a non-blocking
+// request whose answer arrives as MSG_OLSR_ROUTE_UPDATE. Entries belong to
+// route_cache_generation: an answer or update read from another OLSR
+// routing table generation drops them all first.
+#define RRC_ROUTE_REQUEST_HOLDOFF_SEC 1
+typedef struct
+{
+    uint8_t next_hop;      // 0: OLSR has no route
+    bool valid;
+    uint32_t requested_at; // time() of the last async request, 0 if none
+} RRC_RouteCacheEntry;
+
+static RRC_RouteCacheEntry route_cache[256];
+static uint32_t route_cache_generation = 0;
+static uint32_t route_cache_flushes = 0;
+
 // Data types from queue.c
 typedef enum
 {
@@ -145,6 +186,9 @@ struct frame
     uint8_t source_add;
     uint8_t dest_add;
     uint8_t next_hop_add;
+    uint8_t prev_hop_add;     // Transmitting node of the last hop (set by RRC)
+    uint16_t sequence_number; // Per-source sequence, (source_add, seq) is unique
+    uint32_t enqueue_time_ms; // CLOCK_MONOTONIC ms, stamped by the AQM on enqueue
     bool rx_or_l3;
     int TTL;
     int priority;
@@ -237,15 +281,17 @@ typedef struct
 // MANET WAVEFORM STRUCTURES AND DEFINITIONS
 // ============================================================================
 
-// PHY Metrics Structure for neighbor tracking
+// PHY metrics indexed directly by node ID; struct-of-arrays so the
+// per-packet link check only touches the fields it compares
 typedef struct
 {
-    float rssi_dbm;
-    float snr_db;
-    float per_percent;
-    uint32_t packet_count; // Total packets received from neighbor
-    uint32_t last_update_time;
-} PHYMetrics;
+    float rssi_dbm[256];
+    float snr_db[256];
+    float per_percent[256];
+    uint32_t packet_count[256]; // Total packets received from neighbor
+    uint32_t last_update_time[256];
+    bool link_active[256];
+} PHYMetricsTable;
 
 // Neighbor State Structure (neighbour tx/rx info)
 typedef struct
@@ -254,7 +300,6 @@ typedef struct
     uint64_t lastHeardTime;
     uint8_t txSlots[10]; // Which slots neighbor will transmit
     uint8_t rxSlots[10]; // Which slots neighbor expects to receive
-    PHYMetrics phy;
     uint8_t capabilities;   // TX/RX capabilities bitmask
     bool active;            // Is this neighbor currently active
     uint8_t assignedNCSlot; // NC slot assigned to this neighbor
@@ -308,7 +353,9 @@ typedef struct
 
 // Static arrays for neighbor tracking (MANET requirements)
 static NeighborState neighbor_table[MAX_MONITORED_NODES];
-static int neighbor_count = 0;
+static int neighbor_count = 0;                // High-water mark of used entries
+static uint8_t neighbor_index[256];           // Node ID → neighbor_table slot
+static PHYMetricsTable phy_metrics;
 static SlotStatus current_slot_status = {0};
 static NCSlotManager nc_manager = {0};
 static PiggybackTLV current_piggyback_tlv = {0};
@@ -344,25 +391,88 @@ typedef enum
     RRC_STATE_RELEASE           // Releasing radio resources
 } RRC_SystemState;
 
-// Connection Context Structure (static allocation)
+#define RRC_FSM_STATE_COUNT (RRC_STATE_RELEASE + 1)
+
+// Per-connection FSM events
+#define RRC_FSM_EVENTS(X)   \
+    X(DATA_REQUEST)         \
+    X(ROUTE_ALLOCATED)      \
+    X(ROUTE_LOST)           \
+    X(ROUTE_CHANGE)         \
+    X(RECONFIG_SUCCESS)     \
+    X(SETUP_TIMEOUT)        \
+    X(INACTIVITY_TIMEOUT)   \
+    X(RELEASE_REQUEST)      \
+    X(RELEASE_COMPLETE)
+
+#define RRC_FSM_EVENT_ENUM(name) RRC_EVENT_##name,
+typedef enum
+{
+    RRC_FSM_EVENTS(RRC_FSM_EVENT_ENUM)
+        RRC_EVENT_COUNT
+} RRC_FsmEvent;
+
+// Queued event; next_hop/qos are only meaningful for some events
+typedef struct
+{
+    uint8_t event;
+    uint8_t next_hop;
+    uint8_t qos;
+} RRC_FsmEventMsg;
+
+#define RRC_FSM_EVENT_QUEUE_DEPTH 8
+#define RRC_FSM_HIST_BUCKETS 16 // Time in state: bucket 0 = <1ms, bucket b = [2^(b-1), 2^b) ms
+
+// Connection Context Structure (static allocation, cold fields)
 typedef struct
 {
     uint8_t dest_node_id;             // Destination node for this connection
-    uint8_t next_hop_id;              // Current next hop via OLSR
-    uint8_t allocated_slots[4];       // TDMA slots allocated for this connection    uint32_t connection_start_time;   // When connection was established
-    uint32_t last_activity_time;      // Last packet activity timestamp
+    uint8_t allocated_slots[4];       // TDMA slots allocated for this connection
+    uint32_t connection_start_time;   // When connection was established
     RRC_SystemState connection_state; // State of this specific connection
     MessagePriority qos_priority;     // QoS requirements for this connection
-    bool active;                      // Connection context in use
     bool setup_pending;               // Waiting for setup completion
     bool reconfig_pending;            // Reconfiguration in progress
+    uint32_t state_enter_ms;          // Monotonic time connection_state was entered
+    RRC_FsmEventMsg events[RRC_FSM_EVENT_QUEUE_DEPTH]; // Pending events, drained by the RRC worker
+    uint8_t event_head;
+    uint8_t event_count;
+    uint8_t reconfig_old_hop;         // Next hop before RECONFIGURATION (keeps its slots)
+    uint8_t reconfig_new_hop;         // Candidate next hop awaiting confirmation
+    uint32_t reconfig_start_ms;
+    uint8_t hold_slots[RRC_RECONFIG_HOLD_PER_CONN]; // reconfig_hold_pool indexes, FIFO
+    uint8_t hold_head;
+    uint8_t hold_count;
 } RRC_ConnectionContext;
 
-// Static FSM state variables
+// Per-packet connection fields, struct-of-arrays indexed by pool slot
+typedef struct
+{
+    bool active[RRC_CONNECTION_POOL_SIZE];                 // Connection context in use
+    uint8_t next_hop_id[RRC_CONNECTION_POOL_SIZE];         // Current next hop via OLSR
+    uint32_t last_activity_time[RRC_CONNECTION_POOL_SIZE]; // Last packet activity timestamp
+} RRC_ConnectionHot;
+
+// Static FSM state variables. current_rrc_state is the node lifecycle
+// (NULL ↔ IDLE); every connection runs its own FSM in connection_state.
 static RRC_SystemState current_rrc_state = RRC_STATE_NULL;
 static RRC_ConnectionContext connection_pool[RRC_CONNECTION_POOL_SIZE];
+static RRC_ConnectionHot connection_hot;
+static uint8_t connection_index[256]; // Destination node ID → connection_pool slot
+static uint32_t fsm_pending[(RRC_CONNECTION_POOL_SIZE + 31) / 32]; // Slots with queued events
 static bool fsm_initialized = false;
 
+// Transition table: state × event → action, next state on success, next state on failure
+typedef int (*RRC_FsmAction)(RRC_ConnectionContext *ctx, const RRC_FsmEventMsg *msg);
+
+typedef struct
+{
+    bool defined;
+    RRC_SystemState next;
+    RRC_SystemState fail;
+    RRC_FsmAction action; // NULL = unconditional transition
+} RRC_FsmTransition;
+
 // FSM Statistics
 static struct
 {
@@ -374,6 +484,11 @@ static struct
     uint32_t inactivity_releases;
     uint32_t power_on_events;
     uint32_t power_off_events;
+    uint32_t events[RRC_EVENT_COUNT];
+    uint32_t rejected_events; // No table entry for (state, event)
+    uint32_t queue_overflows;
+    uint32_t transition_counts[RRC_FSM_STATE_COUNT][RRC_FSM_STATE_COUNT];
+    uint32_t time_in_state[RRC_FSM_STATE_COUNT][RRC_FSM_HIST_BUCKETS];
 } rrc_fsm_stats = {0};
 
 // ============================================================================
@@ -446,8 +561,237 @@ static struct
     uint32_t relay_packets_discarded;
     uint32_t relay_queue_full_drops;
     uint32_t relay_packets_to_self;
+    uint32_t relay_duplicates_suppressed;
+    uint32_t uplink_duplicates_suppressed;
 } relay_stats = {0};
 
+// ============================================================================
+// ACTIVE QUEUE MANAGEMENT STATE
+// ============================================================================
+
+// TDMA superframe (TDMA_CODE.c: TOTAL_SLOTS x SLOT_DURATION_MS); a class
+// that owns one slot per superframe waits up to this long for its turn
+#define RRC_TDMA_SLOT_MS 10
+#define RRC_TDMA_SLOTS_PER_SUPERFRAME 10
+#define RRC_SUPERFRAME_MS (RRC_TDMA_SLOT_MS * RRC_TDMA_SLOTS_PER_SUPERFRAME)
+
+// Voice may miss one transmit opportunity (analog: the MV slot, digital:
+// a contended DU slot) before it is too old to play out
+#define RRC_ANALOG_VOICE_DEADLINE_MS (2 * RRC_SUPERFRAME_MS)
+#define RRC_DIGITAL_VOICE_DEADLINE_MS (2 * RRC_SUPERFRAME_MS + RRC_SUPERFRAME_MS / 2)
+
+// CoDel parameters sized for TDMA superframes rather than wired links
+#define RRC_CODEL_TARGET_MS RRC_SUPERFRAME_MS
+#define RRC_CODEL_INTERVAL_MS 1000
+#define RRC_AQM_ANY_HOP -1           // rrc_aqm_dequeue_for_hop(): plain FIFO order
+
+typedef enum
+{
+    RRC_AQM_CLASS_ANALOG_VOICE = 0, // analog_voice_queue
+    RRC_AQM_CLASS_DIGITAL_VOICE,    // data_from_l3_queue[0]
+    RRC_AQM_CLASS_VIDEO,            // data_from_l3_queue[1]
+    RRC_AQM_CLASS_FILE,             // data_from_l3_queue[2]
+    RRC_AQM_CLASS_SMS,              // data_from_l3_queue[3]
+    RRC_AQM_CLASS_RELAY,            // rrc_relay_queue
+    RRC_AQM_CLASS_COUNT
+} RRC_AqmClass;
+
+// Deadline of a frame follows its own traffic class; the relay queue only
+// decides whether CoDel runs on it
+typedef struct
+{
+    const char *name;
+    uint32_t deadline_ms; // 0 = no deadline
+    bool codel;
+} RRC_AqmClassConfig;
+
+// CoDel control state (RFC 8289)
+typedef struct
+{
+    uint32_t first_above_time;
+    uint32_t drop_next;
+    uint32_t count;
+    uint32_t last_count;
+    bool dropping;
+} RRC_CodelState;
+
+static RRC_AqmClassConfig aqm_config[RRC_AQM_CLASS_COUNT] = {
+    {"analog_voice", RRC_ANALOG_VOICE_DEADLINE_MS, false},
+    {"digital_voice", RRC_DIGITAL_VOICE_DEADLINE_MS, false},
+    {"video", 400, false},
+    {"file", 30000, true},
+    {"sms", 300000, false},
+    {"relay", 0, true},
+};
+
+static RRC_CodelState aqm_codel[RRC_AQM_CLASS_COUNT];
+
+// AQM Statistics (per class)
+static struct
+{
+    uint32_t enqueued;
+    uint32_t dequeued;
+    uint32_t deadline_drops;
+    uint32_t codel_drops;
+    uint32_t overflow_drops;
+    uint32_t head_drops;
+    uint32_t max_sojourn_ms;
+    uint64_t total_sojourn_ms;
+} aqm_stats[RRC_AQM_CLASS_COUNT];
+
+// ============================================================================
+// DUPLICATE DETECTION CACHE STATE
+// ============================================================================
+
+// Layout and lookup live in rrc_dup_cache.h
+static RRC_DupCache dup_cache;
+static uint16_t rrc_tx_sequence = 0; // Sequence 0 is reserved for unsequenced frames
+
+// ============================================================================
+// TIMER WHEEL STATE
+// ============================================================================
+
+// Hierarchical wheel (rrc_timer_wheel.h) on millisecond CLOCK_MONOTONIC ticks
+
+typedef enum
+{
+    RRC_TIMER_CONN_SETUP = 0,
+    RRC_TIMER_CONN_INACTIVITY,
+    RRC_TIMER_NEIGHBOR_EXPIRY,
+    RRC_TIMER_RESERVATION_EXPIRY,
+    RRC_TIMER_PIGGYBACK_TTL,
+    RRC_TIMER_RECONFIG_HOLD,
+    RRC_TIMER_KIND_COUNT
+} RRC_TimerKind;
+
+_Static_assert(RRC_TIMER_KIND_COUNT <= RRC_TIMER_MAX_KINDS, "timer kinds fit the wheel");
+
+// A timer is keyed by (kind, node ID); at most one is armed per pair
+static RRC_TimerWheel timer_wheel;
+static bool timers_initialized = false;
+
+static const char *timer_kind_names[RRC_TIMER_KIND_COUNT] = {
+    "conn_setup", "conn_inactivity", "neighbor_expiry", "reservation_expiry", "piggyback_ttl",
+    "reconfig_hold"};
+
+// Timer Statistics (arm/cancel/cascade counts live in timer_wheel)
+static struct
+{
+    uint32_t fired[RRC_TIMER_KIND_COUNT];
+} timer_stats = {0};
+
+// ============================================================================
+// RECONFIGURATION HOLD BUFFER STATE
+// ============================================================================
+
+#define RRC_RECONFIG_HOLD_POOL_SIZE 32
+
+// Frame built for a connection in RECONFIGURATION, waiting for the new path
+typedef struct
+{
+    struct frame frame;
+    uint32_t held_at_ms;
+    bool in_use;
+} RRC_HeldFrame;
+
+static RRC_HeldFrame reconfig_hold_pool[RRC_RECONFIG_HOLD_POOL_SIZE];
+
+// Reconfiguration Statistics
+static struct
+{
+    uint32_t started;
+    uint32_t confirmed;
+    uint32_t fallbacks;
+    uint32_t failed;
+    uint32_t frames_retargeted;
+    uint32_t frames_held;
+    uint32_t frames_flushed;
+    uint32_t hold_overflow_drops;
+    uint32_t hold_expired;
+    uint32_t hold_dropped;
+    uint32_t hold_flush_drops;
+    uint32_t old_slots_released;
+    uint32_t old_slots_kept_shared;
+} reconfig_stats = {0};
+
+// ============================================================================
+// MULTICAST / BROADCAST FAN-OUT STATE
+// ============================================================================
+
+#define RRC_BROADCAST_ADDR 0xFF      // Broadcast destination and next hop (0 is also accepted)
+#define RRC_MCAST_GROUP_FIRST 0xE0   // Node IDs 0xE0-0xFE address multicast groups
+#define RRC_MCAST_GROUP_LAST 0xFE
+#define RRC_MCAST_REPORT_GROUP 0xE0   // Reserved: membership reports, never joined
+#define RRC_MCAST_REPORT_TAG 0x4A     // First payload byte of a membership report
+#define RRC_MCAST_REPORT_INTERVAL_SEC 20 // Well inside RRC_MCAST_MEMBER_TIMEOUT_SEC
+#define RRC_MCAST_MAX_GROUPS 16
+#define RRC_MCAST_MEMBER_TIMEOUT_SEC 60
+#define RRC_MCAST_PAYLOAD_POOL_SIZE 8
+#define RRC_MCAST_TX_QUEUE_SIZE 32
+
+// One bit per uint8_t node ID
+typedef struct
+{
+    uint32_t bits[8];
+} RRC_NodeSet;
+
+// Group membership: who has joined, refreshed by periodic joins
+typedef struct
+{
+    uint8_t group_id;
+    bool active;
+    bool local_member;
+    RRC_NodeSet members;
+    uint32_t member_last_seen[256]; // Indexed by node ID
+} RRC_McastGroup;
+
+// One payload copy shared by every next hop it is fanned out to
+typedef struct
+{
+    struct frame frame; // next_hop_add is filled in per transmission
+    uint8_t refcount;
+    bool in_use;
+} RRC_McastPayload;
+
+typedef struct
+{
+    uint8_t payload_index;
+    uint8_t next_hop;
+    uint8_t slot_id;
+} RRC_McastTxDescriptor;
+
+static RRC_McastGroup mcast_groups[RRC_MCAST_MAX_GROUPS];
+static RRC_NodeSet mcast_mpr_set;       // Neighbors this node selected as MPR
+static RRC_NodeSet mcast_mpr_selectors; // Neighbors that selected this node as MPR
+static bool mcast_mpr_known = false;    // False until OLSR pushes an MPR update
+static RRC_McastPayload mcast_payload_pool[RRC_MCAST_PAYLOAD_POOL_SIZE];
+static RRC_McastTxDescriptor mcast_tx_ring[RRC_MCAST_TX_QUEUE_SIZE];
+static int mcast_tx_head = 0;
+static int mcast_tx_count = 0;
+static uint32_t mcast_last_report = 0;  // time() of the last membership report
+
+// Multicast Statistics
+static struct
+{
+    uint32_t mcast_originated;
+    uint32_t mcast_received;
+    uint32_t mcast_delivered_local;
+    uint32_t mcast_forwarded;
+    uint32_t mcast_not_selected_mpr;
+    uint32_t mcast_copies_queued;
+    uint32_t mcast_payload_copies;
+    uint32_t mcast_payload_pool_exhausted;
+    uint32_t mcast_tx_queue_full_drops;
+    uint32_t mcast_no_slot_drops;
+    uint32_t mcast_deadline_drops;
+    uint32_t mcast_unreachable_members;
+    uint32_t mcast_unresolved_members;
+    uint32_t mpr_updates;
+    uint32_t reports_sent;
+    uint32_t reports_received;
+    uint32_t route_updates;
+} mcast_stats = {0};
+
 // External queue functions from queue.c
 extern void enqueue(struct queue *q, struct frame rx_f);
 extern struct frame dequeue(struct queue *q);
@@ -486,8 +830,85 @@ void print_relay_stats(void);
 
 // TDMA API functions for relay queue access
 struct frame rrc_tdma_dequeue_relay_packet(void);
+bool rrc_tdma_pull_relay_packet(struct frame *out);
 bool rrc_has_relay_packets(void);
 
+// Active queue management over the RRC-fed queues
+uint32_t rrc_now_ms(void);
+void init_aqm(void);
+void rrc_aqm_set_deadline(RRC_AqmClass cls, uint32_t deadline_ms);
+bool rrc_aqm_enqueue(RRC_AqmClass cls, struct frame *frame);
+bool rrc_aqm_dequeue(RRC_AqmClass cls, struct frame *out);
+bool rrc_aqm_dequeue_for_hop(RRC_AqmClass cls, int next_hop, struct frame *out);
+struct frame rrc_tdma_dequeue_data_packet(int priority);
+struct frame rrc_tdma_dequeue_analog_voice_packet(void);
+bool rrc_tdma_pull_data_packet(int priority, struct frame *out);
+bool rrc_tdma_pull_analog_voice_packet(struct frame *out);
+void print_aqm_stats(void);
+
+// Timer wheel for connection, neighbor, reservation and piggyback timeouts
+void init_rrc_timers(void);
+bool rrc_timer_arm(RRC_TimerKind kind, uint8_t key, uint32_t delay_ms);
+void rrc_timer_cancel(RRC_TimerKind kind, uint8_t key);
+bool rrc_timer_is_armed(RRC_TimerKind kind, uint8_t key);
+int rrc_timer_service(void);
+void print_timer_stats(void);
+void rrc_clear_piggyback(void);
+
+// Make-before-break reconfiguration
+void init_reconfig_engine(void);
+void rrc_reconfig_begin(RRC_ConnectionContext *ctx, uint8_t new_next_hop);
+void rrc_reconfig_commit(RRC_ConnectionContext *ctx, uint8_t new_next_hop);
+void rrc_reconfig_abort(RRC_ConnectionContext *ctx);
+bool rrc_reconfig_try_confirm(RRC_ConnectionContext *ctx, uint8_t hop);
+int rrc_reconfig_hold_message(RRC_ConnectionContext *ctx, ApplicationMessage *app_msg);
+void rrc_reconfig_poll(uint8_t dest_node);
+void rrc_release_slot(uint8_t node_id, uint8_t slot_id);
+void print_reconfig_stats(void);
+
+// Duplicate detection for received and relayed frames
+void init_dup_cache(void);
+bool rrc_dup_cache_test_and_set(uint8_t source, uint16_t seq, uint8_t flag);
+bool rrc_dup_cache_test(uint8_t source, uint16_t seq, uint8_t flag);
+void rrc_dup_cache_set(uint8_t source, uint16_t seq, uint8_t flag);
+uint16_t rrc_next_tx_sequence(void);
+
+// Multicast / broadcast fan-out engine
+void init_mcast_engine(void);
+bool rrc_is_broadcast_addr(uint8_t addr);
+bool rrc_is_mcast_group_addr(uint8_t addr);
+int rrc_mcast_join_group(uint8_t group_id, uint8_t node_id);
+void rrc_mcast_leave_group(uint8_t group_id, uint8_t node_id);
+bool rrc_mcast_is_member(uint8_t group_id, uint8_t node_id);
+void rrc_mcast_expire_members(void);
+void rrc_mcast_update_mpr_sets(const uint8_t *mprs, int mpr_count,
+                               const uint8_t *selectors, int selector_count);
+void rrc_handle_olsr_mpr_update(const IPC_MPRUpdate *update);
+void rrc_handle_olsr_route_update(const IPC_RouteResponse *update);
+void rrc_dispatch_olsr_message(const void *msg, size_t len);
+void rrc_poll_olsr_updates(void);
+int rrc_mcast_send_membership_report(void);
+void rrc_mcast_refresh_membership(void);
+bool rrc_mcast_should_forward(const struct frame *frame);
+int rrc_mcast_fanout_frame(const struct frame *frame, uint8_t prev_hop);
+int rrc_mcast_send_application_message(ApplicationMessage *app_msg);
+struct frame create_frame_from_rrc(ApplicationMessage *app_msg, uint8_t next_hop_node);
+int rrc_mcast_process_uplink_frame(struct frame *received_frame);
+void print_mcast_stats(void);
+
+// TDMA API functions for multicast fan-out access
+bool rrc_has_mcast_packets(void);
+const struct frame *rrc_tdma_peek_mcast_packet(uint8_t *next_hop, uint8_t *slot_id);
+void rrc_tdma_complete_mcast_packet(void);
+struct frame rrc_tdma_dequeue_mcast_packet(uint8_t *slot_id);
+void rrc_tdma_release_mcast_slot(uint8_t next_hop, uint8_t slot_id);
+
+// TDMA per-next-hop access. A TDMA class is a data priority (0-3) or one of:
+#define RRC_TDMA_CLASS_RELAY 4
+#define RRC_TDMA_CLASS_MCAST 5
+int rrc_tdma_queued_next_hops(int tdma_class, uint32_t hops[8]);
+bool rrc_tdma_pull_packet_for_hop(int tdma_class, uint8_t next_hop, struct frame *out, uint8_t *slot_id);
+
 // RRC configuration functions
 void rrc_set_node_id(uint8_t node_id);
 uint8_t rrc_get_node_id(void);
@@ -500,6 +921,8 @@ RRC_ConnectionContext *rrc_get_connection_context(uint8_t dest_node);
 RRC_ConnectionContext *rrc_create_connection_context(uint8_t dest_node);
 void rrc_release_connection_context(uint8_t dest_node);
 void rrc_update_connection_activity(uint8_t dest_node);
+uint8_t rrc_connection_next_hop(const RRC_ConnectionContext *ctx);
+void rrc_connection_set_next_hop(RRC_ConnectionContext *ctx, uint8_t next_hop);
 
 // FSM event handlers
 int rrc_handle_power_on(void);
@@ -510,6 +933,15 @@ int rrc_handle_route_change(uint8_t dest_node, uint8_t new_next_hop);
 int rrc_handle_reconfig_success(uint8_t dest_node, uint8_t new_next_hop);
 int rrc_handle_inactivity_timeout(uint8_t dest_node);
 int rrc_handle_release_complete(uint8_t dest_node);
+int rrc_handle_setup_timeout(uint8_t dest_node);
+int rrc_handle_route_lost(uint8_t dest_node);
+
+// Per-connection event queues
+bool rrc_fsm_post_event(uint8_t dest_node, RRC_FsmEvent event, uint8_t next_hop, MessagePriority qos);
+int rrc_fsm_process_events(int budget);
+uint32_t rrc_fsm_transition_count(RRC_SystemState from, RRC_SystemState to);
+const uint32_t *rrc_fsm_time_in_state_histogram(RRC_SystemState state);
+const char *rrc_fsm_event_to_string(RRC_FsmEvent event);
 
 // System management
 void rrc_periodic_system_management(void);
@@ -525,6 +957,8 @@ void rrc_ipc_cleanup(void);
 
 // IPC wrapper functions (replace extern API calls)
 uint8_t ipc_olsr_get_next_hop(uint8_t destination_node_id);
+void ipc_olsr_request_route(uint8_t destination_node_id);
+bool rrc_route_cache_lookup(uint8_t dest_node, uint8_t *next_hop);
 void ipc_olsr_trigger_route_discovery(uint8_t destination_node_id);
 void ipc_phy_get_link_metrics(uint8_t node_id, float *rssi, float *snr, float *per);
 bool ipc_phy_is_link_active(uint8_t node_id);
@@ -549,6 +983,7 @@ uint8_t rrc_assign_nc_slot(uint16_t nodeID);
 void init_neighbor_state_table(void);
 NeighborState *rrc_get_neighbor_state(uint16_t nodeID);
 NeighborState *rrc_create_neighbor_state(uint16_t nodeID);
+void rrc_deactivate_neighbor(NeighborState *neighbor);
 void rrc_update_neighbor_slots(uint16_t nodeID, uint8_t *txSlots, uint8_t *rxSlots);
 bool rrc_is_neighbor_tx(uint16_t nodeID, uint8_t slot);
 bool rrc_is_neighbor_rx(uint16_t nodeID, uint8_t slot);
@@ -780,6 +1215,55 @@ int rrc_receive_from_phy(void *msg, size_t msg_size, bool blocking)
     return bytes;
 }
 
+// OLSR answers arrive in order on one queue, so any generation other than
+// the cached one is newer (or OLSR restarted): every cached hop is stale
+static void rrc_route_cache_sync_generation(uint32_t generation)
+{
+    if (generation == route_cache_generation)
+        return;
+    memset(route_cache, 0, sizeof(route_cache)); // Also lifts the request holdoff
+    route_cache_generation = generation;
+    route_cache_flushes++;
+    printf("RRC: OLSR routing generation %u, route cache flushed\n", generation);
+}
+
+static void rrc_route_cache_store(uint8_t dest_node, uint8_t next_hop, uint32_t generation)
+{
+    rrc_route_cache_sync_generation(generation);
+    route_cache[dest_node].next_hop = next_hop;
+    route_cache[dest_node].valid = true;
+}
+
+// Cached next hop toward dest_node (0 if unreachable); false until OLSR answered
+bool rrc_route_cache_lookup(uint8_t dest_node, uint8_t *next_hop)
+{
+    if (!route_cache[dest_node].valid)
+        return false;
+    *next_hop = route_cache[dest_node].next_hop;
+    return true;
+}
+
+// IPC wrapper: Ask OLSR for a route without waiting for the answer.
+// Repeats for one destination are held off for RRC_ROUTE_REQUEST_HOLDOFF_SEC.
+void ipc_olsr_request_route(uint8_t destination_node_id)
+{
+    if (!ipc_initialized)
+        return;
+
+    RRC_RouteCacheEntry *entry = &route_cache[destination_node_id];
+    uint32_t now = (uint32_t)time(NULL);
+    if (entry->requested_at != 0 && now - entry->requested_at < RRC_ROUTE_REQUEST_HOLDOFF_SEC)
+        return;
+
+    IPC_RouteRequest request;
+    request.type = MSG_RRC_ROUTE_REQUEST;
+    request.dest_node = destination_node_id;
+    request.request_id = ++ipc_request_counter;
+
+    if (rrc_send_to_olsr(&request, sizeof(request)) == 0)
+        entry->requested_at = now;
+}
+
 // IPC wrapper: Get next hop from OLSR (request/response pattern)
 uint8_t ipc_olsr_get_next_hop(uint8_t destination_node_id)
 {
@@ -801,11 +1285,13 @@ uint8_t ipc_olsr_get_next_hop(uint8_t destination_node_id)
         return 0;
     }
 
-    // Wait for response (with timeout)
-    IPC_RouteResponse response;
-    struct timespec timeout;
-    clock_gettime(CLOCK_REALTIME, &timeout);
-    timeout.tv_sec += 1; // 1 second timeout
+    // Wait for response (with timeout). The buffer must hold a full queue
+    // message; anything else that arrives meanwhile is dispatched, not lost.
+    union
+    {
+        IPC_RouteResponse response;
+        char raw[MQ_MESSAGE_SIZE];
+    } rx;
 
     struct mq_attr old_attr, new_attr;
     mq_getattr(mq_olsr_to_rrc, &old_attr);
@@ -816,12 +1302,18 @@ uint8_t ipc_olsr_get_next_hop(uint8_t destination_node_id)
     int retries = 10;
     while (retries-- > 0)
     {
-        ssize_t bytes = mq_receive(mq_olsr_to_rrc, (char *)&response, sizeof(response), NULL);
-        if (bytes > 0 && response.type == MSG_OLSR_ROUTE_UPDATE &&
-            response.request_id == request.request_id)
+        ssize_t bytes;
+        while ((bytes = mq_receive(mq_olsr_to_rrc, rx.raw, sizeof(rx.raw), NULL)) > 0)
         {
-            mq_setattr(mq_olsr_to_rrc, &old_attr, NULL);
-            return response.route_available ? response.next_hop : 0;
+            if ((size_t)bytes >= sizeof(rx.response) && rx.response.type == MSG_OLSR_ROUTE_UPDATE &&
+                rx.response.request_id == request.request_id)
+            {
+                mq_setattr(mq_olsr_to_rrc, &old_attr, NULL);
+                uint8_t next_hop = rx.response.route_available ? rx.response.next_hop : 0;
+                rrc_route_cache_store(destination_node_id, next_hop, rx.response.generation);
+                return next_hop;
+            }
+            rrc_dispatch_olsr_message(rx.raw, (size_t)bytes);
         }
         usleep(100000); // 100ms
     }
@@ -1179,6 +1671,7 @@ typedef struct
 // Static reservation queue for priority-based allocation
 static NCReservationRequest reservation_queue[MAX_MONITORED_NODES];
 static int reservation_count = 0;
+static bool reservation_queue_dirty = false; // Re-sort needed before next assignment pass
 
 // Calculate comprehensive priority score (lower = higher priority)
 static uint32_t calculate_priority_score(const NCReservationRequest *request)
@@ -1259,6 +1752,7 @@ bool rrc_add_nc_reservation(uint16_t nodeID, uint8_t hopCount, bool isSelf,
             reservation_queue[i].timestamp = (uint32_t)time(NULL);
             reservation_queue[i].requestedSlot = preferredSlot;
             reservation_queue[i].packetCount += packetCount; // Accumulate packet count
+            reservation_queue_dirty = true;
 
             printf("RRC PRIORITY: Updated reservation for node %u (hops: %u→%u, packets: %u)\n",
                    nodeID, hopCount, reservation_queue[i].hopCount,
@@ -1278,6 +1772,9 @@ bool rrc_add_nc_reservation(uint16_t nodeID, uint8_t hopCount, bool isSelf,
     new_req->packetCount = packetCount;
 
     reservation_count++;
+    reservation_queue_dirty = true;
+    if (nodeID < 256)
+        rrc_timer_arm(RRC_TIMER_RESERVATION_EXPIRY, (uint8_t)nodeID, RRC_NC_RESERVATION_TIMEOUT_SEC * 1000u);
 
     printf("RRC PRIORITY: Added NC reservation for node %u (hops: %u, packets: %u)\n",
            nodeID, hopCount, packetCount);
@@ -1455,6 +1952,7 @@ void rrc_process_nc_reservations_by_priority(void)
         return;
 
     printf("RRC PRIORITY: Processing %d NC reservations by priority\n", reservation_count);
+    reservation_queue_dirty = false;
 
     // Sort reservations by priority score (lowest score = highest priority)
     qsort(reservation_queue, reservation_count, sizeof(NCReservationRequest), compare_nc_reservations);
@@ -1563,7 +2061,6 @@ int rrc_request_nc_reservation_multi_relay(uint16_t dest_node, uint8_t traffic_t
 void rrc_cleanup_nc_reservations(void)
 {
     uint32_t current_time = (uint32_t)time(NULL);
-    const uint32_t RESERVATION_TIMEOUT = 30; // 30 seconds
 
     int write_index = 0;
     for (int read_index = 0; read_index < reservation_count; read_index++)
@@ -1571,7 +2068,7 @@ void rrc_cleanup_nc_reservations(void)
         NCReservationRequest *req = &reservation_queue[read_index];
         uint32_t age = current_time - req->timestamp;
 
-        if (age <= RESERVATION_TIMEOUT)
+        if (age <= RRC_NC_RESERVATION_TIMEOUT_SEC)
         {
             // Keep this reservation
             if (write_index != read_index)
@@ -1582,6 +2079,9 @@ void rrc_cleanup_nc_reservations(void)
         {
             printf("RRC PRIORITY: Removing expired NC reservation for node %u (age: %u sec)\n",
                    req->nodeID, age);
+            if (req->nodeID < 256)
+                rrc_timer_cancel(RRC_TIMER_RESERVATION_EXPIRY, (uint8_t)req->nodeID);
+            reservation_queue_dirty = true;
         }
     }
 
@@ -1692,14 +2192,10 @@ void init_neighbor_state_table(void)
             neighbor_table[i].txSlots[j] = 0;
             neighbor_table[i].rxSlots[j] = 0;
         }
-
-        neighbor_table[i].phy.rssi_dbm = 0.0f;
-        neighbor_table[i].phy.snr_db = 0.0f;
-        neighbor_table[i].phy.per_percent = 0.0f;
-        neighbor_table[i].phy.packet_count = 0;
-        neighbor_table[i].phy.last_update_time = 0;
     }
 
+    memset(neighbor_index, RRC_NODE_INDEX_NONE, sizeof(neighbor_index));
+    memset(&phy_metrics, 0, sizeof(phy_metrics));
     neighbor_count = 0;
     printf("RRC: Neighbor state table initialized\n");
 }
@@ -1707,34 +2203,56 @@ void init_neighbor_state_table(void)
 // Get neighbor state by node ID (Section A.4)
 NeighborState *rrc_get_neighbor_state(uint16_t nodeID)
 {
-    for (int i = 0; i < neighbor_count; i++)
-    {
-        if (neighbor_table[i].nodeID == nodeID && neighbor_table[i].active)
-        {
-            return &neighbor_table[i];
-        }
-    }
-    return NULL;
+    // Node IDs are uint8_t on the air; the index covers all of them
+    if (nodeID > 255 || neighbor_index[nodeID] == RRC_NODE_INDEX_NONE)
+        return NULL;
+
+    NeighborState *neighbor = &neighbor_table[neighbor_index[nodeID]];
+    return neighbor->active ? neighbor : NULL;
 }
 
 // Create new neighbor state entry (Section A.4)
 NeighborState *rrc_create_neighbor_state(uint16_t nodeID)
 {
-    // Check if already exists
-    NeighborState *existing = rrc_get_neighbor_state(nodeID);
-    if (existing)
+    if (nodeID > 255)
+        return NULL;
+
+    // Check if already exists; an inactive entry keeps its slot and is revived
+    if (neighbor_index[nodeID] != RRC_NODE_INDEX_NONE)
+    {
+        NeighborState *existing = &neighbor_table[neighbor_index[nodeID]];
+        if (!existing->active)
+        {
+            existing->active = true;
+            existing->lastHeardTime = (uint64_t)time(NULL);
+            rrc_timer_arm(RRC_TIMER_NEIGHBOR_EXPIRY, (uint8_t)nodeID, RRC_NEIGHBOR_TIMEOUT_SEC * 1000u);
+        }
         return existing;
+    }
 
-    // Find free slot
-    if (neighbor_count < MAX_MONITORED_NODES)
+    // Find free slot: reuse a released entry before extending the table
+    int slot = -1;
+    for (int i = 0; i < neighbor_count; i++)
+    {
+        if (!neighbor_table[i].active && neighbor_index[neighbor_table[i].nodeID] != i)
+        {
+            slot = i;
+            break;
+        }
+    }
+    if (slot < 0 && neighbor_count < MAX_MONITORED_NODES)
+        slot = neighbor_count++;
+
+    if (slot >= 0)
     {
-        NeighborState *new_neighbor = &neighbor_table[neighbor_count];
+        NeighborState *new_neighbor = &neighbor_table[slot];
         new_neighbor->nodeID = nodeID;
         new_neighbor->active = true;
         new_neighbor->lastHeardTime = (uint64_t)time(NULL);
         new_neighbor->assignedNCSlot = rrc_assign_nc_slot(nodeID);
+        neighbor_index[nodeID] = (uint8_t)slot;
+        rrc_timer_arm(RRC_TIMER_NEIGHBOR_EXPIRY, (uint8_t)nodeID, RRC_NEIGHBOR_TIMEOUT_SEC * 1000u);
 
-        neighbor_count++;
         rrc_update_active_nodes(nodeID);
 
         printf("RRC: Created neighbor state for node %u (NC slot %u)\n",
@@ -1995,6 +2513,12 @@ void rrc_enqueue_relay_packet(struct frame *frame)
         return;
     }
 
+    if (rrc_dup_cache_test(frame->source_add, frame->sequence_number, RRC_DUP_FLAG_FORWARDED))
+    {
+        relay_stats.relay_duplicates_suppressed++;
+        return;
+    }
+
     // Get new next hop from OLSR via IPC
     uint8_t new_next_hop = ipc_olsr_get_next_hop(frame->dest_add);
     frame->next_hop_add = new_next_hop;
@@ -2003,9 +2527,9 @@ void rrc_enqueue_relay_packet(struct frame *frame)
     frame->TTL--;
 
     // Enqueue to relay queue
-    if (!is_full(&rrc_relay_queue))
+    if (rrc_aqm_enqueue(RRC_AQM_CLASS_RELAY, frame))
     {
-        enqueue(&rrc_relay_queue, *frame);
+        rrc_dup_cache_set(frame->source_add, frame->sequence_number, RRC_DUP_FLAG_FORWARDED);
         relay_stats.relay_packets_enqueued++;
 
         printf("RRC: Relayed packet - Dest: %u, Next hop: %u, TTL: %d\n",
@@ -2027,14 +2551,17 @@ void init_rrc_fsm(void)
     current_rrc_state = RRC_STATE_NULL;
 
     // Initialize connection pool
+    memset(&connection_hot, 0, sizeof(connection_hot));
+    memset(connection_index, RRC_NODE_INDEX_NONE, sizeof(connection_index));
+    memset(fsm_pending, 0, sizeof(fsm_pending));
     for (int i = 0; i < RRC_CONNECTION_POOL_SIZE; i++)
     {
-        connection_pool[i].active = false;
         connection_pool[i].dest_node_id = 0;
-        connection_pool[i].next_hop_id = 0;
         connection_pool[i].connection_state = RRC_STATE_NULL;
         connection_pool[i].setup_pending = false;
         connection_pool[i].reconfig_pending = false;
+        connection_pool[i].event_head = 0;
+        connection_pool[i].event_count = 0;
         memset(connection_pool[i].allocated_slots, 0, sizeof(connection_pool[i].allocated_slots));
     }
 
@@ -2071,7 +2598,7 @@ const char *rrc_state_to_string(RRC_SystemState state)
     }
 }
 
-// State transition with logging
+// Node lifecycle transition (NULL ↔ IDLE); connections move through rrc_fsm_dispatch
 void rrc_transition_to_state(RRC_SystemState new_state, uint8_t dest_node)
 {
     RRC_SystemState old_state = current_rrc_state;
@@ -2081,28 +2608,7 @@ void rrc_transition_to_state(RRC_SystemState new_state, uint8_t dest_node)
 
     current_rrc_state = new_state;
     rrc_fsm_stats.state_transitions++;
-}
-
-// Validate state transition
-bool rrc_is_state_transition_valid(RRC_SystemState from, RRC_SystemState to)
-{
-    switch (from)
-    {
-    case RRC_STATE_NULL:
-        return (to == RRC_STATE_IDLE);
-    case RRC_STATE_IDLE:
-        return (to == RRC_STATE_CONNECTION_SETUP || to == RRC_STATE_NULL);
-    case RRC_STATE_CONNECTION_SETUP:
-        return (to == RRC_STATE_CONNECTED || to == RRC_STATE_IDLE);
-    case RRC_STATE_CONNECTED:
-        return (to == RRC_STATE_RECONFIGURATION || to == RRC_STATE_RELEASE);
-    case RRC_STATE_RECONFIGURATION:
-        return (to == RRC_STATE_CONNECTED || to == RRC_STATE_IDLE);
-    case RRC_STATE_RELEASE:
-        return (to == RRC_STATE_IDLE);
-    default:
-        return false;
-    }
+    rrc_fsm_stats.transition_counts[old_state][new_state]++;
 }
 
 // ============================================================================
@@ -2115,14 +2621,10 @@ RRC_ConnectionContext *rrc_get_connection_context(uint8_t dest_node)
     if (!fsm_initialized)
         init_rrc_fsm();
 
-    for (int i = 0; i < RRC_CONNECTION_POOL_SIZE; i++)
-    {
-        if (connection_pool[i].active && connection_pool[i].dest_node_id == dest_node)
-        {
-            return &connection_pool[i];
-        }
-    }
-    return NULL;
+    uint8_t slot = connection_index[dest_node];
+    if (slot == RRC_NODE_INDEX_NONE)
+        return NULL;
+    return &connection_pool[slot];
 }
 
 // Create new connection context
@@ -2142,18 +2644,27 @@ RRC_ConnectionContext *rrc_create_connection_context(uint8_t dest_node)
     // Find free slot
     for (int i = 0; i < RRC_CONNECTION_POOL_SIZE; i++)
     {
-        if (!connection_pool[i].active)
+        if (!connection_hot.active[i])
         {
-            connection_pool[i].active = true;
+            connection_hot.active[i] = true;
+            connection_hot.next_hop_id[i] = 0;
+            connection_hot.last_activity_time[i] = (uint32_t)time(NULL);
+            connection_index[dest_node] = (uint8_t)i;
             connection_pool[i].dest_node_id = dest_node;
-            connection_pool[i].next_hop_id = 0;
             connection_pool[i].connection_start_time = (uint32_t)time(NULL);
-            connection_pool[i].last_activity_time = (uint32_t)time(NULL);
-            connection_pool[i].connection_state = RRC_STATE_CONNECTION_SETUP;
+            connection_pool[i].connection_state = RRC_STATE_IDLE;
+            connection_pool[i].state_enter_ms = rrc_now_ms();
+            connection_pool[i].event_head = 0;
+            connection_pool[i].event_count = 0;
+            connection_pool[i].hold_head = 0;
+            connection_pool[i].hold_count = 0;
             connection_pool[i].setup_pending = true;
             connection_pool[i].reconfig_pending = false;
             memset(connection_pool[i].allocated_slots, 0, sizeof(connection_pool[i].allocated_slots));
 
+            rrc_timer_arm(RRC_TIMER_CONN_SETUP, dest_node, RRC_SETUP_TIMEOUT_SEC * 1000u);
+            rrc_timer_arm(RRC_TIMER_CONN_INACTIVITY, dest_node, RRC_INACTIVITY_TIMEOUT_SEC * 1000u);
+
             printf("RRC: Created connection context for node %u (slot %d)\n", dest_node, i);
             return &connection_pool[i];
         }
@@ -2170,7 +2681,15 @@ void rrc_release_connection_context(uint8_t dest_node)
     if (ctx)
     {
         printf("RRC: Releasing connection context for node %u\n", dest_node);
-        ctx->active = false;
+        connection_hot.active[ctx - connection_pool] = false;
+        connection_index[dest_node] = RRC_NODE_INDEX_NONE;
+        rrc_timer_cancel(RRC_TIMER_CONN_SETUP, dest_node);
+        rrc_timer_cancel(RRC_TIMER_CONN_INACTIVITY, dest_node);
+        rrc_reconfig_abort(ctx);
+        int slot = (int)(ctx - connection_pool);
+        fsm_pending[slot >> 5] &= ~(1u << (slot & 31));
+        ctx->event_count = 0;
+        ctx->connection_state = RRC_STATE_NULL;
         ctx->dest_node_id = 0;
         ctx->setup_pending = false;
         ctx->reconfig_pending = false;
@@ -2180,13 +2699,24 @@ void rrc_release_connection_context(uint8_t dest_node)
 // Update connection activity timestamp
 void rrc_update_connection_activity(uint8_t dest_node)
 {
-    RRC_ConnectionContext *ctx = rrc_get_connection_context(dest_node);
-    if (ctx)
+    uint8_t slot = connection_index[dest_node];
+    if (slot != RRC_NODE_INDEX_NONE)
     {
-        ctx->last_activity_time = (uint32_t)time(NULL);
+        connection_hot.last_activity_time[slot] = (uint32_t)time(NULL);
     }
 }
 
+// Hot-field accessors for a connection context
+uint8_t rrc_connection_next_hop(const RRC_ConnectionContext *ctx)
+{
+    return connection_hot.next_hop_id[ctx - connection_pool];
+}
+
+void rrc_connection_set_next_hop(RRC_ConnectionContext *ctx, uint8_t next_hop)
+{
+    connection_hot.next_hop_id[ctx - connection_pool] = next_hop;
+}
+
 // ============================================================================
 // FSM EVENT HANDLERS
 // ============================================================================
@@ -2239,7 +2769,7 @@ int rrc_handle_power_off(void)
     // Release all active connections
     for (int i = 0; i < RRC_CONNECTION_POOL_SIZE; i++)
     {
-        if (connection_pool[i].active)
+        if (connection_hot.active[i])
         {
             rrc_release_connection_context(connection_pool[i].dest_node_id);
         }
@@ -2255,74 +2785,300 @@ int rrc_handle_power_off(void)
     return 0;
 }
 
-// IDLE → CONNECTION_SETUP: Data request triggers setup
-int rrc_handle_data_request(uint8_t dest_node, MessagePriority qos)
+// ============================================================================
+// CONNECTION FSM (table-driven, per-connection state and event queue)
+// ============================================================================
+//
+// Each connection context carries its own state and a small event queue.
+// Timers, routing and the application path post events; the RRC worker
+// drains them in rrc_fsm_process_events(), so connections progress through
+// setup, reconfiguration and release independently of each other. The
+// rrc_handle_* entry points run the same table synchronously. A connection
+// that reaches IDLE returns its context to the pool.
+
+static int rrc_fsm_action_data_request(RRC_ConnectionContext *ctx, const RRC_FsmEventMsg *msg);
+static int rrc_fsm_action_route_allocated(RRC_ConnectionContext *ctx, const RRC_FsmEventMsg *msg);
+static int rrc_fsm_action_setup_timeout(RRC_ConnectionContext *ctx, const RRC_FsmEventMsg *msg);
+static int rrc_fsm_action_route_change(RRC_ConnectionContext *ctx, const RRC_FsmEventMsg *msg);
+static int rrc_fsm_action_reconfig_success(RRC_ConnectionContext *ctx, const RRC_FsmEventMsg *msg);
+static int rrc_fsm_action_inactivity(RRC_ConnectionContext *ctx, const RRC_FsmEventMsg *msg);
+static int rrc_fsm_action_release(RRC_ConnectionContext *ctx, const RRC_FsmEventMsg *msg);
+
+// X(from, event, next on success, next on failure, action)
+#define RRC_FSM_TRANSITIONS(X)                                                                         \
+    X(IDLE, DATA_REQUEST, CONNECTION_SETUP, IDLE, rrc_fsm_action_data_request)                         \
+    X(CONNECTION_SETUP, ROUTE_ALLOCATED, CONNECTED, IDLE, rrc_fsm_action_route_allocated)              \
+    X(CONNECTION_SETUP, ROUTE_LOST, IDLE, IDLE, NULL)                                                  \
+    X(CONNECTION_SETUP, SETUP_TIMEOUT, IDLE, CONNECTION_SETUP, rrc_fsm_action_setup_timeout)           \
+    X(CONNECTED, ROUTE_CHANGE, RECONFIGURATION, CONNECTED, rrc_fsm_action_route_change)                \
+    X(CONNECTED, INACTIVITY_TIMEOUT, RELEASE, CONNECTED, rrc_fsm_action_inactivity)                    \
+    X(CONNECTED, RELEASE_REQUEST, RELEASE, RELEASE, rrc_fsm_action_release)                            \
+    X(RECONFIGURATION, RECONFIG_SUCCESS, CONNECTED, RECONFIGURATION, rrc_fsm_action_reconfig_success)  \
+    X(RECONFIGURATION, ROUTE_LOST, IDLE, IDLE, NULL)                                                   \
+    X(RECONFIGURATION, INACTIVITY_TIMEOUT, IDLE, RECONFIGURATION, rrc_fsm_action_inactivity)           \
+    X(RELEASE, RELEASE_COMPLETE, IDLE, IDLE, NULL)
+
+#define RRC_FSM_TABLE_ENTRY(from, event, to, fail, action) \
+    [RRC_STATE_##from][RRC_EVENT_##event] = {true, RRC_STATE_##to, RRC_STATE_##fail, action},
+
+static const RRC_FsmTransition rrc_fsm_table[RRC_FSM_STATE_COUNT][RRC_EVENT_COUNT] = {
+    RRC_FSM_TRANSITIONS(RRC_FSM_TABLE_ENTRY)};
+
+#define RRC_FSM_EVENT_NAME(name) #name,
+static const char *rrc_fsm_event_names[RRC_EVENT_COUNT] = {RRC_FSM_EVENTS(RRC_FSM_EVENT_NAME)};
+
+const char *rrc_fsm_event_to_string(RRC_FsmEvent event)
+{
+    return (event < RRC_EVENT_COUNT) ? rrc_fsm_event_names[event] : "UNKNOWN";
+}
+
+// Validate state transition: node lifecycle or any edge of the connection table
+bool rrc_is_state_transition_valid(RRC_SystemState from, RRC_SystemState to)
 {
-    if (current_rrc_state != RRC_STATE_IDLE)
+    if ((from == RRC_STATE_NULL && to == RRC_STATE_IDLE) ||
+        (from == RRC_STATE_IDLE && to == RRC_STATE_NULL))
+        return true;
+    if (from >= RRC_FSM_STATE_COUNT)
+        return false;
+
+    for (int e = 0; e < RRC_EVENT_COUNT; e++)
     {
-        printf("RRC: WARNING - Data request in state %s\n", rrc_state_to_string(current_rrc_state));
-        return -1;
+        const RRC_FsmTransition *t = &rrc_fsm_table[from][e];
+        if (t->defined && to != from && (t->next == to || t->fail == to))
+            return true;
     }
+    return false;
+}
 
-    printf("RRC: Data request for node %u with QoS priority %d\n", dest_node, qos);
-
-    // Create connection context
-    RRC_ConnectionContext *ctx = rrc_create_connection_context(dest_node);
-    if (!ctx)
+static int rrc_fsm_hist_bucket(uint32_t ms)
+{
+    int bucket = 0;
+    while (ms && bucket < RRC_FSM_HIST_BUCKETS - 1)
     {
-        printf("RRC: ERROR - Cannot create connection context for node %u\n", dest_node);
-        return -1;
+        ms >>= 1;
+        bucket++;
     }
+    return bucket;
+}
 
-    ctx->qos_priority = qos;
+// Commit a connection state change; entering IDLE releases the context
+static void rrc_fsm_enter_state(RRC_ConnectionContext *ctx, RRC_SystemState new_state)
+{
+    RRC_SystemState old_state = ctx->connection_state;
+    uint32_t now = rrc_now_ms();
+    uint8_t dest_node = ctx->dest_node_id;
 
-    // Query OLSR for route via IPC
-    uint8_t next_hop = ipc_olsr_get_next_hop(dest_node);
-    if (next_hop == 0)
+    printf("RRC: FSM State transition: %s → %s (Node %u)\n",
+           rrc_state_to_string(old_state), rrc_state_to_string(new_state), dest_node);
+
+    rrc_fsm_stats.state_transitions++;
+    rrc_fsm_stats.transition_counts[old_state][new_state]++;
+    rrc_fsm_stats.time_in_state[old_state][rrc_fsm_hist_bucket(now - ctx->state_enter_ms)]++;
+
+    ctx->connection_state = new_state;
+    ctx->state_enter_ms = now;
+
+    if (new_state == RRC_STATE_IDLE)
+        rrc_release_connection_context(dest_node);
+}
+
+static int rrc_fsm_dispatch(RRC_ConnectionContext *ctx, const RRC_FsmEventMsg *msg)
+{
+    RRC_SystemState from = ctx->connection_state;
+    const RRC_FsmTransition *t = &rrc_fsm_table[from][msg->event];
+
+    rrc_fsm_stats.events[msg->event]++;
+    if (!t->defined)
     {
-        printf("RRC: No route available, triggering route discovery\n");
-        olsr_trigger_route_discovery(dest_node);
-        rrc_stats.route_discoveries_triggered++;
-        // Keep context in CONNECTION_SETUP state waiting for route
+        printf("RRC: WARNING - %s event in state %s (Node %u)\n",
+               rrc_fsm_event_to_string((RRC_FsmEvent)msg->event), rrc_state_to_string(from),
+               ctx->dest_node_id);
+        rrc_fsm_stats.rejected_events++;
+        return -1;
     }
-    else
+
+    int result = t->action ? t->action(ctx, msg) : 0;
+    RRC_SystemState to = (result == 0) ? t->next : t->fail;
+    if (to != from)
+        rrc_fsm_enter_state(ctx, to);
+    return result;
+}
+
+static bool rrc_fsm_enqueue(RRC_ConnectionContext *ctx, const RRC_FsmEventMsg *msg)
+{
+    if (ctx->event_count >= RRC_FSM_EVENT_QUEUE_DEPTH)
     {
-        ctx->next_hop_id = next_hop;
-        printf("RRC: Route found via next hop %u\n", next_hop);
+        rrc_fsm_stats.queue_overflows++;
+        printf("RRC: WARNING - FSM event queue full for node %u, dropped %s\n",
+               ctx->dest_node_id, rrc_fsm_event_to_string((RRC_FsmEvent)msg->event));
+        return false;
     }
 
-    // Transition to CONNECTION_SETUP
-    rrc_transition_to_state(RRC_STATE_CONNECTION_SETUP, dest_node);
-    rrc_fsm_stats.connection_setups++;
+    ctx->events[(ctx->event_head + ctx->event_count) % RRC_FSM_EVENT_QUEUE_DEPTH] = *msg;
+    ctx->event_count++;
 
-    return 0;
+    int slot = (int)(ctx - connection_pool);
+    fsm_pending[slot >> 5] |= 1u << (slot & 31);
+    return true;
 }
 
-// CONNECTION_SETUP → CONNECTED: Route and slots allocated
-int rrc_handle_route_and_slots_allocated(uint8_t dest_node, uint8_t next_hop)
+// Dispatch the oldest queued event of one connection
+static bool rrc_fsm_step_connection(int slot)
 {
-    if (current_rrc_state != RRC_STATE_CONNECTION_SETUP)
+    RRC_ConnectionContext *ctx = &connection_pool[slot];
+    if (!connection_hot.active[slot] || ctx->event_count == 0)
     {
-        printf("RRC: WARNING - Route allocation in state %s\n", rrc_state_to_string(current_rrc_state));
-        return -1;
+        fsm_pending[slot >> 5] &= ~(1u << (slot & 31));
+        return false;
     }
 
+    RRC_FsmEventMsg msg = ctx->events[ctx->event_head];
+    ctx->event_head = (uint8_t)((ctx->event_head + 1) % RRC_FSM_EVENT_QUEUE_DEPTH);
+    if (--ctx->event_count == 0)
+        fsm_pending[slot >> 5] &= ~(1u << (slot & 31));
+
+    rrc_fsm_dispatch(ctx, &msg);
+    return true;
+}
+
+static bool rrc_fsm_connection_live(int slot, uint8_t dest_node)
+{
+    return connection_hot.active[slot] && connection_index[dest_node] == slot;
+}
+
+// Queue an event for a connection; DATA_REQUEST creates the context
+bool rrc_fsm_post_event(uint8_t dest_node, RRC_FsmEvent event, uint8_t next_hop, MessagePriority qos)
+{
+    if (event >= RRC_EVENT_COUNT)
+        return false;
+
     RRC_ConnectionContext *ctx = rrc_get_connection_context(dest_node);
     if (!ctx)
     {
-        printf("RRC: ERROR - No connection context for node %u\n", dest_node);
-        return -1;
+        if (event != RRC_EVENT_DATA_REQUEST)
+            return false;
+        ctx = rrc_create_connection_context(dest_node);
+        if (!ctx)
+            return false;
     }
 
-    // Check RRC slot availability and allocate
-    if (!rrc_check_slot_available(next_hop, ctx->qos_priority))
-    {
-        printf("RRC: ⚠️ No slots available for next hop %u\n", next_hop);
-        rrc_stats.messages_discarded_no_slots++;
-        // Return to IDLE state
-        rrc_transition_to_state(RRC_STATE_IDLE, dest_node);
-        rrc_release_connection_context(dest_node);
+    RRC_FsmEventMsg msg = {(uint8_t)event, next_hop, (uint8_t)qos};
+    return rrc_fsm_enqueue(ctx, &msg);
+}
+
+// RRC worker: drain queued events round-robin, one per connection per pass
+int rrc_fsm_process_events(int budget)
+{
+    int processed = 0;
+    bool progress = true;
+
+    while (progress && processed < budget)
+    {
+        progress = false;
+        for (int w = 0; w < (int)(sizeof(fsm_pending) / sizeof(fsm_pending[0])); w++)
+        {
+            uint32_t bits = fsm_pending[w];
+            while (bits && processed < budget)
+            {
+                int slot = w * 32 + __builtin_ctz(bits);
+                bits &= bits - 1;
+                if (rrc_fsm_step_connection(slot))
+                {
+                    processed++;
+                    progress = true;
+                }
+            }
+        }
+    }
+    return processed;
+}
+
+// Run one event to completion on a connection, after anything already queued for it
+static int rrc_fsm_handle_now(uint8_t dest_node, RRC_FsmEvent event, uint8_t next_hop, MessagePriority qos)
+{
+    RRC_ConnectionContext *ctx = rrc_get_connection_context(dest_node);
+    if (!ctx)
+    {
+        if (event != RRC_EVENT_DATA_REQUEST)
+        {
+            printf("RRC: ERROR - No connection context for node %u\n", dest_node);
+            return -1;
+        }
+        ctx = rrc_create_connection_context(dest_node);
+        if (!ctx)
+        {
+            printf("RRC: ERROR - Cannot create connection context for node %u\n", dest_node);
+            return -1;
+        }
+    }
+
+    int slot = (int)(ctx - connection_pool);
+    while (rrc_fsm_connection_live(slot, dest_node) && ctx->event_count > 0)
+        rrc_fsm_step_connection(slot);
+    if (!rrc_fsm_connection_live(slot, dest_node))
         return -1;
+
+    RRC_FsmEventMsg msg = {(uint8_t)event, next_hop, (uint8_t)qos};
+    int result = rrc_fsm_dispatch(ctx, &msg);
+
+    // Follow-up events raised by the action (e.g. RELEASE_COMPLETE)
+    while (rrc_fsm_connection_live(slot, dest_node) && ctx->event_count > 0)
+        rrc_fsm_step_connection(slot);
+
+    return result;
+}
+
+uint32_t rrc_fsm_transition_count(RRC_SystemState from, RRC_SystemState to)
+{
+    if (from >= RRC_FSM_STATE_COUNT || to >= RRC_FSM_STATE_COUNT)
+        return 0;
+    return rrc_fsm_stats.transition_counts[from][to];
+}
+
+const uint32_t *rrc_fsm_time_in_state_histogram(RRC_SystemState state)
+{
+    if (state >= RRC_FSM_STATE_COUNT)
+        return NULL;
+    return rrc_fsm_stats.time_in_state[state];
+}
+
+// IDLE → CONNECTION_SETUP: Data request triggers setup
+static int rrc_fsm_action_data_request(RRC_ConnectionContext *ctx, const RRC_FsmEventMsg *msg)
+{
+    uint8_t dest_node = ctx->dest_node_id;
+    ctx->qos_priority = (MessagePriority)(int8_t)msg->qos;
+
+    // Query OLSR for route via IPC
+    uint8_t next_hop = ipc_olsr_get_next_hop(dest_node);
+    if (next_hop == 0)
+    {
+        printf("RRC: No route available, triggering route discovery\n");
+        olsr_trigger_route_discovery(dest_node);
+        rrc_stats.route_discoveries_triggered++;
+        // Keep context in CONNECTION_SETUP state waiting for route
+    }
+    else
+    {
+        rrc_connection_set_next_hop(ctx, next_hop);
+        printf("RRC: Route found via next hop %u\n", next_hop);
+    }
+
+    rrc_fsm_stats.connection_setups++;
+    return 0;
+}
+
+// CONNECTION_SETUP → CONNECTED: Route and slots allocated
+static int rrc_fsm_action_route_allocated(RRC_ConnectionContext *ctx, const RRC_FsmEventMsg *msg)
+{
+    uint8_t dest_node = ctx->dest_node_id;
+    uint8_t next_hop = msg->next_hop;
+
+    // Check RRC slot availability and allocate
+    if (!rrc_check_slot_available(next_hop, ctx->qos_priority))
+    {
+        printf("RRC: ⚠️ No slots available for next hop %u\n", next_hop);
+        rrc_stats.messages_discarded_no_slots++;
+        return -1; // Return to IDLE state
     }
 
     // Allocate slot for this connection
@@ -2330,129 +3086,319 @@ int rrc_handle_route_and_slots_allocated(uint8_t dest_node, uint8_t next_hop)
     if (allocated_slot == 255)
     {
         printf("RRC: ERROR - Slot allocation failed for node %u\n", dest_node);
-        rrc_transition_to_state(RRC_STATE_IDLE, dest_node);
-        rrc_release_connection_context(dest_node);
         return -1;
     }
 
     // Update connection context
-    ctx->next_hop_id = next_hop;
+    rrc_connection_set_next_hop(ctx, next_hop);
     ctx->setup_pending = false;
-    ctx->connection_state = RRC_STATE_CONNECTED;
-
-    // Transition to CONNECTED
-    rrc_transition_to_state(RRC_STATE_CONNECTED, dest_node);
+    rrc_timer_cancel(RRC_TIMER_CONN_SETUP, dest_node);
 
     printf("RRC: Connection established - Node %u via next hop %u\n", dest_node, next_hop);
     return 0;
 }
 
-// CONNECTED → RECONFIGURATION: Route change detected
-int rrc_handle_route_change(uint8_t dest_node, uint8_t new_next_hop)
+// CONNECTION_SETUP → IDLE: Setup did not complete in time
+static int rrc_fsm_action_setup_timeout(RRC_ConnectionContext *ctx, const RRC_FsmEventMsg *msg)
 {
-    if (current_rrc_state != RRC_STATE_CONNECTED)
-    {
-        printf("RRC: WARNING - Route change in state %s\n", rrc_state_to_string(current_rrc_state));
+    (void)msg;
+    if (!ctx->setup_pending)
         return -1;
-    }
 
-    RRC_ConnectionContext *ctx = rrc_get_connection_context(dest_node);
-    if (!ctx)
-    {
-        printf("RRC: ERROR - No connection context for node %u\n", dest_node);
-        return -1;
-    }
+    uint32_t setup_time = (uint32_t)time(NULL) - ctx->connection_start_time;
+    printf("RRC: Setup timeout for node %u (%u seconds)\n", ctx->dest_node_id, setup_time);
+    rrc_fsm_stats.setup_timeouts++;
+    return 0;
+}
+
+// CONNECTED → RECONFIGURATION: Route change detected
+static int rrc_fsm_action_route_change(RRC_ConnectionContext *ctx, const RRC_FsmEventMsg *msg)
+{
+    uint8_t dest_node = ctx->dest_node_id;
 
     printf("RRC: Route change detected - Node %u: %u → %u\n",
-           dest_node, ctx->next_hop_id, new_next_hop);
+           dest_node, rrc_connection_next_hop(ctx), msg->next_hop);
 
     // Trigger route discovery for verification via IPC
     ipc_olsr_trigger_route_discovery(dest_node);
     rrc_stats.route_discoveries_triggered++;
 
-    // Set reconfiguration pending
+    // Set reconfiguration pending; the old path keeps its slots until the new one is confirmed
     ctx->reconfig_pending = true;
-    ctx->connection_state = RRC_STATE_RECONFIGURATION;
-
-    // Transition to RECONFIGURATION
-    rrc_transition_to_state(RRC_STATE_RECONFIGURATION, dest_node);
+    rrc_reconfig_begin(ctx, msg->next_hop);
     rrc_fsm_stats.reconfigurations++;
-
     return 0;
 }
 
 // RECONFIGURATION → CONNECTED: Successful reconfiguration
-int rrc_handle_reconfig_success(uint8_t dest_node, uint8_t new_next_hop)
+static int rrc_fsm_action_reconfig_success(RRC_ConnectionContext *ctx, const RRC_FsmEventMsg *msg)
+{
+    // Update connection with new route, move queued and held traffic onto it
+    rrc_reconfig_commit(ctx, msg->next_hop);
+    ctx->reconfig_pending = false;
+
+    printf("RRC: Reconfiguration successful - Node %u now via next hop %u\n",
+           ctx->dest_node_id, msg->next_hop);
+    return 0;
+}
+
+// CONNECTED → RELEASE, RECONFIGURATION → IDLE: Inactivity timeout
+static int rrc_fsm_action_inactivity(RRC_ConnectionContext *ctx, const RRC_FsmEventMsg *msg)
 {
-    if (current_rrc_state != RRC_STATE_RECONFIGURATION)
+    (void)msg;
+    uint32_t current_time = (uint32_t)time(NULL);
+    uint32_t inactivity_time = current_time - connection_hot.last_activity_time[ctx - connection_pool];
+
+    if (inactivity_time < RRC_INACTIVITY_TIMEOUT_SEC)
+        return -1; // Still active
+
+    printf("RRC: Inactivity timeout for node %u (%u seconds)\n", ctx->dest_node_id, inactivity_time);
+    rrc_fsm_stats.inactivity_releases++;
+
+    // From CONNECTED the release finishes through RELEASE_COMPLETE
+    if (ctx->connection_state == RRC_STATE_CONNECTED)
     {
-        printf("RRC: WARNING - Reconfig success in state %s\n", rrc_state_to_string(current_rrc_state));
-        return -1;
+        RRC_FsmEventMsg done = {RRC_EVENT_RELEASE_COMPLETE, 0, 0};
+        rrc_fsm_enqueue(ctx, &done);
     }
+    return 0;
+}
 
-    RRC_ConnectionContext *ctx = rrc_get_connection_context(dest_node);
-    if (!ctx)
+// CONNECTED → RELEASE: Tear down and complete the release
+static int rrc_fsm_action_release(RRC_ConnectionContext *ctx, const RRC_FsmEventMsg *msg)
+{
+    (void)msg;
+    printf("RRC: Release complete for node %u\n", ctx->dest_node_id);
+    rrc_fsm_stats.connection_releases++;
+
+    RRC_FsmEventMsg done = {RRC_EVENT_RELEASE_COMPLETE, 0, 0};
+    rrc_fsm_enqueue(ctx, &done);
+    return 0;
+}
+
+// IDLE → CONNECTION_SETUP: Data request triggers setup
+int rrc_handle_data_request(uint8_t dest_node, MessagePriority qos)
+{
+    if (current_rrc_state != RRC_STATE_IDLE)
     {
-        printf("RRC: ERROR - No connection context for node %u\n", dest_node);
+        printf("RRC: WARNING - Data request in state %s\n", rrc_state_to_string(current_rrc_state));
         return -1;
     }
 
-    // Update connection with new route
-    ctx->next_hop_id = new_next_hop;
-    ctx->reconfig_pending = false;
-    ctx->connection_state = RRC_STATE_CONNECTED;
+    printf("RRC: Data request for node %u with QoS priority %d\n", dest_node, qos);
+    return rrc_fsm_handle_now(dest_node, RRC_EVENT_DATA_REQUEST, 0, qos);
+}
+
+// CONNECTION_SETUP → CONNECTED: Route and slots allocated
+int rrc_handle_route_and_slots_allocated(uint8_t dest_node, uint8_t next_hop)
+{
+    return rrc_fsm_handle_now(dest_node, RRC_EVENT_ROUTE_ALLOCATED, next_hop, PRIORITY_DATA_3);
+}
 
-    // Transition back to CONNECTED
-    rrc_transition_to_state(RRC_STATE_CONNECTED, dest_node);
+// CONNECTION_SETUP/RECONFIGURATION → IDLE: No route to destination
+int rrc_handle_route_lost(uint8_t dest_node)
+{
+    return rrc_fsm_handle_now(dest_node, RRC_EVENT_ROUTE_LOST, 0, PRIORITY_DATA_3);
+}
 
-    printf("RRC: Reconfiguration successful - Node %u now via next hop %u\n",
-           dest_node, new_next_hop);
-    return 0;
+// CONNECTION_SETUP → IDLE: Setup timer expired
+int rrc_handle_setup_timeout(uint8_t dest_node)
+{
+    return rrc_fsm_handle_now(dest_node, RRC_EVENT_SETUP_TIMEOUT, 0, PRIORITY_DATA_3);
+}
+
+// CONNECTED → RECONFIGURATION: Route change detected
+int rrc_handle_route_change(uint8_t dest_node, uint8_t new_next_hop)
+{
+    return rrc_fsm_handle_now(dest_node, RRC_EVENT_ROUTE_CHANGE, new_next_hop, PRIORITY_DATA_3);
+}
+
+// RECONFIGURATION → CONNECTED: Successful reconfiguration
+int rrc_handle_reconfig_success(uint8_t dest_node, uint8_t new_next_hop)
+{
+    return rrc_fsm_handle_now(dest_node, RRC_EVENT_RECONFIG_SUCCESS, new_next_hop, PRIORITY_DATA_3);
 }
 
-// Any state → IDLE: Handle inactivity timeout
+// CONNECTED/RECONFIGURATION → IDLE: Handle inactivity timeout
 int rrc_handle_inactivity_timeout(uint8_t dest_node)
+{
+    if (!rrc_get_connection_context(dest_node))
+        return 0; // No active connection
+
+    rrc_fsm_handle_now(dest_node, RRC_EVENT_INACTIVITY_TIMEOUT, 0, PRIORITY_DATA_3);
+    return rrc_get_connection_context(dest_node) ? 0 : 1; // 1 = released
+}
+
+// CONNECTED/RELEASE → IDLE: Release complete
+int rrc_handle_release_complete(uint8_t dest_node)
 {
     RRC_ConnectionContext *ctx = rrc_get_connection_context(dest_node);
     if (!ctx)
+        return 0;
+
+    RRC_FsmEvent event = (ctx->connection_state == RRC_STATE_RELEASE) ? RRC_EVENT_RELEASE_COMPLETE
+                                                                      : RRC_EVENT_RELEASE_REQUEST;
+    return rrc_fsm_handle_now(dest_node, event, 0, PRIORITY_DATA_3);
+}
+
+// ============================================================================
+// TIMER WHEEL
+// ============================================================================
+//
+// Every RRC timeout registers with the wheel in rrc_timer_wheel.h instead
+// of being found by a table scan. Handlers re-check their object and re-arm
+// for the remaining time, so hot paths (activity updates, neighbor
+// refreshes) only touch a timestamp.
+
+void init_rrc_timers(void)
+{
+    rrc_timer_wheel_init(&timer_wheel, rrc_now_ms());
+    memset(&timer_stats, 0, sizeof(timer_stats));
+    timers_initialized = true;
+    printf("RRC: Timer wheel initialized (%d timers, %d buckets)\n",
+           RRC_TIMER_POOL_SIZE, RRC_TIMER_BUCKETS);
+}
+
+// Arm (or re-arm) the timer for (kind, key) to fire delay_ms from now
+bool rrc_timer_arm(RRC_TimerKind kind, uint8_t key, uint32_t delay_ms)
+{
+    if (!timers_initialized)
+        init_rrc_timers();
+
+    if (!rrc_timer_wheel_arm(&timer_wheel, (uint8_t)kind, key, rrc_now_ms() + delay_ms))
     {
-        return 0; // No active connection
+        printf("RRC: ERROR - Timer pool exhausted (%s for node %u)\n", timer_kind_names[kind], key);
+        return false;
     }
+    return true;
+}
 
-    uint32_t current_time = (uint32_t)time(NULL);
-    uint32_t inactivity_time = current_time - ctx->last_activity_time;
+void rrc_timer_cancel(RRC_TimerKind kind, uint8_t key)
+{
+    if (!timers_initialized)
+        return;
+
+    rrc_timer_wheel_cancel(&timer_wheel, (uint8_t)kind, key);
+}
+
+bool rrc_timer_is_armed(RRC_TimerKind kind, uint8_t key)
+{
+    return timers_initialized && rrc_timer_wheel_is_armed(&timer_wheel, (uint8_t)kind, key);
+}
+
+// Seconds until an activity/heard timestamp ages past timeout_sec, as a re-arm delay
+static uint32_t rrc_timer_remaining_ms(uint32_t since, uint32_t timeout_sec)
+{
+    uint32_t age = (uint32_t)time(NULL) - since;
+    return (age >= timeout_sec) ? 0 : (timeout_sec - age) * 1000u;
+}
+
+static void rrc_timer_dispatch(uint8_t kind_id, uint8_t key, void *user)
+{
+    RRC_TimerKind kind = (RRC_TimerKind)kind_id;
+    (void)user;
+
+    timer_stats.fired[kind]++;
 
-    if (inactivity_time >= RRC_INACTIVITY_TIMEOUT_SEC)
+    switch (kind)
     {
-        printf("RRC: Inactivity timeout for node %u (%u seconds)\n", dest_node, inactivity_time);
+    case RRC_TIMER_CONN_SETUP:
+    {
+        RRC_ConnectionContext *ctx = rrc_get_connection_context(key);
+        if (ctx && ctx->setup_pending)
+            rrc_fsm_post_event(key, RRC_EVENT_SETUP_TIMEOUT, 0, ctx->qos_priority);
+        break;
+    }
+
+    case RRC_TIMER_CONN_INACTIVITY:
+    {
+        RRC_ConnectionContext *ctx = rrc_get_connection_context(key);
+        if (ctx && !rrc_handle_inactivity_timeout(key))
+        {
+            uint32_t last = connection_hot.last_activity_time[ctx - connection_pool];
+            rrc_timer_arm(kind, key, rrc_timer_remaining_ms(last, RRC_INACTIVITY_TIMEOUT_SEC) + 1000u);
+        }
+        break;
+    }
 
-        // Transition to RELEASE then IDLE
-        rrc_transition_to_state(RRC_STATE_RELEASE, dest_node);
-        rrc_transition_to_state(RRC_STATE_IDLE, dest_node);
+    case RRC_TIMER_NEIGHBOR_EXPIRY:
+    {
+        NeighborState *neighbor = rrc_get_neighbor_state(key);
+        if (!neighbor)
+            break;
 
-        rrc_release_connection_context(dest_node);
-        rrc_fsm_stats.inactivity_releases++;
+        uint32_t remaining = rrc_timer_remaining_ms((uint32_t)neighbor->lastHeardTime, RRC_NEIGHBOR_TIMEOUT_SEC);
+        if (remaining == 0)
+        {
+            printf("RRC: Neighbor %u timed out after %u seconds\n", key, RRC_NEIGHBOR_TIMEOUT_SEC);
+            rrc_deactivate_neighbor(neighbor);
+        }
+        else
+        {
+            rrc_timer_arm(kind, key, remaining + 1000u);
+        }
+        break;
+    }
+
+    case RRC_TIMER_RESERVATION_EXPIRY:
+        for (int i = 0; i < reservation_count; i++)
+        {
+            if (reservation_queue[i].nodeID != key)
+                continue;
+
+            uint32_t remaining = rrc_timer_remaining_ms(reservation_queue[i].timestamp, RRC_NC_RESERVATION_TIMEOUT_SEC);
+            if (remaining == 0)
+            {
+                printf("RRC PRIORITY: Removing expired NC reservation for node %u\n", key);
+                memmove(&reservation_queue[i], &reservation_queue[i + 1],
+                        (size_t)(reservation_count - i - 1) * sizeof(NCReservationRequest));
+                reservation_count--;
+                reservation_queue_dirty = true;
+            }
+            else
+            {
+                rrc_timer_arm(kind, key, remaining + 1000u);
+            }
+            break;
+        }
+        break;
+
+    case RRC_TIMER_PIGGYBACK_TTL:
+        rrc_update_piggyback_ttl();
+        if (piggyback_active)
+            rrc_timer_arm(kind, key, RRC_PIGGYBACK_TTL_TICK_MS);
+        break;
+
+    case RRC_TIMER_RECONFIG_HOLD:
+        rrc_reconfig_poll(key);
+        break;
 
-        return 1; // Released
+    default:
+        break;
     }
+}
+
+// Advance the wheel to now and run every expired timer; returns the count
+int rrc_timer_service(void)
+{
+    if (!timers_initialized)
+        init_rrc_timers();
 
-    return 0; // Still active
+    return rrc_timer_wheel_advance(&timer_wheel, rrc_now_ms(), rrc_timer_dispatch, NULL);
 }
 
-// CONNECTED/RELEASE → IDLE: Release complete
-int rrc_handle_release_complete(uint8_t dest_node)
+void print_timer_stats(void)
 {
-    RRC_ConnectionContext *ctx = rrc_get_connection_context(dest_node);
-    if (ctx)
+    printf("\n=== Timer Wheel Statistics ===\n");
+    printf("Armed now: %d / %d\n", rrc_timer_wheel_armed_count(&timer_wheel), RRC_TIMER_POOL_SIZE);
+    printf("Arms: %u, Cancels: %u, Cascaded: %u, Pool exhausted: %u\n",
+           timer_wheel.armed, timer_wheel.cancelled, timer_wheel.cascaded,
+           timer_wheel.pool_exhausted);
+    for (int k = 0; k < RRC_TIMER_KIND_COUNT; k++)
     {
-        printf("RRC: Release complete for node %u\n", dest_node);
-        rrc_release_connection_context(dest_node);
-        rrc_fsm_stats.connection_releases++;
+        printf("  %-20s fired: %u\n", timer_kind_names[k], timer_stats.fired[k]);
     }
-
-    // Transition to IDLE
-    rrc_transition_to_state(RRC_STATE_IDLE, dest_node);
-    return 0;
+    printf("==============================\n\n");
 }
 
 // ============================================================================
@@ -2465,46 +3411,24 @@ void rrc_periodic_system_management(void)
     if (!fsm_initialized)
         return;
 
-    uint32_t current_time = (uint32_t)time(NULL);
-
-    // Check all active connections for timeouts
-    for (int i = 0; i < RRC_CONNECTION_POOL_SIZE; i++)
-    {
-        if (connection_pool[i].active)
-        {
-            uint8_t dest_node = connection_pool[i].dest_node_id;
-
-            // Check setup timeout
-            if (connection_pool[i].setup_pending)
-            {
-                uint32_t setup_time = current_time - connection_pool[i].connection_start_time;
-                if (setup_time >= RRC_SETUP_TIMEOUT_SEC)
-                {
-                    printf("RRC: Setup timeout for node %u (%u seconds)\n", dest_node, setup_time);
-                    rrc_transition_to_state(RRC_STATE_IDLE, dest_node);
-                    rrc_release_connection_context(dest_node);
-                    rrc_fsm_stats.setup_timeouts++;
-                    continue;
-                }
-            }
-
-            // Check inactivity timeout
-            rrc_handle_inactivity_timeout(dest_node);
-        }
-    }
+    // Connection setup/inactivity, neighbor expiry, NC reservation expiry
+    // and piggyback TTL all fire from the timer wheel
+    rrc_timer_service();
 
-    // Cleanup stale neighbors periodically
-    cleanup_stale_neighbors();
+    // Drain per-connection FSM events posted since the last pass
+    rrc_fsm_process_events(RRC_CONNECTION_POOL_SIZE * RRC_FSM_EVENT_QUEUE_DEPTH);
 
-    // EXTENSION: Periodic piggyback TTL management (Requirement 1)
-    rrc_update_piggyback_ttl();
+    // Pick up MPR set and route changes from OLSR, refresh and age multicast membership
+    rrc_poll_olsr_updates();
+    rrc_mcast_refresh_membership();
+    rrc_mcast_expire_members();
 
     // EXTENSION: Update NC slot allocation round-robin (Requirement 3)
     rrc_update_nc_schedule();
 
-    // EXTENSION: Process NC reservations by priority and cleanup expired ones
-    rrc_process_nc_reservations_by_priority();
-    rrc_cleanup_nc_reservations();
+    // EXTENSION: Re-run priority assignment only when reservations changed
+    if (reservation_queue_dirty)
+        rrc_process_nc_reservations_by_priority();
 }
 
 // ============================================================================
@@ -2522,14 +3446,14 @@ int rrc_request_transmit_slot(uint8_t dest_node, MessagePriority priority)
     }
 
     // Check RRC slot availability
-    if (!rrc_check_slot_available(ctx->next_hop_id, priority))
+    if (!rrc_check_slot_available(rrc_connection_next_hop(ctx), priority))
     {
         printf("RRC: No transmit slots available for node %u (priority %d)\n", dest_node, priority);
         return -1;
     }
 
     // Allocate slot for transmission
-    uint8_t allocated_slot = rrc_allocate_du_gu_slot(ctx->next_hop_id, priority);
+    uint8_t allocated_slot = rrc_allocate_du_gu_slot(rrc_connection_next_hop(ctx), priority);
     if (allocated_slot == 255)
     {
         printf("RRC: Slot allocation failed for node %u\n", dest_node);
@@ -2537,7 +3461,7 @@ int rrc_request_transmit_slot(uint8_t dest_node, MessagePriority priority)
     }
 
     printf("RRC: Transmit slot %u allocated for node %u via next hop %u\n",
-           allocated_slot, dest_node, ctx->next_hop_id);
+           allocated_slot, dest_node, rrc_connection_next_hop(ctx));
     return 0;
 }
 
@@ -2631,7 +3555,7 @@ void rrc_cleanup_receive_resources(uint8_t source_node)
 void print_rrc_fsm_stats(void)
 {
     printf("\n=== RRC FSM Statistics ===\n");
-    printf("Current state: %s\n", rrc_state_to_string(current_rrc_state));
+    printf("Node state: %s\n", rrc_state_to_string(current_rrc_state));
     printf("State transitions: %u\n", rrc_fsm_stats.state_transitions);
     printf("Connection setups: %u\n", rrc_fsm_stats.connection_setups);
     printf("Connection releases: %u\n", rrc_fsm_stats.connection_releases);
@@ -2639,16 +3563,52 @@ void print_rrc_fsm_stats(void)
     printf("Setup timeouts: %u\n", rrc_fsm_stats.setup_timeouts);
     printf("Inactivity releases: %u\n", rrc_fsm_stats.inactivity_releases);
     printf("Power events: %u on, %u off\n", rrc_fsm_stats.power_on_events, rrc_fsm_stats.power_off_events);
+    printf("Rejected events: %u, Event queue overflows: %u\n",
+           rrc_fsm_stats.rejected_events, rrc_fsm_stats.queue_overflows);
+
+    printf("\nEvents:\n");
+    for (int e = 0; e < RRC_EVENT_COUNT; e++)
+    {
+        if (rrc_fsm_stats.events[e])
+            printf("  %-20s %u\n", rrc_fsm_event_to_string((RRC_FsmEvent)e), rrc_fsm_stats.events[e]);
+    }
+
+    printf("\nTransitions:\n");
+    for (int from = 0; from < RRC_FSM_STATE_COUNT; from++)
+    {
+        for (int to = 0; to < RRC_FSM_STATE_COUNT; to++)
+        {
+            if (rrc_fsm_stats.transition_counts[from][to])
+                printf("  %-16s → %-16s %u\n", rrc_state_to_string((RRC_SystemState)from),
+                       rrc_state_to_string((RRC_SystemState)to), rrc_fsm_stats.transition_counts[from][to]);
+        }
+    }
+
+    printf("\nTime in state (log2 ms buckets: <1, <2, <4, ...):\n");
+    for (int state = 0; state < RRC_FSM_STATE_COUNT; state++)
+    {
+        uint32_t total = 0;
+        for (int b = 0; b < RRC_FSM_HIST_BUCKETS; b++)
+            total += rrc_fsm_stats.time_in_state[state][b];
+        if (total == 0)
+            continue;
+
+        printf("  %-16s", rrc_state_to_string((RRC_SystemState)state));
+        for (int b = 0; b < RRC_FSM_HIST_BUCKETS; b++)
+            printf(" %u", rrc_fsm_stats.time_in_state[state][b]);
+        printf("\n");
+    }
 
     printf("\nActive connections:\n");
     int active_count = 0;
     for (int i = 0; i < RRC_CONNECTION_POOL_SIZE; i++)
     {
-        if (connection_pool[i].active)
+        if (connection_hot.active[i])
         {
-            printf("  Slot %d: Node %u → %u (state: %s)\n", i,
-                   connection_pool[i].dest_node_id, connection_pool[i].next_hop_id,
-                   rrc_state_to_string(connection_pool[i].connection_state));
+            printf("  Slot %d: Node %u → %u (state: %s, %u queued events)\n", i,
+                   connection_pool[i].dest_node_id, connection_hot.next_hop_id[i],
+                   rrc_state_to_string(connection_pool[i].connection_state),
+                   connection_pool[i].event_count);
             active_count++;
         }
     }
@@ -2680,6 +3640,13 @@ void init_message_pool(void)
     // Initialize Relay queue
     init_relay_queue();
 
+    // Initialize per-class deadlines and CoDel state
+    init_aqm();
+
+    // Initialize multicast fan-out engine
+    init_mcast_engine();
+    init_reconfig_engine();
+
     printf("RRC: Message pool initialized (%d messages)\n", RRC_MESSAGE_POOL_SIZE);
 }
 
@@ -2783,15 +3750,16 @@ void update_phy_metrics_for_node(uint8_t node_id)
     bool link_active = ipc_phy_is_link_active(node_id);
     uint32_t packet_count = ipc_phy_get_packet_count(node_id);
 
-    // Use MANET neighbor state instead of separate PHY array
+    // Metrics are indexed by node ID; the neighbor entry tracks liveness
     NeighborState *neighbor = rrc_create_neighbor_state(node_id);
     if (neighbor)
     {
-        neighbor->phy.rssi_dbm = rssi;
-        neighbor->phy.snr_db = snr;
-        neighbor->phy.per_percent = per;
-        neighbor->phy.packet_count = packet_count;
-        neighbor->phy.last_update_time = (uint32_t)time(NULL);
+        phy_metrics.rssi_dbm[node_id] = rssi;
+        phy_metrics.snr_db[node_id] = snr;
+        phy_metrics.per_percent[node_id] = per;
+        phy_metrics.packet_count[node_id] = packet_count;
+        phy_metrics.last_update_time[node_id] = (uint32_t)time(NULL);
+        phy_metrics.link_active[node_id] = link_active;
         neighbor->active = link_active;
 
         rrc_stats.phy_metrics_updates++;
@@ -2813,18 +3781,17 @@ void update_phy_metrics_for_node(uint8_t node_id)
 // Get link quality for routing decisions
 bool is_link_quality_good(uint8_t node_id)
 {
-    NeighborState *neighbor = rrc_get_neighbor_state(node_id);
-    if (!neighbor)
+    if (phy_metrics.last_update_time[node_id] == 0)
         return false; // No neighbor data
 
-    uint32_t age = (uint32_t)time(NULL) - neighbor->phy.last_update_time;
+    uint32_t age = (uint32_t)time(NULL) - phy_metrics.last_update_time[node_id];
     if (age > LINK_TIMEOUT_SECONDS)
         return false; // Stale data
 
-    return (neighbor->active &&
-            neighbor->phy.per_percent <= PER_POOR_THRESHOLD_PERCENT &&
-            neighbor->phy.rssi_dbm >= RSSI_POOR_THRESHOLD_DBM &&
-            neighbor->phy.snr_db >= SNR_POOR_THRESHOLD_DB);
+    return (phy_metrics.link_active[node_id] &&
+            phy_metrics.per_percent[node_id] <= PER_POOR_THRESHOLD_PERCENT &&
+            phy_metrics.rssi_dbm[node_id] >= RSSI_POOR_THRESHOLD_DBM &&
+            phy_metrics.snr_db[node_id] >= SNR_POOR_THRESHOLD_DB);
 }
 
 // ============================================================================
@@ -2886,225 +3853,1824 @@ bool enqueue_olsr_nc_packet(uint8_t *olsr_payload, size_t payload_len, uint8_t s
                piggyback_data->sourceNodeID, piggyback_data->myNCSlot, piggyback_data->ttl);
     }
 
-    // Enqueue to NC queue
-    enqueue(&rrc_olsr_nc_queue, olsr_frame);
-    olsr_nc_stats.olsr_packets_enqueued++;
+    // Enqueue to NC queue
+    enqueue(&rrc_olsr_nc_queue, olsr_frame);
+    olsr_nc_stats.olsr_packets_enqueued++;
+
+    printf("RRC: OLSR packet from node %u enqueued to NC queue (slot %u, size %u)\n",
+           source_node, assigned_slot, (unsigned int)copy_size);
+
+    return true;
+}
+
+// API function for TDMA team to dequeue from NC queue
+struct frame rrc_tdma_dequeue_nc_packet(uint8_t target_slot)
+{
+    struct frame empty_frame = {0};
+
+    if (is_empty(&rrc_olsr_nc_queue))
+    {
+        printf("RRC: TDMA requested NC packet for slot %u, but NC queue is empty\n", target_slot);
+        return empty_frame;
+    }
+
+    // Simple dequeue - returns next available frame
+    // For slot-specific dequeue, we'd need to search the queue
+    struct frame nc_frame = dequeue(&rrc_olsr_nc_queue);
+    olsr_nc_stats.olsr_packets_dequeued++;
+    olsr_nc_stats.tdma_nc_requests++;
+
+    printf("RRC: TDMA dequeued NC packet for slot %u (assigned slot was %d)\n",
+           target_slot, nc_frame.TTL);
+
+    return nc_frame;
+}
+
+// Check if NC queue has packets for specific slot
+bool rrc_has_nc_packet_for_slot(uint8_t target_slot)
+{
+    (void)target_slot; // Suppress unused parameter warning
+
+    if (is_empty(&rrc_olsr_nc_queue))
+    {
+        return false;
+    }
+
+    // Simple check - just return if queue has any packets
+    // For slot-specific check, we'd need to peek into the queue
+    return true;
+}
+
+// Get NC queue statistics
+void print_olsr_nc_stats(void)
+{
+    printf("\n=== OLSR NC Queue Statistics ===\n");
+    printf("Packets received: %u\n", olsr_nc_stats.olsr_packets_received);
+    printf("Packets enqueued: %u\n", olsr_nc_stats.olsr_packets_enqueued);
+    printf("Packets dequeued: %u\n", olsr_nc_stats.olsr_packets_dequeued);
+    printf("Queue full drops: %u\n", olsr_nc_stats.olsr_queue_full_drops);
+    printf("TDMA NC requests: %u\n", olsr_nc_stats.tdma_nc_requests);
+    printf("Queue status: %s\n", is_empty(&rrc_olsr_nc_queue) ? "EMPTY" : "HAS_PACKETS");
+    printf("===============================\n\n");
+}
+
+// ============================================================================
+// ACTIVE QUEUE MANAGEMENT
+// ============================================================================
+//
+// Every frame is stamped when it enters one of the RRC-fed queues. On the
+// way out, frames whose class deadline has passed are dropped at the head
+// instead of being transmitted late, and bulk classes additionally run
+// CoDel on the sojourn time so a standing queue drains back to the target
+// delay. queue.c queues are linear (full once back reaches the end, even
+// after frames left the front), so pushes go through rrc_queue_push(),
+// which slides the live frames back to index 0 first.
+
+uint32_t rrc_now_ms(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)(ts.tv_sec * 1000u + ts.tv_nsec / 1000000u);
+}
+
+void init_aqm(void)
+{
+    memset(aqm_codel, 0, sizeof(aqm_codel));
+    memset(aqm_stats, 0, sizeof(aqm_stats));
+    printf("RRC: AQM initialized (CoDel target %dms, interval %dms)\n",
+           RRC_CODEL_TARGET_MS, RRC_CODEL_INTERVAL_MS);
+}
+
+void rrc_aqm_set_deadline(RRC_AqmClass cls, uint32_t deadline_ms)
+{
+    if (cls >= RRC_AQM_CLASS_COUNT)
+        return;
+    aqm_config[cls].deadline_ms = deadline_ms;
+    printf("RRC: AQM deadline for %s set to %ums\n", aqm_config[cls].name, deadline_ms);
+}
+
+static struct queue *rrc_aqm_queue(RRC_AqmClass cls)
+{
+    switch (cls)
+    {
+    case RRC_AQM_CLASS_ANALOG_VOICE:
+        return &analog_voice_queue;
+    case RRC_AQM_CLASS_DIGITAL_VOICE:
+        return &data_from_l3_queue[0];
+    case RRC_AQM_CLASS_VIDEO:
+        return &data_from_l3_queue[1];
+    case RRC_AQM_CLASS_FILE:
+        return &data_from_l3_queue[2];
+    case RRC_AQM_CLASS_SMS:
+        return &data_from_l3_queue[3];
+    case RRC_AQM_CLASS_RELAY:
+    default:
+        return &rrc_relay_queue;
+    }
+}
+
+// Traffic class of a frame, used for its deadline
+static RRC_AqmClass rrc_aqm_frame_class(const struct frame *frame)
+{
+    switch (frame->priority)
+    {
+    case PRIORITY_ANALOG_VOICE_PTT:
+        return RRC_AQM_CLASS_ANALOG_VOICE;
+    case PRIORITY_DIGITAL_VOICE:
+        return RRC_AQM_CLASS_DIGITAL_VOICE;
+    case PRIORITY_DATA_1:
+        return RRC_AQM_CLASS_VIDEO;
+    case PRIORITY_DATA_2:
+        return RRC_AQM_CLASS_FILE;
+    default:
+        return RRC_AQM_CLASS_SMS;
+    }
+}
+
+static bool rrc_aqm_frame_expired(const struct frame *frame, uint32_t now)
+{
+    uint32_t deadline = aqm_config[rrc_aqm_frame_class(frame)].deadline_ms;
+    return deadline != 0 && now - frame->enqueue_time_ms > deadline;
+}
+
+// Move the live frames of a queue.c queue to the start of its array
+static void rrc_queue_compact(struct queue *q)
+{
+    if (is_empty(q))
+    {
+        q->front = -1;
+        q->back = -1;
+        return;
+    }
+    if (q->front == 0)
+        return;
+
+    int count = q->back - q->front + 1;
+    memmove(&q->item[0], &q->item[q->front], (size_t)count * sizeof(q->item[0]));
+    q->front = 0;
+    q->back = count - 1;
+}
+
+/**
+ * Append to a queue.c queue, reclaiming slots freed at the front.
+ * @return false if all QUEUE_SIZE slots hold frames
+ */
+static bool rrc_queue_push(struct queue *q, const struct frame *frame)
+{
+    if (is_full(q))
+        rrc_queue_compact(q);
+    if (is_full(q))
+        return false;
+
+    enqueue(q, *frame);
+    return true;
+}
+
+// Drop expired frames sitting at the head of a queue
+static void rrc_aqm_purge_expired(RRC_AqmClass cls, uint32_t now)
+{
+    struct queue *q = rrc_aqm_queue(cls);
+
+    while (!is_empty(q) && rrc_aqm_frame_expired(&q->item[q->front], now))
+    {
+        dequeue(q);
+        aqm_stats[cls].deadline_drops++;
+    }
+}
+
+/**
+ * Stamp and enqueue a frame. When the queue is full, expired frames are
+ * purged first; voice then evicts its oldest frame (fresh audio is worth
+ * more than old audio), other classes reject the new frame.
+ * @return true if the frame was queued
+ */
+bool rrc_aqm_enqueue(RRC_AqmClass cls, struct frame *frame)
+{
+    if (!frame || cls >= RRC_AQM_CLASS_COUNT)
+        return false;
+
+    struct queue *q = rrc_aqm_queue(cls);
+    uint32_t now = rrc_now_ms();
+
+    if (is_full(q))
+    {
+        rrc_queue_compact(q);
+        if (is_full(q))
+            rrc_aqm_purge_expired(cls, now);
+
+        if (is_full(q) && (cls == RRC_AQM_CLASS_ANALOG_VOICE || cls == RRC_AQM_CLASS_DIGITAL_VOICE))
+        {
+            dequeue(q);
+            aqm_stats[cls].head_drops++;
+        }
+    }
+
+    frame->enqueue_time_ms = now;
+    if (!rrc_queue_push(q, frame))
+    {
+        aqm_stats[cls].overflow_drops++;
+        return false;
+    }
+    aqm_stats[cls].enqueued++;
+    return true;
+}
+
+static uint32_t rrc_isqrt(uint32_t value)
+{
+    uint32_t root = 0;
+    uint32_t bit = 1u << 30;
+
+    while (bit > value)
+        bit >>= 2;
+    while (bit != 0)
+    {
+        if (value >= root + bit)
+        {
+            value -= root + bit;
+            root = (root >> 1) + bit;
+        }
+        else
+        {
+            root >>= 1;
+        }
+        bit >>= 2;
+    }
+    return root;
+}
+
+static uint32_t rrc_codel_control_law(uint32_t t, uint32_t count)
+{
+    uint32_t root = rrc_isqrt(count);
+    return t + RRC_CODEL_INTERVAL_MS / (root ? root : 1);
+}
+
+// CoDel "ok to drop" test for the frame just taken off the head
+static bool rrc_codel_should_drop(RRC_CodelState *st, uint32_t sojourn, bool queue_empty, uint32_t now)
+{
+    if (sojourn < RRC_CODEL_TARGET_MS || queue_empty)
+    {
+        st->first_above_time = 0;
+        return false;
+    }
+
+    if (st->first_above_time == 0)
+    {
+        st->first_above_time = now + RRC_CODEL_INTERVAL_MS;
+        return false;
+    }
+
+    return (int32_t)(now - st->first_above_time) >= 0;
+}
+
+// Take item i out of a queue.c queue, keeping the rest in order
+static struct frame rrc_queue_remove_at(struct queue *q, int i)
+{
+    if (i == q->front)
+        return dequeue(q);
+
+    struct frame removed = q->item[i];
+    memmove(&q->item[i], &q->item[i + 1], (size_t)(q->back - i) * sizeof(q->item[0]));
+    q->back--;
+    return removed;
+}
+
+// Pop the oldest frame toward next_hop (any with RRC_AQM_ANY_HOP),
+// dropping anything past its deadline on the way
+static bool rrc_aqm_pop_live(RRC_AqmClass cls, int next_hop, uint32_t now, struct frame *out)
+{
+    struct queue *q = rrc_aqm_queue(cls);
+
+    if (is_empty(q))
+        return false;
+
+    int i = q->front;
+    while (!is_empty(q) && i <= q->back)
+    {
+        if (next_hop != RRC_AQM_ANY_HOP && q->item[i].next_hop_add != next_hop)
+        {
+            i++;
+            continue;
+        }
+        bool head = (i == q->front);
+        *out = rrc_queue_remove_at(q, i);
+        if (head)
+            i = q->front;
+        if (!rrc_aqm_frame_expired(out, now))
+            return true;
+        aqm_stats[cls].deadline_drops++;
+    }
+    return false;
+}
+
+/**
+ * Dequeue the next frame worth transmitting from a class queue.
+ * @return true if *out holds a frame
+ */
+bool rrc_aqm_dequeue(RRC_AqmClass cls, struct frame *out)
+{
+    return rrc_aqm_dequeue_for_hop(cls, RRC_AQM_ANY_HOP, out);
+}
+
+/**
+ * Dequeue the oldest frame worth transmitting toward next_hop. Frames to
+ * other next hops keep their place; CoDel runs on the class as a whole.
+ * @return true if *out holds a frame
+ */
+bool rrc_aqm_dequeue_for_hop(RRC_AqmClass cls, int next_hop, struct frame *out)
+{
+    if (!out || cls >= RRC_AQM_CLASS_COUNT)
+        return false;
+
+    struct queue *q = rrc_aqm_queue(cls);
+    uint32_t now = rrc_now_ms();
+
+    if (!rrc_aqm_pop_live(cls, next_hop, now, out))
+    {
+        aqm_codel[cls].dropping = false;
+        return false;
+    }
+
+    if (aqm_config[cls].codel)
+    {
+        RRC_CodelState *st = &aqm_codel[cls];
+        bool ok_to_drop = rrc_codel_should_drop(st, now - out->enqueue_time_ms, is_empty(q), now);
+
+        if (st->dropping)
+        {
+            if (!ok_to_drop)
+            {
+                st->dropping = false;
+            }
+            else
+            {
+                while (st->dropping && (int32_t)(now - st->drop_next) >= 0)
+                {
+                    aqm_stats[cls].codel_drops++;
+                    st->count++;
+                    if (!rrc_aqm_pop_live(cls, next_hop, now, out))
+                    {
+                        st->dropping = false;
+                        return false;
+                    }
+                    if (!rrc_codel_should_drop(st, now - out->enqueue_time_ms, is_empty(q), now))
+                        st->dropping = false;
+                    else
+                        st->drop_next = rrc_codel_control_law(st->drop_next, st->count);
+                }
+            }
+        }
+        else if (ok_to_drop)
+        {
+            aqm_stats[cls].codel_drops++;
+            if (!rrc_aqm_pop_live(cls, next_hop, now, out))
+                return false;
+
+            st->dropping = true;
+            // Resume near the previous drop rate if we were dropping recently
+            uint32_t delta = st->count - st->last_count;
+            st->count = (delta > 1 && now - st->drop_next < 16 * RRC_CODEL_INTERVAL_MS) ? delta : 1;
+            st->drop_next = rrc_codel_control_law(now, st->count);
+            st->last_count = st->count;
+        }
+    }
+
+    uint32_t sojourn = now - out->enqueue_time_ms;
+    aqm_stats[cls].dequeued++;
+    aqm_stats[cls].total_sojourn_ms += sojourn;
+    if (sojourn > aqm_stats[cls].max_sojourn_ms)
+        aqm_stats[cls].max_sojourn_ms = sojourn;
+    return true;
+}
+
+// API functions for TDMA team: AQM-aware access to the data queues.
+// The pull variants report whether a frame survived the deadline/CoDel
+// checks; the dequeue variants return an all-zero frame otherwise.
+bool rrc_tdma_pull_data_packet(int priority, struct frame *out)
+{
+    if (priority < 0 || priority >= NUM_PRIORITY)
+        return false;
+    return rrc_aqm_dequeue((RRC_AqmClass)(RRC_AQM_CLASS_DIGITAL_VOICE + priority), out);
+}
+
+bool rrc_tdma_pull_analog_voice_packet(struct frame *out)
+{
+    return rrc_aqm_dequeue(RRC_AQM_CLASS_ANALOG_VOICE, out);
+}
+
+struct frame rrc_tdma_dequeue_data_packet(int priority)
+{
+    struct frame data_frame = {0};
+    if (!rrc_tdma_pull_data_packet(priority, &data_frame))
+        memset(&data_frame, 0, sizeof(data_frame));
+    return data_frame;
+}
+
+struct frame rrc_tdma_dequeue_analog_voice_packet(void)
+{
+    struct frame voice_frame = {0};
+    if (!rrc_tdma_pull_analog_voice_packet(&voice_frame))
+        memset(&voice_frame, 0, sizeof(voice_frame));
+    return voice_frame;
+}
+
+void print_aqm_stats(void)
+{
+    printf("\n=== AQM Statistics ===\n");
+    printf("%-14s %8s %8s %8s %8s %8s %8s %10s %10s\n", "Class", "Enq", "Deq", "Deadline",
+           "CoDel", "Overflow", "HeadDrop", "AvgSoj(ms)", "MaxSoj(ms)");
+    for (int i = 0; i < RRC_AQM_CLASS_COUNT; i++)
+    {
+        uint32_t avg = aqm_stats[i].dequeued ? (uint32_t)(aqm_stats[i].total_sojourn_ms / aqm_stats[i].dequeued) : 0;
+        printf("%-14s %8u %8u %8u %8u %8u %8u %10u %10u\n", aqm_config[i].name,
+               aqm_stats[i].enqueued, aqm_stats[i].dequeued, aqm_stats[i].deadline_drops,
+               aqm_stats[i].codel_drops, aqm_stats[i].overflow_drops, aqm_stats[i].head_drops,
+               avg, aqm_stats[i].max_sojourn_ms);
+    }
+    printf("======================\n\n");
+}
+
+// ============================================================================
+// MAKE-BEFORE-BREAK RECONFIGURATION
+// ============================================================================
+//
+// On a route change the connection enters RECONFIGURATION. A slot toward
+// the candidate next hop is reserved right away, but the old next hop keeps
+// its slots and queued frames keep flowing. New traffic is held in a
+// short, bounded buffer. Once the new path is confirmed (OLSR still routes
+// over it and its PHY link is good), three things happen in order: frames
+// already queued for the destination are re-targeted in place, the hold
+// buffer is flushed behind them, and the old next hop's slots are released
+// if nothing else uses it. If the new path is never confirmed, the
+// connection falls back to the old hop while that link is still good, or
+// is released otherwise.
+
+void init_reconfig_engine(void)
+{
+    memset(reconfig_hold_pool, 0, sizeof(reconfig_hold_pool));
+    memset(&reconfig_stats, 0, sizeof(reconfig_stats));
+    printf("RRC: Reconfiguration engine initialized (hold %d frames, %d per connection, %dms max)\n",
+           RRC_RECONFIG_HOLD_POOL_SIZE, RRC_RECONFIG_HOLD_PER_CONN, RRC_RECONFIG_MAX_MS);
+}
+
+// Point queued frames for dest_node at the new next hop, in place
+static int rrc_reconfig_retarget_queued(uint8_t dest_node, uint8_t old_hop, uint8_t new_hop)
+{
+    int retargeted = 0;
+
+    for (int cls = 0; cls < RRC_AQM_CLASS_COUNT; cls++)
+    {
+        struct queue *q = rrc_aqm_queue((RRC_AqmClass)cls);
+        if (q->front < 0)
+            continue;
+
+        for (int i = q->front; i <= q->back; i++)
+        {
+            if (q->item[i].dest_add == dest_node && q->item[i].next_hop_add == old_hop)
+            {
+                q->item[i].next_hop_add = new_hop;
+                retargeted++;
+            }
+        }
+    }
+    return retargeted;
+}
+
+// Whether any connection, reconfiguration candidate, queued frame or
+// queued multicast copy still needs slots toward hop
+static bool rrc_reconfig_hop_in_use(uint8_t hop)
+{
+    for (int i = 0; i < RRC_CONNECTION_POOL_SIZE; i++)
+    {
+        if (!connection_hot.active[i])
+            continue;
+        if (connection_hot.next_hop_id[i] == hop)
+            return true;
+        if (connection_pool[i].connection_state == RRC_STATE_RECONFIGURATION &&
+            connection_pool[i].reconfig_new_hop == hop)
+            return true;
+    }
+
+    for (int i = 0; i < mcast_tx_count; i++)
+    {
+        if (mcast_tx_ring[(mcast_tx_head + i) % RRC_MCAST_TX_QUEUE_SIZE].next_hop == hop)
+            return true;
+    }
+
+    for (int cls = 0; cls < RRC_AQM_CLASS_COUNT; cls++)
+    {
+        struct queue *q = rrc_aqm_queue((RRC_AqmClass)cls);
+        if (q->front < 0)
+            continue;
+        for (int i = q->front; i <= q->back; i++)
+        {
+            if (q->item[i].next_hop_add == hop)
+                return true;
+        }
+    }
+    return false;
+}
+
+// Break: release DU/GU slots held toward hop once nothing depends on them
+static void rrc_reconfig_release_hop_slots(uint8_t hop)
+{
+    if (hop == 0 || rrc_reconfig_hop_in_use(hop))
+    {
+        reconfig_stats.old_slots_kept_shared++;
+        return;
+    }
+
+    for (uint8_t slot = 0; slot <= 7; slot++)
+    {
+        if (tdma_slot_table[slot].assigned_node == hop)
+        {
+            rrc_release_slot(hop, slot);
+            reconfig_stats.old_slots_released++;
+        }
+    }
+}
+
+// Make: reserve a slot toward the candidate before the old path is given up.
+// A candidate superseded by a later route change gives its slot back first.
+static void rrc_reconfig_reserve_candidate(RRC_ConnectionContext *ctx, uint8_t hop)
+{
+    uint8_t previous = ctx->reconfig_new_hop;
+
+    ctx->reconfig_new_hop = hop;
+    if (previous != 0 && previous != hop && previous != ctx->reconfig_old_hop)
+        rrc_reconfig_release_hop_slots(previous);
+    if (hop == 0 || hop == ctx->reconfig_old_hop || ctx->qos_priority == PRIORITY_ANALOG_VOICE_PTT)
+        return;
+
+    if (rrc_allocate_du_gu_slot(hop, ctx->qos_priority) == 255)
+        printf("RRC: RECONFIG - No slot yet toward candidate next hop %u\n", hop);
+}
+
+// Held messages are only reported to L7 once they are actually lost
+static void rrc_reconfig_notify_lost(uint8_t dest_node, int lost, const char *why)
+{
+    char reason[96];
+
+    if (lost <= 0)
+        return;
+    snprintf(reason, sizeof(reason), "%d held message(s) %s during reconfiguration", lost, why);
+    notify_application_of_failure(dest_node, reason);
+}
+
+static void rrc_reconfig_drop_held(RRC_ConnectionContext *ctx)
+{
+    int dropped = 0;
+
+    while (ctx->hold_count > 0)
+    {
+        reconfig_hold_pool[ctx->hold_slots[ctx->hold_head]].in_use = false;
+        ctx->hold_head = (uint8_t)((ctx->hold_head + 1) % RRC_RECONFIG_HOLD_PER_CONN);
+        ctx->hold_count--;
+        reconfig_stats.hold_dropped++;
+        dropped++;
+    }
+    rrc_reconfig_notify_lost(ctx->dest_node_id, dropped, "dropped");
+}
+
+// CONNECTED → RECONFIGURATION: remember both paths and start confirming
+void rrc_reconfig_begin(RRC_ConnectionContext *ctx, uint8_t new_next_hop)
+{
+    ctx->reconfig_old_hop = rrc_connection_next_hop(ctx);
+    ctx->reconfig_new_hop = 0; // Left over from an earlier reconfiguration
+    ctx->reconfig_start_ms = rrc_now_ms();
+    rrc_reconfig_reserve_candidate(ctx, new_next_hop);
+
+    rrc_timer_arm(RRC_TIMER_RECONFIG_HOLD, ctx->dest_node_id, RRC_RECONFIG_CONFIRM_MS);
+    reconfig_stats.started++;
+}
+
+// RECONFIGURATION → CONNECTED: switch to new_next_hop and drain held traffic
+void rrc_reconfig_commit(RRC_ConnectionContext *ctx, uint8_t new_next_hop)
+{
+    uint8_t dest_node = ctx->dest_node_id;
+    uint8_t old_hop = ctx->reconfig_old_hop;
+    uint8_t candidate = ctx->reconfig_new_hop;
+
+    if (new_next_hop != candidate)
+        rrc_reconfig_reserve_candidate(ctx, new_next_hop);
+
+    rrc_connection_set_next_hop(ctx, new_next_hop);
+    rrc_timer_cancel(RRC_TIMER_RECONFIG_HOLD, dest_node);
+
+    int retargeted = 0;
+    if (old_hop != new_next_hop)
+        retargeted = rrc_reconfig_retarget_queued(dest_node, old_hop, new_next_hop);
+    reconfig_stats.frames_retargeted += (uint32_t)retargeted;
+
+    // Held frames go out behind the re-targeted ones, unless already past their deadline
+    uint32_t now = rrc_now_ms();
+    int flushed = 0;
+    int expired = 0;
+    int dropped = 0;
+    while (ctx->hold_count > 0)
+    {
+        RRC_HeldFrame *held = &reconfig_hold_pool[ctx->hold_slots[ctx->hold_head]];
+        ctx->hold_head = (uint8_t)((ctx->hold_head + 1) % RRC_RECONFIG_HOLD_PER_CONN);
+        ctx->hold_count--;
+        held->in_use = false;
+
+        RRC_AqmClass cls = rrc_aqm_frame_class(&held->frame);
+        uint32_t deadline = aqm_config[cls].deadline_ms;
+        if (deadline && (now - held->held_at_ms) > deadline)
+        {
+            reconfig_stats.hold_expired++;
+            expired++;
+            continue;
+        }
+
+        held->frame.next_hop_add = new_next_hop;
+        bool queued;
+        if (held->frame.priority == PRIORITY_RX_RELAY)
+            queued = rrc_queue_push(&rx_queue, &held->frame);
+        else
+            queued = rrc_aqm_enqueue(cls, &held->frame);
+
+        if (queued)
+        {
+            flushed++;
+            rrc_stats.messages_enqueued_total++;
+        }
+        else
+        {
+            reconfig_stats.hold_flush_drops++;
+            dropped++;
+            printf("RRC: RECONFIG - Queue full, held frame for node %u dropped on flush\n", dest_node);
+        }
+    }
+    reconfig_stats.frames_flushed += (uint32_t)flushed;
+    rrc_reconfig_notify_lost(dest_node, expired, "expired");
+    rrc_reconfig_notify_lost(dest_node, dropped, "dropped (queue full)");
+
+    // Break only now that the new path carries the traffic
+    if (old_hop != new_next_hop)
+        rrc_reconfig_release_hop_slots(old_hop);
+    if (candidate != new_next_hop && candidate != old_hop)
+        rrc_reconfig_release_hop_slots(candidate);
+
+    printf("RRC: RECONFIG - Node %u switched %u → %u after %ums (%d re-targeted, %d flushed)\n",
+           dest_node, old_hop, new_next_hop, now - ctx->reconfig_start_ms, retargeted, flushed);
+}
+
+// Connection released mid-reconfiguration: held traffic cannot be delivered,
+// and the slot reserved toward the candidate is no longer needed
+void rrc_reconfig_abort(RRC_ConnectionContext *ctx)
+{
+    rrc_timer_cancel(RRC_TIMER_RECONFIG_HOLD, ctx->dest_node_id);
+    rrc_reconfig_drop_held(ctx);
+
+    if (ctx->connection_state != RRC_STATE_RECONFIGURATION)
+        return;
+
+    uint8_t candidate = ctx->reconfig_new_hop;
+    ctx->reconfig_new_hop = 0;
+    if (candidate != ctx->reconfig_old_hop)
+        rrc_reconfig_release_hop_slots(candidate);
+}
+
+// Confirm hop as the new path if OLSR routes over it and its link is good
+bool rrc_reconfig_try_confirm(RRC_ConnectionContext *ctx, uint8_t hop)
+{
+    if (hop == 0 || !is_link_quality_good(hop))
+        return false;
+
+    if (rrc_handle_reconfig_success(ctx->dest_node_id, hop) != 0)
+        return false;
+
+    reconfig_stats.confirmed++;
+    return true;
+}
+
+// Hold an application message while its connection reconfigures
+int rrc_reconfig_hold_message(RRC_ConnectionContext *ctx, ApplicationMessage *app_msg)
+{
+    if (ctx->hold_count >= RRC_RECONFIG_HOLD_PER_CONN)
+    {
+        reconfig_stats.hold_overflow_drops++;
+        printf("RRC: RECONFIG - Hold buffer full for node %u, dropping message\n", ctx->dest_node_id);
+        rrc_reconfig_notify_lost(ctx->dest_node_id, 1, "dropped (hold buffer full)");
+        return -1;
+    }
+
+    int index = -1;
+    for (int i = 0; i < RRC_RECONFIG_HOLD_POOL_SIZE; i++)
+    {
+        if (!reconfig_hold_pool[i].in_use)
+        {
+            index = i;
+            break;
+        }
+    }
+    if (index < 0)
+    {
+        reconfig_stats.hold_overflow_drops++;
+        printf("RRC: RECONFIG - Hold pool exhausted, dropping message for node %u\n", ctx->dest_node_id);
+        rrc_reconfig_notify_lost(ctx->dest_node_id, 1, "dropped (hold pool exhausted)");
+        return -1;
+    }
+
+    RRC_HeldFrame *held = &reconfig_hold_pool[index];
+    held->frame = create_frame_from_rrc(app_msg, ctx->reconfig_new_hop);
+    held->held_at_ms = rrc_now_ms();
+    held->in_use = true;
+
+    ctx->hold_slots[(ctx->hold_head + ctx->hold_count) % RRC_RECONFIG_HOLD_PER_CONN] = (uint8_t)index;
+    ctx->hold_count++;
+    reconfig_stats.frames_held++;
+
+    printf("RRC: RECONFIG - Holding message for node %u (%u held)\n", ctx->dest_node_id, ctx->hold_count);
+    return 0;
+}
+
+// Hold timer: re-check the route, fall back or give up after RRC_RECONFIG_MAX_MS.
+// The route comes from the cache that OLSR route updates keep current; the
+// timer never waits on OLSR.
+void rrc_reconfig_poll(uint8_t dest_node)
+{
+    RRC_ConnectionContext *ctx = rrc_get_connection_context(dest_node);
+    if (!ctx || ctx->connection_state != RRC_STATE_RECONFIGURATION)
+        return;
+
+    uint8_t hop = 0;
+    if (!rrc_route_cache_lookup(dest_node, &hop))
+        ipc_olsr_request_route(dest_node);
+    if (hop != 0)
+        update_phy_metrics_for_node(hop);
+    if (hop != 0 && hop != ctx->reconfig_new_hop)
+        rrc_reconfig_reserve_candidate(ctx, hop);
+    if (rrc_reconfig_try_confirm(ctx, hop))
+        return;
+
+    if (rrc_now_ms() - ctx->reconfig_start_ms < RRC_RECONFIG_MAX_MS)
+    {
+        rrc_timer_arm(RRC_TIMER_RECONFIG_HOLD, dest_node, RRC_RECONFIG_CONFIRM_MS);
+        return;
+    }
+
+    // New path never confirmed: stay on the old one if it still works
+    uint8_t old_hop = ctx->reconfig_old_hop;
+    if (old_hop != 0 && is_link_quality_good(old_hop) &&
+        rrc_handle_reconfig_success(dest_node, old_hop) == 0)
+    {
+        reconfig_stats.fallbacks++;
+        printf("RRC: RECONFIG - Node %u kept old next hop %u\n", dest_node, old_hop);
+        return;
+    }
+
+    reconfig_stats.failed++;
+    printf("RRC: RECONFIG - No usable path to node %u, releasing connection\n", dest_node);
+    rrc_handle_route_lost(dest_node);
+}
+
+void print_reconfig_stats(void)
+{
+    printf("\n=== Reconfiguration Statistics ===\n");
+    printf("Started: %u, Confirmed: %u, Fallbacks: %u, Failed: %u\n",
+           reconfig_stats.started, reconfig_stats.confirmed, reconfig_stats.fallbacks,
+           reconfig_stats.failed);
+    printf("Frames re-targeted: %u, held: %u, flushed: %u\n",
+           reconfig_stats.frames_retargeted, reconfig_stats.frames_held, reconfig_stats.frames_flushed);
+    printf("Hold drops: %u overflow, %u past deadline, %u on release, %u queue full on flush\n",
+           reconfig_stats.hold_overflow_drops, reconfig_stats.hold_expired, reconfig_stats.hold_dropped,
+           reconfig_stats.hold_flush_drops);
+    printf("Old slots released: %u (kept for shared next hop: %u)\n",
+           reconfig_stats.old_slots_released, reconfig_stats.old_slots_kept_shared);
+    printf("==================================\n\n");
+}
+
+// ============================================================================
+// DUPLICATE DETECTION CACHE
+// ============================================================================
+//
+// One cache (rrc_dup_cache.h) shared by the uplink and relay paths, aged
+// on wall-clock seconds.
+
+void init_dup_cache(void)
+{
+    rrc_dup_cache_clear(&dup_cache);
+    printf("RRC: Duplicate cache initialized (%d entries, %ds hold time)\n",
+           RRC_DUP_CACHE_SIZE, RRC_DUP_HOLD_TIME_SEC);
+}
+
+bool rrc_dup_cache_test_and_set(uint8_t source, uint16_t seq, uint8_t flag)
+{
+    return rrc_dup_cache_test_and_set_at(&dup_cache, source, seq, flag, (uint32_t)time(NULL));
+}
+
+bool rrc_dup_cache_test(uint8_t source, uint16_t seq, uint8_t flag)
+{
+    return rrc_dup_cache_test_at(&dup_cache, source, seq, flag, (uint32_t)time(NULL));
+}
+
+void rrc_dup_cache_set(uint8_t source, uint16_t seq, uint8_t flag)
+{
+    rrc_dup_cache_set_at(&dup_cache, source, seq, flag, (uint32_t)time(NULL));
+}
+
+// Next sequence number for a locally originated frame (skips 0 on wrap)
+uint16_t rrc_next_tx_sequence(void)
+{
+    if (++rrc_tx_sequence == 0)
+        rrc_tx_sequence = 1;
+    return rrc_tx_sequence;
+}
+
+// ============================================================================
+// RELAY QUEUE MANAGEMENT FUNCTIONS
+// ============================================================================
+
+// Initialize Relay queue
+void init_relay_queue(void)
+{
+    rrc_relay_queue.front = -1; // queue.c empty convention
+    rrc_relay_queue.back = -1;
+    relay_stats.relay_packets_received = 0;
+    relay_stats.relay_packets_enqueued = 0;
+    relay_stats.relay_packets_dequeued = 0;
+    relay_stats.relay_packets_discarded = 0;
+    relay_stats.relay_queue_full_drops = 0;
+    relay_stats.relay_packets_to_self = 0;
+    relay_stats.relay_duplicates_suppressed = 0;
+    relay_stats.uplink_duplicates_suppressed = 0;
+    init_dup_cache();
+    printf("RRC: Relay queue initialized\n");
+}
+
+// Check if packet is destined for this node
+bool is_packet_for_self(struct frame *frame)
+{
+    if (!frame)
+        return false;
+
+    return (frame->dest_add == rrc_node_id);
+}
+
+// Determine if packet should be relayed
+bool should_relay_packet(struct frame *frame)
+{
+    if (!frame)
+        return false;
+
+    // Don't relay if packet is for this node
+    if (is_packet_for_self(frame))
+        return false;
+
+    // Don't relay if TTL is expired
+    if (frame->TTL <= 1)
+        return false;
+
+    // Don't relay OLSR control packets (they go to NC queue)
+    if (frame->rx_or_l3 == true)
+        return false;
+
+    // Group and broadcast traffic follows the MPR flooding rules
+    if (rrc_is_broadcast_addr(frame->dest_add) || rrc_is_mcast_group_addr(frame->dest_add))
+        return rrc_mcast_should_forward(frame);
+
+    return true;
+}
+
+// Enqueue packet to relay queue
+bool enqueue_relay_packet(struct frame *relay_frame)
+{
+    if (!relay_frame)
+    {
+        printf("RRC: ERROR - NULL relay frame\n");
+        return false;
+    }
+
+    relay_stats.relay_packets_received++;
+
+    // Each (source, seq) is retransmitted at most once; the flag is set only
+    // once it is actually queued, so a copy dropped here can be relayed later
+    if (rrc_dup_cache_test(relay_frame->source_add, relay_frame->sequence_number,
+                           RRC_DUP_FLAG_FORWARDED))
+    {
+        printf("RRC: Suppressing duplicate relay of %u/%u\n",
+               relay_frame->source_add, relay_frame->sequence_number);
+        relay_stats.relay_duplicates_suppressed++;
+        return false;
+    }
+
+    // Decrement TTL for relay
+    relay_frame->TTL--;
+
+    // Update next hop for relay (get from OLSR)
+    uint8_t new_next_hop = olsr_get_next_hop(relay_frame->dest_add);
+    if (new_next_hop == 0)
+    {
+        printf("RRC: ERROR - No route available for relay destination %u\n", relay_frame->dest_add);
+        relay_stats.relay_packets_discarded++;
+        return false;
+    }
+
+    // Update next hop
+    relay_frame->next_hop_add = new_next_hop;
+    relay_frame->prev_hop_add = rrc_node_id;
+
+    // Enqueue to relay queue
+    if (!rrc_aqm_enqueue(RRC_AQM_CLASS_RELAY, relay_frame))
+    {
+        printf("RRC: ERROR - Relay queue full, dropping packet\n");
+        relay_stats.relay_queue_full_drops++;
+        relay_stats.relay_packets_discarded++;
+        return false;
+    }
+    rrc_dup_cache_set(relay_frame->source_add, relay_frame->sequence_number, RRC_DUP_FLAG_FORWARDED);
+    relay_stats.relay_packets_enqueued++;
+
+    printf("RRC: Packet relayed - Dest: %u, Next hop: %u, TTL: %d\n",
+           relay_frame->dest_add, new_next_hop, relay_frame->TTL);
+
+    return true;
+}
+
+// Dequeue packet from relay queue
+struct frame dequeue_relay_packet(void)
+{
+    struct frame empty_frame = {0};
+    struct frame relay_frame;
+
+    if (!rrc_aqm_dequeue(RRC_AQM_CLASS_RELAY, &relay_frame))
+    {
+        return empty_frame;
+    }
+
+    relay_stats.relay_packets_dequeued++;
+
+    printf("RRC: Relay packet dequeued for transmission (dest: %u, next_hop: %u)\n",
+           relay_frame.dest_add, relay_frame.next_hop_add);
+
+    return relay_frame;
+}
+
+// Check if relay queue has packets
+bool relay_queue_has_packets(void)
+{
+    return !is_empty(&rrc_relay_queue);
+}
+
+// Get relay queue statistics
+void print_relay_stats(void)
+{
+    printf("\n=== Relay Queue Statistics ===\n");
+    printf("Packets received: %u\n", relay_stats.relay_packets_received);
+    printf("Packets enqueued: %u\n", relay_stats.relay_packets_enqueued);
+    printf("Packets dequeued: %u\n", relay_stats.relay_packets_dequeued);
+    printf("Packets to self: %u\n", relay_stats.relay_packets_to_self);
+    printf("Packets discarded: %u\n", relay_stats.relay_packets_discarded);
+    printf("Queue full drops: %u\n", relay_stats.relay_queue_full_drops);
+    printf("Duplicates suppressed (uplink): %u\n", relay_stats.uplink_duplicates_suppressed);
+    printf("Duplicates suppressed (relay): %u\n", relay_stats.relay_duplicates_suppressed);
+    printf("Duplicate cache evictions: %u\n", dup_cache.evictions);
+    printf("Queue status: %s\n", is_empty(&rrc_relay_queue) ? "EMPTY" : "HAS_PACKETS");
+    printf("==============================\n\n");
+}
+
+// API functions for TDMA team to dequeue from relay queue
+bool rrc_tdma_pull_relay_packet(struct frame *out)
+{
+    if (!rrc_aqm_dequeue(RRC_AQM_CLASS_RELAY, out))
+        return false;
+
+    relay_stats.relay_packets_dequeued++;
+
+    printf("RRC: TDMA dequeued relay packet (dest: %u, next_hop: %u, TTL: %d)\n",
+           out->dest_add, out->next_hop_add, out->TTL);
+    return true;
+}
+
+struct frame rrc_tdma_dequeue_relay_packet(void)
+{
+    struct frame relay_frame = {0};
+
+    if (!rrc_tdma_pull_relay_packet(&relay_frame))
+        memset(&relay_frame, 0, sizeof(relay_frame));
+    return relay_frame;
+}
+
+// API function for TDMA team to check relay queue status
+bool rrc_has_relay_packets(void)
+{
+    return !is_empty(&rrc_relay_queue);
+}
+
+// ============================================================================
+// MULTICAST / BROADCAST FAN-OUT ENGINE
+// ============================================================================
+//
+// Flooded traffic (broadcast and multicast groups without known remote
+// members) follows the OLSR MPR flooding tree: every node hears a
+// transmission, but only neighbors selected as MPR by the transmitter
+// retransmit it. Group traffic with known members is sent to the distinct
+// unicast next hops towards those members. Either way the payload is copied
+// once into a reference-counted pool entry that all next-hop transmissions
+// share, and a (source, seq) duplicate cache stops echoes and loops.
+
+static void rrc_nodeset_clear(RRC_NodeSet *set)
+{
+    memset(set, 0, sizeof(*set));
+}
+
+static void rrc_nodeset_add(RRC_NodeSet *set, uint8_t node)
+{
+    set->bits[node >> 5] |= (1u << (node & 31));
+}
+
+static void rrc_nodeset_remove(RRC_NodeSet *set, uint8_t node)
+{
+    set->bits[node >> 5] &= ~(1u << (node & 31));
+}
+
+static bool rrc_nodeset_has(const RRC_NodeSet *set, uint8_t node)
+{
+    return (set->bits[node >> 5] & (1u << (node & 31))) != 0;
+}
+
+static int rrc_nodeset_count(const RRC_NodeSet *set)
+{
+    int count = 0;
+    for (int i = 0; i < 8; i++)
+        count += __builtin_popcount(set->bits[i]);
+    return count;
+}
+
+// Initialize multicast engine state
+void init_mcast_engine(void)
+{
+    memset(mcast_groups, 0, sizeof(mcast_groups));
+    memset(mcast_payload_pool, 0, sizeof(mcast_payload_pool));
+    memset(&mcast_stats, 0, sizeof(mcast_stats));
+    rrc_nodeset_clear(&mcast_mpr_set);
+    rrc_nodeset_clear(&mcast_mpr_selectors);
+    mcast_mpr_known = false;
+    mcast_tx_head = 0;
+    mcast_tx_count = 0;
+    mcast_last_report = 0;
+    printf("RRC: Multicast engine initialized (%d groups, %d shared payloads)\n",
+           RRC_MCAST_MAX_GROUPS, RRC_MCAST_PAYLOAD_POOL_SIZE);
+}
+
+bool rrc_is_broadcast_addr(uint8_t addr)
+{
+    return addr == 0 || addr == RRC_BROADCAST_ADDR;
+}
+
+bool rrc_is_mcast_group_addr(uint8_t addr)
+{
+    return addr >= RRC_MCAST_GROUP_FIRST && addr <= RRC_MCAST_GROUP_LAST;
+}
+
+static RRC_McastGroup *rrc_mcast_find_group(uint8_t group_id, bool create)
+{
+    RRC_McastGroup *free_entry = NULL;
+
+    for (int i = 0; i < RRC_MCAST_MAX_GROUPS; i++)
+    {
+        if (mcast_groups[i].active && mcast_groups[i].group_id == group_id)
+            return &mcast_groups[i];
+        if (!mcast_groups[i].active && !free_entry)
+            free_entry = &mcast_groups[i];
+    }
+
+    if (!create || !free_entry)
+        return NULL;
+
+    memset(free_entry, 0, sizeof(*free_entry));
+    free_entry->group_id = group_id;
+    free_entry->active = true;
+    return free_entry;
+}
+
+// Record (or refresh) a member of a group; node_id == own ID joins locally
+int rrc_mcast_join_group(uint8_t group_id, uint8_t node_id)
+{
+    if (!rrc_is_mcast_group_addr(group_id) || group_id == RRC_MCAST_REPORT_GROUP)
+    {
+        printf("RRC: ERROR - %u is not a joinable multicast group address\n", group_id);
+        return -1;
+    }
+
+    RRC_McastGroup *group = rrc_mcast_find_group(group_id, true);
+    if (!group)
+    {
+        printf("RRC: ERROR - Multicast group table full, cannot join group %u\n", group_id);
+        return -1;
+    }
+
+    if (node_id == rrc_node_id)
+    {
+        if (!group->local_member)
+        {
+            group->local_member = true;
+            printf("RRC: Joined multicast group %u locally\n", group_id);
+            // Announce right away so upstream fan-out includes us without waiting a period
+            mcast_last_report = 0;
+        }
+    }
+    else
+    {
+        if (!rrc_nodeset_has(&group->members, node_id))
+            printf("RRC: Node %u joined multicast group %u\n", node_id, group_id);
+        rrc_nodeset_add(&group->members, node_id);
+        group->member_last_seen[node_id] = (uint32_t)time(NULL);
+    }
+    return 0;
+}
+
+void rrc_mcast_leave_group(uint8_t group_id, uint8_t node_id)
+{
+    RRC_McastGroup *group = rrc_mcast_find_group(group_id, false);
+    if (!group)
+        return;
+
+    if (node_id == rrc_node_id)
+        group->local_member = false;
+    else
+        rrc_nodeset_remove(&group->members, node_id);
+
+    if (!group->local_member && rrc_nodeset_count(&group->members) == 0)
+        group->active = false;
+}
+
+bool rrc_mcast_is_member(uint8_t group_id, uint8_t node_id)
+{
+    RRC_McastGroup *group = rrc_mcast_find_group(group_id, false);
+    if (!group)
+        return false;
+
+    if (node_id == rrc_node_id)
+        return group->local_member;
+    return rrc_nodeset_has(&group->members, node_id);
+}
+
+// Drop remote members that stopped refreshing their join
+void rrc_mcast_expire_members(void)
+{
+    uint32_t now = (uint32_t)time(NULL);
+
+    for (int g = 0; g < RRC_MCAST_MAX_GROUPS; g++)
+    {
+        RRC_McastGroup *group = &mcast_groups[g];
+        if (!group->active)
+            continue;
+
+        for (int node = 0; node < 256; node++)
+        {
+            if (rrc_nodeset_has(&group->members, (uint8_t)node) &&
+                now - group->member_last_seen[node] > RRC_MCAST_MEMBER_TIMEOUT_SEC)
+            {
+                printf("RRC: Multicast member %d of group %u timed out\n", node, group->group_id);
+                rrc_nodeset_remove(&group->members, (uint8_t)node);
+            }
+        }
+
+        if (!group->local_member && rrc_nodeset_count(&group->members) == 0)
+            group->active = false;
+    }
+}
+
+// Replace the MPR view with the latest sets computed by OLSR
+void rrc_mcast_update_mpr_sets(const uint8_t *mprs, int mpr_count,
+                               const uint8_t *selectors, int selector_count)
+{
+    rrc_nodeset_clear(&mcast_mpr_set);
+    rrc_nodeset_clear(&mcast_mpr_selectors);
+
+    for (int i = 0; mprs && i < mpr_count; i++)
+        rrc_nodeset_add(&mcast_mpr_set, mprs[i]);
+    for (int i = 0; selectors && i < selector_count; i++)
+        rrc_nodeset_add(&mcast_mpr_selectors, selectors[i]);
+
+    mcast_mpr_known = true;
+    mcast_stats.mpr_updates++;
+
+    printf("RRC: MPR sets updated - %d MPRs, %d MPR selectors\n", mpr_count, selector_count);
+}
+
+void rrc_handle_olsr_mpr_update(const IPC_MPRUpdate *update)
+{
+    if (!update || update->type != MSG_OLSR_MPR_UPDATE)
+        return;
+
+    int mpr_count = update->mpr_count > MAX_MONITORED_NODES ? MAX_MONITORED_NODES : update->mpr_count;
+    int selector_count = update->selector_count > MAX_MONITORED_NODES ? MAX_MONITORED_NODES : update->selector_count;
+    rrc_mcast_update_mpr_sets(update->mprs, mpr_count, update->selectors, selector_count);
+}
+
+// Unsolicited (or late) route update: re-point an existing connection.
+// A withdrawn route ends setup; while CONNECTED it starts make-before-break
+// reconfiguration, and during RECONFIGURATION it can confirm the candidate.
+void rrc_handle_olsr_route_update(const IPC_RouteResponse *update)
+{
+    if (!update || update->type != MSG_OLSR_ROUTE_UPDATE)
+        return;
+
+    mcast_stats.route_updates++;
+    if (update->dest_node == RRC_ROUTE_UPDATE_ANY_DEST)
+    {
+        rrc_route_cache_sync_generation(update->generation);
+        return;
+    }
+    rrc_route_cache_store(update->dest_node, update->route_available ? update->next_hop : 0,
+                          update->generation);
+
+    RRC_ConnectionContext *ctx = rrc_get_connection_context(update->dest_node);
+    if (!ctx)
+        return;
+
+    uint8_t next_hop = update->route_available ? update->next_hop : 0;
+
+    switch (ctx->connection_state)
+    {
+    case RRC_STATE_CONNECTION_SETUP:
+        if (next_hop == 0)
+            rrc_handle_route_lost(update->dest_node);
+        break;
+    case RRC_STATE_CONNECTED:
+        if (next_hop != rrc_connection_next_hop(ctx))
+        {
+            printf("RRC: OLSR route update for node %u: %u → %u\n",
+                   update->dest_node, rrc_connection_next_hop(ctx), next_hop);
+            rrc_handle_route_change(update->dest_node, next_hop);
+        }
+        break;
+    case RRC_STATE_RECONFIGURATION:
+        if (next_hop != 0)
+        {
+            update_phy_metrics_for_node(next_hop);
+            if (next_hop != ctx->reconfig_new_hop)
+                rrc_reconfig_reserve_candidate(ctx, next_hop);
+            rrc_reconfig_try_confirm(ctx, next_hop);
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+// Route one OLSR → RRC message to its handler
+void rrc_dispatch_olsr_message(const void *msg, size_t len)
+{
+    IPC_MessageType type;
+
+    if (!msg || len < sizeof(type))
+        return;
+    memcpy(&type, msg, sizeof(type));
+
+    if (type == MSG_OLSR_MPR_UPDATE && len >= sizeof(IPC_MPRUpdate))
+        rrc_handle_olsr_mpr_update((const IPC_MPRUpdate *)msg);
+    else if (type == MSG_OLSR_ROUTE_UPDATE && len >= sizeof(IPC_RouteResponse))
+        rrc_handle_olsr_route_update((const IPC_RouteResponse *)msg);
+}
+
+// Drain unsolicited OLSR → RRC messages (MPR and route updates)
+void rrc_poll_olsr_updates(void)
+{
+    if (!ipc_initialized)
+        return;
+
+    union
+    {
+        IPC_MessageType type;
+        IPC_MPRUpdate mpr_update;
+        IPC_RouteResponse route_update;
+        char raw[MQ_MESSAGE_SIZE];
+    } msg;
+
+    int bytes;
+    while ((bytes = rrc_receive_from_olsr(&msg, sizeof(msg), false)) > 0)
+        rrc_dispatch_olsr_message(&msg, (size_t)bytes);
+}
+
+// MPR forwarding rule for a received group/broadcast frame
+bool rrc_mcast_should_forward(const struct frame *frame)
+{
+    if (!frame || frame->TTL <= 1)
+        return false;
+
+    // Explicitly addressed copy of a member fan-out
+    if (frame->next_hop_add == rrc_node_id)
+        return true;
+
+    if (!rrc_is_broadcast_addr(frame->next_hop_add))
+        return false;
+
+    // Flooded copy: retransmit only if the transmitter selected us as MPR.
+    // Without MPR information fall back to classic flooding.
+    return !mcast_mpr_known || rrc_nodeset_has(&mcast_mpr_selectors, frame->prev_hop_add);
+}
+
+// Next hops for a group/broadcast frame, excluding where it came from
+static void rrc_mcast_build_next_hops(const struct frame *frame, uint8_t prev_hop, RRC_NodeSet *next_hops)
+{
+    rrc_nodeset_clear(next_hops);
+
+    RRC_McastGroup *group = NULL;
+    if (rrc_is_mcast_group_addr(frame->dest_add))
+        group = rrc_mcast_find_group(frame->dest_add, false);
+
+    if (group && rrc_nodeset_count(&group->members) > 0)
+    {
+        // Only the member bits are visited, and next hops come from the
+        // route cache: fan-out never waits on OLSR. A member whose route is
+        // not known yet is requested and reached by a flooded copy meanwhile.
+        bool flood = false;
+        for (int word = 0; word < 8; word++)
+        {
+            uint32_t bits = group->members.bits[word];
+            while (bits)
+            {
+                uint8_t node = (uint8_t)(word * 32 + __builtin_ctz(bits));
+                bits &= bits - 1;
+
+                if (node == rrc_node_id || node == frame->source_add || node == prev_hop)
+                    continue;
+
+                uint8_t next_hop;
+                if (!rrc_route_cache_lookup(node, &next_hop))
+                {
+                    ipc_olsr_request_route(node);
+                    mcast_stats.mcast_unresolved_members++;
+                    flood = true;
+                    continue;
+                }
+                if (next_hop == 0)
+                {
+                    mcast_stats.mcast_unreachable_members++;
+                    continue;
+                }
+                if (next_hop != prev_hop)
+                    rrc_nodeset_add(next_hops, next_hop);
+            }
+        }
+        if (flood)
+            rrc_nodeset_add(next_hops, RRC_BROADCAST_ADDR);
+        return;
+    }
+
+    // No known remote members: one transmission reaches every neighbor,
+    // and only our MPRs retransmit it (see rrc_mcast_should_forward)
+    rrc_nodeset_add(next_hops, RRC_BROADCAST_ADDR);
+}
+
+static int rrc_mcast_payload_alloc(const struct frame *frame)
+{
+    for (int i = 0; i < RRC_MCAST_PAYLOAD_POOL_SIZE; i++)
+    {
+        if (!mcast_payload_pool[i].in_use)
+        {
+            mcast_payload_pool[i].frame = *frame;
+            mcast_payload_pool[i].refcount = 0;
+            mcast_payload_pool[i].in_use = true;
+            mcast_stats.mcast_payload_copies++;
+            return i;
+        }
+    }
+    mcast_stats.mcast_payload_pool_exhausted++;
+    return -1;
+}
+
+static void rrc_mcast_payload_release(int index)
+{
+    RRC_McastPayload *payload = &mcast_payload_pool[index];
+    if (payload->refcount > 0)
+        payload->refcount--;
+    if (payload->refcount == 0)
+        payload->in_use = false;
+}
+
+/**
+ * Queue one transmission per next hop, all referencing a single payload copy.
+ * @return number of transmissions queued, -1 on resource exhaustion
+ */
+int rrc_mcast_fanout_frame(const struct frame *frame, uint8_t prev_hop)
+{
+    if (!frame)
+        return -1;
+
+    RRC_NodeSet next_hops;
+    rrc_mcast_build_next_hops(frame, prev_hop, &next_hops);
+    if (rrc_nodeset_count(&next_hops) == 0)
+        return 0;
+
+    int index = rrc_mcast_payload_alloc(frame);
+    if (index < 0)
+    {
+        printf("RRC: ERROR - Multicast payload pool exhausted, dropping frame %u/%u\n",
+               frame->source_add, frame->sequence_number);
+        return -1;
+    }
+
+    RRC_McastPayload *payload = &mcast_payload_pool[index];
+    payload->frame.prev_hop_add = rrc_node_id;
+    payload->frame.enqueue_time_ms = rrc_now_ms(); // Copies age from here, not from the sender's clock
+    payload->refcount = 1; // Held by the fan-out loop until all copies are queued
 
-    printf("RRC: OLSR packet from node %u enqueued to NC queue (slot %u, size %u)\n",
-           source_node, assigned_slot, (unsigned int)copy_size);
+    int queued = 0;
+    for (int node = 1; node < 256; node++)
+    {
+        if (!rrc_nodeset_has(&next_hops, (uint8_t)node))
+            continue;
 
-    return true;
-}
+        if (mcast_tx_count >= RRC_MCAST_TX_QUEUE_SIZE)
+        {
+            printf("RRC: ERROR - Multicast TX queue full, next hop %d skipped\n", node);
+            mcast_stats.mcast_tx_queue_full_drops++;
+            continue;
+        }
 
-// API function for TDMA team to dequeue from NC queue
-struct frame rrc_tdma_dequeue_nc_packet(uint8_t target_slot)
-{
-    struct frame empty_frame = {0};
+        uint8_t slot_id = 255;
+        if (frame->priority != PRIORITY_ANALOG_VOICE_PTT)
+        {
+            slot_id = rrc_allocate_du_gu_slot((uint8_t)node, (MessagePriority)frame->priority);
+            if (slot_id == 255)
+            {
+                mcast_stats.mcast_no_slot_drops++;
+                continue;
+            }
+        }
 
-    if (is_empty(&rrc_olsr_nc_queue))
-    {
-        printf("RRC: TDMA requested NC packet for slot %u, but NC queue is empty\n", target_slot);
-        return empty_frame;
+        RRC_McastTxDescriptor *desc = &mcast_tx_ring[(mcast_tx_head + mcast_tx_count) % RRC_MCAST_TX_QUEUE_SIZE];
+        desc->payload_index = (uint8_t)index;
+        desc->next_hop = (uint8_t)node;
+        desc->slot_id = slot_id;
+        mcast_tx_count++;
+        payload->refcount++;
+        queued++;
     }
 
-    // Simple dequeue - returns next available frame
-    // For slot-specific dequeue, we'd need to search the queue
-    struct frame nc_frame = dequeue(&rrc_olsr_nc_queue);
-    olsr_nc_stats.olsr_packets_dequeued++;
-    olsr_nc_stats.tdma_nc_requests++;
+    mcast_stats.mcast_copies_queued += queued;
+    rrc_mcast_payload_release(index);
 
-    printf("RRC: TDMA dequeued NC packet for slot %u (assigned slot was %d)\n",
-           target_slot, nc_frame.TTL);
+    printf("RRC: Multicast fan-out %u/%u to group %u - %d next hop(s), 1 payload copy\n",
+           frame->source_add, frame->sequence_number, frame->dest_add, queued);
 
-    return nc_frame;
+    return queued;
 }
 
-// Check if NC queue has packets for specific slot
-bool rrc_has_nc_packet_for_slot(uint8_t target_slot)
+// ---------------------------------------------------------------------------
+// Membership reports: every node with local members floods the list of its
+// groups to RRC_MCAST_REPORT_GROUP (relayed by MPRs like any member-less
+// group), and each receiver records the sender with rrc_mcast_join_group().
+// Reports repeat every RRC_MCAST_REPORT_INTERVAL_SEC, well inside the
+// member timeout, so a member that goes quiet ages out.
+// ---------------------------------------------------------------------------
+
+int rrc_mcast_send_membership_report(void)
 {
-    (void)target_slot; // Suppress unused parameter warning
+    struct frame report = {0};
+    int count = 0;
 
-    if (is_empty(&rrc_olsr_nc_queue))
+    report.payload[0] = RRC_MCAST_REPORT_TAG;
+    for (int g = 0; g < RRC_MCAST_MAX_GROUPS && count < PAYLOAD_SIZE_BYTES - 2; g++)
     {
-        return false;
+        if (mcast_groups[g].active && mcast_groups[g].local_member)
+            report.payload[2 + count++] = (char)mcast_groups[g].group_id;
     }
+    if (count == 0)
+        return 0;
 
-    // Simple check - just return if queue has any packets
-    // For slot-specific check, we'd need to peek into the queue
-    return true;
+    report.payload[1] = (char)count;
+    report.payload_length_bytes = 2 + count;
+    report.source_add = rrc_node_id;
+    report.dest_add = RRC_MCAST_REPORT_GROUP;
+    report.next_hop_add = RRC_BROADCAST_ADDR;
+    report.prev_hop_add = rrc_node_id;
+    report.sequence_number = rrc_next_tx_sequence();
+    report.TTL = 10;
+    report.priority = PRIORITY_DATA_3;
+    report.data_type = DATA_TYPE_SMS;
+
+    rrc_dup_cache_test_and_set(report.source_add, report.sequence_number,
+                               RRC_DUP_FLAG_RECEIVED | RRC_DUP_FLAG_FORWARDED);
+
+    if (rrc_mcast_fanout_frame(&report, rrc_node_id) <= 0)
+        return -1;
+
+    mcast_stats.reports_sent++;
+    return count;
 }
 
-// Get NC queue statistics
-void print_olsr_nc_stats(void)
+static void rrc_mcast_process_membership_report(const struct frame *frame)
 {
-    printf("\n=== OLSR NC Queue Statistics ===\n");
-    printf("Packets received: %u\n", olsr_nc_stats.olsr_packets_received);
-    printf("Packets enqueued: %u\n", olsr_nc_stats.olsr_packets_enqueued);
-    printf("Packets dequeued: %u\n", olsr_nc_stats.olsr_packets_dequeued);
-    printf("Queue full drops: %u\n", olsr_nc_stats.olsr_queue_full_drops);
-    printf("TDMA NC requests: %u\n", olsr_nc_stats.tdma_nc_requests);
-    printf("Queue status: %s\n", is_empty(&rrc_olsr_nc_queue) ? "EMPTY" : "HAS_PACKETS");
-    printf("===============================\n\n");
-}
+    if (frame->payload_length_bytes < 2 || (uint8_t)frame->payload[0] != RRC_MCAST_REPORT_TAG)
+        return;
 
-// ============================================================================
-// RELAY QUEUE MANAGEMENT FUNCTIONS
-// ============================================================================
+    int count = (uint8_t)frame->payload[1];
+    if (count > frame->payload_length_bytes - 2)
+        count = frame->payload_length_bytes - 2;
 
-// Initialize Relay queue
-void init_relay_queue(void)
-{
-    rrc_relay_queue.front = 0;
-    rrc_relay_queue.back = 0;
-    relay_stats.relay_packets_received = 0;
-    relay_stats.relay_packets_enqueued = 0;
-    relay_stats.relay_packets_dequeued = 0;
-    relay_stats.relay_packets_discarded = 0;
-    relay_stats.relay_queue_full_drops = 0;
-    relay_stats.relay_packets_to_self = 0;
-    printf("RRC: Relay queue initialized\n");
+    for (int i = 0; i < count; i++)
+        rrc_mcast_join_group((uint8_t)frame->payload[2 + i], frame->source_add);
+    mcast_stats.reports_received++;
 }
 
-// Check if packet is destined for this node
-bool is_packet_for_self(struct frame *frame)
+// Periodic: re-announce local memberships before remote members time out
+void rrc_mcast_refresh_membership(void)
 {
-    if (!frame)
-        return false;
+    uint32_t now = (uint32_t)time(NULL);
 
-    return (frame->dest_add == rrc_node_id);
+    if (mcast_last_report != 0 && now - mcast_last_report < RRC_MCAST_REPORT_INTERVAL_SEC)
+        return;
+
+    if (rrc_mcast_send_membership_report() >= 0)
+        mcast_last_report = now;
 }
 
-// Determine if packet should be relayed
-bool should_relay_packet(struct frame *frame)
+// Originate an L7 broadcast/multicast message
+int rrc_mcast_send_application_message(ApplicationMessage *app_msg)
 {
-    if (!frame)
-        return false;
+    if (!app_msg)
+        return -1;
 
-    // Don't relay if packet is for this node
-    if (is_packet_for_self(frame))
-        return false;
+    // An empty multicast packet from L7 subscribes this node to the group
+    if (app_msg->transmission_type == TRANSMISSION_MULTICAST && app_msg->data_size == 0)
+    {
+        if (rrc_mcast_join_group(app_msg->dest_node_id, rrc_node_id) != 0)
+            return -1;
+        rrc_mcast_refresh_membership();
+        return 0;
+    }
 
-    // Don't relay if TTL is expired
-    if (frame->TTL <= 1)
-        return false;
+    struct frame mcast_frame = create_frame_from_rrc(app_msg, RRC_BROADCAST_ADDR);
+    if (app_msg->transmission_type == TRANSMISSION_BROADCAST)
+        mcast_frame.dest_add = RRC_BROADCAST_ADDR;
 
-    // Don't relay OLSR control packets (they go to NC queue)
-    if (frame->rx_or_l3 == true)
-        return false;
+    // Our own frame must not be processed or relayed again when it echoes back
+    rrc_dup_cache_test_and_set(mcast_frame.source_add, mcast_frame.sequence_number,
+                               RRC_DUP_FLAG_RECEIVED | RRC_DUP_FLAG_FORWARDED);
+    mcast_stats.mcast_originated++;
 
-    // Don't relay broadcast packets with high hop count
-    if (frame->dest_add == 0 && frame->TTL < 3)
-        return false;
+    int queued = rrc_mcast_fanout_frame(&mcast_frame, rrc_node_id);
+    if (queued <= 0)
+    {
+        printf("RRC: No multicast next hops for destination %u\n", mcast_frame.dest_add);
+        if (queued == 0)
+            notify_application_of_failure(app_msg->dest_node_id, "No multicast members reachable");
+        return -1;
+    }
 
-    return true;
+    rrc_stats.messages_enqueued_total++;
+    return 0;
 }
 
-// Enqueue packet to relay queue
-bool enqueue_relay_packet(struct frame *relay_frame)
+// Receive path for group/broadcast frames: dedup, deliver locally, re-fan-out
+int rrc_mcast_process_uplink_frame(struct frame *received_frame)
 {
-    if (!relay_frame)
+    if (!received_frame)
+        return -1;
+
+    // Duplicates were already filtered by rrc_process_uplink_frame
+    mcast_stats.mcast_received++;
+
+    if (received_frame->dest_add == RRC_MCAST_REPORT_GROUP)
     {
-        printf("RRC: ERROR - NULL relay frame\n");
-        return false;
+        rrc_mcast_process_membership_report(received_frame);
+    }
+    else if (rrc_is_broadcast_addr(received_frame->dest_add) ||
+             rrc_mcast_is_member(received_frame->dest_add, rrc_node_id))
+    {
+        mcast_stats.mcast_delivered_local++;
+        deliver_data_packet_to_l7(received_frame);
     }
 
-    relay_stats.relay_packets_received++;
-
-    if (is_full(&rrc_relay_queue))
+    if (!rrc_mcast_should_forward(received_frame))
     {
-        printf("RRC: ERROR - Relay queue full, dropping packet\n");
-        relay_stats.relay_queue_full_drops++;
-        relay_stats.relay_packets_discarded++;
-        return false;
+        if (received_frame->TTL > 1)
+            mcast_stats.mcast_not_selected_mpr++;
+        return 0;
     }
 
-    // Decrement TTL for relay
-    relay_frame->TTL--;
+    if (rrc_dup_cache_test(received_frame->source_add, received_frame->sequence_number,
+                           RRC_DUP_FLAG_FORWARDED))
+    {
+        relay_stats.relay_duplicates_suppressed++;
+        return 0;
+    }
 
-    // Update next hop for relay (get from OLSR)
-    uint8_t new_next_hop = olsr_get_next_hop(relay_frame->dest_add);
-    if (new_next_hop == 0)
+    struct frame relay_frame = *received_frame;
+    relay_frame.TTL--;
+    if (rrc_mcast_fanout_frame(&relay_frame, received_frame->prev_hop_add) > 0)
     {
-        printf("RRC: ERROR - No route available for relay destination %u\n", relay_frame->dest_add);
-        relay_stats.relay_packets_discarded++;
-        return false;
+        rrc_dup_cache_set(received_frame->source_add, received_frame->sequence_number,
+                          RRC_DUP_FLAG_FORWARDED);
+        mcast_stats.mcast_forwarded++;
     }
 
-    // Update next hop
-    relay_frame->next_hop_add = new_next_hop;
+    return 0;
+}
 
-    // Enqueue to relay queue
-    enqueue(&rrc_relay_queue, *relay_frame);
-    relay_stats.relay_packets_enqueued++;
+// API function for TDMA team to check multicast fan-out queue status
+bool rrc_has_mcast_packets(void)
+{
+    return mcast_tx_count > 0;
+}
 
-    printf("RRC: Packet relayed - Dest: %u, Next hop: %u, TTL: %d\n",
-           relay_frame->dest_add, new_next_hop, relay_frame->TTL);
+/**
+ * Zero-copy access for TDMA: the returned frame is the shared payload, its
+ * next_hop_add must be taken from *next_hop. Call
+ * rrc_tdma_complete_mcast_packet() and then rrc_tdma_release_mcast_slot()
+ * once transmitted.
+ */
+const struct frame *rrc_tdma_peek_mcast_packet(uint8_t *next_hop, uint8_t *slot_id)
+{
+    if (mcast_tx_count == 0)
+        return NULL;
 
-    return true;
+    RRC_McastTxDescriptor *desc = &mcast_tx_ring[mcast_tx_head];
+    if (next_hop)
+        *next_hop = desc->next_hop;
+    if (slot_id)
+        *slot_id = desc->slot_id;
+    return &mcast_payload_pool[desc->payload_index].frame;
 }
 
-// Dequeue packet from relay queue
-struct frame dequeue_relay_packet(void)
+void rrc_tdma_complete_mcast_packet(void)
 {
-    struct frame empty_frame = {0};
+    if (mcast_tx_count == 0)
+        return;
 
-    if (is_empty(&rrc_relay_queue))
-    {
-        return empty_frame;
-    }
+    RRC_McastTxDescriptor *desc = &mcast_tx_ring[mcast_tx_head];
+    rrc_mcast_payload_release(desc->payload_index);
+    mcast_tx_head = (mcast_tx_head + 1) % RRC_MCAST_TX_QUEUE_SIZE;
+    mcast_tx_count--;
+}
 
-    struct frame relay_frame = dequeue(&rrc_relay_queue);
-    relay_stats.relay_packets_dequeued++;
+// Copying variant for callers that need an owned frame. *slot_id receives
+// the DU/GU slot reserved for this copy (255 if none), to be handed back to
+// rrc_tdma_release_mcast_slot() after transmission.
+struct frame rrc_tdma_dequeue_mcast_packet(uint8_t *slot_id)
+{
+    struct frame mcast_frame = {0};
+    uint8_t next_hop = 0;
 
-    printf("RRC: Relay packet dequeued for transmission (dest: %u, next_hop: %u)\n",
-           relay_frame.dest_add, relay_frame.next_hop_add);
+    if (slot_id)
+        *slot_id = 255;
+    const struct frame *shared = rrc_tdma_peek_mcast_packet(&next_hop, slot_id);
+    if (!shared)
+        return mcast_frame;
 
-    return relay_frame;
+    mcast_frame = *shared;
+    mcast_frame.next_hop_add = next_hop;
+    rrc_tdma_complete_mcast_packet();
+
+    printf("RRC: TDMA dequeued multicast packet (src: %u, seq: %u, next_hop: %u)\n",
+           mcast_frame.source_add, mcast_frame.sequence_number, next_hop);
+
+    return mcast_frame;
 }
 
-// Check if relay queue has packets
-bool relay_queue_has_packets(void)
+// A transmitted fan-out copy gives its slot back unless a connection, a
+// queued frame or another queued copy still goes to the same next hop
+void rrc_tdma_release_mcast_slot(uint8_t next_hop, uint8_t slot_id)
 {
-    return !is_empty(&rrc_relay_queue);
+    if (slot_id == 255 || rrc_reconfig_hop_in_use(next_hop))
+        return;
+    rrc_release_slot(next_hop, slot_id);
 }
 
-// Get relay queue statistics
-void print_relay_stats(void)
+// Take the copy at ring position pos out of the fan-out queue
+static RRC_McastTxDescriptor rrc_mcast_tx_remove(int pos, struct frame *out)
 {
-    printf("\n=== Relay Queue Statistics ===\n");
-    printf("Packets received: %u\n", relay_stats.relay_packets_received);
-    printf("Packets enqueued: %u\n", relay_stats.relay_packets_enqueued);
-    printf("Packets dequeued: %u\n", relay_stats.relay_packets_dequeued);
-    printf("Packets to self: %u\n", relay_stats.relay_packets_to_self);
-    printf("Packets discarded: %u\n", relay_stats.relay_packets_discarded);
-    printf("Queue full drops: %u\n", relay_stats.relay_queue_full_drops);
-    printf("Queue status: %s\n", is_empty(&rrc_relay_queue) ? "EMPTY" : "HAS_PACKETS");
-    printf("==============================\n\n");
+    RRC_McastTxDescriptor desc = mcast_tx_ring[(mcast_tx_head + pos) % RRC_MCAST_TX_QUEUE_SIZE];
+
+    if (out)
+    {
+        *out = mcast_payload_pool[desc.payload_index].frame;
+        out->next_hop_add = desc.next_hop;
+    }
+    rrc_mcast_payload_release(desc.payload_index);
+
+    for (int i = pos; i + 1 < mcast_tx_count; i++)
+        mcast_tx_ring[(mcast_tx_head + i) % RRC_MCAST_TX_QUEUE_SIZE] =
+            mcast_tx_ring[(mcast_tx_head + i + 1) % RRC_MCAST_TX_QUEUE_SIZE];
+    mcast_tx_count--;
+    return desc;
 }
 
-// API function for TDMA team to dequeue from relay queue
-struct frame rrc_tdma_dequeue_relay_packet(void)
+static RRC_AqmClass rrc_tdma_aqm_class(int tdma_class)
 {
-    struct frame empty_frame = {0};
+    if (tdma_class == RRC_TDMA_CLASS_RELAY)
+        return RRC_AQM_CLASS_RELAY;
+    return (RRC_AqmClass)(RRC_AQM_CLASS_DIGITAL_VOICE + tdma_class);
+}
 
-    if (is_empty(&rrc_relay_queue))
+/**
+ * Next hops with a live frame queued in a TDMA class, one bit per node ID
+ * in hops[8]. Frames and fan-out copies past their deadline are dropped
+ * here, before a scheduler gives their next hop any credit.
+ * @return number of distinct next hops
+ */
+int rrc_tdma_queued_next_hops(int tdma_class, uint32_t hops[8])
+{
+    RRC_NodeSet set;
+    uint32_t now = rrc_now_ms();
+
+    rrc_nodeset_clear(&set);
+    if (tdma_class == RRC_TDMA_CLASS_MCAST)
     {
-        return empty_frame;
+        for (int pos = 0; pos < mcast_tx_count;)
+        {
+            const RRC_McastTxDescriptor *desc = &mcast_tx_ring[(mcast_tx_head + pos) % RRC_MCAST_TX_QUEUE_SIZE];
+            if (rrc_aqm_frame_expired(&mcast_payload_pool[desc->payload_index].frame, now))
+            {
+                RRC_McastTxDescriptor stale = rrc_mcast_tx_remove(pos, NULL);
+                rrc_tdma_release_mcast_slot(stale.next_hop, stale.slot_id);
+                mcast_stats.mcast_deadline_drops++;
+                continue;
+            }
+            rrc_nodeset_add(&set, desc->next_hop);
+            pos++;
+        }
     }
+    else if (tdma_class >= 0 && tdma_class <= RRC_TDMA_CLASS_RELAY)
+    {
+        RRC_AqmClass cls = rrc_tdma_aqm_class(tdma_class);
+        struct queue *q = rrc_aqm_queue(cls);
 
-    struct frame relay_frame = dequeue(&rrc_relay_queue);
-    relay_stats.relay_packets_dequeued++;
-
-    printf("RRC: TDMA dequeued relay packet (dest: %u, next_hop: %u, TTL: %d)\n",
-           relay_frame.dest_add, relay_frame.next_hop_add, relay_frame.TTL);
+        for (int i = q->front; !is_empty(q) && i <= q->back;)
+        {
+            if (rrc_aqm_frame_expired(&q->item[i], now))
+            {
+                bool head = (i == q->front);
+                rrc_queue_remove_at(q, i);
+                if (head)
+                    i = q->front;
+                aqm_stats[cls].deadline_drops++;
+                continue;
+            }
+            rrc_nodeset_add(&set, q->item[i].next_hop_add);
+            i++;
+        }
+    }
 
-    return relay_frame;
+    memcpy(hops, set.bits, sizeof(set.bits));
+    return rrc_nodeset_count(&set);
 }
 
-// API function for TDMA team to check relay queue status
-bool rrc_has_relay_packets(void)
+/**
+ * Oldest live frame of a TDMA class toward next_hop. For fan-out copies
+ * *slot_id receives the reserved DU/GU slot (255 otherwise), to be handed
+ * to rrc_tdma_release_mcast_slot() after transmission.
+ */
+bool rrc_tdma_pull_packet_for_hop(int tdma_class, uint8_t next_hop, struct frame *out, uint8_t *slot_id)
 {
-    return !is_empty(&rrc_relay_queue);
+    if (!out)
+        return false;
+    if (slot_id)
+        *slot_id = 255;
+
+    if (tdma_class == RRC_TDMA_CLASS_MCAST)
+    {
+        for (int pos = 0; pos < mcast_tx_count; pos++)
+        {
+            if (mcast_tx_ring[(mcast_tx_head + pos) % RRC_MCAST_TX_QUEUE_SIZE].next_hop != next_hop)
+                continue;
+
+            RRC_McastTxDescriptor desc = rrc_mcast_tx_remove(pos, out);
+            if (slot_id)
+                *slot_id = desc.slot_id;
+            return true;
+        }
+        return false;
+    }
+
+    if (tdma_class < 0 || tdma_class > RRC_TDMA_CLASS_RELAY)
+        return false;
+    if (!rrc_aqm_dequeue_for_hop(rrc_tdma_aqm_class(tdma_class), next_hop, out))
+        return false;
+    if (tdma_class == RRC_TDMA_CLASS_RELAY)
+        relay_stats.relay_packets_dequeued++;
+    return true;
+}
+
+void print_mcast_stats(void)
+{
+    printf("\n=== Multicast Statistics ===\n");
+    printf("Originated: %u\n", mcast_stats.mcast_originated);
+    printf("Received: %u\n", mcast_stats.mcast_received);
+    printf("Delivered locally: %u\n", mcast_stats.mcast_delivered_local);
+    printf("Forwarded: %u\n", mcast_stats.mcast_forwarded);
+    printf("Not forwarded (not MPR): %u\n", mcast_stats.mcast_not_selected_mpr);
+    printf("Copies queued: %u (payload copies: %u)\n",
+           mcast_stats.mcast_copies_queued, mcast_stats.mcast_payload_copies);
+    printf("Drops - pool: %u, queue full: %u, no slot: %u, deadline: %u\n",
+           mcast_stats.mcast_payload_pool_exhausted, mcast_stats.mcast_tx_queue_full_drops,
+           mcast_stats.mcast_no_slot_drops, mcast_stats.mcast_deadline_drops);
+    printf("Unreachable members: %u, awaiting route (flooded): %u\n",
+           mcast_stats.mcast_unreachable_members, mcast_stats.mcast_unresolved_members);
+    printf("MPR updates: %u (known: %s, MPRs: %d, selectors: %d)\n", mcast_stats.mpr_updates,
+           mcast_mpr_known ? "YES" : "NO", rrc_nodeset_count(&mcast_mpr_set),
+           rrc_nodeset_count(&mcast_mpr_selectors));
+    printf("Membership reports sent: %u, received: %u; OLSR route updates: %u\n",
+           mcast_stats.reports_sent, mcast_stats.reports_received, mcast_stats.route_updates);
+    printf("Route cache generation: %u (flushes: %u)\n", route_cache_generation, route_cache_flushes);
+    printf("TX queue depth: %d\n", mcast_tx_count);
+    printf("============================\n\n");
 }
 
 // ============================================================================
@@ -3234,6 +5800,8 @@ struct frame create_frame_from_rrc(ApplicationMessage *app_msg, uint8_t next_hop
     new_frame.source_add = app_msg->node_id;
     new_frame.dest_add = app_msg->dest_node_id;
     new_frame.next_hop_add = next_hop_node;
+    new_frame.prev_hop_add = rrc_node_id;
+    new_frame.sequence_number = rrc_next_tx_sequence();
     new_frame.rx_or_l3 = false; // L7 data going down to L2
     new_frame.TTL = 10;         // Default TTL
     new_frame.priority = app_msg->priority;
@@ -3323,36 +5891,40 @@ void enqueue_to_appropriate_queue(ApplicationMessage *app_msg, uint8_t next_hop_
     struct frame new_frame = create_frame_from_rrc(app_msg, next_hop_node);
 
     // Enqueue to appropriate queue
+    bool queued = true;
     switch (app_msg->priority)
     {
     case PRIORITY_ANALOG_VOICE_PTT:
-        enqueue(&analog_voice_queue, new_frame);
+        queued = rrc_aqm_enqueue(RRC_AQM_CLASS_ANALOG_VOICE, &new_frame);
         printf("RRC: → Enqueued to analog_voice_queue (PTT)\n");
         break;
     case PRIORITY_DIGITAL_VOICE:
-        enqueue(&data_from_l3_queue[0], new_frame);
+        queued = rrc_aqm_enqueue(RRC_AQM_CLASS_DIGITAL_VOICE, &new_frame);
         printf("RRC: → Enqueued to data_from_l3_queue[0] (Digital Voice)\n");
         break;
     case PRIORITY_DATA_1:
-        enqueue(&data_from_l3_queue[1], new_frame);
+        queued = rrc_aqm_enqueue(RRC_AQM_CLASS_VIDEO, &new_frame);
         printf("RRC: → Enqueued to data_from_l3_queue[1] (Video)\n");
         break;
     case PRIORITY_DATA_2:
-        enqueue(&data_from_l3_queue[2], new_frame);
+        queued = rrc_aqm_enqueue(RRC_AQM_CLASS_FILE, &new_frame);
         printf("RRC: → Enqueued to data_from_l3_queue[2] (File)\n");
         break;
     case PRIORITY_DATA_3:
-        enqueue(&data_from_l3_queue[3], new_frame);
+        queued = rrc_aqm_enqueue(RRC_AQM_CLASS_SMS, &new_frame);
         printf("RRC: → Enqueued to data_from_l3_queue[3] (SMS)\n");
         break;
     case PRIORITY_RX_RELAY:
     default:
-        enqueue(&rx_queue, new_frame);
+        queued = rrc_queue_push(&rx_queue, &new_frame);
         printf("RRC: → Enqueued to rx_queue (Relay)\n");
         break;
     }
 
-    rrc_stats.messages_enqueued_total++;
+    if (queued)
+        rrc_stats.messages_enqueued_total++;
+    else
+        printf("RRC: ⚠️ Queue full for priority %d - message dropped by AQM\n", app_msg->priority);
     release_message(app_msg);
 }
 
@@ -3390,16 +5962,24 @@ int send_to_queue_l2_with_routing_and_phy(ApplicationMessage *app_msg)
             olsr_trigger_route_discovery(app_msg->dest_node_id);
             rrc_stats.route_discoveries_triggered++;
 
+            // Check if we have a connection context and handle route failure
+            RRC_ConnectionContext *ctx = rrc_get_connection_context(app_msg->dest_node_id);
+            if (ctx && ctx->connection_state == RRC_STATE_RECONFIGURATION)
+            {
+                // Route withdrawn while reconfiguring: hold until the hold timer decides.
+                // L7 hears about the message only if it expires or is dropped.
+                int held = rrc_reconfig_hold_message(ctx, app_msg);
+                release_message(app_msg);
+                return held;
+            }
+
             // Notify application of routing failure
             notify_application_of_failure(app_msg->dest_node_id, "No route available");
 
-            // Check if we have a connection context and handle route failure
-            RRC_ConnectionContext *ctx = rrc_get_connection_context(app_msg->dest_node_id);
             if (ctx && ctx->connection_state == RRC_STATE_CONNECTION_SETUP)
             {
                 // Setup failed due to no route - return to IDLE
-                rrc_transition_to_state(RRC_STATE_IDLE, app_msg->dest_node_id);
-                rrc_release_connection_context(app_msg->dest_node_id);
+                rrc_handle_route_lost(app_msg->dest_node_id);
             }
 
             release_message(app_msg);
@@ -3408,10 +5988,10 @@ int send_to_queue_l2_with_routing_and_phy(ApplicationMessage *app_msg)
 
         // Check for route changes in existing connections
         RRC_ConnectionContext *ctx = rrc_get_connection_context(app_msg->dest_node_id);
-        if (ctx && ctx->connection_state == RRC_STATE_CONNECTED && ctx->next_hop_id != next_hop)
+        if (ctx && ctx->connection_state == RRC_STATE_CONNECTED && rrc_connection_next_hop(ctx) != next_hop)
         {
             printf("RRC: Route change detected for node %u: %u → %u\n",
-                   app_msg->dest_node_id, ctx->next_hop_id, next_hop);
+                   app_msg->dest_node_id, rrc_connection_next_hop(ctx), next_hop);
             rrc_handle_route_change(app_msg->dest_node_id, next_hop);
         }
 
@@ -3419,7 +5999,8 @@ int send_to_queue_l2_with_routing_and_phy(ApplicationMessage *app_msg)
         update_phy_metrics_for_node(next_hop);
 
         // Check PHY link quality to next hop
-        if (!is_link_quality_good(next_hop))
+        bool link_good = is_link_quality_good(next_hop);
+        if (!link_good)
         {
             printf("RRC: Poor link quality to next hop %u, triggering route re-discovery\n", next_hop);
             olsr_trigger_route_discovery(app_msg->dest_node_id);
@@ -3430,15 +6011,30 @@ int send_to_queue_l2_with_routing_and_phy(ApplicationMessage *app_msg)
             {
                 rrc_handle_route_change(app_msg->dest_node_id, next_hop);
             }
+        }
 
+        // Make-before-break: switch once the new path is usable, hold traffic until then
+        if (ctx && ctx->connection_state == RRC_STATE_RECONFIGURATION)
+        {
+            if (!link_good || !rrc_reconfig_try_confirm(ctx, next_hop))
+            {
+                int held = rrc_reconfig_hold_message(ctx, app_msg);
+                release_message(app_msg);
+                return held;
+            }
+        }
+        else if (!link_good)
+        {
             release_message(app_msg);
             return -1;
         }
     }
     else
     {
-        // Broadcast/multicast - use destination as next hop
-        next_hop = app_msg->dest_node_id;
+        // Broadcast/multicast - fan out over the MPR tree / member next hops
+        int result = rrc_mcast_send_application_message(app_msg);
+        release_message(app_msg);
+        return result;
     }
 
     printf("RRC: Routing decision - Dest: %u, Next hop: %u (PHY quality: %s)\n",
@@ -3449,7 +6045,7 @@ int send_to_queue_l2_with_routing_and_phy(ApplicationMessage *app_msg)
     RRC_ConnectionContext *ctx = rrc_get_connection_context(app_msg->dest_node_id);
     if (ctx)
     {
-        ctx->next_hop_id = next_hop;
+        rrc_connection_set_next_hop(ctx, next_hop);
         rrc_update_connection_activity(app_msg->dest_node_id);
     }
 
@@ -3575,8 +6171,8 @@ int rrc_process_application_packet(const CustomApplicationPacket *packet)
         return -1;
     }
 
-    // Trigger data request event if we're in IDLE state
-    if (current_rrc_state == RRC_STATE_IDLE)
+    // Trigger data request event if this destination has no connection yet
+    if (!rrc_get_connection_context(packet->dest_id))
     {
         MessagePriority qos = map_data_type_to_priority(packet->data_type, packet->urgent);
         int result = rrc_handle_data_request(packet->dest_id, qos);
@@ -3621,7 +6217,7 @@ int rrc_process_application_packet(const CustomApplicationPacket *packet)
         // Successful transmission - ensure we're in CONNECTED state
         if (ctx->connection_state == RRC_STATE_CONNECTION_SETUP)
         {
-            rrc_handle_route_and_slots_allocated(packet->dest_id, ctx->next_hop_id);
+            rrc_handle_route_and_slots_allocated(packet->dest_id, rrc_connection_next_hop(ctx));
         }
     }
 
@@ -3653,6 +6249,18 @@ void print_rrc_stats(void)
     // Print Relay queue statistics
     print_relay_stats();
 
+    // Print multicast fan-out statistics
+    print_mcast_stats();
+
+    // Print AQM statistics
+    print_aqm_stats();
+
+    // Print timer wheel statistics
+    print_timer_stats();
+
+    // Print reconfiguration statistics
+    print_reconfig_stats();
+
     // Print NC reservation priority status
     print_nc_reservation_priority_status();
 }
@@ -3709,14 +6317,26 @@ void update_neighbor_capabilities(uint8_t node_id, bool tx_capable, bool rx_capa
     }
 }
 
-// Cleanup stale neighbors periodically using NeighborState
+// Mark neighbor as inactive and free its slot
+void rrc_deactivate_neighbor(NeighborState *neighbor)
+{
+    printf("RRC: Deactivated stale neighbor %u\n", neighbor->nodeID);
+    if (neighbor->nodeID < 256)
+    {
+        neighbor_index[neighbor->nodeID] = RRC_NODE_INDEX_NONE;
+        rrc_timer_cancel(RRC_TIMER_NEIGHBOR_EXPIRY, (uint8_t)neighbor->nodeID);
+    }
+    neighbor->active = false;
+    neighbor->nodeID = 0; // Clear node ID
+}
+
+// Full sweep of the neighbor table; periodic expiry runs on the timer wheel
 void cleanup_stale_neighbors(void)
 {
     if (!neighbor_tracking_initialized)
         return;
 
     uint64_t current_time = (uint64_t)time(NULL);
-    const uint64_t NEIGHBOR_TIMEOUT_SEC = 60; // 60 seconds timeout
 
     // Check NeighborState table instead of undefined neighbor_capabilities
     for (int i = 0; i < neighbor_count; i++)
@@ -3725,16 +6345,11 @@ void cleanup_stale_neighbors(void)
         if (neighbor->active && neighbor->nodeID != 0)
         {
             uint64_t age = current_time - neighbor->lastHeardTime;
-            if (age > NEIGHBOR_TIMEOUT_SEC)
+            if (age > RRC_NEIGHBOR_TIMEOUT_SEC)
             {
                 printf("RRC: Neighbor %u timed out after %llu seconds\n",
                        neighbor->nodeID, age);
-
-                // Mark neighbor as inactive
-                neighbor->active = false;
-                neighbor->nodeID = 0; // Clear node ID
-
-                printf("RRC: Deactivated stale neighbor %u\n", neighbor->nodeID);
+                rrc_deactivate_neighbor(neighbor);
             }
         }
     }
@@ -3972,13 +6587,28 @@ int rrc_process_uplink_frame(struct frame *received_frame)
     // Route based on frame type
     if (received_frame->rx_or_l3)
     {
-        // L3 control frame - forward to OLSR
+        // L3 control frame - forward to OLSR (OLSR runs its own duplicate set)
         return forward_olsr_packet_to_l3(received_frame);
     }
     else
     {
+        // Drop copies already heard from another neighbor or looped back
+        if (rrc_dup_cache_test_and_set(received_frame->source_add, received_frame->sequence_number,
+                                       RRC_DUP_FLAG_RECEIVED))
+        {
+            printf("RRC: Suppressing duplicate frame %u/%u\n",
+                   received_frame->source_add, received_frame->sequence_number);
+            relay_stats.uplink_duplicates_suppressed++;
+            return 0;
+        }
+
         // Application data frame - check if for self or relay
-        if (is_packet_for_self(received_frame))
+        if (rrc_is_broadcast_addr(received_frame->dest_add) ||
+            rrc_is_mcast_group_addr(received_frame->dest_add))
+        {
+            return rrc_mcast_process_uplink_frame(received_frame);
+        }
+        else if (is_packet_for_self(received_frame))
         {
             // Packet is for this node - deliver to L7
             relay_stats.relay_packets_to_self++;
@@ -4271,6 +6901,7 @@ void rrc_initialize_piggyback(uint8_t node_id, uint8_t session_id, uint8_t traff
 
     piggyback_active = true;
     piggyback_last_update = (uint32_t)time(NULL);
+    rrc_timer_arm(RRC_TIMER_PIGGYBACK_TTL, 0, RRC_PIGGYBACK_TTL_TICK_MS);
 
     printf("RRC EXTENSION: Piggyback TLV initialized successfully\n");
 }
@@ -4284,6 +6915,7 @@ void rrc_clear_piggyback(void)
     rrc_init_piggyback_tlv();
     piggyback_active = false;
     piggyback_last_update = 0;
+    rrc_timer_cancel(RRC_TIMER_PIGGYBACK_TTL, 0);
 
     printf("RRC EXTENSION: Piggyback TLV cleared\n");
 }
@@ -4381,7 +7013,7 @@ void rrc_generate_slot_status(SlotStatusInfo slot_status[10])
     // Update based on connection pool data
     for (int i = 0; i < RRC_CONNECTION_POOL_SIZE; i++)
     {
-        if (connection_pool[i].active)
+        if (connection_hot.active[i])
         {
             for (int j = 0; j < 4; j++)
             {
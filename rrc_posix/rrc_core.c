@@ -5,6 +5,7 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <stdarg.h>
 #include <string.h>
 #include <unistd.h>
 #include <signal.h>
@@ -116,7 +117,8 @@ int init_rrc_core(void) {
     };
     
     for (int i = 0; i < 7; i++) {
-        if (mq_init(&mq_datatype_queues[i], dt_queues[i], O_WRONLY, true) < 0) {
+        // Non-blocking: a missing or slow PHY reader must not stall RRC
+        if (mq_init(&mq_datatype_queues[i], dt_queues[i], O_WRONLY | O_NONBLOCK, true) < 0) {
             fprintf(stderr, "[RRC] Failed to init datatype queue %d\n", i);
             return -1;
         }
@@ -154,6 +156,25 @@ void cleanup_rrc_core(void) {
 // APP -> RRC MESSAGE HANDLER
 // ============================================================================
 
+/**
+ * Report a dropped app packet; request_id echoes the app's AppToRrcMsg
+ */
+static void send_app_error(uint32_t request_id, ErrorCode code, const char* fmt, ...) {
+    RrcToAppMsg err_msg;
+    va_list args;
+    
+    init_message_header(&err_msg.header, MSG_RRC_TO_APP_ERROR);
+    err_msg.header.request_id = request_id;  // Correlation
+    err_msg.pool_index = 0;
+    err_msg.generation = 0;
+    err_msg.is_error = 1;
+    err_msg.error_code = code;
+    va_start(args, fmt);
+    vsnprintf(err_msg.error_text, sizeof(err_msg.error_text), fmt, args);
+    va_end(args);
+    mq_send_msg(&mq_rrc_to_app, &err_msg, sizeof(err_msg), 0);
+}
+
 void handle_app_to_rrc_message(void) {
     AppToRrcMsg msg;
     unsigned int priority;
@@ -190,13 +211,8 @@ void handle_app_to_rrc_message(void) {
     if (mq_send_msg(&mq_rrc_to_olsr, &olsr_req, sizeof(olsr_req), priority) < 0) {
         fprintf(stderr, "[RRC] Failed to send OLSR route request\n");
         // Send error to app
-        RrcToAppMsg err_msg;
-        init_message_header(&err_msg.header, MSG_RRC_TO_APP_ERROR);
-        err_msg.is_error = 1;
-        err_msg.error_code = ERROR_OLSR_NO_ROUTE;
-        snprintf(err_msg.error_text, sizeof(err_msg.error_text), 
-                 "OLSR: Failed to send route request");
-        mq_send_msg(&mq_rrc_to_app, &err_msg, sizeof(err_msg), 0);
+        app_pool_release(&app_pool, msg.pool_index);
+        send_app_error(msg.header.request_id, ERROR_OLSR_NO_ROUTE, "OLSR: Failed to send route request");
         return;
     }
     
@@ -209,28 +225,19 @@ void handle_app_to_rrc_message(void) {
     
     if (bytes == -2) {  // Timeout
         fprintf(stderr, "[RRC] OLSR route request timeout\n");
-        RrcToAppMsg err_msg;
-        init_message_header(&err_msg.header, MSG_RRC_TO_APP_ERROR);
-        err_msg.is_error = 1;
-        err_msg.error_code = ERROR_TIMEOUT;
-        snprintf(err_msg.error_text, sizeof(err_msg.error_text), 
-                 "OLSR: Route request timeout");
-        mq_send_msg(&mq_rrc_to_app, &err_msg, sizeof(err_msg), 0);
+        app_pool_release(&app_pool, msg.pool_index);
+        send_app_error(msg.header.request_id, ERROR_TIMEOUT, "OLSR: Route request timeout");
         return;
     } else if (bytes < 0) {  // Error
         fprintf(stderr, "[RRC] OLSR communication error\n");
+        app_pool_release(&app_pool, msg.pool_index);
         return;
     }
     
     if (olsr_rsp.status != 0) {  // No route found
         fprintf(stderr, "[RRC] OLSR: No route to dest=%d\n", dest_id);
-        RrcToAppMsg err_msg;
-        init_message_header(&err_msg.header, MSG_RRC_TO_APP_ERROR);
-        err_msg.is_error = 1;
-        err_msg.error_code = ERROR_OLSR_NO_ROUTE;
-        snprintf(err_msg.error_text, sizeof(err_msg.error_text), 
-                 "OLSR: No route found to node %d", dest_id);
-        mq_send_msg(&mq_rrc_to_app, &err_msg, sizeof(err_msg), 0);
+        app_pool_release(&app_pool, msg.pool_index);
+        send_app_error(msg.header.request_id, ERROR_OLSR_NO_ROUTE, "OLSR: No route found to node %d", dest_id);
         return;
     }
     
@@ -248,13 +255,8 @@ void handle_app_to_rrc_message(void) {
     
     if (mq_send_msg(&mq_rrc_to_tdma, &tdma_req, sizeof(tdma_req), priority) < 0) {
         fprintf(stderr, "[RRC] Failed to send TDMA slot check\n");
-        RrcToAppMsg err_msg;
-        init_message_header(&err_msg.header, MSG_RRC_TO_APP_ERROR);
-        err_msg.is_error = 1;
-        err_msg.error_code = ERROR_TDMA_SLOT_UNAVAILABLE;
-        snprintf(err_msg.error_text, sizeof(err_msg.error_text), 
-                 "TDMA: Failed to send slot check");
-        mq_send_msg(&mq_rrc_to_app, &err_msg, sizeof(err_msg), 0);
+        app_pool_release(&app_pool, msg.pool_index);
+        send_app_error(msg.header.request_id, ERROR_TDMA_SLOT_UNAVAILABLE, "TDMA: Failed to send slot check");
         return;
     }
     
@@ -267,45 +269,50 @@ void handle_app_to_rrc_message(void) {
     
     if (bytes == -2) {  // Timeout
         fprintf(stderr, "[RRC] TDMA slot check timeout\n");
-        RrcToAppMsg err_msg;
-        init_message_header(&err_msg.header, MSG_RRC_TO_APP_ERROR);
-        err_msg.is_error = 1;
-        err_msg.error_code = ERROR_TIMEOUT;
-        snprintf(err_msg.error_text, sizeof(err_msg.error_text), 
-                 "TDMA: Slot check timeout");
-        mq_send_msg(&mq_rrc_to_app, &err_msg, sizeof(err_msg), 0);
+        app_pool_release(&app_pool, msg.pool_index);
+        send_app_error(msg.header.request_id, ERROR_TIMEOUT, "TDMA: Slot check timeout");
         return;
     } else if (bytes < 0) {
         fprintf(stderr, "[RRC] TDMA communication error\n");
+        app_pool_release(&app_pool, msg.pool_index);
         return;
     }
     
     if (!tdma_rsp.success) {  // No slot available
         fprintf(stderr, "[RRC] TDMA: No slot available for next_hop=%d\n", 
                 olsr_rsp.next_hop);
-        RrcToAppMsg err_msg;
-        init_message_header(&err_msg.header, MSG_RRC_TO_APP_ERROR);
-        err_msg.is_error = 1;
-        err_msg.error_code = ERROR_TDMA_SLOT_UNAVAILABLE;
-        snprintf(err_msg.error_text, sizeof(err_msg.error_text), 
-                 "TDMA: No slot available for next hop");
-        mq_send_msg(&mq_rrc_to_app, &err_msg, sizeof(err_msg), 0);
+        app_pool_release(&app_pool, msg.pool_index);
+        send_app_error(msg.header.request_id, ERROR_TDMA_SLOT_UNAVAILABLE, "TDMA: No slot available for next hop");
         return;
     }
     
     printf("[RRC] TDMA slot available: slot=%d\n", tdma_rsp.assigned_slot);
     
-    // Step 3: Allocate frame pool entry and build RRC frame
-    int frame_idx = frame_pool_alloc(&frame_pool);
+    // Step 3: Allocate frame pool entry and build RRC frame.
+    // Under congestion delta frames go first: a discardable packet is dropped
+    // above the high watermark, and a keyframe may reclaim a delta frame's entry.
+    int frame_idx = -1;
+    if ((app_pkt->flags & FRAME_FLAG_DISCARDABLE) &&
+        frame_pool_in_use(&frame_pool) >= FRAME_POOL_HIGH_WATERMARK) {
+        printf("[RRC] Congested, dropping discardable frame seq=%u\n",
+               app_pkt->sequence_number);
+        app_pool_release(&app_pool, msg.pool_index);
+        send_app_error(msg.header.request_id, ERROR_BUFFER_FULL, "RRC: Congested, discardable frame dropped");
+        return;
+    }
+    
+    frame_idx = frame_pool_alloc(&frame_pool);
+    if (frame_idx < 0 && !(app_pkt->flags & FRAME_FLAG_DISCARDABLE)) {
+        frame_idx = frame_pool_evict_discardable(&frame_pool);
+        if (frame_idx >= 0) {
+            printf("[RRC] Frame pool full, evicted discardable frame at pool_index=%d\n",
+                   frame_idx);
+        }
+    }
     if (frame_idx < 0) {
         fprintf(stderr, "[RRC] Frame pool full\n");
-        RrcToAppMsg err_msg;
-        init_message_header(&err_msg.header, MSG_RRC_TO_APP_ERROR);
-        err_msg.is_error = 1;
-        err_msg.error_code = ERROR_BUFFER_FULL;
-        snprintf(err_msg.error_text, sizeof(err_msg.error_text), 
-                 "RRC: Frame pool full");
-        mq_send_msg(&mq_rrc_to_app, &err_msg, sizeof(err_msg), 0);
+        app_pool_release(&app_pool, msg.pool_index);
+        send_app_error(msg.header.request_id, ERROR_BUFFER_FULL, "RRC: Frame pool full");
         return;
     }
     
@@ -319,8 +326,8 @@ void handle_app_to_rrc_message(void) {
     frame.payload_len = app_pkt->payload_len;
     frame.sequence_number = app_pkt->sequence_number;
     frame.timestamp_ms = get_timestamp_ms();
+    frame.flags = app_pkt->flags;
     memcpy(frame.payload, app_pkt->payload, app_pkt->payload_len);
-    frame.in_use = true;
     frame.valid = true;
     
     frame_pool_set(&frame_pool, frame_idx, &frame);
@@ -328,10 +335,29 @@ void handle_app_to_rrc_message(void) {
     printf("[RRC] Built RRC frame at pool_index=%d: src=%d, dest=%d, next_hop=%d\n",
            frame_idx, src_id, dest_id, olsr_rsp.next_hop);
     
-    // Step 4: Route to PHY layer via data-type-specific queue
-    // (In real implementation, PHY would read from frame pool)
-    // For demo, we just log it
-    printf("[RRC] Frame ready for PHY transmission at pool_index=%d\n", frame_idx);
+    // Step 4: Route to PHY layer via data-type-specific queue.
+    // A queued RrcToPhyMsg hands the frame over: the PHY reader (mac_sim, or
+    // rrc_pipeline_bench) releases it by generation once sent. RRC keeps it
+    // only if the send fails, or by evicting it under congestion.
+    RrcToPhyMsg phy_msg;
+    init_message_header(&phy_msg.header, MSG_RRC_TO_PHY_TX_FRAME);
+    phy_msg.header.request_id = msg.header.request_id;  // Correlation
+    phy_msg.pool_index = frame_idx;
+    phy_msg.generation = frame_pool_generation(&frame_pool, frame_idx);
+    phy_msg.next_hop = olsr_rsp.next_hop;
+    phy_msg.assigned_slot = tdma_rsp.assigned_slot;
+    
+    int dt_index = frame.data_type <= DATA_TYPE_PTT ? frame.data_type : 6;
+    if (mq_send_msg(&mq_datatype_queues[dt_index], &phy_msg, sizeof(phy_msg), priority) < 0) {
+        // PHY queue full or no reader: nobody will release the frame, so drop it here
+        fprintf(stderr, "[RRC] PHY queue for dtype=%d unavailable, dropping frame at pool_index=%d\n",
+                dt_index, frame_idx);
+        frame_pool_release_gen(&frame_pool, frame_idx, phy_msg.generation);
+        app_pool_release(&app_pool, msg.pool_index);
+        send_app_error(msg.header.request_id, ERROR_BUFFER_FULL, "RRC: PHY queue full");
+        return;
+    }
+    printf("[RRC] Frame queued for PHY at pool_index=%d, dtype=%d\n", frame_idx, dt_index);
     
     // Release app pool entry
     app_pool_release(&app_pool, msg.pool_index);
@@ -356,7 +382,7 @@ void handle_mac_to_rrc_message(void) {
     
     // Get frame from MAC RX pool
     FramePoolEntry* frame = frame_pool_get(&mac_rx_pool, msg.pool_index);
-    if (!frame || !frame->in_use || !frame->valid) {
+    if (!frame || !frame_pool_entry_in_use(frame) || !frame->valid) {
         fprintf(stderr, "[RRC] Invalid MAC RX frame at pool_index=%d\n", msg.pool_index);
         return;
     }
@@ -386,6 +412,7 @@ void handle_mac_to_rrc_message(void) {
     RrcToAppMsg app_msg;
     init_message_header(&app_msg.header, MSG_RRC_TO_APP_FRAME);
     app_msg.pool_index = deliver_idx;
+    app_msg.generation = frame_pool_generation(&frame_pool, deliver_idx);
     app_msg.is_error = 0;
     app_msg.error_code = 0;
     memset(app_msg.error_text, 0, sizeof(app_msg.error_text));
@@ -0,0 +1,51 @@
+/**
+ * Futex doorbell shared by the RRC rings
+ * A doorbell is a 32-bit sequence word in shared memory: the publisher
+ * bumps it and wakes sleepers, a consumer snapshots it, rechecks its ring,
+ * and sleeps only while the word still holds the snapshot
+ */
+
+#ifndef RRC_DOORBELL_H
+#define RRC_DOORBELL_H
+
+#include <stdint.h>
+#include <limits.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+
+// Shared futex (no FUTEX_PRIVATE_FLAG): the two sides of every doorbell
+// live in separate processes
+static inline long rrc_futex(uint32_t* addr, int op, uint32_t val, const struct timespec* timeout) {
+    return syscall(SYS_futex, addr, op, val, timeout, NULL, 0);
+}
+
+/**
+ * Bump the sequence and wake every sleeper
+ * @param waiters Sleeper count kept next to seq; the syscall is skipped when
+ *                it is zero. NULL if the layout has none: always wake
+ */
+static inline void rrc_doorbell_ring(uint32_t* seq, uint32_t* waiters) {
+    __atomic_add_fetch(seq, 1, __ATOMIC_SEQ_CST);
+    if (!waiters || __atomic_load_n(waiters, __ATOMIC_SEQ_CST) > 0) {
+        rrc_futex(seq, FUTEX_WAKE, INT_MAX, NULL);
+    }
+}
+
+/**
+ * Sleep while *seq still equals seen
+ * @param waiters Sleeper count to register in, NULL if the layout has none
+ * @param timeout Relative timeout, NULL to wait indefinitely
+ * @return The futex result: 0 after a wakeup (possibly spurious), -1 with
+ *         errno EAGAIN (already moved), ETIMEDOUT, EINTR, ...
+ */
+static inline long rrc_doorbell_wait(uint32_t* seq, uint32_t* waiters, uint32_t seen,
+                                     const struct timespec* timeout) {
+    if (waiters) __atomic_add_fetch(waiters, 1, __ATOMIC_SEQ_CST);
+    long rc = rrc_futex(seq, FUTEX_WAIT, seen, timeout);
+    if (waiters) __atomic_sub_fetch(waiters, 1, __ATOMIC_SEQ_CST);  // Atomic builtins leave errno alone
+    return rc;
+}
+
+#endif // RRC_DOORBELL_H
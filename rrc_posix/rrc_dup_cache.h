@@ -0,0 +1,161 @@
+/**
+ * Duplicate Detection Cache for the RRC uplink and relay paths
+ *
+ * Remembers every sequenced (source, seq) pair for RRC_DUP_HOLD_TIME_SEC,
+ * with separate RECEIVED and FORWARDED flags as in the RFC 3626 duplicate
+ * set: a frame heard twice is processed once, and a frame is queued for
+ * retransmission at most once even if it reaches the relay path again.
+ * Open addressing with a bounded linear probe; expired slots are reused in
+ * place, so ageing needs no periodic sweep.
+ *
+ * Times are whole seconds supplied by the caller. Not thread-safe.
+ */
+
+#ifndef RRC_DUP_CACHE_H
+#define RRC_DUP_CACHE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#define RRC_DUP_CACHE_SIZE 1024      // Power of two
+#define RRC_DUP_PROBE_LIMIT 16
+#define RRC_DUP_HOLD_TIME_SEC 30     // RFC 3626 DUP_HOLD_TIME
+#define RRC_DUP_FLAG_RECEIVED 0x01   // Already processed on the uplink
+#define RRC_DUP_FLAG_FORWARDED 0x02  // Already queued for retransmission
+
+// (source, seq) entry; expires == 0 marks a never-used slot
+typedef struct
+{
+    uint8_t source;
+    uint8_t flags;
+    uint16_t seq;
+    uint32_t expires;
+} RRC_DupEntry;
+
+typedef struct
+{
+    RRC_DupEntry entries[RRC_DUP_CACHE_SIZE];
+    uint32_t evictions;              // Live entries pushed out by a full probe window
+} RRC_DupCache;
+
+static inline void rrc_dup_cache_clear(RRC_DupCache *cache)
+{
+    memset(cache, 0, sizeof(*cache));
+}
+
+static inline uint32_t rrc_dup_cache_index(uint8_t source, uint16_t seq)
+{
+    uint32_t hash = ((uint32_t)source * 0x9E3779B1u) ^ ((uint32_t)seq * 0x85EBCA6Bu);
+    return (hash ^ (hash >> 16)) & (RRC_DUP_CACHE_SIZE - 1);
+}
+
+// Live entry for (source, seq), or NULL; never inserts
+static inline RRC_DupEntry *rrc_dup_cache_find(RRC_DupCache *cache, uint8_t source, uint16_t seq,
+                                               uint32_t now)
+{
+    uint32_t index = rrc_dup_cache_index(source, seq);
+
+    for (int probe = 0; probe < RRC_DUP_PROBE_LIMIT; probe++)
+    {
+        RRC_DupEntry *entry = &cache->entries[(index + probe) & (RRC_DUP_CACHE_SIZE - 1)];
+
+        if (entry->expires == 0)
+            break;
+        if (entry->expires > now && entry->source == source && entry->seq == seq)
+            return entry;
+    }
+    return NULL;
+}
+
+static inline RRC_DupEntry *rrc_dup_cache_lookup_or_insert(RRC_DupCache *cache, uint8_t source,
+                                                           uint16_t seq, uint32_t now)
+{
+    uint32_t index = rrc_dup_cache_index(source, seq);
+    RRC_DupEntry *reuse = NULL;
+    RRC_DupEntry *oldest = NULL;
+
+    for (int probe = 0; probe < RRC_DUP_PROBE_LIMIT; probe++)
+    {
+        RRC_DupEntry *entry = &cache->entries[(index + probe) & (RRC_DUP_CACHE_SIZE - 1)];
+
+        if (entry->expires == 0)
+        {
+            if (!reuse)
+                reuse = entry;
+            break;
+        }
+
+        if (entry->expires > now)
+        {
+            if (entry->source == source && entry->seq == seq)
+                return entry;
+        }
+        else if (!reuse)
+        {
+            reuse = entry;
+        }
+
+        if (!oldest || entry->expires < oldest->expires)
+            oldest = entry;
+    }
+
+    if (!reuse)
+    {
+        // Probe window full of live entries: evict the one closest to expiry
+        reuse = oldest;
+        cache->evictions++;
+    }
+
+    reuse->source = source;
+    reuse->seq = seq;
+    reuse->flags = 0;
+    reuse->expires = now + RRC_DUP_HOLD_TIME_SEC;
+    return reuse;
+}
+
+/**
+ * Set flag on the (source, seq) entry, creating it if needed.
+ * Unsequenced frames (seq 0) are never treated as duplicates.
+ * @return true if the flag was already set (duplicate)
+ */
+static inline bool rrc_dup_cache_test_and_set_at(RRC_DupCache *cache, uint8_t source, uint16_t seq,
+                                                 uint8_t flag, uint32_t now)
+{
+    if (seq == 0)
+        return false;
+
+    RRC_DupEntry *entry = rrc_dup_cache_lookup_or_insert(cache, source, seq, now);
+    if (entry->flags & flag)
+        return true;
+
+    entry->flags |= flag;
+    return false;
+}
+
+/**
+ * Check flag without setting it or creating an entry. Use with
+ * rrc_dup_cache_set_at() when the flag must only stick once the action it
+ * records has succeeded (e.g. FORWARDED after a successful enqueue), so a
+ * failed attempt can be retried by a later copy of the frame.
+ */
+static inline bool rrc_dup_cache_test_at(RRC_DupCache *cache, uint8_t source, uint16_t seq,
+                                         uint8_t flag, uint32_t now)
+{
+    if (seq == 0)
+        return false;
+
+    const RRC_DupEntry *entry = rrc_dup_cache_find(cache, source, seq, now);
+    return entry && (entry->flags & flag) != 0;
+}
+
+static inline void rrc_dup_cache_set_at(RRC_DupCache *cache, uint8_t source, uint16_t seq,
+                                        uint8_t flag, uint32_t now)
+{
+    if (seq == 0)
+        return;
+
+    rrc_dup_cache_lookup_or_insert(cache, source, seq, now)->flags |= flag;
+}
+
+#endif // RRC_DUP_CACHE_H
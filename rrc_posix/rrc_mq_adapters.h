@@ -1,18 +1,95 @@
 /**
  * POSIX Message Queue Adapter Layer for RRC Integration
  * Wrappers for mq_open, mq_send, mq_receive with timeout support
+ *
+ * Every queue runs on one of two backends, picked by whoever creates it:
+ * a kernel POSIX message queue, or a shared-memory ring for high-rate
+ * queues. Processes that attach find out which one exists and follow it,
+ * so only the creator needs configuring.
  */
 
 #ifndef RRC_MQ_ADAPTERS_H
 #define RRC_MQ_ADAPTERS_H
 
 #include "rrc_posix_mq_defs.h"
+#include "rrc_doorbell.h"
 #include <mqueue.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <errno.h>
 #include <time.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+_Static_assert(sizeof(AppToRrcMsg) <= MQ_CONTROL_MSG_SIZE, "AppToRrcMsg exceeds control queue size");
+_Static_assert(sizeof(RrcToAppMsg) <= MQ_CONTROL_MSG_SIZE, "RrcToAppMsg exceeds control queue size");
+_Static_assert(sizeof(RrcToOlsrMsg) <= MQ_CONTROL_MSG_SIZE, "RrcToOlsrMsg exceeds control queue size");
+_Static_assert(sizeof(OlsrToRrcMsg) <= MQ_CONTROL_MSG_SIZE, "OlsrToRrcMsg exceeds control queue size");
+_Static_assert(sizeof(RrcToTdmaMsg) <= MQ_CONTROL_MSG_SIZE, "RrcToTdmaMsg exceeds control queue size");
+_Static_assert(sizeof(TdmaToRrcMsg) <= MQ_CONTROL_MSG_SIZE, "TdmaToRrcMsg exceeds control queue size");
+_Static_assert(sizeof(MacToRrcMsg) <= MQ_CONTROL_MSG_SIZE, "MacToRrcMsg exceeds control queue size");
+
+// ============================================================================
+// TRANSPORT CONFIGURATION
+// ============================================================================
+
+typedef enum {
+    MQ_BACKEND_POSIX = 0,       // Kernel POSIX message queue
+    MQ_BACKEND_SHM_RING = 1     // Shared-memory ring with a futex doorbell
+} MQBackend;
+
+typedef struct {
+    long max_msgs;              // Queue depth
+    long msg_size;              // Largest message the queue carries
+    MQBackend backend;
+} MQConfig;
+
+/**
+ * One received message, read in place until mq_recv_release()
+ */
+typedef struct {
+    const void* data;
+    size_t len;
+    unsigned int priority;
+} MQMsgView;
+
+// ============================================================================
+// SHARED-MEMORY RING LAYOUT
+// ============================================================================
+
+#define MQ_RING_MAGIC 0x52524352u      // "RRCR", stored last by the creator
+#define MQ_RING_SHM_PREFIX "/rrc_ring_"
+
+/**
+ * Ring header at the start of the shared object; slots follow it.
+ * head and tail run freely and are masked by depth (a power of two).
+ * Producers serialize on producer_lock; there is one consumer per queue.
+ */
+typedef struct {
+    uint32_t magic;
+    uint32_t depth;
+    uint32_t msg_size;
+    uint32_t slot_size;         // Slot header + msg_size, 8-byte aligned
+    uint32_t head;              // Next slot producers fill
+    uint32_t tail;              // Next slot the consumer reads
+    uint32_t data_seq;          // Futex word: bumped on every publish
+    uint32_t data_waiters;
+    uint32_t space_seq;         // Futex word: bumped when slots are freed
+    uint32_t space_waiters;
+    pthread_mutex_t producer_lock;
+} MQRingHeader;
+
+typedef struct {
+    uint32_t len;
+    uint32_t priority;
+} MQRingSlot;
+
+#define MQ_RING_HEADER_BYTES ((sizeof(MQRingHeader) + 63) & ~(size_t)63)
 
 // ============================================================================
 // MESSAGE QUEUE CONTEXT
@@ -21,116 +98,641 @@
 typedef struct {
     mqd_t mqd;
     char mq_name[64];
-    struct mq_attr attr;
+    struct mq_attr attr;        // Depth and message size for either backend
     MQStats stats;
     bool initialized;
     bool is_read;   // true if opened for reading
     bool is_write;  // true if opened for writing
+    MQBackend backend;
+    MQRingHeader* ring;         // SHM_RING: mapped ring
+    size_t ring_bytes;
+    uint8_t* staging;           // POSIX: buffers behind views and reservations
+    int peeked;                 // Views outstanding from mq_recv_peek()
 } MQContext;
 
+/**
+ * Depth, size and backend for a queue created by name
+ * Control queues carry small fixed structs, so they get a deep queue of
+ * MQ_CONTROL_MSG_SIZE messages; RRC_MQ_BACKEND=shm moves them onto rings.
+ * Anything else keeps the original 10 x MAX_MQ_MSG_SIZE POSIX queue.
+ */
+static inline MQConfig mq_queue_config(const char* mq_name) {
+    static const char* control_queues[] = {
+        MQ_APP_TO_RRC, MQ_RRC_TO_APP, MQ_RRC_TO_OLSR, MQ_OLSR_TO_RRC,
+        MQ_RRC_TO_TDMA, MQ_TDMA_TO_RRC, MQ_MAC_TO_RRC
+    };
+    MQConfig cfg = { MQ_DEFAULT_DEPTH, MAX_MQ_MSG_SIZE, MQ_BACKEND_POSIX };
+
+    for (size_t i = 0; i < sizeof(control_queues) / sizeof(control_queues[0]); i++) {
+        if (strcmp(mq_name, control_queues[i]) == 0) {
+            const char* backend = getenv("RRC_MQ_BACKEND");
+            cfg.max_msgs = MQ_CONTROL_DEPTH;
+            cfg.msg_size = MQ_CONTROL_MSG_SIZE;
+            if (backend && strcmp(backend, "shm") == 0) {
+                cfg.backend = MQ_BACKEND_SHM_RING;
+            }
+            break;
+        }
+    }
+    return cfg;
+}
+
+// ============================================================================
+// SHARED-MEMORY RING BACKEND
+// ============================================================================
+
+static inline uint64_t mq_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static inline void mq_ring_name(char* buf, size_t size, const char* mq_name) {
+    snprintf(buf, size, "%s%.63s", MQ_RING_SHM_PREFIX, mq_name[0] == '/' ? mq_name + 1 : mq_name);
+}
+
+/**
+ * Wake sleepers on a sequence word; the syscall is skipped when nobody waits
+ */
+static inline void mq_ring_notify(uint32_t* seq, uint32_t* waiters) {
+    rrc_doorbell_ring(seq, waiters);
+}
+
+/**
+ * Sleep until *seq moves past seen
+ * @param deadline_ns CLOCK_MONOTONIC deadline, 0 to wait indefinitely
+ * @return 0 after a wakeup (possibly spurious), -2 once the deadline has passed
+ */
+static inline int mq_ring_wait(uint32_t* seq, uint32_t* waiters, uint32_t seen,
+                               uint64_t deadline_ns) {
+    struct timespec ts;
+    struct timespec* timeout = NULL;
+
+    if (deadline_ns != 0) {
+        uint64_t now = mq_now_ns();
+        if (now >= deadline_ns) return -2;
+        ts.tv_sec = (deadline_ns - now) / 1000000000ULL;
+        ts.tv_nsec = (deadline_ns - now) % 1000000000ULL;
+        timeout = &ts;
+    }
+
+    rrc_doorbell_wait(seq, waiters, seen, timeout);
+    return 0;
+}
+
+static inline MQRingSlot* mq_ring_slot(MQRingHeader* ring, uint32_t pos) {
+    return (MQRingSlot*)((uint8_t*)ring + MQ_RING_HEADER_BYTES +
+                         (size_t)(pos & (ring->depth - 1)) * ring->slot_size);
+}
+
+/**
+ * Create or attach the ring behind ctx->mq_name
+ * @return 0 on success, -1 on error (errno from shm_open kept on attach)
+ */
+static inline int mq_ring_open(MQContext* ctx, const MQConfig* cfg, bool create_new) {
+    char name[96];
+    int fd;
+    size_t total_size;
+
+    mq_ring_name(name, sizeof(name), ctx->mq_name);
+
+    if (create_new) {
+        uint32_t depth = 1;
+        while (depth < (uint32_t)cfg->max_msgs) depth <<= 1;
+        uint32_t slot_size = (sizeof(MQRingSlot) + (uint32_t)cfg->msg_size + 7) & ~7u;
+        total_size = MQ_RING_HEADER_BYTES + (size_t)depth * slot_size;
+
+        shm_unlink(name);  // Remove any existing
+        fd = shm_open(name, O_CREAT | O_RDWR, 0666);
+        if (fd < 0) {
+            perror("shm_open ring");
+            return -1;
+        }
+        if (ftruncate(fd, total_size) < 0) {
+            perror("ftruncate ring");
+            close(fd);
+            return -1;
+        }
+        ctx->ring = mmap(NULL, total_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        close(fd);
+        if (ctx->ring == MAP_FAILED) {
+            perror("mmap ring");
+            ctx->ring = NULL;
+            return -1;
+        }
+
+        MQRingHeader* ring = ctx->ring;
+        memset(ring, 0, MQ_RING_HEADER_BYTES);
+        ring->depth = depth;
+        ring->msg_size = (uint32_t)cfg->msg_size;
+        ring->slot_size = slot_size;
+
+        pthread_mutexattr_t attr;
+        pthread_mutexattr_init(&attr);
+        pthread_mutexattr_setpshared(&attr, PTHREAD_PROCESS_SHARED);
+        pthread_mutex_init(&ring->producer_lock, &attr);
+        pthread_mutexattr_destroy(&attr);
+
+        __atomic_store_n(&ring->magic, MQ_RING_MAGIC, __ATOMIC_RELEASE);
+    } else {
+        struct stat st;
+
+        fd = shm_open(name, O_RDWR, 0666);
+        if (fd < 0) return -1;
+        if (fstat(fd, &st) < 0 || (size_t)st.st_size < MQ_RING_HEADER_BYTES) {
+            close(fd);
+            errno = EINVAL;
+            return -1;
+        }
+        total_size = st.st_size;
+        ctx->ring = mmap(NULL, total_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        close(fd);
+        if (ctx->ring == MAP_FAILED) {
+            perror("mmap ring");
+            ctx->ring = NULL;
+            return -1;
+        }
+        if (__atomic_load_n(&ctx->ring->magic, __ATOMIC_ACQUIRE) != MQ_RING_MAGIC) {
+            fprintf(stderr, "Ring %s not initialized\n", name);
+            munmap(ctx->ring, total_size);
+            ctx->ring = NULL;
+            errno = EINVAL;
+            return -1;
+        }
+    }
+
+    ctx->ring_bytes = total_size;
+    ctx->mqd = (mqd_t)-1;
+    ctx->backend = MQ_BACKEND_SHM_RING;
+    ctx->attr.mq_maxmsg = ctx->ring->depth;
+    ctx->attr.mq_msgsize = ctx->ring->msg_size;
+    return 0;
+}
+
+/**
+ * Copy count messages of len bytes, stride apart, into the ring
+ * Publishes each run of free slots with one doorbell
+ * @return Number of messages written before the deadline
+ */
+static inline int mq_ring_send(MQContext* ctx, const uint8_t* msgs, size_t stride, size_t len,
+                               int count, unsigned int priority, uint64_t deadline_ns) {
+    MQRingHeader* ring = ctx->ring;
+    int sent = 0;
+
+    while (sent < count) {
+        uint32_t seen = __atomic_load_n(&ring->space_seq, __ATOMIC_SEQ_CST);
+
+        pthread_mutex_lock(&ring->producer_lock);
+        uint32_t head = ring->head;
+        uint32_t room = ring->depth - (head - __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE));
+        uint32_t n = room < (uint32_t)(count - sent) ? room : (uint32_t)(count - sent);
+
+        for (uint32_t i = 0; i < n; i++) {
+            MQRingSlot* slot = mq_ring_slot(ring, head + i);
+            slot->len = (uint32_t)len;
+            slot->priority = priority;
+            memcpy(slot + 1, msgs + (size_t)(sent + i) * stride, len);
+        }
+        if (n > 0) {
+            __atomic_store_n(&ring->head, head + n, __ATOMIC_RELEASE);
+        }
+        pthread_mutex_unlock(&ring->producer_lock);
+
+        if (n > 0) {
+            mq_ring_notify(&ring->data_seq, &ring->data_waiters);
+            sent += n;
+        } else if (mq_ring_wait(&ring->space_seq, &ring->space_waiters, seen, deadline_ns) < 0) {
+            break;
+        }
+    }
+    return sent;
+}
+
+/**
+ * Expose up to max queued messages in place
+ * @param timeout_ms -1 waits indefinitely, 0 polls
+ * @return Number of views filled, 0 if none arrived in time
+ */
+static inline int mq_ring_peek(MQContext* ctx, MQMsgView* views, int max, int timeout_ms) {
+    MQRingHeader* ring = ctx->ring;
+    uint64_t deadline_ns = timeout_ms > 0 ? mq_now_ns() + (uint64_t)timeout_ms * 1000000ULL : 0;
+
+    for (;;) {
+        uint32_t seen = __atomic_load_n(&ring->data_seq, __ATOMIC_SEQ_CST);
+        uint32_t tail = ring->tail;
+        uint32_t avail = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE) - tail;
+
+        if (avail > 0) {
+            int n = avail < (uint32_t)max ? (int)avail : max;
+            for (int i = 0; i < n; i++) {
+                MQRingSlot* slot = mq_ring_slot(ring, tail + i);
+                views[i].data = slot + 1;
+                views[i].len = slot->len;
+                views[i].priority = slot->priority;
+            }
+            return n;
+        }
+        if (timeout_ms == 0 ||
+            mq_ring_wait(&ring->data_seq, &ring->data_waiters, seen, deadline_ns) < 0) {
+            return 0;
+        }
+    }
+}
+
+// ============================================================================
+// POSIX BACKEND
+// ============================================================================
+
+/**
+ * Read a value from /proc/sys/fs/mqueue, or fallback if unavailable
+ */
+static inline long mq_system_limit(const char* path, long fallback) {
+    FILE* f = fopen(path, "r");
+    long value;
+
+    if (!f) return fallback;
+    if (fscanf(f, "%ld", &value) != 1) value = fallback;
+    fclose(f);
+    return value;
+}
+
+/**
+ * Receive up to max messages into the staging area
+ * Only the first receive waits; the rest drain with an already-expired
+ * timeout, so a batch never blocks once something has arrived.
+ * @param timeout_ms -1 waits indefinitely, 0 polls
+ * @return Number of views filled, 0 if none arrived in time, -1 on error
+ */
+static inline int mq_posix_peek(MQContext* ctx, MQMsgView* views, int max, int timeout_ms) {
+    const struct timespec expired = { 0, 0 };
+    size_t slot_size = ctx->attr.mq_msgsize;
+    int n = 0;
+
+    while (n < max) {
+        char* buf = (char*)ctx->staging + (size_t)n * slot_size;
+        unsigned int priority = 0;
+        ssize_t bytes;
+
+        if (n == 0 && timeout_ms < 0) {
+            bytes = mq_receive(ctx->mqd, buf, slot_size, &priority);
+        } else if (n == 0 && timeout_ms > 0) {
+            struct timespec abs_timeout;
+            clock_gettime(CLOCK_REALTIME, &abs_timeout);
+            abs_timeout.tv_sec += timeout_ms / 1000;
+            abs_timeout.tv_nsec += (timeout_ms % 1000) * 1000000;
+            if (abs_timeout.tv_nsec >= 1000000000) {
+                abs_timeout.tv_sec++;
+                abs_timeout.tv_nsec -= 1000000000;
+            }
+            bytes = mq_timedreceive(ctx->mqd, buf, slot_size, &priority, &abs_timeout);
+        } else {
+            bytes = mq_timedreceive(ctx->mqd, buf, slot_size, &priority, &expired);
+        }
+
+        if (bytes < 0) {
+            if (errno == ETIMEDOUT || errno == EAGAIN) break;
+            if (n == 0) {
+                ctx->stats.error_count++;
+                return -1;
+            }
+            break;
+        }
+
+        views[n].data = buf;
+        views[n].len = bytes;
+        views[n].priority = priority;
+        n++;
+    }
+    return n;
+}
+
 // ============================================================================
 // MESSAGE QUEUE INITIALIZATION
 // ============================================================================
 
 /**
- * Initialize POSIX message queue
+ * Initialize a queue with explicit depth, message size and backend
  * @param ctx Message queue context
  * @param mq_name Queue name (e.g., MQ_APP_TO_RRC)
  * @param flags O_RDONLY, O_WRONLY, or O_RDWR
- * @param create_new If true, create with O_CREAT
+ * @param create_new If true, create per cfg; if false, attach to whichever
+ *        backend the creator chose (cfg is ignored)
+ * @param cfg Queue configuration, NULL for mq_queue_config(mq_name)
  * @return 0 on success, -1 on error
  */
-static inline int mq_init(MQContext* ctx, const char* mq_name, int flags, bool create_new) {
+static inline int mq_init_config(MQContext* ctx, const char* mq_name, int flags,
+                                 bool create_new, const MQConfig* cfg) {
     if (!ctx || !mq_name) return -1;
-    
+
+    MQConfig defaults = mq_queue_config(mq_name);
+    if (!cfg) cfg = &defaults;
+    if (cfg->max_msgs <= 0 || cfg->msg_size <= 0 || cfg->msg_size > MAX_MQ_MSG_SIZE) {
+        fprintf(stderr, "Invalid queue config for %s\n", mq_name);
+        return -1;
+    }
+
     memset(ctx, 0, sizeof(MQContext));
     strncpy(ctx->mq_name, mq_name, sizeof(ctx->mq_name) - 1);
-    
-    // Set queue attributes
-    ctx->attr.mq_flags = 0;
-    ctx->attr.mq_maxmsg = 10;  // Max messages in queue
-    ctx->attr.mq_msgsize = MAX_MQ_MSG_SIZE;
-    ctx->attr.mq_curmsgs = 0;
-    
+    ctx->mqd = (mqd_t)-1;
+
+    char ring_name[96];
+    mq_ring_name(ring_name, sizeof(ring_name), mq_name);
+
     if (create_new) {
-        mq_unlink(mq_name);  // Remove any existing
-        ctx->mqd = mq_open(mq_name, flags | O_CREAT, 0666, &ctx->attr);
-    } else {
+        // Remove any existing queue of either kind so attachers can't pick a stale one
+        mq_unlink(mq_name);
+        shm_unlink(ring_name);
+
+        if (cfg->backend == MQ_BACKEND_SHM_RING) {
+            if (mq_ring_open(ctx, cfg, true) < 0) {
+                fprintf(stderr, "Failed to create ring: %s\n", mq_name);
+                return -1;
+            }
+        } else {
+            ctx->attr.mq_flags = 0;
+            ctx->attr.mq_maxmsg = cfg->max_msgs;
+            ctx->attr.mq_msgsize = cfg->msg_size;
+            ctx->attr.mq_curmsgs = 0;
+            ctx->mqd = mq_open(mq_name, flags | O_CREAT, 0666, &ctx->attr);
+
+            if (ctx->mqd == (mqd_t)-1 && errno == EINVAL) {
+                // Unprivileged processes are capped by fs.mqueue limits
+                long max_msgs = mq_system_limit("/proc/sys/fs/mqueue/msg_max", MQ_DEFAULT_DEPTH);
+                if (ctx->attr.mq_maxmsg > max_msgs) {
+                    fprintf(stderr, "Queue %s: depth %ld capped to msg_max %ld\n",
+                            mq_name, ctx->attr.mq_maxmsg, max_msgs);
+                    ctx->attr.mq_maxmsg = max_msgs;
+                    ctx->mqd = mq_open(mq_name, flags | O_CREAT, 0666, &ctx->attr);
+                }
+            }
+        }
+    } else if (mq_ring_open(ctx, NULL, false) < 0) {
+        if (errno != ENOENT) {
+            fprintf(stderr, "Failed to attach ring: %s\n", mq_name);
+            return -1;
+        }
         ctx->mqd = mq_open(mq_name, flags);
     }
-    
-    if (ctx->mqd == (mqd_t)-1) {
-        perror("mq_open");
-        fprintf(stderr, "Failed to open queue: %s\n", mq_name);
-        return -1;
+
+    if (ctx->backend == MQ_BACKEND_POSIX) {
+        if (ctx->mqd == (mqd_t)-1) {
+            perror("mq_open");
+            fprintf(stderr, "Failed to open queue: %s\n", mq_name);
+            return -1;
+        }
+        // Receives must offer mq_msgsize bytes, whatever the caller's buffer
+        mq_getattr(ctx->mqd, &ctx->attr);
+        size_t staged = (flags & O_ACCMODE) == O_WRONLY ? 1 : MQ_BATCH_MAX;
+        ctx->staging = malloc(staged * ctx->attr.mq_msgsize);
+        if (!ctx->staging) {
+            mq_close(ctx->mqd);
+            return -1;
+        }
     }
-    
-    ctx->is_read = (flags & O_RDONLY) || (flags & O_RDWR);
-    ctx->is_write = (flags & O_WRONLY) || (flags & O_RDWR);
+
+    ctx->is_read = (flags & O_ACCMODE) == O_RDONLY || (flags & O_ACCMODE) == O_RDWR;
+    ctx->is_write = (flags & O_ACCMODE) == O_WRONLY || (flags & O_ACCMODE) == O_RDWR;
     ctx->initialized = true;
-    
+
     return 0;
 }
 
+/**
+ * Initialize message queue with its per-queue configuration
+ * @param ctx Message queue context
+ * @param mq_name Queue name (e.g., MQ_APP_TO_RRC)
+ * @param flags O_RDONLY, O_WRONLY, or O_RDWR
+ * @param create_new If true, create with O_CREAT
+ * @return 0 on success, -1 on error
+ */
+static inline int mq_init(MQContext* ctx, const char* mq_name, int flags, bool create_new) {
+    return mq_init_config(ctx, mq_name, flags, create_new, NULL);
+}
+
 /**
  * Cleanup message queue
  */
 static inline void mq_cleanup(MQContext* ctx, bool unlink) {
     if (!ctx || !ctx->initialized) return;
-    
-    if (ctx->mqd != (mqd_t)-1) {
-        mq_close(ctx->mqd);
-    }
-    
-    if (unlink) {
-        mq_unlink(ctx->mq_name);
+
+    if (ctx->backend == MQ_BACKEND_SHM_RING) {
+        munmap(ctx->ring, ctx->ring_bytes);
+        if (unlink) {
+            char ring_name[96];
+            mq_ring_name(ring_name, sizeof(ring_name), ctx->mq_name);
+            shm_unlink(ring_name);
+        }
+    } else {
+        if (ctx->mqd != (mqd_t)-1) {
+            mq_close(ctx->mqd);
+        }
+        if (unlink) {
+            mq_unlink(ctx->mq_name);
+        }
     }
-    
+
+    free(ctx->staging);
     memset(ctx, 0, sizeof(MQContext));
 }
 
 // ============================================================================
-// MESSAGE SEND/RECEIVE OPERATIONS
+// BATCH AND ZERO-COPY OPERATIONS
 // ============================================================================
 
 /**
- * Send message to queue (blocking)
- * @param priority Message priority (0 = lowest)
+ * Expose up to max received messages without copying them out
+ * Ring views point into shared memory; POSIX views into the context's
+ * staging area. Only the first message is waited for. Views stay valid
+ * until mq_recv_release(), which must come before the next receive.
+ * @param timeout_ms -1 waits indefinitely, 0 polls
+ * @return Number of views filled, 0 if none arrived in time, -1 on error
  */
-static inline int mq_send_msg(MQContext* ctx, const void* msg, size_t msg_size, 
-                             unsigned int priority) {
-    if (!ctx || !ctx->initialized || !msg) return -1;
+static inline int mq_recv_peek(MQContext* ctx, MQMsgView* views, int max, int timeout_ms) {
+    if (!ctx || !ctx->initialized || !views || max <= 0) return -1;
+    if (!ctx->is_read || ctx->peeked > 0) return -1;
+
+    if (max > MQ_BATCH_MAX) max = MQ_BATCH_MAX;
+    int n = ctx->backend == MQ_BACKEND_SHM_RING ? mq_ring_peek(ctx, views, max, timeout_ms)
+                                                : mq_posix_peek(ctx, views, max, timeout_ms);
+    if (n > 0) {
+        ctx->peeked = n;
+        ctx->stats.dequeue_count += n;
+    } else if (n == 0 && timeout_ms > 0) {
+        ctx->stats.timeout_count++;
+    }
+    return n;
+}
+
+/**
+ * Return every message from the last mq_recv_peek() to the queue
+ */
+static inline void mq_recv_release(MQContext* ctx) {
+    if (!ctx || !ctx->initialized || ctx->peeked == 0) return;
+
+    if (ctx->backend == MQ_BACKEND_SHM_RING) {
+        MQRingHeader* ring = ctx->ring;
+        __atomic_store_n(&ring->tail, ring->tail + (uint32_t)ctx->peeked, __ATOMIC_RELEASE);
+        mq_ring_notify(&ring->space_seq, &ring->space_waiters);
+    }
+    ctx->peeked = 0;
+}
+
+/**
+ * Receive up to max messages into buf, stride bytes apart
+ * @param lens Output: length of each message (optional)
+ * @param priorities Output: priority of each message (optional)
+ * @param timeout_ms -1 waits indefinitely, 0 polls
+ * @return Number received, 0 if none arrived in time, -1 on error
+ */
+static inline int mq_recv_batch(MQContext* ctx, void* buf, size_t stride, int max,
+                                size_t* lens, unsigned int* priorities, int timeout_ms) {
+    MQMsgView views[MQ_BATCH_MAX];
+
+    if (!buf) return -1;
+    int n = mq_recv_peek(ctx, views, max, timeout_ms);
+    for (int i = 0; i < n; i++) {
+        size_t len = views[i].len < stride ? views[i].len : stride;
+        memcpy((uint8_t*)buf + (size_t)i * stride, views[i].data, len);
+        if (lens) lens[i] = len;
+        if (priorities) priorities[i] = views[i].priority;
+    }
+    mq_recv_release(ctx);
+    return n;
+}
+
+/**
+ * Send count messages of msg_size bytes from msgs, stride bytes apart (blocking)
+ * The ring backend publishes each run that fits with a single wakeup
+ * @return Number sent, -1 on error before anything was sent
+ */
+static inline int mq_send_batch(MQContext* ctx, const void* msgs, size_t stride,
+                                size_t msg_size, int count, unsigned int priority) {
+    if (!ctx || !ctx->initialized || !msgs || count <= 0) return -1;
     if (!ctx->is_write) return -1;
-    if (msg_size > MAX_MQ_MSG_SIZE) return -1;
-    
-    if (mq_send(ctx->mqd, (const char*)msg, msg_size, priority) < 0) {
+    if (msg_size > (size_t)ctx->attr.mq_msgsize) return -1;
+
+    int sent;
+    if (ctx->backend == MQ_BACKEND_SHM_RING) {
+        sent = mq_ring_send(ctx, msgs, stride, msg_size, count, priority, 0);
+    } else {
+        for (sent = 0; sent < count; sent++) {
+            if (mq_send(ctx->mqd, (const char*)msgs + (size_t)sent * stride, msg_size, priority) < 0) {
+                ctx->stats.error_count++;
+                break;
+            }
+        }
+    }
+
+    ctx->stats.enqueue_count += sent;
+    return sent > 0 ? sent : -1;
+}
+
+/**
+ * Reserve space to build one message in place (blocking)
+ * On the ring this is the slot itself, held under the producer lock until
+ * mq_send_commit(); on POSIX it is the staging buffer.
+ * @return Buffer of at least mq_msgsize bytes, NULL on error
+ */
+static inline void* mq_send_reserve(MQContext* ctx) {
+    if (!ctx || !ctx->initialized || !ctx->is_write) return NULL;
+
+    if (ctx->backend == MQ_BACKEND_POSIX) return ctx->staging;
+
+    MQRingHeader* ring = ctx->ring;
+    for (;;) {
+        uint32_t seen = __atomic_load_n(&ring->space_seq, __ATOMIC_SEQ_CST);
+        pthread_mutex_lock(&ring->producer_lock);
+        if (ring->head - __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE) < ring->depth) {
+            return mq_ring_slot(ring, ring->head) + 1;
+        }
+        pthread_mutex_unlock(&ring->producer_lock);
+        mq_ring_wait(&ring->space_seq, &ring->space_waiters, seen, 0);
+    }
+}
+
+/**
+ * Publish the message built in the mq_send_reserve() buffer
+ * Every reservation must be committed, even one that is abandoned
+ * @return 0 on success, -1 on error (nothing is sent)
+ */
+static inline int mq_send_commit(MQContext* ctx, size_t msg_size, unsigned int priority) {
+    if (!ctx || !ctx->initialized) return -1;
+
+    if (ctx->backend == MQ_BACKEND_POSIX) {
+        if (msg_size > (size_t)ctx->attr.mq_msgsize ||
+            mq_send(ctx->mqd, (const char*)ctx->staging, msg_size, priority) < 0) {
+            ctx->stats.error_count++;
+            return -1;
+        }
+        ctx->stats.enqueue_count++;
+        return 0;
+    }
+
+    MQRingHeader* ring = ctx->ring;
+    if (msg_size > ring->msg_size) {
+        pthread_mutex_unlock(&ring->producer_lock);
         ctx->stats.error_count++;
         return -1;
     }
-    
+
+    MQRingSlot* slot = mq_ring_slot(ring, ring->head);
+    slot->len = (uint32_t)msg_size;
+    slot->priority = priority;
+    __atomic_store_n(&ring->head, ring->head + 1, __ATOMIC_RELEASE);
+    pthread_mutex_unlock(&ring->producer_lock);
+
+    mq_ring_notify(&ring->data_seq, &ring->data_waiters);
     ctx->stats.enqueue_count++;
     return 0;
 }
 
+// ============================================================================
+// MESSAGE SEND/RECEIVE OPERATIONS
+// ============================================================================
+
+/**
+ * Send message to queue (blocking)
+ * @param priority Message priority (0 = lowest; the ring backend stays FIFO)
+ */
+static inline int mq_send_msg(MQContext* ctx, const void* msg, size_t msg_size,
+                             unsigned int priority) {
+    return mq_send_batch(ctx, msg, msg_size, msg_size, 1, priority) == 1 ? 0 : -1;
+}
+
 /**
- * Receive message from queue (blocking)
+ * Receive one message, copying it into msg
+ * A message longer than msg_size is consumed and reported as an error
+ * @return Number of bytes received, 0 if none arrived in time, -1 on error
  */
-static inline ssize_t mq_recv_msg(MQContext* ctx, void* msg, size_t msg_size, 
-                                 unsigned int* priority) {
-    if (!ctx || !ctx->initialized || !msg) return -1;
-    if (!ctx->is_read) return -1;
-    
-    ssize_t bytes = mq_receive(ctx->mqd, (char*)msg, msg_size, priority);
-    
-    if (bytes < 0) {
+static inline ssize_t mq_recv_one(MQContext* ctx, void* msg, size_t msg_size,
+                                  unsigned int* priority, int timeout_ms) {
+    MQMsgView view;
+
+    if (priority) *priority = 0;
+    if (!msg) return -1;
+    int n = mq_recv_peek(ctx, &view, 1, timeout_ms);
+    if (n <= 0) return n;
+
+    ssize_t bytes = view.len;
+    if (view.len > msg_size) {
         ctx->stats.error_count++;
-        return -1;
+        bytes = -1;
+    } else {
+        memcpy(msg, view.data, view.len);
+        if (priority) *priority = view.priority;
     }
-    
-    ctx->stats.dequeue_count++;
+    mq_recv_release(ctx);
     return bytes;
 }
 
+/**
+ * Receive message from queue (blocking)
+ */
+static inline ssize_t mq_recv_msg(MQContext* ctx, void* msg, size_t msg_size,
+                                 unsigned int* priority) {
+    return mq_recv_one(ctx, msg, msg_size, priority, -1);
+}
+
 /**
  * Receive message with timeout
  * @param timeout_ms Timeout in milliseconds
@@ -138,35 +740,9 @@ static inline ssize_t mq_recv_msg(MQContext* ctx, void* msg, size_t msg_size,
  */
 static inline ssize_t mq_recv_msg_timeout(MQContext* ctx, void* msg, size_t msg_size,
                                          unsigned int* priority, uint32_t timeout_ms) {
-    if (!ctx || !ctx->initialized || !msg) return -1;
-    if (!ctx->is_read) return -1;
-    
-    struct timespec abs_timeout;
-    clock_gettime(CLOCK_REALTIME, &abs_timeout);
-    
-    abs_timeout.tv_sec += timeout_ms / 1000;
-    abs_timeout.tv_nsec += (timeout_ms % 1000) * 1000000;
-    
-    // Handle nanosecond overflow
-    if (abs_timeout.tv_nsec >= 1000000000) {
-        abs_timeout.tv_sec++;
-        abs_timeout.tv_nsec -= 1000000000;
-    }
-    
-    ssize_t bytes = mq_timedreceive(ctx->mqd, (char*)msg, msg_size, 
-                                   priority, &abs_timeout);
-    
-    if (bytes < 0) {
-        if (errno == ETIMEDOUT) {
-            ctx->stats.timeout_count++;
-            return -2;  // Timeout
-        }
-        ctx->stats.error_count++;
-        return -1;  // Error
-    }
-    
-    ctx->stats.dequeue_count++;
-    return bytes;
+    ssize_t bytes = mq_recv_one(ctx, msg, msg_size, priority,
+                                timeout_ms > 0 ? (int)timeout_ms : 0);
+    return bytes == 0 ? -2 : bytes;
 }
 
 /**
@@ -175,32 +751,7 @@ static inline ssize_t mq_recv_msg_timeout(MQContext* ctx, void* msg, size_t msg_
  */
 static inline ssize_t mq_try_recv_msg(MQContext* ctx, void* msg, size_t msg_size,
                                      unsigned int* priority) {
-    if (!ctx || !ctx->initialized || !msg) return -1;
-    if (!ctx->is_read) return -1;
-    
-    // Set queue to non-blocking
-    struct mq_attr old_attr, new_attr;
-    mq_getattr(ctx->mqd, &old_attr);
-    
-    new_attr = old_attr;
-    new_attr.mq_flags = O_NONBLOCK;
-    mq_setattr(ctx->mqd, &new_attr, NULL);
-    
-    ssize_t bytes = mq_receive(ctx->mqd, (char*)msg, msg_size, priority);
-    
-    // Restore blocking mode
-    mq_setattr(ctx->mqd, &old_attr, NULL);
-    
-    if (bytes < 0) {
-        if (errno == EAGAIN || errno == EWOULDBLOCK) {
-            return 0;  // Queue empty
-        }
-        ctx->stats.error_count++;
-        return -1;  // Error
-    }
-    
-    ctx->stats.dequeue_count++;
-    return bytes;
+    return mq_recv_one(ctx, msg, msg_size, priority, 0);
 }
 
 // ============================================================================
@@ -256,6 +807,13 @@ static inline void mq_reset_stats(MQContext* ctx) {
  */
 static inline int mq_get_attr(MQContext* ctx, struct mq_attr* attr) {
     if (!ctx || !ctx->initialized || !attr) return -1;
+
+    if (ctx->backend == MQ_BACKEND_SHM_RING) {
+        *attr = ctx->attr;
+        attr->mq_curmsgs = __atomic_load_n(&ctx->ring->head, __ATOMIC_ACQUIRE) -
+                           __atomic_load_n(&ctx->ring->tail, __ATOMIC_ACQUIRE);
+        return 0;
+    }
     return mq_getattr(ctx->mqd, attr);
 }
 
@@ -79,23 +79,25 @@ uint8_t rrc_select_best_neighbor(uint8_t* candidates, uint8_t num_candidates) {
     
     uint8_t best_neighbor = 0;
     uint8_t best_score = 0;
+    PhyLinkBatch batch;
     
     printf("[RRC] Evaluating %u candidate neighbors...\n", num_candidates);
     
+    // One pass scores every neighbor; candidates are then just lookups
+    if (phy_refresh_all_links(&g_phy_ctx, -85, 12, &batch) < 0) {
+        return 0;
+    }
+    
     for (uint8_t i = 0; i < num_candidates; i++) {
         uint8_t neighbor_id = candidates[i];
-        PhyLinkMetrics metrics;
-        
-        if (phy_read_link_metrics(&g_phy_ctx, neighbor_id, &metrics) < 0) {
+        if (neighbor_id == 0 || neighbor_id > PHY_MAX_NEIGHBORS) {
             continue;
         }
         
-        // Calculate link quality score
-        uint8_t score = phy_calculate_link_score(&metrics);
+        uint8_t score = batch.score[neighbor_id - 1];
         
-        printf("  Neighbor %u: score=%u/100, RSSI=%d dBm, SNR=%d dB, PER=%.2f%%\n",
-               neighbor_id, score, metrics.rssi_dbm, metrics.snr_db,
-               metrics.packet_error_rate / 1e4);
+        printf("  Neighbor %u: score=%u/100%s\n", neighbor_id, score,
+               (batch.usable_mask >> (neighbor_id - 1)) & 1 ? "" : " (unusable)");
         
         if (score > best_score) {
             best_score = score;
@@ -142,7 +144,7 @@ void rrc_monitor_phy_metrics(uint8_t* neighbors, uint8_t num_neighbors) {
         uint8_t neighbor_id = neighbors[i];
         PhyLinkMetrics metrics;
         
-        if (phy_read_link_metrics(&g_phy_ctx, neighbor_id, &metrics) == 0) {
+        if (phy_read_link_metrics_stable(&g_phy_ctx, neighbor_id, &metrics) == 0) {
             uint8_t score = phy_calculate_link_score(&metrics);
             bool usable = phy_is_link_usable(&metrics, -85, 12);
             
@@ -269,11 +271,32 @@ int main(int argc, char* argv[]) {
     printf("\n");
     sleep(2);
     
-    // Main loop: Periodic monitoring
+    // Main loop: wake on PHY change notifications, process changed neighbors only
     printf("[RRC] Entering main monitoring loop...\n\n");
     int loop_count = 0;
+    phy_collect_changed_links(&g_phy_ctx);  // Baseline sequences
     while (g_running && loop_count < 5) {  // Run 5 cycles for demo
-        rrc_monitor_phy_metrics(neighbors, num_neighbors);
+        int woke = phy_wait_for_changes(&g_phy_ctx, 3000);
+        if (woke < 0) {
+            break;
+        }
+        loop_count++;
+        if (woke == 0) {
+            continue;  // No PHY updates within the cycle
+        }
+        uint64_t changed = phy_collect_changed_links(&g_phy_ctx);
+        uint8_t changed_neighbors[PHY_MAX_NEIGHBORS];
+        uint8_t num_changed = 0;
+        for (uint8_t i = 0; i < num_neighbors; i++) {
+            if (changed & (1ULL << (neighbors[i] - 1))) {
+                changed_neighbors[num_changed++] = neighbors[i];
+            }
+        }
+        if (num_changed == 0) {
+            continue;  // Only links we do not route over changed
+        }
+        
+        rrc_monitor_phy_metrics(changed_neighbors, num_changed);
         
         // Every 2 cycles, re-evaluate best neighbor
         if (loop_count % 2 == 0) {
@@ -281,9 +304,6 @@ int main(int argc, char* argv[]) {
             rrc_select_best_neighbor(neighbors, num_neighbors);
             printf("\n");
         }
-        
-        sleep(3);
-        loop_count++;
     }
     
     // Cleanup
@@ -9,11 +9,21 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include <stdio.h>
 #include <sys/mman.h>
 #include <fcntl.h>
 #include <unistd.h>
 #include <time.h>
 #include <string.h>
+#include <errno.h>
+#include <sched.h>
+#include "rrc_doorbell.h"
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
 
 // ============================================================================
 // PHY METRICS MEMORY LAYOUT
@@ -28,6 +38,7 @@
 #define PHY_OFFSET_RF_STATUS     0x4000       // RF module status
 #define PHY_OFFSET_DIAGNOSTICS   0x8000       // PHY diagnostics and counters
 #define PHY_OFFSET_CONFIG        0xC000       // PHY configuration registers
+#define PHY_OFFSET_CHANGE_NOTIFY 0x3F00       // Change notification block (end of link quality window)
 
 // Maximum neighbors for metrics tracking
 #define PHY_MAX_NEIGHBORS        40
@@ -153,6 +164,29 @@ typedef struct __attribute__((packed)) {
     
 } PhyDiagnostics;  // Total: 48 bytes
 
+// ============================================================================
+// PHY CHANGE NOTIFICATION BLOCK
+// ============================================================================
+
+#define PHY_CHANGE_MAGIC         0x50484743   // "PHGC": PHY maintains the block below
+#define PHY_DOORBELL_POLL_US     1000         // Doorbell poll period when futex cannot be used
+#define PHY_STABLE_READ_RETRIES  64           // Attempts before giving up on a busy entry
+
+/**
+ * Change notification written by PHY alongside the link table
+ * Located at: PHY_METRICS_BASE_ADDR + PHY_OFFSET_CHANGE_NOTIFY
+ *
+ * Writer protocol per entry: entry_seq[i]++ (odd), rewrite link_metrics[i],
+ * entry_seq[i]++ (even). After a batch of entries: generation++, then
+ * FUTEX_WAKE on generation. Readers never write to the region; they keep
+ * the sequences they last saw and wake only when generation moves.
+ */
+typedef struct {
+    uint32_t magic;                         // PHY_CHANGE_MAGIC once PHY maintains the block
+    uint32_t generation;                    // Doorbell word, bumped once per update batch
+    uint32_t entry_seq[PHY_MAX_NEIGHBORS];  // Per-entry sequence, odd while PHY rewrites it
+} PhyChangeBlock;
+
 // ============================================================================
 // PHY METRICS CONTEXT
 // ============================================================================
@@ -162,6 +196,9 @@ typedef struct {
     void* phy_base;                  // Mapped base address
     bool initialized;                // Init flag
     uint64_t last_read_ns;           // Last read timestamp
+    uint32_t seen_generation;        // Doorbell generation last waited on
+    bool doorbell_poll;              // Futex refused on this mapping, poll generation instead
+    uint32_t seen_seq[PHY_MAX_NEIGHBORS]; // Entry sequences at the last collect
 } PhyMetricsContext;
 
 // ============================================================================
@@ -254,6 +291,165 @@ static inline int phy_read_link_metrics(PhyMetricsContext* ctx,
     return 0;
 }
 
+// ============================================================================
+// CHANGE NOTIFICATION
+// ============================================================================
+
+static inline PhyChangeBlock* phy_change_block(void* phy_base) {
+    return (PhyChangeBlock*)((uint8_t*)phy_base + PHY_OFFSET_CHANGE_NOTIFY);
+}
+
+/**
+ * Check whether the PHY maintains the change notification block
+ */
+static inline bool phy_change_supported(const PhyMetricsContext* ctx) {
+    return ctx && ctx->initialized &&
+           __atomic_load_n(&phy_change_block(ctx->phy_base)->magic, __ATOMIC_ACQUIRE) == PHY_CHANGE_MAGIC;
+}
+
+/**
+ * Sleep until the PHY rings the doorbell or the timeout expires
+ * Falls back to a plain sleep when the PHY does not maintain the block,
+ * and to polling the generation every PHY_DOORBELL_POLL_US when the kernel
+ * refuses a futex on the mapping (read-only /dev/mem gives EFAULT)
+ * @param ctx PHY metrics context
+ * @param timeout_ms Maximum wait in milliseconds
+ * @return 1 if the generation moved, 0 on timeout, -1 on error
+ */
+static inline int phy_wait_for_changes(PhyMetricsContext* ctx, int timeout_ms) {
+    if (!ctx || !ctx->initialized) return -1;
+    
+    if (!phy_change_supported(ctx)) {
+        usleep(timeout_ms * 1000);
+        return 1;  // Unknown: caller rescans by update_count
+    }
+    
+    uint32_t* doorbell = &phy_change_block(ctx->phy_base)->generation;
+    struct timespec now, deadline;
+    clock_gettime(CLOCK_MONOTONIC, &deadline);
+    deadline.tv_sec += timeout_ms / 1000;
+    deadline.tv_nsec += (timeout_ms % 1000) * 1000000L;
+    if (deadline.tv_nsec >= 1000000000L) {
+        deadline.tv_sec++;
+        deadline.tv_nsec -= 1000000000L;
+    }
+    
+    for (;;) {
+        uint32_t gen = __atomic_load_n(doorbell, __ATOMIC_ACQUIRE);
+        if (gen != ctx->seen_generation) {
+            ctx->seen_generation = gen;
+            return 1;
+        }
+        
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        int64_t left_ns = (int64_t)(deadline.tv_sec - now.tv_sec) * 1000000000LL +
+                          (deadline.tv_nsec - now.tv_nsec);
+        if (left_ns <= 0) return 0;
+        
+        if (ctx->doorbell_poll) {
+            int64_t nap_ns = left_ns < PHY_DOORBELL_POLL_US * 1000LL ? left_ns
+                                                                     : PHY_DOORBELL_POLL_US * 1000LL;
+            struct timespec nap = { 0, (long)nap_ns };
+            nanosleep(&nap, NULL);
+            continue;
+        }
+        
+        // Read-only mapping: no waiter count, the PHY always wakes
+        struct timespec ts = { (time_t)(left_ns / 1000000000LL), (long)(left_ns % 1000000000LL) };
+        if (rrc_doorbell_wait(doorbell, NULL, gen, &ts) < 0) {
+            if (errno == ETIMEDOUT) return 0;
+            if (errno == EFAULT || errno == ENOSYS) {
+                printf("[PHY_METRICS] Futex unavailable on PHY mapping (%s), polling doorbell\n",
+                       errno == EFAULT ? "EFAULT" : "ENOSYS");
+                ctx->doorbell_poll = true;
+                continue;
+            }
+            if (errno != EAGAIN && errno != EINTR) return -1;
+        }
+    }
+}
+
+/**
+ * Bitmask of neighbors whose metrics changed since the previous call
+ * Compares the 40 entry sequences (or update_count on PHYs without the
+ * change block) instead of re-reading the whole metrics window
+ * @return Bit (neighbor_id - 1) set for each changed neighbor
+ */
+static inline uint64_t phy_collect_changed_links(PhyMetricsContext* ctx) {
+    if (!ctx || !ctx->initialized) return 0;
+    
+    uint64_t changed = 0;
+    bool supported = phy_change_supported(ctx);
+    PhyChangeBlock* block = phy_change_block(ctx->phy_base);
+    volatile PhyLinkMetrics* table = 
+        (volatile PhyLinkMetrics*)((uint8_t*)ctx->phy_base + PHY_OFFSET_LINK_QUALITY);
+    
+    // Everything up to this generation is covered by the scan below
+    if (supported) {
+        ctx->seen_generation = __atomic_load_n(&block->generation, __ATOMIC_ACQUIRE);
+    }
+    for (int i = 0; i < PHY_MAX_NEIGHBORS; i++) {
+        uint32_t seq = supported ? __atomic_load_n(&block->entry_seq[i], __ATOMIC_ACQUIRE)
+                                 : table[i].update_count;
+        if (seq != ctx->seen_seq[i]) {
+            ctx->seen_seq[i] = seq;
+            changed |= 1ULL << i;
+        }
+    }
+    return changed;
+}
+
+/**
+ * Read link metrics without tearing against a concurrent PHY update
+ * Retries while the entry sequence is odd or moved during the copy, at most
+ * PHY_STABLE_READ_RETRIES times so a PHY that died mid-write cannot hang RRC
+ * @return 0 on success, -1 on error or if the entry never settled
+ */
+static inline int phy_read_link_metrics_stable(PhyMetricsContext* ctx, 
+                                               uint8_t neighbor_id,
+                                               PhyLinkMetrics* metrics) {
+    if (!phy_change_supported(ctx)) {
+        return phy_read_link_metrics(ctx, neighbor_id, metrics);
+    }
+    if (neighbor_id == 0 || neighbor_id > PHY_MAX_NEIGHBORS) return -1;
+    
+    uint32_t* seq = &phy_change_block(ctx->phy_base)->entry_seq[neighbor_id - 1];
+    for (int attempt = 0; attempt < PHY_STABLE_READ_RETRIES; attempt++) {
+        uint32_t before = __atomic_load_n(seq, __ATOMIC_ACQUIRE);
+        if (before & 1) {  // PHY mid-write
+            sched_yield();
+            continue;
+        }
+        if (phy_read_link_metrics(ctx, neighbor_id, metrics) < 0) return -1;
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        if (__atomic_load_n(seq, __ATOMIC_RELAXED) == before) return 0;
+    }
+    return -1;
+}
+
+/**
+ * PHY writer side: mark an entry as being rewritten
+ */
+static inline void phy_change_begin_entry(PhyChangeBlock* block, uint8_t neighbor_id) {
+    __atomic_add_fetch(&block->entry_seq[neighbor_id - 1], 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+}
+
+/**
+ * PHY writer side: entry rewrite complete
+ */
+static inline void phy_change_end_entry(PhyChangeBlock* block, uint8_t neighbor_id) {
+    __atomic_add_fetch(&block->entry_seq[neighbor_id - 1], 1, __ATOMIC_RELEASE);
+}
+
+/**
+ * PHY writer side: publish a batch of entry updates and wake waiting readers
+ */
+static inline void phy_change_ring_doorbell(PhyChangeBlock* block) {
+    __atomic_store_n(&block->magic, PHY_CHANGE_MAGIC, __ATOMIC_RELEASE);
+    rrc_doorbell_ring(&block->generation, NULL);
+}
+
 /**
  * Read RF status
  */
@@ -317,6 +513,272 @@ static inline bool phy_is_link_usable(const PhyLinkMetrics* metrics,
             metrics->packet_error_rate < 100000);          // PER < 10%
 }
 
+// ============================================================================
+// BATCH LINK SCORING
+// ============================================================================
+
+// Column length: PHY_MAX_NEIGHBORS rounded up to a whole number of 8-lane vectors
+#define PHY_BATCH_LANES          ((PHY_MAX_NEIGHBORS + 7) & ~7)
+#define PHY_PER_SATURATE         1000000      // PER×10^6 clamp (100%) so columns fit int32
+
+/**
+ * Link table transposed into struct-of-arrays columns
+ * Lane i holds neighbor_id i+1; lanes past PHY_MAX_NEIGHBORS are link DOWN
+ */
+typedef struct {
+    int32_t rssi_dbm[PHY_BATCH_LANES]   __attribute__((aligned(32)));
+    int32_t snr_db[PHY_BATCH_LANES]     __attribute__((aligned(32)));
+    int32_t per[PHY_BATCH_LANES]        __attribute__((aligned(32)));  // PER×10^6, saturated
+    int32_t link_state[PHY_BATCH_LANES] __attribute__((aligned(32)));
+} PhyLinkColumns;
+
+/**
+ * Scores and usability for every neighbor from one batch pass
+ */
+typedef struct {
+    uint8_t  score[PHY_BATCH_LANES];    // score[neighbor_id - 1], 0-100
+    uint64_t usable_mask;               // Bit (neighbor_id - 1) set if usable
+    uint64_t up_mask;                   // Bit (neighbor_id - 1) set if link_state != DOWN
+} PhyLinkBatch;
+
+/**
+ * Transpose the PHY link table into columns
+ * Reads only the four scored fields of each entry instead of copying all 88 bytes.
+ * Each entry is read under its entry_seq like phy_read_link_metrics_stable();
+ * one the PHY never finished rewriting reads as link DOWN
+ * @return 0 on success, -1 on error
+ */
+static inline int phy_gather_link_columns(PhyMetricsContext* ctx, PhyLinkColumns* cols) {
+    if (!ctx || !ctx->initialized || !cols) return -1;
+
+    volatile PhyLinkMetrics* table =
+        (volatile PhyLinkMetrics*)((uint8_t*)ctx->phy_base + PHY_OFFSET_LINK_QUALITY);
+    PhyChangeBlock* block = phy_change_supported(ctx) ? phy_change_block(ctx->phy_base) : NULL;
+
+    for (int i = 0; i < PHY_BATCH_LANES; i++) {
+        cols->rssi_dbm[i] = cols->snr_db[i] = cols->per[i] = cols->link_state[i] = 0;
+        if (i >= PHY_MAX_NEIGHBORS) continue;
+
+        for (int attempt = 0; attempt < PHY_STABLE_READ_RETRIES; attempt++) {
+            uint32_t before = block ? __atomic_load_n(&block->entry_seq[i], __ATOMIC_ACQUIRE) : 0;
+            if (before & 1) {  // PHY mid-write
+                sched_yield();
+                continue;
+            }
+            uint32_t per = table[i].packet_error_rate;
+            int32_t link_state = table[i].link_state;
+            int32_t rssi_dbm = table[i].rssi_dbm;
+            int32_t snr_db = table[i].snr_db;
+            if (block) {
+                __atomic_thread_fence(__ATOMIC_ACQUIRE);
+                if (__atomic_load_n(&block->entry_seq[i], __ATOMIC_RELAXED) != before) continue;
+            }
+            cols->link_state[i] = link_state;
+            cols->rssi_dbm[i] = rssi_dbm;
+            cols->snr_db[i] = snr_db;
+            cols->per[i] = (int32_t)(per > PHY_PER_SATURATE ? PHY_PER_SATURATE : per);
+            break;
+        }
+    }
+
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    ctx->last_read_ns = ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+
+    return 0;
+}
+
+/*
+ * The vector kernels evaluate phy_calculate_link_score() in float lanes.
+ * Every intermediate is an integer below 2^24 and every non-integral
+ * quotient is at least 1/120 from the next integer, so truncating the
+ * float quotient matches the scalar integer division exactly.
+ */
+
+#if defined(__AVX2__)
+static inline void phy_score_columns_simd(const PhyLinkColumns* cols, int16_t min_rssi_dbm,
+                                          int16_t min_snr_db, PhyLinkBatch* out) {
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 hundred = _mm256_set1_ps(100.0f);
+    const __m256i min_rssi = _mm256_set1_epi32(min_rssi_dbm);
+    const __m256i min_snr = _mm256_set1_epi32(min_snr_db);
+
+    for (int i = 0; i < PHY_BATCH_LANES; i += 8) {
+        __m256i rssi = _mm256_load_si256((const __m256i*)&cols->rssi_dbm[i]);
+        __m256i snr = _mm256_load_si256((const __m256i*)&cols->snr_db[i]);
+        __m256i per = _mm256_load_si256((const __m256i*)&cols->per[i]);
+        __m256i state = _mm256_load_si256((const __m256i*)&cols->link_state[i]);
+
+        __m256 r = _mm256_min_ps(_mm256_max_ps(_mm256_cvtepi32_ps(
+                       _mm256_add_epi32(rssi, _mm256_set1_epi32(120))), zero), _mm256_set1_ps(120.0f));
+        __m256 sn = _mm256_min_ps(_mm256_max_ps(_mm256_cvtepi32_ps(snr), zero), _mm256_set1_ps(40.0f));
+        __m256 rs = _mm256_round_ps(_mm256_div_ps(_mm256_mul_ps(r, hundred), _mm256_set1_ps(120.0f)),
+                                    _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC);
+        __m256 ss = _mm256_round_ps(_mm256_div_ps(_mm256_mul_ps(sn, hundred), _mm256_set1_ps(40.0f)),
+                                    _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC);
+        __m256 ps = _mm256_max_ps(_mm256_sub_ps(hundred, _mm256_round_ps(
+                        _mm256_div_ps(_mm256_cvtepi32_ps(per), _mm256_set1_ps(10000.0f)),
+                        _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC)), zero);
+        __m256 total = _mm256_div_ps(_mm256_add_ps(_mm256_mul_ps(_mm256_add_ps(rs, ss), _mm256_set1_ps(40.0f)),
+                                                   _mm256_mul_ps(ps, _mm256_set1_ps(20.0f))), hundred);
+
+        __m256i down = _mm256_cmpeq_epi32(state, _mm256_setzero_si256());
+        __m256i score = _mm256_andnot_si256(down, _mm256_cvttps_epi32(total));
+        __m256i usable = _mm256_andnot_si256(
+            _mm256_or_si256(_mm256_cmpgt_epi32(min_rssi, rssi), _mm256_cmpgt_epi32(min_snr, snr)),
+            _mm256_and_si256(_mm256_cmpeq_epi32(state, _mm256_set1_epi32(1)),
+                             _mm256_cmpgt_epi32(_mm256_set1_epi32(100000), per)));
+
+        int32_t lanes[8] __attribute__((aligned(32)));
+        _mm256_store_si256((__m256i*)lanes, score);
+        for (int k = 0; k < 8; k++) {
+            out->score[i + k] = (uint8_t)lanes[k];
+        }
+        out->usable_mask |= (uint64_t)_mm256_movemask_ps(_mm256_castsi256_ps(usable)) << i;
+        out->up_mask |= (uint64_t)(~_mm256_movemask_ps(_mm256_castsi256_ps(down)) & 0xFF) << i;
+    }
+}
+#define PHY_HAVE_SIMD_SCORING 1
+#elif defined(__SSE2__)
+static inline void phy_score_columns_simd(const PhyLinkColumns* cols, int16_t min_rssi_dbm,
+                                          int16_t min_snr_db, PhyLinkBatch* out) {
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 hundred = _mm_set1_ps(100.0f);
+    const __m128i min_rssi = _mm_set1_epi32(min_rssi_dbm);
+    const __m128i min_snr = _mm_set1_epi32(min_snr_db);
+
+    for (int i = 0; i < PHY_BATCH_LANES; i += 4) {
+        __m128i rssi = _mm_load_si128((const __m128i*)&cols->rssi_dbm[i]);
+        __m128i snr = _mm_load_si128((const __m128i*)&cols->snr_db[i]);
+        __m128i per = _mm_load_si128((const __m128i*)&cols->per[i]);
+        __m128i state = _mm_load_si128((const __m128i*)&cols->link_state[i]);
+
+        // SSE2 has no float truncation: round-trip through cvttps_epi32
+        __m128 r = _mm_min_ps(_mm_max_ps(_mm_cvtepi32_ps(
+                       _mm_add_epi32(rssi, _mm_set1_epi32(120))), zero), _mm_set1_ps(120.0f));
+        __m128 sn = _mm_min_ps(_mm_max_ps(_mm_cvtepi32_ps(snr), zero), _mm_set1_ps(40.0f));
+        __m128 rs = _mm_cvtepi32_ps(_mm_cvttps_epi32(_mm_div_ps(_mm_mul_ps(r, hundred), _mm_set1_ps(120.0f))));
+        __m128 ss = _mm_cvtepi32_ps(_mm_cvttps_epi32(_mm_div_ps(_mm_mul_ps(sn, hundred), _mm_set1_ps(40.0f))));
+        __m128 ps = _mm_max_ps(_mm_sub_ps(hundred, _mm_cvtepi32_ps(_mm_cvttps_epi32(
+                        _mm_div_ps(_mm_cvtepi32_ps(per), _mm_set1_ps(10000.0f))))), zero);
+        __m128 total = _mm_div_ps(_mm_add_ps(_mm_mul_ps(_mm_add_ps(rs, ss), _mm_set1_ps(40.0f)),
+                                             _mm_mul_ps(ps, _mm_set1_ps(20.0f))), hundred);
+
+        __m128i down = _mm_cmpeq_epi32(state, _mm_setzero_si128());
+        __m128i score = _mm_andnot_si128(down, _mm_cvttps_epi32(total));
+        __m128i usable = _mm_andnot_si128(
+            _mm_or_si128(_mm_cmplt_epi32(rssi, min_rssi), _mm_cmplt_epi32(snr, min_snr)),
+            _mm_and_si128(_mm_cmpeq_epi32(state, _mm_set1_epi32(1)),
+                          _mm_cmplt_epi32(per, _mm_set1_epi32(100000))));
+
+        int32_t lanes[4] __attribute__((aligned(16)));
+        _mm_store_si128((__m128i*)lanes, score);
+        for (int k = 0; k < 4; k++) {
+            out->score[i + k] = (uint8_t)lanes[k];
+        }
+        out->usable_mask |= (uint64_t)_mm_movemask_ps(_mm_castsi128_ps(usable)) << i;
+        out->up_mask |= (uint64_t)(~_mm_movemask_ps(_mm_castsi128_ps(down)) & 0xF) << i;
+    }
+}
+#define PHY_HAVE_SIMD_SCORING 1
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+static inline void phy_score_columns_simd(const PhyLinkColumns* cols, int16_t min_rssi_dbm,
+                                          int16_t min_snr_db, PhyLinkBatch* out) {
+    const float32x4_t zero = vdupq_n_f32(0.0f);
+    const float32x4_t hundred = vdupq_n_f32(100.0f);
+    const int32x4_t min_rssi = vdupq_n_s32(min_rssi_dbm);
+    const int32x4_t min_snr = vdupq_n_s32(min_snr_db);
+    const uint32x4_t lane_bits = {1, 2, 4, 8};
+
+    for (int i = 0; i < PHY_BATCH_LANES; i += 4) {
+        int32x4_t rssi = vld1q_s32(&cols->rssi_dbm[i]);
+        int32x4_t snr = vld1q_s32(&cols->snr_db[i]);
+        int32x4_t per = vld1q_s32(&cols->per[i]);
+        int32x4_t state = vld1q_s32(&cols->link_state[i]);
+
+        float32x4_t r = vminq_f32(vmaxq_f32(vcvtq_f32_s32(vaddq_s32(rssi, vdupq_n_s32(120))), zero),
+                                  vdupq_n_f32(120.0f));
+        float32x4_t sn = vminq_f32(vmaxq_f32(vcvtq_f32_s32(snr), zero), vdupq_n_f32(40.0f));
+        float32x4_t rs = vrndq_f32(vdivq_f32(vmulq_f32(r, hundred), vdupq_n_f32(120.0f)));
+        float32x4_t ss = vrndq_f32(vdivq_f32(vmulq_f32(sn, hundred), vdupq_n_f32(40.0f)));
+        float32x4_t ps = vmaxq_f32(vsubq_f32(hundred, vrndq_f32(
+                             vdivq_f32(vcvtq_f32_s32(per), vdupq_n_f32(10000.0f)))), zero);
+        float32x4_t total = vdivq_f32(vaddq_f32(vmulq_f32(vaddq_f32(rs, ss), vdupq_n_f32(40.0f)),
+                                                vmulq_f32(ps, vdupq_n_f32(20.0f))), hundred);
+
+        uint32x4_t down = vceqq_s32(state, vdupq_n_s32(0));
+        uint32x4_t score = vbicq_u32(vcvtq_u32_f32(total), down);
+        uint32x4_t usable = vandq_u32(vandq_u32(vceqq_s32(state, vdupq_n_s32(1)),
+                                                vcltq_s32(per, vdupq_n_s32(100000))),
+                                      vandq_u32(vcgeq_s32(rssi, min_rssi), vcgeq_s32(snr, min_snr)));
+
+        uint32_t lanes[4];
+        vst1q_u32(lanes, score);
+        for (int k = 0; k < 4; k++) {
+            out->score[i + k] = (uint8_t)lanes[k];
+        }
+        out->usable_mask |= (uint64_t)vaddvq_u32(vandq_u32(usable, lane_bits)) << i;
+        out->up_mask |= (uint64_t)vaddvq_u32(vbicq_u32(lane_bits, down)) << i;
+    }
+}
+#define PHY_HAVE_SIMD_SCORING 1
+#endif
+
+/**
+ * Scalar batch kernel; same results as the vector kernels
+ */
+static inline void phy_score_columns_scalar(const PhyLinkColumns* cols, int16_t min_rssi_dbm,
+                                            int16_t min_snr_db, PhyLinkBatch* out) {
+    for (int i = 0; i < PHY_BATCH_LANES; i++) {
+        PhyLinkMetrics m;
+        m.link_state = (uint8_t)cols->link_state[i];
+        m.rssi_dbm = (int16_t)cols->rssi_dbm[i];
+        m.snr_db = (int16_t)cols->snr_db[i];
+        m.packet_error_rate = (uint32_t)cols->per[i];
+
+        out->score[i] = phy_calculate_link_score(&m);
+        if (phy_is_link_usable(&m, min_rssi_dbm, min_snr_db)) {
+            out->usable_mask |= 1ULL << i;
+        }
+        if (m.link_state != 0) {
+            out->up_mask |= 1ULL << i;
+        }
+    }
+}
+
+/**
+ * Score every column lane and build the usable-neighbor mask
+ */
+static inline void phy_score_link_columns(const PhyLinkColumns* cols, int16_t min_rssi_dbm,
+                                          int16_t min_snr_db, PhyLinkBatch* out) {
+    out->usable_mask = 0;
+    out->up_mask = 0;
+#ifdef PHY_HAVE_SIMD_SCORING
+    phy_score_columns_simd(cols, min_rssi_dbm, min_snr_db, out);
+#else
+    phy_score_columns_scalar(cols, min_rssi_dbm, min_snr_db, out);
+#endif
+}
+
+/**
+ * Refresh scores and usability for all neighbors in one pass per frame
+ * Replaces per-neighbor phy_read_link_metrics + phy_calculate_link_score +
+ * phy_is_link_usable calls for the router and slot allocator
+ * @param ctx PHY metrics context
+ * @param min_rssi_dbm Usability RSSI threshold
+ * @param min_snr_db Usability SNR threshold
+ * @param out Output: per-neighbor scores and masks
+ * @return 0 on success, -1 on error
+ */
+static inline int phy_refresh_all_links(PhyMetricsContext* ctx, int16_t min_rssi_dbm,
+                                        int16_t min_snr_db, PhyLinkBatch* out) {
+    PhyLinkColumns cols;
+
+    if (!out || phy_gather_link_columns(ctx, &cols) < 0) return -1;
+    phy_score_link_columns(&cols, min_rssi_dbm, min_snr_db, out);
+    return 0;
+}
+
 /**
  * Print link metrics (for debugging)
  */
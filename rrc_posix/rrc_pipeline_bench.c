@@ -0,0 +1,731 @@
+/**
+ * RRC Pipeline Benchmark
+ * Drives rrc_core, olsr_daemon and tdma_daemon end to end under an
+ * open-loop offered load and measures what comes out the other side.
+ *
+ * The harness plays both ends of the stack: it is the application
+ * (app pool + APP->RRC queue) and the PHY (per-datatype queues + frame
+ * pool). A packet is delivered when its frame notification reaches the
+ * PHY side, and dropped when RRC reports an error for its request_id.
+ *
+ * Usage: rrc_pipeline_bench [options]
+ *   -r RATES   Offered loads to sweep, packets/s (default 25,50,100,200)
+ *   -s SIZES   Payload sizes, bytes (default 256)
+ *   -d DESTS   Destination node IDs, picked uniformly (default 2,3,4)
+ *   -m MIX     Data-type weights, e.g. msg:60,voice:30,video:10 (default msg:1)
+ *   -t SECS    Seconds of load per run (default 5)
+ *   -n NODE    Node ID the daemons run as (default 1)
+ *   -o FILE    Write results as JSON to FILE
+ *   -x         Attach to already-running daemons instead of launching them
+ *   -v         Let launched daemons write to the terminal
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <signal.h>
+#include <pthread.h>
+#include <sys/wait.h>
+#include "rrc_posix_mq_defs.h"
+#include "rrc_shm_pool.h"
+#include "rrc_mq_adapters.h"
+
+// ============================================================================
+// CONFIGURATION
+// ============================================================================
+
+#define BENCH_MAX_LIST 16
+#define BENCH_MAX_INFLIGHT 4096        // Power of two, well above pool + queue depth
+#define BENCH_DRAIN_MS (REQUEST_TIMEOUT_MS * 2 + 1000)
+#define BENCH_DATATYPE_QUEUES 7
+
+typedef enum {
+    DROP_APP_POOL_FULL = 0,    // No free app pool entry when offered
+    DROP_QUEUE_FULL,           // APP->RRC queue full when offered
+    DROP_NO_ROUTE,             // ERROR_OLSR_NO_ROUTE
+    DROP_NO_SLOT,              // ERROR_TDMA_SLOT_UNAVAILABLE
+    DROP_FRAME_POOL_FULL,      // ERROR_BUFFER_FULL
+    DROP_TIMEOUT,              // ERROR_TIMEOUT inside RRC
+    DROP_OTHER,                // Any other RRC error
+    DROP_EVICTED,              // Frame reclaimed for a keyframe before PHY read it
+    DROP_LOST,                 // No outcome before the drain deadline
+    DROP_REASON_COUNT
+} DropReason;
+
+static const char* drop_reason_names[DROP_REASON_COUNT] = {
+    "app_pool_full", "queue_full", "no_route", "no_slot",
+    "frame_pool_full", "timeout", "other", "evicted", "lost"
+};
+
+static const char* datatype_names[] = { "msg", "voice", "video", "file", "relay", "ptt" };
+#define BENCH_DATATYPES (int)(sizeof(datatype_names) / sizeof(datatype_names[0]))
+
+typedef struct {
+    int rates[BENCH_MAX_LIST];
+    int rate_count;
+    int sizes[BENCH_MAX_LIST];
+    int size_count;
+    int dests[BENCH_MAX_LIST];
+    int dest_count;
+    int mix[BENCH_DATATYPES];          // Relative weight per DataType
+    int mix_total;
+    int duration_s;
+    uint8_t node_id;
+    const char* json_path;
+    bool external;
+    bool verbose;
+} BenchConfig;
+
+// Outcome tracking for one request_id
+typedef struct {
+    uint32_t request_id;
+    uint64_t send_ns;
+    bool active;
+} InflightEntry;
+
+// Results of one (size, rate) run
+typedef struct {
+    int payload_bytes;
+    int offered_pps;
+    uint32_t offered;
+    uint32_t sent;
+    uint32_t delivered;
+    uint32_t drops[DROP_REASON_COUNT];
+    uint64_t start_ns;
+    uint64_t last_delivery_ns;
+    uint64_t* latencies_ns;
+    uint32_t latency_capacity;
+    double throughput_pps;
+    double throughput_mbps;
+    double p50_us, p90_us, p99_us, max_us;
+} BenchRun;
+
+// ============================================================================
+// GLOBAL STATE
+// ============================================================================
+
+static volatile bool g_running = true;
+static bool g_collecting = true;
+
+static PoolContext app_pool;
+static PoolContext frame_pool;
+static MQContext mq_app_to_rrc;
+static MQContext mq_rrc_to_app;
+static MQContext mq_phy_queues[BENCH_DATATYPE_QUEUES];
+
+static pthread_mutex_t bench_lock = PTHREAD_MUTEX_INITIALIZER;
+static InflightEntry inflight[BENCH_MAX_INFLIGHT];
+static uint32_t inflight_count;
+static BenchRun* current_run;
+
+static pid_t daemon_pids[3];
+static int daemon_count;
+
+void signal_handler(int signum) {
+    (void)signum;
+    g_running = false;
+}
+
+// ============================================================================
+// ARGUMENT PARSING
+// ============================================================================
+
+/**
+ * Parse a comma-separated list of positive integers
+ * @return Number of values, -1 on error
+ */
+static int parse_int_list(const char* text, int* out, int max) {
+    char buf[256];
+    int count = 0;
+
+    strncpy(buf, text, sizeof(buf) - 1);
+    buf[sizeof(buf) - 1] = '\0';
+
+    for (char* tok = strtok(buf, ","); tok; tok = strtok(NULL, ",")) {
+        int value = atoi(tok);
+        if (value <= 0 || count >= max) return -1;
+        out[count++] = value;
+    }
+    return count > 0 ? count : -1;
+}
+
+/**
+ * Parse "name:weight,..." into per-DataType weights
+ * @return 0 on success, -1 on error
+ */
+static int parse_mix(const char* text, BenchConfig* cfg) {
+    char buf[256];
+
+    memset(cfg->mix, 0, sizeof(cfg->mix));
+    cfg->mix_total = 0;
+    strncpy(buf, text, sizeof(buf) - 1);
+    buf[sizeof(buf) - 1] = '\0';
+
+    for (char* tok = strtok(buf, ","); tok; tok = strtok(NULL, ",")) {
+        char* colon = strchr(tok, ':');
+        int weight = colon ? atoi(colon + 1) : 1;
+        int dtype = -1;
+
+        if (colon) *colon = '\0';
+        for (int i = 0; i < BENCH_DATATYPES; i++) {
+            if (strcmp(tok, datatype_names[i]) == 0) dtype = i;
+        }
+        if (dtype < 0 || weight < 0) return -1;
+        cfg->mix[dtype] += weight;
+        cfg->mix_total += weight;
+    }
+    return cfg->mix_total > 0 ? 0 : -1;
+}
+
+static void usage(const char* prog) {
+    fprintf(stderr,
+            "Usage: %s [-r rates] [-s sizes] [-d dests] [-m mix] [-t secs] [-n node]\n"
+            "          [-o results.json] [-x] [-v]\n"
+            "  -r RATES  offered loads to sweep, packets/s (default 25,50,100,200)\n"
+            "  -s SIZES  payload sizes in bytes, max %d (default 256)\n"
+            "  -d DESTS  destination node IDs (default 2,3,4)\n"
+            "  -m MIX    data-type weights, e.g. msg:60,voice:30,video:10\n"
+            "  -t SECS   seconds of load per run (default 5)\n"
+            "  -n NODE   node ID the daemons run as (default 1)\n"
+            "  -o FILE   write machine-readable results (JSON)\n"
+            "  -x        attach to running daemons instead of launching them\n"
+            "  -v        show launched daemons' output\n",
+            prog, PAYLOAD_SIZE_BYTES);
+}
+
+static int parse_args(int argc, char* argv[], BenchConfig* cfg) {
+    int opt;
+
+    memset(cfg, 0, sizeof(*cfg));
+    cfg->rate_count = parse_int_list("25,50,100,200", cfg->rates, BENCH_MAX_LIST);
+    cfg->size_count = parse_int_list("256", cfg->sizes, BENCH_MAX_LIST);
+    cfg->dest_count = parse_int_list("2,3,4", cfg->dests, BENCH_MAX_LIST);
+    parse_mix("msg:1", cfg);
+    cfg->duration_s = 5;
+    cfg->node_id = 1;
+
+    while ((opt = getopt(argc, argv, "r:s:d:m:t:n:o:xvh")) != -1) {
+        switch (opt) {
+            case 'r': cfg->rate_count = parse_int_list(optarg, cfg->rates, BENCH_MAX_LIST); break;
+            case 's': cfg->size_count = parse_int_list(optarg, cfg->sizes, BENCH_MAX_LIST); break;
+            case 'd': cfg->dest_count = parse_int_list(optarg, cfg->dests, BENCH_MAX_LIST); break;
+            case 'm':
+                if (parse_mix(optarg, cfg) < 0) {
+                    fprintf(stderr, "Invalid mix: %s\n", optarg);
+                    return -1;
+                }
+                break;
+            case 't': cfg->duration_s = atoi(optarg); break;
+            case 'n': cfg->node_id = (uint8_t)atoi(optarg); break;
+            case 'o': cfg->json_path = optarg; break;
+            case 'x': cfg->external = true; break;
+            case 'v': cfg->verbose = true; break;
+            default: return -1;
+        }
+    }
+
+    if (cfg->rate_count < 0 || cfg->size_count < 0 || cfg->dest_count < 0 ||
+        cfg->duration_s <= 0 || cfg->node_id == 0) {
+        return -1;
+    }
+    for (int i = 0; i < cfg->size_count; i++) {
+        if (cfg->sizes[i] > PAYLOAD_SIZE_BYTES) return -1;
+    }
+    for (int i = 0; i < cfg->dest_count; i++) {
+        if (cfg->dests[i] > 255) return -1;
+    }
+    return 0;
+}
+
+// ============================================================================
+// DAEMON LAUNCH AND ATTACH
+// ============================================================================
+
+static pid_t launch_daemon(const char* dir, const char* name, uint8_t node_id, bool verbose) {
+    char path[512];
+    char node_arg[8];
+
+    snprintf(path, sizeof(path), "%s/%s", dir, name);
+    snprintf(node_arg, sizeof(node_arg), "%u", node_id);
+
+    pid_t pid = fork();
+    if (pid == 0) {
+        if (!verbose) {
+            FILE* devnull = fopen("/dev/null", "w");
+            if (devnull) {
+                dup2(fileno(devnull), STDOUT_FILENO);
+                dup2(fileno(devnull), STDERR_FILENO);
+            }
+        }
+        execl(path, name, node_arg, (char*)NULL);
+        perror(path);
+        _exit(127);
+    }
+    if (pid < 0) {
+        perror("fork");
+    }
+    return pid;
+}
+
+static void stop_daemons(void) {
+    // Layer daemons first: rrc_core unlinks the queues they hold open
+    for (int i = daemon_count - 1; i >= 0; i--) {
+        kill(daemon_pids[i], SIGTERM);
+        waitpid(daemon_pids[i], NULL, 0);
+    }
+    daemon_count = 0;
+}
+
+/**
+ * Wait for rrc_core to finish creating its queues (the datatype queues come last)
+ */
+static bool wait_for_rrc_core(int timeout_ms) {
+    for (int waited = 0; waited < timeout_ms; waited += 50) {
+        mqd_t probe = mq_open(MQ_RRC_UNKNOWN_QUEUE, O_RDONLY);
+        if (probe != (mqd_t)-1) {
+            mq_close(probe);
+            return true;
+        }
+        usleep(50000);
+    }
+    return false;
+}
+
+static int start_pipeline(const BenchConfig* cfg, const char* dir) {
+    if (!cfg->external) {
+        daemon_pids[0] = launch_daemon(dir, "rrc_core", cfg->node_id, cfg->verbose);
+        if (daemon_pids[0] < 0) return -1;
+        daemon_count = 1;
+
+        if (!wait_for_rrc_core(5000)) {
+            fprintf(stderr, "[BENCH] rrc_core did not create its queues\n");
+            return -1;
+        }
+
+        daemon_pids[1] = launch_daemon(dir, "olsr_daemon", cfg->node_id, cfg->verbose);
+        if (daemon_pids[1] < 0) return -1;
+        daemon_count = 2;
+        daemon_pids[2] = launch_daemon(dir, "tdma_daemon", cfg->node_id, cfg->verbose);
+        if (daemon_pids[2] < 0) return -1;
+        daemon_count = 3;
+        usleep(200000);  // Let the daemons attach before load starts
+    }
+
+    if (pool_init(&app_pool, SHM_APP_POOL, sizeof(AppPacketPoolEntry), APP_POOL_SIZE, false) < 0 ||
+        pool_init(&frame_pool, SHM_FRAME_POOL, sizeof(FramePoolEntry), FRAME_POOL_SIZE, false) < 0) {
+        fprintf(stderr, "[BENCH] Failed to attach to shared memory pools\n");
+        return -1;
+    }
+
+    if (mq_init(&mq_app_to_rrc, MQ_APP_TO_RRC, O_WRONLY, false) < 0 ||
+        mq_init(&mq_rrc_to_app, MQ_RRC_TO_APP, O_RDONLY, false) < 0) {
+        fprintf(stderr, "[BENCH] Failed to open APP<->RRC queues\n");
+        return -1;
+    }
+
+    for (int i = 0; i < BENCH_DATATYPE_QUEUES; i++) {
+        if (mq_init(&mq_phy_queues[i], get_datatype_queue_name((DataType)i), O_RDONLY, false) < 0) {
+            fprintf(stderr, "[BENCH] Failed to open datatype queue %d\n", i);
+            return -1;
+        }
+    }
+    return 0;
+}
+
+static void stop_pipeline(void) {
+    for (int i = 0; i < BENCH_DATATYPE_QUEUES; i++) {
+        mq_cleanup(&mq_phy_queues[i], false);
+    }
+    mq_cleanup(&mq_app_to_rrc, false);
+    mq_cleanup(&mq_rrc_to_app, false);
+    pool_cleanup(&app_pool, SHM_APP_POOL, false);
+    pool_cleanup(&frame_pool, SHM_FRAME_POOL, false);
+    stop_daemons();
+}
+
+// ============================================================================
+// OUTCOME COLLECTION
+// ============================================================================
+
+/**
+ * Settle a request: delivered (reason < 0) or dropped for reason
+ * Outcomes for requests no longer tracked (a previous run) are ignored
+ */
+static void complete_request(uint32_t request_id, int reason, uint64_t now_ns) {
+    pthread_mutex_lock(&bench_lock);
+
+    InflightEntry* entry = &inflight[request_id & (BENCH_MAX_INFLIGHT - 1)];
+    BenchRun* run = current_run;
+
+    if (entry->active && entry->request_id == request_id && run) {
+        entry->active = false;
+        inflight_count--;
+        if (reason < 0) {
+            if (run->delivered < run->latency_capacity) {
+                run->latencies_ns[run->delivered] = now_ns - entry->send_ns;
+            }
+            run->delivered++;
+            run->last_delivery_ns = now_ns;
+        } else {
+            run->drops[reason]++;
+        }
+    }
+
+    pthread_mutex_unlock(&bench_lock);
+}
+
+static int drop_reason_for_error(uint8_t error_code) {
+    switch (error_code) {
+        case ERROR_OLSR_NO_ROUTE:         return DROP_NO_ROUTE;
+        case ERROR_TDMA_SLOT_UNAVAILABLE: return DROP_NO_SLOT;
+        case ERROR_BUFFER_FULL:           return DROP_FRAME_POOL_FULL;
+        case ERROR_TIMEOUT:               return DROP_TIMEOUT;
+        default:                          return DROP_OTHER;
+    }
+}
+
+/**
+ * Collector thread: acts as PHY on the datatype queues (releasing frames)
+ * and reads RRC error reports, settling requests as outcomes arrive
+ */
+static void* collector_thread(void* arg) {
+    MQMsgView views[MQ_BATCH_MAX];
+    (void)arg;
+
+    while (__atomic_load_n(&g_collecting, __ATOMIC_ACQUIRE)) {
+        int handled = 0;
+
+        for (int q = 0; q < BENCH_DATATYPE_QUEUES; q++) {
+            int n = mq_recv_peek(&mq_phy_queues[q], views, MQ_BATCH_MAX, 0);
+            uint64_t now_ns = mq_now_ns();
+            for (int i = 0; i < n; i++) {
+                const RrcToPhyMsg* phy = views[i].data;
+                if (views[i].len < sizeof(*phy)) continue;
+                // A stale generation means RRC evicted the frame after queueing it
+                if (frame_pool_release_gen(&frame_pool, phy->pool_index, phy->generation) < 0) {
+                    complete_request(phy->header.request_id, DROP_EVICTED, now_ns);
+                    continue;
+                }
+                complete_request(phy->header.request_id, -1, now_ns);
+            }
+            mq_recv_release(&mq_phy_queues[q]);
+            handled += n > 0 ? n : 0;
+        }
+
+        int n = mq_recv_peek(&mq_rrc_to_app, views, MQ_BATCH_MAX, 0);
+        uint64_t now_ns = mq_now_ns();
+        for (int i = 0; i < n; i++) {
+            const RrcToAppMsg* msg = views[i].data;
+            if (views[i].len < sizeof(*msg)) continue;
+            if (msg->is_error) {
+                complete_request(msg->header.request_id, drop_reason_for_error(msg->error_code), now_ns);
+            } else {
+                frame_pool_release_gen(&frame_pool, msg->pool_index, msg->generation);  // RX delivery, not ours
+            }
+        }
+        mq_recv_release(&mq_rrc_to_app);
+        handled += n > 0 ? n : 0;
+
+        if (handled == 0) {
+            usleep(50);
+        }
+    }
+    return NULL;
+}
+
+// ============================================================================
+// LOAD GENERATION
+// ============================================================================
+
+static DataType pick_datatype(const BenchConfig* cfg) {
+    int r = rand() % cfg->mix_total;
+    for (int i = 0; i < BENCH_DATATYPES; i++) {
+        if (r < cfg->mix[i]) return (DataType)i;
+        r -= cfg->mix[i];
+    }
+    return DATA_TYPE_MSG;
+}
+
+/**
+ * Offer one packet to RRC the way an application would
+ */
+static void offer_packet(const BenchConfig* cfg, BenchRun* run, uint32_t seq) {
+    DataType dtype = pick_datatype(cfg);
+    uint8_t dest = (uint8_t)cfg->dests[rand() % cfg->dest_count];
+    struct mq_attr attr;
+
+    run->offered++;
+
+    int pool_idx = app_pool_alloc(&app_pool);
+    if (pool_idx < 0) {
+        run->drops[DROP_APP_POOL_FULL]++;
+        return;
+    }
+
+    // Open loop: never block on a full queue, count it instead
+    if (mq_get_attr(&mq_app_to_rrc, &attr) == 0 && attr.mq_curmsgs >= attr.mq_maxmsg) {
+        app_pool_release(&app_pool, pool_idx);
+        run->drops[DROP_QUEUE_FULL]++;
+        return;
+    }
+
+    AppPacketPoolEntry* pkt = app_pool_get(&app_pool, pool_idx);
+    pkt->src_id = cfg->node_id;
+    pkt->dest_id = dest;
+    pkt->data_type = dtype;
+    pkt->transmission_type = 0;  // Unicast
+    pkt->priority = 5;
+    pkt->payload_len = (uint16_t)run->payload_bytes;
+    pkt->sequence_number = seq;
+    pkt->timestamp_ms = get_timestamp_ms();
+    pkt->urgent = false;
+    pkt->flags = 0;
+    memset(pkt->payload, (int)(seq & 0xFF), run->payload_bytes);
+
+    AppToRrcMsg msg;
+    init_message_header(&msg.header, MSG_APP_TO_RRC_DATA);
+    msg.pool_index = pool_idx;
+    msg.data_type = dtype;
+    msg.priority = pkt->priority;
+
+    pthread_mutex_lock(&bench_lock);
+    InflightEntry* entry = &inflight[msg.header.request_id & (BENCH_MAX_INFLIGHT - 1)];
+    entry->request_id = msg.header.request_id;
+    entry->send_ns = mq_now_ns();
+    entry->active = true;
+    inflight_count++;
+    pthread_mutex_unlock(&bench_lock);
+
+    if (mq_send_msg(&mq_app_to_rrc, &msg, sizeof(msg), msg.priority) < 0) {
+        pthread_mutex_lock(&bench_lock);
+        entry->active = false;
+        inflight_count--;
+        pthread_mutex_unlock(&bench_lock);
+        app_pool_release(&app_pool, pool_idx);
+        run->drops[DROP_QUEUE_FULL]++;
+        return;
+    }
+    run->sent++;
+}
+
+static int compare_u64(const void* a, const void* b) {
+    uint64_t x = *(const uint64_t*)a;
+    uint64_t y = *(const uint64_t*)b;
+    return x < y ? -1 : (x > y ? 1 : 0);
+}
+
+static double percentile_us(const uint64_t* sorted, uint32_t count, double pct) {
+    if (count == 0) return 0.0;
+    uint32_t idx = (uint32_t)(pct / 100.0 * (count - 1) + 0.5);
+    return sorted[idx] / 1000.0;
+}
+
+/**
+ * One run at a fixed size and rate: paced load, then drain outstanding requests
+ */
+static void run_load(const BenchConfig* cfg, BenchRun* run) {
+    uint64_t interval_ns = 1000000000ULL / run->offered_pps;
+    uint64_t duration_ns = (uint64_t)cfg->duration_s * 1000000000ULL;
+    uint32_t seq = 0;
+
+    run->latency_capacity = (uint32_t)((uint64_t)run->offered_pps * cfg->duration_s + 16);
+    run->latencies_ns = calloc(run->latency_capacity, sizeof(uint64_t));
+
+    pthread_mutex_lock(&bench_lock);
+    current_run = run;
+    pthread_mutex_unlock(&bench_lock);
+
+    run->start_ns = mq_now_ns();
+    uint64_t next_ns = run->start_ns;
+
+    while (g_running && next_ns < run->start_ns + duration_ns) {
+        struct timespec ts = { (time_t)(next_ns / 1000000000ULL), (long)(next_ns % 1000000000ULL) };
+        clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL);
+        offer_packet(cfg, run, seq++);
+        next_ns += interval_ns;
+    }
+
+    // Drain: RRC may still hold a backlog, and a layer timeout takes REQUEST_TIMEOUT_MS
+    uint64_t drain_deadline = mq_now_ns() + (uint64_t)BENCH_DRAIN_MS * 1000000ULL;
+    for (;;) {
+        pthread_mutex_lock(&bench_lock);
+        uint32_t outstanding = inflight_count;
+        pthread_mutex_unlock(&bench_lock);
+        if (outstanding == 0 || !g_running || mq_now_ns() >= drain_deadline) break;
+        usleep(1000);
+    }
+
+    pthread_mutex_lock(&bench_lock);
+    for (int i = 0; i < BENCH_MAX_INFLIGHT; i++) {
+        if (inflight[i].active) {
+            inflight[i].active = false;
+            run->drops[DROP_LOST]++;
+        }
+    }
+    inflight_count = 0;
+    current_run = NULL;
+    pthread_mutex_unlock(&bench_lock);
+
+    uint32_t samples = run->delivered < run->latency_capacity ? run->delivered : run->latency_capacity;
+    qsort(run->latencies_ns, samples, sizeof(uint64_t), compare_u64);
+    run->p50_us = percentile_us(run->latencies_ns, samples, 50.0);
+    run->p90_us = percentile_us(run->latencies_ns, samples, 90.0);
+    run->p99_us = percentile_us(run->latencies_ns, samples, 99.0);
+    run->max_us = samples ? run->latencies_ns[samples - 1] / 1000.0 : 0.0;
+
+    double elapsed_s = run->delivered ? (run->last_delivery_ns - run->start_ns) / 1e9 : 0.0;
+    if (elapsed_s > 0) {
+        run->throughput_pps = run->delivered / elapsed_s;
+        run->throughput_mbps = run->throughput_pps * run->payload_bytes * 8 / 1e6;
+    }
+}
+
+// ============================================================================
+// REPORTING
+// ============================================================================
+
+static void print_run(const BenchRun* run) {
+    printf("%6d %7d %7u %7u %7u %9.1f %8.3f", run->payload_bytes, run->offered_pps,
+           run->offered, run->sent, run->delivered, run->throughput_pps, run->throughput_mbps);
+    for (int i = 0; i < DROP_REASON_COUNT; i++) {
+        printf(" %*u", (int)strlen(drop_reason_names[i]) < 6 ? 6 : (int)strlen(drop_reason_names[i]),
+               run->drops[i]);
+    }
+    printf(" %9.0f %9.0f %9.0f %9.0f\n", run->p50_us, run->p90_us, run->p99_us, run->max_us);
+}
+
+static void print_header(void) {
+    printf("%6s %7s %7s %7s %7s %9s %8s", "size", "rate", "offered", "sent", "deliv",
+           "thr_pps", "thr_mbps");
+    for (int i = 0; i < DROP_REASON_COUNT; i++) {
+        printf(" %6s", drop_reason_names[i]);
+    }
+    printf(" %9s %9s %9s %9s\n", "p50_us", "p90_us", "p99_us", "max_us");
+}
+
+static int write_json(const BenchConfig* cfg, const BenchRun* runs, int run_count) {
+    FILE* f = fopen(cfg->json_path, "w");
+    if (!f) {
+        perror(cfg->json_path);
+        return -1;
+    }
+
+    fprintf(f, "{\n  \"benchmark\": \"rrc_pipeline\",\n");
+    fprintf(f, "  \"timestamp\": %ld,\n", (long)time(NULL));
+    fprintf(f, "  \"node_id\": %u,\n", cfg->node_id);
+    fprintf(f, "  \"backend\": \"%s\",\n",
+            mq_app_to_rrc.backend == MQ_BACKEND_SHM_RING ? "shm" : "posix");
+    fprintf(f, "  \"duration_s\": %d,\n", cfg->duration_s);
+    fprintf(f, "  \"destinations\": [");
+    for (int i = 0; i < cfg->dest_count; i++) {
+        fprintf(f, "%s%d", i ? ", " : "", cfg->dests[i]);
+    }
+    fprintf(f, "],\n  \"mix\": {");
+    for (int i = 0, first = 1; i < BENCH_DATATYPES; i++) {
+        if (cfg->mix[i] == 0) continue;
+        fprintf(f, "%s\"%s\": %d", first ? "" : ", ", datatype_names[i], cfg->mix[i]);
+        first = 0;
+    }
+    fprintf(f, "},\n  \"runs\": [\n");
+
+    for (int r = 0; r < run_count; r++) {
+        const BenchRun* run = &runs[r];
+        fprintf(f, "    {\"payload_bytes\": %d, \"offered_pps\": %d, \"offered\": %u, "
+                   "\"sent\": %u, \"delivered\": %u,\n",
+                run->payload_bytes, run->offered_pps, run->offered, run->sent, run->delivered);
+        fprintf(f, "     \"throughput_pps\": %.1f, \"throughput_mbps\": %.3f,\n",
+                run->throughput_pps, run->throughput_mbps);
+        fprintf(f, "     \"drops\": {");
+        for (int i = 0; i < DROP_REASON_COUNT; i++) {
+            fprintf(f, "%s\"%s\": %u", i ? ", " : "", drop_reason_names[i], run->drops[i]);
+        }
+        fprintf(f, "},\n     \"latency_us\": {\"p50\": %.1f, \"p90\": %.1f, \"p99\": %.1f, "
+                   "\"max\": %.1f}}%s\n",
+                run->p50_us, run->p90_us, run->p99_us, run->max_us, r + 1 < run_count ? "," : "");
+    }
+
+    fprintf(f, "  ]\n}\n");
+    fclose(f);
+    return 0;
+}
+
+// ============================================================================
+// MAIN FUNCTION
+// ============================================================================
+
+int main(int argc, char* argv[]) {
+    BenchConfig cfg;
+    char dir[512] = ".";
+
+    if (parse_args(argc, argv, &cfg) < 0) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    // Daemons live next to this binary
+    const char* slash = strrchr(argv[0], '/');
+    if (slash) {
+        snprintf(dir, sizeof(dir), "%.*s", (int)(slash - argv[0]), argv[0]);
+    }
+
+    signal(SIGINT, signal_handler);
+    signal(SIGTERM, signal_handler);
+    srand(1);  // Same offered sequence every run, for comparable results
+
+    printf("========================================\n");
+    printf("RRC Pipeline Benchmark\n");
+    printf("Node ID: %d, %d s per run, %s daemons\n", cfg.node_id, cfg.duration_s,
+           cfg.external ? "external" : "launched");
+    printf("========================================\n\n");
+
+    if (start_pipeline(&cfg, dir) < 0) {
+        stop_pipeline();
+        return 1;
+    }
+
+    pthread_t collector;
+    if (pthread_create(&collector, NULL, collector_thread, NULL) != 0) {
+        fprintf(stderr, "[BENCH] Failed to create collector thread\n");
+        stop_pipeline();
+        return 1;
+    }
+
+    int run_count = cfg.size_count * cfg.rate_count;
+    BenchRun* runs = calloc(run_count, sizeof(BenchRun));
+    int done = 0;
+
+    printf("[BENCH] Backend: %s\n\n", mq_app_to_rrc.backend == MQ_BACKEND_SHM_RING ? "shm" : "posix");
+    print_header();
+
+    for (int s = 0; s < cfg.size_count && g_running; s++) {
+        for (int r = 0; r < cfg.rate_count && g_running; r++) {
+            BenchRun* run = &runs[done];
+            run->payload_bytes = cfg.sizes[s];
+            run->offered_pps = cfg.rates[r];
+            run_load(&cfg, run);
+            print_run(run);
+            fflush(stdout);
+            done++;
+        }
+    }
+
+    __atomic_store_n(&g_collecting, false, __ATOMIC_RELEASE);
+    pthread_join(collector, NULL);
+
+    int ret = 0;
+    if (cfg.json_path) {
+        if (write_json(&cfg, runs, done) == 0) {
+            printf("\n[BENCH] Results written to %s\n", cfg.json_path);
+        } else {
+            ret = 1;
+        }
+    }
+
+    for (int i = 0; i < done; i++) {
+        free(runs[i].latencies_ns);
+    }
+    free(runs);
+    stop_pipeline();
+    return ret;
+}
@@ -15,7 +15,12 @@
 // ============================================================================
 
 #define MAX_MQ_MSG_SIZE 2048           // POSIX MQ message size limit
+#define MQ_DEFAULT_DEPTH 10            // Queue depth when no per-queue config applies
+#define MQ_CONTROL_DEPTH 64            // Depth of the RRC<->layer control queues
+#define MQ_CONTROL_MSG_SIZE 128        // Control queues carry only the small structs below
+#define MQ_BATCH_MAX 32                // Most messages moved by one batch call
 #define FRAME_POOL_SIZE 64             // Number of frame pool entries
+#define FRAME_POOL_HIGH_WATERMARK 48   // Above this, discardable frames are dropped
 #define APP_POOL_SIZE 32               // Number of app packet pool entries
 #define PAYLOAD_SIZE_BYTES 2800        // From rrc1011.c
 #define REQUEST_TIMEOUT_MS 5000        // Default timeout for requests
@@ -77,7 +82,10 @@ typedef enum {
     MSG_TDMA_TO_RRC_NC_RSP = 24,
     
     // MAC -> RRC
-    MSG_MAC_TO_RRC_RX_FRAME = 30
+    MSG_MAC_TO_RRC_RX_FRAME = 30,
+    
+    // RRC -> PHY (per-datatype queues)
+    MSG_RRC_TO_PHY_TX_FRAME = 40
 } MessageType;
 
 typedef enum {
@@ -90,6 +98,10 @@ typedef enum {
     DATA_TYPE_UNKNOWN = 99
 } DataType;
 
+// Frame flags (FramePoolEntry.flags / AppPacketPoolEntry.flags)
+#define FRAME_FLAG_KEYFRAME     0x01   // Video keyframe or stream header, never dropped first
+#define FRAME_FLAG_DISCARDABLE  0x02   // Video delta frame, first to go under congestion
+
 typedef enum {
     ERROR_OLSR_NO_ROUTE = 1,
     ERROR_TDMA_SLOT_UNAVAILABLE = 2,
@@ -114,8 +126,9 @@ typedef struct {
     uint32_t sequence_number;
     uint32_t timestamp_ms;
     uint8_t payload[PAYLOAD_SIZE_BYTES];
-    bool in_use;
     bool valid;
+    uint8_t flags;             // FRAME_FLAG_*
+    uint32_t generation;       // Odd while allocated; bumped on alloc, release and eviction
 } FramePoolEntry;
 
 // Application packet pool entry in shared memory
@@ -131,6 +144,7 @@ typedef struct {
     uint8_t payload[PAYLOAD_SIZE_BYTES];
     bool in_use;
     bool urgent;
+    uint8_t flags;             // FRAME_FLAG_*
 } AppPacketPoolEntry;
 
 // ============================================================================
@@ -160,6 +174,7 @@ typedef struct {
     uint8_t is_error;          // 0=frame delivery, 1=error
     uint8_t error_code;        // ErrorCode if is_error=1
     char error_text[64];       // Human-readable error
+    uint32_t generation;       // FramePoolEntry.generation at send time
 } RrcToAppMsg;
 
 // RRC -> OLSR: Route lookup request
@@ -207,6 +222,15 @@ typedef struct {
     float snr_db;
 } MacToRrcMsg;
 
+// RRC -> PHY: Frame ready for transmission
+typedef struct {
+    MessageHeader header;      // request_id echoes the AppToRrcMsg it came from
+    uint16_t pool_index;       // Index into SHM_FRAME_POOL; PHY releases it
+    uint8_t next_hop;
+    uint8_t assigned_slot;
+    uint32_t generation;       // FramePoolEntry.generation at send time
+} RrcToPhyMsg;
+
 // Generic message union (for convenience)
 typedef union {
     MessageHeader header;
@@ -217,6 +241,7 @@ typedef union {
     RrcToTdmaMsg rrc_to_tdma;
     TdmaToRrcMsg tdma_to_rrc;
     MacToRrcMsg mac_to_rrc;
+    RrcToPhyMsg rrc_to_phy;
     uint8_t raw[MAX_MQ_MSG_SIZE];
 } GenericMessage;
 
@@ -236,6 +261,7 @@ typedef struct {
     uint32_t release_count;
     uint32_t in_use_count;
     uint32_t overflow_count;
+    uint32_t evicted_count;    // Discardable entries reclaimed under pressure
 } PoolStats;
 
 #endif // RRC_POSIX_MQ_DEFS_H
@@ -13,14 +13,21 @@
 #include <unistd.h>
 #include <string.h>
 #include <errno.h>
+#include <stddef.h>
 
 // ============================================================================
 // POOL MANAGEMENT STRUCTURES
 // ============================================================================
 
+// Shared bookkeeping placed after the entry array, visible to every attacher
+typedef struct {
+    uint32_t in_use;           // Entries currently allocated (all processes)
+} PoolControl;
+
 typedef struct {
     int shm_fd;
     void* base_ptr;
+    PoolControl* control;
     size_t entry_size;
     size_t pool_size;
     PoolStats stats;
@@ -48,7 +55,7 @@ static inline int pool_init(PoolContext* ctx, const char* shm_name,
     ctx->entry_size = entry_size;
     ctx->pool_size = pool_size;
     
-    size_t total_size = entry_size * pool_size;
+    size_t total_size = entry_size * pool_size + sizeof(PoolControl);
     
     if (create_new) {
         // Create new shared memory
@@ -86,6 +93,7 @@ static inline int pool_init(PoolContext* ctx, const char* shm_name,
     if (create_new) {
         memset(ctx->base_ptr, 0, total_size);
     }
+    ctx->control = (PoolControl*)((uint8_t*)ctx->base_ptr + entry_size * pool_size);
     
     ctx->initialized = true;
     return 0;
@@ -97,7 +105,7 @@ static inline int pool_init(PoolContext* ctx, const char* shm_name,
 static inline void pool_cleanup(PoolContext* ctx, const char* shm_name, bool unlink) {
     if (!ctx || !ctx->initialized) return;
     
-    size_t total_size = ctx->entry_size * ctx->pool_size;
+    size_t total_size = ctx->entry_size * ctx->pool_size + sizeof(PoolControl);
     
     if (ctx->base_ptr != NULL && ctx->base_ptr != MAP_FAILED) {
         munmap(ctx->base_ptr, total_size);
@@ -118,6 +126,21 @@ static inline void pool_cleanup(PoolContext* ctx, const char* shm_name, bool unl
 // FRAME POOL OPERATIONS
 // ============================================================================
 
+// Frame entries are handed between processes by index, so ownership is
+// tracked by FramePoolEntry.generation alone: odd while allocated, even while free.
+// Every transition is a CAS on the generation, and messages carry the value
+// seen at send time. A holder whose generation no longer matches has lost the
+// entry (released or evicted) and must not touch or release it.
+
+static inline bool frame_pool_entry_in_use(const FramePoolEntry* entry) {
+    return (__atomic_load_n(&entry->generation, __ATOMIC_ACQUIRE) & 1u) != 0;
+}
+
+static inline bool frame_gen_claim(FramePoolEntry* entry, uint32_t expected, uint32_t next) {
+    return __atomic_compare_exchange_n(&entry->generation, &expected, next, false,
+                                       __ATOMIC_ACQ_REL, __ATOMIC_RELAXED);
+}
+
 /**
  * Allocate a free frame from the pool
  * @return pool_index on success, -1 if pool full
@@ -128,11 +151,13 @@ static inline int frame_pool_alloc(PoolContext* ctx) {
     FramePoolEntry* entries = (FramePoolEntry*)ctx->base_ptr;
     
     for (size_t i = 0; i < ctx->pool_size; i++) {
-        if (!entries[i].in_use) {
-            entries[i].in_use = true;
+        uint32_t gen = __atomic_load_n(&entries[i].generation, __ATOMIC_RELAXED);
+        if ((gen & 1u) == 0 && frame_gen_claim(&entries[i], gen, gen + 1)) {
             entries[i].valid = false;
+            entries[i].flags = 0;
             memset(entries[i].payload, 0, PAYLOAD_SIZE_BYTES);
             
+            __atomic_add_fetch(&ctx->control->in_use, 1, __ATOMIC_RELAXED);
             ctx->stats.alloc_count++;
             ctx->stats.in_use_count++;
             return (int)i;
@@ -144,26 +169,115 @@ static inline int frame_pool_alloc(PoolContext* ctx) {
 }
 
 /**
- * Release a frame back to the pool
+ * Current generation of an allocated frame, to be sent along with its index
  */
-static inline int frame_pool_release(PoolContext* ctx, uint16_t pool_index) {
+static inline uint32_t frame_pool_generation(PoolContext* ctx, uint16_t pool_index) {
+    if (!ctx || !ctx->initialized || pool_index >= ctx->pool_size) return 0;
+    
+    FramePoolEntry* entries = (FramePoolEntry*)ctx->base_ptr;
+    return __atomic_load_n(&entries[pool_index].generation, __ATOMIC_ACQUIRE);
+}
+
+/**
+ * Release a frame back to the pool if it is still the generation the caller
+ * was handed. A stale generation (entry evicted or already released) fails.
+ * @return 0 on success, -1 if the caller no longer owns the entry
+ */
+static inline int frame_pool_release_gen(PoolContext* ctx, uint16_t pool_index,
+                                         uint32_t generation) {
     if (!ctx || !ctx->initialized) return -1;
-    if (pool_index >= ctx->pool_size) return -1;
+    if (pool_index >= ctx->pool_size || (generation & 1u) == 0) return -1;
     
     FramePoolEntry* entries = (FramePoolEntry*)ctx->base_ptr;
     
-    if (!entries[pool_index].in_use) {
-        return -1;  // Already released
+    // The next owner resets valid on alloc, so the entry is not touched after the CAS
+    if (!frame_gen_claim(&entries[pool_index], generation, generation + 1)) {
+        return -1;  // Evicted or already released
     }
     
-    entries[pool_index].in_use = false;
-    entries[pool_index].valid = false;
-    
+    __atomic_sub_fetch(&ctx->control->in_use, 1, __ATOMIC_RELAXED);
     ctx->stats.release_count++;
     ctx->stats.in_use_count--;
     return 0;
 }
 
+/**
+ * Release a frame back to the pool (caller is the sole owner in this process)
+ */
+static inline int frame_pool_release(PoolContext* ctx, uint16_t pool_index) {
+    uint32_t gen = frame_pool_generation(ctx, pool_index);
+    if ((gen & 1u) == 0) {
+        return -1;  // Already released
+    }
+    return frame_pool_release_gen(ctx, pool_index, gen);
+}
+
+/**
+ * Reclaim one discardable frame (e.g. a video delta frame) to make room
+ * for a frame that must not be dropped. Oldest discardable entry goes first.
+ * The victim's generation is advanced, so the PHY holding the old message
+ * sees a stale generation and drops it instead of sending or releasing.
+ * @return pool_index of the reclaimed (now allocated) entry, -1 if none
+ */
+static inline int frame_pool_evict_discardable(PoolContext* ctx) {
+    if (!ctx || !ctx->initialized) return -1;
+    
+    FramePoolEntry* entries = (FramePoolEntry*)ctx->base_ptr;
+    
+    for (;;) {
+        int victim = -1;
+        uint32_t victim_gen = 0;
+        
+        for (size_t i = 0; i < ctx->pool_size; i++) {
+            uint32_t gen = __atomic_load_n(&entries[i].generation, __ATOMIC_ACQUIRE);
+            if ((gen & 1u) && (entries[i].flags & FRAME_FLAG_DISCARDABLE)) {
+                if (victim < 0 || entries[i].timestamp_ms < entries[victim].timestamp_ms) {
+                    victim = (int)i;
+                    victim_gen = gen;
+                }
+            }
+        }
+        
+        if (victim < 0) return -1;
+        
+        // Odd -> odd: ownership moves to us without the entry ever looking free
+        if (!frame_gen_claim(&entries[victim], victim_gen, victim_gen + 2)) {
+            continue;  // Released by its reader meanwhile, pick again
+        }
+        
+        entries[victim].valid = false;
+        entries[victim].flags = 0;
+        memset(entries[victim].payload, 0, PAYLOAD_SIZE_BYTES);
+        ctx->stats.evicted_count++;
+        ctx->stats.alloc_count++;
+        ctx->stats.release_count++;
+        return victim;
+    }
+}
+
+/**
+ * Number of frames currently allocated across all processes
+ */
+static inline size_t frame_pool_in_use(PoolContext* ctx) {
+    if (!ctx || !ctx->initialized) return 0;
+    return __atomic_load_n(&ctx->control->in_use, __ATOMIC_RELAXED);
+}
+
+/**
+ * Get a frame only if it still carries the generation the caller was sent.
+ * Readers that may race an eviction should re-check frame_pool_generation()
+ * after copying the payload out.
+ * @return Entry pointer, or NULL if released or reused since
+ */
+static inline FramePoolEntry* frame_pool_get_gen(PoolContext* ctx, uint16_t pool_index,
+                                                 uint32_t generation) {
+    if (frame_pool_generation(ctx, pool_index) != generation || (generation & 1u) == 0) {
+        return NULL;
+    }
+    FramePoolEntry* entries = (FramePoolEntry*)ctx->base_ptr;
+    return &entries[pool_index];
+}
+
 /**
  * Get pointer to frame at pool_index
  */
@@ -184,10 +298,11 @@ static inline int frame_pool_set(PoolContext* ctx, uint16_t pool_index,
     if (pool_index >= ctx->pool_size) return -1;
     
     FramePoolEntry* entries = (FramePoolEntry*)ctx->base_ptr;
-    if (!entries[pool_index].in_use) return -1;
+    if (!frame_pool_entry_in_use(&entries[pool_index])) return -1;
     
-    memcpy(&entries[pool_index], data, sizeof(FramePoolEntry));
-    entries[pool_index].in_use = true;
+    // Frame contents only; the generation belongs to the pool
+    memcpy(&entries[pool_index], data, offsetof(FramePoolEntry, valid));
+    entries[pool_index].flags = data->flags;
     entries[pool_index].valid = true;
     
     return 0;
@@ -207,6 +322,7 @@ static inline int app_pool_alloc(PoolContext* ctx) {
             entries[i].in_use = true;
             memset(entries[i].payload, 0, PAYLOAD_SIZE_BYTES);
             
+            __atomic_add_fetch(&ctx->control->in_use, 1, __ATOMIC_RELAXED);
             ctx->stats.alloc_count++;
             ctx->stats.in_use_count++;
             return (int)i;
@@ -226,6 +342,7 @@ static inline int app_pool_release(PoolContext* ctx, uint16_t pool_index) {
     if (!entries[pool_index].in_use) return -1;
     
     entries[pool_index].in_use = false;
+    __atomic_sub_fetch(&ctx->control->in_use, 1, __ATOMIC_RELAXED);
     ctx->stats.release_count++;
     ctx->stats.in_use_count--;
     return 0;
@@ -260,6 +377,9 @@ static inline int app_pool_set(PoolContext* ctx, uint16_t pool_index,
 static inline void pool_get_stats(PoolContext* ctx, PoolStats* stats) {
     if (!ctx || !stats) return;
     memcpy(stats, &ctx->stats, sizeof(PoolStats));
+    if (ctx->initialized) {
+        stats->in_use_count = __atomic_load_n(&ctx->control->in_use, __ATOMIC_RELAXED);
+    }
 }
 
 static inline void pool_reset_stats(PoolContext* ctx) {
@@ -0,0 +1,311 @@
+/**
+ * Hierarchical Timer Wheel for RRC timeouts
+ *
+ * Millisecond ticks: 256 x 1ms buckets at level 0, then three 64-bucket
+ * levels cascading down (~18h horizon). Arm and cancel are O(1) list
+ * operations; advancing walks only occupied level-0 buckets (located
+ * through an occupancy bitmap) plus one cascade per 256ms, so the cost of
+ * servicing follows the number of expiring timers.
+ *
+ * A timer is identified by (kind, key); at most one is armed per pair.
+ * Expired timers are freed before their callback runs, so callbacks may
+ * re-arm or cancel any timer. The caller supplies the clock. Not
+ * thread-safe.
+ */
+
+#ifndef RRC_TIMER_WHEEL_H
+#define RRC_TIMER_WHEEL_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define RRC_TIMER_POOL_SIZE 256
+#define RRC_TIMER_MAX_KINDS 8
+#define RRC_TIMER_L0_BITS 8
+#define RRC_TIMER_LN_BITS 6
+#define RRC_TIMER_L0_SLOTS (1 << RRC_TIMER_L0_BITS)
+#define RRC_TIMER_LN_SLOTS (1 << RRC_TIMER_LN_BITS)
+#define RRC_TIMER_LEVELS 4
+#define RRC_TIMER_BUCKETS (RRC_TIMER_L0_SLOTS + (RRC_TIMER_LEVELS - 1) * RRC_TIMER_LN_SLOTS)
+#define RRC_TIMER_FIRING_BUCKET RRC_TIMER_BUCKETS // Expired list being dispatched
+#define RRC_TIMER_MAX_DELAY_MS ((1u << (RRC_TIMER_L0_BITS + 3 * RRC_TIMER_LN_BITS)) - 1)
+#define RRC_TIMER_NONE (-1)
+
+typedef struct
+{
+    uint32_t expires_ms;
+    int16_t next;
+    int16_t prev;
+    int16_t bucket; // RRC_TIMER_NONE when on the free list
+    uint8_t kind;
+    uint8_t key;
+} RRC_Timer;
+
+typedef struct
+{
+    RRC_Timer pool[RRC_TIMER_POOL_SIZE];
+    int16_t bucket_head[RRC_TIMER_BUCKETS + 1];
+    uint32_t l0_occupied[RRC_TIMER_L0_SLOTS / 32];
+    int16_t by_key[RRC_TIMER_MAX_KINDS][256];
+    int16_t free_head;
+    uint32_t now; // Next millisecond tick to process
+
+    // Statistics
+    uint32_t armed;
+    uint32_t cancelled;
+    uint32_t cascaded;
+    uint32_t pool_exhausted;
+} RRC_TimerWheel;
+
+typedef void (*rrc_timer_fire_cb)(uint8_t kind, uint8_t key, void *user);
+
+static inline void rrc_timer_wheel_init(RRC_TimerWheel *w, uint32_t now_ms)
+{
+    for (int i = 0; i <= RRC_TIMER_BUCKETS; i++)
+        w->bucket_head[i] = RRC_TIMER_NONE;
+    for (int i = 0; i < RRC_TIMER_L0_SLOTS / 32; i++)
+        w->l0_occupied[i] = 0;
+    for (int k = 0; k < RRC_TIMER_MAX_KINDS; k++)
+        for (int n = 0; n < 256; n++)
+            w->by_key[k][n] = RRC_TIMER_NONE;
+
+    // Thread the free list through next
+    for (int i = 0; i < RRC_TIMER_POOL_SIZE; i++)
+    {
+        w->pool[i].bucket = RRC_TIMER_NONE;
+        w->pool[i].prev = RRC_TIMER_NONE;
+        w->pool[i].next = (i + 1 < RRC_TIMER_POOL_SIZE) ? (int16_t)(i + 1) : RRC_TIMER_NONE;
+    }
+    w->free_head = 0;
+
+    w->now = now_ms;
+    w->armed = 0;
+    w->cancelled = 0;
+    w->cascaded = 0;
+    w->pool_exhausted = 0;
+}
+
+// Bucket for an expiry relative to the current wheel position
+static inline int rrc_timer_wheel_bucket_for(const RRC_TimerWheel *w, uint32_t *expires_ms)
+{
+    int32_t signed_delta = (int32_t)(*expires_ms - w->now);
+    uint32_t delta;
+
+    if (signed_delta < 0)
+    {
+        // Already due: run on the next tick processed
+        *expires_ms = w->now;
+        delta = 0;
+    }
+    else
+    {
+        delta = (uint32_t)signed_delta;
+        if (delta > RRC_TIMER_MAX_DELAY_MS)
+        {
+            *expires_ms = w->now + RRC_TIMER_MAX_DELAY_MS;
+            delta = RRC_TIMER_MAX_DELAY_MS;
+        }
+    }
+
+    uint32_t expires = *expires_ms;
+    if (delta < RRC_TIMER_L0_SLOTS)
+        return (int)(expires & (RRC_TIMER_L0_SLOTS - 1));
+
+    for (int level = 1; level < RRC_TIMER_LEVELS; level++)
+    {
+        uint32_t shift = RRC_TIMER_L0_BITS + (uint32_t)level * RRC_TIMER_LN_BITS;
+        if (level == RRC_TIMER_LEVELS - 1 || delta < (1u << shift))
+        {
+            uint32_t index = (expires >> (shift - RRC_TIMER_LN_BITS)) & (RRC_TIMER_LN_SLOTS - 1);
+            return RRC_TIMER_L0_SLOTS + (level - 1) * RRC_TIMER_LN_SLOTS + (int)index;
+        }
+    }
+    return 0; // Not reached
+}
+
+static inline void rrc_timer_wheel_link(RRC_TimerWheel *w, int16_t t, int bucket)
+{
+    RRC_Timer *timer = &w->pool[t];
+    timer->bucket = (int16_t)bucket;
+    timer->prev = RRC_TIMER_NONE;
+    timer->next = w->bucket_head[bucket];
+    if (timer->next != RRC_TIMER_NONE)
+        w->pool[timer->next].prev = t;
+    w->bucket_head[bucket] = t;
+
+    if (bucket < RRC_TIMER_L0_SLOTS)
+        w->l0_occupied[bucket >> 5] |= 1u << (bucket & 31);
+}
+
+static inline void rrc_timer_wheel_unlink(RRC_TimerWheel *w, int16_t t)
+{
+    RRC_Timer *timer = &w->pool[t];
+    int bucket = timer->bucket;
+
+    if (timer->prev != RRC_TIMER_NONE)
+        w->pool[timer->prev].next = timer->next;
+    else
+        w->bucket_head[bucket] = timer->next;
+    if (timer->next != RRC_TIMER_NONE)
+        w->pool[timer->next].prev = timer->prev;
+
+    if (bucket < RRC_TIMER_L0_SLOTS && w->bucket_head[bucket] == RRC_TIMER_NONE)
+        w->l0_occupied[bucket >> 5] &= ~(1u << (bucket & 31));
+
+    timer->bucket = RRC_TIMER_NONE;
+}
+
+static inline void rrc_timer_wheel_free(RRC_TimerWheel *w, int16_t t)
+{
+    w->by_key[w->pool[t].kind][w->pool[t].key] = RRC_TIMER_NONE;
+    w->pool[t].next = w->free_head;
+    w->free_head = t;
+}
+
+/**
+ * Arm (or re-arm) the timer for (kind, key) to fire at expires_ms.
+ * Expiries in the past fire on the next tick processed; those beyond
+ * RRC_TIMER_MAX_DELAY_MS are clamped to it.
+ * @return false if the pool is exhausted
+ */
+static inline bool rrc_timer_wheel_arm(RRC_TimerWheel *w, uint8_t kind, uint8_t key, uint32_t expires_ms)
+{
+    int16_t t = w->by_key[kind][key];
+    if (t != RRC_TIMER_NONE)
+    {
+        rrc_timer_wheel_unlink(w, t);
+    }
+    else
+    {
+        if (w->free_head == RRC_TIMER_NONE)
+        {
+            w->pool_exhausted++;
+            return false;
+        }
+        t = w->free_head;
+        w->free_head = w->pool[t].next;
+        w->pool[t].kind = kind;
+        w->pool[t].key = key;
+        w->by_key[kind][key] = t;
+    }
+
+    int bucket = rrc_timer_wheel_bucket_for(w, &expires_ms);
+    w->pool[t].expires_ms = expires_ms;
+    rrc_timer_wheel_link(w, t, bucket);
+    w->armed++;
+    return true;
+}
+
+// @return true if a timer was armed for (kind, key)
+static inline bool rrc_timer_wheel_cancel(RRC_TimerWheel *w, uint8_t kind, uint8_t key)
+{
+    int16_t t = w->by_key[kind][key];
+    if (t == RRC_TIMER_NONE)
+        return false;
+
+    rrc_timer_wheel_unlink(w, t);
+    rrc_timer_wheel_free(w, t);
+    w->cancelled++;
+    return true;
+}
+
+static inline bool rrc_timer_wheel_is_armed(const RRC_TimerWheel *w, uint8_t kind, uint8_t key)
+{
+    return w->by_key[kind][key] != RRC_TIMER_NONE;
+}
+
+static inline int rrc_timer_wheel_armed_count(const RRC_TimerWheel *w)
+{
+    int armed = 0;
+    for (int i = 0; i < RRC_TIMER_POOL_SIZE; i++)
+    {
+        if (w->pool[i].bucket != RRC_TIMER_NONE)
+            armed++;
+    }
+    return armed;
+}
+
+// Re-place every timer of a higher-level bucket relative to the current tick
+static inline void rrc_timer_wheel_cascade(RRC_TimerWheel *w, int bucket)
+{
+    int16_t t = w->bucket_head[bucket];
+    w->bucket_head[bucket] = RRC_TIMER_NONE;
+
+    while (t != RRC_TIMER_NONE)
+    {
+        int16_t next = w->pool[t].next;
+        uint32_t expires = w->pool[t].expires_ms;
+        rrc_timer_wheel_link(w, t, rrc_timer_wheel_bucket_for(w, &expires));
+        w->cascaded++;
+        t = next;
+    }
+}
+
+// Ticks from level-0 index to the next occupied bucket or the next cascade
+static inline uint32_t rrc_timer_wheel_next_l0_distance(const RRC_TimerWheel *w, uint32_t index)
+{
+    for (uint32_t i = index; i < RRC_TIMER_L0_SLOTS;)
+    {
+        uint32_t word = w->l0_occupied[i >> 5] >> (i & 31);
+        if (word)
+            return i + (uint32_t)__builtin_ctz(word) - index;
+        i = (i | 31) + 1;
+    }
+    return RRC_TIMER_L0_SLOTS - index;
+}
+
+// Advance the wheel to now_ms and fire every expired timer; returns the count
+static inline int rrc_timer_wheel_advance(RRC_TimerWheel *w, uint32_t now_ms,
+                                          rrc_timer_fire_cb fire, void *user)
+{
+    int fired = 0;
+
+    while ((int32_t)(now_ms - w->now) >= 0)
+    {
+        uint32_t index = w->now & (RRC_TIMER_L0_SLOTS - 1);
+
+        if (index == 0)
+        {
+            // Level-0 wrap: pull the next span down from the upper levels
+            for (int level = 1; level < RRC_TIMER_LEVELS; level++)
+            {
+                uint32_t shift = RRC_TIMER_L0_BITS + (uint32_t)(level - 1) * RRC_TIMER_LN_BITS;
+                uint32_t slot = (w->now >> shift) & (RRC_TIMER_LN_SLOTS - 1);
+                rrc_timer_wheel_cascade(w, RRC_TIMER_L0_SLOTS + (level - 1) * RRC_TIMER_LN_SLOTS + (int)slot);
+                if (slot != 0)
+                    break;
+            }
+        }
+        else if (w->bucket_head[index] == RRC_TIMER_NONE)
+        {
+            // Skip empty buckets up to the next occupied one, cascade point or now
+            uint32_t skip = rrc_timer_wheel_next_l0_distance(w, index);
+            uint32_t ahead = now_ms - w->now + 1;
+            w->now += (skip < ahead) ? skip : ahead;
+            continue;
+        }
+
+        // Move the expired bucket aside so callbacks can arm/cancel freely
+        int16_t t = w->bucket_head[index];
+        w->bucket_head[index] = RRC_TIMER_NONE;
+        w->l0_occupied[index >> 5] &= ~(1u << (index & 31));
+        w->bucket_head[RRC_TIMER_FIRING_BUCKET] = t;
+        for (; t != RRC_TIMER_NONE; t = w->pool[t].next)
+            w->pool[t].bucket = RRC_TIMER_FIRING_BUCKET;
+        w->now++;
+
+        while ((t = w->bucket_head[RRC_TIMER_FIRING_BUCKET]) != RRC_TIMER_NONE)
+        {
+            uint8_t kind = w->pool[t].kind;
+            uint8_t key = w->pool[t].key;
+            rrc_timer_wheel_unlink(w, t);
+            rrc_timer_wheel_free(w, t);
+            fire(kind, key, user);
+            fired++;
+        }
+    }
+
+    return fired;
+}
+
+#endif // RRC_TIMER_WHEEL_H
@@ -75,49 +75,59 @@ int find_available_slot(uint64_t bitmap) {
 }
 
 void handle_slot_check(MQContext* mq_in, MQContext* mq_out) {
-    RrcToTdmaMsg req;
-    unsigned int priority;
-    
-    ssize_t bytes = mq_try_recv_msg(mq_in, &req, sizeof(req), &priority);
-    if (bytes <= 0) return;
-    
-    printf("[TDMA] Slot check: next_hop=%d, priority=%d, req_id=%u\n",
-           req.next_hop, req.priority, req.header.request_id);
-    
-    // Lookup slot table
-    SlotTableEntry* entry = lookup_slots(req.next_hop);
-    
-    // Send response
-    TdmaToRrcMsg rsp;
-    init_message_header(&rsp.header, MSG_TDMA_TO_RRC_SLOT_RSP);
-    rsp.header.request_id = req.header.request_id;  // Correlation
-    
-    if (entry && entry->slot_bitmap != 0) {
-        int slot = find_available_slot(entry->slot_bitmap);
-        if (slot >= 0) {
-            rsp.success = 1;
-            rsp.assigned_slot = slot;
-            rsp.slot_bitmap_low = (uint16_t)(entry->slot_bitmap & 0xFFFF);
-            rsp.slot_bitmap_high = (uint16_t)((entry->slot_bitmap >> 16) & 0xFFFF);
-            printf("[TDMA] Slot available: slot=%d\n", slot);
+    MQMsgView views[MQ_BATCH_MAX];
+    
+    // Wait up to 10ms for a request, then take everything queued behind it
+    int count = mq_recv_peek(mq_in, views, MQ_BATCH_MAX, 10);
+    if (count < 0) {
+        usleep(10000);
+        return;
+    }
+    
+    for (int i = 0; i < count; i++) {
+        if (views[i].len < sizeof(RrcToTdmaMsg)) continue;
+        const RrcToTdmaMsg* req = views[i].data;
+        
+        printf("[TDMA] Slot check: next_hop=%d, priority=%d, req_id=%u\n",
+               req->next_hop, req->priority, req->header.request_id);
+    
+        // Lookup slot table
+        SlotTableEntry* entry = lookup_slots(req->next_hop);
+    
+        // Send response
+        TdmaToRrcMsg rsp;
+        init_message_header(&rsp.header, MSG_TDMA_TO_RRC_SLOT_RSP);
+        rsp.header.request_id = req->header.request_id;  // Correlation
+    
+        if (entry && entry->slot_bitmap != 0) {
+            int slot = find_available_slot(entry->slot_bitmap);
+            if (slot >= 0) {
+                rsp.success = 1;
+                rsp.assigned_slot = slot;
+                rsp.slot_bitmap_low = (uint16_t)(entry->slot_bitmap & 0xFFFF);
+                rsp.slot_bitmap_high = (uint16_t)((entry->slot_bitmap >> 16) & 0xFFFF);
+                printf("[TDMA] Slot available: slot=%d\n", slot);
+            } else {
+                rsp.success = 0;
+                rsp.assigned_slot = 0;
+                rsp.slot_bitmap_low = 0;
+                rsp.slot_bitmap_high = 0;
+                printf("[TDMA] No slot available for next_hop=%d\n", req->next_hop);
+            }
         } else {
             rsp.success = 0;
             rsp.assigned_slot = 0;
             rsp.slot_bitmap_low = 0;
             rsp.slot_bitmap_high = 0;
-            printf("[TDMA] No slot available for next_hop=%d\n", req.next_hop);
+            printf("[TDMA] No slot table entry for next_hop=%d\n", req->next_hop);
         }
-    } else {
-        rsp.success = 0;
-        rsp.assigned_slot = 0;
-        rsp.slot_bitmap_low = 0;
-        rsp.slot_bitmap_high = 0;
-        printf("[TDMA] No slot table entry for next_hop=%d\n", req.next_hop);
-    }
     
-    if (mq_send_msg(mq_out, &rsp, sizeof(rsp), priority) < 0) {
-        fprintf(stderr, "[TDMA] Failed to send slot response\n");
+        if (mq_send_msg(mq_out, &rsp, sizeof(rsp), views[i].priority) < 0) {
+            fprintf(stderr, "[TDMA] Failed to send slot response\n");
+        }
     }
+    
+    mq_recv_release(mq_in);
 }
 
 int main(int argc, char* argv[]) {
@@ -155,7 +165,6 @@ int main(int argc, char* argv[]) {
     // Main processing loop
     while (g_running) {
         handle_slot_check(&mq_rrc_to_tdma, &mq_tdma_to_rrc);
-        usleep(10000);  // 10ms
     }
     
     // Cleanup
@@ -0,0 +1,188 @@
+/**
+ * TDMA Slot Scheduler Test Program
+ * Builds TDMA_CODE.c without its main() against an in-memory stand-in
+ * for the RRC's AQM queues (counts per class and next hop), then checks
+ * scheduler selection by name, strict priority order, and the DRR shares
+ * per class and per next hop.
+ */
+
+#define TDMA_NO_MAIN
+#include "TDMA_CODE.c"
+
+static int failures = 0;
+
+#define CHECK(cond, what) do { \
+    if (cond) { \
+        printf("PASS: %s\n", what); \
+    } else { \
+        printf("FAIL: %s\n", what); \
+        failures++; \
+    } \
+} while (0)
+
+// ============================================================================
+// FAKE RRC QUEUES
+// ============================================================================
+
+static int queued[SCHED_CLASS_COUNT][SCHED_FLOW_BITS];
+
+static void fake_reset(void) {
+    memset(queued, 0, sizeof(queued));
+}
+
+static bool fake_pop(int c, int hop, struct frame* out) {
+    if (queued[c][hop] == 0) return false;
+    queued[c][hop]--;
+    memset(out, 0, sizeof(*out));
+    out->priority = c;
+    out->next_hop_add = (uint8_t)hop;
+    out->payload_length_bytes = 100;
+    return true;
+}
+
+static bool fake_pop_any(int c, struct frame* out) {
+    for (int hop = 0; hop < SCHED_FLOW_BITS; hop++) {
+        if (fake_pop(c, hop, out)) return true;
+    }
+    return false;
+}
+
+bool rrc_has_nc_packet_for_slot(uint8_t slot) { (void)slot; return false; }
+struct frame rrc_tdma_dequeue_nc_packet(uint8_t slot) { struct frame f = {0}; (void)slot; return f; }
+uint8_t rrc_get_my_nc_slot(void) { return 9; }
+
+bool rrc_has_mcast_packets(void) {
+    for (int hop = 0; hop < SCHED_FLOW_BITS; hop++) {
+        if (queued[SCHED_CLASS_MCAST][hop]) return true;
+    }
+    return false;
+}
+
+struct frame rrc_tdma_dequeue_mcast_packet(uint8_t* slot_id) {
+    struct frame f = {0};
+    fake_pop_any(SCHED_CLASS_MCAST, &f);
+    *slot_id = 2;
+    return f;
+}
+
+void rrc_tdma_release_mcast_slot(uint8_t next_hop, uint8_t slot_id) { (void)next_hop; (void)slot_id; }
+
+bool rrc_tdma_pull_data_packet(int priority, struct frame* out) { return fake_pop_any(priority, out); }
+bool rrc_tdma_pull_relay_packet(struct frame* out) { return fake_pop_any(SCHED_CLASS_RELAY, out); }
+bool rrc_tdma_pull_analog_voice_packet(struct frame* out) { (void)out; return false; }
+
+int rrc_tdma_queued_next_hops(int tdma_class, uint32_t hops[8]) {
+    int count = 0;
+    for (int hop = 0; hop < SCHED_FLOW_BITS; hop++) {
+        if (queued[tdma_class][hop]) {
+            hops[hop / 32] |= 1u << (hop % 32);
+            count++;
+        }
+    }
+    return count;
+}
+
+bool rrc_tdma_pull_packet_for_hop(int tdma_class, uint8_t next_hop, struct frame* out, uint8_t* slot_id) {
+    if (!fake_pop(tdma_class, next_hop, out)) return false;
+    *slot_id = 3;
+    return true;
+}
+
+// ============================================================================
+// TESTS
+// ============================================================================
+
+// Run n slots of one type; sent[c][hop] counts the frames picked
+static void run_slots(SLOT_TYPE slot_type, int n, int sent[SCHED_CLASS_COUNT][SCHED_FLOW_BITS]) {
+    memset(sent, 0, sizeof(int) * SCHED_CLASS_COUNT * SCHED_FLOW_BITS);
+    for (int i = 0; i < n; i++) {
+        struct frame f;
+        SCHED_CLASS c;
+        if (active_scheduler->select(slot_type, &f, &c)) sent[c][f.next_hop_add]++;
+    }
+}
+
+static void test_selection(void) {
+    CHECK(tdma_get_scheduler("drr") == &drr_scheduler, "\"drr\" selects the DRR scheduler");
+    CHECK(tdma_get_scheduler("strict") == &strict_scheduler, "\"strict\" selects the strict scheduler");
+    CHECK(tdma_get_scheduler("fifo") == NULL, "unknown name selects nothing");
+}
+
+static void test_strict(void) {
+    static int sent[SCHED_CLASS_COUNT][SCHED_FLOW_BITS];
+    struct frame f;
+    SCHED_CLASS c;
+
+    tdma_set_scheduler(&strict_scheduler);
+    fake_reset();
+    queued[SCHED_CLASS_P1][1] = 5;
+    queued[SCHED_CLASS_P0][1] = 2;
+    bool order = true;
+    for (int i = 0; i < 7; i++) {
+        order &= active_scheduler->select(SLOT_TYPE_DU, &f, &c) && c == (i < 2 ? SCHED_CLASS_P0 : SCHED_CLASS_P1);
+    }
+    CHECK(order, "strict DU: P0 drains before P1");
+
+    fake_reset();
+    queued[SCHED_CLASS_P3][1] = 3;
+    queued[SCHED_CLASS_P2][1] = 3;
+    queued[SCHED_CLASS_RELAY][1] = 3;
+    run_slots(SLOT_TYPE_GU, 6, sent);
+    CHECK(sent[SCHED_CLASS_RELAY][1] == 3 && sent[SCHED_CLASS_P2][1] == 3 && sent[SCHED_CLASS_P3][1] == 0,
+          "strict GU: relay, then P2, P3 starved while they have frames");
+}
+
+static void test_drr_class_shares(void) {
+    static int sent[SCHED_CLASS_COUNT][SCHED_FLOW_BITS];
+    const int slots = 600;
+
+    tdma_set_scheduler(&drr_scheduler);
+    fake_reset();
+    queued[SCHED_CLASS_RELAY][1] = slots;
+    queued[SCHED_CLASS_MCAST][1] = slots;
+    queued[SCHED_CLASS_P2][1] = slots;
+    queued[SCHED_CLASS_P3][1] = slots;
+    run_slots(SLOT_TYPE_GU, slots, sent);
+
+    // Weights relay 3, mcast 2, P2 2, P3 1 per round of 8 slots
+    int round = slots / 8;
+    CHECK(sent[SCHED_CLASS_RELAY][1] == 3 * round && sent[SCHED_CLASS_MCAST][1] == 2 * round &&
+          sent[SCHED_CLASS_P2][1] == 2 * round && sent[SCHED_CLASS_P3][1] == round,
+          "DRR GU: backlogged classes share slots by weight");
+
+    fake_reset();
+    queued[SCHED_CLASS_P0][1] = 3;
+    queued[SCHED_CLASS_P1][1] = 10;
+    run_slots(SLOT_TYPE_DU, 5, sent);
+    CHECK(sent[SCHED_CLASS_P0][1] == 3 && sent[SCHED_CLASS_P1][1] == 2, "DRR DU: voice keeps strict priority");
+}
+
+static void test_drr_next_hops(void) {
+    static int sent[SCHED_CLASS_COUNT][SCHED_FLOW_BITS];
+
+    tdma_set_scheduler(&drr_scheduler);
+    fake_reset();
+    queued[SCHED_CLASS_RELAY][7] = 1000;     // Congested next hop
+    queued[SCHED_CLASS_RELAY][200] = 1000;
+    queued[SCHED_CLASS_RELAY][40] = 4;       // Light next hop
+    run_slots(SLOT_TYPE_GU, 60, sent);
+
+    CHECK(sent[SCHED_CLASS_RELAY][40] == 4, "DRR: light next hop is not starved by congested ones");
+    CHECK(sent[SCHED_CLASS_RELAY][7] - sent[SCHED_CLASS_RELAY][200] <= 3 &&
+          sent[SCHED_CLASS_RELAY][200] - sent[SCHED_CLASS_RELAY][7] <= 3,
+          "DRR: backlogged next hops of one class share equally");
+
+    fake_reset();
+    run_slots(SLOT_TYPE_GU, 4, sent);
+    CHECK(sent[SCHED_CLASS_RELAY][7] == 0, "DRR: idle when nothing is queued");
+}
+
+int main(void) {
+    test_selection();
+    test_strict();
+    test_drr_class_shares();
+    test_drr_next_hops();
+
+    printf("%s\n", failures ? "FAILED" : "ALL TESTS PASSED");
+    return failures ? 1 : 0;
+}
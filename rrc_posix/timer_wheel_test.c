@@ -0,0 +1,176 @@
+/**
+ * Timer Wheel Test Program
+ * Drives rrc_timer_wheel.h on a simulated millisecond clock: expiry on
+ * the exact tick at every level, cancel and re-arm, re-arming from a
+ * callback, pool exhaustion, large clock jumps and 32-bit wraparound.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "rrc_timer_wheel.h"
+
+static int failures = 0;
+
+#define CHECK(cond, what) do { \
+    if (cond) { \
+        printf("PASS: %s\n", what); \
+    } else { \
+        printf("FAIL: %s\n", what); \
+        failures++; \
+    } \
+} while (0)
+
+static RRC_TimerWheel wheel;
+static uint32_t clock_ms;
+
+// Tick each (kind 0, key) timer fired on, UINT32_MAX if it has not fired
+static uint32_t fired_at[256];
+static int fire_count[256];
+static uint32_t rearm_delay = 0;   // Key 0 re-arms itself this far ahead from its callback
+static int rearms_left = 0;        // ... this many more times
+
+static void record_fire(uint8_t kind, uint8_t key, void *user)
+{
+    (void)user;
+    if (kind != 0)
+        return;
+    fired_at[key] = clock_ms;
+    fire_count[key]++;
+    if (key == 0 && rearms_left > 0)
+    {
+        rearms_left--;
+        rrc_timer_wheel_arm(&wheel, 0, 0, clock_ms + rearm_delay);
+    }
+}
+
+static void reset(uint32_t start_ms)
+{
+    clock_ms = start_ms;
+    rrc_timer_wheel_init(&wheel, clock_ms);
+    memset(fired_at, 0xFF, sizeof(fired_at));
+    memset(fire_count, 0, sizeof(fire_count));
+    rearms_left = 0;
+}
+
+// Advance one millisecond at a time up to end_ms
+static int step_to(uint32_t end_ms)
+{
+    int fired = 0;
+    while (clock_ms != end_ms)
+    {
+        clock_ms++;
+        fired += rrc_timer_wheel_advance(&wheel, clock_ms, record_fire, NULL);
+    }
+    return fired;
+}
+
+static void test_exact_expiry(uint32_t start_ms, const char *name)
+{
+    static const uint32_t delays[] = {
+        1, 2, 255, 256, 257, 1000, 16383, 16384, 16385, 70000,
+        1048575, 1048576, 5000000, RRC_TIMER_MAX_DELAY_MS
+    };
+    const int count = (int)(sizeof(delays) / sizeof(delays[0]));
+    char what[128];
+
+    reset(start_ms);
+    for (int i = 0; i < count; i++)
+        rrc_timer_wheel_arm(&wheel, 0, (uint8_t)i, clock_ms + delays[i]);
+    rrc_timer_wheel_advance(&wheel, clock_ms, record_fire, NULL);
+
+    int fired = step_to(start_ms + RRC_TIMER_MAX_DELAY_MS + 10);
+
+    int exact = 0;
+    for (int i = 0; i < count; i++)
+    {
+        if (fire_count[i] == 1 && fired_at[i] == start_ms + delays[i])
+            exact++;
+        else
+            printf("      delay %u fired %d times, at +%u\n", delays[i], fire_count[i],
+                   fired_at[i] - start_ms);
+    }
+    snprintf(what, sizeof(what), "%s: every level fires once, on its exact tick", name);
+    CHECK(fired == count && exact == count, what);
+    snprintf(what, sizeof(what), "%s: wheel empty afterwards", name);
+    CHECK(rrc_timer_wheel_armed_count(&wheel) == 0, what);
+}
+
+static void test_cancel_and_rearm(void)
+{
+    reset(1000);
+
+    rrc_timer_wheel_arm(&wheel, 0, 1, clock_ms + 50);
+    rrc_timer_wheel_arm(&wheel, 0, 2, clock_ms + 5000);
+    CHECK(rrc_timer_wheel_is_armed(&wheel, 0, 1) && rrc_timer_wheel_is_armed(&wheel, 0, 2),
+          "armed timers report armed");
+
+    CHECK(rrc_timer_wheel_cancel(&wheel, 0, 1) && !rrc_timer_wheel_cancel(&wheel, 0, 1),
+          "cancel succeeds once");
+    rrc_timer_wheel_arm(&wheel, 0, 2, clock_ms + 100);
+    CHECK(rrc_timer_wheel_armed_count(&wheel) == 1, "re-arm keeps one timer per key");
+
+    rrc_timer_wheel_arm(&wheel, 1, 2, clock_ms + 100);
+    CHECK(rrc_timer_wheel_armed_count(&wheel) == 2, "same key, other kind is a separate timer");
+
+    step_to(1000 + 6000);
+    CHECK(fire_count[1] == 0, "cancelled timer never fires");
+    CHECK(fire_count[2] == 1 && fired_at[2] == 1100, "re-armed timer fires at its new expiry only");
+}
+
+static void test_rearm_from_callback(void)
+{
+    reset(5000);
+    rearm_delay = 300;
+    rearms_left = 3;
+
+    rrc_timer_wheel_arm(&wheel, 0, 0, clock_ms + 10);
+    step_to(5000 + 2000);
+    CHECK(fire_count[0] == 4 && fired_at[0] == 5000 + 10 + 3 * 300,
+          "callback re-arms its own timer");
+}
+
+static void test_pool_exhaustion(void)
+{
+    reset(0);
+
+    int armed = 0;
+    for (int kind = 0; kind < 2 && armed < RRC_TIMER_POOL_SIZE; kind++)
+        for (int key = 0; key < 256 && armed < RRC_TIMER_POOL_SIZE; key++, armed++)
+            rrc_timer_wheel_arm(&wheel, (uint8_t)kind, (uint8_t)key, 100 + (uint32_t)key);
+
+    CHECK(!rrc_timer_wheel_arm(&wheel, 2, 0, 100) && wheel.pool_exhausted == 1,
+          "arm fails once the pool is exhausted");
+    CHECK(rrc_timer_wheel_arm(&wheel, 0, 5, 200), "re-arming an armed key needs no new timer");
+    rrc_timer_wheel_cancel(&wheel, 0, 6);
+    CHECK(rrc_timer_wheel_arm(&wheel, 2, 0, 100), "cancel returns the timer to the pool");
+}
+
+static void test_clock_jump(void)
+{
+    reset(0);
+    for (int i = 0; i < 10; i++)
+        rrc_timer_wheel_arm(&wheel, 0, (uint8_t)i, (uint32_t)(i * 40000 + 1));
+
+    clock_ms = 1000000;
+    int fired = rrc_timer_wheel_advance(&wheel, clock_ms, record_fire, NULL);
+    CHECK(fired == 10 && rrc_timer_wheel_armed_count(&wheel) == 0,
+          "one advance across a large jump fires everything due");
+
+    rrc_timer_wheel_arm(&wheel, 0, 20, clock_ms - 500);
+    CHECK(rrc_timer_wheel_advance(&wheel, clock_ms, record_fire, NULL) == 0 &&
+          rrc_timer_wheel_advance(&wheel, clock_ms + 1, record_fire, NULL) == 1,
+          "expiry in the past fires on the next tick");
+}
+
+int main(void)
+{
+    test_exact_expiry(0, "from zero");
+    test_exact_expiry(0xFFFFFF00u, "across 32-bit wrap");
+    test_cancel_and_rearm();
+    test_rearm_from_callback();
+    test_pool_exhaustion();
+    test_clock_jump();
+
+    printf("%s\n", failures ? "FAILED" : "ALL TESTS PASSED");
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,62 @@
+/**
+ * TDMA slot timing for TDMA_CODE.c
+ * Slot counter driven by the slot timer, aligned to the network time master
+ */
+
+#ifndef TIMESYNC_H
+#define TIMESYNC_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+// ============================================================================
+// TIME SYNC STATE
+// ============================================================================
+
+typedef struct {
+    bool synchronized;
+    bool is_master;            // No master heard: this node keeps the time
+    uint32_t current_slot;     // Slots since init; slot in frame = current_slot % TOTAL_SLOTS
+    uint32_t alignments;       // Times the counter was moved to a master's
+} NetworkTimeSync;
+
+// Called once per slot by on_slot_timer_interrupt(), defined by the TDMA code
+void tdma_scheduler_process(void);
+
+static NetworkTimeSync network_time_sync;
+
+static inline NetworkTimeSync* get_time_sync_instance(void) {
+    return &network_time_sync;
+}
+
+static inline bool is_synchronized(void) {
+    return network_time_sync.synchronized;
+}
+
+// Start as our own time master until a beacon says otherwise
+static inline void network_time_sync_init(void) {
+    memset(&network_time_sync, 0, sizeof(network_time_sync));
+    network_time_sync.synchronized = true;
+    network_time_sync.is_master = true;
+    printf("[SYNC] Init (master until a beacon is heard)\n");
+}
+
+// Adopt the slot count carried in a master's beacon
+static inline void network_time_sync_align(uint32_t master_slot) {
+    if (network_time_sync.current_slot != master_slot) {
+        network_time_sync.current_slot = master_slot;
+        network_time_sync.alignments++;
+    }
+    network_time_sync.is_master = false;
+    network_time_sync.synchronized = true;
+}
+
+// Slot timer: run the slot that just started, then count it
+static inline void on_slot_timer_interrupt(void) {
+    tdma_scheduler_process();
+    network_time_sync.current_slot++;
+}
+
+#endif // TIMESYNC_H